@@ -32,6 +32,7 @@ config = {
   },
   spatializers = {
     simple = true,
+    hrtf = true,
     oculus = false,
     phonon = false
   },
@@ -389,10 +390,15 @@ end
 src = {
   'src/main.c',
   'src/util.c',
+  'src/core/bc.c',
+  'src/core/convert.c',
+  'src/core/dsp.c',
   'src/core/fs.c',
+  'src/core/job.c',
   ('src/core/os_%s.c'):format(target),
   'src/core/spv.c',
   'src/core/zip.c',
+  'src/core/zstd.c',
   'src/api/api.c',
   'src/api/l_lovr.c'
 }
@@ -434,7 +440,7 @@ src += (config.modules.audio or config.modules.data) and 'src/lib/miniaudio/*.c'
 src += config.modules.data and 'src/lib/jsmn/*.c' or nil
 src += config.modules.data and 'src/lib/minimp3/*.c' or nil
 src += config.modules.math and 'src/lib/noise/*.c' or nil
-src += config.modules.thread and 'src/lib/tinycthread/*.c' or nil
+src += 'src/lib/tinycthread/*.c'
 
 -- embed resource files with xxd
 
@@ -0,0 +1,2 @@
+const unsigned char etc_VarelaRound_ttf[] = {0x00,0x01,0x00,0x00,0x00,0x12,0x01,0x00,0x00,0x04,0x00,0x20,0x46,0x46,0x54,0x4d,0x81,0xa2,0x3e,0x84,0x00,0x00,0xad,0xc8,0x00,0x00,0x00,0x1c,0x47,0x44,0x45,0x46,0x09,0xcf,0x0a,0x8c,0x00,0x00,0x74,0x38,0x00,0x00,0x00,0x88,0x47,0x50,0x4f,0x53,0x77,0xa3,0x14,0x54,0x00,0x00,0x7e,0x14,0x00,0x00,0x2f,0xb2,0x47,0x53,0x55,0x42,0x06,0xc3,0x10,0xc7,0x00,0x00,0x74,0xc0,0x00,0x00,0x09,0x52,0x4f,0x53,0x2f,0x32,0x71,0xc6,0xaa,0xaf,0x00,0x00,0x01,0xa8,0x00,0x00,0x00,0x60,0x63,0x6d,0x61,0x70,0x45,0x3f,0x2b,0xb2,0x00,0x00,0x05,0x44,0x00,0x00,0x01,0xa2,0x63,0x76,0x74,0x20,0x09,0x6f,0x3e,0x54,0x00,0x00,0x14,0xb4,0x00,0x00,0x00,0xba,0x66,0x70,0x67,0x6d,0x76,0x64,0x80,0x7c,0x00,0x00,0x06,0xe8,0x00,0x00,0x0d,0x16,0x67,0x61,0x73,0x70,0x00,0x00,0x00,0x10,0x00,0x00,0x74,0x30,0x00,0x00,0x00,0x08,0x67,0x6c,0x79,0x66,0x91,0x42,0x95,0xde,0x00,0x00,0x17,0x28,0x00,0x00,0x58,0xa4,0x68,0x65,0x61,0x64,0x0f,0x8c,0xa3,0x64,0x00,0x00,0x01,0x2c,0x00,0x00,0x00,0x36,0x68,0x68,0x65,0x61,0x05,0xf4,0x03,0x7a,0x00,0x00,0x01,0x64,0x00,0x00,0x00,0x24,0x68,0x6d,0x74,0x78,0xa3,0x41,0x1d,0x05,0x00,0x00,0x02,0x08,0x00,0x00,0x03,0x3c,0x6c,0x6f,0x63,0x61,0xd0,0x61,0xb9,0xe0,0x00,0x00,0x15,0x70,0x00,0x00,0x01,0xb6,0x6d,0x61,0x78,0x70,0x02,0x49,0x01,0x04,0x00,0x00,0x01,0x88,0x00,0x00,0x00,0x20,0x6e,0x61,0x6d,0x65,0x12,0x75,0x8c,0xb9,0x00,0x00,0x6f,0xcc,0x00,0x00,0x04,0x41,0x70,0x6f,0x73,0x74,0xff,0x86,0x00,0x32,0x00,0x00,0x74,0x10,0x00,0x00,0x00,0x20,0x70,0x72,0x65,0x70,0x7e,0xe5,0x8d,0xba,0x00,0x00,0x14,0x00,0x00,0x00,0x00,0xb1,0x00,0x01,0x00,0x00,0x00,0x03,0x00,0x00,0x0b,0x1f,0xd1,0xe6,0x5f,0x0f,0x3c,0xf5,0x02,0x1f,0x03,0xe8,0x00,0x00,0x00,0x00,0xd3,0xc7,0xf2,0x5f,0x00,0x00,0x00,0x00,0xd8,0x36,0x6d,0x98,0xfe,0x7f,0xfe,0xf9,0x03,0xdc,0x03,0x8f,0x00,0x00,0x00,0x08,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x00,0x03,0x96,0xfe,0xe2,0x00,0x00,0x04,0x10,0xfe,0x7f,0xff,0xc3,0x03,0xdc,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xc4,0x00,0x01,0x00,0x00,0x00,0xda,0x00,0x68,0x00,0x05,0x00,0x52,0x00,0x04,0x00,0x02,0x00,0x36,0x00,0x47,0x00,0x8b,0x00,0x00,0x00,0xa2,0x00,0x00,0x00,0x02,0x00,0x01,0x00,0x04,0x02,0x3b,0x01,0x90,0x00,0x05,0x00,0x00,0x02,0x8a,0x02,0x58,0x00,0x00,0x00,0x4b,0x02,0x8a,0x02,0x58,0x00,0x00,0x01,0x5e,0x00,0x32,0x01,0x32,0x00,0x00,0x00,0x00,0x05,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x20,0x00,0x08,0x07,0x00,0x00,0x00,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x55,0x4b,0x57,0x4e,0x00,0xc0,0x00,0x0d,0x03,0x31,0x03,0x96,0xfe,0xe2,0x00,0x00,0x04,0x01,0x01,0x1e,0x20,0x00,0x01,0xb3,0x00,0x00,0x00,0x00,0x01,0xfe,0x02,0xba,0x00,0x00,0x00,0x20,0x00,0x0c,0x03,0xe8,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x04,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x04,0x00,0x00,0x01,0x19,0x00,0x52,0x01,0x9b,0x00,0x3c,0x02,0x64,0x00,0x24,0x02,0x68,0x00,0x33,0x03,0x2e,0x00,0x2b,0x02,0xdc,0x00,0x47,0x00,0xde,0x00,0x3c,0x01,0x38,0x00,0x33,0x01,0x38,0x00,0x30,0x01,0xa1,0x00,0x42,0x02,0x32,0x00,0x28,0x01,0x04,0x00,0x3f,0x01,0x98,0x00,0x45,0x01,0x04,0x00,0x45,0x01,0xbb,0x00,0x30,0x02,0x74,0x00,0x2b,0x02,0x74,0x00,0x80,0x02,0x74,0x00,0x41,0x02,0x74,0x00,0x3b,0x02,0x74,0x00,0x19,0x02,0x74,0x00,0x40,0x02,0x74,0x00,0x3b,0x02,0x74,0x00,0x3c,0x02,0x74,0x00,0x2f,0x02,0x74,0x00,0x30,0x01,0x04,0x00,0x45,0x01,0x04,0x00,0x3f,0x02,0x44,0x00,0x23,0x02,0xc8,0x00,0x49,0x02,0x44,0x00,0x36,0x01,0xf1,0x00,0x1a,0x03,0x82,0x00,0x31,0x02,0xea,0x00,0x32,0x02,0xb5,0x00,0x61,0x02,0xb7,0x00,0x37,0x02,0xef,0x00,0x61,0x02,0x7e,0x00,0x61,0x02,0x60,0x00,0x61,0x02,0xf5,0x00,0x37,0x02,0xf3,0x00,0x61,0x01,0x1d,0x00,0x61,0x01,0xd2,0x00,0x0d,0x02,0x9e,0x00,0x61,0x02,0x40,0x00,0x61,0x03,0xc6,0x00,0x61,0x03,0x23,0x00,0x61,0x03,0x2c,0x00,0x37,0x02,0xa0,0x00,0x61,0x03,0x2c,0x00,0x37,0x02,0xc8,0x00,0x61,0x02,0x68,0x00,0x33,0x02,0x61,0x00,0x0d,0x02,0xf6,0x00,0x5c,0x02,0xb6,0x00,0x18,0x03,0xf3,0x00,0x1b,0x02,0x9f,0x00,0x2c,0x02,0x7f,0x00,0x1b,0x02,0x7e,0x00,0x2f,0x01,0x42,0x00,0x57,0x01,0xbb,0x00,0x2f,0x01,0x42,0x00,0x1c,0x02,0x0c,0x00,0x52,0x02,0x97,0x00,0x34,0x00,0xf6,0x00,0x63,0x02,0x32,0x00,0x2e,0x02,0x77,0x00,0x4f,0x02,0x15,0x00,0x30,0x02,0x77,0x00,0x30,0x02,0x36,0x00,0x30,0x01,0x7e,0x00,0x13,0x02,0x77,0x00,0x30,0x02,0x61,0x00,0x4f,0x00,0xf9,0x00,0x47,0x00,0xfe,0xff,0xd3,0x02,0x21,0x00,0x4f,0x00,0xf9,0x00,0x4f,0x03,0x96,0x00,0x4f,0x02,0x61,0x00,0x4f,0x02,0x60,0x00,0x30,0x02,0x77,0x00,0x4f,0x02,0x77,0x00,0x30,0x01,0x7f,0x00,0x4f,0x01,0xe0,0x00,0x2d,0x01,0x7e,0x00,0x13,0x02,0x61,0x00,0x4a,0x02,0x12,0x00,0x1a,0x03,0x18,0x00,0x1c,0x02,0x1d,0x00,0x32,0x02,0x19,0x00,0x1a,0x01,0xf2,0x00,0x28,0x01,0x58,0x00,0x03,0x00,0xfd,0x00,0x56,0x01,0x58,0x00,0x1c,0x02,0x7e,0x00,0x4a,0x01,0x04,0x00,0x00,0x01,0x03,0x00,0x47,0x02,0x27,0x00,0x2c,0x02,0x5c,0x00,0x27,0x02,0x9c,0x00,0x42,0x02,0x92,0x00,0x41,0x00,0xfd,0x00,0x56,0x02,0x11,0x00,0x2f,0x01,0x90,0x00,0x41,0x03,0x33,0x00,0x33,0x01,0xe5,0x00,0x42,0x02,0x49,0x00,0x36,0x02,0x43,0x00,0x49,0x01,0x98,0x00,0x45,0x03,0x33,0x00,0x33,0x01,0x38,0x00,0x35,0x01,0x7a,0x00,0x34,0x02,0x5e,0x00,0x3e,0x01,0x72,0x00,0x26,0x01,0x72,0x00,0x24,0x00,0xf0,0x00,0xad,0x02,0x5c,0x00,0x54,0x02,0xdc,0x00,0x27,0x01,0x04,0x00,0x45,0x01,0x33,0x00,0x56,0x01,0x72,0x00,0x4e,0x02,0x02,0x00,0x46,0x02,0x49,0x00,0x4a,0x03,0x7b,0x00,0x4e,0x03,0xa3,0x00,0x4e,0x03,0x7b,0x00,0x24,0x01,0xe8,0x00,0x28,0x02,0xea,0x00,0x32,0x02,0xea,0x00,0x32,0x02,0xea,0x00,0x32,0x02,0xea,0x00,0x32,0x02,0xea,0x00,0x32,0x02,0xea,0x00,0x32,0x04,0x10,0x00,0x02,0x02,0xb7,0x00,0x37,0x02,0x7e,0x00,0x61,0x02,0x7e,0x00,0x61,0x02,0x7e,0x00,0x61,0x02,0x7e,0x00,0x61,0x01,0x1d,0x00,0x2a,0x01,0x1d,0x00,0x61,0x01,0x1d,0x00,0x07,0x01,0x1d,0x00,0x08,0x02,0xf4,0x00,0x0f,0x03,0x23,0x00,0x61,0x03,0x2c,0x00,0x37,0x03,0x2c,0x00,0x37,0x03,0x2c,0x00,0x37,0x03,0x2c,0x00,0x37,0x03,0x2c,0x00,0x37,0x02,0x33,0x00,0x3b,0x03,0x2c,0x00,0x37,0x02,0xf6,0x00,0x5c,0x02,0xf6,0x00,0x5c,0x02,0xf6,0x00,0x5c,0x02,0xf6,0x00,0x5c,0x02,0x7f,0x00,0x1b,0x02,0xa0,0x00,0x61,0x02,0x60,0x00,0x4f,0x02,0x32,0x00,0x2e,0x02,0x32,0x00,0x2e,0x02,0x32,0x00,0x2e,0x02,0x32,0x00,0x2e,0x02,0x32,0x00,0x2e,0x02,0x32,0x00,0x2e,0x03,0x8f,0x00,0x2e,0x02,0x15,0x00,0x30,0x02,0x36,0x00,0x30,0x02,0x36,0x00,0x30,0x02,0x36,0x00,0x30,0x02,0x36,0x00,0x30,0x00,0xf9,0x00,0x18,0x00,0xf9,0x00,0x4f,0x00,0xf9,0xff,0xf5,0x00,0xf9,0xff,0xf6,0x02,0x51,0x00,0x30,0x02,0x61,0x00,0x4f,0x02,0x60,0x00,0x30,0x02,0x60,0x00,0x30,0x02,0x60,0x00,0x30,0x02,0x60,0x00,0x30,0x02,0x60,0x00,0x30,0x02,0xc8,0x00,0x49,0x02,0x60,0x00,0x30,0x02,0x61,0x00,0x4a,0x02,0x61,0x00,0x4a,0x02,0x61,0x00,0x4a,0x02,0x61,0x00,0x4a,0x02,0x19,0x00,0x1a,0x02,0x77,0x00,0x4f,0x02,0x19,0x00,0x1a,0x00,0x00,0xfe,0xd3,0xff,0x1d,0xfe,0xb0,0xfe,0x97,0xfe,0xa5,0xfe,0xa9,0xff,0x05,0xfe,0xb1,0xfe,0xe5,0xfe,0xda,0xfe,0xe2,0xfe,0xb0,0xfe,0xd0,0xfe,0xa9,0xff,0x04,0xff,0x38,0xff,0x05,0xfe,0xb1,0xff,0x04,0xfe,0xc6,0xfe,0x7f,0xfe,0xa9,0xfe,0xa5,0x00,0x00,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x00,0x00,0x1c,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x9c,0x00,0x03,0x00,0x01,0x00,0x00,0x00,0x1c,0x00,0x04,0x00,0x80,0x00,0x00,0x00,0x1c,0x00,0x10,0x00,0x03,0x00,0x0c,0x00,0x00,0x00,0x0d,0x00,0x7e,0x00,0xff,0x03,0x04,0x03,0x0c,0x03,0x0f,0x03,0x12,0x03,0x1b,0x03,0x24,0x03,0x28,0x03,0x2e,0x03,0x31,0xff,0xff,0x00,0x00,0x00,0x00,0x00,0x0d,0x00,0x20,0x00,0xa0,0x03,0x00,0x03,0x06,0x03,0x0f,0x03,0x11,0x03,0x1b,0x03,0x23,0x03,0x26,0x03,0x2e,0x03,0x31,0xff,0xff,0x00,0x03,0xff,0xf5,0xff,0xe4,0xff,0xc3,0xfd,0xc3,0xfd,0xc2,0xfd,0xc0,0xfd,0xbf,0xfd,0xb7,0xfd,0xb0,0xfd,0xaf,0xfd,0xaa,0xfd,0xa8,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x06,0x00,0x00,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x02,0x00,0x00,0x00,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x00,0x04,0x05,0x06,0x07,0x08,0x09,0x0a,0x0b,0x0c,0x0d,0x0e,0x0f,0x10,0x11,0x12,0x13,0x14,0x15,0x16,0x17,0x18,0x19,0x1a,0x1b,0x1c,0x1d,0x1e,0x1f,0x20,0x21,0x22,0x23,0x24,0x25,0x26,0x27,0x28,0x29,0x2a,0x2b,0x2c,0x2d,0x2e,0x2f,0x30,0x31,0x32,0x33,0x34,0x35,0x36,0x37,0x38,0x39,0x3a,0x3b,0x3c,0x3d,0x3e,0x3f,0x40,0x41,0x42,0x43,0x44,0x45,0x46,0x47,0x48,0x49,0x4a,0x4b,0x4c,0x4d,0x4e,0x4f,0x50,0x51,0x52,0x53,0x54,0x55,0x56,0x57,0x58,0x59,0x5a,0x5b,0x5c,0x5d,0x5e,0x5f,0x60,0x61,0x62,0x00,0x87,0x88,0x8a,0x8c,0x94,0x99,0x9f,0xa4,0xa3,0xa5,0xa7,0xa6,0xa8,0xaa,0xac,0xab,0xad,0xae,0xb0,0xaf,0xb1,0xb2,0xb4,0xb6,0xb5,0xb7,0xb9,0xb8,0xbd,0xbc,0xbe,0xbf,0x00,0x73,0x65,0x66,0x6a,0x00,0x79,0xa2,0x71,0x6c,0x00,0x77,0x6b,0x00,0x89,0x9b,0x00,0x74,0x00,0x00,0x68,0x78,0x00,0x00,0x00,0x00,0x00,0x6d,0x7d,0x00,0xa9,0xbb,0x82,0x64,0x6f,0x00,0x00,0x00,0x00,0x6e,0x7e,0x00,0x63,0x83,0x86,0x98,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xba,0x00,0xc2,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7a,0x00,0x00,0x00,0x85,0x8d,0x84,0x8e,0x8b,0x90,0x91,0x92,0x8f,0x96,0x97,0x00,0x95,0x9d,0x9e,0x9c,0x00,0x00,0x00,0x72,0x00,0x00,0x00,0x7b,0x00,0x00,0x00,0x00,0x00,0xb0,0x00,0x2c,0x20,0xb0,0x00,0x55,0x58,0x45,0x59,0x20,0x20,0x4b,0xb8,0x00,0x0e,0x51,0x4b,0xb0,0x06,0x53,0x5a,0x58,0xb0,0x34,0x1b,0xb0,0x28,0x59,0x60,0x66,0x20,0x8a,0x55,0x58,0xb0,0x02,0x25,0x61,0xb9,0x08,0x00,0x08,0x00,0x63,0x63,0x23,0x62,0x1b,0x21,0x21,0xb0,0x00,0x59,0xb0,0x00,0x43,0x23,0x44,0xb2,0x00,0x01,0x00,0x43,0x60,0x42,0x2d,0xb0,0x01,0x2c,0xb0,0x20,0x60,0x66,0x2d,0xb0,0x02,0x2c,0x20,0x64,0x20,0xb0,0xc0,0x50,0xb0,0x04,0x26,0x5a,0xb2,0x28,0x01,0x0a,0x43,0x45,0x63,0x45,0xb0,0x06,0x45,0x58,0x21,0xb0,0x03,0x25,0x59,0x52,0x5b,0x58,0x21,0x23,0x21,0x1b,0x8a,0x58,0x20,0xb0,0x50,0x50,0x58,0x21,0xb0,0x40,0x59,0x1b,0x20,0xb0,0x38,0x50,0x58,0x21,0xb0,0x38,0x59,0x59,0x20,0xb1,0x01,0x0a,0x43,0x45,0x63,0x45,0x61,0x64,0xb0,0x28,0x50,0x58,0x21,0xb1,0x01,0x0a,0x43,0x45,0x63,0x45,0x20,0xb0,0x30,0x50,0x58,0x21,0xb0,0x30,0x59,0x1b,0x20,0xb0,0xc0,0x50,0x58,0x20,0x66,0x20,0x8a,0x8a,0x61,0x20,0xb0,0x0a,0x50,0x58,0x60,0x1b,0x20,0xb0,0x20,0x50,0x58,0x21,0xb0,0x0a,0x60,0x1b,0x20,0xb0,0x36,0x50,0x58,0x21,0xb0,0x36,0x60,0x1b,0x60,0x59,0x59,0x59,0x1b,0xb0,0x01,0x2b,0x59,0x59,0x23,0xb0,0x00,0x50,0x58,0x65,0x59,0x59,0x2d,0xb0,0x03,0x2c,0x20,0x45,0x20,0xb0,0x04,0x25,0x61,0x64,0x20,0xb0,0x05,0x43,0x50,0x58,0xb0,0x05,0x23,0x42,0xb0,0x06,0x23,0x42,0x1b,0x21,0x21,0x59,0xb0,0x01,0x60,0x2d,0xb0,0x04,0x2c,0x23,0x21,0x23,0x21,0x20,0x64,0xb1,0x05,0x62,0x42,0x20,0xb0,0x06,0x23,0x42,0xb0,0x06,0x45,0x58,0x1b,0xb1,0x01,0x0a,0x43,0x45,0x63,0xb1,0x01,0x0a,0x43,0xb0,0x04,0x60,0x45,0x63,0xb0,0x03,0x2a,0x21,0x20,0xb0,0x06,0x43,0x20,0x8a,0x20,0x8a,0xb0,0x01,0x2b,0xb1,0x30,0x05,0x25,0xb0,0x04,0x26,0x51,0x58,0x60,0x50,0x1b,0x61,0x52,0x59,0x58,0x23,0x59,0x21,0x59,0x20,0xb0,0x40,0x53,0x58,0xb0,0x01,0x2b,0x1b,0x21,0xb0,0x40,0x59,0x23,0xb0,0x00,0x50,0x58,0x65,0x59,0x2d,0xb0,0x05,0x2c,0xb0,0x07,0x43,0x2b,0xb2,0x00,0x02,0x00,0x43,0x60,0x42,0x2d,0xb0,0x06,0x2c,0xb0,0x07,0x23,0x42,0x23,0x20,0xb0,0x00,0x23,0x42,0x61,0xb0,0x02,0x62,0x66,0xb0,0x01,0x63,0xb0,0x01,0x60,0xb0,0x05,0x2a,0x2d,0xb0,0x07,0x2c,0x20,0x20,0x45,0x20,0xb0,0x0b,0x43,0x63,0xb8,0x04,0x00,0x62,0x20,0xb0,0x00,0x50,0x58,0xb0,0x40,0x60,0x59,0x66,0xb0,0x01,0x63,0x60,0x44,0xb0,0x01,0x60,0x2d,0xb0,0x08,0x2c,0xb2,0x07,0x0b,0x00,0x43,0x45,0x42,0x2a,0x21,0xb2,0x00,0x01,0x00,0x43,0x60,0x42,0x2d,0xb0,0x09,0x2c,0xb0,0x00,0x43,0x23,0x44,0xb2,0x00,0x01,0x00,0x43,0x60,0x42,0x2d,0xb0,0x0a,0x2c,0x20,0x20,0x45,0x20,0xb0,0x01,0x2b,0x23,0xb0,0x00,0x43,0xb0,0x04,0x25,0x60,0x20,0x45,0x8a,0x23,0x61,0x20,0x64,0x20,0xb0,0x20,0x50,0x58,0x21,0xb0,0x00,0x1b,0xb0,0x30,0x50,0x58,0xb0,0x20,0x1b,0xb0,0x40,0x59,0x59,0x23,0xb0,0x00,0x50,0x58,0x65,0x59,0xb0,0x03,0x25,0x23,0x61,0x44,0x44,0xb0,0x01,0x60,0x2d,0xb0,0x0b,0x2c,0x20,0x20,0x45,0x20,0xb0,0x01,0x2b,0x23,0xb0,0x00,0x43,0xb0,0x04,0x25,0x60,0x20,0x45,0x8a,0x23,0x61,0x20,0x64,0xb0,0x24,0x50,0x58,0xb0,0x00,0x1b,0xb0,0x40,0x59,0x23,0xb0,0x00,0x50,0x58,0x65,0x59,0xb0,0x03,0x25,0x23,0x61,0x44,0x44,0xb0,0x01,0x60,0x2d,0xb0,0x0c,0x2c,0x20,0xb0,0x00,0x23,0x42,0xb2,0x0b,0x0a,0x03,0x45,0x58,0x21,0x1b,0x23,0x21,0x59,0x2a,0x21,0x2d,0xb0,0x0d,0x2c,0xb1,0x02,0x02,0x45,0xb0,0x64,0x61,0x44,0x2d,0xb0,0x0e,0x2c,0xb0,0x01,0x60,0x20,0x20,0xb0,0x0c,0x43,0x4a,0xb0,0x00,0x50,0x58,0x20,0xb0,0x0c,0x23,0x42,0x59,0xb0,0x0d,0x43,0x4a,0xb0,0x00,0x52,0x58,0x20,0xb0,0x0d,0x23,0x42,0x59,0x2d,0xb0,0x0f,0x2c,0x20,0xb0,0x10,0x62,0x66,0xb0,0x01,0x63,0x20,0xb8,0x04,0x00,0x63,0x8a,0x23,0x61,0xb0,0x0e,0x43,0x60,0x20,0x8a,0x60,0x20,0xb0,0x0e,0x23,0x42,0x23,0x2d,0xb0,0x10,0x2c,0x4b,0x54,0x58,0xb1,0x04,0x64,0x44,0x59,0x24,0xb0,0x0d,0x65,0x23,0x78,0x2d,0xb0,0x11,0x2c,0x4b,0x51,0x58,0x4b,0x53,0x58,0xb1,0x04,0x64,0x44,0x59,0x1b,0x21,0x59,0x24,0xb0,0x13,0x65,0x23,0x78,0x2d,0xb0,0x12,0x2c,0xb1,0x00,0x0f,0x43,0x55,0x58,0xb1,0x0f,0x0f,0x43,0xb0,0x01,0x61,0x42,0xb0,0x0f,0x2b,0x59,0xb0,0x00,0x43,0xb0,0x02,0x25,0x42,0xb1,0x0c,0x02,0x25,0x42,0xb1,0x0d,0x02,0x25,0x42,0xb0,0x01,0x16,0x23,0x20,0xb0,0x03,0x25,0x50,0x58,0xb1,0x01,0x00,0x43,0x60,0xb0,0x04,0x25,0x42,0x8a,0x8a,0x20,0x8a,0x23,0x61,0xb0,0x0e,0x2a,0x21,0x23,0xb0,0x01,0x61,0x20,0x8a,0x23,0x61,0xb0,0x0e,0x2a,0x21,0x1b,0xb1,0x01,0x00,0x43,0x60,0xb0,0x02,0x25,0x42,0xb0,0x02,0x25,0x61,0xb0,0x0e,0x2a,0x21,0x59,0xb0,0x0c,0x43,0x47,0xb0,0x0d,0x43,0x47,0x60,0xb0,0x02,0x62,0x20,0xb0,0x00,0x50,0x58,0xb0,0x40,0x60,0x59,0x66,0xb0,0x01,0x63,0x20,0xb0,0x0b,0x43,0x63,0xb8,0x04,0x00,0x62,0x20,0xb0,0x00,0x50,0x58,0xb0,0x40,0x60,0x59,0x66,0xb0,0x01,0x63,0x60,0xb1,0x00,0x00,0x13,0x23,0x44,0xb0,0x01,0x43,0xb0,0x00,0x3e,0xb2,0x01,0x01,0x01,0x43,0x60,0x42,0x2d,0xb0,0x13,0x2c,0x00,0xb1,0x00,0x02,0x45,0x54,0x58,0xb0,0x0f,0x23,0x42,0x20,0x45,0xb0,0x0b,0x23,0x42,0xb0,0x0a,0x23,0xb0,0x04,0x60,0x42,0x20,0x60,0xb0,0x01,0x61,0xb5,0x11,0x11,0x01,0x00,0x0e,0x00,0x42,0x42,0x8a,0x60,0xb1,0x12,0x06,0x2b,0xb0,0x89,0x2b,0x1b,0x22,0x59,0x2d,0xb0,0x14,0x2c,0xb1,0x00,0x13,0x2b,0x2d,0xb0,0x15,0x2c,0xb1,0x01,0x13,0x2b,0x2d,0xb0,0x16,0x2c,0xb1,0x02,0x13,0x2b,0x2d,0xb0,0x17,0x2c,0xb1,0x03,0x13,0x2b,0x2d,0xb0,0x18,0x2c,0xb1,0x04,0x13,0x2b,0x2d,0xb0,0x19,0x2c,0xb1,0x05,0x13,0x2b,0x2d,0xb0,0x1a,0x2c,0xb1,0x06,0x13,0x2b,0x2d,0xb0,0x1b,0x2c,0xb1,0x07,0x13,0x2b,0x2d,0xb0,0x1c,0x2c,0xb1,0x08,0x13,0x2b,0x2d,0xb0,0x1d,0x2c,0xb1,0x09,0x13,0x2b,0x2d,0xb0,0x29,0x2c,0x23,0x20,0xb0,0x10,0x62,0x66,0xb0,0x01,0x63,0xb0,0x06,0x60,0x4b,0x54,0x58,0x23,0x20,0x2e,0xb0,0x01,0x5d,0x1b,0x21,0x21,0x59,0x2d,0xb0,0x2a,0x2c,0x23,0x20,0xb0,0x10,0x62,0x66,0xb0,0x01,0x63,0xb0,0x16,0x60,0x4b,0x54,0x58,0x23,0x20,0x2e,0xb0,0x01,0x71,0x1b,0x21,0x21,0x59,0x2d,0xb0,0x2b,0x2c,0x23,0x20,0xb0,0x10,0x62,0x66,0xb0,0x01,0x63,0xb0,0x26,0x60,0x4b,0x54,0x58,0x23,0x20,0x2e,0xb0,0x01,0x72,0x1b,0x21,0x21,0x59,0x2d,0xb0,0x1e,0x2c,0x00,0xb0,0x0d,0x2b,0xb1,0x00,0x02,0x45,0x54,0x58,0xb0,0x0f,0x23,0x42,0x20,0x45,0xb0,0x0b,0x23,0x42,0xb0,0x0a,0x23,0xb0,0x04,0x60,0x42,0x20,0x60,0xb0,0x01,0x61,0xb5,0x11,0x11,0x01,0x00,0x0e,0x00,0x42,0x42,0x8a,0x60,0xb1,0x12,0x06,0x2b,0xb0,0x89,0x2b,0x1b,0x22,0x59,0x2d,0xb0,0x1f,0x2c,0xb1,0x00,0x1e,0x2b,0x2d,0xb0,0x20,0x2c,0xb1,0x01,0x1e,0x2b,0x2d,0xb0,0x21,0x2c,0xb1,0x02,0x1e,0x2b,0x2d,0xb0,0x22,0x2c,0xb1,0x03,0x1e,0x2b,0x2d,0xb0,0x23,0x2c,0xb1,0x04,0x1e,0x2b,0x2d,0xb0,0x24,0x2c,0xb1,0x05,0x1e,0x2b,0x2d,0xb0,0x25,0x2c,0xb1,0x06,0x1e,0x2b,0x2d,0xb0,0x26,0x2c,0xb1,0x07,0x1e,0x2b,0x2d,0xb0,0x27,0x2c,0xb1,0x08,0x1e,0x2b,0x2d,0xb0,0x28,0x2c,0xb1,0x09,0x1e,0x2b,0x2d,0xb0,0x2c,0x2c,0x20,0x3c,0xb0,0x01,0x60,0x2d,0xb0,0x2d,0x2c,0x20,0x60,0xb0,0x11,0x60,0x20,0x43,0x23,0xb0,0x01,0x60,0x43,0xb0,0x02,0x25,0x61,0xb0,0x01,0x60,0xb0,0x2c,0x2a,0x21,0x2d,0xb0,0x2e,0x2c,0xb0,0x2d,0x2b,0xb0,0x2d,0x2a,0x2d,0xb0,0x2f,0x2c,0x20,0x20,0x47,0x20,0x20,0xb0,0x0b,0x43,0x63,0xb8,0x04,0x00,0x62,0x20,0xb0,0x00,0x50,0x58,0xb0,0x40,0x60,0x59,0x66,0xb0,0x01,0x63,0x60,0x23,0x61,0x38,0x23,0x20,0x8a,0x55,0x58,0x20,0x47,0x20,0x20,0xb0,0x0b,0x43,0x63,0xb8,0x04,0x00,0x62,0x20,0xb0,0x00,0x50,0x58,0xb0,0x40,0x60,0x59,0x66,0xb0,0x01,0x63,0x60,0x23,0x61,0x38,0x1b,0x21,0x59,0x2d,0xb0,0x30,0x2c,0x00,0xb1,0x00,0x02,0x45,0x54,0x58,0xb0,0x01,0x16,0xb0,0x2f,0x2a,0xb1,0x05,0x01,0x15,0x45,0x58,0x30,0x59,0x1b,0x22,0x59,0x2d,0xb0,0x31,0x2c,0x00,0xb0,0x0d,0x2b,0xb1,0x00,0x02,0x45,0x54,0x58,0xb0,0x01,0x16,0xb0,0x2f,0x2a,0xb1,0x05,0x01,0x15,0x45,0x58,0x30,0x59,0x1b,0x22,0x59,0x2d,0xb0,0x32,0x2c,0x20,0x35,0xb0,0x01,0x60,0x2d,0xb0,0x33,0x2c,0x00,0xb0,0x01,0x45,0x63,0xb8,0x04,0x00,0x62,0x20,0xb0,0x00,0x50,0x58,0xb0,0x40,0x60,0x59,0x66,0xb0,0x01,0x63,0xb0,0x01,0x2b,0xb0,0x0b,0x43,0x63,0xb8,0x04,0x00,0x62,0x20,0xb0,0x00,0x50,0x58,0xb0,0x40,0x60,0x59,0x66,0xb0,0x01,0x63,0xb0,0x01,0x2b,0xb0,0x00,0x16,0xb4,0x00,0x00,0x00,0x00,0x00,0x44,0x3e,0x23,0x38,0xb1,0x32,0x01,0x15,0x2a,0x21,0x2d,0xb0,0x34,0x2c,0x20,0x3c,0x20,0x47,0x20,0xb0,0x0b,0x43,0x63,0xb8,0x04,0x00,0x62,0x20,0xb0,0x00,0x50,0x58,0xb0,0x40,0x60,0x59,0x66,0xb0,0x01,0x63,0x60,0xb0,0x00,0x43,0x61,0x38,0x2d,0xb0,0x35,0x2c,0x2e,0x17,0x3c,0x2d,0xb0,0x36,0x2c,0x20,0x3c,0x20,0x47,0x20,0xb0,0x0b,0x43,0x63,0xb8,0x04,0x00,0x62,0x20,0xb0,0x00,0x50,0x58,0xb0,0x40,0x60,0x59,0x66,0xb0,0x01,0x63,0x60,0xb0,0x00,0x43,0x61,0xb0,0x01,0x43,0x63,0x38,0x2d,0xb0,0x37,0x2c,0xb1,0x02,0x00,0x16,0x25,0x20,0x2e,0x20,0x47,0xb0,0x00,0x23,0x42,0xb0,0x02,0x25,0x49,0x8a,0x8a,0x47,0x23,0x47,0x23,0x61,0x20,0x58,0x62,0x1b,0x21,0x59,0xb0,0x01,0x23,0x42,0xb2,0x36,0x01,0x01,0x15,0x14,0x2a,0x2d,0xb0,0x38,0x2c,0xb0,0x00,0x16,0xb0,0x10,0x23,0x42,0xb0,0x04,0x25,0xb0,0x04,0x25,0x47,0x23,0x47,0x23,0x61,0xb0,0x09,0x43,0x2b,0x65,0x8a,0x2e,0x23,0x20,0x20,0x3c,0x8a,0x38,0x2d,0xb0,0x39,0x2c,0xb0,0x00,0x16,0xb0,0x10,0x23,0x42,0xb0,0x04,0x25,0xb0,0x04,0x25,0x20,0x2e,0x47,0x23,0x47,0x23,0x61,0x20,0xb0,0x04,0x23,0x42,0xb0,0x09,0x43,0x2b,0x20,0xb0,0x60,0x50,0x58,0x20,0xb0,0x40,0x51,0x58,0xb3,0x02,0x20,0x03,0x20,0x1b,0xb3,0x02,0x26,0x03,0x1a,0x59,0x42,0x42,0x23,0x20,0xb0,0x08,0x43,0x20,0x8a,0x23,0x47,0x23,0x47,0x23,0x61,0x23,0x46,0x60,0xb0,0x04,0x43,0xb0,0x02,0x62,0x20,0xb0,0x00,0x50,0x58,0xb0,0x40,0x60,0x59,0x66,0xb0,0x01,0x63,0x60,0x20,0xb0,0x01,0x2b,0x20,0x8a,0x8a,0x61,0x20,0xb0,0x02,0x43,0x60,0x64,0x23,0xb0,0x03,0x43,0x61,0x64,0x50,0x58,0xb0,0x02,0x43,0x61,0x1b,0xb0,0x03,0x43,0x60,0x59,0xb0,0x03,0x25,0xb0,0x02,0x62,0x20,0xb0,0x00,0x50,0x58,0xb0,0x40,0x60,0x59,0x66,0xb0,0x01,0x63,0x61,0x23,0x20,0x20,0xb0,0x04,0x26,0x23,0x46,0x61,0x38,0x1b,0x23,0xb0,0x08,0x43,0x46,0xb0,0x02,0x25,0xb0,0x08,0x43,0x47,0x23,0x47,0x23,0x61,0x60,0x20,0xb0,0x04,0x43,0xb0,0x02,0x62,0x20,0xb0,0x00,0x50,0x58,0xb0,0x40,0x60,0x59,0x66,0xb0,0x01,0x63,0x60,0x23,0x20,0xb0,0x01,0x2b,0x23,0xb0,0x04,0x43,0x60,0xb0,0x01,0x2b,0xb0,0x05,0x25,0x61,0xb0,0x05,0x25,0xb0,0x02,0x62,0x20,0xb0,0x00,0x50,0x58,0xb0,0x40,0x60,0x59,0x66,0xb0,0x01,0x63,0xb0,0x04,0x26,0x61,0x20,0xb0,0x04,0x25,0x60,0x64,0x23,0xb0,0x03,0x25,0x60,0x64,0x50,0x58,0x21,0x1b,0x23,0x21,0x59,0x23,0x20,0x20,0xb0,0x04,0x26,0x23,0x46,0x61,0x38,0x59,0x2d,0xb0,0x3a,0x2c,0xb0,0x00,0x16,0xb0,0x10,0x23,0x42,0x20,0x20,0x20,0xb0,0x05,0x26,0x20,0x2e,0x47,0x23,0x47,0x23,0x61,0x23,0x3c,0x38,0x2d,0xb0,0x3b,0x2c,0xb0,0x00,0x16,0xb0,0x10,0x23,0x42,0x20,0xb0,0x08,0x23,0x42,0x20,0x20,0x20,0x46,0x23,0x47,0xb0,0x01,0x2b,0x23,0x61,0x38,0x2d,0xb0,0x3c,0x2c,0xb0,0x00,0x16,0xb0,0x10,0x23,0x42,0xb0,0x03,0x25,0xb0,0x02,0x25,0x47,0x23,0x47,0x23,0x61,0xb0,0x00,0x54,0x58,0x2e,0x20,0x3c,0x23,0x21,0x1b,0xb0,0x02,0x25,0xb0,0x02,0x25,0x47,0x23,0x47,0x23,0x61,0x20,0xb0,0x05,0x25,0xb0,0x04,0x25,0x47,0x23,0x47,0x23,0x61,0xb0,0x06,0x25,0xb0,0x05,0x25,0x49,0xb0,0x02,0x25,0x61,0xb9,0x08,0x00,0x08,0x00,0x63,0x63,0x23,0x20,0x58,0x62,0x1b,0x21,0x59,0x63,0xb8,0x04,0x00,0x62,0x20,0xb0,0x00,0x50,0x58,0xb0,0x40,0x60,0x59,0x66,0xb0,0x01,0x63,0x60,0x23,0x2e,0x23,0x20,0x20,0x3c,0x8a,0x38,0x23,0x21,0x59,0x2d,0xb0,0x3d,0x2c,0xb0,0x00,0x16,0xb0,0x10,0x23,0x42,0x20,0xb0,0x08,0x43,0x20,0x2e,0x47,0x23,0x47,0x23,0x61,0x20,0x60,0xb0,0x20,0x60,0x66,0xb0,0x02,0x62,0x20,0xb0,0x00,0x50,0x58,0xb0,0x40,0x60,0x59,0x66,0xb0,0x01,0x63,0x23,0x20,0x20,0x3c,0x8a,0x38,0x2d,0xb0,0x3e,0x2c,0x23,0x20,0x2e,0x46,0xb0,0x02,0x25,0x46,0xb0,0x10,0x43,0x58,0x50,0x1b,0x52,0x59,0x58,0x20,0x3c,0x59,0x2e,0xb1,0x2e,0x01,0x14,0x2b,0x2d,0xb0,0x3f,0x2c,0x23,0x20,0x2e,0x46,0xb0,0x02,0x25,0x46,0xb0,0x10,0x43,0x58,0x52,0x1b,0x50,0x59,0x58,0x20,0x3c,0x59,0x2e,0xb1,0x2e,0x01,0x14,0x2b,0x2d,0xb0,0x40,0x2c,0x23,0x20,0x2e,0x46,0xb0,0x02,0x25,0x46,0xb0,0x10,0x43,0x58,0x50,0x1b,0x52,0x59,0x58,0x20,0x3c,0x59,0x23,0x20,0x2e,0x46,0xb0,0x02,0x25,0x46,0xb0,0x10,0x43,0x58,0x52,0x1b,0x50,0x59,0x58,0x20,0x3c,0x59,0x2e,0xb1,0x2e,0x01,0x14,0x2b,0x2d,0xb0,0x41,0x2c,0xb0,0x38,0x2b,0x23,0x20,0x2e,0x46,0xb0,0x02,0x25,0x46,0xb0,0x10,0x43,0x58,0x50,0x1b,0x52,0x59,0x58,0x20,0x3c,0x59,0x2e,0xb1,0x2e,0x01,0x14,0x2b,0x2d,0xb0,0x42,0x2c,0xb0,0x39,0x2b,0x8a,0x20,0x20,0x3c,0xb0,0x04,0x23,0x42,0x8a,0x38,0x23,0x20,0x2e,0x46,0xb0,0x02,0x25,0x46,0xb0,0x10,0x43,0x58,0x50,0x1b,0x52,0x59,0x58,0x20,0x3c,0x59,0x2e,0xb1,0x2e,0x01,0x14,0x2b,0xb0,0x04,0x43,0x2e,0xb0,0x2e,0x2b,0x2d,0xb0,0x43,0x2c,0xb0,0x00,0x16,0xb0,0x04,0x25,0xb0,0x04,0x26,0x20,0x2e,0x47,0x23,0x47,0x23,0x61,0xb0,0x09,0x43,0x2b,0x23,0x20,0x3c,0x20,0x2e,0x23,0x38,0xb1,0x2e,0x01,0x14,0x2b,0x2d,0xb0,0x44,0x2c,0xb1,0x08,0x04,0x25,0x42,0xb0,0x00,0x16,0xb0,0x04,0x25,0xb0,0x04,0x25,0x20,0x2e,0x47,0x23,0x47,0x23,0x61,0x20,0xb0,0x04,0x23,0x42,0xb0,0x09,0x43,0x2b,0x20,0xb0,0x60,0x50,0x58,0x20,0xb0,0x40,0x51,0x58,0xb3,0x02,0x20,0x03,0x20,0x1b,0xb3,0x02,0x26,0x03,0x1a,0x59,0x42,0x42,0x23,0x20,0x47,0xb0,0x04,0x43,0xb0,0x02,0x62,0x20,0xb0,0x00,0x50,0x58,0xb0,0x40,0x60,0x59,0x66,0xb0,0x01,0x63,0x60,0x20,0xb0,0x01,0x2b,0x20,0x8a,0x8a,0x61,0x20,0xb0,0x02,0x43,0x60,0x64,0x23,0xb0,0x03,0x43,0x61,0x64,0x50,0x58,0xb0,0x02,0x43,0x61,0x1b,0xb0,0x03,0x43,0x60,0x59,0xb0,0x03,0x25,0xb0,0x02,0x62,0x20,0xb0,0x00,0x50,0x58,0xb0,0x40,0x60,0x59,0x66,0xb0,0x01,0x63,0x61,0xb0,0x02,0x25,0x46,0x61,0x38,0x23,0x20,0x3c,0x23,0x38,0x1b,0x21,0x20,0x20,0x46,0x23,0x47,0xb0,0x01,0x2b,0x23,0x61,0x38,0x21,0x59,0xb1,0x2e,0x01,0x14,0x2b,0x2d,0xb0,0x45,0x2c,0xb1,0x00,0x38,0x2b,0x2e,0xb1,0x2e,0x01,0x14,0x2b,0x2d,0xb0,0x46,0x2c,0xb1,0x00,0x39,0x2b,0x21,0x23,0x20,0x20,0x3c,0xb0,0x04,0x23,0x42,0x23,0x38,0xb1,0x2e,0x01,0x14,0x2b,0xb0,0x04,0x43,0x2e,0xb0,0x2e,0x2b,0x2d,0xb0,0x47,0x2c,0xb0,0x00,0x15,0x20,0x47,0xb0,0x00,0x23,0x42,0xb2,0x00,0x01,0x01,0x15,0x14,0x13,0x2e,0xb0,0x34,0x2a,0x2d,0xb0,0x48,0x2c,0xb0,0x00,0x15,0x20,0x47,0xb0,0x00,0x23,0x42,0xb2,0x00,0x01,0x01,0x15,0x14,0x13,0x2e,0xb0,0x34,0x2a,0x2d,0xb0,0x49,0x2c,0xb1,0x00,0x01,0x14,0x13,0xb0,0x35,0x2a,0x2d,0xb0,0x4a,0x2c,0xb0,0x37,0x2a,0x2d,0xb0,0x4b,0x2c,0xb0,0x00,0x16,0x45,0x23,0x20,0x2e,0x20,0x46,0x8a,0x23,0x61,0x38,0xb1,0x2e,0x01,0x14,0x2b,0x2d,0xb0,0x4c,0x2c,0xb0,0x08,0x23,0x42,0xb0,0x4b,0x2b,0x2d,0xb0,0x4d,0x2c,0xb2,0x00,0x00,0x44,0x2b,0x2d,0xb0,0x4e,0x2c,0xb2,0x00,0x01,0x44,0x2b,0x2d,0xb0,0x4f,0x2c,0xb2,0x01,0x00,0x44,0x2b,0x2d,0xb0,0x50,0x2c,0xb2,0x01,0x01,0x44,0x2b,0x2d,0xb0,0x51,0x2c,0xb2,0x00,0x00,0x45,0x2b,0x2d,0xb0,0x52,0x2c,0xb2,0x00,0x01,0x45,0x2b,0x2d,0xb0,0x53,0x2c,0xb2,0x01,0x00,0x45,0x2b,0x2d,0xb0,0x54,0x2c,0xb2,0x01,0x01,0x45,0x2b,0x2d,0xb0,0x55,0x2c,0xb3,0x00,0x00,0x00,0x41,0x2b,0x2d,0xb0,0x56,0x2c,0xb3,0x00,0x01,0x00,0x41,0x2b,0x2d,0xb0,0x57,0x2c,0xb3,0x01,0x00,0x00,0x41,0x2b,0x2d,0xb0,0x58,0x2c,0xb3,0x01,0x01,0x00,0x41,0x2b,0x2d,0xb0,0x59,0x2c,0xb3,0x00,0x00,0x01,0x41,0x2b,0x2d,0xb0,0x5a,0x2c,0xb3,0x00,0x01,0x01,0x41,0x2b,0x2d,0xb0,0x5b,0x2c,0xb3,0x01,0x00,0x01,0x41,0x2b,0x2d,0xb0,0x5c,0x2c,0xb3,0x01,0x01,0x01,0x41,0x2b,0x2d,0xb0,0x5d,0x2c,0xb2,0x00,0x00,0x43,0x2b,0x2d,0xb0,0x5e,0x2c,0xb2,0x00,0x01,0x43,0x2b,0x2d,0xb0,0x5f,0x2c,0xb2,0x01,0x00,0x43,0x2b,0x2d,0xb0,0x60,0x2c,0xb2,0x01,0x01,0x43,0x2b,0x2d,0xb0,0x61,0x2c,0xb2,0x00,0x00,0x46,0x2b,0x2d,0xb0,0x62,0x2c,0xb2,0x00,0x01,0x46,0x2b,0x2d,0xb0,0x63,0x2c,0xb2,0x01,0x00,0x46,0x2b,0x2d,0xb0,0x64,0x2c,0xb2,0x01,0x01,0x46,0x2b,0x2d,0xb0,0x65,0x2c,0xb3,0x00,0x00,0x00,0x42,0x2b,0x2d,0xb0,0x66,0x2c,0xb3,0x00,0x01,0x00,0x42,0x2b,0x2d,0xb0,0x67,0x2c,0xb3,0x01,0x00,0x00,0x42,0x2b,0x2d,0xb0,0x68,0x2c,0xb3,0x01,0x01,0x00,0x42,0x2b,0x2d,0xb0,0x69,0x2c,0xb3,0x00,0x00,0x01,0x42,0x2b,0x2d,0xb0,0x6a,0x2c,0xb3,0x00,0x01,0x01,0x42,0x2b,0x2d,0xb0,0x6b,0x2c,0xb3,0x01,0x00,0x01,0x42,0x2b,0x2d,0xb0,0x6c,0x2c,0xb3,0x01,0x01,0x01,0x42,0x2b,0x2d,0xb0,0x6d,0x2c,0xb1,0x00,0x3a,0x2b,0x2e,0xb1,0x2e,0x01,0x14,0x2b,0x2d,0xb0,0x6e,0x2c,0xb1,0x00,0x3a,0x2b,0xb0,0x3e,0x2b,0x2d,0xb0,0x6f,0x2c,0xb1,0x00,0x3a,0x2b,0xb0,0x3f,0x2b,0x2d,0xb0,0x70,0x2c,0xb0,0x00,0x16,0xb1,0x00,0x3a,0x2b,0xb0,0x40,0x2b,0x2d,0xb0,0x71,0x2c,0xb1,0x01,0x3a,0x2b,0xb0,0x3e,0x2b,0x2d,0xb0,0x72,0x2c,0xb1,0x01,0x3a,0x2b,0xb0,0x3f,0x2b,0x2d,0xb0,0x73,0x2c,0xb0,0x00,0x16,0xb1,0x01,0x3a,0x2b,0xb0,0x40,0x2b,0x2d,0xb0,0x74,0x2c,0xb1,0x00,0x3b,0x2b,0x2e,0xb1,0x2e,0x01,0x14,0x2b,0x2d,0xb0,0x75,0x2c,0xb1,0x00,0x3b,0x2b,0xb0,0x3e,0x2b,0x2d,0xb0,0x76,0x2c,0xb1,0x00,0x3b,0x2b,0xb0,0x3f,0x2b,0x2d,0xb0,0x77,0x2c,0xb1,0x00,0x3b,0x2b,0xb0,0x40,0x2b,0x2d,0xb0,0x78,0x2c,0xb1,0x01,0x3b,0x2b,0xb0,0x3e,0x2b,0x2d,0xb0,0x79,0x2c,0xb1,0x01,0x3b,0x2b,0xb0,0x3f,0x2b,0x2d,0xb0,0x7a,0x2c,0xb1,0x01,0x3b,0x2b,0xb0,0x40,0x2b,0x2d,0xb0,0x7b,0x2c,0xb1,0x00,0x3c,0x2b,0x2e,0xb1,0x2e,0x01,0x14,0x2b,0x2d,0xb0,0x7c,0x2c,0xb1,0x00,0x3c,0x2b,0xb0,0x3e,0x2b,0x2d,0xb0,0x7d,0x2c,0xb1,0x00,0x3c,0x2b,0xb0,0x3f,0x2b,0x2d,0xb0,0x7e,0x2c,0xb1,0x00,0x3c,0x2b,0xb0,0x40,0x2b,0x2d,0xb0,0x7f,0x2c,0xb1,0x01,0x3c,0x2b,0xb0,0x3e,0x2b,0x2d,0xb0,0x80,0x2c,0xb1,0x01,0x3c,0x2b,0xb0,0x3f,0x2b,0x2d,0xb0,0x81,0x2c,0xb1,0x01,0x3c,0x2b,0xb0,0x40,0x2b,0x2d,0xb0,0x82,0x2c,0xb1,0x00,0x3d,0x2b,0x2e,0xb1,0x2e,0x01,0x14,0x2b,0x2d,0xb0,0x83,0x2c,0xb1,0x00,0x3d,0x2b,0xb0,0x3e,0x2b,0x2d,0xb0,0x84,0x2c,0xb1,0x00,0x3d,0x2b,0xb0,0x3f,0x2b,0x2d,0xb0,0x85,0x2c,0xb1,0x00,0x3d,0x2b,0xb0,0x40,0x2b,0x2d,0xb0,0x86,0x2c,0xb1,0x01,0x3d,0x2b,0xb0,0x3e,0x2b,0x2d,0xb0,0x87,0x2c,0xb1,0x01,0x3d,0x2b,0xb0,0x3f,0x2b,0x2d,0xb0,0x88,0x2c,0xb1,0x01,0x3d,0x2b,0xb0,0x40,0x2b,0x2d,0xb0,0x89,0x2c,0xb3,0x09,0x04,0x02,0x03,0x45,0x58,0x21,0x1b,0x23,0x21,0x59,0x42,0x2b,0xb0,0x08,0x65,0xb0,0x03,0x24,0x50,0x78,0xb1,0x05,0x01,0x15,0x45,0x58,0x30,0x59,0x2d,0x00,0x00,0x00,0x4b,0xb8,0x00,0xc8,0x52,0x58,0xb1,0x01,0x01,0x8e,0x59,0xb0,0x01,0xb9,0x08,0x00,0x08,0x00,0x63,0x70,0xb1,0x00,0x07,0x42,0xb5,0x58,0x44,0x30,0x00,0x04,0x00,0x2a,0xb1,0x00,0x07,0x42,0x40,0x0a,0x4b,0x08,0x37,0x08,0x23,0x08,0x15,0x05,0x04,0x08,0x2a,0xb1,0x00,0x07,0x42,0x40,0x0a,0x55,0x06,0x41,0x06,0x2d,0x06,0x1c,0x03,0x04,0x08,0x2a,0xb1,0x00,0x0b,0x42,0xbd,0x13,0x00,0x0e,0x00,0x09,0x00,0x05,0x80,0x00,0x04,0x00,0x09,0x2a,0xb1,0x00,0x0f,0x42,0xbd,0x00,0x40,0x00,0x40,0x00,0x40,0x00,0x40,0x00,0x04,0x00,0x09,0x2a,0xb1,0x03,0x00,0x44,0xb1,0x24,0x01,0x88,0x51,0x58,0xb0,0x40,0x88,0x58,0xb1,0x03,0x64,0x44,0xb1,0x26,0x01,0x88,0x51,0x58,0xba,0x08,0x80,0x00,0x01,0x04,0x40,0x88,0x63,0x54,0x58,0xb1,0x03,0x00,0x44,0x59,0x59,0x59,0x59,0x40,0x0a,0x4d,0x08,0x39,0x08,0x25,0x08,0x17,0x05,0x04,0x0c,0x2a,0xb8,0x01,0xff,0x85,0xb0,0x04,0x8d,0xb1,0x02,0x00,0x44,0xb3,0x05,0x64,0x06,0x00,0x44,0x44,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x5b,0x00,0x5b,0x00,0x50,0x00,0x50,0x02,0x4e,0x00,0x00,0xff,0x3f,0x04,0x01,0xfe,0xe2,0x02,0x54,0xff,0xfb,0xff,0x3f,0x04,0x01,0xfe,0xe2,0x00,0x5b,0x00,0x5b,0x00,0x53,0x00,0x53,0x02,0xba,0x00,0x00,0x02,0xdf,0x01,0xfe,0x00,0x00,0xff,0x15,0x04,0x01,0xfe,0xe2,0x02,0xc4,0xff,0xf6,0x02,0xdf,0x02,0x08,0xff,0xf6,0xff,0x15,0x04,0x01,0xfe,0xe2,0x00,0x5b,0x00,0x5b,0x00,0x53,0x00,0x53,0x01,0x8a,0x00,0x00,0x02,0xdf,0x02,0x08,0xff,0xf6,0xff,0x15,0x04,0x01,0xfe,0xe2,0x01,0x8f,0xff,0xfb,0x02,0xdf,0x02,0x08,0xff,0xf6,0xff,0x15,0x04,0x01,0xfe,0xe2,0x00,0x5b,0x00,0x5b,0x00,0x53,0x00,0x53,0x02,0xc0,0x01,0x36,0x02,0xdf,0x01,0xfe,0x00,0x00,0xff,0x15,0x04,0x01,0xfe,0xe2,0x02,0xc5,0x01,0x30,0x02,0xdf,0x02,0x08,0xff,0xf6,0xff,0x15,0x04,0x01,0xfe,0xe2,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x2c,0x00,0x64,0x00,0xca,0x01,0x30,0x01,0x90,0x01,0xf2,0x02,0x12,0x02,0x3e,0x02,0x6a,0x02,0xc4,0x02,0xf0,0x03,0x16,0x03,0x2e,0x03,0x48,0x03,0x6a,0x03,0x90,0x03,0xbe,0x03,0xfe,0x04,0x48,0x04,0x7e,0x04,0xc6,0x05,0x06,0x05,0x2e,0x05,0x7a,0x05,0xbc,0x05,0xea,0x06,0x24,0x06,0x52,0x06,0x7e,0x06,0xac,0x06,0xf4,0x07,0x6a,0x07,0xa0,0x07,0xd8,0x08,0x16,0x08,0x42,0x08,0x72,0x08,0x9c,0x08,0xe2,0x09,0x12,0x09,0x2c,0x09,0x52,0x09,0x88,0x09,0xa8,0x09,0xe6,0x0a,0x16,0x0a,0x48,0x0a,0x76,0x0a,0xb8,0x0a,0xf4,0x0b,0x3e,0x0b,0x62,0x0b,0x92,0x0b,0xbc,0x0c,0x02,0x0c,0x3e,0x0c,0x6a,0x0c,0x98,0x0c,0xbc,0x0c,0xde,0x0d,0x02,0x0d,0x2e,0x0d,0x48,0x0d,0x52,0x0d,0x96,0x0d,0xd0,0x0e,0x0a,0x0e,0x44,0x0e,0x80,0x0e,0xbe,0x0f,0x06,0x0f,0x3a,0x0f,0x68,0x0f,0xa4,0x0f,0xd8,0x0f,0xf2,0x10,0x3e,0x10,0x72,0x10,0xa4,0x10,0xe0,0x11,0x1c,0x11,0x46,0x11,0x8a,0x11,0xc2,0x11,0xf6,0x12,0x24,0x12,0x68,0x12,0x9e,0x12,0xcc,0x12,0xf8,0x13,0x3c,0x13,0x56,0x13,0x9a,0x13,0xd4,0x13,0xd4,0x14,0x02,0x14,0x62,0x14,0xd0,0x15,0x30,0x15,0x80,0x15,0xac,0x16,0x10,0x16,0x1a,0x16,0x7c,0x16,0xd0,0x17,0x12,0x17,0x32,0x17,0x3a,0x17,0xa0,0x17,0xaa,0x17,0xd6,0x18,0x16,0x18,0x52,0x18,0x9c,0x18,0xa6,0x18,0xde,0x19,0x10,0x19,0x2a,0x19,0x34,0x19,0x64,0x19,0x9c,0x19,0xde,0x1a,0x50,0x1a,0xce,0x1b,0x5a,0x1b,0xa2,0x1b,0xee,0x1c,0x3a,0x1c,0x94,0x1c,0xf8,0x1d,0x4e,0x1d,0xa4,0x1d,0xea,0x1e,0x54,0x1e,0x9c,0x1e,0xe4,0x1f,0x38,0x1f,0x88,0x1f,0xb8,0x1f,0xe8,0x20,0x24,0x20,0x5c,0x20,0x9c,0x20,0xfc,0x21,0x44,0x21,0x8e,0x21,0xe4,0x22,0x44,0x22,0x96,0x22,0xcc,0x23,0x22,0x23,0x68,0x23,0xb0,0x24,0x04,0x24,0x54,0x24,0x96,0x24,0xc8,0x25,0x16,0x25,0x22,0x25,0x2e,0x25,0x3a,0x25,0x46,0x25,0x52,0x25,0x5e,0x25,0xcc,0x26,0x32,0x26,0x3e,0x26,0x4a,0x26,0x56,0x26,0x62,0x26,0x90,0x26,0xc0,0x26,0xfc,0x27,0x34,0x27,0x90,0x27,0x9c,0x27,0xa8,0x27,0xb4,0x27,0xc0,0x27,0xcc,0x27,0xd8,0x28,0x12,0x28,0x64,0x28,0x70,0x28,0x7c,0x28,0x88,0x28,0x94,0x28,0xa0,0x28,0xdc,0x28,0xe8,0x29,0x04,0x29,0x20,0x29,0x4a,0x29,0x7e,0x29,0x98,0x29,0xc2,0x29,0xd8,0x29,0xfe,0x2a,0x30,0x2a,0x56,0x2a,0x8c,0x2a,0xb6,0x2a,0xe8,0x2b,0x12,0x2b,0x36,0x2b,0x56,0x2b,0x6c,0x2b,0x92,0x2b,0xb6,0x2b,0xec,0x2c,0x10,0x2c,0x3a,0x2c,0x52,0x00,0x00,0x00,0x02,0x00,0x52,0xff,0xfc,0x00,0xc9,0x02,0xbf,0x00,0x0f,0x00,0x1b,0x00,0x00,0x36,0x26,0x27,0x03,0x35,0x34,0x36,0x33,0x32,0x16,0x1d,0x01,0x03,0x0e,0x01,0x23,0x06,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x7e,0x12,0x01,0x12,0x1e,0x16,0x16,0x1d,0x12,0x01,0x11,0x0f,0x18,0x23,0x23,0x18,0x19,0x23,0x23,0x19,0xc1,0x10,0x0d,0x01,0x4a,0x63,0x16,0x1e,0x1e,0x16,0x63,0xfe,0xb6,0x0d,0x10,0xc5,0x23,0x19,0x18,0x23,0x23,0x18,0x19,0x23,0x00,0x02,0x00,0x3c,0x01,0xec,0x01,0x5f,0x02,0xeb,0x00,0x11,0x00,0x22,0x00,0x00,0x12,0x26,0x27,0x2e,0x01,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x07,0x0e,0x01,0x23,0x32,0x26,0x27,0x26,0x37,0x3e,0x01,0x33,0x32,0x16,0x15,0x14,0x06,0x07,0x0e,0x01,0x23,0x64,0x10,0x02,0x08,0x0e,0x1e,0x15,0x15,0x1e,0x0e,0x08,0x02,0x10,0x0b,0xb2,0x10,0x02,0x19,0x03,0x01,0x1e,0x14,0x15,0x1e,0x0e,0x08,0x02,0x10,0x0b,0x01,0xec,0x0e,0x0b,0x29,0x65,0x26,0x15,0x1d,0x1d,0x15,0x26,0x65,0x29,0x0b,0x0e,0x0e,0x0b,0x7a,0x3a,0x15,0x1d,0x1d,0x15,0x26,0x65,0x29,0x0b,0x0e,0x00,0x00,0x00,0x00,0x02,0x00,0x24,0xff,0xfb,0x02,0x3f,0x02,0x94,0x00,0x47,0x00,0x4b,0x00,0x00,0x16,0x26,0x35,0x34,0x37,0x23,0x22,0x26,0x35,0x34,0x36,0x3b,0x01,0x37,0x23,0x22,0x26,0x35,0x34,0x36,0x3b,0x01,0x37,0x3e,0x01,0x33,0x32,0x16,0x15,0x14,0x07,0x33,0x37,0x3e,0x01,0x33,0x32,0x16,0x15,0x14,0x07,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x07,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x07,0x0e,0x01,0x23,0x22,0x26,0x35,0x34,0x37,0x23,0x07,0x0e,0x01,0x23,0x13,0x33,0x37,0x23,0x91,0x15,0x18,0x4d,0x0e,0x15,0x15,0x0e,0x58,0x18,0x4d,0x0e,0x15,0x15,0x0e,0x58,0x19,0x02,0x13,0x0e,0x10,0x13,0x18,0x7f,0x19,0x02,0x13,0x0e,0x10,0x13,0x18,0x4d,0x0e,0x15,0x15,0x0e,0x58,0x18,0x4d,0x0e,0x15,0x15,0x0e,0x58,0x19,0x02,0x14,0x0d,0x0e,0x15,0x18,0x7f,0x19,0x02,0x14,0x0d,0x47,0x7f,0x18,0x7f,0x05,0x14,0x0f,0x04,0x94,0x15,0x0e,0x0e,0x15,0x98,0x15,0x0e,0x0e,0x15,0x9e,0x0c,0x10,0x14,0x0f,0x07,0x90,0x9e,0x0c,0x10,0x14,0x0f,0x07,0x90,0x15,0x0e,0x0e,0x15,0x98,0x15,0x0e,0x0e,0x15,0x9e,0x0c,0x11,0x14,0x0f,0x04,0x94,0x9e,0x0c,0x11,0x01,0x01,0x98,0x00,0x00,0x00,0x03,0x00,0x33,0xff,0x92,0x02,0x3d,0x03,0x28,0x00,0x38,0x00,0x3f,0x00,0x45,0x00,0x00,0x24,0x0e,0x01,0x07,0x15,0x14,0x06,0x23,0x22,0x26,0x3d,0x01,0x26,0x27,0x2e,0x01,0x35,0x34,0x36,0x33,0x32,0x17,0x16,0x17,0x35,0x2e,0x02,0x35,0x34,0x3e,0x01,0x37,0x35,0x34,0x36,0x33,0x32,0x16,0x1d,0x01,0x16,0x17,0x16,0x15,0x14,0x06,0x23,0x22,0x27,0x26,0x27,0x15,0x1e,0x02,0x15,0x00,0x16,0x17,0x35,0x0e,0x01,0x15,0x00,0x35,0x34,0x26,0x27,0x15,0x02,0x3d,0x39,0x69,0x45,0x11,0x0e,0x0d,0x11,0x6c,0x5e,0x0c,0x10,0x17,0x12,0x0a,0x09,0x51,0x59,0x44,0x5d,0x3e,0x33,0x65,0x47,0x11,0x0d,0x0d,0x12,0x62,0x4c,0x1c,0x16,0x12,0x06,0x0a,0x44,0x4e,0x48,0x5f,0x40,0xfe,0x58,0x43,0x41,0x3c,0x48,0x01,0x4e,0x47,0x46,0x84,0x56,0x33,0x04,0x47,0x0d,0x11,0x10,0x0e,0x47,0x07,0x28,0x05,0x17,0x0d,0x11,0x19,0x04,0x24,0x04,0xe6,0x12,0x2a,0x4d,0x3b,0x34,0x58,0x3a,0x06,0x46,0x0d,0x12,0x12,0x0d,0x45,0x04,0x1d,0x0a,0x1e,0x10,0x1a,0x04,0x18,0x03,0xee,0x11,0x28,0x4f,0x41,0x01,0x19,0x30,0x11,0xdc,0x08,0x39,0x2e,0xfe,0x59,0x68,0x27,0x2b,0x13,0xd7,0x00,0x00,0x00,0x00,0x05,0x00,0x2b,0xff,0xee,0x03,0x03,0x02,0xcb,0x00,0x0b,0x00,0x1c,0x00,0x28,0x00,0x34,0x00,0x40,0x00,0x00,0x12,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x02,0x26,0x35,0x34,0x37,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x01,0x0e,0x01,0x23,0x12,0x36,0x35,0x34,0x26,0x23,0x22,0x06,0x15,0x14,0x16,0x33,0x00,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x3e,0x01,0x35,0x34,0x26,0x23,0x22,0x06,0x15,0x14,0x16,0x33,0x7f,0x54,0x54,0x4d,0x4d,0x54,0x54,0x4d,0x0d,0x14,0x05,0x01,0x97,0x0a,0x12,0x0f,0x13,0x07,0xfe,0x6c,0x05,0x10,0x09,0x2b,0x30,0x30,0x2b,0x2b,0x30,0x30,0x2b,0x01,0x49,0x54,0x54,0x4d,0x4d,0x54,0x54,0x4d,0x2b,0x30,0x30,0x2b,0x2b,0x30,0x30,0x2b,0x01,0x65,0x65,0x4e,0x4e,0x65,0x65,0x4e,0x4e,0x65,0xfe,0x91,0x13,0x0e,0x09,0x08,0x02,0x8b,0x10,0x10,0x0e,0x0b,0x0b,0xfd,0x79,0x08,0x0a,0x01,0xb0,0x40,0x32,0x32,0x40,0x40,0x32,0x32,0x40,0xfe,0x48,0x65,0x4e,0x4e,0x65,0x65,0x4e,0x4e,0x65,0x41,0x40,0x32,0x32,0x40,0x40,0x32,0x32,0x40,0x00,0x00,0x02,0x00,0x47,0xff,0xf6,0x02,0x94,0x02,0xc4,0x00,0x3a,0x00,0x43,0x00,0x00,0x16,0x2e,0x01,0x35,0x34,0x36,0x37,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x32,0x17,0x1e,0x01,0x15,0x14,0x06,0x23,0x22,0x27,0x26,0x23,0x22,0x06,0x15,0x14,0x1e,0x01,0x1f,0x01,0x36,0x37,0x3e,0x01,0x33,0x32,0x16,0x15,0x14,0x07,0x06,0x07,0x17,0x1e,0x01,0x15,0x14,0x06,0x23,0x22,0x2f,0x01,0x0e,0x01,0x23,0x36,0x37,0x27,0x0e,0x01,0x15,0x14,0x16,0x33,0xe8,0x6e,0x33,0x47,0x2a,0x1e,0x1f,0x2d,0x55,0x39,0x43,0x42,0x07,0x0b,0x14,0x0f,0x08,0x0a,0x30,0x2e,0x32,0x39,0x13,0x26,0x2b,0xd1,0x0e,0x13,0x05,0x15,0x0d,0x12,0x18,0x05,0x14,0x1c,0x43,0x08,0x08,0x16,0x13,0x12,0x0d,0x43,0x2b,0x68,0x3a,0x4d,0x45,0xdf,0x22,0x30,0x57,0x40,0x0a,0x3b,0x5e,0x35,0x44,0x61,0x1b,0x24,0x42,0x2b,0x30,0x50,0x2f,0x2c,0x04,0x11,0x09,0x0e,0x15,0x05,0x1a,0x37,0x25,0x1d,0x2c,0x2a,0x28,0xc5,0x14,0x29,0x0b,0x0e,0x17,0x12,0x0a,0x0a,0x2b,0x27,0x40,0x07,0x0e,0x0b,0x11,0x18,0x0c,0x40,0x24,0x2a,0x4d,0x38,0xd1,0x16,0x46,0x2f,0x37,0x47,0x00,0x00,0x00,0x01,0x00,0x3c,0x01,0xec,0x00,0xa2,0x02,0xeb,0x00,0x11,0x00,0x00,0x12,0x26,0x27,0x2e,0x01,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x07,0x0e,0x01,0x23,0x64,0x10,0x02,0x08,0x0e,0x1e,0x15,0x15,0x1e,0x0e,0x08,0x02,0x10,0x0b,0x01,0xec,0x0e,0x0b,0x29,0x65,0x26,0x15,0x1d,0x1d,0x15,0x26,0x65,0x29,0x0b,0x0e,0x00,0x00,0x00,0x01,0x00,0x33,0xff,0x66,0x01,0x09,0x03,0x00,0x00,0x1b,0x00,0x00,0x16,0x26,0x27,0x2e,0x01,0x35,0x34,0x36,0x37,0x3e,0x01,0x33,0x32,0x16,0x15,0x14,0x07,0x0e,0x01,0x15,0x14,0x16,0x17,0x16,0x15,0x14,0x06,0x23,0xd5,0x0d,0x08,0x46,0x47,0x47,0x46,0x08,0x0d,0x0c,0x10,0x18,0x06,0x37,0x3e,0x3e,0x37,0x06,0x18,0x10,0x9a,0x08,0x0a,0x53,0xe7,0x81,0x81,0xe7,0x53,0x0a,0x08,0x16,0x11,0x0b,0x0b,0x5b,0xcb,0x6a,0x6a,0xcb,0x5b,0x0b,0x0b,0x11,0x16,0x00,0x00,0x01,0x00,0x30,0xff,0x66,0x01,0x06,0x03,0x00,0x00,0x1b,0x00,0x00,0x16,0x26,0x35,0x34,0x37,0x3e,0x01,0x35,0x34,0x26,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x17,0x1e,0x01,0x15,0x14,0x06,0x07,0x0e,0x01,0x23,0x48,0x18,0x06,0x37,0x3e,0x3e,0x37,0x06,0x18,0x10,0x0c,0x0d,0x08,0x46,0x47,0x47,0x46,0x08,0x0d,0x0c,0x9a,0x16,0x11,0x0b,0x0b,0x5b,0xcb,0x6a,0x6a,0xcb,0x5b,0x0b,0x0b,0x11,0x16,0x08,0x0a,0x53,0xe7,0x81,0x81,0xe7,0x53,0x0a,0x08,0x00,0x00,0x01,0x00,0x42,0x01,0x80,0x01,0x5e,0x02,0xbe,0x00,0x3f,0x00,0x00,0x12,0x26,0x35,0x34,0x37,0x06,0x07,0x06,0x23,0x22,0x27,0x26,0x35,0x34,0x3f,0x01,0x27,0x26,0x35,0x34,0x37,0x36,0x33,0x32,0x17,0x16,0x17,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x36,0x37,0x36,0x33,0x32,0x17,0x16,0x15,0x14,0x0f,0x01,0x17,0x16,0x15,0x14,0x07,0x06,0x23,0x22,0x27,0x26,0x27,0x16,0x15,0x14,0x06,0x23,0xc4,0x12,0x10,0x50,0x04,0x06,0x07,0x11,0x0a,0x04,0x0e,0x64,0x64,0x0e,0x04,0x0a,0x10,0x07,0x07,0x04,0x50,0x10,0x12,0x0c,0x0c,0x12,0x10,0x50,0x04,0x05,0x09,0x10,0x0a,0x04,0x0e,0x64,0x64,0x0e,0x04,0x0a,0x11,0x07,0x06,0x04,0x50,0x10,0x12,0x0c,0x01,0x80,0x11,0x0c,0x04,0x66,0x41,0x02,0x03,0x0f,0x07,0x09,0x11,0x07,0x27,0x27,0x08,0x11,0x09,0x07,0x0f,0x04,0x02,0x41,0x66,0x04,0x0c,0x11,0x11,0x0c,0x04,0x66,0x41,0x02,0x04,0x0f,0x08,0x07,0x11,0x09,0x27,0x27,0x08,0x11,0x07,0x08,0x0f,0x03,0x02,0x41,0x66,0x04,0x0c,0x11,0x00,0x01,0x00,0x28,0x00,0x68,0x02,0x0a,0x02,0x4b,0x00,0x1f,0x00,0x00,0x24,0x26,0x3d,0x01,0x23,0x22,0x26,0x35,0x34,0x36,0x3b,0x01,0x35,0x34,0x36,0x33,0x32,0x16,0x1d,0x01,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x15,0x14,0x06,0x23,0x01,0x09,0x17,0xa4,0x10,0x16,0x16,0x10,0xa4,0x17,0x10,0x11,0x16,0xa3,0x11,0x16,0x16,0x11,0xa3,0x16,0x11,0x68,0x17,0x10,0xa4,0x16,0x10,0x11,0x16,0xa4,0x11,0x16,0x16,0x11,0xa4,0x16,0x11,0x10,0x16,0xa4,0x10,0x17,0x00,0x01,0x00,0x3f,0xff,0x69,0x00,0xbf,0x00,0x73,0x00,0x18,0x00,0x00,0x16,0x26,0x35,0x34,0x37,0x3e,0x01,0x35,0x23,0x22,0x26,0x3d,0x01,0x34,0x36,0x3b,0x01,0x32,0x16,0x1d,0x01,0x14,0x07,0x06,0x23,0x50,0x11,0x0f,0x19,0x1a,0x04,0x17,0x21,0x21,0x17,0x0a,0x17,0x21,0x52,0x08,0x09,0x97,0x12,0x0c,0x10,0x09,0x0f,0x28,0x26,0x21,0x17,0x06,0x17,0x21,0x21,0x17,0x3b,0x60,0x32,0x05,0x00,0x00,0x00,0x01,0x00,0x45,0x00,0xf0,0x01,0x53,0x01,0x41,0x00,0x0d,0x00,0x00,0x36,0x26,0x35,0x34,0x36,0x3b,0x01,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x5c,0x17,0x17,0x11,0xbd,0x11,0x18,0x18,0x11,0xbd,0xf0,0x17,0x11,0x11,0x18,0x18,0x11,0x11,0x17,0x00,0x00,0x01,0x00,0x45,0xff,0xfd,0x00,0xbf,0x00,0x73,0x00,0x0f,0x00,0x00,0x16,0x26,0x3d,0x01,0x34,0x36,0x3b,0x01,0x32,0x16,0x1d,0x01,0x14,0x06,0x2b,0x01,0x66,0x21,0x21,0x17,0x0a,0x17,0x21,0x21,0x17,0x0a,0x03,0x21,0x17,0x06,0x17,0x21,0x21,0x17,0x06,0x17,0x21,0x00,0x00,0x01,0x00,0x30,0xff,0xa1,0x01,0x8c,0x02,0xfc,0x00,0x11,0x00,0x00,0x16,0x26,0x35,0x34,0x37,0x01,0x3e,0x01,0x33,0x32,0x16,0x15,0x14,0x07,0x01,0x0e,0x01,0x23,0x47,0x17,0x03,0x01,0x09,0x04,0x14,0x0f,0x12,0x17,0x03,0xfe,0xf7,0x04,0x14,0x0f,0x5f,0x18,0x11,0x06,0x09,0x03,0x07,0x0c,0x10,0x18,0x11,0x06,0x09,0xfc,0xf9,0x0c,0x10,0x00,0x00,0x00,0x00,0x02,0x00,0x2b,0xff,0xf6,0x02,0x49,0x02,0xc4,0x00,0x0b,0x00,0x17,0x00,0x00,0x16,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x3e,0x01,0x35,0x34,0x26,0x23,0x22,0x06,0x15,0x14,0x16,0x33,0xb6,0x8b,0x8b,0x84,0x83,0x8c,0x8c,0x83,0x57,0x5d,0x5d,0x57,0x57,0x5d,0x5d,0x57,0x0a,0xc2,0xa5,0xa5,0xc2,0xc2,0xa5,0xa5,0xc2,0x54,0x92,0x81,0x80,0x92,0x92,0x80,0x81,0x92,0x00,0x00,0x00,0x01,0x00,0x80,0x00,0x00,0x02,0x11,0x02,0xba,0x00,0x1f,0x00,0x00,0x32,0x26,0x35,0x34,0x36,0x3b,0x01,0x11,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x3f,0x01,0x36,0x3b,0x01,0x32,0x16,0x15,0x11,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x9f,0x18,0x18,0x12,0x77,0x66,0x0e,0x09,0x13,0x18,0x1a,0x88,0x0e,0x0e,0x15,0x14,0x1c,0x63,0x12,0x19,0x19,0x12,0xfe,0xcb,0x18,0x12,0x12,0x19,0x01,0xfb,0x32,0x06,0x18,0x13,0x1c,0x0d,0x47,0x07,0x1c,0x14,0xfd,0xcb,0x19,0x12,0x12,0x18,0x00,0x01,0x00,0x41,0x00,0x00,0x02,0x29,0x02,0xc4,0x00,0x2b,0x00,0x00,0x32,0x26,0x35,0x34,0x3e,0x01,0x37,0x3e,0x02,0x35,0x34,0x26,0x23,0x22,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x37,0x36,0x33,0x32,0x1e,0x01,0x15,0x14,0x0e,0x01,0x07,0x0e,0x01,0x07,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x5f,0x1e,0x3d,0x57,0x47,0x3d,0x48,0x30,0x4b,0x53,0x5a,0x51,0x0a,0x09,0x10,0x16,0x16,0x66,0x78,0x40,0x69,0x3d,0x45,0x60,0x4d,0x46,0x47,0x0e,0x01,0x5c,0x12,0x19,0x19,0x12,0xfe,0x7e,0x1d,0x17,0x34,0x58,0x43,0x2e,0x27,0x36,0x40,0x24,0x39,0x43,0x24,0x05,0x16,0x11,0x19,0x0c,0x33,0x33,0x5c,0x3c,0x3b,0x65,0x4c,0x32,0x2f,0x39,0x1e,0x19,0x12,0x12,0x18,0x00,0x00,0x00,0x01,0x00,0x3b,0xff,0xf6,0x02,0x29,0x02,0xc4,0x00,0x35,0x00,0x00,0x16,0x27,0x2e,0x01,0x35,0x34,0x36,0x33,0x32,0x17,0x16,0x33,0x32,0x36,0x35,0x34,0x2b,0x01,0x22,0x26,0x35,0x34,0x36,0x3b,0x01,0x32,0x36,0x35,0x34,0x26,0x23,0x22,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x07,0x1e,0x01,0x15,0x14,0x06,0x23,0xb7,0x62,0x0c,0x0e,0x17,0x11,0x09,0x0a,0x48,0x57,0x4e,0x6b,0xdd,0x10,0x11,0x19,0x19,0x11,0x06,0x64,0x6a,0x50,0x4e,0x54,0x47,0x0a,0x08,0x0f,0x16,0x14,0x60,0x66,0x73,0x7e,0x45,0x34,0x39,0x59,0x91,0x72,0x0a,0x28,0x05,0x13,0x0e,0x11,0x19,0x04,0x1d,0x33,0x3c,0x7e,0x19,0x11,0x11,0x19,0x3d,0x3c,0x30,0x38,0x21,0x04,0x15,0x10,0x17,0x0b,0x33,0x5e,0x56,0x45,0x4f,0x13,0x0d,0x53,0x52,0x5c,0x65,0x00,0x00,0x00,0x00,0x02,0x00,0x19,0xff,0xfb,0x02,0x54,0x02,0xbf,0x00,0x1f,0x00,0x22,0x00,0x00,0x04,0x26,0x3d,0x01,0x21,0x22,0x26,0x3d,0x01,0x34,0x37,0x01,0x3e,0x01,0x3b,0x01,0x32,0x16,0x15,0x11,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x15,0x14,0x06,0x23,0x01,0x21,0x11,0x01,0x9e,0x1a,0xfe,0xcf,0x18,0x22,0x0c,0x01,0x3a,0x08,0x1b,0x0f,0x14,0x1a,0x20,0x4c,0x11,0x18,0x18,0x11,0x4c,0x1b,0x13,0xfe,0xc9,0x01,0x0a,0x05,0x1a,0x13,0x88,0x21,0x18,0x09,0x15,0x0f,0x01,0x91,0x0b,0x0d,0x21,0x19,0xfe,0x7c,0x18,0x11,0x11,0x17,0x88,0x13,0x1a,0x01,0x06,0x01,0x57,0x00,0x00,0x01,0x00,0x40,0xff,0xf6,0x02,0x3b,0x02,0xba,0x00,0x31,0x00,0x00,0x16,0x27,0x2e,0x01,0x35,0x34,0x36,0x33,0x32,0x17,0x16,0x33,0x32,0x36,0x35,0x34,0x26,0x23,0x22,0x07,0x0e,0x01,0x23,0x22,0x26,0x35,0x34,0x37,0x13,0x3e,0x01,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x07,0x36,0x33,0x32,0x1e,0x01,0x15,0x14,0x06,0x23,0xaf,0x5b,0x0a,0x0a,0x16,0x12,0x0b,0x0a,0x4f,0x51,0x5f,0x64,0x53,0x48,0x53,0x47,0x02,0x13,0x0e,0x1c,0x26,0x02,0x2d,0x03,0x1d,0x15,0x01,0x41,0x12,0x19,0x19,0x12,0xfe,0xde,0x20,0x4c,0x5d,0x4a,0x69,0x36,0x8a,0x88,0x0a,0x3a,0x07,0x0f,0x0e,0x12,0x19,0x05,0x2a,0x40,0x4d,0x3e,0x48,0x2b,0x01,0x0b,0x20,0x1a,0x0c,0x0c,0x01,0x0a,0x17,0x1b,0x19,0x12,0x12,0x18,0xd4,0x29,0x3a,0x66,0x42,0x65,0x7d,0x00,0x00,0x00,0x00,0x02,0x00,0x3b,0xff,0xf6,0x02,0x44,0x02,0xc4,0x00,0x20,0x00,0x2b,0x00,0x00,0x16,0x11,0x34,0x3e,0x01,0x33,0x32,0x16,0x17,0x1e,0x01,0x15,0x14,0x06,0x23,0x22,0x27,0x26,0x23,0x22,0x06,0x07,0x3e,0x01,0x33,0x32,0x1e,0x01,0x15,0x14,0x0e,0x01,0x23,0x3e,0x02,0x35,0x34,0x26,0x23,0x22,0x07,0x16,0x33,0x3b,0x39,0x82,0x67,0x38,0x54,0x25,0x09,0x0c,0x17,0x12,0x09,0x08,0x3e,0x47,0x71,0x5c,0x05,0x1e,0x64,0x4b,0x44,0x67,0x3a,0x3c,0x70,0x4b,0x2f,0x47,0x26,0x4c,0x49,0x82,0x3b,0x1b,0x9c,0x0a,0x01,0x66,0x57,0xa4,0x6d,0x18,0x13,0x05,0x14,0x0b,0x10,0x19,0x03,0x1d,0x9e,0x62,0x26,0x32,0x3a,0x6a,0x47,0x3f,0x68,0x3c,0x55,0x27,0x42,0x27,0x44,0x52,0x6e,0xb8,0x00,0x01,0x00,0x3c,0xff,0xfb,0x02,0x37,0x02,0xba,0x00,0x16,0x00,0x00,0x16,0x26,0x35,0x34,0x37,0x01,0x21,0x22,0x26,0x35,0x34,0x36,0x33,0x21,0x32,0x16,0x15,0x14,0x07,0x01,0x0e,0x01,0x23,0xd3,0x1a,0x06,0x01,0x13,0xfe,0x95,0x12,0x19,0x19,0x12,0x01,0x98,0x18,0x20,0x0a,0xfe,0xe4,0x06,0x18,0x0d,0x05,0x1a,0x13,0x0c,0x0c,0x02,0x23,0x19,0x12,0x12,0x1a,0x1e,0x17,0x16,0x16,0xfd,0xbb,0x0b,0x0e,0x00,0x00,0x00,0x00,0x03,0x00,0x2f,0xff,0xf6,0x02,0x45,0x02,0xc4,0x00,0x19,0x00,0x25,0x00,0x33,0x00,0x00,0x16,0x2e,0x01,0x35,0x34,0x37,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x32,0x1e,0x01,0x15,0x14,0x06,0x07,0x16,0x15,0x14,0x0e,0x01,0x23,0x12,0x36,0x35,0x34,0x26,0x23,0x22,0x06,0x15,0x14,0x16,0x33,0x12,0x3e,0x01,0x35,0x34,0x26,0x23,0x22,0x06,0x15,0x14,0x1e,0x01,0x33,0xdc,0x77,0x36,0x95,0x33,0x41,0x2f,0x69,0x52,0x52,0x69,0x2f,0x41,0x33,0x95,0x36,0x77,0x5e,0x4a,0x45,0x49,0x46,0x46,0x49,0x45,0x4a,0x3e,0x4f,0x23,0x66,0x4a,0x4a,0x66,0x23,0x4f,0x3e,0x0a,0x3a,0x58,0x31,0x8b,0x32,0x11,0x4d,0x3a,0x2b,0x54,0x37,0x37,0x54,0x2b,0x3a,0x4d,0x11,0x32,0x8b,0x31,0x58,0x3a,0x01,0xa6,0x42,0x2a,0x2f,0x3d,0x3d,0x2f,0x2a,0x42,0xfe,0xaa,0x29,0x3a,0x1a,0x40,0x47,0x47,0x40,0x1a,0x3a,0x29,0x00,0x00,0x02,0x00,0x30,0xff,0xf6,0x02,0x39,0x02,0xc4,0x00,0x20,0x00,0x2b,0x00,0x00,0x16,0x26,0x27,0x2e,0x01,0x35,0x34,0x36,0x33,0x32,0x17,0x16,0x33,0x32,0x36,0x37,0x0e,0x01,0x23,0x22,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x20,0x11,0x14,0x0e,0x01,0x23,0x12,0x37,0x26,0x23,0x22,0x0e,0x01,0x15,0x14,0x16,0x33,0xdf,0x54,0x25,0x09,0x0c,0x17,0x12,0x09,0x08,0x3e,0x47,0x71,0x5c,0x05,0x1e,0x64,0x4b,0x44,0x67,0x3a,0x3c,0x70,0x4b,0x01,0x12,0x39,0x82,0x67,0x8b,0x3b,0x1b,0x9c,0x2e,0x47,0x26,0x4c,0x49,0x0a,0x18,0x13,0x05,0x14,0x0b,0x10,0x19,0x03,0x1d,0x9e,0x62,0x26,0x32,0x3a,0x6a,0x47,0x3f,0x68,0x3c,0xfe,0x9a,0x57,0xa4,0x6d,0x01,0x53,0x6e,0xb8,0x27,0x42,0x27,0x44,0x52,0x00,0x00,0x02,0x00,0x45,0xff,0xfd,0x00,0xbf,0x02,0x01,0x00,0x0f,0x00,0x1f,0x00,0x00,0x12,0x26,0x3d,0x01,0x34,0x36,0x3b,0x01,0x32,0x16,0x1d,0x01,0x14,0x06,0x2b,0x01,0x02,0x26,0x3d,0x01,0x34,0x36,0x3b,0x01,0x32,0x16,0x1d,0x01,0x14,0x06,0x2b,0x01,0x66,0x21,0x21,0x17,0x0a,0x17,0x21,0x21,0x17,0x0a,0x17,0x21,0x21,0x17,0x0a,0x17,0x21,0x21,0x17,0x0a,0x01,0x8b,0x21,0x17,0x06,0x17,0x21,0x21,0x17,0x06,0x17,0x21,0xfe,0x72,0x21,0x17,0x06,0x17,0x21,0x21,0x17,0x06,0x17,0x21,0x00,0x02,0x00,0x3f,0xff,0x69,0x00,0xbf,0x02,0x01,0x00,0x0f,0x00,0x28,0x00,0x00,0x12,0x26,0x3d,0x01,0x34,0x36,0x3b,0x01,0x32,0x16,0x1d,0x01,0x14,0x06,0x2b,0x01,0x02,0x26,0x35,0x34,0x37,0x3e,0x01,0x35,0x23,0x22,0x26,0x3d,0x01,0x34,0x36,0x3b,0x01,0x32,0x16,0x1d,0x01,0x14,0x07,0x06,0x23,0x66,0x21,0x21,0x17,0x0a,0x17,0x21,0x21,0x17,0x0a,0x2d,0x11,0x0f,0x19,0x1a,0x04,0x17,0x21,0x21,0x17,0x0a,0x17,0x21,0x52,0x08,0x09,0x01,0x8b,0x21,0x17,0x06,0x17,0x21,0x21,0x17,0x06,0x17,0x21,0xfd,0xde,0x12,0x0c,0x10,0x09,0x0f,0x28,0x26,0x21,0x17,0x06,0x17,0x21,0x21,0x17,0x3b,0x60,0x32,0x05,0x00,0x00,0x01,0x00,0x23,0x00,0x3a,0x02,0x0e,0x02,0x16,0x00,0x1a,0x00,0x00,0x24,0x27,0x25,0x2e,0x01,0x3d,0x01,0x34,0x36,0x37,0x25,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x07,0x0d,0x01,0x1e,0x01,0x15,0x14,0x06,0x23,0x01,0xde,0x08,0xfe,0x71,0x11,0x13,0x13,0x11,0x01,0x8f,0x08,0x08,0x11,0x17,0x0f,0x0c,0xfe,0x98,0x01,0x68,0x0c,0x0f,0x17,0x11,0x3a,0x03,0xb3,0x08,0x1b,0x11,0x08,0x11,0x1b,0x08,0xb3,0x03,0x17,0x11,0x0c,0x15,0x05,0xa0,0xa0,0x05,0x15,0x0c,0x11,0x17,0x00,0x00,0x00,0x02,0x00,0x49,0x00,0xb4,0x02,0x7f,0x01,0xe2,0x00,0x0d,0x00,0x1b,0x00,0x00,0x12,0x26,0x35,0x34,0x36,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x06,0x26,0x35,0x34,0x36,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x60,0x17,0x17,0x10,0x01,0xe8,0x11,0x16,0x16,0x11,0xfe,0x18,0x10,0x17,0x17,0x10,0x01,0xe8,0x11,0x16,0x16,0x11,0xfe,0x18,0x01,0x94,0x17,0x10,0x11,0x16,0x16,0x11,0x10,0x17,0xe0,0x17,0x10,0x11,0x16,0x16,0x11,0x10,0x17,0x00,0x00,0x01,0x00,0x36,0x00,0x3a,0x02,0x21,0x02,0x16,0x00,0x1a,0x00,0x00,0x36,0x26,0x35,0x34,0x36,0x37,0x2d,0x01,0x2e,0x01,0x35,0x34,0x36,0x33,0x32,0x17,0x05,0x1e,0x01,0x1d,0x01,0x14,0x06,0x07,0x05,0x06,0x23,0x4d,0x17,0x0f,0x0c,0x01,0x68,0xfe,0x98,0x0c,0x0f,0x17,0x11,0x09,0x07,0x01,0x8f,0x11,0x13,0x13,0x11,0xfe,0x71,0x07,0x09,0x3a,0x17,0x11,0x0c,0x15,0x05,0xa0,0xa0,0x05,0x15,0x0c,0x11,0x17,0x03,0xb3,0x08,0x1b,0x11,0x08,0x11,0x1b,0x08,0xb3,0x03,0x00,0x00,0x00,0x00,0x02,0x00,0x1a,0xff,0xfc,0x01,0xc4,0x02,0xc4,0x00,0x25,0x00,0x31,0x00,0x00,0x36,0x26,0x35,0x34,0x3e,0x01,0x37,0x3e,0x01,0x35,0x34,0x23,0x22,0x06,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x37,0x3e,0x01,0x33,0x32,0x16,0x15,0x14,0x0e,0x01,0x07,0x0e,0x01,0x15,0x14,0x06,0x23,0x06,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0xca,0x19,0x20,0x2b,0x24,0x26,0x24,0x8f,0x23,0x43,0x1a,0x0c,0x0d,0x10,0x18,0x19,0x29,0x54,0x33,0x66,0x7b,0x1c,0x28,0x21,0x2b,0x2b,0x1a,0x12,0x1a,0x23,0x23,0x18,0x19,0x23,0x23,0x19,0xba,0x17,0x10,0x2d,0x44,0x2d,0x1d,0x1e,0x2c,0x1c,0x6d,0x11,0x10,0x08,0x18,0x10,0x17,0x0f,0x1a,0x16,0x66,0x57,0x27,0x3b,0x29,0x1a,0x22,0x37,0x28,0x10,0x17,0xbe,0x23,0x19,0x18,0x23,0x23,0x18,0x19,0x23,0x00,0x00,0x00,0x02,0x00,0x31,0xff,0xad,0x03,0x56,0x02,0xb0,0x00,0x48,0x00,0x54,0x00,0x00,0x04,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x32,0x1e,0x01,0x15,0x14,0x0e,0x01,0x23,0x22,0x26,0x27,0x0e,0x01,0x23,0x22,0x26,0x35,0x34,0x3e,0x01,0x33,0x32,0x17,0x37,0x3e,0x01,0x33,0x32,0x16,0x15,0x0f,0x01,0x06,0x15,0x14,0x16,0x33,0x32,0x36,0x35,0x34,0x2e,0x01,0x23,0x22,0x0e,0x01,0x15,0x14,0x1e,0x01,0x33,0x32,0x36,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x07,0x06,0x23,0x36,0x3f,0x01,0x26,0x23,0x22,0x0e,0x01,0x15,0x14,0x16,0x33,0x01,0x28,0xa0,0x57,0x74,0xc3,0x71,0x67,0xaf,0x67,0x27,0x53,0x40,0x32,0x38,0x06,0x1f,0x56,0x30,0x50,0x5a,0x43,0x6d,0x3d,0x4b,0x35,0x03,0x02,0x15,0x0e,0x0f,0x15,0x01,0x21,0x07,0x19,0x19,0x3e,0x43,0x5e,0x97,0x52,0x63,0xab,0x66,0x47,0x87,0x5d,0x3d,0x5a,0x3a,0x06,0x05,0x0b,0x0e,0x08,0x06,0x6a,0x7d,0x87,0x18,0x10,0x2c,0x45,0x2b,0x4b,0x2e,0x40,0x33,0x53,0x5f,0x9f,0x5b,0x71,0xc4,0x75,0x59,0x9d,0x64,0x3f,0x70,0x48,0x2c,0x1e,0x26,0x25,0x62,0x4e,0x4b,0x6e,0x3a,0x33,0x11,0x0d,0x12,0x15,0x10,0x0b,0xbe,0x25,0x1c,0x1c,0x25,0x6c,0x5c,0x5c,0x85,0x44,0x66,0xac,0x63,0x4a,0x87,0x54,0x17,0x17,0x02,0x0e,0x0a,0x07,0x0d,0x03,0x35,0xf6,0x8c,0x5d,0x2e,0x26,0x49,0x33,0x3a,0x3b,0x00,0x00,0x00,0x00,0x02,0x00,0x32,0xff,0xfb,0x02,0xb8,0x02,0xbf,0x00,0x1b,0x00,0x1e,0x00,0x00,0x16,0x26,0x35,0x34,0x37,0x01,0x3e,0x01,0x3b,0x01,0x32,0x16,0x17,0x01,0x16,0x15,0x14,0x06,0x23,0x22,0x26,0x2f,0x01,0x21,0x07,0x0e,0x01,0x23,0x13,0x21,0x03,0x4b,0x19,0x05,0x00,0xff,0x08,0x1d,0x15,0x0a,0x15,0x1d,0x08,0x00,0xff,0x05,0x19,0x14,0x0e,0x17,0x06,0x41,0xfe,0xac,0x41,0x06,0x17,0x0e,0x8f,0x01,0x0e,0x87,0x05,0x1a,0x13,0x08,0x0c,0x02,0x5a,0x12,0x17,0x17,0x12,0xfd,0xa6,0x0c,0x08,0x13,0x1a,0x0f,0x0d,0x9c,0x9c,0x0d,0x0f,0x01,0x0b,0x01,0x45,0x00,0x00,0x00,0x00,0x03,0x00,0x61,0x00,0x00,0x02,0x81,0x02,0xba,0x00,0x14,0x00,0x1d,0x00,0x25,0x00,0x00,0x32,0x26,0x35,0x11,0x34,0x36,0x3b,0x01,0x32,0x16,0x15,0x14,0x06,0x07,0x1e,0x01,0x15,0x14,0x06,0x2b,0x01,0x13,0x32,0x36,0x35,0x34,0x26,0x2b,0x01,0x15,0x13,0x32,0x36,0x35,0x34,0x2b,0x01,0x15,0x7b,0x1a,0x1a,0x13,0xec,0x6b,0x75,0x37,0x2b,0x3c,0x4d,0x7c,0x85,0xf2,0xd4,0x59,0x48,0x4d,0x43,0xb7,0xbb,0x61,0x51,0xb1,0xbc,0x1a,0x13,0x02,0x5f,0x13,0x1b,0x62,0x53,0x3a,0x4d,0x13,0x13,0x54,0x40,0x5c,0x68,0x01,0x8c,0x3c,0x36,0x2f,0x38,0xd9,0xfe,0xc9,0x3c,0x37,0x72,0xe5,0x00,0x00,0x00,0x01,0x00,0x37,0xff,0xf6,0x02,0x8f,0x02,0xc4,0x00,0x29,0x00,0x00,0x04,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x32,0x16,0x17,0x16,0x15,0x14,0x06,0x23,0x22,0x27,0x2e,0x01,0x23,0x22,0x0e,0x01,0x15,0x14,0x1e,0x01,0x33,0x32,0x36,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x0e,0x01,0x23,0x01,0x31,0x9f,0x5b,0x5b,0x9f,0x64,0x44,0x6b,0x35,0x16,0x16,0x12,0x0a,0x08,0x2c,0x54,0x37,0x56,0x79,0x3d,0x3d,0x79,0x56,0x37,0x54,0x2c,0x08,0x0a,0x12,0x16,0x16,0x35,0x6b,0x44,0x0a,0x57,0xa3,0x6d,0x6d,0xa3,0x57,0x20,0x1e,0x0c,0x1a,0x0f,0x17,0x04,0x17,0x18,0x47,0x7b,0x4e,0x4e,0x7b,0x47,0x18,0x17,0x04,0x16,0x10,0x1a,0x0c,0x1e,0x20,0x00,0x00,0x00,0x02,0x00,0x61,0x00,0x00,0x02,0xb8,0x02,0xba,0x00,0x10,0x00,0x1b,0x00,0x00,0x32,0x26,0x35,0x11,0x34,0x36,0x3b,0x01,0x32,0x1e,0x01,0x15,0x14,0x0e,0x01,0x2b,0x01,0x37,0x32,0x3e,0x01,0x35,0x34,0x2e,0x01,0x2b,0x01,0x11,0x7b,0x1a,0x1a,0x13,0xc9,0x72,0x9f,0x50,0x50,0x9f,0x72,0xc9,0xbe,0x52,0x7c,0x44,0x44,0x7c,0x52,0x90,0x1a,0x13,0x02,0x5f,0x13,0x1b,0x65,0xa0,0x58,0x58,0xa0,0x65,0x55,0x43,0x77,0x4e,0x4e,0x77,0x43,0xfd,0xf0,0x00,0x00,0x00,0x00,0x01,0x00,0x61,0x00,0x00,0x02,0x4a,0x02,0xba,0x00,0x20,0x00,0x00,0x32,0x26,0x35,0x11,0x34,0x36,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x15,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x15,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x7b,0x1a,0x1a,0x13,0x01,0x91,0x12,0x19,0x19,0x12,0xfe,0x9d,0x01,0x3f,0x12,0x19,0x19,0x12,0xfe,0xc1,0x01,0x63,0x12,0x19,0x19,0x12,0xfe,0x6f,0x1a,0x13,0x02,0x5f,0x13,0x1b,0x19,0x12,0x12,0x18,0xdd,0x19,0x12,0x12,0x18,0xde,0x19,0x12,0x12,0x18,0x00,0x00,0x01,0x00,0x61,0xff,0xfb,0x02,0x3e,0x02,0xba,0x00,0x1b,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x15,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x11,0x14,0x06,0x23,0x7b,0x1a,0x1a,0x13,0x01,0x85,0x12,0x19,0x19,0x12,0xfe,0xa9,0x01,0x34,0x12,0x19,0x19,0x12,0xfe,0xcc,0x1b,0x13,0x05,0x1a,0x13,0x02,0x64,0x13,0x1b,0x19,0x12,0x12,0x18,0xdd,0x19,0x12,0x12,0x18,0xfe,0xf5,0x13,0x1a,0x00,0x01,0x00,0x37,0xff,0xf6,0x02,0xa1,0x02,0xc4,0x00,0x31,0x00,0x00,0x04,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x32,0x16,0x17,0x1e,0x01,0x15,0x14,0x06,0x23,0x22,0x27,0x2e,0x01,0x23,0x22,0x0e,0x01,0x15,0x14,0x1e,0x01,0x33,0x32,0x37,0x35,0x23,0x22,0x26,0x35,0x34,0x36,0x3b,0x01,0x32,0x16,0x1d,0x01,0x14,0x06,0x07,0x06,0x23,0x01,0x2f,0xa0,0x58,0x5c,0x9f,0x61,0x4e,0x75,0x36,0x08,0x0c,0x17,0x13,0x0b,0x0a,0x2f,0x5e,0x37,0x4c,0x7a,0x45,0x41,0x7b,0x54,0x5e,0x51,0xa5,0x11,0x18,0x18,0x11,0xc5,0x14,0x1c,0x15,0x11,0x70,0x75,0x0a,0x5b,0xa3,0x68,0x6a,0xa4,0x5a,0x26,0x22,0x04,0x14,0x0c,0x11,0x18,0x05,0x1c,0x1c,0x40,0x7b,0x55,0x4e,0x7b,0x47,0x2c,0xb5,0x18,0x11,0x11,0x18,0x1c,0x14,0xe3,0x15,0x21,0x08,0x38,0x00,0x00,0x01,0x00,0x61,0xff,0xfb,0x02,0x92,0x02,0xbf,0x00,0x1f,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x21,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x22,0x26,0x35,0x11,0x21,0x11,0x14,0x06,0x23,0x7b,0x1a,0x1a,0x13,0x13,0x1b,0x01,0x7b,0x1a,0x13,0x13,0x1b,0x1b,0x13,0x13,0x1a,0xfe,0x85,0x1b,0x13,0x05,0x1a,0x13,0x02,0x69,0x13,0x1b,0x1b,0x13,0xfe,0xf6,0x01,0x0a,0x13,0x1b,0x1b,0x13,0xfd,0x97,0x13,0x1a,0x1a,0x13,0x01,0x0a,0xfe,0xf6,0x13,0x1a,0x00,0x00,0x01,0x00,0x61,0xff,0xfb,0x00,0xbc,0x02,0xbf,0x00,0x0d,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x7b,0x1a,0x1a,0x13,0x13,0x1b,0x1b,0x13,0x05,0x1a,0x13,0x02,0x69,0x13,0x1b,0x1b,0x13,0xfd,0x97,0x13,0x1a,0x00,0x00,0x00,0x00,0x01,0x00,0x0d,0xff,0xf6,0x01,0x76,0x02,0xbf,0x00,0x18,0x00,0x00,0x16,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x17,0x16,0x33,0x32,0x36,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x5f,0x3c,0x16,0x15,0x11,0x0a,0x08,0x2e,0x2f,0x36,0x43,0x1a,0x13,0x13,0x1b,0x75,0x59,0x0a,0x22,0x0d,0x18,0x10,0x19,0x04,0x16,0x3e,0x56,0x01,0xb1,0x13,0x1b,0x1b,0x13,0xfe,0x55,0x83,0x6d,0x00,0x01,0x00,0x61,0xff,0xfb,0x02,0x81,0x02,0xbf,0x00,0x21,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x01,0x16,0x15,0x16,0x06,0x23,0x22,0x27,0x01,0x07,0x15,0x14,0x06,0x23,0x7b,0x1a,0x1a,0x13,0x13,0x1b,0x01,0x56,0x0e,0x14,0x11,0x19,0x0b,0xe7,0x01,0x09,0x0b,0x01,0x1a,0x13,0x17,0x0d,0xfe,0xfe,0x72,0x1b,0x13,0x05,0x1a,0x13,0x02,0x69,0x13,0x1b,0x1b,0x13,0xfe,0xc2,0x01,0x5c,0x10,0x17,0x11,0x14,0x0b,0xe6,0xfe,0xb2,0x0e,0x0f,0x12,0x1a,0x12,0x01,0x49,0x73,0xbb,0x13,0x1a,0x00,0x00,0x01,0x00,0x61,0x00,0x00,0x02,0x31,0x02,0xbf,0x00,0x12,0x00,0x00,0x32,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x86,0x25,0x1a,0x13,0x13,0x1b,0x01,0x47,0x13,0x1b,0x1b,0x13,0xfe,0x9d,0x25,0x1a,0x02,0x52,0x13,0x1b,0x1b,0x13,0xfd,0xca,0x1b,0x13,0x13,0x1a,0x00,0x00,0x00,0x00,0x01,0x00,0x61,0xff,0xfb,0x03,0x65,0x02,0xbf,0x00,0x27,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x3b,0x01,0x32,0x16,0x17,0x1b,0x01,0x3e,0x01,0x3b,0x01,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x22,0x26,0x35,0x11,0x03,0x0e,0x01,0x23,0x22,0x26,0x27,0x03,0x11,0x14,0x06,0x23,0x7b,0x1a,0x26,0x1b,0x21,0x14,0x21,0x08,0xe3,0xe3,0x08,0x21,0x14,0x21,0x1b,0x26,0x1a,0x13,0x13,0x1b,0xe7,0x08,0x23,0x15,0x15,0x23,0x08,0xe7,0x1b,0x13,0x05,0x1a,0x13,0x02,0x55,0x1b,0x27,0x18,0x12,0xfd,0xca,0x02,0x36,0x12,0x18,0x27,0x1b,0xfd,0xab,0x13,0x1a,0x1a,0x13,0x02,0x38,0xfd,0xc5,0x13,0x17,0x17,0x13,0x02,0x3b,0xfd,0xc8,0x13,0x1a,0x00,0x00,0x00,0x00,0x01,0x00,0x61,0xff,0xfb,0x02,0xc2,0x02,0xbf,0x00,0x1e,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x3b,0x01,0x32,0x17,0x01,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x2b,0x01,0x22,0x26,0x27,0x01,0x11,0x14,0x06,0x23,0x7b,0x1a,0x26,0x1b,0x0d,0x20,0x17,0x01,0x81,0x1a,0x13,0x13,0x1b,0x27,0x1b,0x0c,0x10,0x1c,0x09,0xfe,0x7d,0x1b,0x13,0x05,0x1a,0x13,0x02,0x55,0x1b,0x27,0x1e,0xfd,0xd4,0x02,0x1c,0x13,0x1b,0x1b,0x13,0xfd,0xab,0x1b,0x26,0x0f,0x0c,0x02,0x2f,0xfd,0xe3,0x13,0x1a,0x00,0x02,0x00,0x37,0xff,0xf6,0x02,0xf5,0x02,0xc4,0x00,0x0f,0x00,0x1f,0x00,0x00,0x04,0x2e,0x01,0x27,0x3e,0x02,0x33,0x32,0x1e,0x01,0x17,0x0e,0x02,0x23,0x3e,0x02,0x35,0x34,0x2e,0x01,0x23,0x22,0x0e,0x01,0x15,0x14,0x1e,0x01,0x33,0x01,0x2d,0x9e,0x56,0x02,0x02,0x56,0x9e,0x69,0x69,0x9d,0x57,0x02,0x02,0x57,0x9d,0x69,0x50,0x76,0x3e,0x3e,0x76,0x50,0x51,0x75,0x3e,0x3e,0x75,0x51,0x0a,0x5c,0xa2,0x69,0x69,0xa2,0x5c,0x5c,0xa3,0x68,0x68,0xa3,0x5c,0x55,0x48,0x7c,0x4e,0x4e,0x7c,0x48,0x48,0x7c,0x4e,0x4e,0x7c,0x48,0x00,0x02,0x00,0x61,0xff,0xfb,0x02,0x7d,0x02,0xba,0x00,0x14,0x00,0x1d,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x3b,0x01,0x32,0x1e,0x01,0x15,0x14,0x0e,0x01,0x2b,0x01,0x15,0x14,0x06,0x23,0x13,0x32,0x36,0x35,0x34,0x26,0x2b,0x01,0x11,0x7b,0x1a,0x1a,0x13,0xe4,0x5f,0x78,0x34,0x34,0x78,0x5f,0xb6,0x1b,0x13,0xdb,0x66,0x53,0x53,0x66,0xad,0x05,0x1a,0x13,0x02,0x64,0x13,0x1b,0x40,0x64,0x3a,0x3a,0x64,0x40,0xd6,0x13,0x1a,0x01,0x59,0x4e,0x3a,0x3a,0x4e,0xfe,0xf0,0x00,0x00,0x00,0x02,0x00,0x37,0xff,0x68,0x02,0xf5,0x02,0xc4,0x00,0x19,0x00,0x29,0x00,0x00,0x04,0x2f,0x01,0x06,0x23,0x22,0x2e,0x01,0x27,0x3e,0x02,0x33,0x32,0x1e,0x01,0x17,0x0e,0x01,0x07,0x17,0x16,0x15,0x16,0x06,0x23,0x26,0x3e,0x01,0x35,0x34,0x2e,0x01,0x23,0x22,0x0e,0x01,0x15,0x14,0x1e,0x01,0x33,0x02,0x4c,0x0d,0x6d,0x19,0x23,0x69,0x9e,0x56,0x02,0x02,0x56,0x9e,0x69,0x69,0x9d,0x57,0x02,0x02,0x6d,0x60,0x58,0x0c,0x01,0x1a,0x12,0x79,0x76,0x3e,0x3e,0x76,0x50,0x51,0x75,0x3e,0x3e,0x75,0x51,0x98,0x10,0x82,0x04,0x5c,0xa2,0x69,0x69,0xa2,0x5c,0x5c,0xa3,0x68,0x75,0xaf,0x28,0x61,0x0c,0x11,0x11,0x1a,0xe3,0x48,0x7c,0x4e,0x4e,0x7c,0x48,0x48,0x7c,0x4e,0x4e,0x7c,0x48,0x00,0x00,0x00,0x00,0x02,0x00,0x61,0xff,0xfb,0x02,0x87,0x02,0xba,0x00,0x21,0x00,0x2a,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x3b,0x01,0x32,0x16,0x15,0x14,0x06,0x07,0x1e,0x01,0x1d,0x01,0x14,0x06,0x23,0x22,0x26,0x3d,0x01,0x34,0x2e,0x01,0x2b,0x01,0x15,0x14,0x06,0x23,0x13,0x32,0x36,0x35,0x34,0x26,0x2b,0x01,0x15,0x7b,0x1a,0x1a,0x13,0xe9,0x88,0x88,0x43,0x40,0x48,0x35,0x1a,0x13,0x15,0x19,0x12,0x44,0x45,0xcf,0x1b,0x13,0xe3,0x56,0x65,0x57,0x69,0xb0,0x05,0x1a,0x13,0x02,0x64,0x13,0x1b,0x70,0x5b,0x3c,0x63,0x16,0x13,0x8d,0x44,0x2e,0x13,0x1a,0x19,0x14,0x1e,0x32,0x55,0x43,0xe8,0x13,0x1a,0x01,0x6b,0x44,0x3e,0x3c,0x40,0xfe,0x00,0x01,0x00,0x33,0xff,0xf6,0x02,0x3d,0x02,0xc4,0x00,0x33,0x00,0x00,0x16,0x27,0x2e,0x01,0x35,0x34,0x36,0x33,0x32,0x17,0x16,0x33,0x32,0x35,0x34,0x2e,0x01,0x27,0x2e,0x02,0x35,0x34,0x3e,0x01,0x33,0x32,0x17,0x16,0x15,0x14,0x06,0x23,0x22,0x27,0x26,0x23,0x22,0x06,0x15,0x14,0x1e,0x01,0x17,0x1e,0x02,0x15,0x14,0x0e,0x01,0x23,0xbe,0x6f,0x0c,0x10,0x17,0x12,0x0a,0x09,0x5c,0x69,0xaf,0x2d,0x42,0x3d,0x51,0x64,0x48,0x3c,0x75,0x52,0x6e,0x59,0x1c,0x16,0x12,0x06,0x0a,0x4e,0x53,0x4f,0x63,0x2f,0x47,0x3d,0x4f,0x61,0x45,0x40,0x74,0x4c,0x0a,0x30,0x05,0x17,0x0d,0x11,0x19,0x04,0x29,0x73,0x1e,0x28,0x17,0x10,0x15,0x27,0x4e,0x41,0x39,0x5d,0x37,0x21,0x0a,0x1e,0x10,0x1a,0x04,0x1b,0x3c,0x36,0x24,0x2d,0x19,0x0e,0x13,0x26,0x50,0x44,0x38,0x59,0x32,0x00,0x00,0x00,0x00,0x01,0x00,0x0d,0xff,0xfb,0x02,0x54,0x02,0xba,0x00,0x16,0x00,0x00,0x04,0x26,0x35,0x11,0x23,0x22,0x26,0x35,0x34,0x36,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x11,0x14,0x06,0x23,0x01,0x1d,0x1a,0xcc,0x12,0x18,0x18,0x12,0x01,0xf2,0x12,0x19,0x19,0x12,0xcb,0x1b,0x13,0x05,0x1a,0x13,0x02,0x3d,0x18,0x12,0x12,0x19,0x19,0x12,0x12,0x18,0xfd,0xc3,0x13,0x1a,0x00,0x00,0x01,0x00,0x5c,0xff,0xf6,0x02,0x9a,0x02,0xbf,0x00,0x1f,0x00,0x00,0x04,0x2e,0x01,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x1e,0x01,0x33,0x32,0x3e,0x01,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x0e,0x01,0x23,0x01,0x34,0x84,0x54,0x1a,0x13,0x13,0x1b,0x37,0x5a,0x33,0x33,0x5a,0x37,0x1a,0x13,0x13,0x1b,0x54,0x84,0x47,0x0a,0x3c,0x7b,0x59,0x01,0x8b,0x13,0x1b,0x1b,0x13,0xfe,0x72,0x3c,0x54,0x2a,0x2a,0x54,0x3c,0x01,0x8e,0x13,0x1b,0x1b,0x13,0xfe,0x75,0x59,0x7b,0x3c,0x00,0x01,0x00,0x18,0xff,0xfb,0x02,0x9e,0x02,0xbf,0x00,0x18,0x00,0x00,0x04,0x27,0x03,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x17,0x1b,0x01,0x3e,0x01,0x33,0x32,0x16,0x15,0x14,0x07,0x03,0x06,0x2b,0x01,0x01,0x27,0x15,0xf7,0x03,0x18,0x15,0x0e,0x17,0x06,0xeb,0xeb,0x06,0x17,0x0e,0x15,0x18,0x03,0xf7,0x15,0x29,0x16,0x05,0x2e,0x02,0x57,0x08,0x09,0x15,0x19,0x11,0x0e,0xfd,0xb6,0x02,0x4a,0x0e,0x11,0x19,0x15,0x09,0x08,0xfd,0xa9,0x2e,0x00,0x01,0x00,0x1b,0xff,0xfb,0x03,0xd9,0x02,0xbf,0x00,0x29,0x00,0x00,0x04,0x26,0x27,0x03,0x26,0x35,0x26,0x36,0x33,0x32,0x16,0x17,0x1b,0x01,0x3e,0x01,0x33,0x32,0x16,0x17,0x1b,0x01,0x3e,0x01,0x33,0x32,0x16,0x07,0x14,0x07,0x03,0x0e,0x01,0x23,0x22,0x26,0x27,0x0b,0x01,0x0e,0x01,0x23,0x01,0x0a,0x1f,0x08,0xc4,0x03,0x01,0x19,0x14,0x10,0x18,0x05,0xa8,0xa9,0x05,0x1d,0x12,0x12,0x1d,0x05,0xa9,0xa8,0x05,0x18,0x10,0x14,0x19,0x01,0x03,0xc4,0x08,0x1f,0x14,0x14,0x21,0x06,0xa1,0xa1,0x06,0x21,0x14,0x05,0x17,0x16,0x02,0x5a,0x0b,0x06,0x13,0x19,0x14,0x10,0xfd,0xd8,0x02,0x26,0x11,0x15,0x15,0x11,0xfd,0xda,0x02,0x28,0x10,0x14,0x19,0x13,0x06,0x0b,0xfd,0xa6,0x16,0x17,0x19,0x14,0x01,0xfe,0xfe,0x02,0x14,0x19,0x00,0x00,0x00,0x01,0x00,0x2c,0xff,0xfb,0x02,0x73,0x02,0xbf,0x00,0x24,0x00,0x00,0x16,0x26,0x35,0x34,0x37,0x13,0x03,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x17,0x1b,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x03,0x13,0x16,0x15,0x14,0x06,0x23,0x22,0x27,0x0b,0x01,0x06,0x23,0x45,0x19,0x09,0xe7,0xe5,0x09,0x19,0x13,0x0b,0x14,0x06,0xd3,0xd3,0x0b,0x16,0x12,0x1a,0x08,0xe7,0xe7,0x09,0x19,0x14,0x16,0x0e,0xd6,0xd3,0x0f,0x14,0x05,0x19,0x11,0x10,0x0c,0x01,0x1c,0x01,0x1a,0x0c,0x10,0x13,0x19,0x0a,0x08,0xfe,0xf4,0x01,0x0e,0x10,0x19,0x12,0x0e,0x0b,0xfe,0xe3,0xfe,0xe4,0x0a,0x10,0x13,0x1a,0x13,0x01,0x0d,0xfe,0xf2,0x12,0x00,0x00,0x00,0x01,0x00,0x1b,0xff,0xfb,0x02,0x66,0x02,0xbf,0x00,0x19,0x00,0x00,0x04,0x26,0x35,0x11,0x03,0x26,0x35,0x34,0x36,0x33,0x32,0x17,0x1b,0x01,0x36,0x33,0x32,0x16,0x07,0x14,0x07,0x03,0x15,0x14,0x06,0x23,0x01,0x2d,0x1b,0xef,0x08,0x19,0x13,0x19,0x0f,0xd1,0xd1,0x0f,0x19,0x13,0x1a,0x01,0x08,0xf0,0x1a,0x13,0x05,0x1a,0x13,0x00,0xff,0x01,0x4f,0x0d,0x0e,0x13,0x1b,0x17,0xfe,0xd0,0x01,0x30,0x17,0x1b,0x13,0x0e,0x0d,0xfe,0xb1,0xff,0x13,0x1a,0x00,0x00,0x00,0x01,0x00,0x2f,0x00,0x00,0x02,0x51,0x02,0xba,0x00,0x1c,0x00,0x00,0x32,0x26,0x35,0x34,0x37,0x01,0x21,0x22,0x26,0x35,0x34,0x36,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x07,0x01,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x51,0x22,0x0c,0x01,0xa2,0xfe,0x7f,0x12,0x19,0x19,0x12,0x01,0xb2,0x1c,0x21,0x09,0x07,0xfe,0x63,0x01,0x88,0x12,0x19,0x19,0x12,0xfe,0x43,0x22,0x18,0x16,0x0f,0x02,0x04,0x19,0x12,0x12,0x1a,0x24,0x1a,0x0a,0x16,0x08,0xfe,0x01,0x19,0x12,0x12,0x18,0x00,0x00,0x01,0x00,0x57,0xff,0x7c,0x01,0x26,0x02,0xdc,0x00,0x17,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x3b,0x01,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x11,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x71,0x1a,0x1a,0x12,0x7f,0x0f,0x15,0x15,0x0f,0x5c,0x5c,0x0f,0x15,0x15,0x0f,0x7f,0x84,0x1a,0x12,0x03,0x08,0x12,0x1a,0x15,0x0f,0x0f,0x15,0xfd,0x2f,0x15,0x0e,0x0e,0x16,0x00,0x00,0x01,0x00,0x2f,0xff,0xa1,0x01,0x8b,0x02,0xfc,0x00,0x11,0x00,0x00,0x04,0x26,0x27,0x01,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x17,0x01,0x16,0x15,0x14,0x06,0x23,0x01,0x53,0x14,0x04,0xfe,0xf7,0x03,0x17,0x12,0x0f,0x14,0x04,0x01,0x09,0x03,0x17,0x12,0x5f,0x10,0x0c,0x03,0x07,0x09,0x06,0x11,0x18,0x10,0x0c,0xfc,0xf9,0x09,0x06,0x11,0x18,0x00,0x00,0x00,0x01,0x00,0x1c,0xff,0x7c,0x00,0xeb,0x02,0xdc,0x00,0x17,0x00,0x00,0x16,0x26,0x35,0x34,0x36,0x3b,0x01,0x11,0x23,0x22,0x26,0x35,0x34,0x36,0x3b,0x01,0x32,0x16,0x15,0x11,0x14,0x06,0x2b,0x01,0x31,0x15,0x15,0x0f,0x5c,0x5c,0x0f,0x15,0x15,0x0f,0x7f,0x12,0x1a,0x1a,0x12,0x7f,0x84,0x16,0x0e,0x0e,0x15,0x02,0xd1,0x15,0x0f,0x0f,0x15,0x1a,0x12,0xfc,0xf8,0x12,0x1a,0x00,0x00,0x01,0x00,0x52,0x01,0x9f,0x01,0xb8,0x02,0xbe,0x00,0x1a,0x00,0x00,0x12,0x26,0x35,0x34,0x3f,0x01,0x3e,0x01,0x3b,0x01,0x32,0x16,0x1f,0x01,0x16,0x15,0x14,0x06,0x23,0x22,0x27,0x16,0x27,0x0f,0x01,0x06,0x23,0x67,0x15,0x06,0x69,0x09,0x16,0x12,0x26,0x12,0x16,0x09,0x69,0x06,0x15,0x0f,0x11,0x09,0x03,0x78,0x66,0x0f,0x09,0x11,0x01,0x9f,0x15,0x0f,0x06,0x0c,0xc7,0x10,0x12,0x12,0x10,0xc7,0x0c,0x06,0x0f,0x15,0x0b,0x03,0xc1,0xa6,0x18,0x0b,0x00,0x00,0x00,0x01,0x00,0x34,0xff,0x6d,0x02,0x63,0xff,0xaf,0x00,0x0d,0x00,0x00,0x16,0x26,0x35,0x34,0x36,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x48,0x14,0x14,0x0d,0x01,0xed,0x0e,0x13,0x13,0x0e,0xfe,0x13,0x93,0x13,0x0e,0x0d,0x14,0x14,0x0d,0x0e,0x13,0x00,0x00,0x00,0xff,0xff,0x00,0x63,0x02,0x37,0x00,0xe3,0x02,0xd2,0x10,0x03,0x00,0xc3,0x01,0x90,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x2e,0xff,0xf6,0x01,0xe8,0x02,0x08,0x00,0x25,0x00,0x2f,0x00,0x00,0x16,0x2e,0x01,0x35,0x34,0x36,0x3b,0x01,0x35,0x34,0x26,0x23,0x22,0x06,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x37,0x36,0x33,0x32,0x1e,0x01,0x15,0x11,0x14,0x06,0x23,0x22,0x26,0x3d,0x01,0x06,0x23,0x3e,0x01,0x37,0x35,0x23,0x22,0x15,0x14,0x16,0x33,0xa5,0x4b,0x2c,0x75,0x71,0x79,0x41,0x45,0x26,0x3b,0x24,0x08,0x05,0x0f,0x16,0x1a,0x55,0x58,0x45,0x5f,0x2d,0x1b,0x13,0x13,0x1a,0x4a,0x72,0x4e,0x52,0x1c,0x6d,0x97,0x31,0x39,0x0a,0x24,0x45,0x2d,0x4a,0x58,0x08,0x42,0x3a,0x0c,0x0c,0x02,0x16,0x10,0x1b,0x0b,0x24,0x38,0x59,0x34,0xfe,0xe5,0x13,0x1a,0x1a,0x13,0x1a,0x4c,0x50,0x2b,0x20,0x54,0x4f,0x24,0x2c,0x00,0x00,0x00,0x00,0x02,0x00,0x4f,0xff,0xf6,0x02,0x47,0x02,0xdf,0x00,0x1a,0x00,0x27,0x00,0x00,0x16,0x27,0x15,0x14,0x06,0x23,0x22,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x1d,0x01,0x36,0x33,0x32,0x1e,0x01,0x15,0x14,0x0e,0x01,0x23,0x3e,0x01,0x35,0x34,0x26,0x23,0x22,0x06,0x07,0x15,0x1e,0x01,0x33,0xf3,0x49,0x1b,0x13,0x13,0x1a,0x1a,0x13,0x14,0x1a,0x49,0x62,0x3e,0x6f,0x45,0x45,0x6f,0x3e,0x3d,0x5a,0x5a,0x4a,0x2e,0x51,0x1f,0x1f,0x51,0x2e,0x0a,0x4c,0x1a,0x13,0x1a,0x1a,0x13,0x02,0x89,0x13,0x1b,0x1a,0x14,0xf5,0x4c,0x3f,0x79,0x51,0x51,0x79,0x3f,0x55,0x5e,0x56,0x56,0x5e,0x29,0x22,0xd2,0x22,0x29,0x00,0x00,0x01,0x00,0x30,0xff,0xf6,0x01,0xf2,0x02,0x08,0x00,0x27,0x00,0x00,0x16,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x32,0x16,0x17,0x16,0x15,0x14,0x06,0x23,0x22,0x27,0x2e,0x01,0x23,0x22,0x06,0x15,0x14,0x16,0x33,0x32,0x36,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x0e,0x01,0x23,0xf3,0x7a,0x49,0x49,0x7a,0x48,0x35,0x4d,0x21,0x14,0x17,0x0f,0x0b,0x0b,0x21,0x2f,0x23,0x56,0x62,0x62,0x56,0x23,0x2f,0x21,0x0b,0x0b,0x0f,0x17,0x14,0x21,0x4d,0x35,0x0a,0x40,0x78,0x51,0x51,0x78,0x40,0x1b,0x15,0x0d,0x16,0x0f,0x19,0x06,0x11,0x0f,0x63,0x51,0x51,0x63,0x0f,0x11,0x06,0x19,0x0f,0x16,0x0d,0x15,0x1b,0x00,0x00,0x02,0x00,0x30,0xff,0xf6,0x02,0x28,0x02,0xdf,0x00,0x1a,0x00,0x27,0x00,0x00,0x16,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x32,0x17,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x22,0x26,0x3d,0x01,0x06,0x23,0x3e,0x01,0x37,0x35,0x2e,0x01,0x23,0x22,0x06,0x15,0x14,0x16,0x33,0xe4,0x6f,0x45,0x45,0x6f,0x3e,0x62,0x49,0x1b,0x13,0x13,0x1a,0x1a,0x13,0x13,0x1b,0x49,0x62,0x3b,0x51,0x1f,0x1f,0x51,0x2e,0x4a,0x5a,0x5a,0x4a,0x0a,0x3f,0x79,0x51,0x51,0x79,0x3f,0x4c,0xf5,0x14,0x1a,0x1b,0x13,0xfd,0x77,0x13,0x1a,0x1a,0x13,0x1a,0x4c,0x55,0x29,0x22,0xd2,0x22,0x29,0x5e,0x56,0x56,0x5e,0x00,0x00,0x02,0x00,0x30,0xff,0xf6,0x02,0x0d,0x02,0x08,0x00,0x1e,0x00,0x27,0x00,0x00,0x16,0x26,0x35,0x34,0x3e,0x01,0x33,0x32,0x1e,0x01,0x15,0x14,0x06,0x23,0x21,0x1e,0x01,0x33,0x32,0x36,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x0e,0x01,0x23,0x13,0x2e,0x02,0x23,0x22,0x0e,0x01,0x07,0xb9,0x89,0x34,0x6c,0x4f,0x4a,0x6c,0x38,0x19,0x15,0xfe,0xad,0x08,0x58,0x4f,0x2a,0x3f,0x1e,0x08,0x0a,0x10,0x18,0x1a,0x27,0x4c,0x3c,0x80,0x03,0x2d,0x42,0x22,0x22,0x42,0x2c,0x03,0x0a,0x8b,0x7e,0x47,0x78,0x4a,0x45,0x73,0x44,0x13,0x1a,0x46,0x4e,0x10,0x0f,0x04,0x16,0x11,0x16,0x0f,0x16,0x16,0x01,0x33,0x31,0x42,0x1f,0x1f,0x42,0x31,0x00,0x01,0x00,0x13,0xff,0xfb,0x01,0x79,0x02,0xe4,0x00,0x2c,0x00,0x00,0x16,0x26,0x35,0x11,0x23,0x22,0x26,0x35,0x34,0x36,0x3b,0x01,0x35,0x34,0x3e,0x01,0x33,0x32,0x17,0x1e,0x01,0x15,0x14,0x06,0x23,0x22,0x27,0x26,0x23,0x22,0x06,0x1d,0x01,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x11,0x14,0x06,0x23,0x8f,0x1a,0x3b,0x10,0x17,0x17,0x10,0x3b,0x2b,0x45,0x26,0x2f,0x28,0x0a,0x0d,0x16,0x0f,0x0b,0x0c,0x18,0x03,0x29,0x29,0x7d,0x11,0x16,0x16,0x11,0x7d,0x1b,0x13,0x05,0x1a,0x13,0x01,0x88,0x17,0x10,0x11,0x16,0x3a,0x3c,0x4d,0x23,0x14,0x05,0x13,0x0b,0x0f,0x17,0x03,0x03,0x26,0x32,0x37,0x16,0x11,0x10,0x17,0xfe,0x78,0x13,0x1a,0x00,0x00,0x00,0x02,0x00,0x30,0xff,0x10,0x02,0x28,0x02,0x08,0x00,0x25,0x00,0x32,0x00,0x00,0x04,0x26,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x17,0x16,0x33,0x32,0x3d,0x01,0x06,0x23,0x22,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x32,0x17,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x12,0x36,0x37,0x35,0x2e,0x01,0x23,0x22,0x06,0x15,0x14,0x16,0x33,0x01,0x03,0x76,0x26,0x12,0x17,0x11,0x08,0x0a,0x4c,0x59,0x99,0x47,0x64,0x3b,0x6f,0x48,0x48,0x6f,0x3b,0x64,0x47,0x1a,0x13,0x13,0x1b,0x7a,0x71,0x27,0x48,0x21,0x21,0x48,0x2f,0x4b,0x5f,0x5f,0x4b,0xf0,0x1e,0x16,0x0b,0x18,0x10,0x19,0x04,0x26,0xa3,0x43,0x4c,0x3b,0x75,0x54,0x54,0x75,0x3b,0x4c,0x19,0x13,0x1b,0x1b,0x13,0xfe,0x41,0x7e,0x88,0x01,0x43,0x28,0x22,0xce,0x22,0x28,0x5b,0x56,0x56,0x5b,0x00,0x01,0x00,0x4f,0xff,0xfb,0x02,0x17,0x02,0xdf,0x00,0x22,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x3e,0x01,0x33,0x32,0x1e,0x01,0x15,0x11,0x14,0x06,0x23,0x22,0x26,0x35,0x11,0x34,0x23,0x22,0x06,0x07,0x11,0x14,0x06,0x23,0x69,0x1a,0x1a,0x13,0x13,0x1b,0x26,0x58,0x3c,0x37,0x51,0x2b,0x1b,0x13,0x13,0x1a,0x6e,0x32,0x4f,0x23,0x1b,0x13,0x05,0x1a,0x13,0x02,0x89,0x13,0x1b,0x1b,0x13,0xfe,0xfb,0x2a,0x32,0x34,0x5a,0x36,0xfe,0xe4,0x13,0x1a,0x1a,0x13,0x01,0x12,0x7a,0x34,0x2c,0xfe,0xd4,0x13,0x1a,0x00,0x00,0x00,0x02,0x00,0x47,0xff,0xfb,0x00,0xb3,0x02,0xd0,0x00,0x0f,0x00,0x1d,0x00,0x00,0x12,0x26,0x3d,0x01,0x34,0x36,0x3b,0x01,0x32,0x16,0x1d,0x01,0x14,0x06,0x2b,0x01,0x02,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x65,0x1e,0x1e,0x15,0x06,0x15,0x1e,0x1e,0x15,0x06,0x11,0x1a,0x1a,0x13,0x14,0x1a,0x1b,0x13,0x02,0x66,0x1e,0x15,0x04,0x15,0x1e,0x1e,0x15,0x04,0x15,0x1e,0xfd,0x95,0x1a,0x13,0x01,0xad,0x13,0x1b,0x1a,0x14,0xfe,0x53,0x13,0x1a,0x00,0x00,0x00,0x02,0xff,0xd3,0xff,0x10,0x00,0xb8,0x02,0xd0,0x00,0x0f,0x00,0x28,0x00,0x00,0x12,0x26,0x3d,0x01,0x34,0x36,0x3b,0x01,0x32,0x16,0x1d,0x01,0x14,0x06,0x2b,0x01,0x02,0x27,0x2e,0x01,0x35,0x34,0x36,0x33,0x32,0x16,0x33,0x32,0x36,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x6a,0x1e,0x1e,0x15,0x06,0x15,0x1e,0x1e,0x15,0x06,0x77,0x1b,0x0c,0x0e,0x16,0x10,0x06,0x12,0x06,0x1f,0x1e,0x1a,0x13,0x14,0x1a,0x3f,0x44,0x02,0x66,0x1e,0x15,0x04,0x15,0x1e,0x1e,0x15,0x04,0x15,0x1e,0xfc,0xaa,0x09,0x04,0x13,0x0d,0x0f,0x17,0x03,0x16,0x25,0x02,0x39,0x13,0x1b,0x1a,0x14,0xfd,0xc5,0x3e,0x4b,0x00,0x00,0x00,0x00,0x01,0x00,0x4f,0xff,0xfb,0x02,0x00,0x02,0xdf,0x00,0x22,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x17,0x16,0x15,0x14,0x06,0x23,0x22,0x26,0x2f,0x01,0x07,0x15,0x14,0x06,0x23,0x69,0x1a,0x1a,0x13,0x13,0x1b,0xee,0x0f,0x0f,0x17,0x15,0x11,0x90,0xb5,0x0a,0x1a,0x14,0x0a,0x14,0x07,0xac,0x57,0x1b,0x13,0x05,0x1a,0x13,0x02,0x89,0x13,0x1b,0x1b,0x13,0xfe,0x67,0xdc,0x0d,0x1a,0x12,0x11,0x11,0x81,0xf0,0x0d,0x0e,0x14,0x18,0x0a,0x09,0xea,0x4f,0x81,0x13,0x1a,0x00,0x00,0x01,0x00,0x4f,0xff,0xfb,0x00,0xaa,0x02,0xdf,0x00,0x0d,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x69,0x1a,0x1a,0x13,0x14,0x1a,0x1b,0x13,0x05,0x1a,0x13,0x02,0x89,0x13,0x1b,0x1a,0x14,0xfd,0x77,0x13,0x1a,0x00,0x00,0x00,0x00,0x01,0x00,0x4f,0xff,0xfb,0x03,0x4c,0x02,0x08,0x00,0x36,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x1d,0x01,0x3e,0x01,0x33,0x32,0x16,0x17,0x36,0x33,0x32,0x1e,0x01,0x15,0x11,0x14,0x06,0x23,0x22,0x26,0x35,0x11,0x34,0x26,0x23,0x22,0x06,0x07,0x11,0x14,0x06,0x23,0x22,0x26,0x35,0x11,0x34,0x26,0x23,0x22,0x06,0x07,0x11,0x14,0x06,0x23,0x69,0x1a,0x1a,0x13,0x13,0x1b,0x1c,0x4f,0x3f,0x38,0x50,0x11,0x3e,0x7a,0x38,0x4b,0x24,0x1b,0x13,0x13,0x1a,0x2e,0x38,0x33,0x43,0x1a,0x1b,0x13,0x13,0x1a,0x2e,0x38,0x33,0x43,0x1a,0x1b,0x13,0x05,0x1a,0x13,0x01,0xad,0x13,0x1b,0x1b,0x13,0x29,0x28,0x34,0x3c,0x2b,0x67,0x38,0x58,0x30,0xfe,0xe0,0x13,0x1a,0x1a,0x13,0x01,0x0e,0x41,0x3d,0x35,0x2b,0xfe,0xd4,0x13,0x1a,0x1a,0x13,0x01,0x0e,0x41,0x3d,0x35,0x2b,0xfe,0xd4,0x13,0x1a,0x00,0x01,0x00,0x4f,0xff,0xfb,0x02,0x17,0x02,0x08,0x00,0x22,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x1d,0x01,0x3e,0x01,0x33,0x32,0x1e,0x01,0x15,0x11,0x14,0x06,0x23,0x22,0x26,0x35,0x11,0x34,0x23,0x22,0x06,0x07,0x11,0x14,0x06,0x23,0x69,0x1a,0x1a,0x13,0x13,0x1b,0x26,0x58,0x3c,0x37,0x51,0x2b,0x1b,0x13,0x13,0x1a,0x6e,0x32,0x4f,0x23,0x1b,0x13,0x05,0x1a,0x13,0x01,0xad,0x13,0x1b,0x1b,0x13,0x29,0x2a,0x32,0x34,0x5a,0x36,0xfe,0xe4,0x13,0x1a,0x1a,0x13,0x01,0x12,0x7a,0x34,0x2c,0xfe,0xd4,0x13,0x1a,0x00,0x00,0x00,0x00,0x02,0x00,0x30,0xff,0xf6,0x02,0x30,0x02,0x08,0x00,0x0f,0x00,0x1f,0x00,0x00,0x16,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x32,0x1e,0x01,0x15,0x14,0x0e,0x01,0x23,0x3e,0x02,0x35,0x34,0x2e,0x01,0x23,0x22,0x0e,0x01,0x15,0x14,0x1e,0x01,0x33,0xe3,0x74,0x3f,0x3f,0x74,0x4d,0x4c,0x74,0x40,0x40,0x74,0x4c,0x29,0x4b,0x31,0x31,0x4b,0x29,0x2a,0x4b,0x30,0x30,0x4b,0x2a,0x0a,0x42,0x79,0x4e,0x4e,0x79,0x42,0x42,0x79,0x4e,0x4e,0x79,0x42,0x53,0x26,0x52,0x3f,0x3e,0x52,0x25,0x25,0x52,0x3e,0x3f,0x52,0x26,0x00,0x00,0x00,0x00,0x02,0x00,0x4f,0xff,0x15,0x02,0x47,0x02,0x08,0x00,0x1a,0x00,0x27,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x1d,0x01,0x36,0x33,0x32,0x1e,0x01,0x15,0x14,0x0e,0x01,0x23,0x22,0x27,0x15,0x14,0x06,0x23,0x00,0x36,0x35,0x34,0x26,0x23,0x22,0x06,0x07,0x15,0x1e,0x01,0x33,0x69,0x1a,0x1a,0x13,0x13,0x1b,0x49,0x62,0x3e,0x6f,0x45,0x45,0x6f,0x3e,0x62,0x49,0x1a,0x14,0x01,0x16,0x5a,0x5a,0x4a,0x2e,0x51,0x1f,0x1f,0x51,0x2e,0xeb,0x1b,0x13,0x02,0x93,0x13,0x1a,0x1a,0x13,0x1a,0x4c,0x3f,0x79,0x51,0x51,0x79,0x3f,0x4c,0xff,0x14,0x1a,0x01,0x36,0x5e,0x56,0x56,0x5e,0x29,0x22,0xd2,0x22,0x29,0x00,0x00,0x00,0x00,0x02,0x00,0x30,0xff,0x15,0x02,0x28,0x02,0x08,0x00,0x1a,0x00,0x27,0x00,0x00,0x04,0x26,0x35,0x11,0x06,0x23,0x22,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x32,0x17,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x02,0x36,0x37,0x35,0x2e,0x01,0x23,0x22,0x06,0x15,0x14,0x16,0x33,0x01,0xe8,0x1b,0x49,0x62,0x3e,0x6f,0x45,0x45,0x6f,0x3e,0x62,0x49,0x1b,0x13,0x13,0x1a,0x1a,0x13,0x9e,0x51,0x1f,0x1f,0x51,0x2e,0x4a,0x5a,0x5a,0x4a,0xeb,0x1a,0x14,0x00,0xff,0x4c,0x3f,0x79,0x51,0x51,0x79,0x3f,0x4c,0x1a,0x13,0x1a,0x1a,0x13,0xfd,0x6d,0x13,0x1b,0x01,0x36,0x29,0x22,0xd2,0x22,0x29,0x5e,0x56,0x56,0x5e,0x00,0x00,0x00,0x01,0x00,0x4f,0xff,0xfb,0x01,0x78,0x02,0x08,0x00,0x1b,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x1d,0x01,0x36,0x3b,0x01,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x22,0x06,0x07,0x11,0x14,0x06,0x23,0x69,0x1a,0x1a,0x13,0x13,0x1b,0x46,0x57,0x05,0x13,0x19,0x1a,0x14,0x05,0x30,0x50,0x1b,0x1b,0x13,0x05,0x1a,0x13,0x01,0xad,0x13,0x1b,0x1b,0x13,0x2b,0x5e,0x1a,0x13,0x13,0x18,0x2f,0x29,0xfe,0xd0,0x13,0x1a,0x00,0x00,0x00,0x01,0x00,0x2d,0xff,0xf6,0x01,0xb5,0x02,0x08,0x00,0x30,0x00,0x00,0x16,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x17,0x1e,0x01,0x33,0x32,0x35,0x34,0x26,0x27,0x2e,0x02,0x35,0x34,0x36,0x33,0x32,0x17,0x1e,0x01,0x15,0x14,0x06,0x23,0x22,0x27,0x26,0x23,0x22,0x06,0x15,0x14,0x16,0x17,0x1e,0x02,0x15,0x14,0x06,0x23,0x90,0x52,0x11,0x16,0x11,0x09,0x09,0x20,0x40,0x28,0x6f,0x33,0x3a,0x3b,0x4d,0x37,0x65,0x5e,0x4d,0x44,0x0e,0x0f,0x17,0x11,0x05,0x08,0x3a,0x38,0x36,0x3d,0x38,0x3b,0x3b,0x4a,0x35,0x65,0x5c,0x0a,0x2d,0x0c,0x15,0x10,0x18,0x04,0x0e,0x10,0x47,0x17,0x18,0x0f,0x0e,0x1e,0x3d,0x32,0x46,0x58,0x19,0x04,0x16,0x0c,0x10,0x18,0x02,0x12,0x27,0x1f,0x1e,0x1c,0x0d,0x0f,0x1d,0x3e,0x34,0x40,0x54,0x00,0x01,0x00,0x13,0xff,0xf6,0x01,0x69,0x02,0x62,0x00,0x27,0x00,0x00,0x16,0x35,0x11,0x23,0x22,0x26,0x35,0x34,0x3f,0x01,0x36,0x33,0x32,0x16,0x1d,0x01,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x11,0x14,0x16,0x33,0x32,0x37,0x3e,0x01,0x33,0x32,0x16,0x15,0x14,0x07,0x06,0x23,0x6d,0x47,0x08,0x0b,0x09,0x88,0x09,0x08,0x08,0x0b,0x71,0x11,0x16,0x16,0x11,0x71,0x25,0x1c,0x14,0x14,0x04,0x09,0x07,0x0e,0x16,0x17,0x27,0x2c,0x0a,0x84,0x01,0x36,0x0b,0x08,0x0a,0x07,0x85,0x09,0x0c,0x08,0x50,0x16,0x11,0x10,0x17,0xfe,0xd2,0x27,0x15,0x06,0x01,0x02,0x15,0x0f,0x17,0x0c,0x12,0x00,0x00,0x01,0x00,0x4a,0xff,0xf6,0x02,0x12,0x02,0x03,0x00,0x22,0x00,0x00,0x16,0x2e,0x01,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x33,0x32,0x36,0x37,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x22,0x26,0x3d,0x01,0x0e,0x01,0x23,0xc6,0x51,0x2b,0x1b,0x13,0x13,0x1a,0x6e,0x32,0x4f,0x23,0x1b,0x13,0x13,0x1a,0x1a,0x13,0x13,0x1b,0x26,0x58,0x3c,0x0a,0x34,0x5a,0x36,0x01,0x1c,0x13,0x1a,0x1a,0x13,0xfe,0xee,0x7a,0x34,0x2c,0x01,0x2c,0x13,0x1a,0x1a,0x13,0xfe,0x53,0x13,0x1b,0x1b,0x13,0x29,0x2a,0x32,0x00,0x00,0x00,0x00,0x01,0x00,0x1a,0xff,0xfb,0x01,0xf8,0x02,0x03,0x00,0x1a,0x00,0x00,0x16,0x26,0x27,0x03,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x17,0x1b,0x01,0x3e,0x01,0x33,0x32,0x16,0x15,0x14,0x07,0x03,0x0e,0x01,0x2b,0x01,0xf2,0x1e,0x07,0xae,0x05,0x1a,0x13,0x0d,0x17,0x05,0x99,0x99,0x05,0x17,0x0d,0x13,0x1a,0x05,0xae,0x07,0x1e,0x12,0x0a,0x05,0x15,0x10,0x01,0xa0,0x0c,0x09,0x13,0x1b,0x0f,0x0b,0xfe,0x7c,0x01,0x84,0x0b,0x0f,0x1b,0x13,0x09,0x0c,0xfe,0x60,0x10,0x15,0x00,0x00,0x00,0x00,0x01,0x00,0x1c,0xff,0xfb,0x02,0xfc,0x02,0x03,0x00,0x29,0x00,0x00,0x16,0x26,0x27,0x03,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x17,0x1b,0x01,0x3e,0x01,0x33,0x32,0x16,0x17,0x1b,0x01,0x3e,0x01,0x33,0x32,0x16,0x15,0x14,0x07,0x03,0x0e,0x01,0x23,0x22,0x26,0x27,0x0b,0x01,0x0e,0x01,0x23,0xd3,0x20,0x06,0x8e,0x03,0x1a,0x13,0x0e,0x17,0x04,0x75,0x74,0x05,0x1b,0x11,0x11,0x1b,0x05,0x74,0x75,0x04,0x17,0x0e,0x13,0x1a,0x03,0x8e,0x06,0x20,0x14,0x14,0x20,0x07,0x6a,0x6a,0x07,0x20,0x14,0x05,0x18,0x12,0x01,0xa0,0x09,0x08,0x13,0x1a,0x0f,0x0c,0xfe,0x7f,0x01,0x78,0x10,0x14,0x14,0x10,0xfe,0x88,0x01,0x81,0x0c,0x0f,0x1a,0x13,0x08,0x09,0xfe,0x60,0x12,0x18,0x18,0x13,0x01,0x4b,0xfe,0xb5,0x13,0x18,0x00,0x00,0x01,0x00,0x32,0xff,0xfb,0x01,0xeb,0x02,0x03,0x00,0x23,0x00,0x00,0x16,0x26,0x35,0x34,0x3f,0x01,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x1f,0x01,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x17,0x16,0x15,0x14,0x06,0x23,0x22,0x2f,0x01,0x07,0x06,0x23,0x4a,0x17,0x0a,0x9b,0x9b,0x0b,0x1a,0x13,0x18,0x0c,0x8c,0x8b,0x0c,0x17,0x14,0x1a,0x0a,0x9e,0x9c,0x0b,0x18,0x16,0x16,0x0d,0x8e,0x86,0x0f,0x18,0x05,0x19,0x15,0x0f,0x0d,0xb7,0xbd,0x0e,0x0f,0x14,0x19,0x11,0xad,0xad,0x11,0x19,0x12,0x0f,0x0d,0xba,0xbc,0x0c,0x11,0x13,0x1b,0x12,0xaa,0xa8,0x14,0x00,0x00,0x01,0x00,0x1a,0xff,0x15,0x01,0xff,0x02,0x03,0x00,0x1a,0x00,0x00,0x16,0x26,0x35,0x34,0x3f,0x01,0x03,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x17,0x1b,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x01,0x06,0x23,0xaf,0x19,0x03,0x41,0xbc,0x04,0x1a,0x13,0x0e,0x17,0x05,0x9a,0x9d,0x0d,0x1d,0x13,0x1a,0x03,0xfe,0xef,0x0e,0x1c,0xeb,0x1a,0x12,0x08,0x08,0xa7,0x01,0xca,0x0a,0x09,0x13,0x1b,0x10,0x0c,0xfe,0x82,0x01,0x7c,0x1e,0x1b,0x13,0x09,0x08,0xfd,0x70,0x1f,0x00,0x00,0x00,0x00,0x01,0x00,0x28,0x00,0x00,0x01,0xca,0x01,0xfe,0x00,0x1b,0x00,0x00,0x32,0x26,0x35,0x34,0x37,0x01,0x23,0x22,0x26,0x35,0x34,0x36,0x33,0x21,0x32,0x16,0x15,0x14,0x07,0x01,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x4c,0x24,0x10,0x01,0x20,0xfd,0x12,0x18,0x18,0x12,0x01,0x2f,0x1a,0x20,0x0e,0xfe,0xe8,0x01,0x01,0x12,0x19,0x19,0x12,0xfe,0xc8,0x1c,0x19,0x17,0x12,0x01,0x4b,0x18,0x12,0x12,0x19,0x20,0x19,0x17,0x11,0xfe,0xb8,0x19,0x12,0x12,0x18,0x00,0x00,0x01,0x00,0x03,0xff,0x6f,0x01,0x3c,0x02,0xf7,0x00,0x31,0x00,0x00,0x16,0x26,0x3d,0x01,0x34,0x2e,0x01,0x27,0x2e,0x01,0x35,0x34,0x36,0x37,0x3e,0x02,0x3d,0x01,0x34,0x36,0x3b,0x01,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x22,0x06,0x1d,0x01,0x14,0x07,0x16,0x1d,0x01,0x14,0x16,0x3b,0x01,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0xca,0x49,0x0a,0x28,0x2a,0x11,0x11,0x11,0x11,0x2a,0x28,0x0a,0x49,0x43,0x0c,0x0e,0x15,0x15,0x0e,0x0f,0x26,0x15,0x5a,0x5a,0x15,0x26,0x0f,0x0e,0x15,0x15,0x0e,0x0c,0x91,0x34,0x44,0xd3,0x15,0x1c,0x19,0x07,0x03,0x15,0x10,0x10,0x15,0x03,0x07,0x19,0x1c,0x15,0xd3,0x44,0x34,0x15,0x0e,0x0e,0x15,0x18,0x12,0xde,0x55,0x21,0x21,0x55,0xde,0x12,0x18,0x15,0x0e,0x0e,0x15,0x00,0x00,0x00,0x01,0x00,0x56,0xff,0x3c,0x00,0xa7,0x02,0xe5,0x00,0x0d,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x6d,0x17,0x17,0x11,0x11,0x18,0x18,0x11,0xc4,0x17,0x11,0x03,0x58,0x11,0x18,0x18,0x11,0xfc,0xa8,0x11,0x17,0x00,0x00,0x00,0x00,0x01,0x00,0x1c,0xff,0x6f,0x01,0x55,0x02,0xf7,0x00,0x31,0x00,0x00,0x16,0x26,0x35,0x34,0x36,0x3b,0x01,0x32,0x36,0x3d,0x01,0x34,0x37,0x26,0x3d,0x01,0x34,0x26,0x2b,0x01,0x22,0x26,0x35,0x34,0x36,0x3b,0x01,0x32,0x16,0x1d,0x01,0x14,0x1e,0x01,0x17,0x1e,0x01,0x15,0x14,0x06,0x07,0x0e,0x02,0x1d,0x01,0x14,0x06,0x2b,0x01,0x31,0x15,0x15,0x0e,0x0f,0x26,0x15,0x5a,0x5a,0x15,0x26,0x0f,0x0e,0x15,0x15,0x0e,0x0c,0x43,0x49,0x0a,0x28,0x2a,0x11,0x11,0x11,0x11,0x2a,0x28,0x0a,0x49,0x43,0x0c,0x91,0x15,0x0e,0x0e,0x15,0x18,0x12,0xde,0x55,0x21,0x21,0x55,0xde,0x12,0x18,0x15,0x0e,0x0e,0x15,0x34,0x44,0xd3,0x15,0x1c,0x19,0x07,0x03,0x15,0x10,0x10,0x15,0x03,0x07,0x19,0x1c,0x15,0xd3,0x44,0x34,0x00,0x00,0x00,0x01,0x00,0x4a,0x00,0xce,0x02,0x3a,0x01,0x6f,0x00,0x24,0x00,0x00,0x24,0x26,0x27,0x2e,0x01,0x23,0x22,0x07,0x0e,0x01,0x23,0x22,0x26,0x35,0x34,0x3e,0x01,0x33,0x32,0x16,0x17,0x1e,0x01,0x33,0x32,0x36,0x37,0x36,0x37,0x36,0x33,0x32,0x16,0x07,0x0e,0x01,0x23,0x01,0x92,0x3f,0x2d,0x23,0x2b,0x16,0x37,0x0f,0x02,0x0d,0x09,0x0a,0x10,0x23,0x3b,0x21,0x27,0x3f,0x2d,0x23,0x2b,0x16,0x1c,0x16,0x0c,0x03,0x06,0x08,0x10,0x0b,0x10,0x03,0x0c,0x44,0x2f,0xce,0x16,0x15,0x11,0x10,0x36,0x08,0x0b,0x10,0x0a,0x1f,0x3e,0x27,0x16,0x15,0x11,0x10,0x12,0x17,0x08,0x0b,0x0f,0x10,0x0f,0x3f,0x42,0x00,0x00,0x00,0x00,0x02,0x00,0x47,0xff,0x3f,0x00,0xbe,0x02,0x02,0x00,0x0b,0x00,0x1b,0x00,0x00,0x12,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x02,0x26,0x3d,0x01,0x13,0x3e,0x01,0x33,0x32,0x16,0x17,0x13,0x15,0x14,0x06,0x23,0x6a,0x23,0x23,0x18,0x19,0x23,0x23,0x19,0x16,0x1e,0x12,0x01,0x12,0x0f,0x0f,0x11,0x01,0x12,0x1d,0x16,0x01,0x8b,0x23,0x18,0x19,0x23,0x23,0x19,0x18,0x23,0xfd,0xb4,0x1e,0x16,0x63,0x01,0x4a,0x0d,0x10,0x10,0x0d,0xfe,0xb6,0x63,0x16,0x1e,0x00,0x00,0x00,0x02,0x00,0x2c,0xff,0x85,0x01,0xee,0x02,0x6c,0x00,0x38,0x00,0x41,0x00,0x00,0x16,0x26,0x35,0x34,0x3f,0x01,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x32,0x17,0x37,0x3e,0x01,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x16,0x17,0x16,0x15,0x14,0x06,0x23,0x22,0x2f,0x01,0x03,0x16,0x33,0x32,0x36,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x0e,0x01,0x23,0x22,0x27,0x07,0x0e,0x01,0x23,0x13,0x26,0x23,0x22,0x06,0x15,0x14,0x16,0x17,0xab,0x10,0x03,0x21,0x43,0x50,0x49,0x7a,0x48,0x14,0x20,0x1d,0x03,0x0f,0x09,0x0c,0x10,0x02,0x1b,0x1c,0x1c,0x14,0x17,0x0f,0x0b,0x0b,0x2b,0x76,0x13,0x1b,0x23,0x2f,0x21,0x0b,0x0b,0x0f,0x17,0x14,0x21,0x4d,0x35,0x20,0x22,0x23,0x03,0x0f,0x09,0x98,0x05,0x0b,0x56,0x62,0x2c,0x29,0x7b,0x11,0x0b,0x07,0x06,0x61,0x1e,0x7c,0x56,0x51,0x78,0x40,0x04,0x55,0x08,0x0b,0x11,0x0c,0x04,0x06,0x50,0x0a,0x13,0x0d,0x16,0x0f,0x19,0x06,0x14,0xfe,0xa8,0x04,0x0f,0x11,0x06,0x19,0x0f,0x16,0x0d,0x15,0x1b,0x08,0x67,0x09,0x09,0x02,0x2d,0x01,0x63,0x51,0x36,0x51,0x16,0x00,0x00,0x00,0x00,0x01,0x00,0x27,0xff,0xf6,0x02,0x35,0x02,0xc4,0x00,0x51,0x00,0x00,0x24,0x16,0x15,0x14,0x07,0x06,0x23,0x22,0x26,0x27,0x2e,0x01,0x23,0x22,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x37,0x3e,0x01,0x35,0x34,0x27,0x23,0x22,0x26,0x35,0x34,0x36,0x3b,0x01,0x2e,0x01,0x35,0x34,0x36,0x33,0x32,0x17,0x16,0x15,0x14,0x06,0x23,0x22,0x27,0x26,0x23,0x22,0x06,0x15,0x14,0x16,0x1f,0x01,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x16,0x15,0x14,0x07,0x37,0x32,0x16,0x17,0x1e,0x01,0x33,0x32,0x37,0x36,0x33,0x02,0x1d,0x18,0x17,0x31,0x39,0x1c,0x29,0x1e,0x1c,0x2b,0x1d,0x3a,0x32,0x0b,0x0c,0x0f,0x16,0x0e,0x26,0x36,0x03,0x61,0x0f,0x15,0x15,0x0f,0x4f,0x0f,0x0e,0x85,0x6e,0x4a,0x46,0x1e,0x18,0x12,0x07,0x0c,0x3b,0x32,0x55,0x47,0x0c,0x0c,0x07,0xa7,0x0f,0x16,0x15,0x10,0x97,0x02,0x2a,0x19,0x1a,0x29,0x24,0x1c,0x2b,0x17,0x20,0x1f,0x0c,0x04,0x5d,0x17,0x11,0x17,0x0d,0x1b,0x0b,0x0b,0x0b,0x0c,0x22,0x08,0x15,0x0e,0x13,0x0c,0x24,0x68,0x38,0x13,0x12,0x15,0x0f,0x0f,0x16,0x2e,0x39,0x22,0x60,0x6e,0x1d,0x0c,0x1c,0x12,0x18,0x04,0x13,0x42,0x30,0x19,0x36,0x26,0x18,0x16,0x0f,0x10,0x14,0x14,0x0b,0x4d,0x42,0x01,0x0a,0x0b,0x0a,0x0a,0x0b,0x04,0x00,0x00,0x02,0x00,0x42,0x00,0x51,0x02,0x5a,0x02,0x69,0x00,0x33,0x00,0x43,0x00,0x00,0x36,0x26,0x35,0x34,0x3f,0x01,0x26,0x35,0x34,0x37,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x1f,0x01,0x36,0x33,0x32,0x17,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x16,0x15,0x14,0x07,0x17,0x16,0x15,0x14,0x06,0x23,0x22,0x2f,0x01,0x06,0x23,0x22,0x27,0x07,0x06,0x23,0x24,0x3e,0x01,0x35,0x34,0x2e,0x01,0x23,0x22,0x0e,0x01,0x15,0x14,0x1e,0x01,0x33,0x57,0x15,0x0b,0x41,0x2d,0x2d,0x41,0x0b,0x15,0x10,0x0d,0x0d,0x42,0x3f,0x4c,0x4c,0x3f,0x42,0x0d,0x0d,0x10,0x15,0x0b,0x41,0x2d,0x2d,0x41,0x0b,0x15,0x10,0x0d,0x0d,0x42,0x3f,0x4c,0x4c,0x3f,0x42,0x0d,0x0d,0x01,0x11,0x48,0x2a,0x2a,0x48,0x2a,0x2a,0x48,0x2a,0x2a,0x48,0x2a,0x51,0x16,0x0f,0x0f,0x0b,0x41,0x40,0x4c,0x4c,0x40,0x41,0x0b,0x0f,0x0f,0x16,0x0b,0x41,0x2d,0x2d,0x41,0x0b,0x16,0x0f,0x0f,0x0b,0x41,0x40,0x4c,0x4c,0x40,0x41,0x0b,0x0f,0x0f,0x16,0x0b,0x41,0x2d,0x2d,0x41,0x0b,0x70,0x2a,0x48,0x2a,0x2a,0x48,0x2a,0x2a,0x48,0x2a,0x2a,0x48,0x2a,0x00,0x00,0x01,0x00,0x41,0xff,0xfa,0x02,0x51,0x02,0xc8,0x00,0x3b,0x00,0x00,0x04,0x26,0x3d,0x01,0x23,0x22,0x26,0x35,0x34,0x36,0x3b,0x01,0x35,0x23,0x22,0x26,0x35,0x34,0x36,0x3b,0x01,0x03,0x26,0x35,0x34,0x36,0x33,0x32,0x17,0x1b,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x03,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x15,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x15,0x14,0x06,0x23,0x01,0x37,0x1b,0x8d,0x10,0x15,0x15,0x10,0x8d,0x8d,0x10,0x15,0x15,0x10,0x62,0xa8,0x08,0x1c,0x14,0x1b,0x10,0xad,0xad,0x10,0x1b,0x14,0x1c,0x08,0xa8,0x62,0x10,0x15,0x15,0x10,0x8d,0x8d,0x10,0x15,0x15,0x10,0x8d,0x1b,0x12,0x06,0x1a,0x13,0x70,0x15,0x10,0x10,0x16,0x40,0x15,0x10,0x10,0x16,0x01,0x12,0x0d,0x0d,0x15,0x1a,0x1c,0xfe,0xd1,0x01,0x2f,0x1c,0x1a,0x15,0x0d,0x0d,0xfe,0xee,0x16,0x10,0x10,0x15,0x40,0x16,0x10,0x10,0x15,0x70,0x13,0x1a,0x00,0x02,0x00,0x56,0xff,0x3c,0x00,0xa7,0x02,0xe5,0x00,0x0d,0x00,0x1b,0x00,0x00,0x12,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x02,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x6d,0x17,0x17,0x11,0x11,0x18,0x18,0x11,0x11,0x17,0x17,0x11,0x11,0x18,0x18,0x11,0x01,0x6c,0x17,0x11,0x01,0x28,0x11,0x18,0x18,0x11,0xfe,0xd8,0x11,0x17,0xfd,0xd0,0x17,0x11,0x01,0x28,0x11,0x18,0x18,0x11,0xfe,0xd8,0x11,0x17,0x00,0x02,0x00,0x2f,0xff,0x99,0x01,0xdf,0x02,0xc4,0x00,0x37,0x00,0x47,0x00,0x00,0x16,0x27,0x2e,0x01,0x35,0x34,0x36,0x33,0x32,0x17,0x16,0x33,0x32,0x35,0x34,0x26,0x27,0x2e,0x02,0x35,0x34,0x37,0x26,0x35,0x34,0x36,0x33,0x32,0x17,0x1e,0x01,0x15,0x14,0x06,0x23,0x22,0x27,0x26,0x23,0x22,0x15,0x14,0x16,0x17,0x1e,0x02,0x15,0x14,0x07,0x16,0x15,0x14,0x06,0x23,0x12,0x35,0x34,0x2e,0x01,0x27,0x2e,0x01,0x27,0x06,0x15,0x14,0x1e,0x01,0x1f,0x01,0x86,0x47,0x07,0x09,0x17,0x10,0x09,0x0c,0x38,0x53,0x71,0x38,0x3c,0x3a,0x4b,0x35,0x62,0x40,0x65,0x5c,0x54,0x42,0x0c,0x0f,0x19,0x10,0x07,0x08,0x33,0x40,0x71,0x38,0x3c,0x3b,0x4a,0x35,0x63,0x41,0x65,0x5c,0x8f,0x21,0x32,0x2c,0x0a,0x1b,0x10,0x4a,0x21,0x31,0x2c,0x35,0x67,0x2d,0x04,0x13,0x0a,0x11,0x17,0x06,0x1c,0x46,0x1c,0x23,0x17,0x16,0x26,0x43,0x31,0x5d,0x21,0x2f,0x4a,0x40,0x54,0x1b,0x05,0x14,0x0e,0x10,0x18,0x03,0x13,0x46,0x1c,0x23,0x17,0x17,0x26,0x42,0x31,0x5f,0x20,0x2c,0x4c,0x40,0x54,0x01,0x3f,0x46,0x19,0x23,0x17,0x11,0x04,0x0a,0x07,0x12,0x46,0x19,0x23,0x17,0x11,0x15,0xff,0xff,0x00,0x41,0x02,0x3f,0x01,0x4f,0x02,0xa5,0x10,0x03,0x00,0xca,0x01,0x90,0x00,0x00,0x00,0x00,0x00,0x03,0x00,0x33,0xff,0xf7,0x03,0x01,0x02,0xc3,0x00,0x0f,0x00,0x1f,0x00,0x45,0x00,0x00,0x04,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x32,0x1e,0x01,0x15,0x14,0x0e,0x01,0x23,0x3e,0x02,0x35,0x34,0x2e,0x01,0x23,0x22,0x0e,0x01,0x15,0x14,0x1e,0x01,0x33,0x2e,0x02,0x35,0x34,0x3e,0x01,0x33,0x32,0x16,0x17,0x16,0x15,0x14,0x06,0x23,0x22,0x27,0x26,0x23,0x22,0x06,0x15,0x14,0x16,0x33,0x32,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x0e,0x01,0x23,0x01,0x39,0xa5,0x61,0x61,0xa5,0x61,0x61,0xa5,0x61,0x61,0xa5,0x61,0x53,0x8d,0x53,0x53,0x8d,0x54,0x53,0x8c,0x53,0x53,0x8c,0x53,0x32,0x57,0x31,0x31,0x57,0x39,0x3a,0x56,0x19,0x03,0x12,0x0e,0x13,0x0c,0x26,0x47,0x3c,0x42,0x42,0x3c,0x47,0x26,0x0c,0x13,0x0e,0x12,0x03,0x19,0x56,0x3a,0x09,0x61,0xa4,0x61,0x61,0xa4,0x61,0x61,0xa4,0x61,0x61,0xa4,0x61,0x34,0x53,0x8c,0x53,0x53,0x8c,0x53,0x53,0x8c,0x53,0x53,0x8c,0x53,0x67,0x32,0x5c,0x3d,0x3d,0x5c,0x32,0x37,0x32,0x06,0x07,0x0d,0x13,0x16,0x43,0x52,0x3c,0x3c,0x52,0x43,0x16,0x12,0x0e,0x07,0x06,0x32,0x37,0x00,0x00,0x00,0x03,0x00,0x42,0x00,0xe5,0x01,0x95,0x02,0xc4,0x00,0x24,0x00,0x2e,0x00,0x3c,0x00,0x00,0x12,0x26,0x35,0x34,0x36,0x3b,0x01,0x35,0x34,0x26,0x23,0x22,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x36,0x37,0x36,0x33,0x32,0x16,0x1d,0x01,0x14,0x06,0x23,0x22,0x26,0x3d,0x01,0x0e,0x01,0x23,0x3e,0x01,0x37,0x35,0x23,0x22,0x06,0x15,0x14,0x33,0x06,0x26,0x35,0x34,0x36,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x95,0x44,0x51,0x50,0x4c,0x2a,0x2b,0x2f,0x2c,0x06,0x04,0x0d,0x13,0x0d,0x0a,0x3f,0x3a,0x48,0x4a,0x15,0x0f,0x0f,0x15,0x12,0x3d,0x2a,0x33,0x33,0x13,0x44,0x2f,0x32,0x43,0x89,0x11,0x11,0x0b,0x01,0x1b,0x0b,0x11,0x11,0x0b,0xfe,0xe5,0x01,0x53,0x3a,0x31,0x33,0x38,0x02,0x2d,0x28,0x10,0x02,0x13,0x0d,0x0a,0x10,0x04,0x18,0x52,0x39,0xbf,0x0f,0x15,0x15,0x0f,0x09,0x15,0x1b,0x41,0x1b,0x14,0x30,0x16,0x19,0x30,0xaf,0x11,0x0b,0x0b,0x11,0x11,0x0b,0x0b,0x11,0x00,0x00,0x02,0x00,0x36,0x00,0x14,0x01,0xff,0x01,0xea,0x00,0x15,0x00,0x2b,0x00,0x00,0x36,0x2f,0x01,0x26,0x35,0x34,0x3f,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x17,0x16,0x15,0x14,0x06,0x23,0x32,0x2f,0x01,0x26,0x35,0x34,0x3f,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x17,0x16,0x15,0x14,0x06,0x23,0xf5,0x09,0xa4,0x12,0x12,0xa4,0x09,0x13,0x11,0x16,0x09,0xa0,0xa0,0x09,0x16,0x11,0xbd,0x09,0xa4,0x12,0x12,0xa4,0x09,0x13,0x11,0x16,0x09,0xa0,0xa0,0x09,0x16,0x11,0x14,0x0b,0xb5,0x14,0x17,0x17,0x14,0xb5,0x0b,0x16,0x11,0x0f,0x0b,0xaa,0xaa,0x0a,0x10,0x11,0x16,0x0b,0xb5,0x14,0x17,0x17,0x14,0xb5,0x0b,0x16,0x11,0x0f,0x0b,0xaa,0xaa,0x0a,0x10,0x11,0x16,0x00,0x00,0x00,0x00,0x01,0x00,0x49,0x00,0xa8,0x01,0xf0,0x01,0x7f,0x00,0x12,0x00,0x00,0x24,0x26,0x3d,0x01,0x21,0x22,0x26,0x35,0x34,0x36,0x33,0x21,0x32,0x16,0x1d,0x01,0x14,0x06,0x23,0x01,0xba,0x15,0xfe,0xc8,0x0f,0x15,0x15,0x0f,0x01,0x59,0x11,0x19,0x16,0x10,0xa8,0x15,0x10,0x6a,0x15,0x0f,0x0f,0x15,0x19,0x11,0x88,0x10,0x15,0x00,0x00,0x00,0xff,0xff,0x00,0x45,0x00,0xf0,0x01,0x53,0x01,0x41,0x10,0x02,0x00,0x11,0x00,0x00,0x00,0x04,0x00,0x33,0xff,0xf6,0x03,0x01,0x02,0xc4,0x00,0x0f,0x00,0x1f,0x00,0x40,0x00,0x49,0x00,0x00,0x04,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x32,0x1e,0x01,0x15,0x14,0x0e,0x01,0x23,0x3e,0x02,0x35,0x34,0x2e,0x01,0x23,0x22,0x0e,0x01,0x15,0x14,0x1e,0x01,0x33,0x2e,0x01,0x35,0x11,0x34,0x36,0x3b,0x01,0x32,0x16,0x15,0x14,0x06,0x07,0x1e,0x01,0x1d,0x01,0x14,0x06,0x23,0x22,0x26,0x3d,0x01,0x34,0x26,0x2b,0x01,0x15,0x14,0x06,0x23,0x37,0x32,0x36,0x35,0x34,0x26,0x2b,0x01,0x15,0x01,0x39,0xa5,0x61,0x61,0xa5,0x61,0x61,0xa5,0x61,0x61,0xa5,0x61,0x53,0x8d,0x53,0x53,0x8d,0x54,0x53,0x8c,0x53,0x53,0x8c,0x53,0x81,0x13,0x1a,0x13,0x78,0x4f,0x4e,0x2a,0x20,0x1c,0x29,0x14,0x0e,0x0e,0x14,0x19,0x30,0x6d,0x14,0x0e,0x81,0x2b,0x33,0x2c,0x34,0x5d,0x0a,0x61,0xa5,0x61,0x61,0xa5,0x61,0x61,0xa5,0x61,0x61,0xa5,0x61,0x34,0x53,0x8d,0x54,0x53,0x8c,0x53,0x53,0x8c,0x53,0x54,0x8d,0x53,0x67,0x13,0x0e,0x01,0x44,0x13,0x1b,0x42,0x36,0x24,0x31,0x0c,0x0a,0x3d,0x36,0x1b,0x0e,0x14,0x14,0x0e,0x12,0x2b,0x3b,0x79,0x0e,0x13,0xd5,0x23,0x21,0x1f,0x21,0x84,0x00,0x00,0xff,0xff,0x00,0x35,0x02,0x4c,0x01,0x5b,0x02,0x88,0x10,0x03,0x00,0xc7,0x01,0x90,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x34,0x01,0xb2,0x01,0x46,0x02,0xc4,0x00,0x0f,0x00,0x1b,0x00,0x00,0x12,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x32,0x1e,0x01,0x15,0x14,0x0e,0x01,0x23,0x3e,0x01,0x35,0x34,0x26,0x23,0x22,0x06,0x15,0x14,0x16,0x33,0x98,0x3f,0x25,0x25,0x3f,0x25,0x25,0x3f,0x25,0x25,0x3f,0x25,0x23,0x32,0x32,0x23,0x23,0x32,0x32,0x23,0x01,0xb2,0x25,0x3f,0x25,0x25,0x3f,0x25,0x25,0x3f,0x25,0x25,0x3f,0x25,0x34,0x32,0x23,0x23,0x32,0x32,0x23,0x23,0x32,0x00,0x00,0x02,0x00,0x3e,0x00,0x00,0x02,0x20,0x02,0x68,0x00,0x1f,0x00,0x2d,0x00,0x00,0x24,0x26,0x3d,0x01,0x23,0x22,0x26,0x35,0x34,0x36,0x3b,0x01,0x35,0x34,0x36,0x33,0x32,0x16,0x1d,0x01,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x15,0x14,0x06,0x23,0x06,0x26,0x35,0x34,0x36,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x01,0x1f,0x17,0xa4,0x10,0x16,0x16,0x10,0xa4,0x17,0x10,0x11,0x16,0xa3,0x11,0x16,0x16,0x11,0xa3,0x16,0x11,0xdb,0x16,0x16,0x10,0x01,0x95,0x11,0x16,0x16,0x11,0xfe,0x6b,0x91,0x17,0x10,0x9e,0x16,0x10,0x11,0x16,0x9e,0x11,0x16,0x16,0x11,0x9e,0x16,0x11,0x10,0x16,0x9e,0x10,0x17,0x91,0x16,0x10,0x11,0x16,0x16,0x11,0x10,0x16,0x00,0x00,0x00,0x00,0x01,0x00,0x26,0x01,0x36,0x01,0x47,0x02,0xc5,0x00,0x28,0x00,0x00,0x12,0x26,0x35,0x34,0x36,0x37,0x3e,0x01,0x35,0x34,0x26,0x23,0x22,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x0e,0x01,0x07,0x0e,0x01,0x07,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x3c,0x16,0x40,0x3d,0x32,0x2f,0x26,0x28,0x37,0x28,0x06,0x07,0x0c,0x10,0x0e,0x37,0x4b,0x3a,0x4b,0x29,0x38,0x2c,0x1f,0x23,0x09,0xbe,0x0d,0x11,0x11,0x0d,0xdc,0x01,0x36,0x18,0x10,0x29,0x3c,0x27,0x20,0x29,0x19,0x1b,0x21,0x16,0x03,0x0f,0x0d,0x11,0x08,0x21,0x43,0x32,0x22,0x3b,0x2b,0x1d,0x14,0x1a,0x0c,0x11,0x0d,0x0d,0x10,0x00,0x00,0x00,0x01,0x00,0x24,0x01,0x30,0x01,0x42,0x02,0xc5,0x00,0x36,0x00,0x00,0x13,0x2e,0x01,0x35,0x34,0x36,0x33,0x32,0x17,0x1e,0x01,0x33,0x32,0x36,0x35,0x34,0x2b,0x01,0x22,0x26,0x35,0x34,0x36,0x3b,0x01,0x32,0x36,0x35,0x34,0x26,0x23,0x22,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x07,0x1e,0x01,0x15,0x14,0x06,0x23,0x22,0x35,0x07,0x0a,0x12,0x0b,0x03,0x08,0x1b,0x27,0x19,0x2a,0x32,0x70,0x0b,0x0d,0x11,0x11,0x0d,0x05,0x2f,0x3a,0x2e,0x20,0x2e,0x28,0x06,0x07,0x0b,0x11,0x13,0x38,0x38,0x45,0x43,0x24,0x1a,0x20,0x2c,0x47,0x4b,0x4e,0x01,0x49,0x04,0x0e,0x09,0x0c,0x11,0x02,0x08,0x09,0x1a,0x1a,0x3e,0x11,0x0d,0x0d,0x11,0x1b,0x1f,0x1b,0x17,0x13,0x03,0x0f,0x0c,0x10,0x0a,0x1e,0x3b,0x2f,0x24,0x2c,0x0a,0x0a,0x2f,0x28,0x30,0x40,0xff,0xff,0x00,0xad,0x02,0x37,0x01,0x2d,0x02,0xd2,0x10,0x03,0x00,0xc4,0x01,0x90,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x54,0xff,0x26,0x02,0x1c,0x02,0x03,0x00,0x27,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x33,0x32,0x36,0x37,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x22,0x26,0x3d,0x01,0x0e,0x01,0x23,0x22,0x27,0x15,0x14,0x06,0x23,0x6e,0x1a,0x1b,0x13,0x13,0x1a,0x6e,0x32,0x4f,0x23,0x1b,0x13,0x13,0x1a,0x1a,0x13,0x13,0x1b,0x28,0x51,0x3c,0x35,0x28,0x1b,0x13,0xda,0x1a,0x13,0x02,0x83,0x13,0x1a,0x1a,0x13,0xfe,0xee,0x7a,0x34,0x2c,0x01,0x2c,0x13,0x1a,0x1a,0x13,0xfe,0x53,0x13,0x1b,0x1b,0x13,0x29,0x2b,0x31,0x1b,0xbe,0x13,0x1a,0x00,0x01,0x00,0x27,0xff,0x20,0x02,0xb0,0x02,0xba,0x00,0x21,0x00,0x00,0x04,0x26,0x35,0x11,0x23,0x22,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x11,0x14,0x06,0x23,0x22,0x26,0x35,0x11,0x23,0x11,0x14,0x06,0x23,0x01,0x63,0x17,0x24,0x46,0x76,0x45,0x45,0x76,0x46,0x01,0x60,0x11,0x17,0x17,0x11,0x2e,0x17,0x11,0x10,0x17,0x70,0x17,0x11,0xe0,0x17,0x11,0x01,0x70,0x45,0x76,0x46,0x46,0x76,0x45,0x17,0x11,0x10,0x17,0xfc,0xdd,0x11,0x17,0x17,0x11,0x03,0x23,0xfc,0xdd,0x11,0x17,0x00,0x00,0x01,0x00,0x45,0x00,0xe2,0x00,0xbf,0x01,0x58,0x00,0x0f,0x00,0x00,0x36,0x26,0x3d,0x01,0x34,0x36,0x3b,0x01,0x32,0x16,0x1d,0x01,0x14,0x06,0x2b,0x01,0x66,0x21,0x21,0x17,0x0a,0x17,0x21,0x21,0x17,0x0a,0xe2,0x21,0x17,0x06,0x17,0x21,0x21,0x17,0x06,0x17,0x21,0x00,0xff,0xff,0x00,0x56,0xff,0x23,0x01,0x2a,0x00,0x11,0x10,0x03,0x00,0xd6,0x01,0x90,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x4e,0x01,0x36,0x01,0x38,0x02,0xc4,0x00,0x1f,0x00,0x00,0x12,0x26,0x35,0x34,0x36,0x3b,0x01,0x11,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x36,0x3f,0x01,0x36,0x33,0x32,0x16,0x15,0x11,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x5f,0x10,0x10,0x0d,0x3c,0x2d,0x0a,0x05,0x0c,0x12,0x0a,0x09,0x48,0x0a,0x0a,0x13,0x18,0x32,0x0d,0x11,0x11,0x0d,0xae,0x01,0x36,0x10,0x0d,0x0d,0x11,0x01,0x09,0x16,0x04,0x11,0x0d,0x08,0x10,0x04,0x25,0x05,0x19,0x12,0xfe,0xd8,0x11,0x0d,0x0d,0x10,0x00,0x00,0x00,0x03,0x00,0x46,0x00,0xe5,0x01,0xbc,0x02,0xc4,0x00,0x0b,0x00,0x17,0x00,0x25,0x00,0x00,0x12,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x3e,0x01,0x35,0x34,0x26,0x23,0x22,0x06,0x15,0x14,0x16,0x33,0x06,0x26,0x35,0x34,0x36,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0xb0,0x61,0x61,0x51,0x51,0x61,0x61,0x51,0x2a,0x40,0x40,0x2a,0x2a,0x40,0x40,0x2a,0xaa,0x11,0x11,0x0b,0x01,0x3e,0x0b,0x11,0x11,0x0b,0xfe,0xc2,0x01,0x53,0x66,0x53,0x53,0x65,0x65,0x53,0x53,0x66,0x40,0x3d,0x3d,0x3c,0x3c,0x3c,0x3c,0x3d,0x3d,0xae,0x11,0x0b,0x0b,0x11,0x11,0x0b,0x0b,0x11,0x00,0x02,0x00,0x4a,0x00,0x14,0x02,0x13,0x01,0xea,0x00,0x15,0x00,0x2b,0x00,0x00,0x36,0x26,0x35,0x34,0x3f,0x01,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x1f,0x01,0x16,0x15,0x14,0x0f,0x01,0x06,0x23,0x32,0x26,0x35,0x34,0x3f,0x01,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x1f,0x01,0x16,0x15,0x14,0x0f,0x01,0x06,0x23,0x60,0x16,0x09,0xa0,0xa0,0x09,0x16,0x11,0x13,0x09,0xa4,0x12,0x12,0xa4,0x09,0x13,0xbf,0x16,0x09,0xa0,0xa0,0x09,0x16,0x11,0x13,0x09,0xa4,0x12,0x12,0xa4,0x09,0x13,0x14,0x16,0x11,0x10,0x0a,0xaa,0xaa,0x0b,0x0f,0x11,0x16,0x0b,0xb5,0x14,0x17,0x17,0x14,0xb5,0x0b,0x16,0x11,0x10,0x0a,0xaa,0xaa,0x0b,0x0f,0x11,0x16,0x0b,0xb5,0x14,0x17,0x17,0x14,0xb5,0x0b,0x00,0x00,0x00,0x00,0x04,0x00,0x4e,0xff,0xe8,0x03,0x63,0x02,0xd4,0x00,0x1f,0x00,0x3d,0x00,0x40,0x00,0x50,0x00,0x00,0x12,0x26,0x35,0x34,0x36,0x3b,0x01,0x11,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x36,0x3f,0x01,0x36,0x33,0x32,0x16,0x15,0x11,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x00,0x26,0x3d,0x01,0x23,0x22,0x26,0x35,0x34,0x3f,0x01,0x36,0x3b,0x01,0x32,0x16,0x1d,0x01,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x15,0x14,0x06,0x23,0x27,0x33,0x35,0x00,0x26,0x35,0x34,0x37,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x01,0x06,0x23,0x5f,0x10,0x10,0x0d,0x3c,0x2d,0x0a,0x05,0x0c,0x12,0x0a,0x09,0x48,0x0a,0x0a,0x13,0x18,0x32,0x0d,0x11,0x11,0x0d,0xae,0x02,0x88,0x13,0x9c,0x11,0x19,0x0b,0xa5,0x11,0x13,0x08,0x12,0x18,0x24,0x0d,0x11,0x11,0x0d,0x24,0x12,0x0e,0x9f,0x7f,0xfe,0x14,0x14,0x05,0x01,0x9e,0x08,0x14,0x0e,0x14,0x05,0xfe,0x62,0x08,0x14,0x01,0x36,0x10,0x0d,0x0d,0x11,0x01,0x09,0x16,0x04,0x11,0x0d,0x08,0x10,0x04,0x25,0x05,0x19,0x12,0xfe,0xd8,0x11,0x0d,0x0d,0x10,0xfe,0xc5,0x13,0x0d,0x45,0x19,0x11,0x0f,0x0e,0xd3,0x15,0x19,0x11,0xca,0x11,0x0d,0x0d,0x10,0x45,0x0d,0x13,0xa0,0xa5,0xfe,0xa8,0x13,0x0f,0x08,0x0a,0x02,0xaa,0x0e,0x13,0x0f,0x08,0x0a,0xfd,0x56,0x0e,0x00,0x00,0x00,0x03,0x00,0x4e,0xff,0xe8,0x03,0x78,0x02,0xd4,0x00,0x1f,0x00,0x48,0x00,0x58,0x00,0x00,0x12,0x26,0x35,0x34,0x36,0x3b,0x01,0x11,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x36,0x3f,0x01,0x36,0x33,0x32,0x16,0x15,0x11,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x00,0x26,0x35,0x34,0x36,0x37,0x3e,0x01,0x35,0x34,0x26,0x23,0x22,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x0e,0x01,0x07,0x0e,0x01,0x07,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x04,0x26,0x35,0x34,0x37,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x01,0x06,0x23,0x5f,0x10,0x10,0x0d,0x3c,0x2d,0x0a,0x05,0x0c,0x12,0x0a,0x09,0x48,0x0a,0x0a,0x13,0x18,0x32,0x0d,0x11,0x11,0x0d,0xae,0x02,0x01,0x16,0x40,0x3d,0x32,0x2f,0x26,0x28,0x37,0x28,0x06,0x07,0x0c,0x10,0x0e,0x37,0x4b,0x3a,0x4b,0x29,0x38,0x2c,0x1f,0x23,0x09,0xbe,0x0d,0x11,0x11,0x0d,0xdc,0xfe,0x77,0x14,0x05,0x01,0x9e,0x08,0x14,0x0e,0x14,0x05,0xfe,0x62,0x08,0x14,0x01,0x36,0x10,0x0d,0x0d,0x11,0x01,0x09,0x16,0x04,0x11,0x0d,0x08,0x10,0x04,0x25,0x05,0x19,0x12,0xfe,0xd8,0x11,0x0d,0x0d,0x10,0xfe,0xca,0x18,0x10,0x29,0x3c,0x27,0x20,0x29,0x19,0x1b,0x21,0x16,0x03,0x0f,0x0d,0x11,0x08,0x21,0x43,0x32,0x22,0x3b,0x2b,0x1d,0x14,0x1a,0x0c,0x11,0x0d,0x0d,0x10,0x18,0x13,0x0f,0x08,0x0a,0x02,0xaa,0x0e,0x13,0x0f,0x08,0x0a,0xfd,0x56,0x0e,0x00,0x00,0x00,0x00,0x04,0x00,0x24,0xff,0xe8,0x03,0x63,0x02,0xd4,0x00,0x36,0x00,0x54,0x00,0x57,0x00,0x67,0x00,0x00,0x13,0x2e,0x01,0x35,0x34,0x36,0x33,0x32,0x17,0x1e,0x01,0x33,0x32,0x36,0x35,0x34,0x2b,0x01,0x22,0x26,0x35,0x34,0x36,0x3b,0x01,0x32,0x36,0x35,0x34,0x26,0x23,0x22,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x07,0x1e,0x01,0x15,0x14,0x06,0x23,0x22,0x00,0x26,0x3d,0x01,0x23,0x22,0x26,0x35,0x34,0x3f,0x01,0x36,0x3b,0x01,0x32,0x16,0x1d,0x01,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x15,0x14,0x06,0x23,0x27,0x33,0x35,0x00,0x26,0x35,0x34,0x37,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x01,0x06,0x23,0x35,0x07,0x0a,0x12,0x0b,0x03,0x08,0x1b,0x27,0x19,0x2a,0x32,0x70,0x0b,0x0d,0x11,0x11,0x0d,0x05,0x2f,0x3a,0x2e,0x20,0x2e,0x28,0x06,0x07,0x0b,0x11,0x13,0x38,0x38,0x45,0x43,0x24,0x1a,0x20,0x2c,0x47,0x4b,0x4e,0x02,0x92,0x13,0x9c,0x11,0x19,0x0b,0xa5,0x11,0x13,0x08,0x12,0x18,0x24,0x0d,0x11,0x11,0x0d,0x24,0x12,0x0e,0x9f,0x7f,0xfe,0x14,0x14,0x05,0x01,0x9e,0x08,0x14,0x0e,0x14,0x05,0xfe,0x62,0x08,0x14,0x01,0x49,0x04,0x0e,0x09,0x0c,0x11,0x02,0x08,0x09,0x1a,0x1a,0x3e,0x11,0x0d,0x0d,0x11,0x1b,0x1f,0x1b,0x17,0x13,0x03,0x0f,0x0c,0x10,0x0a,0x1e,0x3b,0x2f,0x24,0x2c,0x0a,0x0a,0x2f,0x28,0x30,0x40,0xfe,0xcb,0x13,0x0d,0x45,0x19,0x11,0x0f,0x0e,0xd3,0x15,0x19,0x11,0xca,0x11,0x0d,0x0d,0x10,0x45,0x0d,0x13,0xa0,0xa5,0xfe,0xa8,0x13,0x0f,0x08,0x0a,0x02,0xaa,0x0e,0x13,0x0f,0x08,0x0a,0xfd,0x56,0x0e,0x00,0x02,0x00,0x28,0xff,0x3a,0x01,0xd2,0x02,0x02,0x00,0x0b,0x00,0x31,0x00,0x00,0x12,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x02,0x26,0x35,0x34,0x3e,0x01,0x37,0x3e,0x01,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x0e,0x01,0x07,0x0e,0x01,0x15,0x14,0x33,0x32,0x36,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x0e,0x01,0x23,0xf8,0x23,0x23,0x19,0x18,0x23,0x23,0x18,0x6e,0x7b,0x1c,0x28,0x21,0x2b,0x2b,0x1a,0x12,0x13,0x19,0x20,0x2b,0x24,0x26,0x24,0x8f,0x23,0x43,0x1a,0x0c,0x0d,0x11,0x17,0x19,0x29,0x54,0x33,0x01,0x8b,0x23,0x18,0x19,0x23,0x23,0x19,0x18,0x23,0xfd,0xaf,0x66,0x57,0x27,0x3b,0x29,0x1a,0x22,0x37,0x28,0x10,0x17,0x17,0x10,0x2d,0x44,0x2d,0x1d,0x1e,0x2c,0x1c,0x6d,0x11,0x10,0x08,0x18,0x10,0x17,0x0f,0x1a,0x16,0x00,0x03,0x00,0x32,0xff,0xfb,0x02,0xb8,0x03,0x7e,0x00,0x0f,0x00,0x2b,0x00,0x2e,0x00,0x00,0x01,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x1f,0x01,0x16,0x15,0x14,0x06,0x23,0x22,0x00,0x26,0x35,0x34,0x37,0x01,0x3e,0x01,0x3b,0x01,0x32,0x16,0x17,0x01,0x16,0x15,0x14,0x06,0x23,0x22,0x26,0x2f,0x01,0x21,0x07,0x0e,0x01,0x23,0x13,0x21,0x03,0x01,0x5f,0x45,0x0a,0x14,0x11,0x17,0x0a,0x33,0x07,0x0f,0x0c,0x0d,0xfe,0xe3,0x19,0x05,0x00,0xff,0x08,0x1d,0x15,0x0a,0x15,0x1d,0x08,0x00,0xff,0x05,0x19,0x14,0x0e,0x17,0x06,0x41,0xfe,0xac,0x41,0x06,0x17,0x0e,0x8f,0x01,0x0e,0x87,0x02,0xee,0x52,0x0b,0x0e,0x11,0x14,0x13,0x5a,0x0a,0x09,0x0c,0x0f,0xfd,0x18,0x1a,0x13,0x08,0x0c,0x02,0x5a,0x12,0x17,0x17,0x12,0xfd,0xa6,0x0c,0x08,0x13,0x1a,0x0f,0x0d,0x9c,0x9c,0x0d,0x0f,0x01,0x0b,0x01,0x45,0x00,0x00,0x03,0x00,0x32,0xff,0xfb,0x02,0xb8,0x03,0x7e,0x00,0x0f,0x00,0x2b,0x00,0x2e,0x00,0x00,0x00,0x26,0x35,0x34,0x3f,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x06,0x23,0x00,0x26,0x35,0x34,0x37,0x01,0x3e,0x01,0x3b,0x01,0x32,0x16,0x17,0x01,0x16,0x15,0x14,0x06,0x23,0x22,0x26,0x2f,0x01,0x21,0x07,0x0e,0x01,0x23,0x13,0x21,0x03,0x01,0x69,0x0f,0x07,0x33,0x0a,0x17,0x10,0x15,0x0a,0x45,0x09,0x0d,0xfe,0xd6,0x19,0x05,0x00,0xff,0x08,0x1d,0x15,0x0a,0x15,0x1d,0x08,0x00,0xff,0x05,0x19,0x14,0x0e,0x17,0x06,0x41,0xfe,0xac,0x41,0x06,0x17,0x0e,0x8f,0x01,0x0e,0x87,0x02,0xe3,0x0f,0x0c,0x09,0x0a,0x5a,0x13,0x14,0x11,0x0e,0x0b,0x52,0x0b,0xfd,0x18,0x1a,0x13,0x08,0x0c,0x02,0x5a,0x12,0x17,0x17,0x12,0xfd,0xa6,0x0c,0x08,0x13,0x1a,0x0f,0x0d,0x9c,0x9c,0x0d,0x0f,0x01,0x0b,0x01,0x45,0x00,0x03,0x00,0x32,0xff,0xfb,0x02,0xb8,0x03,0x6d,0x00,0x18,0x00,0x34,0x00,0x37,0x00,0x00,0x00,0x26,0x37,0x34,0x3f,0x01,0x3e,0x01,0x3b,0x01,0x32,0x16,0x1f,0x01,0x16,0x15,0x16,0x06,0x23,0x22,0x2f,0x01,0x07,0x06,0x23,0x02,0x26,0x35,0x34,0x37,0x01,0x3e,0x01,0x3b,0x01,0x32,0x16,0x17,0x01,0x16,0x15,0x14,0x06,0x23,0x22,0x26,0x2f,0x01,0x21,0x07,0x0e,0x01,0x23,0x13,0x21,0x03,0x00,0xff,0x12,0x01,0x08,0x44,0x09,0x12,0x0d,0x26,0x0d,0x12,0x09,0x44,0x08,0x01,0x12,0x0d,0x0b,0x07,0x57,0x57,0x07,0x0b,0xc1,0x19,0x05,0x00,0xff,0x08,0x1d,0x15,0x0a,0x15,0x1d,0x08,0x00,0xff,0x05,0x19,0x14,0x0e,0x17,0x06,0x41,0xfe,0xac,0x41,0x06,0x17,0x0e,0x8f,0x01,0x0e,0x87,0x02,0xe2,0x13,0x0b,0x0b,0x08,0x46,0x0a,0x0a,0x0a,0x0a,0x46,0x08,0x0b,0x0b,0x13,0x07,0x4a,0x4a,0x07,0xfd,0x19,0x1a,0x13,0x08,0x0c,0x02,0x5a,0x12,0x17,0x17,0x12,0xfd,0xa6,0x0c,0x08,0x13,0x1a,0x0f,0x0d,0x9c,0x9c,0x0d,0x0f,0x01,0x0b,0x01,0x45,0x00,0x00,0x00,0x00,0x03,0x00,0x32,0xff,0xfb,0x02,0xb8,0x03,0x5e,0x00,0x21,0x00,0x3d,0x00,0x40,0x00,0x00,0x12,0x26,0x35,0x34,0x3e,0x01,0x33,0x32,0x16,0x17,0x1e,0x01,0x33,0x32,0x36,0x37,0x36,0x33,0x32,0x16,0x17,0x14,0x06,0x23,0x22,0x26,0x27,0x2e,0x01,0x23,0x22,0x07,0x06,0x23,0x02,0x26,0x35,0x34,0x37,0x01,0x3e,0x01,0x3b,0x01,0x32,0x16,0x17,0x01,0x16,0x15,0x14,0x06,0x23,0x22,0x26,0x2f,0x01,0x21,0x07,0x0e,0x01,0x23,0x13,0x21,0x03,0xe2,0x0e,0x15,0x26,0x19,0x14,0x23,0x19,0x17,0x21,0x12,0x0f,0x11,0x05,0x08,0x11,0x0a,0x0c,0x01,0x30,0x24,0x14,0x24,0x1a,0x17,0x20,0x11,0x1a,0x0d,0x06,0x11,0xa0,0x19,0x05,0x00,0xff,0x08,0x1d,0x15,0x0a,0x15,0x1d,0x08,0x00,0xff,0x05,0x19,0x14,0x0e,0x17,0x06,0x41,0xfe,0xac,0x41,0x06,0x17,0x0e,0x8f,0x01,0x0e,0x87,0x02,0xe7,0x0d,0x0a,0x15,0x2c,0x1e,0x0c,0x0c,0x0b,0x0c,0x0e,0x0d,0x15,0x0d,0x09,0x23,0x3c,0x0d,0x0c,0x0b,0x0c,0x20,0x12,0xfd,0x14,0x1a,0x13,0x08,0x0c,0x02,0x5a,0x12,0x17,0x17,0x12,0xfd,0xa6,0x0c,0x08,0x13,0x1a,0x0f,0x0d,0x9c,0x9c,0x0d,0x0f,0x01,0x0b,0x01,0x45,0x00,0x00,0x00,0x00,0x04,0x00,0x32,0xff,0xfb,0x02,0xb8,0x03,0x51,0x00,0x0b,0x00,0x17,0x00,0x33,0x00,0x36,0x00,0x00,0x00,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x32,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x00,0x26,0x35,0x34,0x37,0x01,0x3e,0x01,0x3b,0x01,0x32,0x16,0x17,0x01,0x16,0x15,0x14,0x06,0x23,0x22,0x26,0x2f,0x01,0x21,0x07,0x0e,0x01,0x23,0x13,0x21,0x03,0x01,0x0c,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x93,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0xfe,0x82,0x19,0x05,0x00,0xff,0x08,0x1d,0x15,0x0a,0x15,0x1d,0x08,0x00,0xff,0x05,0x19,0x14,0x0e,0x17,0x06,0x41,0xfe,0xac,0x41,0x06,0x17,0x0e,0x8f,0x01,0x0e,0x87,0x02,0xeb,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0xfd,0x10,0x1a,0x13,0x08,0x0c,0x02,0x5a,0x12,0x17,0x17,0x12,0xfd,0xa6,0x0c,0x08,0x13,0x1a,0x0f,0x0d,0x9c,0x9c,0x0d,0x0f,0x01,0x0b,0x01,0x45,0x00,0x00,0x00,0x04,0x00,0x32,0xff,0xfb,0x02,0xb8,0x03,0x8f,0x00,0x0b,0x00,0x17,0x00,0x33,0x00,0x36,0x00,0x00,0x00,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x3e,0x01,0x35,0x34,0x26,0x23,0x22,0x06,0x15,0x14,0x16,0x33,0x00,0x26,0x35,0x34,0x37,0x01,0x3e,0x01,0x3b,0x01,0x32,0x16,0x17,0x01,0x16,0x15,0x14,0x06,0x23,0x22,0x26,0x2f,0x01,0x21,0x07,0x0e,0x01,0x23,0x13,0x21,0x03,0x01,0x4e,0x37,0x37,0x27,0x27,0x37,0x37,0x27,0x14,0x1d,0x1d,0x14,0x14,0x1d,0x1d,0x14,0xfe,0xd6,0x19,0x05,0x00,0xff,0x08,0x1d,0x15,0x0a,0x15,0x1d,0x08,0x00,0xff,0x05,0x19,0x14,0x0e,0x17,0x06,0x41,0xfe,0xac,0x41,0x06,0x17,0x0e,0x8f,0x01,0x0e,0x87,0x02,0xd3,0x37,0x27,0x27,0x37,0x37,0x27,0x27,0x37,0x2d,0x1d,0x14,0x14,0x1d,0x1d,0x14,0x14,0x1d,0xfc,0xfb,0x1a,0x13,0x08,0x0c,0x02,0x5a,0x12,0x17,0x17,0x12,0xfd,0xa6,0x0c,0x08,0x13,0x1a,0x0f,0x0d,0x9c,0x9c,0x0d,0x0f,0x01,0x0b,0x01,0x45,0x00,0x00,0x02,0x00,0x02,0xff,0xfb,0x03,0xdc,0x02,0xba,0x00,0x2a,0x00,0x2e,0x00,0x00,0x16,0x26,0x35,0x34,0x37,0x01,0x3e,0x01,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x15,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x15,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x22,0x26,0x3d,0x01,0x21,0x07,0x06,0x23,0x13,0x33,0x11,0x23,0x1d,0x1b,0x0a,0x01,0x8f,0x08,0x18,0x0e,0x01,0xe8,0x12,0x19,0x19,0x12,0xfe,0x9d,0x01,0x3f,0x12,0x19,0x19,0x12,0xfe,0xc1,0x01,0x63,0x12,0x19,0x19,0x12,0xfe,0x6f,0x13,0x1a,0xfe,0xcc,0x66,0x11,0x18,0xc5,0xfe,0x19,0x05,0x1a,0x13,0x0d,0x0f,0x02,0x5d,0x0b,0x0e,0x19,0x12,0x12,0x18,0xdd,0x19,0x12,0x12,0x18,0xde,0x19,0x12,0x12,0x18,0x1a,0x13,0x86,0x9e,0x1a,0x01,0x0b,0x01,0x5f,0x00,0x00,0x00,0x00,0x01,0x00,0x37,0xff,0x23,0x02,0x8f,0x02,0xc4,0x00,0x4d,0x00,0x00,0x24,0x16,0x15,0x14,0x07,0x0e,0x01,0x0f,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x22,0x27,0x2e,0x01,0x35,0x34,0x36,0x33,0x32,0x17,0x16,0x33,0x32,0x35,0x34,0x26,0x23,0x22,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x3f,0x01,0x2e,0x02,0x35,0x34,0x3e,0x01,0x33,0x32,0x16,0x17,0x16,0x15,0x14,0x06,0x23,0x22,0x27,0x2e,0x01,0x23,0x22,0x0e,0x01,0x15,0x14,0x1e,0x01,0x33,0x32,0x36,0x37,0x36,0x33,0x02,0x79,0x16,0x16,0x33,0x68,0x41,0x1f,0x10,0x12,0x22,0x2b,0x39,0x36,0x30,0x2a,0x04,0x07,0x0a,0x09,0x04,0x06,0x1f,0x1c,0x39,0x14,0x10,0x16,0x16,0x06,0x04,0x07,0x0b,0x04,0x30,0x5b,0x8f,0x51,0x5b,0x9f,0x64,0x44,0x6b,0x35,0x16,0x16,0x12,0x0a,0x08,0x2c,0x54,0x37,0x56,0x79,0x3d,0x3d,0x79,0x56,0x37,0x54,0x2c,0x08,0x0a,0x80,0x16,0x10,0x1a,0x0c,0x1d,0x20,0x01,0x35,0x04,0x27,0x1f,0x2e,0x2e,0x1a,0x03,0x09,0x05,0x08,0x0c,0x03,0x11,0x2e,0x0f,0x10,0x0b,0x03,0x09,0x07,0x08,0x06,0x4c,0x08,0x5b,0x9c,0x67,0x6d,0xa3,0x57,0x20,0x1e,0x0c,0x1a,0x0f,0x17,0x04,0x17,0x18,0x47,0x7b,0x4e,0x4e,0x7b,0x47,0x18,0x17,0x04,0x00,0x00,0x02,0x00,0x61,0x00,0x00,0x02,0x4a,0x03,0x7e,0x00,0x0f,0x00,0x30,0x00,0x00,0x01,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x1f,0x01,0x16,0x15,0x14,0x06,0x23,0x22,0x02,0x26,0x35,0x11,0x34,0x36,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x15,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x15,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x01,0x40,0x45,0x0a,0x14,0x11,0x17,0x0a,0x33,0x07,0x0f,0x0c,0x0d,0xce,0x1a,0x1a,0x13,0x01,0x91,0x12,0x19,0x19,0x12,0xfe,0x9d,0x01,0x3f,0x12,0x19,0x19,0x12,0xfe,0xc1,0x01,0x63,0x12,0x19,0x19,0x12,0xfe,0x6f,0x02,0xee,0x52,0x0b,0x0e,0x11,0x14,0x13,0x5a,0x0a,0x09,0x0c,0x0f,0xfd,0x1d,0x1a,0x13,0x02,0x5f,0x13,0x1b,0x19,0x12,0x12,0x18,0xdd,0x19,0x12,0x12,0x18,0xde,0x19,0x12,0x12,0x18,0x00,0x00,0x00,0x00,0x02,0x00,0x61,0x00,0x00,0x02,0x4a,0x03,0x7e,0x00,0x0f,0x00,0x30,0x00,0x00,0x00,0x26,0x35,0x34,0x3f,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x06,0x23,0x02,0x26,0x35,0x11,0x34,0x36,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x15,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x15,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x01,0x4a,0x0f,0x07,0x33,0x0a,0x17,0x10,0x15,0x0a,0x45,0x09,0x0d,0xdb,0x1a,0x1a,0x13,0x01,0x91,0x12,0x19,0x19,0x12,0xfe,0x9d,0x01,0x3f,0x12,0x19,0x19,0x12,0xfe,0xc1,0x01,0x63,0x12,0x19,0x19,0x12,0xfe,0x6f,0x02,0xe3,0x0f,0x0c,0x09,0x0a,0x5a,0x13,0x14,0x11,0x0e,0x0b,0x52,0x0b,0xfd,0x1d,0x1a,0x13,0x02,0x5f,0x13,0x1b,0x19,0x12,0x12,0x18,0xdd,0x19,0x12,0x12,0x18,0xde,0x19,0x12,0x12,0x18,0x00,0x00,0x00,0x02,0x00,0x61,0x00,0x00,0x02,0x4a,0x03,0x6d,0x00,0x18,0x00,0x39,0x00,0x00,0x12,0x26,0x37,0x34,0x3f,0x01,0x3e,0x01,0x3b,0x01,0x32,0x16,0x1f,0x01,0x16,0x15,0x16,0x06,0x23,0x22,0x2f,0x01,0x07,0x06,0x23,0x02,0x26,0x35,0x11,0x34,0x36,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x15,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x15,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0xe0,0x12,0x01,0x08,0x44,0x09,0x12,0x0d,0x26,0x0d,0x12,0x09,0x44,0x08,0x01,0x12,0x0d,0x0b,0x07,0x57,0x57,0x07,0x0b,0x72,0x1a,0x1a,0x13,0x01,0x91,0x12,0x19,0x19,0x12,0xfe,0x9d,0x01,0x3f,0x12,0x19,0x19,0x12,0xfe,0xc1,0x01,0x63,0x12,0x19,0x19,0x12,0xfe,0x6f,0x02,0xe2,0x13,0x0b,0x0b,0x08,0x46,0x0a,0x0a,0x0a,0x0a,0x46,0x08,0x0b,0x0b,0x13,0x07,0x4a,0x4a,0x07,0xfd,0x1e,0x1a,0x13,0x02,0x5f,0x13,0x1b,0x19,0x12,0x12,0x18,0xdd,0x19,0x12,0x12,0x18,0xde,0x19,0x12,0x12,0x18,0x00,0x00,0x03,0x00,0x61,0x00,0x00,0x02,0x4a,0x03,0x51,0x00,0x0b,0x00,0x17,0x00,0x38,0x00,0x00,0x12,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x32,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x00,0x26,0x35,0x11,0x34,0x36,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x15,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x15,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0xed,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x93,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0xfe,0xd1,0x1a,0x1a,0x13,0x01,0x91,0x12,0x19,0x19,0x12,0xfe,0x9d,0x01,0x3f,0x12,0x19,0x19,0x12,0xfe,0xc1,0x01,0x63,0x12,0x19,0x19,0x12,0xfe,0x6f,0x02,0xeb,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0xfd,0x15,0x1a,0x13,0x02,0x5f,0x13,0x1b,0x19,0x12,0x12,0x18,0xdd,0x19,0x12,0x12,0x18,0xde,0x19,0x12,0x12,0x18,0x00,0x02,0x00,0x2a,0xff,0xfb,0x00,0xbc,0x03,0x7e,0x00,0x0f,0x00,0x1d,0x00,0x00,0x13,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x1f,0x01,0x16,0x15,0x14,0x06,0x23,0x22,0x02,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x79,0x45,0x0a,0x14,0x11,0x17,0x0a,0x33,0x07,0x0f,0x0c,0x0d,0x07,0x1a,0x1a,0x13,0x13,0x1b,0x1b,0x13,0x02,0xee,0x52,0x0b,0x0e,0x11,0x14,0x13,0x5a,0x0a,0x09,0x0c,0x0f,0xfd,0x18,0x1a,0x13,0x02,0x69,0x13,0x1b,0x1b,0x13,0xfd,0x97,0x13,0x1a,0x00,0x00,0x00,0x00,0x02,0x00,0x61,0xff,0xfb,0x00,0xf4,0x03,0x7e,0x00,0x0f,0x00,0x1d,0x00,0x00,0x12,0x26,0x35,0x34,0x3f,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x06,0x23,0x02,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x83,0x0f,0x07,0x33,0x0a,0x17,0x10,0x15,0x0a,0x45,0x09,0x0d,0x14,0x1a,0x1a,0x13,0x13,0x1b,0x1b,0x13,0x02,0xe3,0x0f,0x0c,0x09,0x0a,0x5a,0x13,0x14,0x11,0x0e,0x0b,0x52,0x0b,0xfd,0x18,0x1a,0x13,0x02,0x69,0x13,0x1b,0x1b,0x13,0xfd,0x97,0x13,0x1a,0x00,0x00,0x00,0x02,0x00,0x07,0xff,0xfb,0x01,0x17,0x03,0x6d,0x00,0x18,0x00,0x26,0x00,0x00,0x12,0x26,0x37,0x34,0x3f,0x01,0x3e,0x01,0x3b,0x01,0x32,0x16,0x1f,0x01,0x16,0x15,0x16,0x06,0x23,0x22,0x2f,0x01,0x07,0x06,0x23,0x12,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x19,0x12,0x01,0x08,0x44,0x09,0x12,0x0d,0x26,0x0d,0x12,0x09,0x44,0x08,0x01,0x12,0x0d,0x0b,0x07,0x57,0x57,0x07,0x0b,0x55,0x1a,0x1a,0x13,0x13,0x1b,0x1b,0x13,0x02,0xe2,0x13,0x0b,0x0b,0x08,0x46,0x0a,0x0a,0x0a,0x0a,0x46,0x08,0x0b,0x0b,0x13,0x07,0x4a,0x4a,0x07,0xfd,0x19,0x1a,0x13,0x02,0x69,0x13,0x1b,0x1b,0x13,0xfd,0x97,0x13,0x1a,0x00,0x03,0x00,0x08,0xff,0xfb,0x01,0x16,0x03,0x51,0x00,0x0b,0x00,0x17,0x00,0x25,0x00,0x00,0x12,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x32,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x02,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x26,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x93,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x68,0x1a,0x1a,0x13,0x13,0x1b,0x1b,0x13,0x02,0xeb,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0xfd,0x10,0x1a,0x13,0x02,0x69,0x13,0x1b,0x1b,0x13,0xfd,0x97,0x13,0x1a,0x00,0x02,0x00,0x0f,0x00,0x00,0x02,0xbd,0x02,0xba,0x00,0x19,0x00,0x2d,0x00,0x00,0x32,0x26,0x35,0x11,0x23,0x22,0x26,0x35,0x34,0x36,0x3b,0x01,0x11,0x34,0x36,0x3b,0x01,0x32,0x1e,0x01,0x15,0x14,0x0e,0x01,0x2b,0x01,0x37,0x32,0x3e,0x01,0x35,0x34,0x2e,0x01,0x2b,0x01,0x15,0x33,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0x15,0x80,0x1a,0x36,0x0e,0x13,0x13,0x0e,0x36,0x1a,0x13,0xc9,0x72,0x9f,0x50,0x50,0x9f,0x72,0xc9,0xbe,0x52,0x7c,0x44,0x44,0x7c,0x52,0x90,0x75,0x0e,0x14,0x14,0x0e,0x75,0x1a,0x13,0x01,0x0e,0x13,0x0e,0x0e,0x14,0x01,0x0e,0x13,0x1b,0x65,0xa0,0x58,0x58,0xa0,0x65,0x55,0x43,0x77,0x4e,0x4e,0x77,0x43,0xe7,0x14,0x0e,0x0e,0x13,0xe6,0x00,0x00,0x00,0x00,0x02,0x00,0x61,0xff,0xfb,0x02,0xc2,0x03,0x5e,0x00,0x21,0x00,0x40,0x00,0x00,0x00,0x26,0x35,0x34,0x3e,0x01,0x33,0x32,0x16,0x17,0x1e,0x01,0x33,0x32,0x36,0x37,0x36,0x33,0x32,0x16,0x17,0x14,0x06,0x23,0x22,0x26,0x27,0x2e,0x01,0x23,0x22,0x07,0x06,0x23,0x02,0x26,0x35,0x11,0x34,0x36,0x3b,0x01,0x32,0x17,0x01,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x2b,0x01,0x22,0x26,0x27,0x01,0x11,0x14,0x06,0x23,0x00,0xff,0x0e,0x15,0x26,0x19,0x14,0x23,0x19,0x17,0x21,0x12,0x0f,0x11,0x05,0x08,0x11,0x0a,0x0c,0x01,0x30,0x24,0x14,0x24,0x1a,0x17,0x20,0x11,0x1a,0x0d,0x06,0x11,0x8d,0x1a,0x26,0x1b,0x0d,0x20,0x17,0x01,0x81,0x1a,0x13,0x13,0x1b,0x27,0x1b,0x0c,0x10,0x1c,0x09,0xfe,0x7d,0x1b,0x13,0x02,0xe7,0x0d,0x0a,0x15,0x2c,0x1e,0x0c,0x0c,0x0b,0x0c,0x0e,0x0d,0x15,0x0d,0x09,0x23,0x3c,0x0d,0x0c,0x0b,0x0c,0x20,0x12,0xfd,0x14,0x1a,0x13,0x02,0x55,0x1b,0x27,0x1e,0xfd,0xd4,0x02,0x1c,0x13,0x1b,0x1b,0x13,0xfd,0xab,0x1b,0x26,0x0f,0x0c,0x02,0x2f,0xfd,0xe3,0x13,0x1a,0x00,0x00,0x00,0x00,0x03,0x00,0x37,0xff,0xf6,0x02,0xf5,0x03,0x7e,0x00,0x0f,0x00,0x1f,0x00,0x2f,0x00,0x00,0x01,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x1f,0x01,0x16,0x15,0x14,0x06,0x23,0x22,0x02,0x2e,0x01,0x27,0x3e,0x02,0x33,0x32,0x1e,0x01,0x17,0x0e,0x02,0x23,0x3e,0x02,0x35,0x34,0x2e,0x01,0x23,0x22,0x0e,0x01,0x15,0x14,0x1e,0x01,0x33,0x01,0x80,0x45,0x0a,0x14,0x11,0x17,0x0a,0x33,0x07,0x0f,0x0c,0x0d,0x5c,0x9e,0x56,0x02,0x02,0x56,0x9e,0x69,0x69,0x9d,0x57,0x02,0x02,0x57,0x9d,0x69,0x50,0x76,0x3e,0x3e,0x76,0x50,0x51,0x75,0x3e,0x3e,0x75,0x51,0x02,0xee,0x52,0x0b,0x0e,0x11,0x14,0x13,0x5a,0x0a,0x09,0x0c,0x0f,0xfd,0x13,0x5c,0xa2,0x69,0x69,0xa2,0x5c,0x5c,0xa3,0x68,0x68,0xa3,0x5c,0x55,0x48,0x7c,0x4e,0x4e,0x7c,0x48,0x48,0x7c,0x4e,0x4e,0x7c,0x48,0x00,0x03,0x00,0x37,0xff,0xf6,0x02,0xf5,0x03,0x7e,0x00,0x0f,0x00,0x1f,0x00,0x2f,0x00,0x00,0x00,0x26,0x35,0x34,0x3f,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x06,0x23,0x02,0x2e,0x01,0x27,0x3e,0x02,0x33,0x32,0x1e,0x01,0x17,0x0e,0x02,0x23,0x3e,0x02,0x35,0x34,0x2e,0x01,0x23,0x22,0x0e,0x01,0x15,0x14,0x1e,0x01,0x33,0x01,0x8a,0x0f,0x07,0x33,0x0a,0x17,0x10,0x15,0x0a,0x45,0x09,0x0d,0x69,0x9e,0x56,0x02,0x02,0x56,0x9e,0x69,0x69,0x9d,0x57,0x02,0x02,0x57,0x9d,0x69,0x50,0x76,0x3e,0x3e,0x76,0x50,0x51,0x75,0x3e,0x3e,0x75,0x51,0x02,0xe3,0x0f,0x0c,0x09,0x0a,0x5a,0x13,0x14,0x11,0x0e,0x0b,0x52,0x0b,0xfd,0x13,0x5c,0xa2,0x69,0x69,0xa2,0x5c,0x5c,0xa3,0x68,0x68,0xa3,0x5c,0x55,0x48,0x7c,0x4e,0x4e,0x7c,0x48,0x48,0x7c,0x4e,0x4e,0x7c,0x48,0x00,0x00,0x00,0x00,0x03,0x00,0x37,0xff,0xf6,0x02,0xf5,0x03,0x6d,0x00,0x18,0x00,0x28,0x00,0x38,0x00,0x00,0x00,0x26,0x37,0x34,0x3f,0x01,0x3e,0x01,0x3b,0x01,0x32,0x16,0x1f,0x01,0x16,0x15,0x16,0x06,0x23,0x22,0x2f,0x01,0x07,0x06,0x23,0x10,0x2e,0x01,0x27,0x3e,0x02,0x33,0x32,0x1e,0x01,0x17,0x0e,0x02,0x23,0x3e,0x02,0x35,0x34,0x2e,0x01,0x23,0x22,0x0e,0x01,0x15,0x14,0x1e,0x01,0x33,0x01,0x20,0x12,0x01,0x08,0x44,0x09,0x12,0x0d,0x26,0x0d,0x12,0x09,0x44,0x08,0x01,0x12,0x0d,0x0b,0x07,0x57,0x57,0x07,0x0b,0x9e,0x56,0x02,0x02,0x56,0x9e,0x69,0x69,0x9d,0x57,0x02,0x02,0x57,0x9d,0x69,0x50,0x76,0x3e,0x3e,0x76,0x50,0x51,0x75,0x3e,0x3e,0x75,0x51,0x02,0xe2,0x13,0x0b,0x0b,0x08,0x46,0x0a,0x0a,0x0a,0x0a,0x46,0x08,0x0b,0x0b,0x13,0x07,0x4a,0x4a,0x07,0xfd,0x14,0x5c,0xa2,0x69,0x69,0xa2,0x5c,0x5c,0xa3,0x68,0x68,0xa3,0x5c,0x55,0x48,0x7c,0x4e,0x4e,0x7c,0x48,0x48,0x7c,0x4e,0x4e,0x7c,0x48,0x00,0x00,0x00,0x03,0x00,0x37,0xff,0xf6,0x02,0xf5,0x03,0x5e,0x00,0x21,0x00,0x31,0x00,0x41,0x00,0x00,0x00,0x26,0x35,0x34,0x3e,0x01,0x33,0x32,0x16,0x17,0x1e,0x01,0x33,0x32,0x36,0x37,0x36,0x33,0x32,0x16,0x17,0x14,0x06,0x23,0x22,0x26,0x27,0x2e,0x01,0x23,0x22,0x07,0x06,0x23,0x12,0x2e,0x01,0x27,0x3e,0x02,0x33,0x32,0x1e,0x01,0x17,0x0e,0x02,0x23,0x3e,0x02,0x35,0x34,0x2e,0x01,0x23,0x22,0x0e,0x01,0x15,0x14,0x1e,0x01,0x33,0x01,0x03,0x0e,0x15,0x26,0x19,0x14,0x23,0x19,0x17,0x21,0x12,0x0f,0x11,0x05,0x08,0x11,0x0a,0x0c,0x01,0x30,0x24,0x14,0x24,0x1a,0x17,0x20,0x11,0x1a,0x0d,0x06,0x11,0x21,0x9e,0x56,0x02,0x02,0x56,0x9e,0x69,0x69,0x9d,0x57,0x02,0x02,0x57,0x9d,0x69,0x50,0x76,0x3e,0x3e,0x76,0x50,0x51,0x75,0x3e,0x3e,0x75,0x51,0x02,0xe7,0x0d,0x0a,0x15,0x2c,0x1e,0x0c,0x0c,0x0b,0x0c,0x0e,0x0d,0x15,0x0d,0x09,0x23,0x3c,0x0d,0x0c,0x0b,0x0c,0x20,0x12,0xfd,0x0f,0x5c,0xa2,0x69,0x69,0xa2,0x5c,0x5c,0xa3,0x68,0x68,0xa3,0x5c,0x55,0x48,0x7c,0x4e,0x4e,0x7c,0x48,0x48,0x7c,0x4e,0x4e,0x7c,0x48,0x00,0x04,0x00,0x37,0xff,0xf6,0x02,0xf5,0x03,0x51,0x00,0x0b,0x00,0x17,0x00,0x27,0x00,0x37,0x00,0x00,0x00,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x32,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x02,0x2e,0x01,0x27,0x3e,0x02,0x33,0x32,0x1e,0x01,0x17,0x0e,0x02,0x23,0x3e,0x02,0x35,0x34,0x2e,0x01,0x23,0x22,0x0e,0x01,0x15,0x14,0x1e,0x01,0x33,0x01,0x2d,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x93,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0xbd,0x9e,0x56,0x02,0x02,0x56,0x9e,0x69,0x69,0x9d,0x57,0x02,0x02,0x57,0x9d,0x69,0x50,0x76,0x3e,0x3e,0x76,0x50,0x51,0x75,0x3e,0x3e,0x75,0x51,0x02,0xeb,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0xfd,0x0b,0x5c,0xa2,0x69,0x69,0xa2,0x5c,0x5c,0xa3,0x68,0x68,0xa3,0x5c,0x55,0x48,0x7c,0x4e,0x4e,0x7c,0x48,0x48,0x7c,0x4e,0x4e,0x7c,0x48,0x00,0x00,0x01,0x00,0x3b,0x00,0x24,0x01,0xf7,0x01,0xe0,0x00,0x23,0x00,0x00,0x36,0x26,0x35,0x34,0x3f,0x01,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x1f,0x01,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x17,0x16,0x15,0x14,0x06,0x23,0x22,0x2f,0x01,0x07,0x06,0x23,0x51,0x16,0x0c,0x9d,0x9d,0x0c,0x16,0x10,0x0f,0x0c,0x9d,0x9d,0x0c,0x0f,0x10,0x16,0x0c,0x9d,0x9d,0x0c,0x16,0x10,0x0f,0x0c,0x9d,0x9d,0x0c,0x0f,0x24,0x17,0x0f,0x0f,0x0c,0x9d,0x9d,0x0c,0x0f,0x0f,0x17,0x0c,0x9d,0x9d,0x0c,0x17,0x0f,0x0f,0x0c,0x9d,0x9d,0x0c,0x0f,0x0f,0x17,0x0c,0x9d,0x9d,0x0c,0x00,0x00,0x03,0x00,0x37,0xff,0xe2,0x02,0xf5,0x02,0xd7,0x00,0x23,0x00,0x2d,0x00,0x37,0x00,0x00,0x16,0x26,0x35,0x34,0x3f,0x01,0x2e,0x01,0x27,0x3e,0x02,0x33,0x32,0x17,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x1e,0x01,0x17,0x0e,0x02,0x23,0x22,0x27,0x07,0x06,0x23,0x01,0x26,0x23,0x22,0x0e,0x01,0x15,0x14,0x16,0x17,0x04,0x3e,0x01,0x35,0x34,0x26,0x27,0x01,0x16,0x33,0x93,0x0e,0x06,0x27,0x3a,0x40,0x01,0x02,0x56,0x9e,0x69,0x6a,0x52,0x28,0x07,0x0e,0x0b,0x0e,0x06,0x27,0x39,0x3f,0x02,0x02,0x57,0x9d,0x69,0x6a,0x51,0x28,0x07,0x0e,0x01,0x81,0x3c,0x4d,0x51,0x75,0x3e,0x2b,0x28,0x01,0x01,0x76,0x3e,0x2a,0x28,0xfe,0xc5,0x3b,0x4e,0x1e,0x0e,0x0a,0x08,0x09,0x37,0x30,0x92,0x59,0x69,0xa2,0x5c,0x31,0x3a,0x0a,0x0e,0x0a,0x08,0x09,0x38,0x30,0x91,0x58,0x68,0xa3,0x5c,0x2f,0x39,0x0a,0x02,0x6a,0x23,0x48,0x7c,0x4e,0x41,0x6c,0x25,0x40,0x48,0x7c,0x4e,0x3f,0x6d,0x25,0xfe,0x3f,0x22,0x00,0x00,0x02,0x00,0x5c,0xff,0xf6,0x02,0x9a,0x03,0x7e,0x00,0x0f,0x00,0x2f,0x00,0x00,0x01,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x1f,0x01,0x16,0x15,0x14,0x06,0x23,0x22,0x02,0x2e,0x01,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x1e,0x01,0x33,0x32,0x3e,0x01,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x0e,0x01,0x23,0x01,0x65,0x45,0x0a,0x14,0x11,0x17,0x0a,0x33,0x07,0x0f,0x0c,0x0d,0x3a,0x84,0x54,0x1a,0x13,0x13,0x1b,0x37,0x5a,0x33,0x33,0x5a,0x37,0x1a,0x13,0x13,0x1b,0x54,0x84,0x47,0x02,0xee,0x52,0x0b,0x0e,0x11,0x14,0x13,0x5a,0x0a,0x09,0x0c,0x0f,0xfd,0x13,0x3c,0x7b,0x59,0x01,0x8b,0x13,0x1b,0x1b,0x13,0xfe,0x72,0x3c,0x54,0x2a,0x2a,0x54,0x3c,0x01,0x8e,0x13,0x1b,0x1b,0x13,0xfe,0x75,0x59,0x7b,0x3c,0x00,0x02,0x00,0x5c,0xff,0xf6,0x02,0x9a,0x03,0x7e,0x00,0x0f,0x00,0x2f,0x00,0x00,0x00,0x26,0x35,0x34,0x3f,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x06,0x23,0x02,0x2e,0x01,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x1e,0x01,0x33,0x32,0x3e,0x01,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x0e,0x01,0x23,0x01,0x6f,0x0f,0x07,0x33,0x0a,0x17,0x10,0x15,0x0a,0x45,0x09,0x0d,0x47,0x84,0x54,0x1a,0x13,0x13,0x1b,0x37,0x5a,0x33,0x33,0x5a,0x37,0x1a,0x13,0x13,0x1b,0x54,0x84,0x47,0x02,0xe3,0x0f,0x0c,0x09,0x0a,0x5a,0x13,0x14,0x11,0x0e,0x0b,0x52,0x0b,0xfd,0x13,0x3c,0x7b,0x59,0x01,0x8b,0x13,0x1b,0x1b,0x13,0xfe,0x72,0x3c,0x54,0x2a,0x2a,0x54,0x3c,0x01,0x8e,0x13,0x1b,0x1b,0x13,0xfe,0x75,0x59,0x7b,0x3c,0x00,0x00,0x00,0x00,0x02,0x00,0x5c,0xff,0xf6,0x02,0x9a,0x03,0x6d,0x00,0x18,0x00,0x38,0x00,0x00,0x00,0x26,0x37,0x34,0x3f,0x01,0x3e,0x01,0x3b,0x01,0x32,0x16,0x1f,0x01,0x16,0x15,0x16,0x06,0x23,0x22,0x2f,0x01,0x07,0x06,0x23,0x12,0x2e,0x01,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x1e,0x01,0x33,0x32,0x3e,0x01,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x0e,0x01,0x23,0x01,0x05,0x12,0x01,0x08,0x44,0x09,0x12,0x0d,0x26,0x0d,0x12,0x09,0x44,0x08,0x01,0x12,0x0d,0x0b,0x07,0x57,0x57,0x07,0x0b,0x22,0x84,0x54,0x1a,0x13,0x13,0x1b,0x37,0x5a,0x33,0x33,0x5a,0x37,0x1a,0x13,0x13,0x1b,0x54,0x84,0x47,0x02,0xe2,0x13,0x0b,0x0b,0x08,0x46,0x0a,0x0a,0x0a,0x0a,0x46,0x08,0x0b,0x0b,0x13,0x07,0x4a,0x4a,0x07,0xfd,0x14,0x3c,0x7b,0x59,0x01,0x8b,0x13,0x1b,0x1b,0x13,0xfe,0x72,0x3c,0x54,0x2a,0x2a,0x54,0x3c,0x01,0x8e,0x13,0x1b,0x1b,0x13,0xfe,0x75,0x59,0x7b,0x3c,0x00,0x00,0x03,0x00,0x5c,0xff,0xf6,0x02,0x9a,0x03,0x51,0x00,0x0b,0x00,0x17,0x00,0x37,0x00,0x00,0x00,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x32,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x02,0x2e,0x01,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x1e,0x01,0x33,0x32,0x3e,0x01,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x0e,0x01,0x23,0x01,0x12,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x93,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x9b,0x84,0x54,0x1a,0x13,0x13,0x1b,0x37,0x5a,0x33,0x33,0x5a,0x37,0x1a,0x13,0x13,0x1b,0x54,0x84,0x47,0x02,0xeb,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0xfd,0x0b,0x3c,0x7b,0x59,0x01,0x8b,0x13,0x1b,0x1b,0x13,0xfe,0x72,0x3c,0x54,0x2a,0x2a,0x54,0x3c,0x01,0x8e,0x13,0x1b,0x1b,0x13,0xfe,0x75,0x59,0x7b,0x3c,0x00,0x00,0x02,0x00,0x1b,0xff,0xfb,0x02,0x66,0x03,0x7e,0x00,0x0f,0x00,0x29,0x00,0x00,0x00,0x26,0x35,0x34,0x3f,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x06,0x23,0x02,0x26,0x35,0x11,0x03,0x26,0x35,0x34,0x36,0x33,0x32,0x17,0x1b,0x01,0x36,0x33,0x32,0x16,0x07,0x14,0x07,0x03,0x15,0x14,0x06,0x23,0x01,0x34,0x0f,0x07,0x33,0x0a,0x17,0x10,0x15,0x0a,0x45,0x09,0x0d,0x13,0x1b,0xef,0x08,0x19,0x13,0x19,0x0f,0xd1,0xd1,0x0f,0x19,0x13,0x1a,0x01,0x08,0xf0,0x1a,0x13,0x02,0xe3,0x0f,0x0c,0x09,0x0a,0x5a,0x13,0x14,0x11,0x0e,0x0b,0x52,0x0b,0xfd,0x18,0x1a,0x13,0x00,0xff,0x01,0x4f,0x0d,0x0e,0x13,0x1b,0x17,0xfe,0xd0,0x01,0x30,0x17,0x1b,0x13,0x0e,0x0d,0xfe,0xb1,0xff,0x13,0x1a,0x00,0x00,0x02,0x00,0x61,0xff,0xfb,0x02,0x7d,0x02,0xbf,0x00,0x18,0x00,0x21,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x1d,0x01,0x33,0x32,0x1e,0x01,0x15,0x14,0x0e,0x01,0x2b,0x01,0x15,0x14,0x06,0x23,0x37,0x32,0x36,0x35,0x34,0x26,0x2b,0x01,0x11,0x7b,0x1a,0x1a,0x13,0x13,0x1b,0xb6,0x5f,0x78,0x34,0x34,0x78,0x5f,0xb6,0x1b,0x13,0xdb,0x66,0x53,0x53,0x66,0xad,0x05,0x1a,0x13,0x02,0x69,0x13,0x1b,0x1b,0x13,0x47,0x40,0x64,0x3a,0x3a,0x64,0x40,0x66,0x13,0x1a,0xe9,0x4e,0x3a,0x3a,0x4e,0xfe,0xf0,0x00,0x00,0x00,0x01,0x00,0x4f,0xff,0xf6,0x02,0x33,0x02,0xc4,0x00,0x37,0x00,0x00,0x04,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x17,0x16,0x33,0x32,0x36,0x35,0x34,0x26,0x23,0x22,0x26,0x35,0x34,0x36,0x37,0x3e,0x01,0x35,0x34,0x26,0x23,0x22,0x06,0x15,0x11,0x14,0x06,0x23,0x22,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x1e,0x01,0x15,0x14,0x07,0x1e,0x01,0x15,0x14,0x0e,0x01,0x23,0x01,0x37,0x31,0x20,0x16,0x11,0x08,0x07,0x1e,0x2c,0x28,0x4a,0x61,0x4b,0x12,0x14,0x15,0x11,0x3d,0x48,0x45,0x3c,0x3a,0x4c,0x1b,0x13,0x13,0x1a,0x7c,0x66,0x36,0x65,0x40,0x6e,0x3c,0x59,0x36,0x56,0x32,0x0a,0x11,0x0b,0x1b,0x11,0x16,0x03,0x0a,0x34,0x3e,0x39,0x43,0x14,0x11,0x0f,0x14,0x02,0x07,0x40,0x30,0x38,0x41,0x43,0x51,0xfe,0x4e,0x13,0x1a,0x1a,0x13,0x01,0xbd,0x69,0x75,0x2b,0x59,0x40,0x7d,0x23,0x0e,0x55,0x4f,0x3c,0x53,0x29,0x00,0x00,0xff,0xff,0x00,0x2e,0xff,0xf6,0x01,0xe8,0x02,0xd2,0x10,0x22,0x00,0x45,0x00,0x00,0x10,0x03,0x00,0xc3,0x01,0xdf,0x00,0x00,0xff,0xff,0x00,0x2e,0xff,0xf6,0x01,0xe8,0x02,0xd2,0x10,0x22,0x00,0x45,0x00,0x00,0x10,0x03,0x00,0xc4,0x01,0xdf,0x00,0x00,0xff,0xff,0x00,0x2e,0xff,0xf6,0x01,0xe8,0x02,0xc1,0x10,0x22,0x00,0x45,0x00,0x00,0x10,0x03,0x00,0xc5,0x01,0xdf,0x00,0x00,0xff,0xff,0x00,0x2e,0xff,0xf6,0x01,0xe8,0x02,0xb2,0x10,0x22,0x00,0x45,0x00,0x00,0x10,0x03,0x00,0xc6,0x01,0xdf,0x00,0x00,0xff,0xff,0x00,0x2e,0xff,0xf6,0x01,0xe8,0x02,0xa5,0x10,0x22,0x00,0x45,0x00,0x00,0x10,0x03,0x00,0xca,0x01,0xdf,0x00,0x00,0xff,0xff,0x00,0x2e,0xff,0xf6,0x01,0xe8,0x02,0xe3,0x10,0x22,0x00,0x45,0x00,0x00,0x10,0x03,0x00,0xcc,0x01,0xdf,0x00,0x00,0x00,0x03,0x00,0x2e,0xff,0xf6,0x03,0x66,0x02,0x08,0x00,0x3a,0x00,0x43,0x00,0x4e,0x00,0x00,0x16,0x2e,0x01,0x35,0x34,0x36,0x3b,0x01,0x35,0x34,0x26,0x23,0x22,0x06,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x37,0x36,0x33,0x32,0x16,0x17,0x36,0x33,0x32,0x1e,0x01,0x15,0x14,0x06,0x23,0x21,0x1e,0x01,0x33,0x32,0x36,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x0e,0x01,0x23,0x22,0x26,0x27,0x0e,0x01,0x23,0x01,0x2e,0x02,0x23,0x22,0x0e,0x01,0x07,0x06,0x36,0x3d,0x01,0x23,0x22,0x06,0x15,0x14,0x16,0x33,0xbc,0x59,0x35,0x75,0x71,0x79,0x41,0x45,0x26,0x3b,0x24,0x08,0x05,0x0f,0x16,0x1a,0x55,0x58,0x3e,0x55,0x18,0x3f,0x76,0x49,0x6c,0x3a,0x18,0x14,0xfe,0xa8,0x08,0x56,0x53,0x2a,0x3f,0x1e,0x08,0x0a,0x10,0x18,0x1a,0x27,0x4c,0x3c,0x44,0x66,0x21,0x20,0x6f,0x3f,0x02,0x1a,0x03,0x2d,0x42,0x23,0x23,0x42,0x2d,0x03,0xa5,0x50,0x6d,0x4a,0x4d,0x41,0x3a,0x0a,0x24,0x44,0x2e,0x49,0x56,0x0b,0x42,0x3a,0x0c,0x0c,0x02,0x16,0x10,0x1b,0x0b,0x24,0x2d,0x27,0x54,0x41,0x72,0x48,0x11,0x1a,0x47,0x50,0x10,0x0f,0x04,0x16,0x11,0x16,0x0f,0x16,0x16,0x2d,0x2a,0x31,0x26,0x01,0x35,0x31,0x41,0x1e,0x1e,0x41,0x31,0xe5,0x2c,0x37,0x39,0x23,0x29,0x22,0x2e,0x00,0x00,0x01,0x00,0x30,0xff,0x23,0x01,0xf2,0x02,0x08,0x00,0x4b,0x00,0x00,0x24,0x16,0x15,0x14,0x07,0x0e,0x01,0x23,0x07,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x22,0x27,0x2e,0x01,0x35,0x34,0x36,0x33,0x32,0x17,0x16,0x33,0x32,0x35,0x34,0x26,0x23,0x22,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x3f,0x01,0x2e,0x02,0x35,0x34,0x3e,0x01,0x33,0x32,0x16,0x17,0x16,0x15,0x14,0x06,0x23,0x22,0x27,0x2e,0x01,0x23,0x22,0x06,0x15,0x14,0x16,0x33,0x32,0x36,0x37,0x36,0x33,0x01,0xdb,0x17,0x14,0x21,0x4d,0x35,0x1e,0x10,0x12,0x22,0x2b,0x39,0x36,0x30,0x2a,0x04,0x07,0x0a,0x09,0x04,0x06,0x1f,0x1c,0x39,0x14,0x10,0x16,0x16,0x06,0x04,0x07,0x0b,0x04,0x31,0x3f,0x67,0x3c,0x49,0x7a,0x48,0x35,0x4d,0x21,0x14,0x17,0x0f,0x0b,0x0b,0x21,0x2f,0x23,0x56,0x62,0x62,0x56,0x23,0x2f,0x21,0x0b,0x0b,0x71,0x19,0x0f,0x16,0x0d,0x15,0x1b,0x35,0x04,0x27,0x1f,0x2e,0x2e,0x1a,0x03,0x09,0x05,0x08,0x0c,0x03,0x11,0x2e,0x0f,0x10,0x0b,0x03,0x09,0x07,0x08,0x06,0x4e,0x09,0x43,0x71,0x49,0x51,0x78,0x40,0x1b,0x15,0x0d,0x16,0x0f,0x19,0x06,0x11,0x0f,0x63,0x51,0x51,0x63,0x0f,0x11,0x06,0xff,0xff,0x00,0x30,0xff,0xf6,0x02,0x0d,0x02,0xd2,0x10,0x22,0x00,0x49,0x00,0x00,0x10,0x03,0x00,0xc3,0x01,0xe5,0x00,0x00,0xff,0xff,0x00,0x30,0xff,0xf6,0x02,0x0d,0x02,0xd2,0x10,0x22,0x00,0x49,0x00,0x00,0x10,0x03,0x00,0xc4,0x01,0xe5,0x00,0x00,0xff,0xff,0x00,0x30,0xff,0xf6,0x02,0x0d,0x02,0xc1,0x10,0x22,0x00,0x49,0x00,0x00,0x10,0x03,0x00,0xc5,0x01,0xe5,0x00,0x00,0xff,0xff,0x00,0x30,0xff,0xf6,0x02,0x0d,0x02,0xa5,0x10,0x22,0x00,0x49,0x00,0x00,0x10,0x03,0x00,0xca,0x01,0xe5,0x00,0x00,0x00,0x02,0x00,0x18,0xff,0xfb,0x00,0xaa,0x02,0xd2,0x00,0x0d,0x00,0x1d,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x03,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x1f,0x01,0x16,0x15,0x14,0x06,0x23,0x22,0x69,0x1a,0x1a,0x13,0x14,0x1a,0x1b,0x13,0x15,0x45,0x0a,0x14,0x11,0x17,0x0a,0x33,0x07,0x0f,0x0c,0x0d,0x05,0x1a,0x13,0x01,0xad,0x13,0x1b,0x1a,0x14,0xfe,0x53,0x13,0x1a,0x02,0x47,0x52,0x0b,0x0e,0x11,0x14,0x13,0x5a,0x0a,0x09,0x0c,0x0f,0x00,0x02,0x00,0x4f,0xff,0xfb,0x00,0xe2,0x02,0xd2,0x00,0x0d,0x00,0x1d,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x02,0x26,0x35,0x34,0x3f,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x06,0x23,0x69,0x1a,0x1a,0x13,0x14,0x1a,0x1b,0x13,0x0b,0x0f,0x07,0x33,0x0a,0x17,0x10,0x15,0x0a,0x45,0x09,0x0d,0x05,0x1a,0x13,0x01,0xad,0x13,0x1b,0x1a,0x14,0xfe,0x53,0x13,0x1a,0x02,0x3c,0x0f,0x0c,0x09,0x0a,0x5a,0x13,0x14,0x11,0x0e,0x0b,0x52,0x0b,0x00,0x00,0x00,0x00,0x02,0xff,0xf5,0xff,0xfb,0x01,0x05,0x02,0xc1,0x00,0x0d,0x00,0x26,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x02,0x26,0x37,0x34,0x3f,0x01,0x3e,0x01,0x3b,0x01,0x32,0x16,0x1f,0x01,0x16,0x15,0x16,0x06,0x23,0x22,0x2f,0x01,0x07,0x06,0x23,0x69,0x1a,0x1a,0x13,0x14,0x1a,0x1b,0x13,0x75,0x12,0x01,0x08,0x44,0x09,0x12,0x0d,0x26,0x0d,0x12,0x09,0x44,0x08,0x01,0x12,0x0d,0x0b,0x07,0x57,0x57,0x07,0x0b,0x05,0x1a,0x13,0x01,0xad,0x13,0x1b,0x1a,0x14,0xfe,0x53,0x13,0x1a,0x02,0x3b,0x13,0x0b,0x0b,0x08,0x46,0x0a,0x0a,0x0a,0x0a,0x46,0x08,0x0b,0x0b,0x13,0x07,0x4a,0x4a,0x07,0x00,0x00,0x03,0xff,0xf6,0xff,0xfb,0x01,0x04,0x02,0xa5,0x00,0x0d,0x00,0x19,0x00,0x25,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x15,0x11,0x14,0x06,0x23,0x02,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x32,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x69,0x1a,0x1a,0x13,0x14,0x1a,0x1b,0x13,0x68,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x93,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x05,0x1a,0x13,0x01,0xad,0x13,0x1b,0x1a,0x14,0xfe,0x53,0x13,0x1a,0x02,0x44,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x00,0x00,0x02,0x00,0x30,0xff,0xf6,0x02,0x21,0x02,0xf0,0x00,0x2f,0x00,0x3f,0x00,0x00,0x16,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x32,0x17,0x26,0x27,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x3f,0x01,0x26,0x27,0x2e,0x01,0x35,0x34,0x36,0x33,0x32,0x17,0x16,0x17,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x1e,0x01,0x15,0x14,0x06,0x23,0x3e,0x02,0x35,0x34,0x2e,0x01,0x23,0x22,0x0e,0x01,0x15,0x14,0x1e,0x01,0x33,0xde,0x71,0x3d,0x38,0x6a,0x48,0x3b,0x36,0x29,0x42,0x54,0x0a,0x07,0x0a,0x0f,0x0f,0x44,0x32,0x1a,0x09,0x0b,0x19,0x11,0x0b,0x0b,0x3c,0x30,0x44,0x08,0x07,0x0b,0x0e,0x0c,0x38,0x51,0x67,0x7a,0x7f,0x28,0x4a,0x2f,0x2f,0x4a,0x28,0x28,0x49,0x2f,0x2f,0x49,0x28,0x0a,0x41,0x75,0x4c,0x44,0x76,0x47,0x1c,0x3d,0x38,0x31,0x06,0x0f,0x0a,0x0f,0x08,0x28,0x22,0x0e,0x04,0x14,0x0b,0x12,0x18,0x06,0x25,0x26,0x29,0x05,0x0e,0x0b,0x0e,0x08,0x21,0x49,0xb6,0x6c,0x7d,0x9f,0x50,0x26,0x52,0x3e,0x3d,0x51,0x25,0x25,0x51,0x3d,0x3e,0x52,0x26,0x00,0x00,0x00,0xff,0xff,0x00,0x4f,0xff,0xfb,0x02,0x17,0x02,0xb2,0x10,0x22,0x00,0x52,0x00,0x00,0x10,0x03,0x00,0xc6,0x01,0xf9,0x00,0x00,0xff,0xff,0x00,0x30,0xff,0xf6,0x02,0x30,0x02,0xd2,0x10,0x22,0x00,0x53,0x00,0x00,0x10,0x03,0x00,0xc3,0x01,0xf8,0x00,0x00,0xff,0xff,0x00,0x30,0xff,0xf6,0x02,0x30,0x02,0xd2,0x10,0x22,0x00,0x53,0x00,0x00,0x10,0x03,0x00,0xc4,0x01,0xf8,0x00,0x00,0xff,0xff,0x00,0x30,0xff,0xf6,0x02,0x30,0x02,0xc1,0x10,0x22,0x00,0x53,0x00,0x00,0x10,0x03,0x00,0xc5,0x01,0xf8,0x00,0x00,0xff,0xff,0x00,0x30,0xff,0xf6,0x02,0x30,0x02,0xb2,0x10,0x22,0x00,0x53,0x00,0x00,0x10,0x03,0x00,0xc6,0x01,0xf8,0x00,0x00,0xff,0xff,0x00,0x30,0xff,0xf6,0x02,0x30,0x02,0xa5,0x10,0x22,0x00,0x53,0x00,0x00,0x10,0x03,0x00,0xca,0x01,0xf8,0x00,0x00,0x00,0x03,0x00,0x49,0x00,0x5f,0x02,0x7f,0x02,0x37,0x00,0x0b,0x00,0x19,0x00,0x25,0x00,0x00,0x00,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x04,0x26,0x35,0x34,0x36,0x33,0x21,0x32,0x16,0x15,0x14,0x06,0x23,0x21,0x16,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x01,0x4f,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0xfe,0xfc,0x17,0x17,0x11,0x01,0xe5,0x11,0x18,0x18,0x11,0xfe,0x1b,0xde,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x01,0xd1,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0xae,0x17,0x11,0x11,0x18,0x18,0x11,0x11,0x17,0xc4,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x00,0x00,0x00,0x03,0x00,0x30,0xff,0xe1,0x02,0x30,0x02,0x1b,0x00,0x23,0x00,0x2c,0x00,0x35,0x00,0x00,0x16,0x26,0x35,0x34,0x3f,0x01,0x2e,0x01,0x35,0x34,0x3e,0x01,0x33,0x32,0x17,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x1e,0x01,0x15,0x14,0x0e,0x01,0x23,0x22,0x27,0x07,0x06,0x23,0x01,0x26,0x23,0x22,0x0e,0x01,0x15,0x14,0x17,0x16,0x3e,0x01,0x35,0x34,0x27,0x03,0x16,0x33,0x6d,0x0e,0x06,0x1d,0x27,0x2b,0x3f,0x74,0x4d,0x47,0x3d,0x1d,0x07,0x0e,0x0b,0x0e,0x06,0x1c,0x28,0x2b,0x40,0x74,0x4c,0x4b,0x3a,0x1e,0x07,0x0e,0x01,0x0a,0x27,0x2b,0x2a,0x4b,0x30,0x2b,0xa3,0x4b,0x31,0x2b,0xcc,0x24,0x2e,0x1f,0x0e,0x0a,0x08,0x09,0x29,0x24,0x68,0x40,0x4e,0x79,0x42,0x20,0x29,0x0a,0x0e,0x0a,0x08,0x09,0x28,0x23,0x68,0x40,0x4e,0x79,0x42,0x20,0x2b,0x0a,0x01,0xbf,0x15,0x25,0x52,0x3e,0x53,0x30,0x34,0x26,0x52,0x3f,0x4f,0x32,0xfe,0xdd,0x15,0x00,0x00,0x00,0xff,0xff,0x00,0x4a,0xff,0xf6,0x02,0x12,0x02,0xd2,0x10,0x22,0x00,0x59,0x00,0x00,0x10,0x03,0x00,0xc3,0x01,0xf9,0x00,0x00,0xff,0xff,0x00,0x4a,0xff,0xf6,0x02,0x12,0x02,0xd2,0x10,0x22,0x00,0x59,0x00,0x00,0x10,0x03,0x00,0xc4,0x01,0xf9,0x00,0x00,0xff,0xff,0x00,0x4a,0xff,0xf6,0x02,0x12,0x02,0xc1,0x10,0x22,0x00,0x59,0x00,0x00,0x10,0x03,0x00,0xc5,0x01,0xf9,0x00,0x00,0xff,0xff,0x00,0x4a,0xff,0xf6,0x02,0x12,0x02,0xa5,0x10,0x22,0x00,0x59,0x00,0x00,0x10,0x03,0x00,0xca,0x01,0xf9,0x00,0x00,0xff,0xff,0x00,0x1a,0xff,0x15,0x01,0xff,0x02,0xd2,0x10,0x22,0x00,0x5d,0x00,0x00,0x10,0x03,0x00,0xc4,0x01,0xd5,0x00,0x00,0x00,0x02,0x00,0x4f,0xff,0x15,0x02,0x47,0x02,0xdf,0x00,0x1a,0x00,0x27,0x00,0x00,0x16,0x26,0x35,0x11,0x34,0x36,0x33,0x32,0x16,0x1d,0x01,0x36,0x33,0x32,0x1e,0x01,0x15,0x14,0x0e,0x01,0x23,0x22,0x27,0x15,0x14,0x06,0x23,0x00,0x36,0x35,0x34,0x26,0x23,0x22,0x06,0x07,0x15,0x1e,0x01,0x33,0x69,0x1a,0x1a,0x13,0x14,0x1a,0x49,0x62,0x3e,0x6f,0x45,0x45,0x6f,0x3e,0x62,0x49,0x1a,0x14,0x01,0x16,0x5a,0x5a,0x4a,0x2e,0x51,0x1f,0x1f,0x51,0x2e,0xeb,0x1b,0x13,0x03,0x6e,0x13,0x1b,0x1a,0x14,0xf5,0x4c,0x3f,0x79,0x51,0x51,0x79,0x3f,0x4c,0xff,0x14,0x1a,0x01,0x36,0x5e,0x56,0x56,0x5e,0x29,0x22,0xd2,0x22,0x29,0x00,0x00,0x00,0xff,0xff,0x00,0x1a,0xff,0x15,0x01,0xff,0x02,0xa5,0x10,0x22,0x00,0x5d,0x00,0x00,0x10,0x03,0x00,0xca,0x01,0xd5,0x00,0x00,0x00,0x01,0xfe,0xd3,0x02,0x37,0xff,0x53,0x02,0xd2,0x00,0x0f,0x00,0x00,0x02,0x2f,0x01,0x26,0x35,0x34,0x36,0x33,0x32,0x1f,0x01,0x16,0x15,0x14,0x06,0x23,0xd5,0x09,0x45,0x0a,0x14,0x11,0x17,0x0a,0x33,0x07,0x0f,0x0c,0x02,0x37,0x0b,0x52,0x0b,0x0e,0x11,0x14,0x13,0x5a,0x0a,0x09,0x0c,0x0f,0x00,0x01,0xff,0x1d,0x02,0x37,0xff,0x9d,0x02,0xd2,0x00,0x0f,0x00,0x00,0x02,0x26,0x35,0x34,0x3f,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x06,0x23,0xd4,0x0f,0x07,0x33,0x0a,0x17,0x10,0x15,0x0a,0x45,0x09,0x0d,0x02,0x37,0x0f,0x0c,0x09,0x0a,0x5a,0x13,0x14,0x11,0x0e,0x0b,0x52,0x0b,0x00,0x01,0xfe,0xb0,0x02,0x36,0xff,0xc0,0x02,0xc1,0x00,0x18,0x00,0x00,0x00,0x26,0x37,0x34,0x3f,0x01,0x3e,0x01,0x3b,0x01,0x32,0x16,0x1f,0x01,0x16,0x15,0x16,0x06,0x23,0x22,0x2f,0x01,0x07,0x06,0x23,0xfe,0xc2,0x12,0x01,0x08,0x44,0x09,0x12,0x0d,0x26,0x0d,0x12,0x09,0x44,0x08,0x01,0x12,0x0d,0x0b,0x07,0x57,0x57,0x07,0x0b,0x02,0x36,0x13,0x0b,0x0b,0x08,0x46,0x0a,0x0a,0x0a,0x0a,0x46,0x08,0x0b,0x0b,0x13,0x07,0x4a,0x4a,0x07,0x00,0x00,0x01,0xfe,0x97,0x02,0x3b,0xff,0xda,0x02,0xb2,0x00,0x21,0x00,0x00,0x00,0x26,0x35,0x34,0x3e,0x01,0x33,0x32,0x16,0x17,0x1e,0x01,0x33,0x32,0x36,0x37,0x36,0x33,0x32,0x16,0x17,0x14,0x06,0x23,0x22,0x26,0x27,0x2e,0x01,0x23,0x22,0x07,0x06,0x23,0xfe,0xa5,0x0e,0x15,0x26,0x19,0x14,0x23,0x19,0x17,0x21,0x12,0x0f,0x11,0x05,0x08,0x11,0x0a,0x0c,0x01,0x30,0x24,0x14,0x24,0x1a,0x17,0x20,0x11,0x1a,0x0d,0x06,0x11,0x02,0x3b,0x0d,0x0a,0x15,0x2c,0x1e,0x0c,0x0c,0x0b,0x0c,0x0e,0x0d,0x15,0x0d,0x09,0x23,0x3c,0x0d,0x0c,0x0b,0x0c,0x20,0x12,0x00,0x01,0xfe,0xa5,0x02,0x4c,0xff,0xcb,0x02,0x88,0x00,0x0d,0x00,0x00,0x00,0x26,0x35,0x34,0x36,0x3b,0x01,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0xfe,0xb6,0x11,0x11,0x0d,0xea,0x0d,0x11,0x11,0x0d,0xea,0x02,0x4c,0x11,0x0d,0x0d,0x11,0x11,0x0d,0x0d,0x11,0x00,0x00,0x00,0x00,0x01,0xfe,0xa9,0x02,0x40,0xff,0xc7,0x02,0xbe,0x00,0x19,0x00,0x00,0x02,0x26,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x17,0x1e,0x01,0x33,0x32,0x36,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x0e,0x01,0x23,0xf8,0x4b,0x11,0x03,0x11,0x0e,0x13,0x09,0x0b,0x2c,0x1d,0x1d,0x2c,0x0b,0x09,0x13,0x0e,0x11,0x03,0x11,0x4b,0x30,0x02,0x40,0x2b,0x26,0x06,0x08,0x0d,0x12,0x13,0x17,0x1a,0x1a,0x17,0x13,0x12,0x0d,0x08,0x06,0x26,0x2b,0x00,0x00,0x00,0x01,0xff,0x05,0x02,0x3f,0xff,0x6b,0x02,0xa5,0x00,0x0b,0x00,0x00,0x02,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0xdd,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x02,0x3f,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x00,0x02,0xfe,0xb1,0x02,0x3f,0xff,0xbf,0x02,0xa5,0x00,0x0b,0x00,0x17,0x00,0x00,0x00,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x32,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0xfe,0xcf,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x93,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x02,0x3f,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x00,0x00,0x01,0xfe,0xe5,0x02,0x36,0xff,0x90,0x02,0xe6,0x00,0x20,0x00,0x00,0x02,0x26,0x35,0x34,0x36,0x37,0x3e,0x01,0x35,0x34,0x23,0x22,0x06,0x23,0x22,0x26,0x35,0x34,0x37,0x3e,0x01,0x33,0x32,0x16,0x15,0x14,0x06,0x07,0x0e,0x01,0x07,0x06,0x23,0xd8,0x0e,0x15,0x12,0x0f,0x0c,0x1f,0x19,0x26,0x04,0x09,0x0c,0x0b,0x10,0x29,0x14,0x28,0x2b,0x13,0x14,0x0c,0x0f,0x04,0x06,0x13,0x02,0x36,0x0c,0x0c,0x11,0x18,0x0d,0x0c,0x0c,0x08,0x13,0x0f,0x0d,0x08,0x0e,0x07,0x0a,0x0a,0x21,0x20,0x16,0x1a,0x0f,0x08,0x0f,0x0a,0x0f,0x00,0x00,0x02,0xfe,0xda,0x02,0x27,0xff,0x96,0x02,0xe3,0x00,0x0b,0x00,0x17,0x00,0x00,0x02,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x3e,0x01,0x35,0x34,0x26,0x23,0x22,0x06,0x15,0x14,0x16,0x33,0xef,0x37,0x37,0x27,0x27,0x37,0x37,0x27,0x14,0x1d,0x1d,0x14,0x14,0x1d,0x1d,0x14,0x02,0x27,0x37,0x27,0x27,0x37,0x37,0x27,0x27,0x37,0x2d,0x1d,0x14,0x14,0x1d,0x1d,0x14,0x14,0x1d,0x00,0x00,0x02,0xfe,0xe2,0x02,0x37,0xff,0xbb,0x02,0xd1,0x00,0x10,0x00,0x21,0x00,0x00,0x00,0x26,0x35,0x34,0x3f,0x01,0x3e,0x01,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x06,0x23,0x32,0x26,0x35,0x34,0x3f,0x01,0x3e,0x01,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x06,0x23,0xfe,0xf2,0x10,0x01,0x1b,0x04,0x16,0x0c,0x0e,0x15,0x07,0x29,0x09,0x11,0x69,0x10,0x01,0x1b,0x04,0x16,0x0c,0x0e,0x15,0x07,0x29,0x09,0x11,0x02,0x37,0x0e,0x0b,0x05,0x03,0x5a,0x0f,0x10,0x12,0x0f,0x0c,0x0d,0x4f,0x11,0x0e,0x0b,0x05,0x03,0x5a,0x0f,0x10,0x12,0x0f,0x0c,0x0d,0x4f,0x11,0x00,0x00,0x00,0x00,0x01,0xfe,0xb0,0x02,0x37,0xff,0xc0,0x02,0xc2,0x00,0x18,0x00,0x00,0x02,0x26,0x2f,0x01,0x26,0x35,0x26,0x36,0x33,0x32,0x1f,0x01,0x37,0x36,0x33,0x32,0x16,0x07,0x14,0x0f,0x01,0x0e,0x01,0x2b,0x01,0xe8,0x12,0x09,0x44,0x08,0x01,0x12,0x0d,0x0b,0x07,0x57,0x57,0x07,0x0b,0x0d,0x12,0x01,0x08,0x44,0x09,0x12,0x0d,0x26,0x02,0x37,0x0a,0x0a,0x46,0x08,0x0b,0x0b,0x13,0x07,0x4a,0x4a,0x07,0x13,0x0b,0x0b,0x08,0x46,0x0a,0x0a,0x00,0x00,0x00,0x02,0xfe,0xd0,0x02,0x37,0xff,0xea,0x02,0xd2,0x00,0x0f,0x00,0x1f,0x00,0x00,0x00,0x26,0x35,0x34,0x3f,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x06,0x23,0x32,0x26,0x35,0x34,0x3f,0x01,0x36,0x33,0x32,0x16,0x15,0x14,0x0f,0x01,0x06,0x23,0xfe,0xdf,0x0f,0x07,0x33,0x0a,0x17,0x10,0x15,0x0a,0x45,0x09,0x0d,0x8e,0x0f,0x07,0x33,0x0a,0x17,0x10,0x15,0x0a,0x45,0x09,0x0d,0x02,0x37,0x0f,0x0c,0x09,0x0a,0x5a,0x13,0x14,0x11,0x0e,0x0b,0x52,0x0b,0x0f,0x0c,0x09,0x0a,0x5a,0x13,0x14,0x11,0x0e,0x0b,0x52,0x0b,0x00,0x00,0x01,0xfe,0xa9,0x02,0x37,0xff,0xc7,0x02,0xb5,0x00,0x19,0x00,0x00,0x00,0x26,0x35,0x34,0x37,0x3e,0x01,0x33,0x32,0x16,0x17,0x16,0x15,0x14,0x06,0x23,0x22,0x27,0x2e,0x01,0x23,0x22,0x06,0x07,0x06,0x23,0xfe,0xba,0x11,0x03,0x13,0x4a,0x2f,0x2f,0x4a,0x13,0x03,0x11,0x0e,0x13,0x09,0x0b,0x2c,0x1d,0x1d,0x2c,0x0b,0x09,0x13,0x02,0x37,0x12,0x0d,0x08,0x06,0x25,0x2c,0x2c,0x25,0x06,0x08,0x0d,0x12,0x13,0x17,0x1a,0x1a,0x17,0x13,0x00,0x00,0x01,0xff,0x04,0x02,0x3f,0xff,0x6e,0x03,0x06,0x00,0x16,0x00,0x00,0x02,0x26,0x3d,0x01,0x34,0x36,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x0e,0x01,0x15,0x32,0x16,0x15,0x14,0x06,0x23,0xe0,0x1c,0x26,0x1e,0x08,0x08,0x09,0x0d,0x0c,0x15,0x16,0x16,0x1b,0x1d,0x15,0x02,0x3f,0x1e,0x17,0x21,0x27,0x33,0x12,0x05,0x0d,0x0a,0x0d,0x08,0x0d,0x19,0x12,0x1b,0x15,0x15,0x1e,0x00,0x01,0xff,0x38,0x01,0xb6,0x00,0x01,0x02,0x99,0x00,0x13,0x00,0x00,0x02,0x27,0x35,0x33,0x32,0x36,0x35,0x34,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0xa4,0x24,0x31,0x26,0x26,0x04,0x03,0x13,0x0e,0x17,0x1b,0x47,0x47,0x01,0xb6,0x08,0x40,0x25,0x22,0x0e,0x10,0x0c,0x09,0x0e,0x13,0x35,0x2f,0x36,0x49,0x00,0x00,0x01,0xff,0x05,0xff,0x5a,0xff,0x6b,0xff,0xc0,0x00,0x0b,0x00,0x00,0x06,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0xdd,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0xa6,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x00,0x00,0x02,0xfe,0xb1,0xff,0x5a,0xff,0xbf,0xff,0xc0,0x00,0x0b,0x00,0x17,0x00,0x00,0x04,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0x32,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0xfe,0xcf,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x93,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0xa6,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x1e,0x15,0x15,0x1e,0x00,0x00,0x00,0x01,0xff,0x04,0xfe,0xf9,0xff,0x6e,0xff,0xc0,0x00,0x16,0x00,0x00,0x02,0x26,0x35,0x34,0x37,0x3e,0x01,0x35,0x22,0x26,0x35,0x34,0x36,0x33,0x32,0x16,0x1d,0x01,0x14,0x06,0x07,0x06,0x23,0xef,0x0d,0x0c,0x15,0x16,0x16,0x1b,0x1d,0x15,0x16,0x1c,0x26,0x1e,0x08,0x08,0xfe,0xf9,0x0d,0x0a,0x0d,0x08,0x0d,0x19,0x12,0x1b,0x15,0x15,0x1e,0x1e,0x17,0x21,0x27,0x33,0x12,0x05,0x00,0x01,0xfe,0xc6,0xff,0x23,0xff,0x9a,0x00,0x11,0x00,0x24,0x00,0x00,0x04,0x27,0x2e,0x01,0x35,0x34,0x36,0x33,0x32,0x17,0x16,0x33,0x32,0x35,0x34,0x26,0x23,0x22,0x07,0x06,0x23,0x22,0x26,0x35,0x34,0x3f,0x01,0x33,0x07,0x36,0x33,0x32,0x16,0x15,0x14,0x06,0x23,0xfe,0xfb,0x2a,0x04,0x07,0x0a,0x09,0x04,0x06,0x1f,0x1c,0x39,0x14,0x10,0x16,0x16,0x06,0x04,0x07,0x0b,0x04,0x40,0x2a,0x2e,0x10,0x12,0x22,0x2b,0x39,0x36,0xdd,0x1a,0x03,0x09,0x05,0x08,0x0c,0x03,0x11,0x2e,0x0f,0x10,0x0b,0x03,0x09,0x07,0x08,0x06,0x66,0x50,0x04,0x27,0x1f,0x2e,0x2e,0x00,0x00,0x00,0x01,0xfe,0x7f,0xff,0x35,0xff,0x3d,0x00,0x0a,0x00,0x15,0x00,0x00,0x04,0x26,0x35,0x34,0x36,0x37,0x33,0x06,0x15,0x14,0x33,0x32,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x06,0x23,0xfe,0xb6,0x37,0x39,0x2f,0x51,0x70,0x33,0x0f,0x14,0x06,0x03,0x0a,0x0c,0x0b,0x22,0x34,0xcb,0x2e,0x26,0x2c,0x3d,0x18,0x34,0x3a,0x2f,0x06,0x02,0x0c,0x0a,0x0a,0x08,0x18,0x00,0x00,0x00,0x00,0x01,0xfe,0xa9,0xff,0x4a,0xff,0xc7,0xff,0xc8,0x00,0x19,0x00,0x00,0x06,0x26,0x27,0x26,0x35,0x34,0x36,0x33,0x32,0x17,0x1e,0x01,0x33,0x32,0x36,0x37,0x36,0x33,0x32,0x16,0x15,0x14,0x07,0x0e,0x01,0x23,0xf7,0x4a,0x13,0x03,0x11,0x0e,0x13,0x09,0x0b,0x2c,0x1d,0x1d,0x2c,0x0b,0x09,0x13,0x0e,0x11,0x03,0x13,0x4a,0x2f,0xb6,0x2c,0x25,0x06,0x08,0x0d,0x12,0x13,0x17,0x1a,0x1a,0x17,0x13,0x12,0x0d,0x08,0x06,0x25,0x2c,0x00,0x00,0x00,0x00,0x01,0xfe,0xa5,0xff,0x77,0xff,0xcb,0xff,0xb3,0x00,0x0d,0x00,0x00,0x04,0x26,0x35,0x34,0x36,0x3b,0x01,0x32,0x16,0x15,0x14,0x06,0x2b,0x01,0xfe,0xb6,0x11,0x11,0x0d,0xea,0x0d,0x11,0x11,0x0d,0xea,0x89,0x11,0x0d,0x0d,0x11,0x11,0x0d,0x0d,0x11,0x00,0x00,0x00,0x10,0x00,0xc6,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xa2,0x01,0x46,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x0c,0x02,0x03,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x07,0x02,0x20,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x03,0x00,0x1e,0x02,0x66,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x04,0x00,0x14,0x02,0xaf,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x05,0x00,0x0d,0x02,0xe0,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x06,0x00,0x13,0x03,0x16,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x0e,0x00,0x1a,0x03,0x60,0x00,0x03,0x00,0x01,0x04,0x09,0x00,0x00,0x01,0x44,0x00,0x00,0x00,0x03,0x00,0x01,0x04,0x09,0x00,0x01,0x00,0x18,0x01,0xe9,0x00,0x03,0x00,0x01,0x04,0x09,0x00,0x02,0x00,0x0e,0x02,0x10,0x00,0x03,0x00,0x01,0x04,0x09,0x00,0x03,0x00,0x3c,0x02,0x28,0x00,0x03,0x00,0x01,0x04,0x09,0x00,0x04,0x00,0x28,0x02,0x85,0x00,0x03,0x00,0x01,0x04,0x09,0x00,0x05,0x00,0x1a,0x02,0xc4,0x00,0x03,0x00,0x01,0x04,0x09,0x00,0x06,0x00,0x26,0x02,0xee,0x00,0x03,0x00,0x01,0x04,0x09,0x00,0x0e,0x00,0x34,0x03,0x2a,0x00,0x43,0x00,0x6f,0x00,0x70,0x00,0x79,0x00,0x72,0x00,0x69,0x00,0x67,0x00,0x68,0x00,0x74,0x00,0x20,0x00,0x32,0x00,0x30,0x00,0x31,0x00,0x31,0x00,0x2d,0x00,0x32,0x00,0x30,0x00,0x31,0x00,0x36,0x00,0x20,0x00,0x54,0x00,0x68,0x00,0x65,0x00,0x20,0x00,0x56,0x00,0x61,0x00,0x72,0x00,0x65,0x00,0x6c,0x00,0x61,0x00,0x20,0x00,0x52,0x00,0x6f,0x00,0x75,0x00,0x6e,0x00,0x64,0x00,0x20,0x00,0x50,0x00,0x72,0x00,0x6f,0x00,0x6a,0x00,0x65,0x00,0x63,0x00,0x74,0x00,0x20,0x00,0x41,0x00,0x75,0x00,0x74,0x00,0x68,0x00,0x6f,0x00,0x72,0x00,0x73,0x00,0x20,0x00,0x28,0x00,0x68,0x00,0x74,0x00,0x74,0x00,0x70,0x00,0x73,0x00,0x3a,0x00,0x2f,0x00,0x2f,0x00,0x67,0x00,0x69,0x00,0x74,0x00,0x68,0x00,0x75,0x00,0x62,0x00,0x2e,0x00,0x63,0x00,0x6f,0x00,0x6d,0x00,0x2f,0x00,0x61,0x00,0x6c,0x00,0x65,0x00,0x66,0x00,0x61,0x00,0x6c,0x00,0x65,0x00,0x66,0x00,0x61,0x00,0x6c,0x00,0x65,0x00,0x66,0x00,0x2f,0x00,0x56,0x00,0x61,0x00,0x72,0x00,0x65,0x00,0x6c,0x00,0x61,0x00,0x2d,0x00,0x52,0x00,0x6f,0x00,0x75,0x00,0x6e,0x00,0x64,0x00,0x2d,0x00,0x48,0x00,0x65,0x00,0x62,0x00,0x72,0x00,0x65,0x00,0x77,0x00,0x2f,0x00,0x29,0x00,0x2c,0x00,0x20,0x00,0x77,0x00,0x69,0x00,0x74,0x00,0x68,0x00,0x20,0x00,0x52,0x00,0x65,0x00,0x73,0x00,0x65,0x00,0x72,0x00,0x76,0x00,0x65,0x00,0x64,0x00,0x20,0x00,0x46,0x00,0x6f,0x00,0x6e,0x00,0x74,0x00,0x20,0x00,0x4e,0x00,0x61,0x00,0x6d,0x00,0x65,0x00,0x73,0x00,0x20,0x00,0x27,0x00,0x56,0x00,0x61,0x00,0x72,0x00,0x65,0x00,0x6c,0x00,0x61,0x00,0x27,0x00,0x20,0x00,0x61,0x00,0x6e,0x00,0x64,0x00,0x20,0x20,0x18,0x00,0x56,0x00,0x61,0x00,0x72,0x00,0x65,0x00,0x6c,0x00,0x61,0x00,0x20,0x00,0x52,0x00,0x6f,0x00,0x75,0x00,0x6e,0x00,0x64,0x20,0x19,0x00,0x2e,0x00,0x00,0x43,0x6f,0x70,0x79,0x72,0x69,0x67,0x68,0x74,0x20,0x32,0x30,0x31,0x31,0x2d,0x32,0x30,0x31,0x36,0x20,0x54,0x68,0x65,0x20,0x56,0x61,0x72,0x65,0x6c,0x61,0x20,0x52,0x6f,0x75,0x6e,0x64,0x20,0x50,0x72,0x6f,0x6a,0x65,0x63,0x74,0x20,0x41,0x75,0x74,0x68,0x6f,0x72,0x73,0x20,0x28,0x68,0x74,0x74,0x70,0x73,0x3a,0x2f,0x2f,0x67,0x69,0x74,0x68,0x75,0x62,0x2e,0x63,0x6f,0x6d,0x2f,0x61,0x6c,0x65,0x66,0x61,0x6c,0x65,0x66,0x61,0x6c,0x65,0x66,0x2f,0x56,0x61,0x72,0x65,0x6c,0x61,0x2d,0x52,0x6f,0x75,0x6e,0x64,0x2d,0x48,0x65,0x62,0x72,0x65,0x77,0x2f,0x29,0x2c,0x20,0x77,0x69,0x74,0x68,0x20,0x52,0x65,0x73,0x65,0x72,0x76,0x65,0x64,0x20,0x46,0x6f,0x6e,0x74,0x20,0x4e,0x61,0x6d,0x65,0x73,0x20,0x27,0x56,0x61,0x72,0x65,0x6c,0x61,0x27,0x20,0x61,0x6e,0x64,0x20,0xd4,0x56,0x61,0x72,0x65,0x6c,0x61,0x20,0x52,0x6f,0x75,0x6e,0x64,0xd5,0x2e,0x00,0x00,0x56,0x00,0x61,0x00,0x72,0x00,0x65,0x00,0x6c,0x00,0x61,0x00,0x20,0x00,0x52,0x00,0x6f,0x00,0x75,0x00,0x6e,0x00,0x64,0x00,0x00,0x56,0x61,0x72,0x65,0x6c,0x61,0x20,0x52,0x6f,0x75,0x6e,0x64,0x00,0x00,0x52,0x00,0x65,0x00,0x67,0x00,0x75,0x00,0x6c,0x00,0x61,0x00,0x72,0x00,0x00,0x52,0x65,0x67,0x75,0x6c,0x61,0x72,0x00,0x00,0x33,0x00,0x2e,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x3b,0x00,0x55,0x00,0x4b,0x00,0x57,0x00,0x4e,0x00,0x3b,0x00,0x56,0x00,0x61,0x00,0x72,0x00,0x65,0x00,0x6c,0x00,0x61,0x00,0x52,0x00,0x6f,0x00,0x75,0x00,0x6e,0x00,0x64,0x00,0x2d,0x00,0x52,0x00,0x65,0x00,0x67,0x00,0x75,0x00,0x6c,0x00,0x61,0x00,0x72,0x00,0x00,0x33,0x2e,0x30,0x30,0x30,0x3b,0x55,0x4b,0x57,0x4e,0x3b,0x56,0x61,0x72,0x65,0x6c,0x61,0x52,0x6f,0x75,0x6e,0x64,0x2d,0x52,0x65,0x67,0x75,0x6c,0x61,0x72,0x00,0x00,0x56,0x00,0x61,0x00,0x72,0x00,0x65,0x00,0x6c,0x00,0x61,0x00,0x20,0x00,0x52,0x00,0x6f,0x00,0x75,0x00,0x6e,0x00,0x64,0x00,0x20,0x00,0x52,0x00,0x65,0x00,0x67,0x00,0x75,0x00,0x6c,0x00,0x61,0x00,0x72,0x00,0x00,0x56,0x61,0x72,0x65,0x6c,0x61,0x20,0x52,0x6f,0x75,0x6e,0x64,0x20,0x52,0x65,0x67,0x75,0x6c,0x61,0x72,0x00,0x00,0x56,0x00,0x65,0x00,0x72,0x00,0x73,0x00,0x69,0x00,0x6f,0x00,0x6e,0x00,0x20,0x00,0x33,0x00,0x2e,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x00,0x56,0x65,0x72,0x73,0x69,0x6f,0x6e,0x20,0x33,0x2e,0x30,0x30,0x30,0x00,0x00,0x56,0x00,0x61,0x00,0x72,0x00,0x65,0x00,0x6c,0x00,0x61,0x00,0x52,0x00,0x6f,0x00,0x75,0x00,0x6e,0x00,0x64,0x00,0x2d,0x00,0x52,0x00,0x65,0x00,0x67,0x00,0x75,0x00,0x6c,0x00,0x61,0x00,0x72,0x00,0x00,0x56,0x61,0x72,0x65,0x6c,0x61,0x52,0x6f,0x75,0x6e,0x64,0x2d,0x52,0x65,0x67,0x75,0x6c,0x61,0x72,0x00,0x00,0x68,0x00,0x74,0x00,0x74,0x00,0x70,0x00,0x3a,0x00,0x2f,0x00,0x2f,0x00,0x73,0x00,0x63,0x00,0x72,0x00,0x69,0x00,0x70,0x00,0x74,0x00,0x73,0x00,0x2e,0x00,0x73,0x00,0x69,0x00,0x6c,0x00,0x2e,0x00,0x6f,0x00,0x72,0x00,0x67,0x00,0x2f,0x00,0x4f,0x00,0x46,0x00,0x4c,0x00,0x00,0x68,0x74,0x74,0x70,0x3a,0x2f,0x2f,0x73,0x63,0x72,0x69,0x70,0x74,0x73,0x2e,0x73,0x69,0x6c,0x2e,0x6f,0x72,0x67,0x2f,0x4f,0x46,0x4c,0x00,0x00,0x00,0x00,0x00,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0x83,0x00,0x32,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x01,0xff,0xff,0x00,0x0f,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x00,0x00,0x64,0x00,0x6c,0x00,0x02,0x00,0x0e,0x00,0x02,0x00,0x43,0x00,0x01,0x00,0x44,0x00,0x44,0x00,0x03,0x00,0x45,0x00,0x6a,0x00,0x01,0x00,0x6b,0x00,0x6b,0x00,0x03,0x00,0x6c,0x00,0x71,0x00,0x01,0x00,0x72,0x00,0x72,0x00,0x03,0x00,0x73,0x00,0x76,0x00,0x01,0x00,0x77,0x00,0x77,0x00,0x03,0x00,0x78,0x00,0x7a,0x00,0x01,0x00,0x7b,0x00,0x7b,0x00,0x03,0x00,0x7c,0x00,0x7f,0x00,0x01,0x00,0x80,0x00,0x81,0x00,0x02,0x00,0x82,0x00,0xc2,0x00,0x01,0x00,0xc3,0x00,0xd9,0x00,0x03,0x00,0x04,0x00,0x00,0x00,0x02,0x00,0x00,0x00,0x02,0x00,0x04,0x00,0xc3,0x00,0xd1,0x00,0x02,0x00,0xd2,0x00,0xd2,0x00,0x03,0x00,0xd3,0x00,0xd6,0x00,0x01,0x00,0xd8,0x00,0xd9,0x00,0x01,0x00,0x01,0x00,0x00,0x00,0x0a,0x01,0x04,0x01,0x98,0x00,0x05,0x44,0x46,0x4c,0x54,0x00,0x20,0x63,0x79,0x72,0x6c,0x00,0x2c,0x67,0x72,0x65,0x6b,0x00,0x48,0x68,0x65,0x62,0x72,0x00,0x56,0x6c,0x61,0x74,0x6e,0x00,0x62,0x00,0x04,0x00,0x00,0x00,0x00,0xff,0xff,0x00,0x01,0x00,0x00,0x00,0x0a,0x00,0x01,0x53,0x52,0x42,0x20,0x00,0x14,0x00,0x00,0xff,0xff,0x00,0x02,0x00,0x00,0x00,0x01,0x00,0x00,0xff,0xff,0x00,0x01,0x00,0x00,0x00,0x04,0x00,0x00,0x00,0x00,0xff,0xff,0x00,0x02,0x00,0x00,0x00,0x02,0x00,0x04,0x00,0x00,0x00,0x00,0xff,0xff,0x00,0x01,0x00,0x00,0x00,0x40,0x00,0x0a,0x41,0x5a,0x45,0x20,0x00,0x4a,0x43,0x41,0x54,0x20,0x00,0x54,0x43,0x52,0x54,0x20,0x00,0x5e,0x44,0x45,0x55,0x20,0x00,0x68,0x4b,0x41,0x5a,0x20,0x00,0x72,0x4d,0x4f,0x4c,0x20,0x00,0x7a,0x4e,0x4c,0x44,0x20,0x00,0x72,0x52,0x4f,0x4d,0x20,0x00,0x84,0x54,0x41,0x54,0x20,0x00,0x72,0x54,0x52,0x4b,0x20,0x00,0x8e,0x00,0x00,0xff,0xff,0x00,0x02,0x00,0x00,0x00,0x03,0x00,0x00,0xff,0xff,0x00,0x02,0x00,0x00,0x00,0x04,0x00,0x00,0xff,0xff,0x00,0x02,0x00,0x00,0x00,0x0a,0x00,0x00,0xff,0xff,0x00,0x02,0x00,0x00,0x00,0x05,0x00,0x00,0xff,0xff,0x00,0x02,0x00,0x00,0x00,0x06,0x00,0x00,0xff,0xff,0x00,0x01,0x00,0x00,0x00,0x00,0xff,0xff,0x00,0x02,0x00,0x00,0x00,0x07,0x00,0x00,0xff,0xff,0x00,0x02,0x00,0x00,0x00,0x08,0x00,0x00,0xff,0xff,0x00,0x02,0x00,0x00,0x00,0x09,0x00,0x0b,0x63,0x63,0x6d,0x70,0x00,0x44,0x66,0x72,0x61,0x63,0x00,0x4c,0x66,0x72,0x61,0x63,0x00,0x52,0x66,0x72,0x61,0x63,0x00,0x58,0x66,0x72,0x61,0x63,0x00,0x5e,0x66,0x72,0x61,0x63,0x00,0x66,0x66,0x72,0x61,0x63,0x00,0x6e,0x66,0x72,0x61,0x63,0x00,0x76,0x66,0x72,0x61,0x63,0x00,0x7e,0x66,0x72,0x61,0x63,0x00,0x86,0x6c,0x6f,0x63,0x6c,0x00,0x8e,0x00,0x00,0x00,0x02,0x00,0x09,0x00,0x0a,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x01,0x00,0x00,0x00,0x01,0x00,0x02,0x00,0x00,0x00,0x02,0x00,0x02,0x00,0x03,0x00,0x00,0x00,0x02,0x00,0x02,0x00,0x04,0x00,0x00,0x00,0x02,0x00,0x02,0x00,0x05,0x00,0x00,0x00,0x02,0x00,0x02,0x00,0x06,0x00,0x00,0x00,0x02,0x00,0x02,0x00,0x07,0x00,0x00,0x00,0x02,0x00,0x02,0x00,0x08,0x00,0x00,0x00,0x01,0x00,0x0b,0x00,0x0e,0x00,0x1e,0x00,0x2c,0x00,0x3a,0x00,0x48,0x00,0x56,0x00,0x64,0x00,0x72,0x00,0x80,0x00,0x8e,0x00,0x9c,0x00,0xaa,0x00,0xb4,0x00,0xbe,0x00,0xc6,0x00,0x06,0x00,0x00,0x00,0x04,0x00,0xb0,0x00,0xd6,0x00,0xfc,0x01,0x22,0x00,0x06,0x00,0x00,0x00,0x04,0x01,0x3a,0x01,0x60,0x01,0x86,0x01,0xac,0x00,0x06,0x00,0x00,0x00,0x04,0x01,0xc4,0x01,0xea,0x02,0x10,0x02,0x36,0x00,0x06,0x00,0x00,0x00,0x04,0x02,0x4e,0x02,0x74,0x02,0x9a,0x02,0xc0,0x00,0x06,0x00,0x00,0x00,0x04,0x02,0xd8,0x02,0xfe,0x03,0x24,0x03,0x4a,0x00,0x06,0x00,0x00,0x00,0x04,0x03,0x62,0x03,0x88,0x03,0xae,0x03,0xd4,0x00,0x06,0x00,0x00,0x00,0x04,0x03,0xec,0x04,0x12,0x04,0x38,0x04,0x5e,0x00,0x06,0x00,0x00,0x00,0x04,0x04,0x76,0x04,0x9c,0x04,0xc2,0x04,0xe8,0x00,0x06,0x00,0x00,0x00,0x04,0x05,0x00,0x05,0x26,0x05,0x4c,0x05,0x72,0x00,0x06,0x00,0x00,0x00,0x04,0x05,0x8a,0x05,0xae,0x05,0xe4,0x06,0x0a,0x00,0x06,0x00,0x00,0x00,0x02,0x06,0x2e,0x06,0x4e,0x00,0x06,0x00,0x00,0x00,0x02,0x06,0x64,0x06,0x8a,0x00,0x04,0x00,0x00,0x00,0x01,0x06,0xa6,0x00,0x01,0x00,0x00,0x00,0x01,0x06,0xe2,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x16,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x17,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x16,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x17,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x16,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x17,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x16,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x17,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x16,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x17,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x16,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x17,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x16,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x17,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x16,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x17,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x14,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x16,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x15,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x14,0x00,0x1a,0x00,0x20,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0c,0x00,0x01,0x00,0x01,0x00,0x17,0x00,0x01,0x00,0x01,0x00,0x13,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x03,0x00,0x00,0x00,0x01,0x00,0x12,0x00,0x01,0x00,0x1a,0x00,0x01,0x00,0x00,0x00,0x0d,0x00,0x01,0x00,0x02,0x00,0x4d,0x00,0x4e,0x00,0x02,0x00,0x01,0x00,0xc3,0x00,0xd1,0x00,0x00,0x00,0x03,0x00,0x00,0x00,0x01,0x00,0x14,0x00,0x02,0x00,0x1c,0x00,0x2c,0x00,0x01,0x00,0x00,0x00,0x0d,0x00,0x01,0x00,0x02,0x00,0x4d,0x00,0x4e,0x00,0x02,0x00,0x02,0x00,0xd2,0x00,0xd4,0x00,0x00,0x00,0xd6,0x00,0xd9,0x00,0x03,0x00,0x02,0x00,0x01,0x00,0xc3,0x00,0xd1,0x00,0x00,0x00,0x03,0x00,0x01,0x00,0x1c,0x00,0x01,0x00,0x12,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0d,0x00,0x02,0x00,0x01,0x00,0xc3,0x00,0xd1,0x00,0x00,0x00,0x02,0x00,0x01,0x00,0xc3,0x00,0xd1,0x00,0x00,0x00,0x03,0x00,0x01,0x00,0x1c,0x00,0x01,0x00,0x12,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0d,0x00,0x02,0x00,0x01,0x00,0xc3,0x00,0xd1,0x00,0x00,0x00,0x02,0x00,0x03,0x00,0x25,0x00,0x3e,0x00,0x00,0x00,0x83,0x00,0x99,0x00,0x1a,0x00,0x9b,0x00,0xa1,0x00,0x31,0x00,0x03,0x00,0x00,0x00,0x01,0x00,0x12,0x00,0x01,0x00,0x1c,0x00,0x01,0x00,0x00,0x00,0x0d,0x00,0x02,0x00,0x01,0x00,0xc3,0x00,0xd1,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x03,0x00,0x01,0x00,0x1c,0x00,0x01,0x00,0x12,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0d,0x00,0x02,0x00,0x01,0x00,0xc3,0x00,0xd1,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x03,0x00,0x01,0x00,0x1a,0x00,0x01,0x00,0x14,0x00,0x01,0x00,0x20,0x00,0x01,0x00,0x00,0x00,0x0d,0x00,0x01,0x00,0x01,0x00,0x7a,0x00,0x01,0x00,0x01,0x00,0x50,0x00,0x01,0x00,0x01,0x00,0x50,0x00,0x03,0x00,0x01,0x00,0x1a,0x00,0x01,0x00,0x14,0x00,0x01,0x00,0x20,0x00,0x01,0x00,0x00,0x00,0x0d,0x00,0x01,0x00,0x01,0x00,0x7a,0x00,0x01,0x00,0x01,0x00,0x30,0x00,0x01,0x00,0x01,0x00,0x30,0x00,0x01,0x00,0x3a,0x00,0x03,0x00,0x0c,0x00,0x18,0x00,0x2e,0x00,0x01,0x00,0x04,0x00,0x09,0x00,0x03,0x00,0x13,0x00,0x14,0x00,0x02,0x00,0x06,0x00,0x0e,0x00,0x80,0x00,0x03,0x00,0x13,0x00,0x16,0x00,0x80,0x00,0x03,0x00,0x13,0x00,0x18,0x00,0x01,0x00,0x04,0x00,0x81,0x00,0x03,0x00,0x13,0x00,0x18,0x00,0x01,0x00,0x03,0x00,0x14,0x00,0x15,0x00,0x17,0x00,0x02,0x00,0x0a,0x00,0x02,0x00,0x6d,0x00,0x7d,0x00,0x01,0x00,0x02,0x00,0x45,0x00,0x53,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x0a,0x00,0x88,0x00,0xd2,0x00,0x05,0x44,0x46,0x4c,0x54,0x00,0x20,0x63,0x79,0x72,0x6c,0x00,0x30,0x67,0x72,0x65,0x6b,0x00,0x40,0x68,0x65,0x62,0x72,0x00,0x50,0x6c,0x61,0x74,0x6e,0x00,0x6e,0x00,0x04,0x00,0x00,0x00,0x00,0xff,0xff,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x04,0x00,0x04,0x00,0x00,0x00,0x00,0xff,0xff,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x04,0x00,0x04,0x00,0x00,0x00,0x00,0xff,0xff,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x04,0x00,0x0a,0x00,0x01,0x49,0x57,0x52,0x20,0x00,0x16,0x00,0x00,0xff,0xff,0x00,0x03,0x00,0x01,0x00,0x03,0x00,0x04,0x00,0x00,0xff,0xff,0x00,0x01,0x00,0x02,0x00,0x04,0x00,0x00,0x00,0x00,0xff,0xff,0x00,0x03,0x00,0x00,0x00,0x03,0x00,0x04,0x00,0x05,0x6b,0x65,0x72,0x6e,0x00,0x20,0x6b,0x65,0x72,0x6e,0x00,0x28,0x6b,0x65,0x72,0x6e,0x00,0x32,0x6d,0x61,0x72,0x6b,0x00,0x38,0x6d,0x6b,0x6d,0x6b,0x00,0x40,0x00,0x00,0x00,0x02,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x03,0x00,0x00,0x00,0x01,0x00,0x02,0x00,0x00,0x00,0x01,0x00,0x02,0x00,0x00,0x00,0x02,0x00,0x03,0x00,0x04,0x00,0x00,0x00,0x03,0x00,0x05,0x00,0x06,0x00,0x07,0x00,0x08,0x00,0x12,0x00,0x1e,0x00,0x32,0x00,0x3a,0x00,0x42,0x00,0x4a,0x00,0x52,0x00,0x5a,0x00,0x02,0x00,0x00,0x00,0x03,0x00,0x50,0x00,0x84,0x01,0xde,0x00,0x02,0x00,0x08,0x00,0x07,0x02,0x5c,0x06,0x12,0x0e,0xae,0x0f,0x4a,0x13,0xdc,0x1a,0x12,0x1a,0x58,0x00,0x02,0x00,0x09,0x00,0x01,0x1a,0x8a,0x00,0x04,0x00,0x00,0x00,0x01,0x1c,0x60,0x00,0x04,0x00,0x00,0x00,0x01,0x1d,0x66,0x00,0x06,0x01,0x00,0x00,0x01,0x2c,0x58,0x00,0x06,0x02,0x00,0x00,0x01,0x2c,0xf6,0x00,0x06,0x03,0x00,0x00,0x01,0x2e,0x58,0x00,0x02,0x00,0x2e,0x00,0x04,0x00,0x00,0x00,0x16,0x00,0x1e,0x00,0x01,0x00,0x03,0x00,0x00,0xff,0xd2,0xff,0xd2,0x00,0x01,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x02,0x00,0x02,0x00,0x06,0x00,0x06,0x00,0x02,0x00,0x0b,0x00,0x0b,0x00,0x02,0x00,0x01,0x00,0x01,0x00,0x0a,0x00,0x02,0x01,0x3c,0x00,0x04,0x00,0x00,0x00,0xb0,0x00,0xf6,0x00,0x08,0x00,0x0a,0x00,0x00,0xff,0xec,0xff,0xec,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xd8,0xff,0xd8,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xea,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0a,0x00,0x00,0x00,0x00,0xff,0xec,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xfb,0xff,0xec,0xff,0x83,0xff,0x83,0xff,0xf6,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xec,0xff,0xde,0xff,0x7e,0xff,0xd5,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xec,0x00,0x00,0xff,0x7e,0xff,0xd5,0x00,0x00,0xff,0xec,0xff,0xc4,0x00,0x00,0x00,0x00,0x00,0x0a,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0x6c,0x00,0x02,0x00,0x0b,0x00,0x06,0x00,0x06,0x00,0x06,0x00,0x0b,0x00,0x0b,0x00,0x06,0x00,0x10,0x00,0x10,0x00,0x04,0x00,0x11,0x00,0x11,0x00,0x03,0x00,0x12,0x00,0x12,0x00,0x04,0x00,0x13,0x00,0x13,0x00,0x07,0x00,0x40,0x00,0x40,0x00,0x01,0x00,0x43,0x00,0x43,0x00,0x04,0x00,0x70,0x00,0x70,0x00,0x03,0x00,0x7a,0x00,0x7a,0x00,0x03,0x00,0x7e,0x00,0x7e,0x00,0x02,0x00,0x02,0x00,0x0b,0x00,0x06,0x00,0x06,0x00,0x04,0x00,0x0b,0x00,0x0b,0x00,0x04,0x00,0x10,0x00,0x10,0x00,0x08,0x00,0x12,0x00,0x12,0x00,0x08,0x00,0x13,0x00,0x13,0x00,0x09,0x00,0x18,0x00,0x18,0x00,0x02,0x00,0x1b,0x00,0x1b,0x00,0x05,0x00,0x1c,0x00,0x1c,0x00,0x01,0x00,0x24,0x00,0x24,0x00,0x06,0x00,0x43,0x00,0x43,0x00,0x08,0x00,0x6e,0x00,0x6e,0x00,0x07,0x00,0x01,0x00,0x0d,0x00,0x06,0x00,0x0b,0x00,0x0e,0x00,0x10,0x00,0x11,0x00,0x12,0x00,0x13,0x00,0x40,0x00,0x42,0x00,0x43,0x00,0x70,0x00,0x7a,0x00,0x7e,0x00,0x02,0x00,0x80,0x00,0x04,0x00,0x00,0x00,0x38,0x00,0x46,0x00,0x04,0x00,0x05,0x00,0x00,0xff,0xec,0xff,0xf6,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xec,0x00,0x00,0x00,0x0a,0x00,0x00,0x00,0x00,0x00,0x0a,0xff,0xce,0xff,0xec,0xff,0xe2,0x00,0x00,0xff,0xec,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x18,0x00,0x04,0x00,0x01,0x00,0x00,0x00,0x03,0x00,0x02,0x00,0x02,0x00,0x09,0x00,0x0e,0x00,0x0e,0x00,0x01,0x00,0x10,0x00,0x10,0x00,0x02,0x00,0x11,0x00,0x11,0x00,0x03,0x00,0x12,0x00,0x12,0x00,0x02,0x00,0x13,0x00,0x13,0x00,0x04,0x00,0x42,0x00,0x42,0x00,0x01,0x00,0x43,0x00,0x43,0x00,0x02,0x00,0x70,0x00,0x70,0x00,0x03,0x00,0x7a,0x00,0x7a,0x00,0x03,0x00,0x02,0x00,0x01,0x00,0x18,0x00,0x1b,0x00,0x00,0x00,0x01,0x03,0x14,0x00,0x04,0x00,0x00,0x00,0x4f,0x00,0xa8,0x00,0xae,0x00,0xb4,0x00,0xbe,0x00,0xc8,0x00,0xc8,0x00,0xc8,0x00,0xc8,0x00,0xbe,0x00,0xce,0x00,0xbe,0x00,0xd8,0x00,0xe6,0x00,0xf8,0x01,0x06,0x00,0xae,0x01,0x58,0x01,0x5e,0x01,0x58,0x01,0x74,0x01,0x74,0x01,0x58,0x01,0x58,0x01,0x5e,0x01,0x5e,0x01,0x7a,0x01,0x7a,0x01,0x7a,0x01,0x80,0x00,0xc8,0x00,0xa8,0x00,0xf8,0x00,0xc8,0x00,0xbe,0x02,0x96,0x00,0xc8,0x02,0xd0,0x00,0xb4,0x00,0xb4,0x00,0xb4,0x00,0xb4,0x00,0xb4,0x00,0xb4,0x00,0xc8,0x00,0xc8,0x00,0xc8,0x00,0xc8,0x00,0xbe,0x00,0xc8,0x00,0xbe,0x00,0xbe,0x00,0xbe,0x00,0xbe,0x00,0xbe,0x00,0xbe,0x00,0xf8,0x02,0xd6,0x02,0xe0,0x01,0x58,0x01,0x58,0x01,0x58,0x01,0x58,0x01,0x58,0x01,0x58,0x01,0x74,0x01,0x74,0x01,0x74,0x01,0x74,0x02,0xea,0x01,0x58,0x01,0x5e,0x01,0x5e,0x01,0x5e,0x01,0x5e,0x01,0x5e,0x01,0x5e,0x01,0x7a,0x01,0x5e,0x01,0x7a,0x00,0x01,0x00,0x4e,0x00,0x1e,0x00,0x01,0x00,0xb2,0x00,0x0b,0x00,0x02,0x00,0x41,0xff,0xf1,0x00,0x71,0xff,0xf6,0x00,0x02,0x00,0x41,0xff,0xee,0x00,0x61,0xff,0xee,0x00,0x01,0x00,0x61,0x00,0x0b,0x00,0x02,0x00,0x61,0xff,0xf6,0x00,0xb1,0xff,0xfe,0x00,0x03,0x00,0x71,0xff,0xf0,0x00,0xb1,0x00,0x01,0x00,0xb2,0x00,0x0f,0x00,0x04,0x00,0x71,0xff,0xf6,0x00,0xaf,0x00,0x03,0x00,0xb1,0x00,0x01,0x00,0xb2,0x00,0x12,0x00,0x03,0x00,0x71,0xff,0xe9,0x00,0xaf,0x00,0x0e,0x00,0xb2,0x00,0x17,0x00,0x14,0x00,0x25,0xff,0xef,0x00,0x27,0xff,0xef,0x00,0x2b,0xff,0xef,0x00,0x33,0xff,0xef,0x00,0x35,0xff,0xef,0x00,0x6c,0xff,0xef,0x00,0x71,0xff,0xef,0x00,0x83,0xff,0xef,0x00,0x84,0xff,0xef,0x00,0x85,0xff,0xef,0x00,0x86,0xff,0xef,0x00,0x87,0xff,0xef,0x00,0x88,0xff,0xef,0x00,0x8a,0xff,0xef,0x00,0x95,0xff,0xef,0x00,0x96,0xff,0xef,0x00,0x97,0xff,0xef,0x00,0x98,0xff,0xef,0x00,0x99,0xff,0xef,0x00,0x9b,0xff,0xef,0x00,0x01,0x00,0x41,0xff,0xe9,0x00,0x05,0x00,0x0d,0xff,0xeb,0x00,0x23,0xff,0xf4,0x00,0x40,0xff,0xf4,0x00,0x41,0xff,0xed,0x00,0x61,0xff,0xe9,0x00,0x01,0x00,0x0e,0x00,0x0a,0x00,0x01,0x00,0x61,0xff,0xef,0x00,0x45,0x00,0x26,0x00,0x0c,0x00,0x27,0xff,0xef,0x00,0x28,0x00,0x0c,0x00,0x29,0x00,0x0c,0x00,0x2a,0x00,0x0c,0x00,0x2b,0xff,0xef,0x00,0x2c,0x00,0x0c,0x00,0x2d,0x00,0x0c,0x00,0x2f,0x00,0x0c,0x00,0x30,0x00,0x0c,0x00,0x31,0x00,0x0c,0x00,0x32,0x00,0x0c,0x00,0x33,0xff,0xef,0x00,0x34,0x00,0x0c,0x00,0x35,0xff,0xef,0x00,0x36,0x00,0x0c,0x00,0x47,0xff,0xea,0x00,0x48,0xff,0xea,0x00,0x49,0xff,0xea,0x00,0x4b,0xff,0xea,0x00,0x53,0xff,0xea,0x00,0x55,0xff,0xea,0x00,0x58,0xff,0xef,0x00,0x59,0xff,0xec,0x00,0x5a,0xff,0xef,0x00,0x5b,0xff,0xef,0x00,0x5d,0xff,0xef,0x00,0x60,0x00,0x0c,0x00,0x65,0xff,0xea,0x00,0x69,0x00,0x0c,0x00,0x6c,0xff,0xef,0x00,0x71,0xff,0xef,0x00,0x78,0xff,0xec,0x00,0x8a,0xff,0xef,0x00,0x8b,0x00,0x0c,0x00,0x8c,0x00,0x0c,0x00,0x8d,0x00,0x0c,0x00,0x8e,0x00,0x0c,0x00,0x8f,0x00,0x0c,0x00,0x90,0x00,0x0c,0x00,0x91,0x00,0x0c,0x00,0x92,0x00,0x0c,0x00,0x93,0x00,0x0c,0x00,0x94,0x00,0x0c,0x00,0x95,0xff,0xef,0x00,0x96,0xff,0xef,0x00,0x97,0xff,0xef,0x00,0x98,0xff,0xef,0x00,0x99,0xff,0xef,0x00,0x9b,0xff,0xef,0x00,0xa1,0x00,0x0c,0x00,0xaa,0xff,0xea,0x00,0xab,0xff,0xea,0x00,0xac,0xff,0xea,0x00,0xad,0xff,0xea,0x00,0xae,0xff,0xea,0x00,0xb3,0xff,0xea,0x00,0xb5,0xff,0xea,0x00,0xb6,0xff,0xea,0x00,0xb7,0xff,0xea,0x00,0xb8,0xff,0xea,0x00,0xb9,0xff,0xea,0x00,0xbb,0xff,0xea,0x00,0xbc,0xff,0xec,0x00,0xbd,0xff,0xec,0x00,0xbe,0xff,0xec,0x00,0xbf,0xff,0xec,0x00,0xc0,0xff,0xef,0x00,0xc2,0xff,0xef,0x00,0x0e,0x00,0x25,0xff,0xf5,0x00,0x38,0xff,0xef,0x00,0x3a,0xff,0xf6,0x00,0x3d,0xff,0xe7,0x00,0x41,0xff,0xee,0x00,0x61,0xff,0xee,0x00,0x68,0xff,0xe7,0x00,0x83,0xff,0xf5,0x00,0x84,0xff,0xf5,0x00,0x85,0xff,0xf5,0x00,0x86,0xff,0xf5,0x00,0x87,0xff,0xf5,0x00,0x88,0xff,0xf5,0x00,0xa0,0xff,0xe7,0x00,0x01,0x00,0x4e,0x00,0x12,0x00,0x02,0x00,0x41,0xff,0xef,0x00,0x61,0xff,0xf1,0x00,0x02,0x00,0x41,0xff,0xf3,0x00,0x61,0xff,0xf3,0x00,0x0a,0x00,0x0d,0xff,0xee,0x00,0x23,0xff,0xf4,0x00,0x40,0xff,0xf4,0x00,0x41,0xff,0xee,0x00,0x5a,0xff,0xfc,0x00,0x5b,0xff,0xfc,0x00,0x5d,0xff,0xfc,0x00,0x61,0xff,0xee,0x00,0xc0,0xff,0xfc,0x00,0xc2,0xff,0xfc,0x00,0x01,0x00,0x4f,0x00,0x05,0x00,0x0e,0x00,0x25,0x00,0x28,0x00,0x2c,0x00,0x2d,0x00,0x31,0x00,0x32,0x00,0x33,0x00,0x34,0x00,0x35,0x00,0x38,0x00,0x3a,0x00,0x3d,0x00,0x3f,0x00,0x42,0x00,0x45,0x00,0x46,0x00,0x4c,0x00,0x4d,0x00,0x4e,0x00,0x51,0x00,0x52,0x00,0x53,0x00,0x54,0x00,0x5a,0x00,0x5b,0x00,0x5d,0x00,0x5f,0x00,0x60,0x00,0x64,0x00,0x68,0x00,0x69,0x00,0x6c,0x00,0x71,0x00,0x79,0x00,0x82,0x00,0x83,0x00,0x84,0x00,0x85,0x00,0x86,0x00,0x87,0x00,0x88,0x00,0x8f,0x00,0x90,0x00,0x91,0x00,0x92,0x00,0x93,0x00,0x94,0x00,0x95,0x00,0x96,0x00,0x97,0x00,0x98,0x00,0x99,0x00,0x9b,0x00,0xa0,0x00,0xa1,0x00,0xa2,0x00,0xa3,0x00,0xa4,0x00,0xa5,0x00,0xa6,0x00,0xa7,0x00,0xa8,0x00,0xaf,0x00,0xb0,0x00,0xb1,0x00,0xb2,0x00,0xb3,0x00,0xb4,0x00,0xb5,0x00,0xb6,0x00,0xb7,0x00,0xb8,0x00,0xb9,0x00,0xbb,0x00,0xc0,0x00,0xc1,0x00,0xc2,0x00,0x02,0x08,0x44,0x00,0x04,0x00,0x00,0x05,0xda,0x06,0xc8,0x00,0x13,0x00,0x27,0x00,0x00,0xff,0xec,0xff,0xf2,0xff,0xc2,0xff,0xed,0xff,0xd4,0x00,0x18,0xff,0xc4,0xff,0xc4,0xff,0xe0,0xff,0xeb,0xff,0xfa,0xff,0xf2,0xff,0xf9,0xff,0xfa,0xff,0xf4,0xff,0xd4,0xff,0xf4,0xff,0xee,0xff,0xd3,0xff,0xd3,0xff,0xe9,0xff,0xf2,0xff,0xdc,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xd6,0x00,0x00,0xff,0xf4,0xff,0xef,0xff,0xe3,0xff,0xec,0x00,0x00,0xff,0xf5,0xff,0xf9,0x00,0x00,0xff,0xf8,0xff,0xf9,0xff,0xfb,0x00,0x00,0xff,0xf0,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf2,0xff,0xf9,0xff,0xf3,0xff,0xf8,0xff,0xfb,0xff,0xf7,0xff,0xee,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xec,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf9,0x00,0x00,0xff,0xea,0x00,0x00,0xff,0xf9,0xff,0xf0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xec,0xff,0xf5,0xff,0xce,0x00,0x00,0x00,0x00,0xff,0xf6,0x00,0x00,0xff,0xf9,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf9,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf5,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf9,0xff,0xf2,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xef,0xff,0xf3,0xff,0xf0,0x00,0x00,0x00,0x00,0xff,0xfa,0x00,0x00,0xff,0xf9,0xff,0xf9,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xcc,0xff,0xec,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xee,0xff,0xf9,0x00,0x00,0xff,0xf5,0xff,0xe5,0xff,0xd8,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xe5,0xff,0xdd,0xff,0xf1,0xff,0xb1,0xff,0xb9,0xff,0xe2,0xff,0xd5,0xff,0xe9,0xff,0xb4,0xff,0xf3,0xff,0xe7,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf6,0x00,0x00,0xff,0xf6,0xff,0xf6,0xff,0xf2,0x00,0x00,0x00,0x11,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf5,0xff,0xf3,0xff,0xf7,0x00,0x00,0x00,0x00,0xff,0xf5,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xec,0xff,0xe2,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xec,0x00,0x00,0xff,0xba,0xff,0xec,0xff,0xce,0x00,0x00,0xff,0xa6,0xff,0xd8,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xe2,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xd8,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf1,0x00,0x00,0xff,0xe4,0x00,0x00,0xff,0xf2,0xff,0xe4,0xff,0xdf,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf7,0x00,0x00,0xff,0xf6,0xff,0xf7,0xff,0xed,0xff,0xf8,0xff,0xeb,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf8,0x00,0x00,0xff,0xd1,0xff,0xe7,0xff,0xfa,0xff,0xf3,0x00,0x00,0xff,0xf6,0x00,0x00,0xff,0xf6,0x00,0x00,0xff,0xec,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xd4,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xec,0xff,0xfb,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xfa,0x00,0x00,0xff,0xf8,0xff,0xf8,0xff,0xf2,0x00,0x00,0xff,0xf3,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf9,0x00,0x00,0xff,0xb1,0xff,0xb2,0xff,0xf9,0x00,0x00,0xff,0xf9,0xff,0xe6,0x00,0x00,0xff,0xe9,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xdb,0x00,0x00,0xff,0xfa,0xff,0xf9,0xff,0xf8,0xff,0xf4,0x00,0x00,0xff,0xe6,0xff,0xf8,0x00,0x00,0xff,0xf7,0xff,0xf8,0x00,0x00,0xff,0xf8,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xea,0xff,0xf7,0xff,0xe0,0x00,0x00,0x00,0x00,0xff,0xf9,0xff,0xeb,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xc2,0xff,0xe8,0x00,0x00,0x00,0x00,0x00,0x25,0x00,0x23,0x00,0x2b,0x00,0x00,0x00,0x00,0xff,0xe2,0xff,0xfa,0xff,0xc0,0xff,0xf6,0xff,0xc4,0xff,0xc0,0x00,0x00,0x00,0x00,0x00,0x14,0x00,0x00,0x00,0x00,0xff,0xc1,0xff,0xc4,0xff,0xb9,0xff,0xcb,0xff,0xce,0xff,0xb4,0xff,0xbc,0xff,0xd7,0xff,0xb0,0xff,0xcd,0xff,0xdc,0x00,0x00,0x00,0x00,0xff,0xe2,0xff,0xce,0xff,0xc5,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xef,0x00,0x00,0xff,0xd3,0x00,0x00,0xff,0xf5,0xff,0xd4,0xff,0xde,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xfb,0x00,0x00,0xff,0xfb,0xff,0xfb,0x00,0x00,0x00,0x00,0xff,0xec,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xc5,0xff,0xdd,0x00,0x00,0xff,0xf6,0x00,0x00,0xff,0xf8,0x00,0x00,0xff,0xf6,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xec,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf8,0xff,0xf3,0x00,0x00,0xff,0xf1,0xff,0xee,0xff,0xee,0x00,0x00,0xff,0xf5,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf6,0xff,0xee,0xff,0xf8,0xff,0xf6,0x00,0x00,0xff,0xf0,0xff,0xf6,0x00,0x00,0xff,0xef,0x00,0x00,0xff,0xf2,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xd4,0xff,0xf3,0x00,0x1f,0x00,0x00,0x00,0x00,0x00,0x21,0x00,0x0a,0x00,0x00,0x00,0x00,0xff,0xf5,0xff,0xf8,0xff,0xdf,0xff,0xf6,0xff,0xd4,0xff,0xc9,0x00,0x08,0x00,0x00,0x00,0x0a,0x00,0x00,0x00,0x00,0xff,0xe8,0xff,0xd7,0xff,0xec,0xff,0xd0,0xff,0xbf,0xff,0xce,0xff,0xf1,0xff,0xf2,0xff,0xc9,0xff,0xf4,0xff,0xdd,0x00,0x00,0x00,0x00,0xff,0xef,0xff,0xf7,0xff,0xe1,0xff,0xfb,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0a,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf6,0x00,0x00,0xff,0xd3,0x00,0x00,0x00,0x00,0x00,0x0a,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xd8,0xff,0xf6,0x00,0x00,0xff,0xce,0xff,0xd8,0x00,0x00,0x00,0x00,0xff,0xd8,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x20,0xff,0xe4,0x00,0x20,0x00,0x00,0x00,0x20,0x00,0x1c,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf1,0x00,0x00,0xff,0xe1,0x00,0x00,0xff,0xf8,0xff,0xd8,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xd4,0xff,0xe1,0xff,0xda,0x00,0x00,0x00,0x00,0xff,0xf7,0x00,0x00,0xff,0xef,0xff,0xf6,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf1,0xff,0xfa,0x00,0x00,0x00,0x00,0xff,0xc4,0xff,0xe2,0x00,0x2a,0x00,0x00,0x00,0x0a,0x00,0x00,0x00,0x32,0x00,0x00,0x00,0x00,0xff,0xe8,0xff,0xf8,0xff,0xbe,0xff,0xf7,0xff,0xba,0xff,0xb5,0x00,0x1a,0x00,0x0c,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xc9,0xff,0xbc,0xff,0xdd,0xff,0xb8,0xff,0xce,0xff,0xab,0xff,0xd5,0xff,0xe6,0xff,0xaf,0xff,0xe0,0xff,0xd4,0x00,0x0a,0x00,0x00,0xff,0xdd,0xff,0xce,0xff,0xc5,0xff,0xf7,0x00,0x00,0x00,0x00,0xff,0xf9,0xff,0xf6,0xff,0xf6,0xff,0xf1,0xff,0xf7,0x00,0x00,0xff,0xf8,0x00,0x13,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x06,0x00,0x00,0x00,0x0e,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf8,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf7,0xff,0xf6,0x00,0x02,0x00,0x27,0x00,0x08,0x00,0x08,0x00,0x0a,0x00,0x26,0x00,0x26,0x00,0x01,0x00,0x27,0x00,0x27,0x00,0x02,0x00,0x28,0x00,0x28,0x00,0x08,0x00,0x29,0x00,0x29,0x00,0x03,0x00,0x2a,0x00,0x2a,0x00,0x04,0x00,0x2c,0x00,0x2d,0x00,0x05,0x00,0x2f,0x00,0x2f,0x00,0x06,0x00,0x30,0x00,0x30,0x00,0x07,0x00,0x31,0x00,0x32,0x00,0x05,0x00,0x33,0x00,0x33,0x00,0x08,0x00,0x34,0x00,0x34,0x00,0x09,0x00,0x35,0x00,0x35,0x00,0x08,0x00,0x37,0x00,0x37,0x00,0x0a,0x00,0x38,0x00,0x38,0x00,0x0b,0x00,0x39,0x00,0x39,0x00,0x0d,0x00,0x3a,0x00,0x3a,0x00,0x0e,0x00,0x3b,0x00,0x3b,0x00,0x0f,0x00,0x3c,0x00,0x3c,0x00,0x10,0x00,0x3d,0x00,0x3d,0x00,0x11,0x00,0x4d,0x00,0x4e,0x00,0x12,0x00,0x60,0x00,0x60,0x00,0x05,0x00,0x68,0x00,0x68,0x00,0x11,0x00,0x69,0x00,0x69,0x00,0x05,0x00,0x6c,0x00,0x6c,0x00,0x08,0x00,0x71,0x00,0x71,0x00,0x08,0x00,0x79,0x00,0x79,0x00,0x05,0x00,0x89,0x00,0x89,0x00,0x03,0x00,0x8a,0x00,0x8a,0x00,0x02,0x00,0x8b,0x00,0x8e,0x00,0x03,0x00,0x8f,0x00,0x92,0x00,0x05,0x00,0x93,0x00,0x93,0x00,0x08,0x00,0x94,0x00,0x94,0x00,0x05,0x00,0x95,0x00,0x99,0x00,0x08,0x00,0x9b,0x00,0x9b,0x00,0x08,0x00,0x9c,0x00,0x9f,0x00,0x0d,0x00,0xa0,0x00,0xa0,0x00,0x11,0x00,0xa1,0x00,0xa1,0x00,0x0c,0x00,0xaf,0x00,0xb2,0x00,0x12,0x00,0x01,0x00,0x08,0x00,0xbb,0x00,0x25,0x00,0x00,0x00,0x1c,0x00,0x00,0x00,0x00,0x00,0x11,0x00,0x08,0x00,0x00,0x00,0x19,0x00,0x0c,0x00,0x19,0x00,0x1f,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x23,0x00,0x23,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x12,0x00,0x22,0x00,0x01,0x00,0x26,0x00,0x02,0x00,0x26,0x00,0x26,0x00,0x26,0x00,0x02,0x00,0x26,0x00,0x26,0x00,0x21,0x00,0x26,0x00,0x26,0x00,0x26,0x00,0x26,0x00,0x02,0x00,0x26,0x00,0x02,0x00,0x26,0x00,0x25,0x00,0x03,0x00,0x04,0x00,0x05,0x00,0x20,0x00,0x06,0x00,0x07,0x00,0x00,0x00,0x00,0x00,0x09,0x00,0x11,0x00,0x08,0x00,0x19,0x00,0x00,0x00,0x1d,0x00,0x0b,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0a,0x00,0x0f,0x00,0x0b,0x00,0x0d,0x00,0x0d,0x00,0x0b,0x00,0x0b,0x00,0x0e,0x00,0x0e,0x00,0x0f,0x00,0x0e,0x00,0x0f,0x00,0x0e,0x00,0x1a,0x00,0x15,0x00,0x16,0x00,0x17,0x00,0x17,0x00,0x1b,0x00,0x17,0x00,0x00,0x00,0x00,0x00,0x26,0x00,0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0f,0x00,0x00,0x00,0x00,0x00,0x07,0x00,0x26,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x10,0x00,0x24,0x00,0x00,0x00,0x0c,0x00,0x02,0x00,0x00,0x00,0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x16,0x00,0x00,0x00,0x0c,0x00,0x00,0x00,0x00,0x00,0x10,0x00,0x1e,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x18,0x00,0x02,0x00,0x26,0x00,0x26,0x00,0x26,0x00,0x26,0x00,0x26,0x00,0x26,0x00,0x26,0x00,0x26,0x00,0x26,0x00,0x26,0x00,0x02,0x00,0x02,0x00,0x02,0x00,0x02,0x00,0x02,0x00,0x00,0x00,0x02,0x00,0x04,0x00,0x04,0x00,0x04,0x00,0x04,0x00,0x07,0x00,0x26,0x00,0x00,0x00,0x1d,0x00,0x1d,0x00,0x1d,0x00,0x1d,0x00,0x1d,0x00,0x1d,0x00,0x1d,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0d,0x00,0x0d,0x00,0x0d,0x00,0x0d,0x00,0x0f,0x00,0x0e,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x00,0x00,0x0f,0x00,0x16,0x00,0x16,0x00,0x16,0x00,0x16,0x00,0x17,0x00,0x0b,0x00,0x17,0x00,0x02,0x00,0x0e,0x00,0x08,0x00,0x08,0x00,0x00,0x00,0x25,0x00,0x2a,0x00,0x01,0x00,0x2c,0x00,0x2d,0x00,0x07,0x00,0x2f,0x00,0x35,0x00,0x09,0x00,0x37,0x00,0x3d,0x00,0x10,0x00,0x4d,0x00,0x4e,0x00,0x17,0x00,0x60,0x00,0x60,0x00,0x19,0x00,0x68,0x00,0x69,0x00,0x1a,0x00,0x6c,0x00,0x6c,0x00,0x1c,0x00,0x71,0x00,0x71,0x00,0x1d,0x00,0x79,0x00,0x79,0x00,0x1e,0x00,0x83,0x00,0x99,0x00,0x1f,0x00,0x9b,0x00,0xa1,0x00,0x36,0x00,0xaf,0x00,0xb2,0x00,0x3d,0x00,0x02,0x00,0x94,0x00,0x04,0x00,0x00,0x00,0x34,0x00,0x3c,0x00,0x02,0x00,0x09,0x00,0x00,0x00,0x13,0xff,0xd0,0xff,0xfb,0xff,0xd2,0xff,0xc8,0xff,0xf3,0xff,0xf1,0xff,0xe8,0x00,0x00,0x00,0x00,0xff,0xee,0x00,0x00,0x00,0x00,0xff,0xe8,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x24,0x00,0x01,0x00,0x01,0x00,0x02,0x00,0x0e,0x00,0x38,0x00,0x38,0x00,0x02,0x00,0x39,0x00,0x39,0x00,0x03,0x00,0x3a,0x00,0x3a,0x00,0x04,0x00,0x3d,0x00,0x3d,0x00,0x05,0x00,0x4a,0x00,0x4a,0x00,0x06,0x00,0x58,0x00,0x58,0x00,0x07,0x00,0x5a,0x00,0x5b,0x00,0x08,0x00,0x5d,0x00,0x5d,0x00,0x08,0x00,0x68,0x00,0x68,0x00,0x05,0x00,0x89,0x00,0x89,0x00,0x01,0x00,0x9c,0x00,0x9f,0x00,0x03,0x00,0xa0,0x00,0xa0,0x00,0x05,0x00,0xc0,0x00,0xc0,0x00,0x08,0x00,0xc2,0x00,0xc2,0x00,0x08,0x00,0x01,0x00,0x02,0x00,0x0a,0x00,0x24,0x00,0x02,0x04,0x66,0x00,0x04,0x00,0x00,0x02,0x80,0x02,0xea,0x00,0x0d,0x00,0x18,0x00,0x00,0xff,0xc4,0xff,0xcd,0xff,0xf6,0x00,0x14,0xff,0xf2,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x08,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf6,0xff,0xdc,0xff,0xf2,0xff,0xdd,0xff,0xd4,0xff,0xf6,0xff,0xed,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xce,0x00,0x00,0xff,0xf7,0xff,0xce,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xd0,0x00,0x00,0xff,0xf0,0xff,0xe0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xcd,0x00,0x00,0xff,0xf4,0xff,0xe0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xc5,0x00,0x00,0xff,0xe1,0xff,0xc5,0x00,0x00,0x00,0x00,0xff,0xf1,0xff,0xf3,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf2,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xc0,0x00,0x00,0xff,0xdf,0xff,0xbe,0xff,0xf4,0xff,0xf8,0xff,0xe1,0xff,0xea,0xff,0xed,0xff,0xf3,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf3,0x00,0x00,0xff,0xed,0x00,0x00,0xff,0xe5,0xff,0xeb,0x00,0x00,0xff,0xf4,0x00,0x00,0x00,0x0c,0xff,0xea,0xff,0xeb,0x00,0x00,0xff,0xf5,0x00,0x00,0xff,0xf3,0x00,0x11,0xff,0xee,0xff,0xed,0xff,0xe9,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf6,0xff,0xe7,0xff,0xce,0x00,0x00,0xff,0xbe,0xff,0xce,0x00,0x00,0xff,0xd8,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x1e,0xff,0xce,0x00,0x00,0x00,0x00,0xff,0xf1,0x00,0x00,0xff,0xeb,0xff,0xee,0xff,0xe7,0xff,0xea,0xff,0x9c,0xff,0xe7,0xff,0xa6,0xff,0xc9,0xff,0xec,0xff,0xeb,0x00,0x00,0xff,0xf5,0xff,0xf0,0xff,0xef,0xff,0xf0,0xff,0xee,0xff,0xed,0xff,0xe9,0xff,0xe2,0xff,0xa6,0xff,0xee,0x00,0x00,0xff,0xcd,0xff,0xc0,0xff,0xf2,0x00,0x00,0xff,0x89,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xd3,0xff,0xc7,0x00,0x00,0x00,0x00,0xff,0x84,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xe0,0xff,0xef,0xff,0xec,0x00,0x00,0xff,0xea,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf1,0xff,0xef,0xff,0xf2,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x11,0x00,0x05,0x00,0x05,0x00,0x03,0x00,0x0c,0x00,0x0c,0x00,0x07,0x00,0x10,0x00,0x10,0x00,0x08,0x00,0x11,0x00,0x11,0x00,0x06,0x00,0x12,0x00,0x12,0x00,0x08,0x00,0x13,0x00,0x13,0x00,0x0c,0x00,0x1e,0x00,0x1f,0x00,0x02,0x00,0x3f,0x00,0x3f,0x00,0x07,0x00,0x40,0x00,0x40,0x00,0x01,0x00,0x43,0x00,0x43,0x00,0x08,0x00,0x5f,0x00,0x5f,0x00,0x07,0x00,0x64,0x00,0x64,0x00,0x03,0x00,0x6e,0x00,0x6e,0x00,0x04,0x00,0x70,0x00,0x70,0x00,0x06,0x00,0x7a,0x00,0x7a,0x00,0x06,0x00,0x7e,0x00,0x7e,0x00,0x05,0x00,0x82,0x00,0x82,0x00,0x09,0x00,0x01,0x00,0x08,0x00,0xbb,0x00,0x0f,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x11,0x00,0x06,0x00,0x11,0x00,0x11,0x00,0x11,0x00,0x06,0x00,0x11,0x00,0x11,0x00,0x15,0x00,0x11,0x00,0x11,0x00,0x11,0x00,0x11,0x00,0x06,0x00,0x11,0x00,0x06,0x00,0x11,0x00,0x0f,0x00,0x07,0x00,0x08,0x00,0x09,0x00,0x16,0x00,0x0d,0x00,0x0a,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x03,0x00,0x17,0x00,0x05,0x00,0x05,0x00,0x05,0x00,0x10,0x00,0x05,0x00,0x17,0x00,0x04,0x00,0x04,0x00,0x17,0x00,0x17,0x00,0x12,0x00,0x12,0x00,0x05,0x00,0x12,0x00,0x05,0x00,0x12,0x00,0x13,0x00,0x0b,0x00,0x14,0x00,0x0c,0x00,0x0c,0x00,0x0e,0x00,0x0c,0x00,0x00,0x00,0x00,0x00,0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x05,0x00,0x00,0x00,0x00,0x00,0x0a,0x00,0x11,0x00,0x00,0x00,0x00,0x00,0x06,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x06,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x14,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x02,0x00,0x06,0x00,0x11,0x00,0x11,0x00,0x11,0x00,0x11,0x00,0x11,0x00,0x11,0x00,0x11,0x00,0x11,0x00,0x11,0x00,0x11,0x00,0x06,0x00,0x06,0x00,0x06,0x00,0x06,0x00,0x06,0x00,0x00,0x00,0x06,0x00,0x08,0x00,0x08,0x00,0x08,0x00,0x08,0x00,0x0a,0x00,0x11,0x00,0x00,0x00,0x03,0x00,0x03,0x00,0x03,0x00,0x03,0x00,0x03,0x00,0x03,0x00,0x03,0x00,0x05,0x00,0x05,0x00,0x05,0x00,0x05,0x00,0x05,0x00,0x04,0x00,0x04,0x00,0x04,0x00,0x04,0x00,0x05,0x00,0x12,0x00,0x05,0x00,0x05,0x00,0x05,0x00,0x05,0x00,0x05,0x00,0x00,0x00,0x05,0x00,0x14,0x00,0x14,0x00,0x14,0x00,0x14,0x00,0x0c,0x00,0x17,0x00,0x0c,0x00,0x01,0x00,0x14,0x00,0x05,0x00,0x0c,0x00,0x0e,0x00,0x10,0x00,0x11,0x00,0x12,0x00,0x13,0x00,0x1e,0x00,0x1f,0x00,0x3f,0x00,0x40,0x00,0x42,0x00,0x43,0x00,0x5f,0x00,0x64,0x00,0x6e,0x00,0x70,0x00,0x7a,0x00,0x7e,0x00,0x82,0x00,0x02,0x06,0x0e,0x00,0x04,0x00,0x00,0x03,0xd0,0x04,0x8e,0x00,0x0f,0x00,0x20,0x00,0x00,0xff,0xf5,0xff,0xf5,0xff,0xa0,0xff,0xf7,0xff,0xe1,0xff,0xba,0xff,0xef,0xff,0xf4,0xff,0xfc,0xff,0xf4,0xff,0xf6,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xfb,0xff,0xf5,0xff,0xaf,0xff,0xf3,0xff,0xca,0xff,0xad,0xff,0xfa,0x00,0x00,0x00,0x00,0xff,0xeb,0xff,0xeb,0xff,0xfb,0xff,0xf5,0xff,0xf0,0xff,0xf5,0xff,0xed,0xff,0xef,0xff,0xf4,0xff,0xf5,0xff,0xfb,0xff,0xfa,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x07,0x00,0x13,0xff,0xed,0xff,0xe1,0xff,0xe3,0x00,0x00,0x00,0x14,0xff,0xd3,0x00,0x00,0x00,0x00,0x00,0x0a,0x00,0x00,0x00,0x14,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xfb,0xff,0xf0,0xff,0xf6,0xff,0xf1,0xff,0xe2,0xff,0xef,0xff,0xf6,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf7,0xff,0xef,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xfa,0xff,0xfa,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xfc,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf7,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf6,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xfb,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf5,0xff,0xf7,0xff,0xf7,0xff,0xee,0xff,0xf5,0xff,0xf5,0xff,0xf7,0xff,0xc4,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf8,0xff,0xf6,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0b,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf6,0xff,0xed,0xff,0xc0,0xff,0xeb,0xff,0xcc,0xff,0xbe,0xff,0xfa,0x00,0x00,0x00,0x00,0xff,0xe8,0xff,0xec,0xff,0xf2,0xff,0xf2,0xff,0xfa,0xff,0xf3,0xff,0xea,0xff,0xee,0xff,0xf2,0xff,0xf5,0xff,0xf7,0x00,0x00,0x00,0x00,0xff,0xf3,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf4,0x00,0x00,0x00,0x00,0xff,0xfc,0x00,0x00,0x00,0x00,0xff,0xfa,0xff,0xf2,0xff,0xaa,0xff,0xf1,0xff,0xcb,0xff,0xa9,0xff,0xfb,0x00,0x00,0x00,0x00,0xff,0xe9,0xff,0xe5,0xff,0xf4,0xff,0xf2,0xff,0xd7,0xff,0xf2,0xff,0xea,0xff,0xec,0xff,0xf0,0xff,0xf1,0xff,0xf9,0xff,0xf3,0x00,0x00,0xff,0xfb,0x00,0x00,0xff,0xf6,0x00,0x00,0xff,0xfc,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf3,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf1,0x00,0x00,0xff,0xeb,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xe2,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf7,0xff,0xfa,0xff,0xb2,0xff,0xf0,0xff,0xcb,0xff,0xb0,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xea,0xff,0xed,0x00,0x00,0xff,0xf5,0xff,0xf4,0x00,0x00,0xff,0xef,0xff,0xef,0x00,0x00,0x00,0x00,0xff,0xfc,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xfc,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xb7,0xff,0xf9,0xff,0xee,0xff,0xd3,0xff,0xf5,0x00,0x00,0xff,0xf9,0xff,0xf8,0xff,0xf5,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xfb,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf7,0xff,0xf8,0xff,0xc5,0xff,0xee,0xff,0xe1,0xff,0xc5,0xff,0xf9,0x00,0x00,0x00,0x00,0xff,0xee,0xff,0xee,0xff,0xfa,0xff,0xf6,0xff,0xf1,0x00,0x00,0xff,0xf1,0x00,0x00,0xff,0xea,0x00,0x00,0x00,0x00,0xff,0xf3,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xcf,0xff,0xf8,0xff,0xf4,0xff,0xdd,0xff,0xf2,0xff,0xf8,0xff,0xf9,0x00,0x00,0xff,0xec,0xff,0xdc,0xff,0xf7,0xff,0xda,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x12,0xff,0xfa,0x00,0x00,0x00,0x00,0xff,0xd8,0xff,0xed,0x00,0x15,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0xf3,0x00,0x00,0xff,0xbc,0xff,0xf6,0xff,0xf1,0xff,0xd5,0xff,0xed,0xff,0xe9,0xff,0xf3,0xff,0xf8,0xff,0xf5,0x00,0x00,0xff,0xfb,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x10,0x00,0x0e,0x00,0x00,0x00,0x15,0xff,0xf3,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x1f,0x00,0x45,0x00,0x45,0x00,0x07,0x00,0x46,0x00,0x46,0x00,0x08,0x00,0x48,0x00,0x48,0x00,0x05,0x00,0x49,0x00,0x49,0x00,0x01,0x00,0x4a,0x00,0x4a,0x00,0x02,0x00,0x4b,0x00,0x4b,0x00,0x0c,0x00,0x4c,0x00,0x4c,0x00,0x07,0x00,0x4f,0x00,0x4f,0x00,0x04,0x00,0x50,0x00,0x50,0x00,0x05,0x00,0x51,0x00,0x52,0x00,0x07,0x00,0x53,0x00,0x54,0x00,0x08,0x00,0x55,0x00,0x55,0x00,0x0c,0x00,0x56,0x00,0x56,0x00,0x09,0x00,0x57,0x00,0x57,0x00,0x0a,0x00,0x58,0x00,0x58,0x00,0x0b,0x00,0x59,0x00,0x59,0x00,0x0c,0x00,0x5a,0x00,0x5b,0x00,0x0d,0x00,0x5c,0x00,0x5c,0x00,0x0e,0x00,0x5d,0x00,0x5d,0x00,0x0d,0x00,0xa2,0x00,0xa2,0x00,0x03,0x00,0xa3,0x00,0xa8,0x00,0x07,0x00,0xa9,0x00,0xa9,0x00,0x01,0x00,0xab,0x00,0xae,0x00,0x01,0x00,0xb3,0x00,0xb3,0x00,0x08,0x00,0xb4,0x00,0xb4,0x00,0x07,0x00,0xb5,0x00,0xb9,0x00,0x08,0x00,0xbb,0x00,0xbb,0x00,0x08,0x00,0xbc,0x00,0xbf,0x00,0x0c,0x00,0xc0,0x00,0xc0,0x00,0x0d,0x00,0xc1,0x00,0xc1,0x00,0x08,0x00,0xc2,0x00,0xc2,0x00,0x0d,0x00,0x01,0x00,0x06,0x00,0xbd,0x00,0x1f,0x00,0x00,0x00,0x02,0x00,0x00,0x00,0x07,0x00,0x1f,0x00,0x00,0x00,0x0b,0x00,0x0f,0x00,0x00,0x00,0x19,0x00,0x08,0x00,0x19,0x00,0x1a,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x11,0x00,0x00,0x00,0x0c,0x00,0x0d,0x00,0x01,0x00,0x0d,0x00,0x0d,0x00,0x0d,0x00,0x01,0x00,0x0d,0x00,0x0d,0x00,0x00,0x00,0x0d,0x00,0x0d,0x00,0x0d,0x00,0x0d,0x00,0x01,0x00,0x0d,0x00,0x01,0x00,0x0d,0x00,0x02,0x00,0x03,0x00,0x04,0x00,0x05,0x00,0x00,0x00,0x0e,0x00,0x06,0x00,0x00,0x00,0x00,0x00,0x10,0x00,0x0b,0x00,0x0f,0x00,0x19,0x00,0x00,0x00,0x16,0x00,0x00,0x00,0x09,0x00,0x09,0x00,0x09,0x00,0x17,0x00,0x09,0x00,0x00,0x00,0x1d,0x00,0x1d,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x09,0x00,0x00,0x00,0x09,0x00,0x00,0x00,0x1c,0x00,0x1b,0x00,0x1e,0x00,0x14,0x00,0x14,0x00,0x15,0x00,0x14,0x00,0x00,0x00,0x00,0x00,0x0d,0x00,0x0b,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x09,0x00,0x00,0x00,0x00,0x00,0x06,0x00,0x0d,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x0a,0x00,0x18,0x00,0x00,0x00,0x08,0x00,0x01,0x00,0x00,0x00,0x0a,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x1e,0x00,0x00,0x00,0x08,0x00,0x00,0x00,0x00,0x00,0x0a,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0c,0x00,0x0c,0x00,0x0c,0x00,0x0c,0x00,0x0c,0x00,0x0c,0x00,0x00,0x00,0x01,0x00,0x0d,0x00,0x0d,0x00,0x0d,0x00,0x0d,0x00,0x0d,0x00,0x0d,0x00,0x0d,0x00,0x0d,0x00,0x0d,0x00,0x0d,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x00,0x00,0x01,0x00,0x04,0x00,0x04,0x00,0x04,0x00,0x04,0x00,0x06,0x00,0x0d,0x00,0x00,0x00,0x16,0x00,0x16,0x00,0x16,0x00,0x16,0x00,0x16,0x00,0x16,0x00,0x16,0x00,0x09,0x00,0x09,0x00,0x09,0x00,0x09,0x00,0x09,0x00,0x1d,0x00,0x1d,0x00,0x1d,0x00,0x1d,0x00,0x09,0x00,0x00,0x00,0x09,0x00,0x09,0x00,0x09,0x00,0x09,0x00,0x09,0x00,0x00,0x00,0x09,0x00,0x1e,0x00,0x1e,0x00,0x1e,0x00,0x1e,0x00,0x14,0x00,0x00,0x00,0x14,0x00,0x02,0x00,0x06,0x00,0x45,0x00,0x4c,0x00,0x00,0x00,0x4f,0x00,0x5d,0x00,0x08,0x00,0x65,0x00,0x65,0x00,0x17,0x00,0xa2,0x00,0xae,0x00,0x18,0x00,0xb3,0x00,0xb9,0x00,0x25,0x00,0xbb,0x00,0xc2,0x00,0x2c,0x00,0x02,0x00,0x3c,0x00,0x04,0x00,0x00,0x00,0x1c,0x00,0x26,0x00,0x03,0x00,0x02,0x00,0x00,0xff,0xec,0x00,0x00,0x00,0x14,0x00,0x00,0xff,0xf6,0x00,0x01,0x00,0x1a,0x00,0x02,0x00,0x02,0x00,0x01,0x00,0x02,0x00,0x03,0x00,0x6d,0x00,0x6d,0x00,0x01,0x00,0x73,0x00,0x73,0x00,0x01,0x00,0x7d,0x00,0x7d,0x00,0x01,0x00,0x01,0x00,0x03,0x00,0x19,0x00,0x1a,0x00,0x1b,0x00,0x02,0x00,0x3c,0x00,0x04,0x00,0x00,0x00,0x18,0x00,0x20,0x00,0x01,0x00,0x04,0x00,0x00,0xff,0xe2,0xff,0xe2,0xff,0xd8,0x00,0x01,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x02,0x00,0x04,0x00,0x18,0x00,0x18,0x00,0x03,0x00,0x25,0x00,0x25,0x00,0x01,0x00,0x83,0x00,0x88,0x00,0x01,0x00,0x89,0x00,0x89,0x00,0x02,0x00,0x01,0x00,0x03,0x00,0x6d,0x00,0x73,0x00,0x7d,0x00,0x01,0x01,0xd4,0x00,0x05,0x00,0x00,0x00,0xd8,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x01,0xba,0x00,0x04,0x00,0x11,0xff,0xec,0xff,0xec,0x00,0x40,0xff,0xf6,0xff,0xf6,0x00,0x70,0xff,0xec,0xff,0xec,0x00,0x7a,0xff,0xec,0xff,0xec,0x00,0x02,0x00,0x01,0x00,0x02,0x00,0xd9,0x00,0x00,0x00,0x01,0x00,0x24,0x00,0x1e,0x00,0x02,0x00,0x3a,0x00,0x0c,0x00,0x01,0x00,0x06,0x00,0x0c,0x00,0x01,0x01,0x34,0x00,0x00,0x00,0x01,0x01,0x34,0x02,0xba,0x00,0x01,0x00,0x01,0x00,0x08,0x00,0x02,0x00,0x03,0x00,0xc3,0x00,0xd1,0x00,0x00,0x00,0xd3,0x00,0xd6,0x00,0x0f,0x00,0xd8,0x00,0xd9,0x00,0x13,0x00,0x15,0x00,0x01,0x00,0x56,0x00,0x01,0x00,0x5c,0x00,0x01,0x00,0x62,0x00,0x01,0x00,0x68,0x00,0x01,0x00,0x6e,0x00,0x01,0x00,0x74,0x00,0x01,0x00,0x7a,0x00,0x01,0x00,0x80,0x00,0x01,0x00,0x86,0x00,0x01,0x00,0x8c,0x00,0x01,0x00,0x92,0x00,0x01,0x00,0x98,0x00,0x01,0x00,0x9e,0x00,0x01,0x00,0xa4,0x00,0x01,0x00,0xaa,0x00,0x00,0x00,0xb0,0x00,0x00,0x00,0xb6,0x00,0x00,0x00,0xbc,0x00,0x00,0x00,0xc2,0x00,0x00,0x00,0xc8,0x00,0x00,0x00,0xce,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0x0e,0x08,0x0d,0xce,0x00,0x04,0x0e,0x12,0x00,0x0c,0x00,0x6e,0x03,0x72,0x03,0x78,0x03,0x7e,0x03,0x84,0x03,0x8a,0x03,0x90,0x03,0x96,0x03,0x9c,0x03,0xa2,0x03,0xa8,0x03,0xae,0x03,0xb4,0x03,0xba,0x03,0xc0,0x03,0xc6,0x03,0xcc,0x03,0xd2,0x03,0xd8,0x03,0xde,0x03,0xe4,0x03,0xea,0x03,0xf0,0x03,0xf6,0x03,0xfc,0x04,0x02,0x04,0x08,0x04,0x0e,0x04,0x14,0x04,0x1a,0x04,0x20,0x04,0x26,0x04,0x2c,0x04,0x32,0x04,0x38,0x04,0x3e,0x04,0x44,0x04,0x4a,0x04,0x50,0x04,0x56,0x04,0x5c,0x04,0x62,0x04,0x68,0x04,0x6e,0x04,0x74,0x04,0x7a,0x04,0x80,0x04,0x86,0x04,0x8c,0x04,0x92,0x04,0x98,0x04,0x9e,0x04,0xa4,0x04,0xaa,0x04,0xb0,0x04,0xb6,0x04,0xbc,0x04,0xc2,0x04,0xc8,0x04,0xce,0x04,0xd4,0x04,0xda,0x04,0xe0,0x04,0xe6,0x04,0xec,0x04,0xf2,0x04,0xf8,0x04,0xfe,0x05,0x04,0x05,0x0a,0x05,0x10,0x05,0x16,0x05,0x1c,0x05,0x22,0x05,0x28,0x05,0x2e,0x05,0x34,0x05,0x3a,0x05,0x40,0x05,0x46,0x05,0x4c,0x05,0x52,0x05,0x58,0x05,0x5e,0x05,0x64,0x05,0x6a,0x05,0x70,0x05,0x76,0x05,0x7c,0x05,0x82,0x05,0x88,0x05,0x8e,0x05,0x94,0x05,0x9a,0x05,0xa0,0x05,0xa6,0x05,0xac,0x05,0xb2,0x05,0xb8,0x05,0xbe,0x05,0xc4,0x05,0xca,0x05,0xd0,0x05,0xd6,0x05,0xdc,0x05,0xe2,0x05,0xe8,0x05,0xee,0x05,0xf4,0x05,0xfa,0x06,0x00,0x06,0x06,0x06,0x0c,0x06,0x12,0x06,0x18,0x06,0x1e,0x06,0x24,0x06,0x2a,0x06,0x30,0x06,0x36,0x06,0x3c,0x06,0x42,0x06,0x48,0x06,0x4e,0x06,0x54,0x06,0x5a,0x06,0x60,0x06,0x66,0x06,0x6c,0x06,0x72,0x06,0x78,0x06,0x7e,0x06,0x84,0x06,0x8a,0x06,0x90,0x06,0x96,0x06,0x9c,0x06,0xa2,0x06,0xa8,0x06,0xae,0x06,0xb4,0x06,0xba,0x06,0xc0,0x06,0xc6,0x06,0xcc,0x06,0xd2,0x06,0xd8,0x06,0xde,0x06,0xe4,0x06,0xea,0x06,0xf0,0x06,0xf6,0x06,0xfc,0x07,0x02,0x07,0x08,0x07,0x0e,0x07,0x14,0x07,0x1a,0x07,0x20,0x07,0x26,0x07,0x2c,0x07,0x32,0x07,0x38,0x07,0x3e,0x07,0x44,0x07,0x4a,0x07,0x50,0x07,0x56,0x07,0x5c,0x07,0x62,0x07,0x68,0x07,0x6e,0x07,0x74,0x07,0x7a,0x07,0x80,0x07,0x86,0x07,0x8c,0x07,0x92,0x07,0x98,0x07,0x9e,0x07,0xa4,0x07,0xaa,0x07,0xb0,0x07,0xb6,0x07,0xbc,0x07,0xc2,0x07,0xc8,0x07,0xce,0x07,0xd4,0x07,0xda,0x07,0xe0,0x07,0xe6,0x07,0xec,0x07,0xf2,0x07,0xf8,0x07,0xfe,0x08,0x04,0x08,0x0a,0x08,0x10,0x08,0x16,0x08,0x1c,0x08,0x22,0x08,0x28,0x08,0x2e,0x08,0x34,0x08,0x3a,0x08,0x40,0x08,0x46,0x08,0x4c,0x08,0x52,0x08,0x58,0x08,0x5e,0x08,0x64,0x08,0x6a,0x08,0x70,0x08,0x76,0x08,0x7c,0x08,0x82,0x08,0x88,0x08,0x8e,0x08,0x94,0x08,0x9a,0x08,0xa0,0x08,0xa6,0x08,0xac,0x08,0xb2,0x08,0xb8,0x08,0xbe,0x08,0xc4,0x08,0xca,0x08,0xd0,0x08,0xd6,0x08,0xdc,0x08,0xe2,0x08,0xe8,0x08,0xee,0x08,0xf4,0x08,0xfa,0x09,0x00,0x09,0x06,0x09,0x0c,0x09,0x12,0x09,0x18,0x09,0x1e,0x09,0x24,0x09,0x2a,0x09,0x30,0x09,0x36,0x09,0x3c,0x09,0x42,0x09,0x48,0x09,0x4e,0x09,0x54,0x09,0x5a,0x09,0x60,0x09,0x66,0x09,0x6c,0x09,0x72,0x09,0x78,0x09,0x7e,0x09,0x84,0x09,0x8a,0x09,0x90,0x09,0x96,0x09,0x9c,0x09,0xa2,0x09,0xa8,0x09,0xae,0x09,0xb4,0x09,0xba,0x09,0xc0,0x09,0xc6,0x09,0xcc,0x09,0xd2,0x09,0xd8,0x09,0xde,0x09,0xe4,0x09,0xea,0x09,0xf0,0x09,0xf6,0x09,0xfc,0x0a,0x02,0x0a,0x08,0x0a,0x0e,0x0a,0x14,0x0a,0x1a,0x0a,0x20,0x0a,0x26,0x0a,0x2c,0x0a,0x32,0x0a,0x38,0x0a,0x3e,0x0a,0x44,0x0a,0x4a,0x0a,0x50,0x0a,0x56,0x0a,0x5c,0x0a,0x62,0x0a,0x68,0x0a,0x6e,0x0a,0x74,0x0a,0x7a,0x0a,0x80,0x0a,0x86,0x0a,0x8c,0x0a,0x92,0x0a,0x98,0x0a,0x9e,0x0a,0xa4,0x0a,0xaa,0x0a,0xb0,0x0a,0xb6,0x0a,0xbc,0x0a,0xc2,0x0a,0xc8,0x0a,0xce,0x0a,0xd4,0x0a,0xda,0x0a,0xe0,0x0a,0xe6,0x0a,0xec,0x0a,0xf2,0x0a,0xf8,0x0a,0xfe,0x0b,0x04,0x0b,0x0a,0x0b,0x10,0x0b,0x16,0x0b,0x1c,0x0b,0x22,0x0b,0x28,0x0b,0x2e,0x0b,0x34,0x0b,0x3a,0x0b,0x40,0x0b,0x46,0x0b,0x4c,0x0b,0x52,0x0b,0x58,0x0b,0x5e,0x0b,0x64,0x0b,0x6a,0x0b,0x70,0x0b,0x76,0x0b,0x7c,0x0b,0x82,0x0b,0x88,0x0b,0x8e,0x0b,0x94,0x0b,0x9a,0x0b,0xa0,0x0b,0xa6,0x0b,0xac,0x0b,0xb2,0x0b,0xb8,0x0b,0xbe,0x0b,0xc4,0x0b,0xca,0x0b,0xd0,0x0b,0xd6,0x0b,0xdc,0x0b,0xe2,0x0b,0xe8,0x0b,0xee,0x0b,0xf4,0x0b,0xfa,0x0c,0x00,0x0c,0x06,0x0c,0x0c,0x0c,0x12,0x0c,0x18,0x0c,0x1e,0x0c,0x24,0x0c,0x2a,0x0c,0x30,0x0c,0x36,0x0c,0x3c,0x0c,0x42,0x0c,0x48,0x0c,0x4e,0x0c,0x54,0x0c,0x5a,0x0c,0x60,0x0c,0x66,0x0c,0x6c,0x0c,0x72,0x0c,0x78,0x0c,0x7e,0x0c,0x84,0x0c,0x8a,0x0c,0x90,0x0c,0x96,0x0c,0x9c,0x0c,0xa2,0x0c,0xa8,0x0c,0xae,0x0c,0xb4,0x0c,0xba,0x0c,0xc0,0x0c,0xc6,0x0c,0xcc,0x0c,0xd2,0x0c,0xd8,0x0c,0xde,0x0c,0xe4,0x0c,0xea,0x0c,0xf0,0x0c,0xf6,0x0c,0xfc,0x0d,0x02,0x0d,0x08,0x0d,0x0e,0x0d,0x14,0x0d,0x1a,0x0d,0x20,0x0d,0x26,0x0d,0x2c,0x0d,0x32,0x0d,0x38,0x0d,0x3e,0x0d,0x44,0x0d,0x4a,0x0d,0x50,0x0d,0x56,0x0d,0x5c,0x0d,0x62,0x0d,0x68,0x0d,0x6e,0x0d,0x74,0x0d,0x7a,0x0d,0x80,0x0d,0x86,0x0d,0x8c,0x0d,0x92,0x0d,0x98,0x0d,0x9e,0x0d,0xa4,0x0d,0xaa,0x0d,0xb0,0x0d,0xb6,0x0d,0xbc,0x00,0x01,0x01,0x75,0x00,0x00,0x00,0x01,0x02,0xad,0x00,0x0a,0x00,0x01,0x01,0x75,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x5b,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x5b,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x8b,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x8b,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x77,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x77,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x56,0x00,0x00,0x00,0x01,0x02,0x3b,0x00,0x0a,0x00,0x01,0x01,0x56,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x31,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x31,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x96,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x96,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x7a,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x7a,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x8f,0x00,0x00,0x00,0x01,0x00,0xb0,0x00,0x0a,0x00,0x01,0x00,0x8f,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0xea,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x48,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x4f,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x4f,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x49,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x8e,0x02,0xba,0x00,0x01,0x01,0x2d,0x02,0xba,0x00,0x01,0x01,0xe3,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0xe3,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x92,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x92,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x96,0x00,0x00,0x00,0x01,0x02,0x13,0x00,0x0a,0x00,0x01,0x01,0x96,0x02,0xba,0x00,0x01,0x02,0x19,0x02,0xba,0x00,0x01,0x01,0x4f,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x4f,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x96,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x96,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x64,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x64,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x34,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x34,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x31,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x31,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x7b,0x00,0x00,0x00,0x01,0x01,0xea,0x00,0x0a,0x00,0x01,0x01,0x7b,0x02,0xba,0x00,0x01,0x02,0x6c,0x02,0xba,0x00,0x01,0x01,0x5b,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x5b,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0xfa,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0xfa,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x50,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x50,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x40,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x40,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x3f,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x3f,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x1d,0x00,0x00,0x00,0x01,0x01,0xdb,0x00,0x0a,0x00,0x01,0x01,0x17,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x4b,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x55,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x2a,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x2a,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x3c,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x3c,0x01,0xfe,0x00,0x01,0x02,0x46,0x02,0xdc,0x00,0x01,0x01,0x1d,0x00,0x00,0x00,0x01,0x01,0xae,0x00,0x0a,0x00,0x01,0x01,0x1d,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0xa3,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0xbe,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x3c,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x3c,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x31,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x33,0x02,0xdc,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x7d,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x11,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x11,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x7d,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x7d,0x02,0xdc,0x00,0x01,0x00,0xc8,0x02,0xdc,0x00,0x01,0x01,0xcb,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0xcb,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x31,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x31,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x30,0x00,0x00,0x00,0x01,0x01,0x9a,0x00,0x0a,0x00,0x01,0x01,0x30,0x01,0xfe,0x00,0x01,0x01,0x7a,0x01,0xfe,0x00,0x01,0x01,0x3c,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x3c,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x3c,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x3c,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x7c,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0xd0,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0xed,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0xed,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0xda,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0xb5,0x02,0x5d,0x00,0x01,0x00,0xf0,0x02,0xdc,0x00,0x01,0x01,0x31,0x00,0x00,0x00,0x01,0x02,0x06,0x00,0x0a,0x00,0x01,0x01,0x31,0x01,0xfe,0x00,0x01,0x01,0xe5,0x01,0xfe,0x00,0x01,0x01,0x09,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x09,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x8c,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x8c,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x0e,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x0e,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x8f,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x0d,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0xfb,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0xfb,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x75,0x00,0x00,0x00,0x01,0x02,0xad,0x00,0x0a,0x00,0x01,0x01,0x75,0x03,0x51,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x75,0x00,0x00,0x00,0x01,0x02,0xad,0x00,0x0a,0x00,0x01,0x01,0x75,0x03,0x51,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x75,0x00,0x00,0x00,0x01,0x02,0xad,0x00,0x0a,0x00,0x01,0x01,0x75,0x03,0x5b,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x75,0x00,0x00,0x00,0x01,0x02,0xad,0x00,0x0a,0x00,0x01,0x01,0x75,0x03,0x3d,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x75,0x00,0x00,0x00,0x01,0x02,0xad,0x00,0x0a,0x00,0x01,0x01,0x75,0x03,0x3d,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x75,0x00,0x00,0x00,0x01,0x02,0xad,0x00,0x0a,0x00,0x01,0x01,0x75,0x03,0x70,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x02,0x21,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x02,0x21,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x8b,0xff,0x23,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x8b,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x56,0x00,0x00,0x00,0x01,0x02,0x3b,0x00,0x0a,0x00,0x01,0x01,0x56,0x03,0x51,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x56,0x00,0x00,0x00,0x01,0x02,0x3b,0x00,0x0a,0x00,0x01,0x01,0x56,0x03,0x51,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x56,0x00,0x00,0x00,0x01,0x02,0x3b,0x00,0x0a,0x00,0x01,0x01,0x56,0x03,0x5b,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x56,0x00,0x00,0x00,0x01,0x02,0x3b,0x00,0x0a,0x00,0x01,0x01,0x56,0x03,0x3d,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x8f,0x00,0x00,0x00,0x01,0x00,0xb0,0x00,0x0a,0x00,0x01,0x00,0x8f,0x03,0x51,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x8f,0x00,0x00,0x00,0x01,0x00,0xb0,0x00,0x0a,0x00,0x01,0x00,0x8f,0x03,0x51,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x8f,0x00,0x00,0x00,0x01,0x00,0xb0,0x00,0x0a,0x00,0x01,0x00,0x8f,0x03,0x5b,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x8f,0x00,0x00,0x00,0x01,0x00,0xb0,0x00,0x0a,0x00,0x01,0x00,0x8f,0x03,0x3d,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x92,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x92,0x03,0x3d,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x96,0x00,0x00,0x00,0x01,0x02,0x13,0x00,0x0a,0x00,0x01,0x01,0x96,0x03,0x51,0x00,0x01,0x02,0x19,0x02,0xba,0x00,0x01,0x01,0x96,0x00,0x00,0x00,0x01,0x02,0x13,0x00,0x0a,0x00,0x01,0x01,0x96,0x03,0x51,0x00,0x01,0x02,0x19,0x02,0xba,0x00,0x01,0x01,0x96,0x00,0x00,0x00,0x01,0x02,0x13,0x00,0x0a,0x00,0x01,0x01,0x96,0x03,0x5b,0x00,0x01,0x02,0x19,0x02,0xba,0x00,0x01,0x01,0x96,0x00,0x00,0x00,0x01,0x02,0x13,0x00,0x0a,0x00,0x01,0x01,0x96,0x03,0x3d,0x00,0x01,0x02,0x19,0x02,0xba,0x00,0x01,0x01,0x96,0x00,0x00,0x00,0x01,0x02,0x13,0x00,0x0a,0x00,0x01,0x01,0x96,0x03,0x3d,0x00,0x01,0x02,0x19,0x02,0xba,0x00,0x01,0x01,0x96,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x96,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x7b,0x00,0x00,0x00,0x01,0x01,0xea,0x00,0x0a,0x00,0x01,0x01,0x7b,0x03,0x51,0x00,0x01,0x02,0x6c,0x02,0xba,0x00,0x01,0x01,0x7b,0x00,0x00,0x00,0x01,0x01,0xea,0x00,0x0a,0x00,0x01,0x01,0x7b,0x03,0x51,0x00,0x01,0x02,0x6c,0x02,0xba,0x00,0x01,0x01,0x7b,0x00,0x00,0x00,0x01,0x01,0xea,0x00,0x0a,0x00,0x01,0x01,0x7b,0x03,0x5b,0x00,0x01,0x02,0x6c,0x02,0xba,0x00,0x01,0x01,0x7b,0x00,0x00,0x00,0x01,0x01,0xea,0x00,0x0a,0x00,0x01,0x01,0x7b,0x03,0x3d,0x00,0x01,0x02,0x6c,0x02,0xba,0x00,0x01,0x01,0x40,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x40,0x03,0x51,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x50,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x50,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x1d,0x00,0x00,0x00,0x01,0x01,0xdb,0x00,0x0a,0x00,0x01,0x01,0x17,0x02,0xaf,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x1d,0x00,0x00,0x00,0x01,0x01,0xdb,0x00,0x0a,0x00,0x01,0x01,0x17,0x02,0xaf,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x1d,0x00,0x00,0x00,0x01,0x01,0xdb,0x00,0x0a,0x00,0x01,0x01,0x17,0x02,0xa5,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x1d,0x00,0x00,0x00,0x01,0x01,0xdb,0x00,0x0a,0x00,0x01,0x01,0x17,0x02,0x91,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x1d,0x00,0x00,0x00,0x01,0x01,0xdb,0x00,0x0a,0x00,0x01,0x01,0x17,0x02,0x87,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x1d,0x00,0x00,0x00,0x01,0x01,0xdb,0x00,0x0a,0x00,0x01,0x01,0x17,0x02,0xba,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0xcd,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0xc7,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x2a,0xff,0x23,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x2a,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x1d,0x00,0x00,0x00,0x01,0x01,0xae,0x00,0x0a,0x00,0x01,0x01,0x1d,0x02,0xaf,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x1d,0x00,0x00,0x00,0x01,0x01,0xae,0x00,0x0a,0x00,0x01,0x01,0x1d,0x02,0xaf,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x1d,0x00,0x00,0x00,0x01,0x01,0xae,0x00,0x0a,0x00,0x01,0x01,0x1d,0x02,0xa5,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x1d,0x00,0x00,0x00,0x01,0x01,0xae,0x00,0x0a,0x00,0x01,0x01,0x1d,0x02,0x87,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x7d,0x00,0x00,0x00,0x01,0x00,0x9e,0x00,0x0a,0x00,0x01,0x00,0x7d,0x02,0xaf,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x7d,0x00,0x00,0x00,0x01,0x00,0x9e,0x00,0x0a,0x00,0x01,0x00,0x7d,0x02,0xaf,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x7d,0x00,0x00,0x00,0x01,0x00,0x9e,0x00,0x0a,0x00,0x01,0x00,0x7d,0x02,0xa5,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x7d,0x00,0x00,0x00,0x01,0x00,0x9e,0x00,0x0a,0x00,0x01,0x00,0x7d,0x02,0x87,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x31,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x31,0x02,0x91,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x30,0x00,0x00,0x00,0x01,0x01,0x9a,0x00,0x0a,0x00,0x01,0x01,0x30,0x02,0xaf,0x00,0x01,0x01,0x7a,0x01,0xfe,0x00,0x01,0x01,0x30,0x00,0x00,0x00,0x01,0x01,0x9a,0x00,0x0a,0x00,0x01,0x01,0x30,0x02,0xaf,0x00,0x01,0x01,0x7a,0x01,0xfe,0x00,0x01,0x01,0x30,0x00,0x00,0x00,0x01,0x01,0x9a,0x00,0x0a,0x00,0x01,0x01,0x30,0x02,0xa5,0x00,0x01,0x01,0x7a,0x01,0xfe,0x00,0x01,0x01,0x30,0x00,0x00,0x00,0x01,0x01,0x9a,0x00,0x0a,0x00,0x01,0x01,0x30,0x02,0x91,0x00,0x01,0x01,0x7a,0x01,0xfe,0x00,0x01,0x01,0x30,0x00,0x00,0x00,0x01,0x01,0x9a,0x00,0x0a,0x00,0x01,0x01,0x30,0x02,0x87,0x00,0x01,0x01,0x7a,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x30,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x31,0x00,0x00,0x00,0x01,0x02,0x06,0x00,0x0a,0x00,0x01,0x01,0x31,0x02,0xaf,0x00,0x01,0x01,0xe5,0x01,0xfe,0x00,0x01,0x01,0x31,0x00,0x00,0x00,0x01,0x02,0x06,0x00,0x0a,0x00,0x01,0x01,0x31,0x02,0xaf,0x00,0x01,0x01,0xe5,0x01,0xfe,0x00,0x01,0x01,0x31,0x00,0x00,0x00,0x01,0x02,0x06,0x00,0x0a,0x00,0x01,0x01,0x31,0x02,0xa5,0x00,0x01,0x01,0xe5,0x01,0xfe,0x00,0x01,0x01,0x31,0x00,0x00,0x00,0x01,0x02,0x06,0x00,0x0a,0x00,0x01,0x01,0x31,0x02,0x87,0x00,0x01,0x01,0xe5,0x01,0xfe,0x00,0x01,0x01,0x8f,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x0d,0x02,0xaf,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x3c,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x3c,0x01,0xfe,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x8f,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x0d,0x02,0x87,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x09,0x00,0x25,0x00,0x3e,0x00,0x00,0x00,0x45,0x00,0x4d,0x00,0x1a,0x00,0x4f,0x00,0x5e,0x00,0x23,0x00,0x83,0x00,0x92,0x00,0x33,0x00,0x94,0x00,0x99,0x00,0x43,0x00,0x9b,0x00,0xa1,0x00,0x49,0x00,0xa3,0x00,0xb2,0x00,0x50,0x00,0xb4,0x00,0xb9,0x00,0x60,0x00,0xbb,0x00,0xc2,0x00,0x66,0x00,0x02,0x00,0x01,0x00,0xc3,0x00,0xd9,0x00,0x00,0x00,0x17,0x00,0x02,0x00,0x5e,0x00,0x02,0x00,0x64,0x00,0x02,0x00,0x6a,0x00,0x02,0x00,0x70,0x00,0x02,0x00,0x76,0x00,0x02,0x00,0x7c,0x00,0x02,0x00,0x82,0x00,0x02,0x00,0x88,0x00,0x02,0x00,0x8e,0x00,0x02,0x00,0x94,0x00,0x02,0x00,0x9a,0x00,0x02,0x00,0xa0,0x00,0x02,0x00,0xa6,0x00,0x02,0x00,0xac,0x00,0x02,0x00,0xb2,0x00,0x03,0x00,0xb8,0x00,0x00,0x00,0xbe,0x00,0x00,0x00,0xc4,0x00,0x00,0x00,0xca,0x00,0x00,0x00,0xd0,0x00,0x01,0x00,0xd6,0x00,0x00,0x00,0xdc,0x00,0x00,0x00,0xe2,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0xff,0x38,0x00,0x0a,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0x00,0x58,0x00,0x46,0x00,0x01,0x00,0x68,0x00,0x0c,0x00,0x07,0x00,0x10,0x00,0x16,0x00,0x1c,0x00,0x22,0x00,0x28,0x00,0x2e,0x00,0x34,0x00,0x01,0x00,0xc8,0xff,0x23,0x00,0x01,0xff,0x38,0xff,0x5a,0x00,0x01,0xff,0x38,0xff,0x5a,0x00,0x01,0xff,0x38,0xff,0x18,0x00,0x01,0xff,0x38,0xff,0x23,0x00,0x01,0xff,0x38,0xff,0x5a,0x00,0x01,0xff,0x38,0xff,0x5a,0x00,0x01,0x00,0x07,0x00,0x7b,0x00,0xd3,0x00,0xd4,0x00,0xd5,0x00,0xd6,0x00,0xd8,0x00,0xd9,0x00,0x01,0x00,0x06,0x00,0xd3,0x00,0xd4,0x00,0xd5,0x00,0xd6,0x00,0xd8,0x00,0xd9,0x00,0x06,0x00,0x00,0x00,0x1a,0x00,0x00,0x00,0x20,0x00,0x00,0x00,0x26,0x00,0x00,0x00,0x2c,0x00,0x00,0x00,0x32,0x00,0x00,0x00,0x38,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0xff,0x38,0x00,0x00,0x00,0x01,0x00,0xc8,0x00,0xa6,0x00,0x01,0x00,0xd2,0x00,0x0c,0x00,0x13,0x00,0x28,0x00,0x2e,0x00,0x34,0x00,0x3a,0x00,0x40,0x00,0x46,0x00,0x4c,0x00,0x52,0x00,0x58,0x00,0x5e,0x00,0x64,0x00,0x6a,0x00,0x70,0x00,0x76,0x00,0x7c,0x00,0x82,0x00,0x88,0x00,0x8e,0x00,0x94,0x00,0x01,0x00,0xc8,0x02,0xaf,0x00,0x01,0x00,0xc8,0x02,0x87,0x00,0x01,0x00,0xc8,0x02,0x73,0x00,0x01,0x00,0xc8,0x02,0xaf,0x00,0x01,0xff,0x38,0x02,0xaf,0x00,0x01,0xff,0x38,0x02,0xaf,0x00,0x01,0xff,0x38,0x02,0xa5,0x00,0x01,0xff,0x38,0x02,0x91,0x00,0x01,0xff,0x38,0x02,0x73,0x00,0x01,0xff,0x38,0x02,0x91,0x00,0x01,0xff,0x38,0x02,0x91,0x00,0x01,0xff,0x38,0x02,0x87,0x00,0x01,0xff,0x38,0x02,0xc4,0x00,0x01,0xff,0x38,0x02,0xba,0x00,0x01,0xff,0x39,0x02,0xaf,0x00,0x01,0xff,0x38,0x02,0x91,0x00,0x01,0xff,0x38,0x02,0xaf,0x00,0x01,0xff,0x38,0x02,0x91,0x00,0x01,0xff,0x38,0x02,0xdc,0x00,0x02,0x00,0x05,0x00,0x44,0x00,0x44,0x00,0x00,0x00,0x6b,0x00,0x6b,0x00,0x01,0x00,0x72,0x00,0x72,0x00,0x02,0x00,0x77,0x00,0x77,0x00,0x03,0x00,0xc3,0x00,0xd1,0x00,0x04,0x00,0x02,0x00,0x01,0x00,0xc3,0x00,0xd1,0x00,0x00,0x00,0x0f,0x00,0x00,0x00,0x3e,0x00,0x00,0x00,0x44,0x00,0x00,0x00,0x4a,0x00,0x00,0x00,0x50,0x00,0x00,0x00,0x56,0x00,0x00,0x00,0x5c,0x00,0x00,0x00,0x62,0x00,0x00,0x00,0x68,0x00,0x00,0x00,0x6e,0x00,0x00,0x00,0x74,0x00,0x00,0x00,0x7a,0x00,0x00,0x00,0x80,0x00,0x00,0x00,0x86,0x00,0x00,0x00,0x8c,0x00,0x00,0x00,0x92,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x01,0x00,0x1c,0x00,0x16,0x00,0x01,0x00,0x22,0x00,0x0c,0x00,0x01,0x00,0x04,0x00,0x01,0xff,0x38,0x02,0xba,0x00,0x01,0x00,0x01,0x00,0xd2,0x00,0x01,0x00,0x01,0x00,0xd2,0x00,0x01,0x00,0x00,0x00,0x06,0x00,0x01,0xff,0x38,0x01,0xfe,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0xd5,0xa3,0xde,0x8c,0x00,0x00,0x00,0x00,0xd3,0xc7,0xf2,0x5f,0x00,0x00,0x00,0x00,0xd8,0x36,0x6d,0x98,};
+const unsigned int etc_VarelaRound_ttf_len = sizeof(etc_VarelaRound_ttf);
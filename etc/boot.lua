@@ -27,7 +27,8 @@ function lovr.boot()
       vsync = true,
       stencil = false,
       antialias = true,
-      shadercache = true
+      shadercache = true,
+      streamingbudget = 512 * 1024 * 1024
     },
     headset = {
       drivers = { 'openxr', 'webxr', 'desktop' },
@@ -0,0 +1,2 @@
+const unsigned char etc_monkeycrush_lua[] = {0x2d,0x2d,0x20,0x55,0x73,0x61,0x67,0x65,0x3a,0x20,0x6c,0x6f,0x76,0x72,0x20,0x65,0x74,0x63,0x2f,0x6d,0x6f,0x6e,0x6b,0x65,0x79,0x63,0x72,0x75,0x73,0x68,0x2e,0x6c,0x75,0x61,0x20,0x3e,0x20,0x65,0x74,0x63,0x2f,0x6d,0x6f,0x6e,0x6b,0x65,0x79,0x2e,0x68,0x0a,0x0a,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x65,0x74,0x63,0x20,0x3d,0x20,0x6c,0x6f,0x76,0x72,0x2e,0x66,0x69,0x6c,0x65,0x73,0x79,0x73,0x74,0x65,0x6d,0x2e,0x67,0x65,0x74,0x53,0x6f,0x75,0x72,0x63,0x65,0x28,0x29,0x0a,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x73,0x75,0x63,0x63,0x65,0x73,0x73,0x2c,0x20,0x6d,0x6f,0x64,0x65,0x6c,0x20,0x3d,0x20,0x61,0x73,0x73,0x65,0x72,0x74,0x28,0x70,0x63,0x61,0x6c,0x6c,0x28,0x6c,0x6f,0x76,0x72,0x2e,0x64,0x61,0x74,0x61,0x2e,0x6e,0x65,0x77,0x4d,0x6f,0x64,0x65,0x6c,0x44,0x61,0x74,0x61,0x2c,0x20,0x27,0x6d,0x6f,0x6e,0x6b,0x65,0x79,0x2e,0x67,0x6c,0x62,0x27,0x29,0x29,0x0a,0x0a,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x6d,0x69,0x6e,0x2c,0x20,0x6d,0x61,0x78,0x20,0x3d,0x20,0x6c,0x6f,0x76,0x72,0x2e,0x6d,0x61,0x74,0x68,0x2e,0x6e,0x65,0x77,0x56,0x65,0x63,0x33,0x28,0x6d,0x61,0x74,0x68,0x2e,0x68,0x75,0x67,0x65,0x29,0x2c,0x20,0x6c,0x6f,0x76,0x72,0x2e,0x6d,0x61,0x74,0x68,0x2e,0x6e,0x65,0x77,0x56,0x65,0x63,0x33,0x28,0x2d,0x6d,0x61,0x74,0x68,0x2e,0x68,0x75,0x67,0x65,0x29,0x0a,0x0a,0x66,0x6f,0x72,0x20,0x69,0x20,0x3d,0x20,0x31,0x2c,0x20,0x6d,0x6f,0x64,0x65,0x6c,0x3a,0x67,0x65,0x74,0x4d,0x65,0x73,0x68,0x56,0x65,0x72,0x74,0x65,0x78,0x43,0x6f,0x75,0x6e,0x74,0x28,0x31,0x29,0x20,0x64,0x6f,0x0a,0x20,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x78,0x2c,0x20,0x79,0x2c,0x20,0x7a,0x2c,0x20,0x6e,0x78,0x2c,0x20,0x6e,0x79,0x2c,0x20,0x6e,0x7a,0x20,0x3d,0x20,0x6d,0x6f,0x64,0x65,0x6c,0x3a,0x67,0x65,0x74,0x4d,0x65,0x73,0x68,0x56,0x65,0x72,0x74,0x65,0x78,0x28,0x31,0x2c,0x20,0x69,0x29,0x0a,0x20,0x20,0x6d,0x69,0x6e,0x2e,0x78,0x2c,0x20,0x6d,0x69,0x6e,0x2e,0x79,0x2c,0x20,0x6d,0x69,0x6e,0x2e,0x7a,0x20,0x3d,0x20,0x6d,0x61,0x74,0x68,0x2e,0x6d,0x69,0x6e,0x28,0x78,0x2c,0x20,0x6d,0x69,0x6e,0x2e,0x78,0x29,0x2c,0x20,0x6d,0x61,0x74,0x68,0x2e,0x6d,0x69,0x6e,0x28,0x79,0x2c,0x20,0x6d,0x69,0x6e,0x2e,0x79,0x29,0x2c,0x20,0x6d,0x61,0x74,0x68,0x2e,0x6d,0x69,0x6e,0x28,0x7a,0x2c,0x20,0x6d,0x69,0x6e,0x2e,0x7a,0x29,0x0a,0x20,0x20,0x6d,0x61,0x78,0x2e,0x78,0x2c,0x20,0x6d,0x61,0x78,0x2e,0x79,0x2c,0x20,0x6d,0x61,0x78,0x2e,0x7a,0x20,0x3d,0x20,0x6d,0x61,0x74,0x68,0x2e,0x6d,0x61,0x78,0x28,0x78,0x2c,0x20,0x6d,0x61,0x78,0x2e,0x78,0x29,0x2c,0x20,0x6d,0x61,0x74,0x68,0x2e,0x6d,0x61,0x78,0x28,0x79,0x2c,0x20,0x6d,0x61,0x78,0x2e,0x79,0x29,0x2c,0x20,0x6d,0x61,0x74,0x68,0x2e,0x6d,0x61,0x78,0x28,0x7a,0x2c,0x20,0x6d,0x61,0x78,0x2e,0x7a,0x29,0x0a,0x65,0x6e,0x64,0x0a,0x0a,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x73,0x69,0x7a,0x65,0x20,0x3d,0x20,0x6c,0x6f,0x76,0x72,0x2e,0x6d,0x61,0x74,0x68,0x2e,0x6e,0x65,0x77,0x56,0x65,0x63,0x33,0x28,0x6d,0x61,0x78,0x20,0x2d,0x20,0x6d,0x69,0x6e,0x29,0x0a,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x73,0x63,0x61,0x6c,0x65,0x20,0x3d,0x20,0x2e,0x35,0x0a,0x0a,0x6d,0x69,0x6e,0x3a,0x6d,0x75,0x6c,0x28,0x73,0x63,0x61,0x6c,0x65,0x29,0x0a,0x6d,0x61,0x78,0x3a,0x6d,0x75,0x6c,0x28,0x73,0x63,0x61,0x6c,0x65,0x29,0x0a,0x73,0x69,0x7a,0x65,0x3a,0x6d,0x75,0x6c,0x28,0x73,0x63,0x61,0x6c,0x65,0x29,0x0a,0x0a,0x69,0x6f,0x2e,0x77,0x72,0x69,0x74,0x65,0x28,0x28,0x27,0x66,0x6c,0x6f,0x61,0x74,0x20,0x6d,0x6f,0x6e,0x6b,0x65,0x79,0x5f,0x73,0x69,0x7a,0x65,0x5b,0x33,0x5d,0x20,0x3d,0x20,0x7b,0x20,0x25,0x66,0x66,0x2c,0x20,0x25,0x66,0x66,0x2c,0x20,0x25,0x66,0x66,0x20,0x7d,0x3b,0x5c,0x6e,0x27,0x29,0x3a,0x66,0x6f,0x72,0x6d,0x61,0x74,0x28,0x73,0x69,0x7a,0x65,0x3a,0x75,0x6e,0x70,0x61,0x63,0x6b,0x28,0x29,0x29,0x29,0x0a,0x69,0x6f,0x2e,0x77,0x72,0x69,0x74,0x65,0x28,0x28,0x27,0x66,0x6c,0x6f,0x61,0x74,0x20,0x6d,0x6f,0x6e,0x6b,0x65,0x79,0x5f,0x6f,0x66,0x66,0x73,0x65,0x74,0x5b,0x33,0x5d,0x20,0x3d,0x20,0x7b,0x20,0x25,0x66,0x66,0x2c,0x20,0x25,0x66,0x66,0x2c,0x20,0x25,0x66,0x66,0x20,0x7d,0x3b,0x5c,0x6e,0x27,0x29,0x3a,0x66,0x6f,0x72,0x6d,0x61,0x74,0x28,0x6d,0x69,0x6e,0x3a,0x75,0x6e,0x70,0x61,0x63,0x6b,0x28,0x29,0x29,0x29,0x0a,0x69,0x6f,0x2e,0x77,0x72,0x69,0x74,0x65,0x28,0x27,0x5c,0x6e,0x27,0x29,0x0a,0x0a,0x69,0x6f,0x2e,0x77,0x72,0x69,0x74,0x65,0x28,0x27,0x75,0x69,0x6e,0x74,0x38,0x5f,0x74,0x20,0x6d,0x6f,0x6e,0x6b,0x65,0x79,0x5f,0x76,0x65,0x72,0x74,0x69,0x63,0x65,0x73,0x5b,0x5d,0x20,0x3d,0x20,0x7b,0x5c,0x6e,0x27,0x29,0x0a,0x66,0x6f,0x72,0x20,0x69,0x20,0x3d,0x20,0x31,0x2c,0x20,0x6d,0x6f,0x64,0x65,0x6c,0x3a,0x67,0x65,0x74,0x4d,0x65,0x73,0x68,0x56,0x65,0x72,0x74,0x65,0x78,0x43,0x6f,0x75,0x6e,0x74,0x28,0x31,0x29,0x20,0x64,0x6f,0x0a,0x20,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x78,0x2c,0x20,0x79,0x2c,0x20,0x7a,0x2c,0x20,0x6e,0x78,0x2c,0x20,0x6e,0x79,0x2c,0x20,0x6e,0x7a,0x20,0x3d,0x20,0x6d,0x6f,0x64,0x65,0x6c,0x3a,0x67,0x65,0x74,0x4d,0x65,0x73,0x68,0x56,0x65,0x72,0x74,0x65,0x78,0x28,0x31,0x2c,0x20,0x69,0x29,0x0a,0x20,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x70,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x76,0x65,0x63,0x33,0x28,0x78,0x2c,0x20,0x79,0x2c,0x20,0x7a,0x29,0x3a,0x6d,0x75,0x6c,0x28,0x73,0x63,0x61,0x6c,0x65,0x29,0x0a,0x20,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x20,0x3d,0x20,0x76,0x65,0x63,0x33,0x28,0x6e,0x78,0x2c,0x20,0x6e,0x79,0x2c,0x20,0x6e,0x7a,0x29,0x0a,0x0a,0x20,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x71,0x78,0x2c,0x20,0x71,0x79,0x2c,0x20,0x71,0x7a,0x20,0x3d,0x20,0x28,0x28,0x70,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x2d,0x20,0x6d,0x69,0x6e,0x29,0x20,0x2f,0x20,0x73,0x69,0x7a,0x65,0x20,0x2a,0x20,0x32,0x35,0x35,0x20,0x2b,0x20,0x2e,0x35,0x29,0x3a,0x75,0x6e,0x70,0x61,0x63,0x6b,0x28,0x29,0x0a,0x20,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x71,0x6e,0x78,0x2c,0x20,0x71,0x6e,0x79,0x2c,0x20,0x71,0x6e,0x7a,0x20,0x3d,0x20,0x28,0x28,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x20,0x2f,0x20,0x32,0x20,0x2b,0x20,0x2e,0x35,0x29,0x20,0x2a,0x20,0x32,0x35,0x35,0x20,0x2b,0x20,0x2e,0x35,0x29,0x3a,0x75,0x6e,0x70,0x61,0x63,0x6b,0x28,0x29,0x0a,0x0a,0x20,0x20,0x71,0x78,0x2c,0x20,0x71,0x79,0x2c,0x20,0x71,0x7a,0x20,0x3d,0x20,0x6d,0x61,0x74,0x68,0x2e,0x66,0x6c,0x6f,0x6f,0x72,0x28,0x71,0x78,0x29,0x2c,0x20,0x6d,0x61,0x74,0x68,0x2e,0x66,0x6c,0x6f,0x6f,0x72,0x28,0x71,0x79,0x29,0x2c,0x20,0x6d,0x61,0x74,0x68,0x2e,0x66,0x6c,0x6f,0x6f,0x72,0x28,0x71,0x7a,0x29,0x0a,0x20,0x20,0x71,0x6e,0x78,0x2c,0x20,0x71,0x6e,0x79,0x2c,0x20,0x71,0x6e,0x7a,0x20,0x3d,0x20,0x6d,0x61,0x74,0x68,0x2e,0x66,0x6c,0x6f,0x6f,0x72,0x28,0x71,0x6e,0x78,0x29,0x2c,0x20,0x6d,0x61,0x74,0x68,0x2e,0x66,0x6c,0x6f,0x6f,0x72,0x28,0x71,0x6e,0x79,0x29,0x2c,0x20,0x6d,0x61,0x74,0x68,0x2e,0x66,0x6c,0x6f,0x6f,0x72,0x28,0x71,0x6e,0x7a,0x29,0x0a,0x0a,0x20,0x20,0x69,0x6f,0x2e,0x77,0x72,0x69,0x74,0x65,0x28,0x28,0x27,0x20,0x20,0x25,0x64,0x2c,0x20,0x25,0x64,0x2c,0x20,0x25,0x64,0x2c,0x20,0x25,0x64,0x2c,0x20,0x25,0x64,0x2c,0x20,0x25,0x64,0x2c,0x5c,0x6e,0x27,0x29,0x3a,0x66,0x6f,0x72,0x6d,0x61,0x74,0x28,0x71,0x78,0x2c,0x20,0x71,0x79,0x2c,0x20,0x71,0x7a,0x2c,0x20,0x71,0x6e,0x78,0x2c,0x20,0x71,0x6e,0x79,0x2c,0x20,0x71,0x6e,0x7a,0x29,0x29,0x0a,0x0a,0x20,0x20,0x6c,0x6f,0x76,0x72,0x2e,0x6d,0x61,0x74,0x68,0x2e,0x64,0x72,0x61,0x69,0x6e,0x28,0x29,0x0a,0x65,0x6e,0x64,0x0a,0x69,0x6f,0x2e,0x77,0x72,0x69,0x74,0x65,0x28,0x27,0x7d,0x3b,0x5c,0x6e,0x5c,0x6e,0x27,0x29,0x0a,0x0a,0x69,0x6f,0x2e,0x77,0x72,0x69,0x74,0x65,0x28,0x27,0x75,0x69,0x6e,0x74,0x31,0x36,0x5f,0x74,0x20,0x6d,0x6f,0x6e,0x6b,0x65,0x79,0x5f,0x69,0x6e,0x64,0x69,0x63,0x65,0x73,0x5b,0x5d,0x20,0x3d,0x20,0x7b,0x5c,0x6e,0x20,0x27,0x29,0x0a,0x66,0x6f,0x72,0x20,0x69,0x20,0x3d,0x20,0x31,0x2c,0x20,0x6d,0x6f,0x64,0x65,0x6c,0x3a,0x67,0x65,0x74,0x4d,0x65,0x73,0x68,0x49,0x6e,0x64,0x65,0x78,0x43,0x6f,0x75,0x6e,0x74,0x28,0x31,0x29,0x20,0x64,0x6f,0x0a,0x20,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x69,0x6e,0x64,0x65,0x78,0x20,0x3d,0x20,0x6d,0x6f,0x64,0x65,0x6c,0x3a,0x67,0x65,0x74,0x4d,0x65,0x73,0x68,0x49,0x6e,0x64,0x65,0x78,0x28,0x31,0x2c,0x20,0x69,0x29,0x20,0x2d,0x20,0x31,0x0a,0x20,0x20,0x69,0x6f,0x2e,0x77,0x72,0x69,0x74,0x65,0x28,0x28,0x27,0x20,0x25,0x64,0x2c,0x27,0x29,0x3a,0x66,0x6f,0x72,0x6d,0x61,0x74,0x28,0x69,0x6e,0x64,0x65,0x78,0x29,0x29,0x0a,0x20,0x20,0x69,0x66,0x20,0x69,0x20,0x25,0x20,0x31,0x30,0x20,0x3d,0x3d,0x20,0x30,0x20,0x74,0x68,0x65,0x6e,0x0a,0x20,0x20,0x20,0x20,0x69,0x6f,0x2e,0x77,0x72,0x69,0x74,0x65,0x28,0x27,0x5c,0x6e,0x20,0x27,0x29,0x0a,0x20,0x20,0x65,0x6e,0x64,0x0a,0x65,0x6e,0x64,0x0a,0x69,0x6f,0x2e,0x77,0x72,0x69,0x74,0x65,0x28,0x27,0x5c,0x6e,0x7d,0x3b,0x5c,0x6e,0x27,0x29,0x0a,0x0a,0x6c,0x6f,0x76,0x72,0x2e,0x65,0x76,0x65,0x6e,0x74,0x2e,0x71,0x75,0x69,0x74,0x28,0x29,0x0a,};
+const unsigned int etc_monkeycrush_lua_len = sizeof(etc_monkeycrush_lua);
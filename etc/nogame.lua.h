@@ -0,0 +1,2 @@
+const unsigned char etc_nogame_lua[] = {0x66,0x75,0x6e,0x63,0x74,0x69,0x6f,0x6e,0x20,0x6c,0x6f,0x76,0x72,0x2e,0x63,0x6f,0x6e,0x66,0x28,0x74,0x29,0x0a,0x20,0x20,0x74,0x2e,0x68,0x65,0x61,0x64,0x73,0x65,0x74,0x2e,0x73,0x75,0x70,0x65,0x72,0x73,0x61,0x6d,0x70,0x6c,0x65,0x20,0x3d,0x20,0x74,0x72,0x75,0x65,0x0a,0x20,0x20,0x74,0x2e,0x6d,0x6f,0x64,0x75,0x6c,0x65,0x73,0x2e,0x61,0x75,0x64,0x69,0x6f,0x20,0x3d,0x20,0x66,0x61,0x6c,0x73,0x65,0x0a,0x20,0x20,0x74,0x2e,0x6d,0x6f,0x64,0x75,0x6c,0x65,0x73,0x2e,0x70,0x68,0x79,0x73,0x69,0x63,0x73,0x20,0x3d,0x20,0x66,0x61,0x6c,0x73,0x65,0x0a,0x20,0x20,0x74,0x2e,0x6d,0x6f,0x64,0x75,0x6c,0x65,0x73,0x2e,0x74,0x68,0x72,0x65,0x61,0x64,0x20,0x3d,0x20,0x66,0x61,0x6c,0x73,0x65,0x0a,0x65,0x6e,0x64,0x0a,0x0a,0x66,0x75,0x6e,0x63,0x74,0x69,0x6f,0x6e,0x20,0x6c,0x6f,0x76,0x72,0x2e,0x6c,0x6f,0x61,0x64,0x28,0x29,0x0a,0x20,0x20,0x69,0x66,0x20,0x6e,0x6f,0x74,0x20,0x6c,0x6f,0x76,0x72,0x2e,0x67,0x72,0x61,0x70,0x68,0x69,0x63,0x73,0x20,0x74,0x68,0x65,0x6e,0x0a,0x20,0x20,0x20,0x20,0x70,0x72,0x69,0x6e,0x74,0x28,0x73,0x74,0x72,0x69,0x6e,0x67,0x2e,0x66,0x6f,0x72,0x6d,0x61,0x74,0x28,0x27,0x4c,0xc3,0x96,0x56,0x52,0x20,0x25,0x64,0x2e,0x25,0x64,0x2e,0x25,0x64,0x5c,0x6e,0x4e,0x6f,0x20,0x67,0x61,0x6d,0x65,0x27,0x2c,0x20,0x6c,0x6f,0x76,0x72,0x2e,0x67,0x65,0x74,0x56,0x65,0x72,0x73,0x69,0x6f,0x6e,0x28,0x29,0x29,0x29,0x0a,0x20,0x20,0x20,0x20,0x6c,0x6f,0x76,0x72,0x2e,0x65,0x76,0x65,0x6e,0x74,0x2e,0x71,0x75,0x69,0x74,0x28,0x29,0x0a,0x20,0x20,0x20,0x20,0x72,0x65,0x74,0x75,0x72,0x6e,0x0a,0x20,0x20,0x65,0x6e,0x64,0x0a,0x0a,0x20,0x20,0x6c,0x6f,0x76,0x72,0x2e,0x67,0x72,0x61,0x70,0x68,0x69,0x63,0x73,0x2e,0x73,0x65,0x74,0x42,0x61,0x63,0x6b,0x67,0x72,0x6f,0x75,0x6e,0x64,0x43,0x6f,0x6c,0x6f,0x72,0x28,0x30,0x78,0x32,0x30,0x32,0x33,0x32,0x63,0x29,0x0a,0x20,0x20,0x6c,0x6f,0x67,0x6f,0x20,0x3d,0x20,0x6c,0x6f,0x76,0x72,0x2e,0x67,0x72,0x61,0x70,0x68,0x69,0x63,0x73,0x2e,0x6e,0x65,0x77,0x53,0x68,0x61,0x64,0x65,0x72,0x28,0x27,0x75,0x6e,0x6c,0x69,0x74,0x27,0x2c,0x20,0x27,0x6c,0x6f,0x67,0x6f,0x27,0x29,0x0a,0x65,0x6e,0x64,0x0a,0x0a,0x66,0x75,0x6e,0x63,0x74,0x69,0x6f,0x6e,0x20,0x6c,0x6f,0x76,0x72,0x2e,0x64,0x72,0x61,0x77,0x28,0x70,0x61,0x73,0x73,0x29,0x0a,0x20,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x70,0x61,0x64,0x64,0x69,0x6e,0x67,0x20,0x3d,0x20,0x2e,0x31,0x0a,0x20,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x66,0x6f,0x6e,0x74,0x20,0x3d,0x20,0x6c,0x6f,0x76,0x72,0x2e,0x67,0x72,0x61,0x70,0x68,0x69,0x63,0x73,0x2e,0x67,0x65,0x74,0x44,0x65,0x66,0x61,0x75,0x6c,0x74,0x46,0x6f,0x6e,0x74,0x28,0x29,0x0a,0x20,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x66,0x61,0x64,0x65,0x20,0x3d,0x20,0x2e,0x33,0x31,0x35,0x20,0x2b,0x20,0x2e,0x36,0x38,0x35,0x20,0x2a,0x20,0x6d,0x61,0x74,0x68,0x2e,0x61,0x62,0x73,0x28,0x6d,0x61,0x74,0x68,0x2e,0x73,0x69,0x6e,0x28,0x6c,0x6f,0x76,0x72,0x2e,0x68,0x65,0x61,0x64,0x73,0x65,0x74,0x2e,0x67,0x65,0x74,0x54,0x69,0x6d,0x65,0x28,0x29,0x20,0x2a,0x20,0x32,0x29,0x29,0x0a,0x20,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x74,0x69,0x74,0x6c,0x65,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x31,0x2e,0x35,0x20,0x2d,0x20,0x70,0x61,0x64,0x64,0x69,0x6e,0x67,0x0a,0x20,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x73,0x75,0x62,0x74,0x69,0x74,0x6c,0x65,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x74,0x69,0x74,0x6c,0x65,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x2d,0x20,0x66,0x6f,0x6e,0x74,0x3a,0x67,0x65,0x74,0x48,0x65,0x69,0x67,0x68,0x74,0x28,0x29,0x20,0x2a,0x20,0x2e,0x32,0x35,0x20,0x2d,0x20,0x70,0x61,0x64,0x64,0x69,0x6e,0x67,0x0a,0x0a,0x20,0x20,0x70,0x61,0x73,0x73,0x3a,0x73,0x65,0x74,0x43,0x75,0x6c,0x6c,0x4d,0x6f,0x64,0x65,0x28,0x27,0x62,0x61,0x63,0x6b,0x27,0x29,0x0a,0x20,0x20,0x70,0x61,0x73,0x73,0x3a,0x73,0x65,0x74,0x53,0x68,0x61,0x64,0x65,0x72,0x28,0x6c,0x6f,0x67,0x6f,0x29,0x0a,0x20,0x20,0x70,0x61,0x73,0x73,0x3a,0x70,0x6c,0x61,0x6e,0x65,0x28,0x30,0x2c,0x20,0x32,0x2c,0x20,0x2d,0x33,0x29,0x0a,0x20,0x20,0x70,0x61,0x73,0x73,0x3a,0x73,0x65,0x74,0x53,0x68,0x61,0x64,0x65,0x72,0x28,0x29,0x0a,0x0a,0x20,0x20,0x70,0x61,0x73,0x73,0x3a,0x74,0x65,0x78,0x74,0x28,0x27,0x4c,0xc3,0x96,0x56,0x52,0x27,0x2c,0x20,0x2d,0x2e,0x30,0x31,0x32,0x2c,0x20,0x74,0x69,0x74,0x6c,0x65,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x2c,0x20,0x2d,0x33,0x2c,0x20,0x2e,0x32,0x35,0x2c,0x20,0x71,0x75,0x61,0x74,0x28,0x30,0x2c,0x20,0x30,0x2c,0x20,0x31,0x2c,0x20,0x30,0x29,0x2c,0x20,0x6e,0x69,0x6c,0x2c,0x20,0x27,0x63,0x65,0x6e,0x74,0x65,0x72,0x27,0x2c,0x20,0x27,0x74,0x6f,0x70,0x27,0x29,0x0a,0x0a,0x20,0x20,0x70,0x61,0x73,0x73,0x3a,0x73,0x65,0x74,0x43,0x6f,0x6c,0x6f,0x72,0x28,0x2e,0x39,0x2c,0x20,0x2e,0x39,0x2c,0x20,0x2e,0x39,0x2c,0x20,0x66,0x61,0x64,0x65,0x29,0x0a,0x20,0x20,0x70,0x61,0x73,0x73,0x3a,0x74,0x65,0x78,0x74,0x28,0x27,0x4e,0x6f,0x20,0x67,0x61,0x6d,0x65,0x20,0x3a,0x28,0x27,0x2c,0x20,0x2d,0x2e,0x30,0x30,0x35,0x2c,0x20,0x73,0x75,0x62,0x74,0x69,0x74,0x6c,0x65,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x2c,0x20,0x2d,0x33,0x2c,0x20,0x2e,0x31,0x35,0x2c,0x20,0x30,0x2c,0x20,0x30,0x2c,0x20,0x31,0x2c,0x20,0x30,0x2c,0x20,0x6e,0x69,0x6c,0x2c,0x20,0x27,0x63,0x65,0x6e,0x74,0x65,0x72,0x27,0x2c,0x20,0x27,0x74,0x6f,0x70,0x27,0x29,0x0a,0x65,0x6e,0x64,0x0a,};
+const unsigned int etc_nogame_lua_len = sizeof(etc_nogame_lua);
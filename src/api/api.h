@@ -24,9 +24,11 @@ extern StringEntry lovrAudioType[];
 extern StringEntry lovrBlendAlphaMode[];
 extern StringEntry lovrBlendMode[];
 extern StringEntry lovrBlockType[];
+extern StringEntry lovrBroadphaseType[];
 extern StringEntry lovrBufferLayout[];
 extern StringEntry lovrChannelLayout[];
 extern StringEntry lovrCompareMode[];
+extern StringEntry lovrContactEventType[];
 extern StringEntry lovrCullMode[];
 extern StringEntry lovrDefaultAttribute[];
 extern StringEntry lovrDefaultShader[];
@@ -38,6 +40,7 @@ extern StringEntry lovrDrawStyle[];
 extern StringEntry lovrEffect[];
 extern StringEntry lovrEventType[];
 extern StringEntry lovrFieldType[];
+extern StringEntry lovrFilterType[];
 extern StringEntry lovrFilterMode[];
 extern StringEntry lovrHeadsetDriver[];
 extern StringEntry lovrHeadsetOrigin[];
@@ -48,6 +51,9 @@ extern StringEntry lovrMeshMode[];
 extern StringEntry lovrOriginType[];
 extern StringEntry lovrPassType[];
 extern StringEntry lovrPermission[];
+extern StringEntry lovrPoseFormat[];
+extern StringEntry lovrRaycastMode[];
+extern StringEntry lovrResampler[];
 extern StringEntry lovrSampleFormat[];
 extern StringEntry lovrShaderStage[];
 extern StringEntry lovrShaderType[];
@@ -135,6 +141,7 @@ int luax_readmesh(lua_State* L, int index, float** vertices, uint32_t* vertexCou
 struct Blob;
 struct Image;
 struct Blob* luax_readblob(lua_State* L, int index, const char* debug);
+struct Blob* luax_mapblob(lua_State* L, int index, const char* debug);
 struct Image* luax_checkimage(lua_State* L, int index);
 uint32_t luax_checkcodepoint(lua_State* L, int index);
 #endif
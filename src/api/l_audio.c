@@ -43,6 +43,20 @@ StringEntry lovrAudioType[] = {
   { 0 }
 };
 
+StringEntry lovrFilterType[] = {
+  [FILTER_NONE] = ENTRY("none"),
+  [FILTER_LOWPASS] = ENTRY("lowpass"),
+  [FILTER_HIGHPASS] = ENTRY("highpass"),
+  { 0 }
+};
+
+StringEntry lovrResampler[] = {
+  [RESAMPLER_FILTERED] = ENTRY("filtered"),
+  [RESAMPLER_LINEAR] = ENTRY("linear"),
+  [RESAMPLER_CUBIC] = ENTRY("cubic"),
+  { 0 }
+};
+
 StringEntry lovrTimeUnit[] = {
   [UNIT_SECONDS] = ENTRY("seconds"),
   [UNIT_FRAMES] = ENTRY("frames"),
@@ -195,6 +209,14 @@ static int l_lovrAudioSetGeometry(lua_State* L) {
   return 1;
 }
 
+static int l_lovrAudioSetHRTF(lua_State* L) {
+  Blob* blob = luax_readblob(L, 1, "HRTF");
+  bool success = lovrAudioSetHRTF(blob->data, blob->size);
+  lovrRelease(blob, lovrBlobDestroy);
+  lua_pushboolean(L, success);
+  return 1;
+}
+
 static int l_lovrAudioGetSpatializer(lua_State *L) {
   lua_pushstring(L, lovrAudioGetSpatializer());
   return 1;
@@ -223,13 +245,158 @@ static int l_lovrAudioSetAbsorption(lua_State* L) {
   return 0;
 }
 
+static int l_lovrAudioRender(lua_State* L) {
+  Sound* sound = luax_totype(L, 1, Sound);
+
+  if (!sound) {
+    uint32_t frames = luax_checku32(L, 1);
+    sound = lovrSoundCreateRaw(frames, SAMPLE_F32, CHANNEL_STEREO, lovrAudioGetSampleRate(), NULL);
+    luax_pushtype(L, Sound, sound);
+    lovrRelease(sound, lovrSoundDestroy);
+    lovrAudioRender(sound, 0, frames);
+    return 1;
+  }
+
+  uint32_t offset = luax_optu32(L, 3, 0);
+  uint32_t frames = luax_optu32(L, 2, lovrSoundIsStream(sound) ? lovrSoundGetCapacity(sound) : lovrSoundGetFrameCount(sound) - offset);
+  uint32_t count = lovrAudioRender(sound, offset, frames);
+  lua_pushinteger(L, count);
+  return 1;
+}
+
+static int l_lovrAudioGetVoiceLimit(lua_State* L) {
+  lua_pushinteger(L, lovrAudioGetVoiceLimit());
+  return 1;
+}
+
+static int l_lovrAudioSetVoiceLimit(lua_State* L) {
+  uint32_t limit = luax_checku32(L, 1);
+  lovrAudioSetVoiceLimit(limit);
+  return 0;
+}
+
+static int l_lovrAudioGetVoiceStats(lua_State* L) {
+  uint32_t real, virtual;
+  double mixTime, convertTime;
+  lovrAudioGetVoiceStats(&real, &virtual, &mixTime, &convertTime);
+  lua_createtable(L, 0, 4);
+  lua_pushinteger(L, real);
+  lua_setfield(L, -2, "real");
+  lua_pushinteger(L, virtual);
+  lua_setfield(L, -2, "virtual");
+  lua_pushnumber(L, mixTime);
+  lua_setfield(L, -2, "mixTime");
+  lua_pushnumber(L, convertTime);
+  lua_setfield(L, -2, "convertTime");
+  return 1;
+}
+
+static int l_lovrAudioNewBus(lua_State* L) {
+  const char* name = luaL_checkstring(L, 1);
+  lovrAudioCreateBus(name);
+  return 0;
+}
+
+static int l_lovrAudioGetBusVolume(lua_State* L) {
+  BusParams params;
+  lovrAudioGetBusParams(luaL_checkstring(L, 1), &params);
+  VolumeUnit units = luax_checkenum(L, 2, VolumeUnit, "linear");
+  lua_pushnumber(L, units == UNIT_LINEAR ? params.volume : 20.f * log10f(params.volume));
+  return 1;
+}
+
+static int l_lovrAudioSetBusVolume(lua_State* L) {
+  BusParams params;
+  const char* name = luaL_checkstring(L, 1);
+  lovrAudioGetBusParams(name, &params);
+  float volume = luax_checkfloat(L, 2);
+  VolumeUnit units = luax_checkenum(L, 3, VolumeUnit, "linear");
+  params.volume = MAX(units == UNIT_LINEAR ? volume : powf(10.f, volume / 20.f), 0.f);
+  lovrAudioSetBusParams(name, &params);
+  return 0;
+}
+
+static int l_lovrAudioGetBusFilter(lua_State* L) {
+  BusParams params;
+  lovrAudioGetBusParams(luaL_checkstring(L, 1), &params);
+  if (params.filter == FILTER_NONE) {
+    lua_pushnil(L);
+    return 1;
+  }
+  luax_pushenum(L, FilterType, params.filter);
+  lua_pushnumber(L, params.frequency);
+  lua_pushnumber(L, params.resonance);
+  return 3;
+}
+
+static int l_lovrAudioSetBusFilter(lua_State* L) {
+  BusParams params;
+  const char* name = luaL_checkstring(L, 1);
+  lovrAudioGetBusParams(name, &params);
+  params.filter = luax_checkenum(L, 2, FilterType, "none");
+  params.frequency = luax_optfloat(L, 3, params.frequency);
+  params.resonance = luax_optfloat(L, 4, params.resonance);
+  lovrCheck(params.frequency > 0.f, "Filter frequency must be positive");
+  lovrCheck(params.resonance > 0.f, "Filter resonance must be positive");
+  lovrAudioSetBusParams(name, &params);
+  return 0;
+}
+
+static int l_lovrAudioGetBusReverb(lua_State* L) {
+  BusParams params;
+  lovrAudioGetBusParams(luaL_checkstring(L, 1), &params);
+  lua_pushnumber(L, params.reverbMix);
+  lua_pushnumber(L, params.reverbDecay);
+  lua_pushnumber(L, params.reverbDamping);
+  return 3;
+}
+
+static int l_lovrAudioSetBusReverb(lua_State* L) {
+  BusParams params;
+  const char* name = luaL_checkstring(L, 1);
+  lovrAudioGetBusParams(name, &params);
+  params.reverbMix = CLAMP(luax_checkfloat(L, 2), 0.f, 1.f);
+  params.reverbDecay = luax_optfloat(L, 3, params.reverbDecay);
+  params.reverbDamping = CLAMP(luax_optfloat(L, 4, params.reverbDamping), 0.f, 1.f);
+  lovrCheck(params.reverbDecay > 0.f, "Reverb decay must be positive");
+  lovrAudioSetBusParams(name, &params);
+  return 0;
+}
+
+static int l_lovrAudioGetBusLimiter(lua_State* L) {
+  BusParams params;
+  lovrAudioGetBusParams(luaL_checkstring(L, 1), &params);
+  if (params.limiterThreshold <= 0.f) {
+    lua_pushnil(L);
+    return 1;
+  }
+  lua_pushnumber(L, params.limiterThreshold);
+  lua_pushnumber(L, params.limiterRelease);
+  return 2;
+}
+
+static int l_lovrAudioSetBusLimiter(lua_State* L) {
+  BusParams params;
+  const char* name = luaL_checkstring(L, 1);
+  lovrAudioGetBusParams(name, &params);
+  params.limiterThreshold = lua_isnoneornil(L, 2) ? 0.f : luax_checkfloat(L, 2);
+  params.limiterRelease = luax_optfloat(L, 3, params.limiterRelease);
+  lovrCheck(params.limiterThreshold >= 0.f, "Limiter threshold can not be negative");
+  lovrCheck(params.limiterRelease > 0.f, "Limiter release must be positive");
+  lovrAudioSetBusParams(name, &params);
+  return 0;
+}
+
 static int l_lovrAudioNewSource(lua_State* L) {
   Sound* sound = luax_totype(L, 1, Sound);
 
   bool decode = false;
+  bool stream = false;
+  size_t window = LOVR_SOUND_STREAM_WINDOW;
   bool pitchable = false;
   bool spatial = true;
   uint32_t effects = ~0u;
+  Resampler resampler = RESAMPLER_FILTERED;
   if (lua_gettop(L) >= 2) {
     luaL_checktype(L, 2, LUA_TTABLE);
 
@@ -237,10 +404,22 @@ static int l_lovrAudioNewSource(lua_State* L) {
     decode = lua_toboolean(L, -1);
     lua_pop(L, 1);
 
+    lua_getfield(L, 2, "stream");
+    stream = lua_toboolean(L, -1);
+    lua_pop(L, 1);
+
+    lua_getfield(L, 2, "window");
+    window = (size_t) luaL_optnumber(L, -1, LOVR_SOUND_STREAM_WINDOW);
+    lua_pop(L, 1);
+
     lua_getfield(L, 2, "pitchable");
     pitchable = lua_toboolean(L, -1);
     lua_pop(L, 1);
 
+    lua_getfield(L, 2, "resampler");
+    resampler = luax_checkenum(L, -1, Resampler, "filtered");
+    lua_pop(L, 1);
+
     lua_getfield(L, 2, "effects");
     if (!lua_isnil(L, -1)) {
       effects = 0;
@@ -265,7 +444,11 @@ static int l_lovrAudioNewSource(lua_State* L) {
     lua_pop(L, 1);
   }
 
-  if (!sound) {
+  if (!sound && stream) {
+    Blob* blob = luax_mapblob(L, 1, "Source");
+    sound = lovrSoundCreateFromStream(blob, window);
+    lovrRelease(blob, lovrBlobDestroy);
+  } else if (!sound) {
     Blob* blob = luax_readblob(L, 1, "Source");
     sound = lovrSoundCreateFromFile(blob, decode);
     lovrRelease(blob, lovrBlobDestroy);
@@ -273,7 +456,7 @@ static int l_lovrAudioNewSource(lua_State* L) {
     lovrRetain(sound);
   }
 
-  Source* source = lovrSourceCreate(sound, pitchable, spatial, effects);
+  Source* source = lovrSourceCreate(sound, pitchable, spatial, effects, resampler);
   luax_pushtype(L, Source, source);
   lovrRelease(sound, lovrSoundDestroy);
   lovrRelease(source, lovrSourceDestroy);
@@ -295,10 +478,24 @@ static const luaL_Reg lovrAudio[] = {
   { "getPose", l_lovrAudioGetPose },
   { "setPose", l_lovrAudioSetPose },
   { "setGeometry", l_lovrAudioSetGeometry },
+  { "setHRTF", l_lovrAudioSetHRTF },
   { "getSpatializer", l_lovrAudioGetSpatializer },
   { "getSampleRate", l_lovrAudioGetSampleRate },
   { "getAbsorption", l_lovrAudioGetAbsorption },
   { "setAbsorption", l_lovrAudioSetAbsorption },
+  { "render", l_lovrAudioRender },
+  { "getVoiceLimit", l_lovrAudioGetVoiceLimit },
+  { "setVoiceLimit", l_lovrAudioSetVoiceLimit },
+  { "getVoiceStats", l_lovrAudioGetVoiceStats },
+  { "newBus", l_lovrAudioNewBus },
+  { "getBusVolume", l_lovrAudioGetBusVolume },
+  { "setBusVolume", l_lovrAudioSetBusVolume },
+  { "getBusFilter", l_lovrAudioGetBusFilter },
+  { "setBusFilter", l_lovrAudioSetBusFilter },
+  { "getBusReverb", l_lovrAudioGetBusReverb },
+  { "setBusReverb", l_lovrAudioSetBusReverb },
+  { "getBusLimiter", l_lovrAudioGetBusLimiter },
+  { "setBusLimiter", l_lovrAudioSetBusLimiter },
   { "newSource", l_lovrAudioNewSource },
   { NULL, NULL }
 };
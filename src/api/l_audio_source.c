@@ -171,6 +171,20 @@ static int l_lovrSourceSetPose(lua_State *L) {
   return 0;
 }
 
+static int l_lovrSourceGetBus(lua_State* L) {
+  Source* source = luax_checktype(L, 1, Source);
+  const char* name = lovrSourceGetBus(source);
+  lua_pushstring(L, name);
+  return 1;
+}
+
+static int l_lovrSourceSetBus(lua_State* L) {
+  Source* source = luax_checktype(L, 1, Source);
+  const char* name = luaL_optstring(L, 2, NULL);
+  lovrSourceSetBus(source, name);
+  return 0;
+}
+
 static int l_lovrSourceGetDirectivity(lua_State* L) {
   Source* source = luax_checktype(L, 1, Source);
   float weight, power;
@@ -202,6 +216,20 @@ static int l_lovrSourceSetRadius(lua_State* L) {
   return 0;
 }
 
+static int l_lovrSourceGetPriority(lua_State* L) {
+  Source* source = luax_checktype(L, 1, Source);
+  float priority = lovrSourceGetPriority(source);
+  lua_pushnumber(L, priority);
+  return 1;
+}
+
+static int l_lovrSourceSetPriority(lua_State* L) {
+  Source* source = luax_checktype(L, 1, Source);
+  float priority = luax_checkfloat(L, 2);
+  lovrSourceSetPriority(source, priority);
+  return 0;
+}
+
 static int l_lovrSourceIsEffectEnabled(lua_State* L) {
   Source* source = luax_checktype(L, 1, Source);
   Effect effect = luax_checkenum(L, 2, Effect, NULL);
@@ -249,6 +277,10 @@ const luaL_Reg lovrSource[] = {
   { "setPose", l_lovrSourceSetPose },
   { "getRadius", l_lovrSourceGetRadius },
   { "setRadius", l_lovrSourceSetRadius },
+  { "getPriority", l_lovrSourceGetPriority },
+  { "setPriority", l_lovrSourceSetPriority },
+  { "getBus", l_lovrSourceGetBus },
+  { "setBus", l_lovrSourceSetBus },
   { "getDirectivity", l_lovrSourceGetDirectivity },
   { "setDirectivity", l_lovrSourceSetDirectivity },
   { "isEffectEnabled", l_lovrSourceIsEffectEnabled },
@@ -183,21 +183,52 @@ static int l_lovrDataNewSound(lua_State* L) {
     return luax_typeerror(L, 1, "number, string, or Blob");
   }
 
-  Blob* blob = luax_readblob(L, 1, "Sound");
-  bool decode = lua_toboolean(L, 2);
-  Sound* sound = lovrSoundCreateFromFile(blob, decode);
+  const char* mode = lua_tostring(L, 2);
+  bool stream = mode && !strcmp(mode, "stream");
+  Blob* blob = stream ? luax_mapblob(L, 1, "Sound") : luax_readblob(L, 1, "Sound");
+  Sound* sound = stream ?
+    lovrSoundCreateFromStream(blob, (size_t) luaL_optnumber(L, 3, LOVR_SOUND_STREAM_WINDOW)) :
+    lovrSoundCreateFromFile(blob, lua_toboolean(L, 2));
   luax_pushtype(L, Sound, sound);
   lovrRelease(blob, lovrBlobDestroy);
   lovrRelease(sound, lovrSoundDestroy);
   return 1;
 }
 
+static int l_lovrDataGetSoundCacheStats(lua_State* L) {
+  SoundCacheStats stats;
+  lovrSoundGetCacheStats(&stats);
+  lua_createtable(L, 0, 6);
+  lua_pushnumber(L, (double) stats.hits);
+  lua_setfield(L, -2, "hits");
+  lua_pushnumber(L, (double) stats.misses);
+  lua_setfield(L, -2, "misses");
+  lua_pushnumber(L, (double) stats.evictions);
+  lua_setfield(L, -2, "evictions");
+  lua_pushinteger(L, stats.count);
+  lua_setfield(L, -2, "count");
+  lua_pushnumber(L, (double) stats.size);
+  lua_setfield(L, -2, "size");
+  lua_pushnumber(L, (double) stats.budget);
+  lua_setfield(L, -2, "budget");
+  return 1;
+}
+
+static int l_lovrDataSetSoundCacheBudget(lua_State* L) {
+  lua_Number budget = luaL_checknumber(L, 1);
+  lovrCheck(budget >= 0., "Sound cache budget can not be negative");
+  lovrSoundSetCacheBudget((size_t) budget);
+  return 0;
+}
+
 static const luaL_Reg lovrData[] = {
   { "newBlob", l_lovrDataNewBlob },
   { "newImage", l_lovrDataNewImage },
   { "newModelData", l_lovrDataNewModelData },
   { "newRasterizer", l_lovrDataNewRasterizer },
   { "newSound", l_lovrDataNewSound },
+  { "getSoundCacheStats", l_lovrDataGetSoundCacheStats },
+  { "setSoundCacheBudget", l_lovrDataSetSoundCacheBudget },
   { NULL, NULL }
 };
 
@@ -124,6 +124,94 @@ static int l_lovrImageSetPixel(lua_State* L) {
   return 0;
 }
 
+static void mapPixelCallback(void* userdata, uint32_t x, uint32_t y, float pixel[4]) {
+  lua_State* L = userdata;
+  lua_pushvalue(L, 2);
+  lua_pushinteger(L, x);
+  lua_pushinteger(L, y);
+  lua_pushnumber(L, pixel[0]);
+  lua_pushnumber(L, pixel[1]);
+  lua_pushnumber(L, pixel[2]);
+  lua_pushnumber(L, pixel[3]);
+  lua_call(L, 6, 4);
+  pixel[0] = luax_optfloat(L, -4, pixel[0]);
+  pixel[1] = luax_optfloat(L, -3, pixel[1]);
+  pixel[2] = luax_optfloat(L, -2, pixel[2]);
+  pixel[3] = luax_optfloat(L, -1, pixel[3]);
+  lua_pop(L, 4);
+}
+
+static int l_lovrImageMapPixel(lua_State* L) {
+  Image* image = luax_checktype(L, 1, Image);
+  luaL_checktype(L, 2, LUA_TFUNCTION);
+  uint32_t x = luax_optu32(L, 3, 0);
+  uint32_t y = luax_optu32(L, 4, 0);
+  uint32_t w = luax_optu32(L, 5, lovrImageGetWidth(image, 0) - x);
+  uint32_t h = luax_optu32(L, 6, lovrImageGetHeight(image, 0) - y);
+  lua_settop(L, 2);
+  lovrImageMapPixel(image, x, y, w, h, mapPixelCallback, L);
+  return 0;
+}
+
+static int l_lovrImageGetPixels(lua_State* L) {
+  Image* image = luax_checktype(L, 1, Image);
+  uint32_t x = luax_optu32(L, 2, 0);
+  uint32_t y = luax_optu32(L, 3, 0);
+  uint32_t w = luax_optu32(L, 4, lovrImageGetWidth(image, 0) - x);
+  uint32_t h = luax_optu32(L, 5, lovrImageGetHeight(image, 0) - y);
+  TextureFormat format = lovrImageGetFormat(image);
+  if (!lua_isnoneornil(L, 6)) format = luax_checkenum(L, 6, TextureFormat, NULL);
+  Blob* blob = lovrImageGetPixels(image, x, y, w, h, format);
+  luax_pushtype(L, Blob, blob);
+  lovrRelease(blob, lovrBlobDestroy);
+  return 1;
+}
+
+static int l_lovrImageConvert(lua_State* L) {
+  Image* image = luax_checktype(L, 1, Image);
+  TextureFormat format = luax_checkenum(L, 2, TextureFormat, NULL);
+  Image* result = lovrImageConvert(image, format);
+  luax_pushtype(L, Image, result);
+  lovrRelease(result, lovrImageDestroy);
+  return 1;
+}
+
+static int l_lovrImagePremultiply(lua_State* L) {
+  Image* image = luax_checktype(L, 1, Image);
+  lovrImagePremultiply(image);
+  return 0;
+}
+
+static int l_lovrImageGammaToLinear(lua_State* L) {
+  Image* image = luax_checktype(L, 1, Image);
+  lovrImageGammaToLinear(image);
+  return 0;
+}
+
+static int l_lovrImageLinearToGamma(lua_State* L) {
+  Image* image = luax_checktype(L, 1, Image);
+  lovrImageLinearToGamma(image);
+  return 0;
+}
+
+static int l_lovrImageGenerateMipmaps(lua_State* L) {
+  Image* image = luax_checktype(L, 1, Image);
+  Image* result = lovrImageGenerateMipmaps(image);
+  luax_pushtype(L, Image, result);
+  lovrRelease(result, lovrImageDestroy);
+  return 1;
+}
+
+static int l_lovrImageCompress(lua_State* L) {
+  Image* image = luax_checktype(L, 1, Image);
+  TextureFormat format = luax_checkenum(L, 2, TextureFormat, NULL);
+  uint32_t threads = luax_optu32(L, 3, 0);
+  Image* result = lovrImageCompress(image, format, threads);
+  luax_pushtype(L, Image, result);
+  lovrRelease(result, lovrImageDestroy);
+  return 1;
+}
+
 static int l_lovrImagePaste(lua_State* L) {
   Image* dst = luax_checktype(L, 1, Image);
   Image* src = luax_checktype(L, 2, Image);
@@ -154,6 +242,14 @@ const luaL_Reg lovrImage[] = {
   { "getFormat", l_lovrImageGetFormat },
   { "getPixel", l_lovrImageGetPixel },
   { "setPixel", l_lovrImageSetPixel },
+  { "mapPixel", l_lovrImageMapPixel },
+  { "getPixels", l_lovrImageGetPixels },
+  { "convert", l_lovrImageConvert },
+  { "premultiply", l_lovrImagePremultiply },
+  { "gammaToLinear", l_lovrImageGammaToLinear },
+  { "linearToGamma", l_lovrImageLinearToGamma },
+  { "generateMipmaps", l_lovrImageGenerateMipmaps },
+  { "compress", l_lovrImageCompress },
   { "paste", l_lovrImagePaste },
   { "encode", l_lovrImageEncode },
   { NULL, NULL }
@@ -32,6 +32,22 @@ Blob* luax_readblob(lua_State* L, int index, const char* debug) {
   }
 }
 
+// Like luax_readblob, but files are mapped instead of read when possible
+Blob* luax_mapblob(lua_State* L, int index, const char* debug) {
+  if (lua_type(L, index) == LUA_TSTRING) {
+    size_t size;
+    const char* path = lua_tostring(L, index);
+    void* data = lovrFilesystemMap(path, &size);
+    if (data) {
+      Blob* blob = lovrBlobCreate(data, size, path);
+      blob->unmap = lovrFilesystemUnmap;
+      return blob;
+    }
+  }
+
+  return luax_readblob(L, index, debug);
+}
+
 static void pushDirectoryItem(void* context, const char* path) {
   lua_State* L = context;
 
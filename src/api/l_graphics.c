@@ -632,7 +632,8 @@ static int l_lovrGraphicsInitialize(lua_State* L) {
     .debug = false,
     .vsync = false,
     .stencil = false,
-    .antialias = true
+    .antialias = true,
+    .streamingBudget = 512 << 20
   };
 
   bool shaderCache = true;
@@ -659,6 +660,10 @@ static int l_lovrGraphicsInitialize(lua_State* L) {
     lua_getfield(L, -1, "shadercache");
     shaderCache = lua_toboolean(L, -1);
     lua_pop(L, 1);
+
+    lua_getfield(L, -1, "streamingbudget");
+    config.streamingBudget = lua_isnil(L, -1) ? config.streamingBudget : (size_t) luaL_checknumber(L, -1);
+    lua_pop(L, 1);
   }
   lua_pop(L, 2);
 
@@ -843,6 +848,32 @@ static int l_lovrGraphicsSetBackgroundColor(lua_State* L) {
   return 0;
 }
 
+static int l_lovrGraphicsGetStreamingBudget(lua_State* L) {
+  size_t budget = lovrGraphicsGetStreamingBudget();
+  lua_pushnumber(L, budget);
+  return 1;
+}
+
+static int l_lovrGraphicsSetStreamingBudget(lua_State* L) {
+  lua_Number budget = luaL_checknumber(L, 1);
+  lovrCheck(budget >= 0., "Streaming budget can not be negative");
+  lovrGraphicsSetStreamingBudget((size_t) budget);
+  return 0;
+}
+
+static int l_lovrGraphicsGetStreamingStats(lua_State* L) {
+  StreamingStats stats;
+  lovrGraphicsGetStreamingStats(&stats);
+  lua_newtable(L);
+  lua_pushnumber(L, stats.budget), lua_setfield(L, -2, "budget");
+  lua_pushnumber(L, stats.memory), lua_setfield(L, -2, "memory");
+  lua_pushinteger(L, stats.textureCount), lua_setfield(L, -2, "textures");
+  lua_pushinteger(L, stats.residentLevels), lua_setfield(L, -2, "residentLevels");
+  lua_pushinteger(L, stats.uploads), lua_setfield(L, -2, "uploads");
+  lua_pushinteger(L, stats.evictions), lua_setfield(L, -2, "evictions");
+  return 1;
+}
+
 static int l_lovrGraphicsGetWindowPass(lua_State* L) {
   Pass* pass = lovrGraphicsGetWindowPass();
   luax_pushtype(L, Pass, pass);
@@ -952,7 +983,24 @@ static int l_lovrGraphicsNewTexture(lua_State* L) {
     }
   } else {
     info.imageCount = 1;
-    images[0] = luax_checkimage(L, index++);
+
+    // Streaming textures map their file instead of reading it, so only the levels that are
+    // resident get paged in
+    bool stream = false;
+    if (lua_type(L, index) == LUA_TSTRING && lua_istable(L, index + 1)) {
+      lua_getfield(L, index + 1, "stream");
+      stream = lua_toboolean(L, -1);
+      lua_pop(L, 1);
+    }
+
+    if (stream) {
+      Blob* blob = luax_mapblob(L, index++, "Texture");
+      images[0] = lovrImageCreateFromFile(blob);
+      lovrRelease(blob, lovrBlobDestroy);
+    } else {
+      images[0] = luax_checkimage(L, index++);
+    }
+
     info.layers = lovrImageGetLayerCount(images[0]);
     if (lovrImageIsCube(images[0])) {
       info.type = TEXTURE_CUBE;
@@ -1025,6 +1073,10 @@ static int l_lovrGraphicsNewTexture(lua_State* L) {
     }
     lua_pop(L, 1);
 
+    lua_getfield(L, index, "stream");
+    info.streaming = lua_toboolean(L, -1);
+    lua_pop(L, 1);
+
     lua_getfield(L, index, "label");
     info.label = lua_tostring(L, -1);
     lua_pop(L, 1);
@@ -1510,6 +1562,9 @@ static const luaL_Reg lovrGraphics[] = {
   { "isFormatSupported", l_lovrGraphicsIsFormatSupported },
   { "getBackgroundColor", l_lovrGraphicsGetBackgroundColor },
   { "setBackgroundColor", l_lovrGraphicsSetBackgroundColor },
+  { "getStreamingBudget", l_lovrGraphicsGetStreamingBudget },
+  { "setStreamingBudget", l_lovrGraphicsSetStreamingBudget },
+  { "getStreamingStats", l_lovrGraphicsGetStreamingStats },
   { "getWindowPass", l_lovrGraphicsGetWindowPass },
   { "getDefaultFont", l_lovrGraphicsGetDefaultFont },
   { "getBuffer", l_lovrGraphicsGetBuffer },
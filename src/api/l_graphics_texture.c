@@ -102,6 +102,33 @@ static int l_lovrTextureHasUsage(lua_State* L) {
   return 1;
 }
 
+static int l_lovrTextureIsStreaming(lua_State* L) {
+  Texture* texture = luax_checktype(L, 1, Texture);
+  const TextureInfo* info = lovrTextureGetInfo(texture);
+  lua_pushboolean(L, info->streaming);
+  return 1;
+}
+
+static int l_lovrTextureGetResidentLevel(lua_State* L) {
+  Texture* texture = luax_checktype(L, 1, Texture);
+  lua_pushinteger(L, lovrTextureGetResidentLevel(texture) + 1);
+  return 1;
+}
+
+static int l_lovrTextureGetMinResidentLevel(lua_State* L) {
+  Texture* texture = luax_checktype(L, 1, Texture);
+  lua_pushinteger(L, lovrTextureGetMinResidentLevel(texture) + 1);
+  return 1;
+}
+
+static int l_lovrTextureSetMinResidentLevel(lua_State* L) {
+  Texture* texture = luax_checktype(L, 1, Texture);
+  uint32_t level = luax_checku32(L, 2);
+  lovrCheck(level > 0, "Mipmap level must be positive");
+  lovrTextureSetMinResidentLevel(texture, level - 1);
+  return 0;
+}
+
 const luaL_Reg lovrTexture[] = {
   { "newView", l_lovrTextureNewView },
   { "isView", l_lovrTextureIsView },
@@ -115,5 +142,9 @@ const luaL_Reg lovrTexture[] = {
   { "getMipmapCount", l_lovrTextureGetMipmapCount },
   { "getSampleCount", l_lovrTextureGetSampleCount },
   { "hasUsage", l_lovrTextureHasUsage },
+  { "isStreaming", l_lovrTextureIsStreaming },
+  { "getResidentLevel", l_lovrTextureGetResidentLevel },
+  { "getMinResidentLevel", l_lovrTextureGetMinResidentLevel },
+  { "setMinResidentLevel", l_lovrTextureSetMinResidentLevel },
   { NULL, NULL }
 };
@@ -12,6 +12,33 @@ StringEntry lovrShapeType[] = {
   { 0 }
 };
 
+StringEntry lovrRaycastMode[] = {
+  [RAYCAST_CLOSEST] = ENTRY("closest"),
+  [RAYCAST_ANY] = ENTRY("any"),
+  { 0 }
+};
+
+StringEntry lovrContactEventType[] = {
+  [CONTACT_BEGIN] = ENTRY("begin"),
+  [CONTACT_PERSIST] = ENTRY("persist"),
+  [CONTACT_END] = ENTRY("end"),
+  { 0 }
+};
+
+StringEntry lovrPoseFormat[] = {
+  [POSE_TRANSFORM] = ENTRY("transform"),
+  [POSE_MATRIX] = ENTRY("matrix"),
+  { 0 }
+};
+
+StringEntry lovrBroadphaseType[] = {
+  [BROADPHASE_HASH] = ENTRY("hash"),
+  [BROADPHASE_SAP] = ENTRY("sap"),
+  [BROADPHASE_QUADTREE] = ENTRY("quadtree"),
+  [BROADPHASE_SIMPLE] = ENTRY("simple"),
+  { 0 }
+};
+
 StringEntry lovrJointType[] = {
   [JOINT_BALL] = ENTRY("ball"),
   [JOINT_DISTANCE] = ENTRY("distance"),
@@ -25,12 +52,13 @@ static int l_lovrPhysicsNewWorld(lua_State* L) {
   float yg = luax_optfloat(L, 2, -9.81f);
   float zg = luax_optfloat(L, 3, 0.f);
   bool allowSleep = lua_gettop(L) < 4 || lua_toboolean(L, 4);
-  const char* tags[16];
+  const char* tags[MAX_TAGS];
   int tagCount;
   if (lua_type(L, 5) == LUA_TTABLE) {
     tagCount = luax_len(L, 5);
+    lovrCheck(tagCount <= MAX_TAGS, "Max number of world tags is %d", MAX_TAGS);
     for (int i = 0; i < tagCount; i++) {
-      lua_rawgeti(L, -1, i + 1);
+      lua_rawgeti(L, 5, i + 1);
       if (lua_isstring(L, -1)) {
         tags[i] = lua_tostring(L, -1);
       } else {
@@ -41,7 +69,59 @@ static int l_lovrPhysicsNewWorld(lua_State* L) {
   } else {
     tagCount = 0;
   }
-  World* world = lovrWorldCreate(xg, yg, zg, allowSleep, tags, tagCount);
+
+  BroadphaseInfo broadphase = {
+    .type = BROADPHASE_HASH,
+    .extents = { 100.f, 100.f, 100.f },
+    .depth = 6
+  };
+
+  uint32_t threadCount = 1;
+
+  if (!lua_isnoneornil(L, 6)) {
+    luaL_checktype(L, 6, LUA_TTABLE);
+
+    // The broadphase is a type name, or a table with the type and the quadtree bounds
+    lua_getfield(L, 6, "broadphase");
+    if (lua_istable(L, -1)) {
+      lua_getfield(L, -1, "type");
+      broadphase.type = luax_checkenum(L, -1, BroadphaseType, "hash");
+      lua_pop(L, 1);
+
+      lua_getfield(L, -1, "center");
+      if (lua_istable(L, -1)) {
+        for (int i = 0; i < 3; i++) {
+          lua_rawgeti(L, -1, i + 1);
+          broadphase.center[i] = luax_checkfloat(L, -1);
+          lua_pop(L, 1);
+        }
+      }
+      lua_pop(L, 1);
+
+      lua_getfield(L, -1, "extents");
+      if (lua_istable(L, -1)) {
+        for (int i = 0; i < 3; i++) {
+          lua_rawgeti(L, -1, i + 1);
+          broadphase.extents[i] = luax_checkfloat(L, -1);
+          lua_pop(L, 1);
+        }
+      }
+      lua_pop(L, 1);
+
+      lua_getfield(L, -1, "depth");
+      broadphase.depth = luax_optu32(L, -1, broadphase.depth);
+      lua_pop(L, 1);
+    } else {
+      broadphase.type = luax_checkenum(L, -1, BroadphaseType, "hash");
+    }
+    lua_pop(L, 1);
+
+    lua_getfield(L, 6, "threads");
+    threadCount = luax_optu32(L, -1, threadCount);
+    lua_pop(L, 1);
+  }
+
+  World* world = lovrWorldCreate(xg, yg, zg, allowSleep, tags, tagCount, &broadphase, threadCount);
   luax_pushtype(L, World, world);
   lovrRelease(world, lovrWorldDestroy);
   return 1;
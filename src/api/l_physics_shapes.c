@@ -1,8 +1,13 @@
 #include "api.h"
 #include "physics/physics.h"
+#include "data/blob.h"
 #include "data/image.h"
+#include "data/modelData.h"
 #include "core/maf.h"
 #include "util.h"
+#ifndef LOVR_DISABLE_GRAPHICS
+#include "graphics/graphics.h"
+#endif
 #include <stdlib.h>
 #include <string.h>
 
@@ -66,6 +71,30 @@ Shape* luax_newcylindershape(lua_State* L, int index) {
 }
 
 Shape* luax_newmeshshape(lua_State* L, int index) {
+  Blob* blob = luax_totype(L, index, Blob);
+
+  if (blob) {
+    return lovrMeshShapeCreateSerialized(blob, lovrBlobDestroy, blob->data, blob->size);
+  }
+
+  ModelData* modelData = luax_totype(L, index, ModelData);
+
+#ifndef LOVR_DISABLE_GRAPHICS
+  Model* model = luax_totype(L, index, Model);
+  if (model) modelData = lovrModelGetInfo(model)->data;
+#endif
+
+  // ModelData keeps its flattened triangles around, so they can be referenced in place and the
+  // trimesh can be shared by every shape created from the same ModelData
+  if (modelData) {
+    float* vertices;
+    uint32_t* indices;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    lovrModelDataGetTriangles(modelData, &vertices, &indices, &vertexCount, &indexCount);
+    return lovrMeshShapeCreateShared(modelData, lovrModelDataDestroy, vertexCount, vertices, indexCount, indices);
+  }
+
   float* vertices;
   uint32_t* indices;
   uint32_t vertexCount;
@@ -406,8 +435,19 @@ const luaL_Reg lovrCylinderShape[] = {
   { NULL, NULL }
 };
 
+static int l_lovrMeshShapeSerialize(lua_State* L) {
+  MeshShape* mesh = luax_checktype(L, 1, MeshShape);
+  size_t size;
+  void* data = lovrMeshShapeSerialize(mesh, &size);
+  Blob* blob = lovrBlobCreate(data, size, "MeshShape");
+  luax_pushtype(L, Blob, blob);
+  lovrRelease(blob, lovrBlobDestroy);
+  return 1;
+}
+
 const luaL_Reg lovrMeshShape[] = {
   lovrShape,
+  { "serialize", l_lovrMeshShapeSerialize },
   { NULL, NULL }
 };
 
@@ -1,9 +1,132 @@
 #include "api.h"
 #include "physics/physics.h"
+#include "data/blob.h"
+#include "core/maf.h"
 #include "util.h"
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
 
+#ifndef LOVR_DISABLE_GRAPHICS
+#include "graphics/graphics.h"
+#endif
+
+// Blobs and Buffers can be used as flat arrays of floats, temporary Buffers are mapped.  Persistent
+// Buffers live in GPU memory, so they can't be read and can only be written through staging memory.
+// They're only accepted when staged is given, in which case NULL is returned, the Buffer is stored
+// in staged, and the caller writes to it with luax_stagefloats.
+static float* luax_tofloats(lua_State* L, int index, uint32_t* count, void** staged) {
+  Blob* blob = luax_totype(L, index, Blob);
+
+  if (blob) {
+    *count = (uint32_t) (blob->size / sizeof(float));
+    return blob->data;
+  }
+
+#ifndef LOVR_DISABLE_GRAPHICS
+  Buffer* buffer = luax_totype(L, index, Buffer);
+
+  if (buffer) {
+    buffer = luax_checkbuffer(L, index);
+    const BufferInfo* info = lovrBufferGetInfo(buffer);
+    uint32_t size = info->length * info->stride;
+    *count = size / sizeof(float);
+
+    if (!lovrBufferIsTemporary(buffer)) {
+      lovrCheck(staged, "Persistent Buffers can't be read on the CPU, use a Blob or a temporary Buffer");
+      *staged = buffer;
+      return NULL;
+    }
+
+    return lovrBufferMap(buffer, 0, size);
+  }
+#endif
+
+  return NULL;
+}
+
+// Returns memory for count floats of a persistent Buffer from luax_tofloats, starting at the float
+// at offset.  It's copied into the Buffer when the frame is submitted, so all of it has to be written.
+static float* luax_stagefloats(void* buffer, uint32_t offset, uint32_t count) {
+#ifndef LOVR_DISABLE_GRAPHICS
+  return lovrBufferSetData(buffer, offset * sizeof(float), count * sizeof(float));
+#else
+  return NULL;
+#endif
+}
+
+// Reads an optional list of colliders into a temporary array on top of the stack, returning NULL
+// (and the number of colliders in the World) when the list is nil
+static Collider** luax_optcolliders(lua_State* L, int index, World* world, uint32_t* count) {
+  if (lua_isnoneornil(L, index)) {
+    *count = lovrWorldGetColliderCount(world);
+    return NULL;
+  }
+
+  luaL_checktype(L, index, LUA_TTABLE);
+  *count = luax_len(L, index);
+  Collider** colliders = lua_newuserdata(L, *count * sizeof(Collider*));
+  for (uint32_t i = 0; i < *count; i++) {
+    lua_rawgeti(L, index, i + 1);
+    colliders[i] = luax_checktype(L, -1, Collider);
+    lovrCheck(lovrColliderGetWorld(colliders[i]) == world, "Collider does not belong to this World");
+    lua_pop(L, 1);
+  }
+  return colliders;
+}
+
+// Tags can be a single tag name or a list of them, nil means any tag (or no tag)
+static uint32_t luax_opttagmask(lua_State* L, int index, World* world) {
+  uint32_t mask = 0;
+
+  switch (lua_type(L, index)) {
+    case LUA_TNIL:
+    case LUA_TNONE:
+      return ~0u;
+    case LUA_TSTRING: {
+      const char* name = lua_tostring(L, index);
+      uint32_t tag = lovrWorldFindTag(world, name);
+      lovrCheck(tag != NO_TAG, "Unknown tag '%s'", name);
+      return 1u << tag;
+    }
+    case LUA_TTABLE: {
+      int length = luax_len(L, index);
+      for (int i = 0; i < length; i++) {
+        lua_rawgeti(L, index, i + 1);
+        const char* name = lua_tostring(L, -1);
+        uint32_t tag = name ? lovrWorldFindTag(world, name) : NO_TAG;
+        lovrCheck(tag != NO_TAG, "Unknown tag '%s'", name ? name : "nil");
+        mask |= 1u << tag;
+        lua_pop(L, 1);
+      }
+      return mask;
+    }
+    default:
+      return luax_typeerror(L, index, "string, table, or nil");
+  }
+}
+
+static int luax_pushqueryresults(lua_State* L, int index, Shape** shapes, uint32_t count) {
+  if (lua_istable(L, index)) {
+    lua_settop(L, index);
+  } else {
+    lua_createtable(L, count, 0);
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    luax_pushshape(L, shapes[i]);
+    lua_rawseti(L, -2, i + 1);
+  }
+
+  int length = luax_len(L, -1);
+  for (int i = count + 1; i <= length; i++) {
+    lua_pushnil(L);
+    lua_rawseti(L, -2, i);
+  }
+
+  return 1;
+}
+
 static void collisionResolver(World* world, void* userdata) {
   lua_State* L = userdata;
   luaL_checktype(L, -1, LUA_TFUNCTION);
@@ -163,6 +286,96 @@ static int l_lovrWorldGetTags(lua_State* L) {
   return 1;
 }
 
+static int l_lovrWorldGetBroadphase(lua_State* L) {
+  World* world = luax_checktype(L, 1, World);
+  luax_pushenum(L, BroadphaseType, lovrWorldGetBroadphase(world));
+  return 1;
+}
+
+static int l_lovrWorldGetThreadCount(lua_State* L) {
+  World* world = luax_checktype(L, 1, World);
+  lua_pushinteger(L, lovrWorldGetThreadCount(world));
+  return 1;
+}
+
+static int l_lovrWorldGetCollisionStats(lua_State* L) {
+  World* world = luax_checktype(L, 1, World);
+  CollisionStats stats;
+  lovrWorldGetCollisionStats(world, &stats);
+  lua_newtable(L);
+  lua_pushinteger(L, stats.pairsCulled), lua_setfield(L, -2, "pairsCulled");
+  lua_pushinteger(L, stats.pairsOverlapping), lua_setfield(L, -2, "pairsOverlapping");
+  lua_pushinteger(L, stats.pairsRejected), lua_setfield(L, -2, "pairsRejected");
+  lua_pushinteger(L, stats.pairsAccepted), lua_setfield(L, -2, "pairsAccepted");
+  lua_pushinteger(L, stats.contacts), lua_setfield(L, -2, "contacts");
+  lua_pushinteger(L, stats.eventsDropped), lua_setfield(L, -2, "eventsDropped");
+  return 1;
+}
+
+static int l_lovrWorldIsCountingCulledPairs(lua_State* L) {
+  World* world = luax_checktype(L, 1, World);
+  lua_pushboolean(L, lovrWorldIsCountingCulledPairs(world));
+  return 1;
+}
+
+static int l_lovrWorldSetCountingCulledPairs(lua_State* L) {
+  World* world = luax_checktype(L, 1, World);
+  bool enable = lua_toboolean(L, 2);
+  lovrWorldSetCountingCulledPairs(world, enable);
+  return 0;
+}
+
+static int l_lovrWorldGetStepTimings(lua_State* L) {
+  World* world = luax_checktype(L, 1, World);
+  StepTimings timings;
+  lovrWorldGetStepTimings(world, &timings);
+  lua_pushnumber(L, timings.broadphase);
+  lua_pushnumber(L, timings.narrowphase);
+  lua_pushnumber(L, timings.solve);
+  return 3;
+}
+
+static int l_lovrWorldGetContactEventCapacity(lua_State* L) {
+  World* world = luax_checktype(L, 1, World);
+  lua_pushinteger(L, lovrWorldGetContactEventCapacity(world));
+  return 1;
+}
+
+static int l_lovrWorldSetContactEventCapacity(lua_State* L) {
+  World* world = luax_checktype(L, 1, World);
+  uint32_t capacity = luax_checku32(L, 2);
+  lovrWorldSetContactEventCapacity(world, capacity);
+  return 0;
+}
+
+static int l_lovrWorldGetContactEvents(lua_State* L) {
+  World* world = luax_checktype(L, 1, World);
+  lua_newtable(L);
+  ContactEvent event;
+  int index = 1;
+  while (lovrWorldPollContactEvent(world, &event)) {
+    lua_createtable(L, 0, 11);
+    luax_pushenum(L, ContactEventType, event.type);
+    lua_setfield(L, -2, "type");
+    luax_pushshape(L, event.a);
+    lua_setfield(L, -2, "a");
+    luax_pushshape(L, event.b);
+    lua_setfield(L, -2, "b");
+    lua_pushnumber(L, event.position[0]), lua_setfield(L, -2, "x");
+    lua_pushnumber(L, event.position[1]), lua_setfield(L, -2, "y");
+    lua_pushnumber(L, event.position[2]), lua_setfield(L, -2, "z");
+    lua_pushnumber(L, event.normal[0]), lua_setfield(L, -2, "nx");
+    lua_pushnumber(L, event.normal[1]), lua_setfield(L, -2, "ny");
+    lua_pushnumber(L, event.normal[2]), lua_setfield(L, -2, "nz");
+    lua_pushnumber(L, event.depth), lua_setfield(L, -2, "depth");
+    lua_pushnumber(L, event.impulse), lua_setfield(L, -2, "impulse");
+    lua_rawseti(L, -2, index++);
+    lovrRelease(event.a, lovrShapeDestroy);
+    lovrRelease(event.b, lovrShapeDestroy);
+  }
+  return 1;
+}
+
 static int l_lovrWorldDestroy(lua_State* L) {
   World* world = luax_checktype(L, 1, World);
   lovrWorldDestroyData(world);
@@ -174,7 +387,28 @@ static int l_lovrWorldUpdate(lua_State* L) {
   World* world = luax_checktype(L, 1, World);
   float dt = luax_checkfloat(L, 2);
   CollisionResolver resolver = lua_type(L, 3) == LUA_TFUNCTION ? collisionResolver : NULL;
-  lovrWorldUpdate(world, dt, resolver, L);
+  uint32_t steps = lovrWorldUpdate(world, dt, resolver, L);
+  lua_pushinteger(L, steps);
+  return 1;
+}
+
+static int l_lovrWorldGetTimestep(lua_State* L) {
+  World* world = luax_checktype(L, 1, World);
+  float timestep;
+  uint32_t maxSubsteps;
+  lovrWorldGetTimestep(world, &timestep, &maxSubsteps);
+  lua_pushnumber(L, timestep);
+  lua_pushinteger(L, maxSubsteps);
+  return 2;
+}
+
+static int l_lovrWorldSetTimestep(lua_State* L) {
+  World* world = luax_checktype(L, 1, World);
+  float timestep = luax_optfloat(L, 2, 0.f);
+  uint32_t maxSubsteps = luax_optu32(L, 3, 4);
+  lovrCheck(timestep >= 0.f, "Timestep can not be negative");
+  lovrCheck(maxSubsteps > 0, "Max substep count must be positive");
+  lovrWorldSetTimestep(world, timestep, maxSubsteps);
   return 0;
 }
 
@@ -242,6 +476,243 @@ static int l_lovrWorldRaycast(lua_State* L) {
   return 0;
 }
 
+static int l_lovrWorldRaycastBatch(lua_State* L) {
+  World* world = luax_checktype(L, 1, World);
+  uint32_t length;
+  float* rays = luax_tofloats(L, 2, &length, NULL);
+  bool raysTable = !rays;
+
+  if (raysTable) {
+    luaL_checktype(L, 2, LUA_TTABLE);
+    length = luax_len(L, 2);
+  }
+
+  lovrCheck(length % 6 == 0, "Raycast batch needs 6 numbers per ray (origin and direction)");
+  uint32_t count = length / 6;
+
+  uint32_t capacity;
+  void* staged = NULL;
+  float* results = luax_tofloats(L, 3, &capacity, &staged);
+
+  if (results || staged) {
+    lovrCheck(capacity >= count * 8, "Raycast batch results need room for %d numbers", count * 8);
+  } else if (lua_isnoneornil(L, 3)) {
+    lua_createtable(L, count * 8, 0);
+    lua_replace(L, 3);
+  } else {
+    luaL_checktype(L, 3, LUA_TTABLE);
+  }
+
+  bool shapes = lua_istable(L, 4);
+  RaycastMode mode = luax_checkenum(L, 5, RaycastMode, "closest");
+
+  RaycastHit* hits = malloc(count * (sizeof(RaycastHit) + (raysTable ? 6 * sizeof(float) : 0)));
+  lovrAssert(hits, "Out of memory");
+
+  if (raysTable) {
+    rays = (float*) (hits + count);
+    for (uint32_t i = 0; i < length; i++) {
+      lua_rawgeti(L, 2, i + 1);
+      rays[i] = luax_tofloat(L, -1);
+      lua_pop(L, 1);
+    }
+  }
+
+  uint32_t hitCount = lovrWorldRaycastBatch(world, rays, count, mode, hits);
+
+  if (staged && count > 0) {
+    results = luax_stagefloats(staged, 0, count * 8);
+  }
+
+  // Each result is a position, normal, distance, and a 1 or 0 for whether the ray hit anything
+  for (uint32_t i = 0; i < count; i++) {
+    RaycastHit* hit = &hits[i];
+    float result[8] = { 0.f };
+
+    if (hit->shape) {
+      float* p = hit->position;
+      float* n = hit->normal;
+      float hitResult[8] = { p[0], p[1], p[2], n[0], n[1], n[2], hit->distance, 1.f };
+      memcpy(result, hitResult, sizeof(result));
+    }
+
+    if (results) {
+      memcpy(results + 8 * i, result, sizeof(result));
+    } else {
+      for (uint32_t j = 0; j < 8; j++) {
+        lua_pushnumber(L, result[j]);
+        lua_rawseti(L, 3, 8 * i + j + 1);
+      }
+    }
+
+    if (shapes) {
+      if (hit->shape) {
+        luax_pushshape(L, hit->shape);
+      } else {
+        lua_pushboolean(L, false);
+      }
+      lua_rawseti(L, 4, i + 1);
+    }
+  }
+
+  free(hits);
+  lua_pushinteger(L, hitCount);
+  lua_pushvalue(L, 3);
+  return 2;
+}
+
+static int l_lovrWorldQueryBox(lua_State* L) {
+  World* world = luax_checktype(L, 1, World);
+  float position[4], size[4], orientation[4];
+  int index = luax_readvec3(L, 2, position, NULL);
+  index = luax_readvec3(L, index, size, NULL);
+  int type = lua_type(L, index);
+  if (type == LUA_TSTRING || type == LUA_TTABLE) {
+    quat_identity(orientation);
+  } else {
+    index = luax_readquat(L, index, orientation, NULL);
+  }
+  uint32_t tagMask = luax_opttagmask(L, index, world);
+  uint32_t count;
+  Shape** shapes = lovrWorldQueryBox(world, position, size, orientation, tagMask, &count);
+  return luax_pushqueryresults(L, index + 1, shapes, count);
+}
+
+static int l_lovrWorldQuerySphere(lua_State* L) {
+  World* world = luax_checktype(L, 1, World);
+  float position[4];
+  int index = luax_readvec3(L, 2, position, NULL);
+  float radius = luax_checkfloat(L, index++);
+  uint32_t tagMask = luax_opttagmask(L, index, world);
+  uint32_t count;
+  Shape** shapes = lovrWorldQuerySphere(world, position, radius, tagMask, &count);
+  return luax_pushqueryresults(L, index + 1, shapes, count);
+}
+
+static int l_lovrWorldSweep(lua_State* L) {
+  World* world = luax_checktype(L, 1, World);
+  Shape* shape = luax_checkshape(L, 2);
+  float start[4], end[4], orientation[4];
+  int index = luax_readvec3(L, 3, start, NULL);
+  index = luax_readvec3(L, index, end, NULL);
+  int type = lua_type(L, index);
+  if (type == LUA_TSTRING || type == LUA_TTABLE) {
+    quat_identity(orientation);
+  } else {
+    index = luax_readquat(L, index, orientation, NULL);
+  }
+  uint32_t tagMask = luax_opttagmask(L, index, world);
+  RaycastHit hit;
+  if (!lovrWorldSweep(world, shape, start, end, orientation, tagMask, &hit)) {
+    lua_pushnil(L);
+    return 1;
+  }
+  luax_pushshape(L, hit.shape);
+  lua_pushnumber(L, hit.position[0]);
+  lua_pushnumber(L, hit.position[1]);
+  lua_pushnumber(L, hit.position[2]);
+  lua_pushnumber(L, hit.normal[0]);
+  lua_pushnumber(L, hit.normal[1]);
+  lua_pushnumber(L, hit.normal[2]);
+  lua_pushnumber(L, hit.distance);
+  return 8;
+}
+
+static int l_lovrWorldGetPoses(lua_State* L) {
+  lua_settop(L, 5);
+  World* world = luax_checktype(L, 1, World);
+  uint32_t capacity;
+  void* staged = NULL;
+  float* poses = luax_tofloats(L, 2, &capacity, &staged);
+  if (!poses && !staged) return luax_typeerror(L, 2, "Blob or Buffer");
+  PoseFormat format = luax_checkenum(L, 4, PoseFormat, "transform");
+  bool awakeOnly = lua_toboolean(L, 5);
+  uint32_t stride = format == POSE_MATRIX ? 16 : 8;
+  uint32_t count;
+  Collider** colliders = luax_optcolliders(L, 3, world, &count);
+  lovrCheck(capacity >= count * stride, "Not enough room for %d poses (need %d numbers)", count, count * stride);
+  uint32_t* indices = awakeOnly ? lua_newuserdata(L, MAX(count, 1) * sizeof(uint32_t)) : NULL;
+
+  // A persistent Buffer gets all of the poses in one staged copy.  With only awake colliders, the
+  // poses go to a scratch array first and each run of consecutive written poses is staged, so the
+  // sleeping colliders' poses in the Buffer are kept.
+  if (staged && count > 0) {
+    poses = awakeOnly ? lua_newuserdata(L, count * stride * sizeof(float)) : luax_stagefloats(staged, 0, count * stride);
+  }
+
+  uint32_t written = count > 0 ? lovrWorldGetPoses(world, colliders, count, format, awakeOnly, poses, indices) : 0;
+
+  if (staged && awakeOnly) {
+    for (uint32_t i = 0; i < written;) {
+      uint32_t first = indices[i];
+      uint32_t last = first;
+      while (++i < written && indices[i] == last + 1) last++;
+      uint32_t floats = (last - first + 1) * stride;
+      memcpy(luax_stagefloats(staged, first * stride, floats), poses + first * stride, floats * sizeof(float));
+    }
+  }
+
+  lua_pushinteger(L, written);
+
+  if (!awakeOnly) {
+    return 1;
+  }
+
+  lua_createtable(L, written, 0);
+  for (uint32_t i = 0; i < written; i++) {
+    lua_pushinteger(L, indices[i] + 1);
+    lua_rawseti(L, -2, i + 1);
+  }
+  return 2;
+}
+
+static int l_lovrWorldSetPoses(lua_State* L) {
+  lua_settop(L, 4);
+  World* world = luax_checktype(L, 1, World);
+  uint32_t capacity;
+  float* poses = luax_tofloats(L, 2, &capacity, NULL);
+  if (!poses) return luax_typeerror(L, 2, "Blob or Buffer");
+  PoseFormat format = luax_checkenum(L, 4, PoseFormat, "transform");
+  uint32_t stride = format == POSE_MATRIX ? 16 : 8;
+  uint32_t count;
+  Collider** colliders = luax_optcolliders(L, 3, world, &count);
+  if (colliders) {
+    lovrCheck(capacity >= count * stride, "Expected %d numbers for %d poses", count * stride, count);
+  } else {
+    count = capacity / stride;
+  }
+  lua_pushinteger(L, lovrWorldSetPoses(world, colliders, count, format, poses));
+  return 1;
+}
+
+static int l_lovrWorldSnapshot(lua_State* L) {
+  World* world = luax_checktype(L, 1, World);
+  Blob* blob = luax_totype(L, 2, Blob);
+  size_t size = lovrWorldGetSnapshotSize(world);
+
+  // An existing Blob is reused when it's big enough, which avoids garbage when snapshotting often
+  if (blob && blob->size >= size) {
+    lovrWorldSnapshot(world, blob->data, blob->size);
+    lua_settop(L, 2);
+    return 1;
+  }
+
+  void* data = malloc(size);
+  lovrAssert(data, "Out of memory");
+  lovrWorldSnapshot(world, data, size);
+  blob = lovrBlobCreate(data, size, "World snapshot");
+  luax_pushtype(L, Blob, blob);
+  lovrRelease(blob, lovrBlobDestroy);
+  return 1;
+}
+
+static int l_lovrWorldRestore(lua_State* L) {
+  World* world = luax_checktype(L, 1, World);
+  Blob* blob = luax_checktype(L, 2, Blob);
+  lovrWorldRestore(world, blob->data, blob->size);
+  return 0;
+}
+
 static int l_lovrWorldGetGravity(lua_State* L) {
   World* world = luax_checktype(L, 1, World);
   float x, y, z;
@@ -385,13 +856,32 @@ const luaL_Reg lovrWorld[] = {
   { "newTerrainCollider", l_lovrWorldNewTerrainCollider },
   { "getColliders", l_lovrWorldGetColliders },
   { "getTags", l_lovrWorldGetTags },
+  { "getBroadphase", l_lovrWorldGetBroadphase },
+  { "getThreadCount", l_lovrWorldGetThreadCount },
+  { "getCollisionStats", l_lovrWorldGetCollisionStats },
+  { "isCountingCulledPairs", l_lovrWorldIsCountingCulledPairs },
+  { "setCountingCulledPairs", l_lovrWorldSetCountingCulledPairs },
+  { "getStepTimings", l_lovrWorldGetStepTimings },
+  { "getContactEventCapacity", l_lovrWorldGetContactEventCapacity },
+  { "setContactEventCapacity", l_lovrWorldSetContactEventCapacity },
+  { "getContactEvents", l_lovrWorldGetContactEvents },
   { "destroy", l_lovrWorldDestroy },
   { "update", l_lovrWorldUpdate },
+  { "getTimestep", l_lovrWorldGetTimestep },
+  { "setTimestep", l_lovrWorldSetTimestep },
   { "computeOverlaps", l_lovrWorldComputeOverlaps },
   { "overlaps", l_lovrWorldOverlaps },
   { "collide", l_lovrWorldCollide },
   { "getContacts", l_lovrWorldGetContacts },
   { "raycast", l_lovrWorldRaycast },
+  { "raycastBatch", l_lovrWorldRaycastBatch },
+  { "queryBox", l_lovrWorldQueryBox },
+  { "querySphere", l_lovrWorldQuerySphere },
+  { "sweep", l_lovrWorldSweep },
+  { "getPoses", l_lovrWorldGetPoses },
+  { "setPoses", l_lovrWorldSetPoses },
+  { "snapshot", l_lovrWorldSnapshot },
+  { "restore", l_lovrWorldRestore },
   { "getGravity", l_lovrWorldGetGravity },
   { "setGravity", l_lovrWorldSetGravity },
   { "getTightness", l_lovrWorldGetTightness },
@@ -0,0 +1,365 @@
+#include "bc.h"
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#define CLAMP(x, lo, hi) ((x) < (lo) ? (lo) : ((x) > (hi) ? (hi) : (x)))
+
+// Endpoints are found by fitting a line through the block's colors (principal component analysis)
+// and taking the extents of the projected points.  They're then refined once with least squares.
+
+static void fitLine(const float* points, int channels, float e0[4], float e1[4]) {
+  float mean[4] = { 0.f };
+  for (int i = 0; i < 16; i++) {
+    for (int c = 0; c < channels; c++) {
+      mean[c] += points[i * 4 + c] / 16.f;
+    }
+  }
+
+  float cov[4][4] = { { 0.f } };
+  for (int i = 0; i < 16; i++) {
+    float d[4] = { 0.f };
+    for (int c = 0; c < channels; c++) d[c] = points[i * 4 + c] - mean[c];
+    for (int r = 0; r < channels; r++) {
+      for (int c = 0; c < channels; c++) {
+        cov[r][c] += d[r] * d[c];
+      }
+    }
+  }
+
+  // Power iteration, starting from the channel with the most variance
+  float axis[4] = { 0.f };
+  int start = 0;
+  for (int c = 1; c < channels; c++) if (cov[c][c] > cov[start][start]) start = c;
+  for (int c = 0; c < channels; c++) axis[c] = cov[start][c];
+
+  for (int iteration = 0; iteration < 8; iteration++) {
+    float next[4] = { 0.f };
+    float length = 0.f;
+    for (int r = 0; r < channels; r++) {
+      for (int c = 0; c < channels; c++) next[r] += cov[r][c] * axis[c];
+      length += next[r] * next[r];
+    }
+    if (length < 1e-12f) break;
+    length = 1.f / sqrtf(length);
+    for (int c = 0; c < channels; c++) axis[c] = next[c] * length;
+  }
+
+  float length = 0.f;
+  for (int c = 0; c < channels; c++) length += axis[c] * axis[c];
+  if (length < 1e-12f) {
+    for (int c = 0; c < channels; c++) e0[c] = e1[c] = mean[c];
+    return;
+  }
+
+  float tmin = 1e30f, tmax = -1e30f;
+  for (int i = 0; i < 16; i++) {
+    float t = 0.f;
+    for (int c = 0; c < channels; c++) t += (points[i * 4 + c] - mean[c]) * axis[c];
+    tmin = t < tmin ? t : tmin;
+    tmax = t > tmax ? t : tmax;
+  }
+
+  for (int c = 0; c < channels; c++) {
+    e0[c] = CLAMP(mean[c] + axis[c] * tmin, 0.f, 255.f);
+    e1[c] = CLAMP(mean[c] + axis[c] * tmax, 0.f, 255.f);
+  }
+}
+
+// Solves for the endpoints that minimize the squared error given fixed interpolation weights
+static bool leastSquares(const float* points, int channels, const float weights[16], float e0[4], float e1[4]) {
+  float aa = 0.f, ab = 0.f, bb = 0.f;
+  float ap[4] = { 0.f }, bp[4] = { 0.f };
+  for (int i = 0; i < 16; i++) {
+    float b = weights[i];
+    float a = 1.f - b;
+    aa += a * a;
+    ab += a * b;
+    bb += b * b;
+    for (int c = 0; c < channels; c++) {
+      ap[c] += a * points[i * 4 + c];
+      bp[c] += b * points[i * 4 + c];
+    }
+  }
+
+  float det = aa * bb - ab * ab;
+  if (fabsf(det) < 1e-6f) {
+    return false;
+  }
+
+  float inv = 1.f / det;
+  for (int c = 0; c < channels; c++) {
+    e0[c] = CLAMP((bb * ap[c] - ab * bp[c]) * inv, 0.f, 255.f);
+    e1[c] = CLAMP((aa * bp[c] - ab * ap[c]) * inv, 0.f, 255.f);
+  }
+
+  return true;
+}
+
+static void toFloat(float points[64], const uint8_t pixels[64]) {
+  for (int i = 0; i < 64; i++) {
+    points[i] = pixels[i];
+  }
+}
+
+// BC1
+
+static uint16_t pack565(const float color[3]) {
+  uint16_t r = (uint16_t) (color[0] * 31.f / 255.f + .5f);
+  uint16_t g = (uint16_t) (color[1] * 63.f / 255.f + .5f);
+  uint16_t b = (uint16_t) (color[2] * 31.f / 255.f + .5f);
+  return (r << 11) | (g << 5) | b;
+}
+
+static void unpack565(uint16_t packed, int color[3]) {
+  int r = (packed >> 11) & 0x1f;
+  int g = (packed >> 5) & 0x3f;
+  int b = packed & 0x1f;
+  color[0] = (r << 3) | (r >> 2);
+  color[1] = (g << 2) | (g >> 4);
+  color[2] = (b << 3) | (b >> 2);
+}
+
+// Picks indices for a 4 color palette (c0, c1, 2/3 c0 + 1/3 c1, 1/3 c0 + 2/3 c1), returns error
+static uint32_t bc1Indices(const uint8_t pixels[64], uint16_t c0, uint16_t c1, uint8_t indices[16]) {
+  int palette[4][3];
+  unpack565(c0, palette[0]);
+  unpack565(c1, palette[1]);
+  for (int c = 0; c < 3; c++) {
+    palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+    palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+  }
+
+  uint32_t total = 0;
+  for (int i = 0; i < 16; i++) {
+    uint32_t best = ~0u;
+    for (int j = 0; j < 4; j++) {
+      int dr = pixels[i * 4 + 0] - palette[j][0];
+      int dg = pixels[i * 4 + 1] - palette[j][1];
+      int db = pixels[i * 4 + 2] - palette[j][2];
+      uint32_t error = dr * dr + dg * dg + db * db;
+      if (error < best) {
+        best = error;
+        indices[i] = j;
+      }
+    }
+    total += best;
+  }
+  return total;
+}
+
+void bc1_encode(uint8_t block[8], const uint8_t pixels[64]) {
+  float points[64];
+  float e0[4], e1[4];
+  toFloat(points, pixels);
+  fitLine(points, 3, e0, e1);
+
+  uint8_t indices[16];
+  uint16_t c0 = pack565(e0);
+  uint16_t c1 = pack565(e1);
+  uint32_t error = bc1Indices(pixels, c0, c1, indices);
+
+  if (error > 0) {
+    static const float weights[4] = { 0.f, 1.f, 1.f / 3.f, 2.f / 3.f };
+    float w[16];
+    for (int i = 0; i < 16; i++) w[i] = weights[indices[i]];
+
+    if (leastSquares(points, 3, w, e0, e1)) {
+      uint8_t refined[16];
+      uint16_t r0 = pack565(e0);
+      uint16_t r1 = pack565(e1);
+      uint32_t refinedError = bc1Indices(pixels, r0, r1, refined);
+      if (refinedError < error) {
+        memcpy(indices, refined, sizeof(indices));
+        c0 = r0;
+        c1 = r1;
+      }
+    }
+  }
+
+  // 4 color mode requires c0 > c1, swapping the endpoints swaps indices 0/1 and 2/3
+  if (c0 < c1) {
+    uint16_t tmp = c0;
+    c0 = c1;
+    c1 = tmp;
+    for (int i = 0; i < 16; i++) indices[i] ^= 1;
+  } else if (c0 == c1) {
+    memset(indices, 0, sizeof(indices));
+  }
+
+  uint32_t bits = 0;
+  for (int i = 0; i < 16; i++) {
+    bits |= (uint32_t) indices[i] << (2 * i);
+  }
+
+  block[0] = c0 & 0xff;
+  block[1] = c0 >> 8;
+  block[2] = c1 & 0xff;
+  block[3] = c1 >> 8;
+  block[4] = (bits >> 0) & 0xff;
+  block[5] = (bits >> 8) & 0xff;
+  block[6] = (bits >> 16) & 0xff;
+  block[7] = (bits >> 24) & 0xff;
+}
+
+// BC3
+
+static void bc4Encode(uint8_t block[8], const uint8_t pixels[64], int channel) {
+  int lo = 255, hi = 0;
+  for (int i = 0; i < 16; i++) {
+    int value = pixels[i * 4 + channel];
+    lo = value < lo ? value : lo;
+    hi = value > hi ? value : hi;
+  }
+
+  memset(block, 0, 8);
+  block[0] = hi;
+  block[1] = lo;
+
+  if (hi == lo) {
+    return;
+  }
+
+  // 8 value mode (a0 > a1): a0, a1, then 6 evenly spaced values from a0 to a1
+  int palette[8] = { hi, lo };
+  for (int j = 1; j < 7; j++) {
+    palette[j + 1] = ((7 - j) * hi + j * lo) / 7;
+  }
+
+  uint64_t bits = 0;
+  for (int i = 0; i < 16; i++) {
+    int value = pixels[i * 4 + channel];
+    int best = 256, index = 0;
+    for (int j = 0; j < 8; j++) {
+      int error = value > palette[j] ? value - palette[j] : palette[j] - value;
+      if (error < best) {
+        best = error;
+        index = j;
+      }
+    }
+    bits |= (uint64_t) index << (3 * i);
+  }
+
+  for (int i = 0; i < 6; i++) {
+    block[2 + i] = (bits >> (8 * i)) & 0xff;
+  }
+}
+
+void bc3_encode(uint8_t block[16], const uint8_t pixels[64]) {
+  bc4Encode(block, pixels, 3);
+  bc1_encode(block + 8, pixels);
+}
+
+// BC7 (mode 6)
+
+static const int bc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// Quantizes an endpoint to 7 bits per channel plus a shared p-bit, returns the 8 bit value
+static void bc7Quantize(const float endpoint[4], uint8_t quantized[4], uint8_t* pbit) {
+  uint32_t bestError = ~0u;
+  for (int p = 0; p < 2; p++) {
+    uint8_t q[4];
+    uint32_t error = 0;
+    for (int c = 0; c < 4; c++) {
+      int value = (int) ((endpoint[c] - p) / 2.f + .5f);
+      q[c] = CLAMP(value, 0, 127);
+      int d = (int) (endpoint[c] + .5f) - ((q[c] << 1) | p);
+      error += d * d;
+    }
+    if (error < bestError) {
+      bestError = error;
+      memcpy(quantized, q, 4);
+      *pbit = p;
+    }
+  }
+}
+
+static uint32_t bc7Indices(const uint8_t pixels[64], uint8_t q[2][4], uint8_t p[2], uint8_t indices[16]) {
+  int palette[16][4];
+  for (int c = 0; c < 4; c++) {
+    int a = (q[0][c] << 1) | p[0];
+    int b = (q[1][c] << 1) | p[1];
+    for (int j = 0; j < 16; j++) {
+      palette[j][c] = ((64 - bc7Weights[j]) * a + bc7Weights[j] * b + 32) >> 6;
+    }
+  }
+
+  uint32_t total = 0;
+  for (int i = 0; i < 16; i++) {
+    uint32_t best = ~0u;
+    for (int j = 0; j < 16; j++) {
+      uint32_t error = 0;
+      for (int c = 0; c < 4; c++) {
+        int d = pixels[i * 4 + c] - palette[j][c];
+        error += d * d;
+      }
+      if (error < best) {
+        best = error;
+        indices[i] = j;
+      }
+    }
+    total += best;
+  }
+  return total;
+}
+
+static void writeBits(uint8_t block[16], uint32_t* offset, uint32_t value, uint32_t count) {
+  for (uint32_t i = 0; i < count; i++, (*offset)++) {
+    block[*offset >> 3] |= ((value >> i) & 1) << (*offset & 7);
+  }
+}
+
+void bc7_encode(uint8_t block[16], const uint8_t pixels[64]) {
+  float points[64];
+  float e0[4], e1[4];
+  toFloat(points, pixels);
+  fitLine(points, 4, e0, e1);
+
+  uint8_t q[2][4], p[2], indices[16];
+  bc7Quantize(e0, q[0], &p[0]);
+  bc7Quantize(e1, q[1], &p[1]);
+  uint32_t error = bc7Indices(pixels, q, p, indices);
+
+  if (error > 0) {
+    float w[16];
+    for (int i = 0; i < 16; i++) w[i] = bc7Weights[indices[i]] / 64.f;
+
+    if (leastSquares(points, 4, w, e0, e1)) {
+      uint8_t rq[2][4], rp[2], refined[16];
+      bc7Quantize(e0, rq[0], &rp[0]);
+      bc7Quantize(e1, rq[1], &rp[1]);
+      uint32_t refinedError = bc7Indices(pixels, rq, rp, refined);
+      if (refinedError < error) {
+        memcpy(q, rq, sizeof(q));
+        memcpy(p, rp, sizeof(p));
+        memcpy(indices, refined, sizeof(indices));
+      }
+    }
+  }
+
+  // The anchor index (first pixel) has its high bit implied to be zero, swap endpoints if it's set
+  if (indices[0] & 8) {
+    uint8_t tmp[4];
+    memcpy(tmp, q[0], 4);
+    memcpy(q[0], q[1], 4);
+    memcpy(q[1], tmp, 4);
+    uint8_t pbit = p[0];
+    p[0] = p[1];
+    p[1] = pbit;
+    for (int i = 0; i < 16; i++) indices[i] = 15 - indices[i];
+  }
+
+  uint32_t offset = 0;
+  memset(block, 0, 16);
+  writeBits(block, &offset, 1 << 6, 7);
+  for (int c = 0; c < 4; c++) {
+    writeBits(block, &offset, q[0][c], 7);
+    writeBits(block, &offset, q[1][c], 7);
+  }
+  writeBits(block, &offset, p[0], 1);
+  writeBits(block, &offset, p[1], 1);
+  writeBits(block, &offset, indices[0], 3);
+  for (int i = 1; i < 16; i++) {
+    writeBits(block, &offset, indices[i], 4);
+  }
+}
@@ -0,0 +1,13 @@
+#include <stdint.h>
+
+// Block compression encoders for 4x4 RGBA8 blocks (pixels are row-major, 64 bytes per block)
+// - bc1 is opaque only (alpha is ignored, no punch-through mode)
+// - bc3 uses the bc1 color encoder along with an 8 level interpolated alpha block
+// - bc7 only uses mode 6 (1 subset, 7777.1 endpoints, 4 bit indices), which is a good fit for
+//   smooth color/alpha and keeps the encoder fast.  Other modes may be added later.
+
+#pragma once
+
+void bc1_encode(uint8_t block[8], const uint8_t pixels[64]);
+void bc3_encode(uint8_t block[16], const uint8_t pixels[64]);
+void bc7_encode(uint8_t block[16], const uint8_t pixels[64]);
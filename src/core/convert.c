@@ -0,0 +1,383 @@
+#include "convert.h"
+#include <math.h>
+
+#if defined(LOVR_CONVERT_SCALAR)
+// Scalar only, so tests and benchmarks can build the reference versions of the kernels
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CONVERT_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define CONVERT_NEON
+#include <arm_neon.h>
+#endif
+
+// Scalar reference versions, also used for the remainders of the vectorized loops
+
+static inline float saturate(float x) {
+  return x > 0.f ? (x < 1.f ? x : 1.f) : 0.f; // NaN goes to zero
+}
+
+static inline float clampSigned(float x) {
+  return x > -1.f ? (x < 1.f ? x : 1.f) : (x <= -1.f ? -1.f : 0.f); // NaN goes to zero
+}
+
+// https://gist.github.com/rygorous/2156668 (float_to_half_fast3_rtne and half_to_float_fast2)
+
+static inline uint16_t f32_to_f16(float x) {
+  union { float f; uint32_t u; } f = { x };
+  uint32_t sign = f.u & 0x80000000u;
+  f.u ^= sign;
+
+  uint16_t h;
+  if (f.u >= (127u + 16u) << 23) {
+    h = f.u > 0x7f800000u ? 0x7e00 : 0x7c00;
+  } else if (f.u < (127u - 14u) << 23) {
+    union { uint32_t u; float f; } magic = { ((127u - 15u) + (23u - 10u) + 1u) << 23 };
+    f.f += magic.f;
+    h = (uint16_t) (f.u - magic.u);
+  } else {
+    uint32_t odd = (f.u >> 13) & 1;
+    f.u += (uint32_t) ((15 - 127) * (1 << 23)) + 0xfff + odd;
+    h = (uint16_t) (f.u >> 13);
+  }
+
+  return h | (uint16_t) (sign >> 16);
+}
+
+static inline float f16_to_f32(uint16_t h) {
+  union { uint32_t u; float f; } magic = { (254u - 15u) << 23 };
+  union { uint32_t u; float f; } infnan = { (127u + 16u) << 23 };
+  union { uint32_t u; float f; } o = { (uint32_t) (h & 0x7fff) << 13 };
+  o.f *= magic.f;
+  if (o.f >= infnan.f) o.u |= 255u << 23;
+  o.u |= (uint32_t) (h & 0x8000) << 16;
+  return o.f;
+}
+
+#ifdef CONVERT_SSE2
+static inline __m128i sse_f32_to_un(__m128 x, __m128 scale) {
+  x = _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()), _mm_set1_ps(1.f)); // max returns 0 for NaN
+  return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(x, scale), _mm_set1_ps(.5f)));
+}
+
+static inline __m128i sse_f32_to_f16(__m128 f) {
+  __m128 sign = _mm_and_ps(f, _mm_set1_ps(-0.f));
+  __m128 absf = _mm_xor_ps(f, sign);
+  __m128i bits = _mm_castps_si128(absf);
+
+  __m128i isRegular = _mm_cmpgt_epi32(_mm_set1_epi32((127 + 16) << 23), bits);
+  __m128i isSubnormal = _mm_cmpgt_epi32(_mm_set1_epi32((127 - 14) << 23), bits);
+  __m128i nanBit = _mm_and_si128(_mm_castps_si128(_mm_cmpunord_ps(absf, absf)), _mm_set1_epi32(0x200));
+  __m128i infOrNan = _mm_or_si128(nanBit, _mm_set1_epi32(0x7c00));
+
+  __m128i magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+  __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absf, _mm_castsi128_ps(magic))), magic);
+
+  __m128i odd = _mm_srai_epi32(_mm_slli_epi32(bits, 31 - 13), 31);
+  __m128i biased = _mm_add_epi32(bits, _mm_set1_epi32(0xfff - ((127 - 15) << 23)));
+  __m128i normal = _mm_srli_epi32(_mm_sub_epi32(biased, odd), 13);
+
+  __m128i finite = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+  __m128i result = _mm_or_si128(_mm_and_si128(isRegular, finite), _mm_andnot_si128(isRegular, infOrNan));
+  return _mm_or_si128(result, _mm_srai_epi32(_mm_castps_si128(sign), 16)); // sign-extended for packs
+}
+
+static inline __m128 sse_clamp_signed(__m128 x) {
+  x = _mm_and_ps(x, _mm_cmpord_ps(x, x));
+  return _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-1.f)), _mm_set1_ps(1.f));
+}
+
+static inline __m128 sse_f16_to_f32(__m128i h) {
+  __m128i expmant = _mm_and_si128(h, _mm_set1_epi32(0x7fff));
+  __m128i sign = _mm_slli_epi32(_mm_xor_si128(h, expmant), 16);
+  __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expmant, 13)), _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23)));
+  __m128i wasInfNan = _mm_cmpgt_epi32(expmant, _mm_set1_epi32(0x7bff));
+  __m128 infNanExp = _mm_and_ps(_mm_castsi128_ps(wasInfNan), _mm_castsi128_ps(_mm_set1_epi32(255 << 23)));
+  return _mm_or_ps(_mm_or_ps(scaled, infNanExp), _mm_castsi128_ps(sign));
+}
+#endif
+
+#ifdef CONVERT_NEON
+static inline uint32x4_t neon_f32_to_un(float32x4_t x, float scale) {
+  x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(0.f)), vdupq_n_f32(1.f));
+  return vcvtq_u32_f32(vmlaq_n_f32(vdupq_n_f32(.5f), x, scale)); // NaN converts to 0
+}
+
+static inline float32x4_t neon_clamp_signed(float32x4_t x) {
+  x = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(x), vceqq_f32(x, x)));
+  return vminq_f32(vmaxq_f32(x, vdupq_n_f32(-1.f)), vdupq_n_f32(1.f));
+}
+#endif
+
+void convert_f32_to_un8(uint8_t* dst, const float* src, size_t count) {
+  size_t i = 0;
+#if defined(CONVERT_SSE2)
+  __m128 scale = _mm_set1_ps(255.f);
+  for (; i + 16 <= count; i += 16) {
+    __m128i a = sse_f32_to_un(_mm_loadu_ps(src + i + 0), scale);
+    __m128i b = sse_f32_to_un(_mm_loadu_ps(src + i + 4), scale);
+    __m128i c = sse_f32_to_un(_mm_loadu_ps(src + i + 8), scale);
+    __m128i d = sse_f32_to_un(_mm_loadu_ps(src + i + 12), scale);
+    __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+    _mm_storeu_si128((__m128i*) (dst + i), packed);
+  }
+#elif defined(CONVERT_NEON)
+  for (; i + 16 <= count; i += 16) {
+    uint16x4_t a = vmovn_u32(neon_f32_to_un(vld1q_f32(src + i + 0), 255.f));
+    uint16x4_t b = vmovn_u32(neon_f32_to_un(vld1q_f32(src + i + 4), 255.f));
+    uint16x4_t c = vmovn_u32(neon_f32_to_un(vld1q_f32(src + i + 8), 255.f));
+    uint16x4_t d = vmovn_u32(neon_f32_to_un(vld1q_f32(src + i + 12), 255.f));
+    uint8x16_t packed = vcombine_u8(vmovn_u16(vcombine_u16(a, b)), vmovn_u16(vcombine_u16(c, d)));
+    vst1q_u8(dst + i, packed);
+  }
+#endif
+  for (; i < count; i++) {
+    dst[i] = (uint8_t) (saturate(src[i]) * 255.f + .5f);
+  }
+}
+
+void convert_un8_to_f32(float* dst, const uint8_t* src, size_t count) {
+  size_t i = 0;
+#if defined(CONVERT_SSE2)
+  __m128 scale = _mm_set1_ps(1.f / 255.f);
+  __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= count; i += 16) {
+    __m128i bytes = _mm_loadu_si128((const __m128i*) (src + i));
+    __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+    __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+    _mm_storeu_ps(dst + i + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+    _mm_storeu_ps(dst + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+    _mm_storeu_ps(dst + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+  }
+#elif defined(CONVERT_NEON)
+  for (; i + 16 <= count; i += 16) {
+    uint8x16_t bytes = vld1q_u8(src + i);
+    uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+    uint16x8_t hi = vmovl_u8(vget_high_u8(bytes));
+    vst1q_f32(dst + i + 0, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), 1.f / 255.f));
+    vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), 1.f / 255.f));
+    vst1q_f32(dst + i + 8, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), 1.f / 255.f));
+    vst1q_f32(dst + i + 12, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), 1.f / 255.f));
+  }
+#endif
+  for (; i < count; i++) {
+    dst[i] = src[i] * (1.f / 255.f);
+  }
+}
+
+void convert_f32_to_un16(uint16_t* dst, const float* src, size_t count) {
+  size_t i = 0;
+#if defined(CONVERT_SSE2)
+  __m128 scale = _mm_set1_ps(65535.f);
+  __m128i bias = _mm_set1_epi32(32768);
+  __m128i flip = _mm_set1_epi16((short) 0x8000);
+  for (; i + 8 <= count; i += 8) {
+    // SSE2 has no unsigned 32 -> 16 pack, so pack signed around zero and flip the top bit back
+    __m128i a = _mm_sub_epi32(sse_f32_to_un(_mm_loadu_ps(src + i + 0), scale), bias);
+    __m128i b = _mm_sub_epi32(sse_f32_to_un(_mm_loadu_ps(src + i + 4), scale), bias);
+    _mm_storeu_si128((__m128i*) (dst + i), _mm_xor_si128(_mm_packs_epi32(a, b), flip));
+  }
+#elif defined(CONVERT_NEON)
+  for (; i + 8 <= count; i += 8) {
+    uint16x4_t a = vmovn_u32(neon_f32_to_un(vld1q_f32(src + i + 0), 65535.f));
+    uint16x4_t b = vmovn_u32(neon_f32_to_un(vld1q_f32(src + i + 4), 65535.f));
+    vst1q_u16(dst + i, vcombine_u16(a, b));
+  }
+#endif
+  for (; i < count; i++) {
+    dst[i] = (uint16_t) (saturate(src[i]) * 65535.f + .5f);
+  }
+}
+
+void convert_un16_to_f32(float* dst, const uint16_t* src, size_t count) {
+  size_t i = 0;
+#if defined(CONVERT_SSE2)
+  __m128 scale = _mm_set1_ps(1.f / 65535.f);
+  __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= count; i += 8) {
+    __m128i words = _mm_loadu_si128((const __m128i*) (src + i));
+    _mm_storeu_ps(dst + i + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero)), scale));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(words, zero)), scale));
+  }
+#elif defined(CONVERT_NEON)
+  for (; i + 8 <= count; i += 8) {
+    uint16x8_t words = vld1q_u16(src + i);
+    vst1q_f32(dst + i + 0, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(words))), 1.f / 65535.f));
+    vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(words))), 1.f / 65535.f));
+  }
+#endif
+  for (; i < count; i++) {
+    dst[i] = src[i] * (1.f / 65535.f);
+  }
+}
+
+void convert_f32_to_f16(uint16_t* dst, const float* src, size_t count) {
+  size_t i = 0;
+#if defined(CONVERT_SSE2)
+  for (; i + 8 <= count; i += 8) {
+    __m128i a = sse_f32_to_f16(_mm_loadu_ps(src + i + 0));
+    __m128i b = sse_f32_to_f16(_mm_loadu_ps(src + i + 4));
+    _mm_storeu_si128((__m128i*) (dst + i), _mm_packs_epi32(a, b));
+  }
+#elif defined(CONVERT_NEON)
+  for (; i + 8 <= count; i += 8) {
+    float16x4_t a = vcvt_f16_f32(vld1q_f32(src + i + 0));
+    float16x4_t b = vcvt_f16_f32(vld1q_f32(src + i + 4));
+    vst1q_u16(dst + i, vcombine_u16(vreinterpret_u16_f16(a), vreinterpret_u16_f16(b)));
+  }
+#endif
+  for (; i < count; i++) {
+    dst[i] = f32_to_f16(src[i]);
+  }
+}
+
+void convert_f16_to_f32(float* dst, const uint16_t* src, size_t count) {
+  size_t i = 0;
+#if defined(CONVERT_SSE2)
+  __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= count; i += 8) {
+    __m128i words = _mm_loadu_si128((const __m128i*) (src + i));
+    _mm_storeu_ps(dst + i + 0, sse_f16_to_f32(_mm_unpacklo_epi16(words, zero)));
+    _mm_storeu_ps(dst + i + 4, sse_f16_to_f32(_mm_unpackhi_epi16(words, zero)));
+  }
+#elif defined(CONVERT_NEON)
+  for (; i + 8 <= count; i += 8) {
+    uint16x8_t words = vld1q_u16(src + i);
+    vst1q_f32(dst + i + 0, vcvt_f32_f16(vreinterpret_f16_u16(vget_low_u16(words))));
+    vst1q_f32(dst + i + 4, vcvt_f32_f16(vreinterpret_f16_u16(vget_high_u16(words))));
+  }
+#endif
+  for (; i < count; i++) {
+    dst[i] = f16_to_f32(src[i]);
+  }
+}
+
+void convert_f32_to_i16(int16_t* dst, const float* src, size_t count) {
+  size_t i = 0;
+#if defined(CONVERT_SSE2)
+  __m128 scale = _mm_set1_ps(32767.f);
+  for (; i + 8 <= count; i += 8) {
+    __m128i a = _mm_cvtps_epi32(_mm_mul_ps(sse_clamp_signed(_mm_loadu_ps(src + i + 0)), scale));
+    __m128i b = _mm_cvtps_epi32(_mm_mul_ps(sse_clamp_signed(_mm_loadu_ps(src + i + 4)), scale));
+    _mm_storeu_si128((__m128i*) (dst + i), _mm_packs_epi32(a, b));
+  }
+#elif defined(CONVERT_NEON)
+  for (; i + 8 <= count; i += 8) {
+    int16x4_t a = vmovn_s32(vcvtnq_s32_f32(vmulq_n_f32(neon_clamp_signed(vld1q_f32(src + i + 0)), 32767.f)));
+    int16x4_t b = vmovn_s32(vcvtnq_s32_f32(vmulq_n_f32(neon_clamp_signed(vld1q_f32(src + i + 4)), 32767.f)));
+    vst1q_s16(dst + i, vcombine_s16(a, b));
+  }
+#endif
+  for (; i < count; i++) {
+    dst[i] = (int16_t) lrintf(clampSigned(src[i]) * 32767.f);
+  }
+}
+
+void convert_i16_to_f32(float* dst, const int16_t* src, size_t count) {
+  size_t i = 0;
+#if defined(CONVERT_SSE2)
+  __m128 scale = _mm_set1_ps(1.f / 32768.f);
+  for (; i + 8 <= count; i += 8) {
+    __m128i words = _mm_loadu_si128((const __m128i*) (src + i));
+    __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(words, words), 16);
+    __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(words, words), 16);
+    _mm_storeu_ps(dst + i + 0, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+  }
+#elif defined(CONVERT_NEON)
+  for (; i + 8 <= count; i += 8) {
+    int16x8_t words = vld1q_s16(src + i);
+    vst1q_f32(dst + i + 0, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(words))), 1.f / 32768.f));
+    vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(words))), 1.f / 32768.f));
+  }
+#endif
+  for (; i < count; i++) {
+    dst[i] = src[i] * (1.f / 32768.f);
+  }
+}
+
+void convert_clamp_f32(float* data, size_t count) {
+  size_t i = 0;
+#if defined(CONVERT_SSE2)
+  for (; i + 4 <= count; i += 4) {
+    _mm_storeu_ps(data + i, sse_clamp_signed(_mm_loadu_ps(data + i)));
+  }
+#elif defined(CONVERT_NEON)
+  for (; i + 4 <= count; i += 4) {
+    vst1q_f32(data + i, neon_clamp_signed(vld1q_f32(data + i)));
+  }
+#endif
+  for (; i < count; i++) {
+    data[i] = clampSigned(data[i]);
+  }
+}
+
+void convert_mix_stereo(float* dst, const float* src, size_t frames, float gain, float step) {
+  size_t i = 0;
+#if defined(CONVERT_SSE2)
+  // Each vector holds 2 stereo frames, so the frame offsets of the lanes are 0, 0, 1, 1
+  __m128 base = _mm_set1_ps(gain);
+  __m128 slope = _mm_set1_ps(step);
+  __m128 offset = _mm_set_ps(1.f, 1.f, 0.f, 0.f);
+  for (; i + 4 <= frames; i += 4) {
+    __m128 index = _mm_add_ps(_mm_set1_ps((float) i), offset);
+    __m128 a = _mm_add_ps(base, _mm_mul_ps(slope, index));
+    __m128 b = _mm_add_ps(base, _mm_mul_ps(slope, _mm_add_ps(index, _mm_set1_ps(2.f))));
+    _mm_storeu_ps(dst + 2 * i + 0, _mm_add_ps(_mm_loadu_ps(dst + 2 * i + 0), _mm_mul_ps(_mm_loadu_ps(src + 2 * i + 0), a)));
+    _mm_storeu_ps(dst + 2 * i + 4, _mm_add_ps(_mm_loadu_ps(dst + 2 * i + 4), _mm_mul_ps(_mm_loadu_ps(src + 2 * i + 4), b)));
+  }
+#elif defined(CONVERT_NEON)
+  static const float offsets[4] = { 0.f, 0.f, 1.f, 1.f };
+  float32x4_t offset = vld1q_f32(offsets);
+  for (; i + 4 <= frames; i += 4) {
+    float32x4_t index = vaddq_f32(vdupq_n_f32((float) i), offset);
+    float32x4_t a = vmlaq_n_f32(vdupq_n_f32(gain), index, step);
+    float32x4_t b = vmlaq_n_f32(vdupq_n_f32(gain), vaddq_f32(index, vdupq_n_f32(2.f)), step);
+    vst1q_f32(dst + 2 * i + 0, vmlaq_f32(vld1q_f32(dst + 2 * i + 0), vld1q_f32(src + 2 * i + 0), a));
+    vst1q_f32(dst + 2 * i + 4, vmlaq_f32(vld1q_f32(dst + 2 * i + 4), vld1q_f32(src + 2 * i + 4), b));
+  }
+#endif
+  for (; i < frames; i++) {
+    float g = gain + step * (float) i;
+    dst[2 * i + 0] += src[2 * i + 0] * g;
+    dst[2 * i + 1] += src[2 * i + 1] * g;
+  }
+}
+
+void convert_pan_mono(float* dst, const float* src, size_t frames, const float gain[2], const float step[2]) {
+  size_t i = 0;
+#if defined(CONVERT_SSE2)
+  // Lanes alternate left/right, so each vector covers 2 frames
+  __m128 base = _mm_set_ps(gain[1], gain[0], gain[1], gain[0]);
+  __m128 slope = _mm_set_ps(step[1], step[0], step[1], step[0]);
+  __m128 offset = _mm_set_ps(1.f, 1.f, 0.f, 0.f);
+  for (; i + 4 <= frames; i += 4) {
+    __m128 samples = _mm_loadu_ps(src + i);
+    __m128 index = _mm_add_ps(_mm_set1_ps((float) i), offset);
+    __m128 a = _mm_add_ps(base, _mm_mul_ps(slope, index));
+    __m128 b = _mm_add_ps(base, _mm_mul_ps(slope, _mm_add_ps(index, _mm_set1_ps(2.f))));
+    _mm_storeu_ps(dst + 2 * i + 0, _mm_mul_ps(_mm_unpacklo_ps(samples, samples), a));
+    _mm_storeu_ps(dst + 2 * i + 4, _mm_mul_ps(_mm_unpackhi_ps(samples, samples), b));
+  }
+#elif defined(CONVERT_NEON)
+  float lanes[4] = { gain[0], gain[1], gain[0], gain[1] };
+  float slopes[4] = { step[0], step[1], step[0], step[1] };
+  static const float offsets[4] = { 0.f, 0.f, 1.f, 1.f };
+  float32x4_t base = vld1q_f32(lanes);
+  float32x4_t slope = vld1q_f32(slopes);
+  float32x4_t offset = vld1q_f32(offsets);
+  for (; i + 4 <= frames; i += 4) {
+    float32x4_t samples = vld1q_f32(src + i);
+    float32x4_t index = vaddq_f32(vdupq_n_f32((float) i), offset);
+    float32x4_t a = vmlaq_f32(base, slope, index);
+    float32x4_t b = vmlaq_f32(base, slope, vaddq_f32(index, vdupq_n_f32(2.f)));
+    vst1q_f32(dst + 2 * i + 0, vmulq_f32(vzip1q_f32(samples, samples), a));
+    vst1q_f32(dst + 2 * i + 4, vmulq_f32(vzip2q_f32(samples, samples), b));
+  }
+#endif
+  for (; i < frames; i++) {
+    dst[2 * i + 0] = src[i] * (gain[0] + step[0] * (float) i);
+    dst[2 * i + 1] = src[i] * (gain[1] + step[1] * (float) i);
+  }
+}
@@ -0,0 +1,23 @@
+#include <stddef.h>
+#include <stdint.h>
+
+// Bulk numeric conversion kernels, vectorized with SSE2 or NEON when available.
+// - Counts are in components, not pixels or frames.
+// - Normalized outputs are clamped to [0, 1] (NaN becomes 0) and rounded to nearest.
+// - Signed audio samples are clamped to [-1, 1] (NaN becomes 0), i16 is rounded to nearest even.
+// - f32 -> un8 can be done in place (dst == src), other conversions can't alias.
+// - The mixing kernels take counts in frames, and ramp linearly: frame i gets gain + step * i.
+
+#pragma once
+
+void convert_f32_to_un8(uint8_t* dst, const float* src, size_t count);
+void convert_un8_to_f32(float* dst, const uint8_t* src, size_t count);
+void convert_f32_to_un16(uint16_t* dst, const float* src, size_t count);
+void convert_un16_to_f32(float* dst, const uint16_t* src, size_t count);
+void convert_f32_to_f16(uint16_t* dst, const float* src, size_t count);
+void convert_f16_to_f32(float* dst, const uint16_t* src, size_t count);
+void convert_f32_to_i16(int16_t* dst, const float* src, size_t count);
+void convert_i16_to_f32(float* dst, const int16_t* src, size_t count);
+void convert_clamp_f32(float* data, size_t count);
+void convert_mix_stereo(float* dst, const float* src, size_t frames, float gain, float step);
+void convert_pan_mono(float* dst, const float* src, size_t frames, const float gain[2], const float step[2]);
@@ -0,0 +1,407 @@
+#include "dsp.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DSP_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define DSP_NEON
+#include <arm_neon.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Biquad, using the lowpass/highpass formulas from the RBJ audio EQ cookbook.  It's recursive, so
+// the channels are the only parallelism and it stays scalar.
+
+void dsp_biquad_init(dsp_biquad* filter) {
+  memset(filter, 0, sizeof(*filter));
+  filter->b[0] = 1.f;
+}
+
+void dsp_biquad_configure(dsp_biquad* filter, dsp_filter_type type, float frequency, float resonance, float sampleRate) {
+  float w = 2.f * (float) M_PI * fminf(fmaxf(frequency, 1.f), .49f * sampleRate) / sampleRate;
+  float c = cosf(w);
+  float alpha = sinf(w) / (2.f * fmaxf(resonance, .01f));
+  float a0 = 1.f + alpha;
+
+  if (type == DSP_LOWPASS) {
+    filter->b[0] = (1.f - c) / 2.f / a0;
+    filter->b[1] = (1.f - c) / a0;
+    filter->b[2] = (1.f - c) / 2.f / a0;
+  } else {
+    filter->b[0] = (1.f + c) / 2.f / a0;
+    filter->b[1] = -(1.f + c) / a0;
+    filter->b[2] = (1.f + c) / 2.f / a0;
+  }
+
+  filter->a[0] = -2.f * c / a0;
+  filter->a[1] = (1.f - alpha) / a0;
+}
+
+void dsp_biquad_process(dsp_biquad* filter, float* data, size_t frames) {
+  float b0 = filter->b[0], b1 = filter->b[1], b2 = filter->b[2];
+  float a1 = filter->a[0], a2 = filter->a[1];
+
+  for (uint32_t c = 0; c < 2; c++) {
+    float z1 = filter->z[c][0];
+    float z2 = filter->z[c][1];
+
+    for (size_t i = 0; i < frames; i++) {
+      float x = data[2 * i + c];
+      float y = b0 * x + z1;
+      z1 = b1 * x - a1 * y + z2;
+      z2 = b2 * x - a2 * y;
+      data[2 * i + c] = y;
+    }
+
+    // Denormals would otherwise build up in the tail of a silent bus
+    filter->z[c][0] = fabsf(z1) < 1e-15f ? 0.f : z1;
+    filter->z[c][1] = fabsf(z2) < 1e-15f ? 0.f : z2;
+  }
+}
+
+// Reverb, a feedback delay network with 4 lines mixed through a Hadamard matrix.  Each line is
+// damped by a one-pole lowpass and attenuated so it decays by 60dB over the decay time.  The 4
+// lines are processed as one vector, only reading and writing the lines is done per lane.
+
+static const uint32_t reverbLengths[DSP_REVERB_LINES] = { 1123, 1361, 1427, 1619 }; // At 48kHz
+
+bool dsp_reverb_init(dsp_reverb* reverb, float sampleRate) {
+  memset(reverb, 0, sizeof(*reverb));
+
+  for (uint32_t i = 0; i < DSP_REVERB_LINES; i++) {
+    reverb->length[i] = (uint32_t) (reverbLengths[i] * sampleRate / 48000.f) + 1;
+    reverb->lines[i] = calloc(reverb->length[i], sizeof(float));
+    if (!reverb->lines[i]) {
+      dsp_reverb_destroy(reverb);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void dsp_reverb_destroy(dsp_reverb* reverb) {
+  for (uint32_t i = 0; i < DSP_REVERB_LINES; i++) {
+    free(reverb->lines[i]);
+    reverb->lines[i] = NULL;
+  }
+}
+
+void dsp_reverb_reset(dsp_reverb* reverb) {
+  for (uint32_t i = 0; i < DSP_REVERB_LINES; i++) {
+    memset(reverb->lines[i], 0, reverb->length[i] * sizeof(float));
+    reverb->lowpass[i] = 0.f;
+  }
+}
+
+void dsp_reverb_configure(dsp_reverb* reverb, float decay, float damping, float sampleRate) {
+  for (uint32_t i = 0; i < DSP_REVERB_LINES; i++) {
+    reverb->feedback[i] = powf(10.f, -3.f * reverb->length[i] / (sampleRate * fmaxf(decay, .01f)));
+  }
+
+  reverb->damping = fminf(fmaxf(damping, 0.f), .99f);
+}
+
+void dsp_reverb_process(dsp_reverb* reverb, float* data, size_t frames, float mix) {
+  float delayed[DSP_REVERB_LINES];
+  float feedback[DSP_REVERB_LINES];
+  float lowpass[DSP_REVERB_LINES];
+  float damping = reverb->damping;
+
+#if defined(DSP_SSE2)
+  __m128 lp = _mm_loadu_ps(reverb->lowpass);
+  __m128 g = _mm_loadu_ps(reverb->feedback);
+  __m128 dry = _mm_set1_ps(1.f - damping);
+  __m128 wet = _mm_set1_ps(damping);
+  __m128 sign1 = _mm_set_ps(-1.f, 1.f, -1.f, 1.f);
+  __m128 sign2 = _mm_set_ps(-1.f, -1.f, 1.f, 1.f);
+  __m128 half = _mm_set1_ps(.5f);
+#elif defined(DSP_NEON)
+  static const float signs1[4] = { 1.f, -1.f, 1.f, -1.f };
+  static const float signs2[4] = { 1.f, 1.f, -1.f, -1.f };
+  float32x4_t lp = vld1q_f32(reverb->lowpass);
+  float32x4_t g = vld1q_f32(reverb->feedback);
+  float32x4_t sign1 = vld1q_f32(signs1);
+  float32x4_t sign2 = vld1q_f32(signs2);
+#endif
+
+  for (size_t i = 0; i < frames; i++) {
+    float input = (data[2 * i + 0] + data[2 * i + 1]) * .5f;
+
+    for (uint32_t j = 0; j < DSP_REVERB_LINES; j++) {
+      delayed[j] = reverb->lines[j][reverb->cursor[j]];
+    }
+
+#if defined(DSP_SSE2)
+    // [a, b, c, d] -> [a+b, a-b, c+d, c-d] -> [a+b+c+d, a-b+c-d, a+b-c-d, a-b-c+d] / 2
+    lp = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(delayed), dry), _mm_mul_ps(lp, wet));
+    __m128 p = _mm_add_ps(_mm_shuffle_ps(lp, lp, _MM_SHUFFLE(2, 3, 0, 1)), _mm_mul_ps(lp, sign1));
+    __m128 h = _mm_mul_ps(_mm_add_ps(_mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 0, 3, 2)), _mm_mul_ps(p, sign2)), half);
+    _mm_storeu_ps(feedback, _mm_add_ps(_mm_set1_ps(input), _mm_mul_ps(h, g)));
+    _mm_storeu_ps(lowpass, lp);
+#elif defined(DSP_NEON)
+    lp = vmlaq_n_f32(vmulq_n_f32(vld1q_f32(delayed), 1.f - damping), lp, damping);
+    float32x4_t p = vmlaq_f32(vrev64q_f32(lp), lp, sign1);
+    float32x4_t q = vcombine_f32(vget_high_f32(p), vget_low_f32(p));
+    float32x4_t h = vmulq_n_f32(vmlaq_f32(q, p, sign2), .5f);
+    vst1q_f32(feedback, vmlaq_f32(vdupq_n_f32(input), h, g));
+    vst1q_f32(lowpass, lp);
+#else
+    for (uint32_t j = 0; j < DSP_REVERB_LINES; j++) {
+      reverb->lowpass[j] = delayed[j] * (1.f - damping) + reverb->lowpass[j] * damping;
+      lowpass[j] = reverb->lowpass[j];
+    }
+    float a = lowpass[0] + lowpass[1], b = lowpass[0] - lowpass[1];
+    float c = lowpass[2] + lowpass[3], d = lowpass[2] - lowpass[3];
+    feedback[0] = input + (a + c) * .5f * reverb->feedback[0];
+    feedback[1] = input + (b + d) * .5f * reverb->feedback[1];
+    feedback[2] = input + (a - c) * .5f * reverb->feedback[2];
+    feedback[3] = input + (b - d) * .5f * reverb->feedback[3];
+#endif
+
+    for (uint32_t j = 0; j < DSP_REVERB_LINES; j++) {
+      reverb->lines[j][reverb->cursor[j]] = feedback[j];
+      if (++reverb->cursor[j] == reverb->length[j]) reverb->cursor[j] = 0;
+    }
+
+    float left = (lowpass[0] + lowpass[2]) * .5f;
+    float right = (lowpass[1] + lowpass[3]) * .5f;
+    data[2 * i + 0] += (left - data[2 * i + 0]) * mix;
+    data[2 * i + 1] += (right - data[2 * i + 1]) * mix;
+  }
+
+#if defined(DSP_SSE2)
+  _mm_storeu_ps(reverb->lowpass, lp);
+#elif defined(DSP_NEON)
+  vst1q_f32(reverb->lowpass, lp);
+#endif
+}
+
+// Limiter, which holds back one buffer and measures the peak of the next one, so the gain is
+// already down when a peak comes out.  The gain ramps linearly across each buffer, towards the
+// lowest gain required by the buffer going out or the one coming in, and recovers exponentially.
+
+bool dsp_limiter_init(dsp_limiter* limiter, uint32_t frames) {
+  limiter->delay = calloc(frames * 2, sizeof(float));
+  limiter->frames = frames;
+  limiter->gain = 1.f;
+  limiter->required = 1.f;
+  return limiter->delay;
+}
+
+void dsp_limiter_destroy(dsp_limiter* limiter) {
+  free(limiter->delay);
+  limiter->delay = NULL;
+}
+
+void dsp_limiter_reset(dsp_limiter* limiter) {
+  memset(limiter->delay, 0, limiter->frames * 2 * sizeof(float));
+  limiter->gain = 1.f;
+  limiter->required = 1.f;
+}
+
+static float peak(const float* data, size_t count) {
+  size_t i = 0;
+  float max = 0.f;
+#if defined(DSP_SSE2)
+  __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  __m128 m = _mm_setzero_ps();
+  for (; i + 4 <= count; i += 4) {
+    m = _mm_max_ps(m, _mm_and_ps(_mm_loadu_ps(data + i), mask));
+  }
+  float lanes[4];
+  _mm_storeu_ps(lanes, m);
+  max = fmaxf(fmaxf(lanes[0], lanes[1]), fmaxf(lanes[2], lanes[3]));
+#elif defined(DSP_NEON)
+  float32x4_t m = vdupq_n_f32(0.f);
+  for (; i + 4 <= count; i += 4) {
+    m = vmaxq_f32(m, vabsq_f32(vld1q_f32(data + i)));
+  }
+  max = vmaxvq_f32(m);
+#endif
+  for (; i < count; i++) {
+    max = fmaxf(max, fabsf(data[i]));
+  }
+  return max;
+}
+
+void dsp_limiter_process(dsp_limiter* limiter, float* data, size_t frames, float threshold, float release, float sampleRate) {
+  if (frames > limiter->frames) frames = limiter->frames;
+
+  float loudest = peak(data, frames * 2);
+  float required = loudest > threshold ? threshold / loudest : 1.f;
+  float recovery = limiter->gain + (1.f - limiter->gain) * (1.f - expf(-(float) frames / (fmaxf(release, .001f) * sampleRate)));
+  float start = limiter->gain;
+  float end = fminf(fminf(limiter->required, required), recovery);
+  float step = (end - start) / frames;
+  float* delay = limiter->delay;
+  size_t i = 0;
+
+#if defined(DSP_SSE2)
+  // Each vector holds 2 stereo frames, so the frame offsets of the lanes are 1, 1, 2, 2
+  __m128 offset = _mm_set_ps(2.f, 2.f, 1.f, 1.f);
+  for (; i + 2 <= frames; i += 2) {
+    __m128 gain = _mm_add_ps(_mm_set1_ps(start), _mm_mul_ps(_mm_set1_ps(step), _mm_add_ps(_mm_set1_ps((float) i), offset)));
+    __m128 x = _mm_loadu_ps(delay + 2 * i);
+    _mm_storeu_ps(delay + 2 * i, _mm_loadu_ps(data + 2 * i));
+    _mm_storeu_ps(data + 2 * i, _mm_mul_ps(x, gain));
+  }
+#elif defined(DSP_NEON)
+  static const float offsets[4] = { 1.f, 1.f, 2.f, 2.f };
+  float32x4_t offset = vld1q_f32(offsets);
+  for (; i + 2 <= frames; i += 2) {
+    float32x4_t gain = vmlaq_n_f32(vdupq_n_f32(start), vaddq_f32(vdupq_n_f32((float) i), offset), step);
+    float32x4_t x = vld1q_f32(delay + 2 * i);
+    vst1q_f32(delay + 2 * i, vld1q_f32(data + 2 * i));
+    vst1q_f32(data + 2 * i, vmulq_f32(x, gain));
+  }
+#endif
+  for (; i < frames; i++) {
+    float gain = start + step * (float) (i + 1);
+    for (uint32_t c = 0; c < 2; c++) {
+      float x = delay[2 * i + c];
+      delay[2 * i + c] = data[2 * i + c];
+      data[2 * i + c] = x * gain;
+    }
+  }
+
+  limiter->gain = end;
+  limiter->required = required;
+}
+
+// FFT, iterative radix-2 decimation in time.  The twiddles for the stage with butterflies of half
+// size h start at twiddle[h - 1], so each stage reads them contiguously, and stages with at least
+// 4 butterflies per group are vectorized.
+
+bool dsp_fft_init(dsp_fft_plan* plan, uint32_t size) {
+  uint32_t bits = 0;
+  while ((1u << bits) < size) bits++;
+
+  plan->size = size;
+  plan->reverse = malloc(size * sizeof(uint32_t));
+  plan->twiddle[0] = malloc(size * sizeof(float));
+  plan->twiddle[1] = malloc(size * sizeof(float));
+
+  if (!plan->reverse || !plan->twiddle[0] || !plan->twiddle[1]) {
+    dsp_fft_destroy(plan);
+    return false;
+  }
+
+  for (uint32_t i = 0; i < size; i++) {
+    uint32_t r = 0;
+    for (uint32_t b = 0; b < bits; b++) {
+      r |= ((i >> b) & 1) << (bits - 1 - b);
+    }
+    plan->reverse[i] = r;
+  }
+
+  for (uint32_t h = 1; h < size; h <<= 1) {
+    for (uint32_t j = 0; j < h; j++) {
+      double angle = -M_PI * j / h;
+      plan->twiddle[0][h - 1 + j] = (float) cos(angle);
+      plan->twiddle[1][h - 1 + j] = (float) sin(angle);
+    }
+  }
+
+  return true;
+}
+
+void dsp_fft_destroy(dsp_fft_plan* plan) {
+  free(plan->reverse);
+  free(plan->twiddle[0]);
+  free(plan->twiddle[1]);
+  plan->reverse = NULL;
+  plan->twiddle[0] = plan->twiddle[1] = NULL;
+}
+
+void dsp_fft(dsp_fft_plan* plan, float* re, float* im, bool inverse) {
+  uint32_t n = plan->size;
+  float sign = inverse ? -1.f : 1.f;
+
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t r = plan->reverse[i];
+    if (r > i) {
+      float t = re[i]; re[i] = re[r]; re[r] = t;
+      t = im[i]; im[i] = im[r]; im[r] = t;
+    }
+  }
+
+  for (uint32_t h = 1; h < n; h <<= 1) {
+    const float* wr = plan->twiddle[0] + h - 1;
+    const float* wi = plan->twiddle[1] + h - 1;
+
+    for (uint32_t k = 0; k < n; k += 2 * h) {
+      float* ar = re + k;
+      float* ai = im + k;
+      float* br = re + k + h;
+      float* bi = im + k + h;
+      uint32_t j = 0;
+
+#if defined(DSP_SSE2)
+      __m128 s = _mm_set1_ps(sign);
+      for (; j + 4 <= h; j += 4) {
+        __m128 xr = _mm_loadu_ps(br + j), xi = _mm_loadu_ps(bi + j);
+        __m128 cr = _mm_loadu_ps(wr + j), ci = _mm_mul_ps(_mm_loadu_ps(wi + j), s);
+        __m128 tr = _mm_sub_ps(_mm_mul_ps(xr, cr), _mm_mul_ps(xi, ci));
+        __m128 ti = _mm_add_ps(_mm_mul_ps(xr, ci), _mm_mul_ps(xi, cr));
+        __m128 yr = _mm_loadu_ps(ar + j), yi = _mm_loadu_ps(ai + j);
+        _mm_storeu_ps(br + j, _mm_sub_ps(yr, tr));
+        _mm_storeu_ps(bi + j, _mm_sub_ps(yi, ti));
+        _mm_storeu_ps(ar + j, _mm_add_ps(yr, tr));
+        _mm_storeu_ps(ai + j, _mm_add_ps(yi, ti));
+      }
+#elif defined(DSP_NEON)
+      for (; j + 4 <= h; j += 4) {
+        float32x4_t xr = vld1q_f32(br + j), xi = vld1q_f32(bi + j);
+        float32x4_t cr = vld1q_f32(wr + j), ci = vmulq_n_f32(vld1q_f32(wi + j), sign);
+        float32x4_t tr = vmlsq_f32(vmulq_f32(xr, cr), xi, ci);
+        float32x4_t ti = vmlaq_f32(vmulq_f32(xr, ci), xi, cr);
+        float32x4_t yr = vld1q_f32(ar + j), yi = vld1q_f32(ai + j);
+        vst1q_f32(br + j, vsubq_f32(yr, tr));
+        vst1q_f32(bi + j, vsubq_f32(yi, ti));
+        vst1q_f32(ar + j, vaddq_f32(yr, tr));
+        vst1q_f32(ai + j, vaddq_f32(yi, ti));
+      }
+#endif
+      for (; j < h; j++) {
+        float cr = wr[j], ci = wi[j] * sign;
+        float tr = br[j] * cr - bi[j] * ci;
+        float ti = br[j] * ci + bi[j] * cr;
+        br[j] = ar[j] - tr;
+        bi[j] = ai[j] - ti;
+        ar[j] += tr;
+        ai[j] += ti;
+      }
+    }
+  }
+}
+
+// Accumulates the elementwise complex product of a and b
+void dsp_complex_mac(float* re, float* im, const float* are, const float* aim, const float* bre, const float* bim, size_t count) {
+  size_t i = 0;
+#if defined(DSP_SSE2)
+  for (; i + 4 <= count; i += 4) {
+    __m128 xr = _mm_loadu_ps(are + i), xi = _mm_loadu_ps(aim + i);
+    __m128 yr = _mm_loadu_ps(bre + i), yi = _mm_loadu_ps(bim + i);
+    _mm_storeu_ps(re + i, _mm_add_ps(_mm_loadu_ps(re + i), _mm_sub_ps(_mm_mul_ps(xr, yr), _mm_mul_ps(xi, yi))));
+    _mm_storeu_ps(im + i, _mm_add_ps(_mm_loadu_ps(im + i), _mm_add_ps(_mm_mul_ps(xr, yi), _mm_mul_ps(xi, yr))));
+  }
+#elif defined(DSP_NEON)
+  for (; i + 4 <= count; i += 4) {
+    float32x4_t xr = vld1q_f32(are + i), xi = vld1q_f32(aim + i);
+    float32x4_t yr = vld1q_f32(bre + i), yi = vld1q_f32(bim + i);
+    vst1q_f32(re + i, vmlsq_f32(vmlaq_f32(vld1q_f32(re + i), xr, yr), xi, yi));
+    vst1q_f32(im + i, vmlaq_f32(vmlaq_f32(vld1q_f32(im + i), xr, yi), xi, yr));
+  }
+#endif
+  for (; i < count; i++) {
+    re[i] += are[i] * bre[i] - aim[i] * bim[i];
+    im[i] += are[i] * bim[i] + aim[i] * bre[i];
+  }
+}
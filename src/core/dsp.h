@@ -0,0 +1,69 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Audio effects for interleaved stereo buffers, vectorized with SSE2 or NEON when available.
+// - Counts are in frames, and processing happens in place.
+// - Effect state is zeroed by the init functions and kept across calls, configuring an effect
+//   only changes its coefficients.
+// - The limiter delays its input by one buffer, which it uses as its look-ahead, so it has to be
+//   called with the same frame count every time.
+// - The FFT is complex, in place, and unnormalized, on split real/imaginary arrays.  Its size has to
+//   be a power of two, at least 4.
+
+#pragma once
+
+typedef enum {
+  DSP_LOWPASS,
+  DSP_HIGHPASS
+} dsp_filter_type;
+
+typedef struct {
+  float b[3];
+  float a[2];
+  float z[2][2];
+} dsp_biquad;
+
+#define DSP_REVERB_LINES 4
+
+typedef struct {
+  float* lines[DSP_REVERB_LINES];
+  uint32_t length[DSP_REVERB_LINES];
+  uint32_t cursor[DSP_REVERB_LINES];
+  float feedback[DSP_REVERB_LINES];
+  float lowpass[DSP_REVERB_LINES];
+  float damping;
+} dsp_reverb;
+
+typedef struct {
+  float* delay;
+  uint32_t frames;
+  float gain;
+  float required;
+} dsp_limiter;
+
+typedef struct {
+  uint32_t size;
+  uint32_t* reverse;
+  float* twiddle[2];
+} dsp_fft_plan;
+
+void dsp_biquad_init(dsp_biquad* filter);
+void dsp_biquad_configure(dsp_biquad* filter, dsp_filter_type type, float frequency, float resonance, float sampleRate);
+void dsp_biquad_process(dsp_biquad* filter, float* data, size_t frames);
+
+bool dsp_reverb_init(dsp_reverb* reverb, float sampleRate);
+void dsp_reverb_destroy(dsp_reverb* reverb);
+void dsp_reverb_reset(dsp_reverb* reverb);
+void dsp_reverb_configure(dsp_reverb* reverb, float decay, float damping, float sampleRate);
+void dsp_reverb_process(dsp_reverb* reverb, float* data, size_t frames, float mix);
+
+bool dsp_limiter_init(dsp_limiter* limiter, uint32_t frames);
+void dsp_limiter_destroy(dsp_limiter* limiter);
+void dsp_limiter_reset(dsp_limiter* limiter);
+void dsp_limiter_process(dsp_limiter* limiter, float* data, size_t frames, float threshold, float release, float sampleRate);
+
+bool dsp_fft_init(dsp_fft_plan* plan, uint32_t size);
+void dsp_fft_destroy(dsp_fft_plan* plan);
+void dsp_fft(dsp_fft_plan* plan, float* re, float* im, bool inverse);
+void dsp_complex_mac(float* re, float* im, const float* are, const float* aim, const float* bre, const float* bim, size_t count);
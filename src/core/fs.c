@@ -98,6 +98,12 @@ bool fs_unmap(void* data, size_t size) {
   return UnmapViewOfFile(data);
 }
 
+// Windows can't drop a range of a file mapping: DiscardVirtualMemory and OfferVirtualMemory only
+// take private memory.  This is a no-op, mapped pages stay until the memory manager trims them.
+bool fs_release(void* data, size_t size) {
+  return false;
+}
+
 bool fs_stat(const char* path, FileInfo* info) {
   WCHAR wpath[FS_PATH_MAX];
   if (!MultiByteToWideChar(CP_UTF8, 0, path, -1, wpath, FS_PATH_MAX)) {
@@ -222,13 +228,21 @@ void* fs_map(const char* path, size_t* size) {
   *size = info.size;
   void* data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, file.fd, 0);
   fs_close(file);
-  return data;
+  return data == MAP_FAILED ? NULL : data;
 }
 
 bool fs_unmap(void* data, size_t size) {
   return munmap(data, size) == 0;
 }
 
+// The mapping is read only, so dropped pages are read from the file again on the next access
+bool fs_release(void* data, size_t size) {
+  size_t page = (size_t) sysconf(_SC_PAGESIZE);
+  uintptr_t start = ((uintptr_t) data + page - 1) & ~(page - 1);
+  uintptr_t end = ((uintptr_t) data + size) & ~(page - 1);
+  return end <= start || madvise((void*) start, end - start, MADV_DONTNEED) == 0;
+}
+
 bool fs_stat(const char* path, FileInfo* info) {
   struct stat stats;
   if (stat(path, &stats)) {
@@ -30,6 +30,7 @@ bool fs_read(fs_handle file, void* buffer, size_t* bytes);
 bool fs_write(fs_handle file, const void* buffer, size_t* bytes);
 void* fs_map(const char* path, size_t* size);
 bool fs_unmap(void* data, size_t size);
+bool fs_release(void* data, size_t size);
 bool fs_stat(const char* path, FileInfo* info);
 bool fs_remove(const char* path);
 bool fs_mkdir(const char* path);
@@ -0,0 +1,45 @@
+#include "job.h"
+#include "os.h"
+#include "lib/tinycthread/tinycthread.h"
+#include <stdatomic.h>
+
+#define MAX_WORKERS 32
+
+typedef struct {
+  job_fn* fn;
+  void* context;
+  uint32_t count;
+  atomic_uint next;
+} job_batch;
+
+static void drain(job_batch* batch) {
+  uint32_t index;
+  while ((index = atomic_fetch_add(&batch->next, 1)) < batch->count) {
+    batch->fn(batch->context, index);
+  }
+}
+
+static int worker(void* arg) {
+  drain(arg);
+  return 0;
+}
+
+void job_run(job_fn* fn, void* context, uint32_t count, uint32_t workers) {
+  if (workers == 0) workers = os_get_core_count();
+  if (workers > count) workers = count;
+  if (workers > MAX_WORKERS) workers = MAX_WORKERS;
+
+  job_batch batch = { .fn = fn, .context = context, .count = count };
+
+  uint32_t spawned = 0;
+  thrd_t threads[MAX_WORKERS];
+  while (spawned + 1 < workers && thrd_create(&threads[spawned], worker, &batch) == thrd_success) {
+    spawned++;
+  }
+
+  drain(&batch);
+
+  for (uint32_t i = 0; i < spawned; i++) {
+    thrd_join(threads[i], NULL);
+  }
+}
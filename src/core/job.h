@@ -0,0 +1,14 @@
+#include <stdint.h>
+
+// Minimal fork/join helper for data-parallel CPU work
+// - job_run calls fn once for each index in [0, count), spread across worker threads.
+// - The calling thread participates and job_run returns once every index has finished.
+// - workers is the maximum number of threads to use, including the caller (0 uses every core).
+// - If threads can't be created, the remaining work runs on the calling thread.
+// - fn must not throw (longjmp) since it may be running on a worker thread.
+
+#pragma once
+
+typedef void job_fn(void* context, uint32_t index);
+
+void job_run(job_fn* fn, void* context, uint32_t count, uint32_t workers);
@@ -0,0 +1,755 @@
+#include "zstd.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_BLOCK_SIZE (1 << 17)
+
+static uint32_t readu16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static uint32_t readu24(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16); }
+static uint32_t readu32(const uint8_t* p) { return readu24(p) | ((uint32_t) p[3] << 24); }
+
+static uint32_t highbit(uint32_t x) {
+  uint32_t bit = 0;
+  while (x >>= 1) bit++;
+  return bit;
+}
+
+// Bitstreams
+
+// Returns count bits starting at a bit position, positions outside of the data read as zero
+static uint32_t getBits(const uint8_t* data, size_t size, int64_t position, uint32_t count) {
+  if (count == 0 || position + count <= 0) {
+    return 0;
+  } else if (position < 0) {
+    return getBits(data, size, 0, (uint32_t) (count + position)) << -position;
+  }
+
+  size_t byte = (size_t) (position >> 3);
+  uint64_t bits = 0;
+  if (byte + 8 <= size) {
+    memcpy(&bits, data + byte, 8);
+  } else {
+    for (size_t i = 0; byte + i < size; i++) {
+      bits |= (uint64_t) data[byte + i] << (8 * i);
+    }
+  }
+
+  return (uint32_t) ((bits >> (position & 7)) & ((1ull << count) - 1));
+}
+
+// Huffman and FSE streams are read backwards, starting from the last set bit of the last byte
+typedef struct {
+  const uint8_t* data;
+  size_t size;
+  int64_t position;
+} bitstream;
+
+static bool bitsInit(bitstream* bits, const uint8_t* data, size_t size) {
+  if (size == 0 || data[size - 1] == 0) {
+    return false;
+  }
+
+  bits->data = data;
+  bits->size = size;
+  bits->position = (int64_t) (size - 1) * 8 + highbit(data[size - 1]);
+  return true;
+}
+
+static uint32_t bitsPeek(bitstream* bits, uint32_t count) {
+  return getBits(bits->data, bits->size, bits->position - count, count);
+}
+
+static uint32_t bitsRead(bitstream* bits, uint32_t count) {
+  uint32_t value = bitsPeek(bits, count);
+  bits->position -= count;
+  return value;
+}
+
+// FSE
+
+typedef struct {
+  uint8_t symbol;
+  uint8_t bits;
+  uint16_t base;
+} fse_entry;
+
+typedef struct {
+  fse_entry entries[1 << 9];
+  uint32_t log;
+} fse_table;
+
+// Reads a table description, returns the number of bytes used or 0 on error
+static size_t fseReadCounts(const uint8_t* data, size_t size, int16_t* counts, uint32_t* symbols, uint32_t* log, uint32_t maxLog) {
+  if (size == 0) {
+    return 0;
+  }
+
+  int64_t position = 4;
+  uint32_t accuracy = getBits(data, size, 0, 4) + 5;
+
+  if (accuracy > maxLog) {
+    return 0;
+  }
+
+  int32_t remaining = (1 << accuracy) + 1;
+  int32_t threshold = 1 << accuracy;
+  uint32_t bits = accuracy + 1;
+  uint32_t symbol = 0;
+
+  while (remaining > 1) {
+    if (symbol >= *symbols) {
+      return 0;
+    }
+
+    int32_t max = (2 * threshold - 1) - remaining;
+    int32_t value = getBits(data, size, position, bits - 1);
+
+    if (value < max) {
+      position += bits - 1;
+    } else {
+      value = getBits(data, size, position, bits);
+      value -= value >= threshold ? max : 0;
+      position += bits;
+    }
+
+    int32_t count = value - 1;
+    counts[symbol++] = count;
+    remaining -= count < 0 ? -count : count;
+
+    if (remaining < 1) {
+      return 0;
+    }
+
+    if (count == 0) {
+      uint32_t repeat;
+      do {
+        repeat = getBits(data, size, position, 2);
+        position += 2;
+        for (uint32_t i = 0; i < repeat; i++) {
+          if (symbol >= *symbols) return 0;
+          counts[symbol++] = 0;
+        }
+      } while (repeat == 3);
+    }
+
+    while (remaining < threshold) {
+      threshold >>= 1;
+      bits--;
+    }
+  }
+
+  if (remaining != 1 || position > (int64_t) size * 8) {
+    return 0;
+  }
+
+  *symbols = symbol;
+  *log = accuracy;
+  return (size_t) (position + 7) / 8;
+}
+
+static bool fseBuild(fse_table* table, const int16_t* counts, uint32_t symbols, uint32_t log) {
+  uint32_t size = 1 << log;
+  uint32_t high = size - 1;
+  uint32_t total = 0;
+  uint16_t next[64];
+
+  if (symbols > 64) {
+    return false;
+  }
+
+  for (uint32_t s = 0; s < symbols; s++) {
+    if (counts[s] == -1) {
+      table->entries[high--].symbol = s;
+      next[s] = 1;
+      total++;
+    } else {
+      next[s] = counts[s];
+      total += counts[s];
+    }
+  }
+
+  if (total != size) {
+    return false;
+  }
+
+  uint32_t step = (size >> 1) + (size >> 3) + 3;
+  uint32_t position = 0;
+  for (uint32_t s = 0; s < symbols; s++) {
+    for (int32_t i = 0; i < counts[s]; i++) {
+      table->entries[position].symbol = s;
+      do {
+        position = (position + step) & (size - 1);
+      } while (position > high);
+    }
+  }
+
+  if (position != 0) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < size; i++) {
+    uint32_t state = next[table->entries[i].symbol]++;
+    uint32_t bits = log - highbit(state);
+    table->entries[i].bits = bits;
+    table->entries[i].base = (state << bits) - size;
+  }
+
+  table->log = log;
+  return true;
+}
+
+// Huffman
+
+typedef struct {
+  uint8_t symbol;
+  uint8_t bits;
+} huf_entry;
+
+typedef struct {
+  huf_entry entries[1 << 11];
+  uint32_t log;
+} huf_table;
+
+// Reads a tree description, returns the number of bytes used or 0 on error
+static size_t hufRead(huf_table* table, const uint8_t* data, size_t size) {
+  uint8_t weights[256];
+  uint32_t count = 0;
+  size_t used;
+
+  if (size == 0) {
+    return 0;
+  }
+
+  uint32_t header = data[0];
+
+  if (header >= 128) {
+    count = header - 127;
+    used = 1 + (count + 1) / 2;
+
+    if (used > size) {
+      return 0;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+      weights[i] = (i & 1) ? (data[1 + i / 2] & 0xf) : (data[1 + i / 2] >> 4);
+    }
+  } else {
+    used = 1 + header;
+
+    if (header == 0 || used > size) {
+      return 0;
+    }
+
+    fse_table fse;
+    int16_t counts[16] = { 0 };
+    uint32_t symbols = 16, log;
+    size_t n = fseReadCounts(data + 1, header, counts, &symbols, &log, 6);
+
+    if (n == 0 || !fseBuild(&fse, counts, symbols, log)) {
+      return 0;
+    }
+
+    bitstream bits;
+    if (!bitsInit(&bits, data + 1 + n, header - n)) {
+      return 0;
+    }
+
+    // Two interleaved states, when the stream runs out the other state emits one last symbol
+    uint32_t s1 = bitsRead(&bits, log);
+    uint32_t s2 = bitsRead(&bits, log);
+    for (;;) {
+      if (count > 253) return 0;
+
+      weights[count++] = fse.entries[s1].symbol;
+      s1 = fse.entries[s1].base + bitsRead(&bits, fse.entries[s1].bits);
+      if (bits.position < 0) {
+        weights[count++] = fse.entries[s2].symbol;
+        break;
+      }
+
+      weights[count++] = fse.entries[s2].symbol;
+      s2 = fse.entries[s2].base + bitsRead(&bits, fse.entries[s2].bits);
+      if (bits.position < 0) {
+        weights[count++] = fse.entries[s1].symbol;
+        break;
+      }
+    }
+  }
+
+  // The weight of the last symbol is implied by the others
+  uint32_t total = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    if (weights[i] > 11) return 0;
+    total += weights[i] ? 1 << (weights[i] - 1) : 0;
+  }
+
+  if (total == 0 || count > 255) {
+    return 0;
+  }
+
+  uint32_t log = highbit(total) + 1;
+  uint32_t left = (1 << log) - total;
+
+  if (log > 11 || (left & (left - 1))) {
+    return 0;
+  }
+
+  weights[count++] = highbit(left) + 1;
+
+  // Codes are assigned from the smallest weight to the largest, then by symbol
+  uint32_t position = 0;
+  for (uint32_t w = 1; w <= log; w++) {
+    for (uint32_t s = 0; s < count; s++) {
+      if (weights[s] == w) {
+        uint32_t length = 1 << (w - 1);
+        for (uint32_t i = 0; i < length; i++) {
+          table->entries[position + i] = (huf_entry) { s, log + 1 - w };
+        }
+        position += length;
+      }
+    }
+  }
+
+  table->log = log;
+  return used;
+}
+
+static bool hufDecode(const huf_table* table, const uint8_t* data, size_t size, uint8_t* dst, size_t count) {
+  bitstream bits;
+  if (!bitsInit(&bits, data, size)) {
+    return false;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    huf_entry entry = table->entries[bitsPeek(&bits, table->log)];
+    bits.position -= entry.bits;
+    dst[i] = entry.symbol;
+  }
+
+  return bits.position == 0;
+}
+
+// Sequences
+
+static const uint32_t llBase[36] = {
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+  16, 18, 20, 22, 24, 28, 32, 40, 48, 64, 128, 256, 512, 1024, 2048, 4096,
+  8192, 16384, 32768, 65536
+};
+
+static const uint8_t llBits[36] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12,
+  13, 14, 15, 16
+};
+
+static const uint32_t mlBase[53] = {
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+  19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34,
+  35, 37, 39, 41, 43, 47, 51, 59, 67, 83, 99, 131, 259, 515, 1027, 2051,
+  4099, 8195, 16387, 32771, 65539
+};
+
+static const uint8_t mlBits[53] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 7, 8, 9, 10, 11,
+  12, 13, 14, 15, 16
+};
+
+static const int16_t llDefaults[36] = {
+  4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1,
+  -1, -1, -1, -1
+};
+
+static const int16_t mlDefaults[53] = {
+  1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1,
+  -1, -1, -1, -1, -1
+};
+
+static const int16_t ofDefaults[29] = {
+  1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1
+};
+
+typedef struct {
+  huf_table huf;
+  fse_table ll;
+  fse_table of;
+  fse_table ml;
+  bool hasHuf;
+  bool hasLL;
+  bool hasOF;
+  bool hasML;
+  uint32_t rep[3];
+  uint8_t literals[MAX_BLOCK_SIZE];
+} zstd_context;
+
+static bool readTable(fse_table* table, bool* valid, uint32_t mode, const uint8_t** p, const uint8_t* end, const int16_t* defaults, uint32_t defaultCount, uint32_t defaultLog, uint32_t maxSymbols, uint32_t maxLog) {
+  switch (mode) {
+    case 0:
+      if (!fseBuild(table, defaults, defaultCount, defaultLog)) return false;
+      break;
+    case 1:
+      if (*p >= end || **p >= maxSymbols) return false;
+      table->entries[0] = (fse_entry) { **p, 0, 0 };
+      table->log = 0;
+      (*p)++;
+      break;
+    case 2: {
+      int16_t counts[64] = { 0 };
+      uint32_t symbols = maxSymbols, log;
+      size_t n = fseReadCounts(*p, end - *p, counts, &symbols, &log, maxLog);
+      if (n == 0 || !fseBuild(table, counts, symbols, log)) return false;
+      *p += n;
+      break;
+    }
+    case 3:
+      if (!*valid) return false;
+      break;
+  }
+
+  *valid = true;
+  return true;
+}
+
+static bool decodeBlock(zstd_context* ctx, const uint8_t* p, size_t size, uint8_t* dst, size_t* cursor, size_t capacity) {
+  const uint8_t* end = p + size;
+  const uint8_t* literals;
+  size_t literalCount;
+
+  // Literals
+
+  if (size < 1) {
+    return false;
+  }
+
+  uint32_t type = p[0] & 3;
+  uint32_t format = (p[0] >> 2) & 3;
+
+  if (type < 2) {
+    size_t header;
+
+    switch (format) {
+      case 1: header = 2; break;
+      case 3: header = 3; break;
+      default: header = 1; break;
+    }
+
+    if (header > size) {
+      return false;
+    }
+
+    switch (format) {
+      case 1: literalCount = (p[0] >> 4) + (p[1] << 4); break;
+      case 3: literalCount = (p[0] >> 4) + (p[1] << 4) + (p[2] << 12); break;
+      default: literalCount = p[0] >> 3; break;
+    }
+
+    p += header;
+
+    if (literalCount > MAX_BLOCK_SIZE) {
+      return false;
+    }
+
+    if (type == 0) {
+      if (literalCount > (size_t) (end - p)) return false;
+      literals = p;
+      p += literalCount;
+    } else {
+      if (p >= end) return false;
+      memset(ctx->literals, *p++, literalCount);
+      literals = ctx->literals;
+    }
+  } else {
+    size_t header = format < 2 ? 3 : format + 2;
+    uint32_t width = header == 3 ? 10 : (header == 4 ? 14 : 18);
+    uint32_t streams = format == 0 ? 1 : 4;
+
+    if (header > size) {
+      return false;
+    }
+
+    uint64_t bits = 0;
+    for (size_t i = 0; i < header; i++) {
+      bits |= (uint64_t) p[i] << (8 * i);
+    }
+
+    literalCount = (bits >> 4) & ((1 << width) - 1);
+    size_t compressed = (bits >> (4 + width)) & ((1 << width) - 1);
+    p += header;
+
+    if (literalCount > MAX_BLOCK_SIZE || compressed > (size_t) (end - p)) {
+      return false;
+    }
+
+    const uint8_t* data = p;
+    size_t length = compressed;
+    p += compressed;
+
+    if (type == 2) {
+      size_t n = hufRead(&ctx->huf, data, length);
+      if (n == 0) return false;
+      ctx->hasHuf = true;
+      data += n;
+      length -= n;
+    } else if (!ctx->hasHuf) {
+      return false;
+    }
+
+    if (streams == 1) {
+      if (!hufDecode(&ctx->huf, data, length, ctx->literals, literalCount)) {
+        return false;
+      }
+    } else {
+      if (length < 6) {
+        return false;
+      }
+
+      size_t sizes[4] = { readu16(data), readu16(data + 2), readu16(data + 4) };
+      size_t total = sizes[0] + sizes[1] + sizes[2] + 6;
+      size_t segment = (literalCount + 3) / 4;
+
+      if (total > length || segment * 3 > literalCount) {
+        return false;
+      }
+
+      sizes[3] = length - total;
+      data += 6;
+
+      for (uint32_t i = 0; i < 4; i++) {
+        size_t count = i < 3 ? segment : literalCount - 3 * segment;
+        if (!hufDecode(&ctx->huf, data, sizes[i], ctx->literals + i * segment, count)) {
+          return false;
+        }
+        data += sizes[i];
+      }
+    }
+
+    literals = ctx->literals;
+  }
+
+  // Sequences
+
+  if (p >= end) {
+    return false;
+  }
+
+  uint32_t sequenceCount = *p++;
+
+  if (sequenceCount >= 128) {
+    if (sequenceCount == 255) {
+      if (end - p < 2) return false;
+      sequenceCount = readu16(p) + 0x7f00;
+      p += 2;
+    } else {
+      if (p >= end) return false;
+      sequenceCount = ((sequenceCount - 128) << 8) + *p++;
+    }
+  }
+
+  uint8_t* out = dst + *cursor;
+  uint8_t* limit = dst + capacity;
+
+  if (sequenceCount > 0) {
+    if (p >= end) {
+      return false;
+    }
+
+    uint32_t modes = *p++;
+
+    if (
+      !readTable(&ctx->ll, &ctx->hasLL, (modes >> 6) & 3, &p, end, llDefaults, 36, 6, 36, 9) ||
+      !readTable(&ctx->of, &ctx->hasOF, (modes >> 4) & 3, &p, end, ofDefaults, 29, 5, 32, 8) ||
+      !readTable(&ctx->ml, &ctx->hasML, (modes >> 2) & 3, &p, end, mlDefaults, 53, 6, 53, 9)
+    ) {
+      return false;
+    }
+
+    bitstream bits;
+    if (!bitsInit(&bits, p, end - p)) {
+      return false;
+    }
+
+    uint32_t ll = bitsRead(&bits, ctx->ll.log);
+    uint32_t of = bitsRead(&bits, ctx->of.log);
+    uint32_t ml = bitsRead(&bits, ctx->ml.log);
+
+    for (uint32_t i = 0; i < sequenceCount; i++) {
+      uint32_t llCode = ctx->ll.entries[ll].symbol;
+      uint32_t ofCode = ctx->of.entries[of].symbol;
+      uint32_t mlCode = ctx->ml.entries[ml].symbol;
+
+      uint32_t offset = (1u << ofCode) + bitsRead(&bits, ofCode);
+      uint32_t matchLength = mlBase[mlCode] + bitsRead(&bits, mlBits[mlCode]);
+      uint32_t literalLength = llBase[llCode] + bitsRead(&bits, llBits[llCode]);
+
+      // Offsets 1-3 refer to recent offsets (shifted by one when there are no literals)
+      if (offset > 3) {
+        offset -= 3;
+        ctx->rep[2] = ctx->rep[1];
+        ctx->rep[1] = ctx->rep[0];
+        ctx->rep[0] = offset;
+      } else {
+        uint32_t index = offset - 1 + (literalLength == 0);
+        if (index == 0) {
+          offset = ctx->rep[0];
+        } else {
+          offset = index == 3 ? ctx->rep[0] - 1 : ctx->rep[index];
+          if (index != 1) ctx->rep[2] = ctx->rep[1];
+          ctx->rep[1] = ctx->rep[0];
+          ctx->rep[0] = offset;
+        }
+      }
+
+      if (i + 1 < sequenceCount) {
+        ll = ctx->ll.entries[ll].base + bitsRead(&bits, ctx->ll.entries[ll].bits);
+        ml = ctx->ml.entries[ml].base + bitsRead(&bits, ctx->ml.entries[ml].bits);
+        of = ctx->of.entries[of].base + bitsRead(&bits, ctx->of.entries[of].bits);
+      }
+
+      if (
+        literalLength > literalCount ||
+        (size_t) (limit - out) < (size_t) literalLength + matchLength ||
+        offset == 0 ||
+        offset > (size_t) (out - dst) + literalLength
+      ) {
+        return false;
+      }
+
+      memcpy(out, literals, literalLength);
+      literals += literalLength;
+      literalCount -= literalLength;
+      out += literalLength;
+
+      const uint8_t* match = out - offset;
+      if (offset >= matchLength) {
+        memcpy(out, match, matchLength);
+        out += matchLength;
+      } else {
+        for (uint32_t j = 0; j < matchLength; j++) {
+          *out++ = *match++;
+        }
+      }
+    }
+
+    if (bits.position != 0) {
+      return false;
+    }
+  }
+
+  if ((size_t) (limit - out) < literalCount) {
+    return false;
+  }
+
+  memcpy(out, literals, literalCount);
+  out += literalCount;
+  *cursor = out - dst;
+  return true;
+}
+
+bool zstd_decompress(void* dst, size_t capacity, const void* src, size_t size, size_t* written) {
+  const uint8_t* p = src;
+  const uint8_t* end = p + size;
+  size_t cursor = 0;
+
+  zstd_context* ctx = malloc(sizeof(zstd_context));
+
+  if (!ctx) {
+    return false;
+  }
+
+  while (p < end) {
+    if (end - p < 4) {
+      goto fail;
+    }
+
+    uint32_t magic = readu32(p);
+    p += 4;
+
+    if ((magic & 0xfffffff0) == 0x184d2a50) {
+      if (end - p < 4 || readu32(p) > (size_t) (end - p) - 4) goto fail;
+      p += 4 + readu32(p);
+      continue;
+    } else if (magic != 0xfd2fb528 || p >= end) {
+      goto fail;
+    }
+
+    uint32_t descriptor = *p++;
+    bool singleSegment = descriptor & (1 << 5);
+    bool checksum = descriptor & (1 << 2);
+    uint32_t dictionarySize = (descriptor & 3) == 3 ? 4 : (descriptor & 3);
+    uint32_t contentSize = (descriptor >> 6) == 0 ? singleSegment : 1 << (descriptor >> 6);
+    size_t header = !singleSegment + dictionarySize + contentSize;
+
+    if ((descriptor & (1 << 3)) || (size_t) (end - p) < header) {
+      goto fail;
+    }
+
+    p += !singleSegment;
+
+    for (uint32_t i = 0; i < dictionarySize; i++) {
+      if (p[i] != 0) goto fail;
+    }
+
+    p += dictionarySize + contentSize;
+
+    ctx->hasHuf = ctx->hasLL = ctx->hasOF = ctx->hasML = false;
+    ctx->rep[0] = 1;
+    ctx->rep[1] = 4;
+    ctx->rep[2] = 8;
+
+    for (;;) {
+      if (end - p < 3) {
+        goto fail;
+      }
+
+      uint32_t block = readu24(p);
+      uint32_t type = (block >> 1) & 3;
+      size_t blockSize = block >> 3;
+      p += 3;
+
+      switch (type) {
+        case 0:
+          if (blockSize > (size_t) (end - p) || blockSize > capacity - cursor) goto fail;
+          memcpy((uint8_t*) dst + cursor, p, blockSize);
+          cursor += blockSize;
+          p += blockSize;
+          break;
+        case 1:
+          if (p >= end || blockSize > capacity - cursor) goto fail;
+          memset((uint8_t*) dst + cursor, *p++, blockSize);
+          cursor += blockSize;
+          break;
+        case 2:
+          if (blockSize > (size_t) (end - p) || blockSize > MAX_BLOCK_SIZE) goto fail;
+          if (!decodeBlock(ctx, p, blockSize, dst, &cursor, capacity)) goto fail;
+          p += blockSize;
+          break;
+        default:
+          goto fail;
+      }
+
+      if (block & 1) {
+        break;
+      }
+    }
+
+    if (checksum) {
+      if (end - p < 4) goto fail;
+      p += 4;
+    }
+  }
+
+  free(ctx);
+  *written = cursor;
+  return true;
+
+fail:
+  free(ctx);
+  return false;
+}
@@ -0,0 +1,14 @@
+#include <stdbool.h>
+#include <stddef.h>
+
+// Status:
+//  - Little endian only
+//  - Decompression only
+//  - Decodes into a single flat buffer, so the window size is not enforced
+//  - Multiple frames are concatenated, skippable frames are skipped
+//  - Dictionaries are not supported
+//  - Content checksums are not verified
+
+#pragma once
+
+bool zstd_decompress(void* dst, size_t capacity, const void* src, size_t size, size_t* written);
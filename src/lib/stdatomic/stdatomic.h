@@ -92,14 +92,14 @@ typedef uintmax_t atomic_uintmax_t;
 
 // 7.17.7
 
-#define atomic_store(p, x) __atomic_store(p, x, __ATOMIC_SEQ_CST)
-#define atomic_store_explicit __atomic_store
+#define atomic_store(p, x) __atomic_store_n(p, x, __ATOMIC_SEQ_CST)
+#define atomic_store_explicit(p, x, o) __atomic_store_n(p, x, o)
 
-#define atomic_load(p, x) __atomic_load(p, x, __ATOMIC_SEQ_CST)
-#define atomic_load_explicit __atomic_load
+#define atomic_load(p) __atomic_load_n(p, __ATOMIC_SEQ_CST)
+#define atomic_load_explicit(p, o) __atomic_load_n(p, o)
 
-#define atomic_exchange(p, x) __atomic_exchange(p, x, __ATOMIC_SEQ_CST)
-#define atomic_exchange_explicit __atomic_exchange
+#define atomic_exchange(p, x) __atomic_exchange_n(p, x, __ATOMIC_SEQ_CST)
+#define atomic_exchange_explicit(p, x, o) __atomic_exchange_n(p, x, o)
 
 #define atomic_compare_exchange_strong(p, x, y) __atomic_compare_exchange(p, x, y, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
 #define atomic_compare_exchange_strong_explicit(p, x, y, o1, o2) __atomic_compare_exchange(p, x, y, false, o1, o2)
@@ -145,8 +145,27 @@ _Bool atomic_flag_clear_explicit(volatile atomic_flag*, memory_order);
 
 typedef volatile long atomic_uint;
 
+typedef enum memory_order {
+  memory_order_relaxed,
+  memory_order_consume,
+  memory_order_acquire,
+  memory_order_release,
+  memory_order_acq_rel,
+  memory_order_seq_cst
+} memory_order;
+
+// Interlocked operations are full barriers, so the explicit variants ignore the memory order
+#define atomic_load(p) _InterlockedOr(p, 0)
+#define atomic_load_explicit(p, o) atomic_load(p)
+#define atomic_store(p, x) ((void) _InterlockedExchange(p, x))
+#define atomic_store_explicit(p, x, o) atomic_store(p, x)
+#define atomic_exchange(p, x) _InterlockedExchange(p, x)
+#define atomic_exchange_explicit(p, x, o) atomic_exchange(p, x)
+
 #define atomic_fetch_add(p, x) _InterlockedExchangeAdd(p, x)
 #define atomic_fetch_sub(p, x) _InterlockedExchangeAdd(p, -(x))
+#define atomic_fetch_add_explicit(p, x, o) atomic_fetch_add(p, x)
+#define atomic_fetch_sub_explicit(p, x, o) atomic_fetch_sub(p, x)
 
 #define ATOMIC_INT_LOCK_FREE 2
 
@@ -1,9 +1,14 @@
 #include "audio/audio.h"
 #include "audio/spatializer.h"
 #include "data/sound.h"
+#include "core/convert.h"
+#include "core/dsp.h"
 #include "core/maf.h"
+#include "core/os.h"
 #include "util.h"
 #include "lib/miniaudio/miniaudio.h"
+#include "lib/tinycthread/tinycthread.h"
+#include <stdatomic.h>
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
@@ -14,9 +19,34 @@
 #define CTZL __builtin_ctzl
 #endif
 
-#define FOREACH_SOURCE(s) for (uint64_t m = state.sourceMask; s = m ? state.sources[CTZL(m)] : NULL, m; m ^= (m & -m))
+#define FOREACH_VOICE(s) for (uint64_t m = state.voiceMask; s = m ? state.voices[CTZL(m)] : NULL, m; m ^= (m & -m))
 #define OUTPUT_FORMAT SAMPLE_F32
 #define OUTPUT_CHANNELS 2
+#define DECODE_AHEAD_MS 250
+#define DECODE_INTERVAL_NS 5000000
+#define SEEK_FADE_FRAMES 64
+#define MAX_COMMANDS 1024
+#define SNAPSHOT_FRESH 4
+#define MAX_PLAYING_SOURCES 4096
+#define AUDIBILITY_THRESHOLD .001f
+#define RESAMPLE_CAPACITY (BUFFER_SIZE * 2)
+
+// Compressed Sounds are decoded ahead of playback on the decoder thread into a ring of f32 frames.
+// The decoder thread is the only writer and the audio callback is the only reader.  Seeks are
+// serviced by the decoder thread, which publishes a flush telling the reader to skip the frames
+// it had written before the seek.
+typedef struct {
+  float* data;
+  uint32_t capacity;
+  uint32_t channels;
+  atomic_uint writeCount;
+  atomic_uint readCount;
+  atomic_uint flushGeneration;
+  atomic_uint flushUntil;
+  atomic_uint flushOffset;
+  atomic_uint ended;
+  atomic_uint seekGeneration;
+} DecodeRing;
 
 struct Source {
   uint32_t ref;
@@ -24,36 +54,120 @@ struct Source {
   Sound* sound;
   // Note: Converter is written once in lovrSourceCreate and can never be changed.
   ma_data_converter* converter;
+  Resampler resampler;
   intptr_t spatializerMemo;
   uint32_t offset;
-  float pitch;
-  float volume;
-  float position[4];
-  float orientation[4];
-  float radius;
-  float dipoleWeight;
-  float dipolePower;
-  uint8_t effects;
-  bool playing;
-  bool looping;
+  // params is written by the Lua side, and published to the mixer using a triple buffer: the writer
+  // owns snapshots[back], the mixer owns snapshots[front], and snapshot holds the index of the
+  // latest one, flagged with SNAPSHOT_FRESH until the mixer picks it up.
+  SourceParams params;
+  SourceParams snapshots[3];
+  atomic_uint snapshot;
+  uint32_t back;
+  uint32_t front;
+  float ratio;
+  float score;
+  float gain;
+  bool tracked;
+  bool demoting;
+  bool virtualized;
+  // Written by Lua and the mixer, read by the mixer and the decoder thread
+  atomic_uint playing;
+  atomic_uint looping;
   bool pitchable;
   bool spatial;
+  DecodeRing* ring;
+  atomic_uint seekGeneration;
+  atomic_uint seekTarget;
+  uint32_t decodeGeneration;
+  uint32_t decodeOffset;
+  bool decoding;
+  uint32_t flushGeneration;
+  uint32_t fadeFrames;
+  uint32_t fadeCursor;
+  float fade[SEEK_FADE_FRAMES * 2];
+  bool primed;
+  double phase;
+  float history[3 * 2];
 };
 
+// Commands from the Lua side to the mixer, for things that can't be expressed as a parameter.
+// Each command holds a reference to its Source until the mixer processes it.
+typedef enum {
+  COMMAND_PLAY,
+  COMMAND_SEEK
+} CommandType;
+
+typedef struct {
+  CommandType type;
+  Source* source;
+  uint32_t offset;
+} Command;
+
+// Buses are submixes with their own effect chain (filter, reverb, limiter) that mix into the master
+// output.  Their parameters are published to the mixer the same way Source parameters are.  They
+// are only created, never destroyed, so the mixer can read the first busCount of them at any time.
+typedef struct {
+  char name[32];
+  BusParams params;
+  BusParams snapshots[3];
+  atomic_uint snapshot;
+  uint32_t back;
+  uint32_t front;
+  dsp_biquad filter;
+  dsp_reverb reverb;
+  dsp_limiter limiter;
+  float buffer[BUFFER_SIZE * OUTPUT_CHANNELS];
+} Bus;
+
+// The listener pose is published to the mixer like Source parameters, and the mixer hands it to the
+// spatializer, so spatializers only ever see it on the audio thread
+typedef struct {
+  float position[4];
+  float orientation[4];
+} ListenerPose;
+
 static struct {
   bool initialized;
-  ma_mutex lock;
+  mtx_t commandLock;
+  mtx_t spatializerLock;
+  mtx_t deviceLock;
+  Command commands[MAX_COMMANDS];
+  atomic_uint commandHead;
+  atomic_uint commandTail;
   ma_context context;
   ma_device devices[2];
   Sound* sinks[2];
-  Source* sources[MAX_SOURCES];
-  uint64_t sourceMask;
-  float position[4];
-  float orientation[4];
+  Source* sources[MAX_PLAYING_SOURCES];
+  Source* ranking[MAX_PLAYING_SOURCES];
+  uint32_t sourceCount;
+  Source* voices[MAX_SOURCES];
+  uint64_t voiceMask;
+  atomic_uint voiceLimit;
+  atomic_uint realVoiceCount;
+  atomic_uint virtualVoiceCount;
+  atomic_uint mixTime;
+  atomic_uint convertTime;
+  Bus buses[MAX_BUSES];
+  atomic_uint busCount;
+  ListenerPose pose;
+  ListenerPose poses[3];
+  atomic_uint poseSnapshot;
+  uint32_t poseBack;
+  uint32_t poseFront;
   Spatializer* spatializer;
   float absorption[3];
   ma_data_converter playbackConverter;
+  bool sinkDirect;
+  bool rendering;
+  float renderBuffer[BUFFER_SIZE * OUTPUT_CHANNELS];
+  uint32_t renderCursor;
   uint32_t sampleRate;
+  thrd_t decodeThread;
+  mtx_t decodeLock;
+  cnd_t decodeCond;
+  arr_t(Source*) decodeList;
+  bool decoding;
 } state;
 
 static const ma_format miniaudioFormats[] = {
@@ -69,65 +183,676 @@ static float linearToDb(float linear) {
   return 20.f * log10f(linear);
 }
 
+// Commands
+
+// Lua threads serialize on the command lock, which the mixer never takes
+static bool pushCommand(CommandType type, Source* source, uint32_t offset) {
+  mtx_lock(&state.commandLock);
+  uint32_t head = atomic_load_explicit(&state.commandHead, memory_order_relaxed);
+  uint32_t tail = atomic_load_explicit(&state.commandTail, memory_order_acquire);
+
+  if (head - tail >= MAX_COMMANDS) {
+    mtx_unlock(&state.commandLock);
+    lovrLog(LOG_WARN, "AUD", "Audio command queue is full, is the playback device running?");
+    return false;
+  }
+
+  lovrRetain(source);
+  state.commands[head & (MAX_COMMANDS - 1)] = (Command) { type, source, offset };
+  atomic_store_explicit(&state.commandHead, head + 1, memory_order_release);
+  mtx_unlock(&state.commandLock);
+  return true;
+}
+
+// Asks the decoder thread to restart a ring Source's decoding at a new offset
+static void requestSeek(Source* source, uint32_t offset) {
+  atomic_store_explicit(&source->seekTarget, offset, memory_order_relaxed);
+  atomic_fetch_add_explicit(&source->seekGeneration, 1, memory_order_release);
+}
+
+static void processCommands(void) {
+  uint32_t head = atomic_load_explicit(&state.commandHead, memory_order_acquire);
+  uint32_t tail = atomic_load_explicit(&state.commandTail, memory_order_relaxed);
+
+  for (; tail != head; tail++) {
+    Command* command = &state.commands[tail & (MAX_COMMANDS - 1)];
+    Source* source = command->source;
+
+    switch (command->type) {
+      case COMMAND_PLAY:
+        if (!source->tracked && atomic_load_explicit(&source->playing, memory_order_relaxed)) {
+          if (state.sourceCount >= MAX_PLAYING_SOURCES) {
+            atomic_store_explicit(&source->playing, false, memory_order_relaxed);
+            break;
+          }
+
+          state.sources[state.sourceCount++] = source;
+          source->tracked = true;
+          source->virtualized = false;
+          source->primed = false;
+          lovrRetain(source);
+        }
+        break;
+      case COMMAND_SEEK:
+        source->offset = command->offset;
+        source->primed = false;
+        if (source->ring) requestSeek(source, command->offset);
+        break;
+    }
+
+    lovrRelease(source, lovrSourceDestroy);
+  }
+
+  atomic_store_explicit(&state.commandTail, tail, memory_order_release);
+}
+
+static void initParams(Source* source) {
+  for (uint32_t i = 0; i < 3; i++) {
+    source->snapshots[i] = source->params;
+  }
+  source->back = 0;
+  source->front = 2;
+  atomic_store_explicit(&source->snapshot, 1, memory_order_release);
+}
+
+// Setters can be called from any thread, so they change params and publish them with commandLock
+// held, which keeps concurrent updates from being lost or published halfway
+static void publishParams(Source* source) {
+  source->snapshots[source->back] = source->params;
+  source->back = atomic_exchange(&source->snapshot, source->back | SNAPSHOT_FRESH) & ~SNAPSHOT_FRESH;
+  mtx_unlock(&state.commandLock);
+}
+
+static SourceParams* consumeParams(Source* source) {
+  if (atomic_load_explicit(&source->snapshot, memory_order_relaxed) & SNAPSHOT_FRESH) {
+    source->front = atomic_exchange(&source->snapshot, source->front) & ~SNAPSHOT_FRESH;
+  }
+
+  return &source->snapshots[source->front];
+}
+
+// Like publishParams, expects commandLock to be held and releases it
+static void publishBusParams(Bus* bus) {
+  bus->snapshots[bus->back] = bus->params;
+  bus->back = atomic_exchange(&bus->snapshot, bus->back | SNAPSHOT_FRESH) & ~SNAPSHOT_FRESH;
+  mtx_unlock(&state.commandLock);
+}
+
+// Returns whether the parameters changed since the last period
+static bool consumeBusParams(Bus* bus) {
+  if (atomic_load_explicit(&bus->snapshot, memory_order_relaxed) & SNAPSHOT_FRESH) {
+    bus->front = atomic_exchange(&bus->snapshot, bus->front) & ~SNAPSHOT_FRESH;
+    return true;
+  }
+
+  return false;
+}
+
+// Like publishParams, expects commandLock to be held and releases it
+static void publishPose(void) {
+  state.poses[state.poseBack] = state.pose;
+  state.poseBack = atomic_exchange(&state.poseSnapshot, state.poseBack | SNAPSHOT_FRESH) & ~SNAPSHOT_FRESH;
+  mtx_unlock(&state.commandLock);
+}
+
+static void consumePose(void) {
+  if (atomic_load_explicit(&state.poseSnapshot, memory_order_relaxed) & SNAPSHOT_FRESH) {
+    state.poseFront = atomic_exchange(&state.poseSnapshot, state.poseFront) & ~SNAPSHOT_FRESH;
+    ListenerPose* pose = &state.poses[state.poseFront];
+    state.spatializer->setListenerPose(pose->position, pose->orientation);
+  }
+}
+
+static uint32_t findBus(const char* name) {
+  uint32_t count = atomic_load_explicit(&state.busCount, memory_order_acquire);
+  for (uint32_t i = 0; i < count; i++) {
+    if (!strcmp(state.buses[i].name, name)) {
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+// Decoding
+
+static DecodeRing* createDecodeRing(Sound* sound) {
+  DecodeRing* ring = calloc(1, sizeof(DecodeRing));
+  lovrAssert(ring, "Out of memory");
+  uint32_t frames = lovrSoundGetSampleRate(sound) * DECODE_AHEAD_MS / 1000;
+  ring->capacity = 1;
+  while (ring->capacity < frames) ring->capacity <<= 1;
+  ring->channels = lovrSoundGetChannelCount(sound);
+  ring->data = malloc(ring->capacity * ring->channels * sizeof(float));
+  lovrAssert(ring->data, "Out of memory");
+  return ring;
+}
+
+static void destroyDecodeRing(DecodeRing* ring) {
+  if (!ring) return;
+  free(ring->data);
+  free(ring);
+}
+
+// Decoder thread: services seek requests and decodes until the ring is full
+static void fillDecodeRing(Source* source) {
+  DecodeRing* ring = source->ring;
+  uint32_t generation = atomic_load_explicit(&source->seekGeneration, memory_order_acquire);
+
+  if (generation != source->decodeGeneration) {
+    source->decodeGeneration = generation;
+    source->decodeOffset = atomic_load_explicit(&source->seekTarget, memory_order_relaxed);
+    atomic_store_explicit(&ring->ended, false, memory_order_relaxed);
+    atomic_store_explicit(&ring->flushUntil, atomic_load_explicit(&ring->writeCount, memory_order_relaxed), memory_order_relaxed);
+    atomic_store_explicit(&ring->flushOffset, source->decodeOffset, memory_order_relaxed);
+    atomic_fetch_add_explicit(&ring->flushGeneration, 1, memory_order_release);
+    atomic_store_explicit(&ring->seekGeneration, generation, memory_order_release);
+  }
+
+  if (atomic_load_explicit(&ring->ended, memory_order_relaxed)) {
+    return;
+  }
+
+  uint32_t write = atomic_load_explicit(&ring->writeCount, memory_order_relaxed);
+  uint32_t read = atomic_load_explicit(&ring->readCount, memory_order_acquire);
+  uint32_t space = ring->capacity - (write - read);
+
+  while (space > 0) {
+    uint32_t index = write & (ring->capacity - 1);
+    uint32_t chunk = MIN(space, ring->capacity - index);
+    uint32_t count = lovrSoundRead(source->sound, source->decodeOffset, chunk, ring->data + index * ring->channels);
+
+    if (count == 0) {
+      if (atomic_load_explicit(&source->looping, memory_order_relaxed) && source->decodeOffset > 0) {
+        source->decodeOffset = 0;
+        continue;
+      }
+
+      atomic_store_explicit(&ring->ended, true, memory_order_release);
+      break;
+    }
+
+    source->decodeOffset += count;
+    write += count;
+    space -= count;
+    atomic_store_explicit(&ring->writeCount, write, memory_order_release);
+  }
+}
+
+static int decodeLoop(void* arg) {
+  arr_t(Source*) sources;
+  arr_init(&sources, arr_alloc);
+
+  mtx_lock(&state.decodeLock);
+
+  while (state.decoding) {
+    arr_clear(&sources);
+
+    // Sources that stopped playing leave the list, and are added again when they're played
+    for (size_t i = 0; i < state.decodeList.length;) {
+      Source* source = state.decodeList.data[i];
+      if (atomic_load_explicit(&source->playing, memory_order_relaxed)) {
+        arr_push(&sources, source);
+        i++;
+      } else {
+        source->decoding = false;
+        arr_splice(&state.decodeList, i, 1);
+        lovrRelease(source, lovrSourceDestroy);
+      }
+    }
+
+    // Only this thread removes Sources from the list, so they stay alive while decoding unlocked
+    mtx_unlock(&state.decodeLock);
+
+    for (size_t i = 0; i < sources.length; i++) {
+      fillDecodeRing(sources.data[i]);
+    }
+
+    mtx_lock(&state.decodeLock);
+
+    struct timespec deadline;
+    timespec_get(&deadline, TIME_UTC);
+    deadline.tv_nsec += DECODE_INTERVAL_NS;
+    if (deadline.tv_nsec >= 1000000000) {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000;
+    }
+
+    if (state.decoding) {
+      cnd_timedwait(&state.decodeCond, &state.decodeLock, &deadline);
+    }
+  }
+
+  mtx_unlock(&state.decodeLock);
+  arr_free(&sources);
+  return 0;
+}
+
+// Audio thread: copies decoded frames out of the ring.  When a flush is published, up to
+// SEEK_FADE_FRAMES of the stale frames are kept to crossfade into the frames after the seek.
+// Returns 0 once the end of the Sound is reached, underruns are padded with silence.
+// Offline rendering can't underrun, so it waits for the decoder thread to service pending seeks and
+// catch up instead of padding with silence
+static void waitForDecodeRing(Source* source, uint32_t count) {
+  DecodeRing* ring = source->ring;
+
+  for (;;) {
+    uint32_t seek = atomic_load_explicit(&source->seekGeneration, memory_order_acquire);
+    bool seeking = seek != atomic_load_explicit(&ring->seekGeneration, memory_order_acquire);
+    uint32_t write = atomic_load_explicit(&ring->writeCount, memory_order_acquire);
+    uint32_t read = atomic_load_explicit(&ring->readCount, memory_order_relaxed);
+
+    if (atomic_load_explicit(&ring->flushGeneration, memory_order_acquire) != source->flushGeneration) {
+      uint32_t until = atomic_load_explicit(&ring->flushUntil, memory_order_relaxed);
+      read = (int32_t) (until - read) > 0 ? until : read;
+    }
+
+    if (!seeking && (write - read >= count || atomic_load_explicit(&ring->ended, memory_order_acquire))) {
+      return;
+    }
+
+    mtx_lock(&state.decodeLock);
+    cnd_signal(&state.decodeCond);
+    mtx_unlock(&state.decodeLock);
+    thrd_yield();
+  }
+}
+
+static uint32_t readDecodeRing(Source* source, uint32_t count, float* data) {
+  DecodeRing* ring = source->ring;
+
+  if (state.rendering) {
+    waitForDecodeRing(source, count);
+  }
+
+  uint32_t channels = ring->channels;
+  uint32_t write = atomic_load_explicit(&ring->writeCount, memory_order_acquire);
+  uint32_t read = atomic_load_explicit(&ring->readCount, memory_order_relaxed);
+  uint32_t generation = atomic_load_explicit(&ring->flushGeneration, memory_order_acquire);
+
+  if (generation != source->flushGeneration) {
+    source->flushGeneration = generation;
+    uint32_t until = atomic_load_explicit(&ring->flushUntil, memory_order_relaxed);
+    uint32_t offset = atomic_load_explicit(&ring->flushOffset, memory_order_relaxed);
+
+    if ((int32_t) (until - read) > 0) {
+      uint32_t stale = MIN(until - read, SEEK_FADE_FRAMES);
+      for (uint32_t i = 0; i < stale; i++) {
+        memcpy(source->fade + i * channels, ring->data + ((read + i) & (ring->capacity - 1)) * channels, channels * sizeof(float));
+      }
+      source->fadeFrames = stale;
+      source->fadeCursor = 0;
+      read = until;
+      source->offset = offset;
+    } else {
+      source->offset = offset + (read - until);
+    }
+
+    atomic_store_explicit(&ring->readCount, read, memory_order_release);
+  }
+
+  uint32_t available = write - read;
+
+  if (available == 0) {
+    if (atomic_load_explicit(&ring->ended, memory_order_acquire) && atomic_load_explicit(&ring->writeCount, memory_order_relaxed) == read) {
+      return 0;
+    }
+
+    memset(data, 0, count * channels * sizeof(float));
+    return count;
+  }
+
+  uint32_t frames = MIN(count, available);
+  for (uint32_t i = 0; i < frames;) {
+    uint32_t index = (read + i) & (ring->capacity - 1);
+    uint32_t chunk = MIN(frames - i, ring->capacity - index);
+    memcpy(data + i * channels, ring->data + index * channels, chunk * channels * sizeof(float));
+    i += chunk;
+  }
+
+  atomic_store_explicit(&ring->readCount, read + frames, memory_order_release);
+
+  for (uint32_t i = 0; source->fadeCursor < source->fadeFrames && i < frames; i++, source->fadeCursor++) {
+    float t = (source->fadeCursor + 1.f) / (source->fadeFrames + 1.f);
+    for (uint32_t c = 0; c < channels; c++) {
+      data[i * channels + c] = data[i * channels + c] * t + source->fade[source->fadeCursor * channels + c] * (1.f - t);
+    }
+  }
+
+  uint32_t length = lovrSoundGetFrameCount(source->sound);
+  source->offset += frames;
+  if (source->offset >= length && length > 0) {
+    source->offset %= length;
+  }
+
+  return frames;
+}
+
+// Reads frames in the Sound's format when they're going to a converter, and as floats otherwise
+static uint32_t readSource(Source* source, uint32_t count, void* data, bool convert) {
+  if (source->ring) {
+    return readDecodeRing(source, count, data);
+  }
+
+  // Sources that only need a format conversion skip the converter
+  if (!convert && lovrSoundGetFormat(source->sound) == SAMPLE_I16) {
+    int16_t samples[BUFFER_SIZE * 2];
+    uint32_t frames = lovrSoundRead(source->sound, source->offset, MIN(count, BUFFER_SIZE), samples);
+    convert_i16_to_f32(data, samples, frames * lovrSoundGetChannelCount(source->sound));
+    source->offset += frames;
+    return frames;
+  }
+
+  uint32_t frames = lovrSoundRead(source->sound, source->offset, count, data);
+  source->offset += frames;
+  return frames;
+}
+
+// Called when a Source runs out of frames, returns whether it loops back to the beginning
+static bool endSource(Source* source) {
+  source->offset = 0;
+
+  if (atomic_load_explicit(&source->looping, memory_order_relaxed) && !source->ring) {
+    return true;
+  }
+
+  atomic_store_explicit(&source->playing, false, memory_order_relaxed);
+  if (source->ring) requestSeek(source, 0);
+  return false;
+}
+
+// Resampling
+
+// Sources using the linear or cubic resampler interpolate their frames directly instead of going
+// through a converter.  history holds the frame before the playhead and the two after it, so there
+// are always 4 taps around the playhead, and phase is the playhead's fractional position.
+
+// Reads count floating point frames, looping or padding the end with silence
+static void fillFrames(Source* source, float* data, uint32_t count) {
+  uint32_t channels = lovrSoundGetChannelCount(source->sound);
+  uint32_t frames = 0;
+
+  while (frames < count && atomic_load_explicit(&source->playing, memory_order_relaxed)) {
+    uint32_t read = readSource(source, count - frames, data + frames * channels, false);
+    if (read == 0 && !endSource(source)) break;
+    frames += read;
+  }
+
+  memset(data + frames * channels, 0, (count - frames) * channels * sizeof(float));
+}
+
+static void resample(Source* source, float step, float* dst, uint32_t count, uint32_t channelsOut) {
+  uint32_t channels = lovrSoundGetChannelCount(source->sound);
+  float window[(RESAMPLE_CAPACITY + 3) * 2];
+
+  if (!source->primed) {
+    memset(source->history, 0, channels * sizeof(float));
+    fillFrames(source, source->history + channels, 2);
+    source->phase = 0.;
+    source->primed = true;
+  }
+
+  // Absurd pitches would need more frames per output frame than the window can hold
+  step = MIN(step, RESAMPLE_CAPACITY / 4);
+
+  while (count > 0) {
+    uint32_t chunk = MIN(count, (uint32_t) ((RESAMPLE_CAPACITY - 1. - source->phase) / step));
+    double end = 1. + source->phase + chunk * step;
+    uint32_t frames = (uint32_t) end;
+
+    memcpy(window, source->history, 3 * channels * sizeof(float));
+    fillFrames(source, window + 3 * channels, frames);
+
+    for (uint32_t i = 0; i < chunk; i++) {
+      double t = 1. + source->phase + i * step;
+      uint32_t index = (uint32_t) t;
+      float f = (float) (t - index);
+      float sample[2];
+
+      for (uint32_t c = 0; c < channels; c++) {
+        float* p = window + (index - 1) * channels + c;
+        float a = p[0], b = p[channels], x = p[2 * channels], y = p[3 * channels];
+        if (source->resampler == RESAMPLER_CUBIC) {
+          sample[c] = b + .5f * f * (x - a + f * (2.f * a - 5.f * b + 4.f * x - y + f * (3.f * (b - x) + y - a)));
+        } else {
+          sample[c] = b + (x - b) * f;
+        }
+      }
+
+      if (channelsOut == channels) {
+        for (uint32_t c = 0; c < channels; c++) dst[c] = sample[c];
+      } else if (channelsOut == 2) {
+        dst[0] = dst[1] = sample[0];
+      } else {
+        dst[0] = (sample[0] + sample[1]) * .5f;
+      }
+
+      dst += channelsOut;
+    }
+
+    memcpy(source->history, window + (frames - 1) * channels, 3 * channels * sizeof(float));
+    source->phase = end - frames;
+    count -= chunk;
+  }
+}
+
+// Voices
+
+// Every playing Source is tracked, but only the most audible ones get one of the real voices and
+// are decoded, converted, and spatialized.  The rest are virtual and only advance their cursor.
+
+static float getAudibility(Source* source, SourceParams* params) {
+  // Streams can't skip ahead, so they have to stay real
+  if (lovrSoundIsStream(source->sound)) {
+    return HUGE_VALF;
+  }
+
+  float audibility = params->priority * params->volume;
+
+  if (source->spatial && (params->effects & (1 << EFFECT_ATTENUATION))) {
+    float distance = vec3_distance(params->position, state.poses[state.poseFront].position);
+    audibility /= MAX(distance, 1.f);
+  }
+
+  return audibility;
+}
+
+static int compareAudibility(const void* a, const void* b) {
+  float x = (*(Source**) a)->score;
+  float y = (*(Source**) b)->score;
+  return (x < y) - (x > y);
+}
+
+static void promoteSource(Source* source) {
+  if (state.voiceMask == ~0ull) {
+    return;
+  }
+
+  uint32_t index = CTZL(~state.voiceMask);
+  state.voiceMask |= (1ull << index);
+  state.voices[index] = source;
+  source->index = index;
+  source->demoting = false;
+  state.spatializer->sourceCreate(source);
+
+  // Sources coming back from being virtual fade in at their new position
+  if (source->virtualized) {
+    source->gain = 0.f;
+    source->primed = false;
+    if (source->ring) requestSeek(source, source->offset);
+  } else {
+    source->gain = 1.f;
+  }
+}
+
+static void demoteSource(Source* source) {
+  state.voices[source->index] = NULL;
+  state.voiceMask &= ~(1ull << source->index);
+  state.spatializer->sourceDestroy(source);
+  source->index = ~0u;
+  source->demoting = false;
+  source->virtualized = true;
+}
+
+static void advanceSource(Source* source, SourceParams* params) {
+  float rate = (float) lovrSoundGetSampleRate(source->sound) / state.sampleRate;
+  uint32_t frames = (uint32_t) (BUFFER_SIZE * rate * (source->pitchable ? params->pitch : 1.f) + .5f);
+  uint32_t length = lovrSoundGetFrameCount(source->sound);
+
+  source->offset += frames;
+
+  if (source->offset >= length) {
+    if (atomic_load_explicit(&source->looping, memory_order_relaxed) && length > 0) {
+      source->offset %= length;
+    } else {
+      source->offset = 0;
+      atomic_store_explicit(&source->playing, false, memory_order_relaxed);
+      if (source->ring) requestSeek(source, 0);
+    }
+  }
+}
+
+// Drops stopped Sources, ranks the rest, and assigns the real voices
+static void updateVoices(void) {
+  for (uint32_t i = 0; i < state.sourceCount;) {
+    Source* source = state.sources[i];
+
+    if (!atomic_load_explicit(&source->playing, memory_order_relaxed)) {
+      if (source->index != ~0u) demoteSource(source);
+      source->tracked = false;
+      state.sources[i] = state.sources[--state.sourceCount];
+      lovrRelease(source, lovrSourceDestroy);
+      continue;
+    }
+
+    source->score = getAudibility(source, consumeParams(source));
+    state.ranking[i] = source;
+    i++;
+  }
+
+  uint32_t limit = atomic_load_explicit(&state.voiceLimit, memory_order_relaxed);
+
+  if (state.sourceCount > limit) {
+    qsort(state.ranking, state.sourceCount, sizeof(Source*), compareAudibility);
+  }
+
+  uint32_t real = 0;
+  for (uint32_t i = 0; i < state.sourceCount; i++) {
+    Source* source = state.ranking[i];
+    bool audible = i < limit && source->score >= AUDIBILITY_THRESHOLD;
+
+    if (audible && source->index == ~0u) {
+      promoteSource(source);
+    } else if (source->index != ~0u) {
+      // Voices losing their slot are mixed one last time while fading out
+      source->demoting = !audible;
+    }
+
+    if (source->index == ~0u) {
+      advanceSource(source, &source->snapshots[source->front]);
+    } else {
+      real++;
+    }
+  }
+
+  atomic_store_explicit(&state.realVoiceCount, real, memory_order_relaxed);
+  atomic_store_explicit(&state.virtualVoiceCount, state.sourceCount - real, memory_order_relaxed);
+}
+
 // Device callbacks
 
-static void onPlayback(ma_device* device, void* out, const void* in, uint32_t count) {
-  lovrAssert(count == BUFFER_SIZE, "Unreachable");
+// Mixes BUFFER_SIZE frames of all playing Sources into dst, which must be zeroed
+static void mixSources(float* dst) {
   float raw[BUFFER_SIZE * 2];
   float aux[BUFFER_SIZE * 2];
   float mix[BUFFER_SIZE * 2];
-  float* dst = out;
   float* buf = NULL; // The "current" buffer (used for fast paths)
-
-  ma_mutex_lock(&state.lock);
+  double start = os_get_time();
+  double convertTime = 0.;
+
+  processCommands();
+  consumePose();
+  updateVoices();
+
+  // Geometry changes are rare and slow, instead of waiting, spatialized Sources are silent meanwhile
+  bool spatialize = mtx_trylock(&state.spatializerLock) == thrd_success;
+
+  uint32_t busCount = atomic_load_explicit(&state.busCount, memory_order_acquire);
+  for (uint32_t i = 0; i < busCount; i++) {
+    Bus* bus = &state.buses[i];
+    if (consumeBusParams(bus)) {
+      BusParams* params = &bus->snapshots[bus->front];
+      dsp_filter_type type = params->filter == FILTER_HIGHPASS ? DSP_HIGHPASS : DSP_LOWPASS;
+      dsp_biquad_configure(&bus->filter, type, params->frequency, params->resonance, state.sampleRate);
+      dsp_reverb_configure(&bus->reverb, params->reverbDecay, params->reverbDamping, state.sampleRate);
+
+      // Disabled effects are cleared, so they don't replay stale audio when they come back
+      if (params->reverbMix <= 0.f) dsp_reverb_reset(&bus->reverb);
+      if (params->limiterThreshold <= 0.f) dsp_limiter_reset(&bus->limiter);
+    }
+    memset(bus->buffer, 0, sizeof(bus->buffer));
+  }
 
   Source* source;
-  FOREACH_SOURCE(source) {
-    if (!source->playing) {
-      state.sources[source->index] = NULL;
-      state.sourceMask &= ~(1ull << source->index);
-      state.spatializer->sourceDestroy(source);
-      source->index = ~0u;
-      lovrRelease(source, lovrSourceDestroy);
-      continue;
+  FOREACH_VOICE(source) {
+    SourceParams* params = &source->snapshots[source->front];
+    uint32_t rate = lovrSoundGetSampleRate(source->sound);
+    uint32_t channelsIn = lovrSoundGetChannelCount(source->sound);
+    uint32_t channelsOut = source->spatial ? 1 : 2; // If spatializer isn't converting to stereo, converter must do it
+
+    // Sources at the device rate and their original pitch skip conversion.  Sources with a converter
+    // never do, since it buffers input that would be dropped or replayed late when toggling bypass.
+    bool bypass = !source->converter && rate == state.sampleRate && params->pitch == 1.f && channelsIn == channelsOut;
+    bool convert = !bypass && source->converter;
+    double convertStart = bypass ? 0. : os_get_time();
+
+    if (convert && source->ratio != params->pitch) {
+      float ratio = (float) rate / state.sampleRate;
+      ma_data_converter_set_rate_ratio(source->converter, params->pitch * ratio);
+      source->ratio = params->pitch;
     }
 
     // Read and convert raw frames until there's BUFFER_SIZE converted frames
+    // - Resampler: interpolate frames into aux.
     // - No converter: just read frames into raw (it has enough space for BUFFER_SIZE frames).
+    //   Sources that were resampling first output the frames still held in their history.
     // - Converter: keep reading as many frames as possible/needed into raw and convert into aux.
     // - If EOF is reached, rewind and continue for looping sources, otherwise pad end with zero.
-    buf = source->converter ? aux : raw;
+    buf = bypass ? raw : aux;
     float* cursor = buf; // Edge of processed frames
-    uint32_t channelsOut = source->spatial ? 1 : 2; // If spatializer isn't converting to stereo, converter must do it
     uint32_t framesRemaining = BUFFER_SIZE;
+
+    if (!bypass && !convert) {
+      resample(source, params->pitch * rate / state.sampleRate, aux, BUFFER_SIZE, channelsOut);
+      framesRemaining = 0;
+    } else if (bypass && source->primed) {
+      memcpy(cursor, source->history + channelsIn, 2 * channelsIn * sizeof(float));
+      cursor += 2 * channelsOut;
+      framesRemaining -= 2;
+      source->primed = false;
+    }
+
     while (framesRemaining > 0) {
       uint32_t framesRead;
 
-      if (source->converter) {
-        uint32_t channelsIn = lovrSoundGetChannelCount(source->sound);
+      if (convert) {
         uint32_t capacity = sizeof(raw) / (channelsIn * sizeof(float));
         ma_uint64 chunk;
         ma_data_converter_get_required_input_frame_count(source->converter, framesRemaining, &chunk);
-        framesRead = lovrSoundRead(source->sound, source->offset, MIN(chunk, capacity), raw);
+        framesRead = readSource(source, MIN(chunk, capacity), raw, true);
       } else {
-        framesRead = lovrSoundRead(source->sound, source->offset, framesRemaining, cursor);
+        framesRead = readSource(source, framesRemaining, cursor, false);
       }
 
       if (framesRead == 0) {
-        if (source->looping) {
-          source->offset = 0;
+        if (endSource(source)) {
           continue;
         } else {
-          source->offset = 0;
-          source->playing = false;
           memset(cursor, 0, framesRemaining * channelsOut * sizeof(float));
           break;
         }
-      } else {
-        source->offset += framesRead;
       }
 
-      if (source->converter) {
+      if (convert) {
         ma_uint64 framesIn = framesRead;
         ma_uint64 framesOut = framesRemaining;
         ma_data_converter_process_pcm_frames(source->converter, raw, &framesIn, cursor, &framesOut);
@@ -139,28 +864,85 @@ static void onPlayback(ma_device* device, void* out, const void* in, uint32_t co
       }
     }
 
+    if (!bypass) {
+      convertTime += os_get_time() - convertStart;
+    }
+
     // Spatialize
     if (source->spatial) {
-      state.spatializer->apply(source, buf, mix, BUFFER_SIZE, BUFFER_SIZE);
+      if (spatialize) {
+        state.spatializer->apply(source, buf, mix, BUFFER_SIZE, BUFFER_SIZE);
+      } else {
+        memset(mix, 0, sizeof(mix));
+      }
       buf = mix;
     }
 
-    // Mix
-    float volume = source->volume;
-    for (uint32_t i = 0; i < OUTPUT_CHANNELS * BUFFER_SIZE; i++) {
-      dst[i] += buf[i] * volume;
+    // Mix, ramping the gain of voices that were just promoted or are being demoted
+    float volume = params->volume;
+    float target = source->demoting ? 0.f : 1.f;
+    float step = (target - source->gain) / BUFFER_SIZE;
+    float* output = params->bus > 0 && params->bus <= busCount ? state.buses[params->bus - 1].buffer : dst;
+    convert_mix_stereo(output, buf, BUFFER_SIZE, volume * source->gain, volume * step);
+    source->gain = target;
+
+    if (source->demoting) {
+      demoteSource(source);
     }
   }
 
+  // Buses
+  for (uint32_t i = 0; i < busCount; i++) {
+    Bus* bus = &state.buses[i];
+    BusParams* params = &bus->snapshots[bus->front];
+
+    if (params->filter != FILTER_NONE) {
+      dsp_biquad_process(&bus->filter, bus->buffer, BUFFER_SIZE);
+    }
+
+    if (params->reverbMix > 0.f) {
+      dsp_reverb_process(&bus->reverb, bus->buffer, BUFFER_SIZE, params->reverbMix);
+    }
+
+    if (params->limiterThreshold > 0.f) {
+      dsp_limiter_process(&bus->limiter, bus->buffer, BUFFER_SIZE, params->limiterThreshold, params->limiterRelease, state.sampleRate);
+    }
+
+    convert_mix_stereo(dst, bus->buffer, BUFFER_SIZE, params->volume, 0.f);
+  }
+
   // Tail
-  uint32_t tailCount = state.spatializer->tail(aux, mix, BUFFER_SIZE);
-  for (uint32_t i = 0; i < tailCount * OUTPUT_CHANNELS; i++) {
-    dst[i] += mix[i];
+  if (spatialize) {
+    uint32_t tailCount = state.spatializer->tail(aux, mix, BUFFER_SIZE);
+    convert_mix_stereo(dst, mix, tailCount, 1.f, 0.f);
+
+    mtx_unlock(&state.spatializerLock);
   }
 
-  ma_mutex_unlock(&state.lock);
+  // The device is created with noClip, since this also flushes NaNs
+  convert_clamp_f32(dst, BUFFER_SIZE * OUTPUT_CHANNELS);
+
+  atomic_store_explicit(&state.mixTime, (uint32_t) ((os_get_time() - start) * 1e9), memory_order_relaxed);
+  atomic_store_explicit(&state.convertTime, (uint32_t) (convertTime * 1e9), memory_order_relaxed);
+}
 
-  if (state.sinks[AUDIO_PLAYBACK]) {
+static void onPlayback(ma_device* device, void* out, const void* in, uint32_t count) {
+  lovrAssert(count == BUFFER_SIZE, "Unreachable");
+  float aux[BUFFER_SIZE * 2];
+  float* dst = out;
+
+  mixSources(dst);
+
+  if (state.sinks[AUDIO_PLAYBACK] && state.sinkDirect) {
+    Sound* sink = state.sinks[AUDIO_PLAYBACK];
+    if (lovrSoundGetFormat(sink) == SAMPLE_I16) {
+      int16_t samples[BUFFER_SIZE * OUTPUT_CHANNELS];
+      convert_f32_to_i16(samples, dst, count * OUTPUT_CHANNELS);
+      lovrSoundWrite(sink, 0, count, samples);
+    } else {
+      lovrSoundWrite(sink, 0, count, dst);
+    }
+  } else if (state.sinks[AUDIO_PLAYBACK]) {
     uint64_t capacity = sizeof(aux) / lovrSoundGetChannelCount(state.sinks[AUDIO_PLAYBACK]) / sizeof(float);
     while (count > 0) {
       ma_uint64 framesConsumed = count;
@@ -186,7 +968,8 @@ static Spatializer* spatializers[] = {
 #ifdef LOVR_ENABLE_OCULUS_SPATIALIZER
   &oculusSpatializer,
 #endif
-  &simpleSpatializer
+  &simpleSpatializer,
+  &hrtfSpatializer
 };
 
 // Entry
@@ -199,8 +982,9 @@ bool lovrAudioInit(const char* spatializer, uint32_t sampleRate) {
   ma_result result = ma_context_init(NULL, 0, NULL, &state.context);
   lovrAssert(result == MA_SUCCESS, "Failed to initialize miniaudio");
 
-  result = ma_mutex_init(&state.lock);
-  lovrAssert(result == MA_SUCCESS, "Failed to create audio mutex");
+  lovrAssert(mtx_init(&state.commandLock, mtx_plain) == thrd_success, "Failed to create audio command mutex");
+  lovrAssert(mtx_init(&state.spatializerLock, mtx_plain) == thrd_success, "Failed to create audio spatializer mutex");
+  lovrAssert(mtx_init(&state.deviceLock, mtx_plain) == thrd_success, "Failed to create audio device mutex");
 
   for (size_t i = 0; i < COUNTOF(spatializers); i++) {
     if (spatializer && strcmp(spatializer, spatializers[i]->name)) {
@@ -219,7 +1003,21 @@ bool lovrAudioInit(const char* spatializer, uint32_t sampleRate) {
   state.absorption[1] = .0017f;
   state.absorption[2] = .0182f;
 
-  quat_identity(state.orientation);
+  quat_identity(state.pose.orientation);
+  for (uint32_t i = 0; i < 3; i++) {
+    state.poses[i] = state.pose;
+  }
+  state.poseBack = 0;
+  state.poseFront = 2;
+  atomic_store_explicit(&state.poseSnapshot, 1, memory_order_release);
+  state.voiceLimit = MAX_SOURCES;
+  state.renderCursor = BUFFER_SIZE;
+
+  arr_init(&state.decodeList, arr_alloc);
+  lovrAssert(mtx_init(&state.decodeLock, mtx_plain) == thrd_success, "Failed to create audio decoder mutex");
+  lovrAssert(cnd_init(&state.decodeCond) == thrd_success, "Failed to create audio decoder condition variable");
+  state.decoding = true;
+  lovrAssert(thrd_create(&state.decodeThread, decodeLoop, NULL) == thrd_success, "Failed to start audio decoder thread");
 
   return state.initialized = true;
 }
@@ -229,9 +1027,28 @@ void lovrAudioDestroy() {
   for (size_t i = 0; i < 2; i++) {
     ma_device_uninit(&state.devices[i]);
   }
-  Source* source;
-  FOREACH_SOURCE(source) lovrRelease(source, lovrSourceDestroy);
-  ma_mutex_uninit(&state.lock);
+  mtx_lock(&state.decodeLock);
+  state.decoding = false;
+  cnd_signal(&state.decodeCond);
+  mtx_unlock(&state.decodeLock);
+  thrd_join(state.decodeThread, NULL);
+  for (size_t i = 0; i < state.decodeList.length; i++) {
+    lovrRelease(state.decodeList.data[i], lovrSourceDestroy);
+  }
+  arr_free(&state.decodeList);
+  cnd_destroy(&state.decodeCond);
+  mtx_destroy(&state.decodeLock);
+  processCommands();
+  for (uint32_t i = 0; i < state.sourceCount; i++) {
+    lovrRelease(state.sources[i], lovrSourceDestroy);
+  }
+  for (uint32_t i = 0; i < atomic_load(&state.busCount); i++) {
+    dsp_reverb_destroy(&state.buses[i].reverb);
+    dsp_limiter_destroy(&state.buses[i].limiter);
+  }
+  mtx_destroy(&state.commandLock);
+  mtx_destroy(&state.deviceLock);
+  mtx_destroy(&state.spatializerLock);
   ma_context_uninit(&state.context);
   lovrRelease(state.sinks[AUDIO_PLAYBACK], lovrSoundDestroy);
   lovrRelease(state.sinks[AUDIO_CAPTURE], lovrSoundDestroy);
@@ -295,7 +1112,9 @@ bool lovrAudioSetDevice(AudioType type, void* id, size_t size, Sound* sink, Audi
     config.playback.format = ma_format_f32;
     config.playback.channels = OUTPUT_CHANNELS;
     config.sampleRate = state.sampleRate;
+    config.noClip = true;
     if (sink) {
+      state.sinkDirect = lovrSoundGetChannelCount(sink) == OUTPUT_CHANNELS && lovrSoundGetSampleRate(sink) == state.sampleRate;
       ma_data_converter_config converterConfig = ma_data_converter_config_init_default();
       converterConfig.formatIn = config.playback.format;
       converterConfig.formatOut = miniaudioFormats[lovrSoundGetFormat(sink)];
@@ -323,8 +1142,14 @@ bool lovrAudioSetDevice(AudioType type, void* id, size_t size, Sound* sink, Audi
   return result == MA_SUCCESS;
 }
 
+// Starting the playback device waits for renders to finish, and drops the frames left over from the
+// last rendered period since the device picks up from a new one
 bool lovrAudioStart(AudioType type) {
-  return ma_device_start(&state.devices[type]) == MA_SUCCESS;
+  mtx_lock(&state.deviceLock);
+  bool success = ma_device_start(&state.devices[type]) == MA_SUCCESS;
+  if (success && type == AUDIO_PLAYBACK) state.renderCursor = BUFFER_SIZE;
+  mtx_unlock(&state.deviceLock);
+  return success;
 }
 
 bool lovrAudioStop(AudioType type) {
@@ -347,18 +1172,34 @@ void lovrAudioSetVolume(float volume, VolumeUnit units) {
 }
 
 void lovrAudioGetPose(float position[4], float orientation[4]) {
-  memcpy(position, state.position, sizeof(state.position));
-  memcpy(orientation, state.orientation, sizeof(state.orientation));
+  mtx_lock(&state.commandLock);
+  memcpy(position, state.pose.position, sizeof(state.pose.position));
+  memcpy(orientation, state.pose.orientation, sizeof(state.pose.orientation));
+  mtx_unlock(&state.commandLock);
 }
 
 void lovrAudioSetPose(float position[4], float orientation[4]) {
-  state.spatializer->setListenerPose(position, orientation);
+  mtx_lock(&state.commandLock);
+  memcpy(state.pose.position, position, sizeof(state.pose.position));
+  memcpy(state.pose.orientation, orientation, sizeof(state.pose.orientation));
+  publishPose();
 }
 
 bool lovrAudioSetGeometry(float* vertices, uint32_t* indices, uint32_t vertexCount, uint32_t indexCount, AudioMaterial material) {
-  ma_mutex_lock(&state.lock);
+  mtx_lock(&state.spatializerLock);
   bool success = state.spatializer->setGeometry(vertices, indices, vertexCount, indexCount, material);
-  ma_mutex_unlock(&state.lock);
+  mtx_unlock(&state.spatializerLock);
+  return success;
+}
+
+bool lovrAudioSetHRTF(const void* data, size_t size) {
+  if (!state.spatializer->setHRTF) {
+    return false;
+  }
+
+  mtx_lock(&state.spatializerLock);
+  bool success = state.spatializer->setHRTF(data, size);
+  mtx_unlock(&state.spatializerLock);
   return success;
 }
 
@@ -375,14 +1216,145 @@ void lovrAudioGetAbsorption(float absorption[3]) {
 }
 
 void lovrAudioSetAbsorption(float absorption[3]) {
-  ma_mutex_lock(&state.lock);
+  mtx_lock(&state.spatializerLock);
   memcpy(state.absorption, absorption, 3 * sizeof(float));
-  ma_mutex_unlock(&state.lock);
+  mtx_unlock(&state.spatializerLock);
+}
+
+uint32_t lovrAudioRender(Sound* sound, uint32_t offset, uint32_t frames) {
+  lovrCheck(lovrSoundGetChannelCount(sound) == OUTPUT_CHANNELS, "Audio can only be rendered to stereo Sounds");
+  lovrCheck(lovrSoundGetSampleRate(sound) == state.sampleRate, "Sound sample rate must match the audio sample rate (%d)", state.sampleRate);
+  uint32_t length = lovrSoundGetFrameCount(sound);
+  lovrCheck(lovrSoundIsStream(sound) || (offset <= length && frames <= length - offset), "Tried to render past the end of the Sound");
+
+  // The device lock keeps the playback device from starting and other threads from rendering
+  // until this render is done
+  mtx_lock(&state.deviceLock);
+
+  if (lovrAudioIsStarted(AUDIO_PLAYBACK)) {
+    mtx_unlock(&state.deviceLock);
+    lovrThrow("The playback device must be stopped to render audio");
+  }
+
+  int16_t samples[BUFFER_SIZE * OUTPUT_CHANNELS];
+  bool convert = lovrSoundGetFormat(sound) == SAMPLE_I16;
+  uint32_t written = 0;
+
+  // Sources always advance by whole periods.  The frames of the last period that aren't written are
+  // kept in renderBuffer and written first by the next render, so consecutive renders are contiguous.
+  state.rendering = true;
+  while (written < frames) {
+    if (state.renderCursor == BUFFER_SIZE) {
+      memset(state.renderBuffer, 0, sizeof(state.renderBuffer));
+      mixSources(state.renderBuffer);
+      state.renderCursor = 0;
+    }
+
+    float* buffer = state.renderBuffer + state.renderCursor * OUTPUT_CHANNELS;
+    uint32_t chunk = MIN(frames - written, BUFFER_SIZE - state.renderCursor);
+
+    if (convert) {
+      convert_f32_to_i16(samples, buffer, chunk * OUTPUT_CHANNELS);
+    }
+
+    uint32_t count = lovrSoundWrite(sound, offset + written, chunk, convert ? (void*) samples : (void*) buffer);
+    state.renderCursor += count;
+    written += count;
+
+    if (count < chunk) {
+      break;
+    }
+  }
+  state.rendering = false;
+
+  mtx_unlock(&state.deviceLock);
+  return written;
+}
+
+uint32_t lovrAudioGetVoiceLimit() {
+  return atomic_load_explicit(&state.voiceLimit, memory_order_relaxed);
+}
+
+void lovrAudioSetVoiceLimit(uint32_t limit) {
+  lovrCheck(limit > 0 && limit <= MAX_SOURCES, "Voice limit must be between 1 and %d", MAX_SOURCES);
+  atomic_store_explicit(&state.voiceLimit, limit, memory_order_relaxed);
+}
+
+void lovrAudioGetVoiceStats(uint32_t* real, uint32_t* virtual, double* mixTime, double* convertTime) {
+  *real = atomic_load_explicit(&state.realVoiceCount, memory_order_relaxed);
+  *virtual = atomic_load_explicit(&state.virtualVoiceCount, memory_order_relaxed);
+  *mixTime = atomic_load_explicit(&state.mixTime, memory_order_relaxed) / 1e9;
+  *convertTime = atomic_load_explicit(&state.convertTime, memory_order_relaxed) / 1e9;
+}
+
+void lovrAudioCreateBus(const char* name) {
+  lovrCheck(strlen(name) < sizeof(state.buses[0].name), "Bus name is too long");
+  lovrCheck(!findBus(name), "A bus named '%s' already exists", name);
+
+  BusParams params = {
+    .volume = 1.f,
+    .filter = FILTER_NONE,
+    .frequency = 1000.f,
+    .resonance = .7071f,
+    .reverbMix = 0.f,
+    .reverbDecay = 1.5f,
+    .reverbDamping = .5f,
+    .limiterThreshold = 0.f,
+    .limiterRelease = .1f
+  };
+
+  dsp_reverb reverb;
+  dsp_limiter limiter;
+  lovrAssert(dsp_reverb_init(&reverb, state.sampleRate), "Out of memory");
+  lovrAssert(dsp_limiter_init(&limiter, BUFFER_SIZE), "Out of memory");
+  dsp_reverb_configure(&reverb, params.reverbDecay, params.reverbDamping, state.sampleRate);
+
+  mtx_lock(&state.commandLock);
+  uint32_t count = atomic_load_explicit(&state.busCount, memory_order_relaxed);
+
+  if (count >= MAX_BUSES) {
+    mtx_unlock(&state.commandLock);
+    dsp_reverb_destroy(&reverb);
+    dsp_limiter_destroy(&limiter);
+    lovrThrow("Too many buses (the maximum is %d)", MAX_BUSES);
+  }
+
+  Bus* bus = &state.buses[count];
+  strcpy(bus->name, name);
+  bus->params = params;
+  for (uint32_t i = 0; i < 3; i++) {
+    bus->snapshots[i] = params;
+  }
+  bus->back = 0;
+  bus->front = 2;
+  atomic_store_explicit(&bus->snapshot, 1, memory_order_relaxed);
+  dsp_biquad_init(&bus->filter);
+  bus->reverb = reverb;
+  bus->limiter = limiter;
+  atomic_store_explicit(&state.busCount, count + 1, memory_order_release);
+  mtx_unlock(&state.commandLock);
+}
+
+void lovrAudioGetBusParams(const char* name, BusParams* params) {
+  uint32_t index = findBus(name);
+  lovrAssert(index > 0, "Unknown bus '%s'", name);
+  mtx_lock(&state.commandLock);
+  *params = state.buses[index - 1].params;
+  mtx_unlock(&state.commandLock);
+}
+
+void lovrAudioSetBusParams(const char* name, BusParams* params) {
+  uint32_t index = findBus(name);
+  lovrAssert(index > 0, "Unknown bus '%s'", name);
+  Bus* bus = &state.buses[index - 1];
+  mtx_lock(&state.commandLock);
+  bus->params = *params;
+  publishBusParams(bus);
 }
 
 // Source
 
-Source* lovrSourceCreate(Sound* sound, bool pitchable, bool spatial, uint32_t effects) {
+Source* lovrSourceCreate(Sound* sound, bool pitchable, bool spatial, uint32_t effects, Resampler resampler) {
   lovrAssert(lovrSoundGetChannelLayout(sound) != CHANNEL_AMBISONIC, "Ambisonic Sources are not currently supported");
   Source* source = calloc(1, sizeof(Source));
   lovrAssert(source, "Out of memory");
@@ -391,12 +1363,20 @@ Source* lovrSourceCreate(Sound* sound, bool pitchable, bool spatial, uint32_t ef
   source->sound = sound;
   lovrRetain(source->sound);
 
-  source->pitch = 1.f;
-  source->volume = 1.f;
+  source->params.pitch = 1.f;
+  source->params.volume = 1.f;
+  source->params.effects = spatial ? effects : 0;
+  source->params.priority = 1.f;
+  quat_identity(source->params.orientation);
+  source->ratio = 1.f;
   source->pitchable = pitchable;
   source->spatial = spatial;
-  source->effects = spatial ? effects : 0;
-  quat_identity(source->orientation);
+  source->resampler = resampler;
+  initParams(source);
+
+  if (lovrSoundIsCompressed(sound)) {
+    source->ring = createDecodeRing(sound);
+  }
 
   ma_data_converter_config config = ma_data_converter_config_init_default();
   config.formatIn = miniaudioFormats[lovrSoundGetFormat(sound)];
@@ -407,7 +1387,9 @@ Source* lovrSourceCreate(Sound* sound, bool pitchable, bool spatial, uint32_t ef
   config.sampleRateOut = state.sampleRate;
   config.allowDynamicSampleRate = pitchable;
 
-  if (pitchable || config.formatIn != config.formatOut || config.channelsIn != config.channelsOut || config.sampleRateIn != config.sampleRateOut) {
+  bool needsConversion = pitchable || config.channelsIn != config.channelsOut || config.sampleRateIn != config.sampleRateOut;
+
+  if (needsConversion && resampler == RESAMPLER_FILTERED) {
     source->converter = malloc(sizeof(ma_data_converter));
     lovrAssert(source->converter, "Out of memory");
     ma_result status = ma_data_converter_init(&config, NULL, source->converter);
@@ -424,17 +1406,18 @@ Source* lovrSourceClone(Source* source) {
   clone->index = ~0u;
   clone->sound = source->sound;
   lovrRetain(clone->sound);
-  clone->pitch = source->pitch;
-  clone->volume = source->volume;
-  memcpy(clone->position, source->position, 4 * sizeof(float));
-  memcpy(clone->orientation, source->orientation, 4 * sizeof(float));
-  clone->radius = source->radius;
-  clone->dipoleWeight = source->dipoleWeight;
-  clone->dipolePower = source->dipolePower;
-  clone->effects = source->effects;
-  clone->looping = source->looping;
+  mtx_lock(&state.commandLock);
+  clone->params = source->params;
+  mtx_unlock(&state.commandLock);
+  clone->ratio = 1.f;
+  initParams(clone);
+  atomic_store_explicit(&clone->looping, atomic_load_explicit(&source->looping, memory_order_relaxed), memory_order_relaxed);
   clone->pitchable = source->pitchable;
   clone->spatial = source->spatial;
+  clone->resampler = source->resampler;
+  if (source->ring) {
+    clone->ring = createDecodeRing(source->sound);
+  }
   if (source->converter) {
     clone->converter = malloc(sizeof(ma_data_converter));
     lovrAssert(clone->converter, "Out of memory");
@@ -457,6 +1440,7 @@ void lovrSourceDestroy(void* ref) {
   lovrRelease(source->sound, lovrSoundDestroy);
   ma_data_converter_uninit(source->converter, NULL);
   free(source->converter);
+  destroyDecodeRing(source->ring);
   free(source);
 }
 
@@ -466,30 +1450,40 @@ Sound* lovrSourceGetSound(Source* source) {
 
 bool lovrSourcePlay(Source* source) {
   // If too many sources already running, refuse to play
-  if (state.sourceMask == ~0ull) {
+  if (state.sourceCount >= MAX_PLAYING_SOURCES) {
     return false;
   }
 
-  ma_mutex_lock(&state.lock);
+  atomic_store_explicit(&source->playing, true, memory_order_relaxed);
 
-  source->playing = true;
+  if (!pushCommand(COMMAND_PLAY, source, 0)) {
+    atomic_store_explicit(&source->playing, false, memory_order_relaxed);
+    return false;
+  }
 
-  // If the source isn't tracked, set its index to the right-most zero bit in the mask
-  if (source->index == ~0u) {
-    uint32_t index = state.sourceMask ? CTZL(~state.sourceMask) : 0;
-    state.sourceMask |= (1ull << index);
-    state.sources[index] = source;
-    source->index = index;
-    lovrRetain(source);
-    state.spatializer->sourceCreate(source);
+  if (source->ring) {
+    mtx_lock(&state.decodeLock);
+    if (!source->decoding) {
+      source->decoding = true;
+      arr_push(&state.decodeList, source);
+      lovrRetain(source);
+    }
+    cnd_signal(&state.decodeCond);
+    mtx_unlock(&state.decodeLock);
   }
 
-  ma_mutex_unlock(&state.lock);
   return true;
 }
 
 void lovrSourcePause(Source* source) {
-  source->playing = false;
+  atomic_store_explicit(&source->playing, false, memory_order_relaxed);
+
+  // Wakes the decoder thread so it drops the Source and its reference right away
+  if (source->ring) {
+    mtx_lock(&state.decodeLock);
+    cnd_signal(&state.decodeCond);
+    mtx_unlock(&state.decodeLock);
+  }
 }
 
 void lovrSourceStop(Source* source) {
@@ -498,48 +1492,60 @@ void lovrSourceStop(Source* source) {
 }
 
 bool lovrSourceIsPlaying(Source* source) {
-  return source->playing;
+  return atomic_load_explicit(&source->playing, memory_order_relaxed);
 }
 
 bool lovrSourceIsLooping(Source* source) {
-  return source->looping;
+  return atomic_load_explicit(&source->looping, memory_order_relaxed);
 }
 
 void lovrSourceSetLooping(Source* source, bool loop) {
   lovrAssert(loop == false || lovrSoundIsStream(source->sound) == false, "Can't loop streams");
-  source->looping = loop;
+  atomic_store_explicit(&source->looping, loop, memory_order_relaxed);
 }
 
 float lovrSourceGetPitch(Source* source) {
-  return source->pitch;
+  mtx_lock(&state.commandLock);
+  float pitch = source->params.pitch;
+  mtx_unlock(&state.commandLock);
+  return pitch;
 }
 
 void lovrSourceSetPitch(Source* source, float pitch) {
   lovrCheck(pitch > 0.f, "Source pitch must be positive");
   lovrCheck(source->pitchable, "Source must be created with the 'pitchable' flag to change its pitch");
 
-  if (source->pitch != pitch) {
-    source->pitch = pitch;
-    ma_mutex_lock(&state.lock);
-    float ratio = (float) lovrSoundGetSampleRate(source->sound) / state.sampleRate;
-    ma_data_converter_set_rate_ratio(source->converter, pitch * ratio);
-    ma_mutex_unlock(&state.lock);
+  mtx_lock(&state.commandLock);
+
+  if (source->params.pitch == pitch) {
+    mtx_unlock(&state.commandLock);
+    return;
   }
+
+  source->params.pitch = pitch;
+  publishParams(source);
 }
 
 float lovrSourceGetVolume(Source* source, VolumeUnit units) {
-  return units == UNIT_LINEAR ? source->volume : linearToDb(source->volume);
+  mtx_lock(&state.commandLock);
+  float volume = source->params.volume;
+  mtx_unlock(&state.commandLock);
+  return units == UNIT_LINEAR ? volume : linearToDb(volume);
 }
 
 void lovrSourceSetVolume(Source* source, float volume, VolumeUnit units) {
   if (units == UNIT_DECIBELS) volume = dbToLinear(volume);
-  source->volume = CLAMP(volume, 0.f, 1.f);
+  mtx_lock(&state.commandLock);
+  source->params.volume = CLAMP(volume, 0.f, 1.f);
+  publishParams(source);
 }
 
 void lovrSourceSeek(Source* source, double time, TimeUnit units) {
-  ma_mutex_lock(&state.lock);
-  source->offset = units == UNIT_SECONDS ? (uint32_t) (time * lovrSoundGetSampleRate(source->sound) + .5) : (uint32_t) time;
-  ma_mutex_unlock(&state.lock);
+  uint32_t offset = units == UNIT_SECONDS ? (uint32_t) (time * lovrSoundGetSampleRate(source->sound) + .5) : (uint32_t) time;
+
+  // Seeks go through the mixer even for ring Sources, so a virtual voice's offset is up to date
+  // when it gets promoted again.  The mixer forwards them to the decoder thread.
+  pushCommand(COMMAND_SEEK, source, offset);
 }
 
 double lovrSourceTell(Source* source, TimeUnit units) {
@@ -556,46 +1562,91 @@ bool lovrSourceIsSpatial(Source* source) {
 }
 
 void lovrSourceGetPose(Source* source, float position[4], float orientation[4]) {
-  memcpy(position, source->position, sizeof(source->position));
-  memcpy(orientation, source->orientation, sizeof(source->orientation));
+  mtx_lock(&state.commandLock);
+  memcpy(position, source->params.position, sizeof(source->params.position));
+  memcpy(orientation, source->params.orientation, sizeof(source->params.orientation));
+  mtx_unlock(&state.commandLock);
 }
 
 void lovrSourceSetPose(Source* source, float position[4], float orientation[4]) {
-  ma_mutex_lock(&state.lock);
-  memcpy(source->position, position, sizeof(source->position));
-  memcpy(source->orientation, orientation, sizeof(source->orientation));
-  ma_mutex_unlock(&state.lock);
+  mtx_lock(&state.commandLock);
+  memcpy(source->params.position, position, sizeof(source->params.position));
+  memcpy(source->params.orientation, orientation, sizeof(source->params.orientation));
+  publishParams(source);
 }
 
 float lovrSourceGetRadius(Source* source) {
-  return source->radius;
+  mtx_lock(&state.commandLock);
+  float radius = source->params.radius;
+  mtx_unlock(&state.commandLock);
+  return radius;
 }
 
 void lovrSourceSetRadius(Source* source, float radius) {
-  source->radius = radius;
+  mtx_lock(&state.commandLock);
+  source->params.radius = radius;
+  publishParams(source);
+}
+
+float lovrSourceGetPriority(Source* source) {
+  mtx_lock(&state.commandLock);
+  float priority = source->params.priority;
+  mtx_unlock(&state.commandLock);
+  return priority;
+}
+
+void lovrSourceSetPriority(Source* source, float priority) {
+  lovrCheck(priority >= 0.f, "Source priority can not be negative");
+  mtx_lock(&state.commandLock);
+  source->params.priority = priority;
+  publishParams(source);
+}
+
+const char* lovrSourceGetBus(Source* source) {
+  mtx_lock(&state.commandLock);
+  uint32_t bus = source->params.bus;
+  mtx_unlock(&state.commandLock);
+  return bus > 0 ? state.buses[bus - 1].name : NULL;
+}
+
+void lovrSourceSetBus(Source* source, const char* name) {
+  uint32_t index = name ? findBus(name) : 0;
+  lovrAssert(!name || index > 0, "Unknown bus '%s'", name);
+  mtx_lock(&state.commandLock);
+  source->params.bus = index;
+  publishParams(source);
 }
 
 void lovrSourceGetDirectivity(Source* source, float* weight, float* power) {
-  *weight = source->dipoleWeight;
-  *power = source->dipolePower;
+  mtx_lock(&state.commandLock);
+  *weight = source->params.dipoleWeight;
+  *power = source->params.dipolePower;
+  mtx_unlock(&state.commandLock);
 }
 
 void lovrSourceSetDirectivity(Source* source, float weight, float power) {
-  source->dipoleWeight = weight;
-  source->dipolePower = power;
+  mtx_lock(&state.commandLock);
+  source->params.dipoleWeight = weight;
+  source->params.dipolePower = power;
+  publishParams(source);
 }
 
 bool lovrSourceIsEffectEnabled(Source* source, Effect effect) {
-  return source->effects & (1 << effect);
+  mtx_lock(&state.commandLock);
+  uint32_t effects = source->params.effects;
+  mtx_unlock(&state.commandLock);
+  return effects & (1 << effect);
 }
 
 void lovrSourceSetEffectEnabled(Source* source, Effect effect, bool enabled) {
   lovrCheck(source->spatial, "Sources must be created with the spatial flag to enable effects");
+  mtx_lock(&state.commandLock);
   if (enabled) {
-    source->effects |= (1 << effect);
+    source->params.effects |= (1 << effect);
   } else {
-    source->effects &= ~(1 << effect);
+    source->params.effects &= ~(1 << effect);
   }
+  publishParams(source);
 }
 
 intptr_t* lovrSourceGetSpatializerMemoField(Source* source) {
@@ -605,3 +1656,7 @@ intptr_t* lovrSourceGetSpatializerMemoField(Source* source) {
 uint32_t lovrSourceGetIndex(Source* source) {
   return source->index;
 }
+
+SourceParams* lovrSourceGetParams(Source* source) {
+  return &source->snapshots[source->front];
+}
@@ -6,6 +6,7 @@
 
 #define BUFFER_SIZE 256
 #define MAX_SOURCES 64
+#define MAX_BUSES 16
 
 struct Sound;
 
@@ -44,6 +45,30 @@ typedef enum {
   AUDIO_CAPTURE
 } AudioType;
 
+typedef enum {
+  RESAMPLER_FILTERED,
+  RESAMPLER_LINEAR,
+  RESAMPLER_CUBIC
+} Resampler;
+
+typedef enum {
+  FILTER_NONE,
+  FILTER_LOWPASS,
+  FILTER_HIGHPASS
+} FilterType;
+
+typedef struct {
+  float volume;
+  FilterType filter;
+  float frequency;
+  float resonance;
+  float reverbMix;
+  float reverbDecay;
+  float reverbDamping;
+  float limiterThreshold; // 0 disables the limiter
+  float limiterRelease;
+} BusParams;
+
 typedef enum {
   UNIT_SECONDS,
   UNIT_FRAMES
@@ -68,14 +93,22 @@ void lovrAudioSetVolume(float volume, VolumeUnit units);
 void lovrAudioGetPose(float position[4], float orientation[4]);
 void lovrAudioSetPose(float position[4], float orientation[4]);
 bool lovrAudioSetGeometry(float* vertices, uint32_t* indices, uint32_t vertexCount, uint32_t indexCount, AudioMaterial material);
+bool lovrAudioSetHRTF(const void* data, size_t size);
 const char* lovrAudioGetSpatializer(void);
 uint32_t lovrAudioGetSampleRate(void);
 void lovrAudioGetAbsorption(float absorption[3]);
 void lovrAudioSetAbsorption(float absorption[3]);
+uint32_t lovrAudioRender(struct Sound* sound, uint32_t offset, uint32_t frames);
+uint32_t lovrAudioGetVoiceLimit(void);
+void lovrAudioSetVoiceLimit(uint32_t limit);
+void lovrAudioGetVoiceStats(uint32_t* real, uint32_t* virtual, double* mixTime, double* convertTime);
+void lovrAudioCreateBus(const char* name);
+void lovrAudioGetBusParams(const char* name, BusParams* params);
+void lovrAudioSetBusParams(const char* name, BusParams* params);
 
 // Source
 
-Source* lovrSourceCreate(struct Sound* sound, bool pitch, bool spatial, uint32_t effects);
+Source* lovrSourceCreate(struct Sound* sound, bool pitch, bool spatial, uint32_t effects, Resampler resampler);
 Source* lovrSourceClone(Source* source);
 void lovrSourceDestroy(void* ref);
 struct Sound* lovrSourceGetSound(Source* source);
@@ -98,6 +131,10 @@ void lovrSourceGetPose(Source* source, float position[4], float orientation[4]);
 void lovrSourceSetPose(Source* source, float position[4], float orientation[4]);
 float lovrSourceGetRadius(Source* source);
 void lovrSourceSetRadius(Source* source, float radius);
+float lovrSourceGetPriority(Source* source);
+void lovrSourceSetPriority(Source* source, float priority);
+const char* lovrSourceGetBus(Source* source);
+void lovrSourceSetBus(Source* source, const char* name);
 void lovrSourceGetDirectivity(Source* source, float* weight, float* power);
 void lovrSourceSetDirectivity(Source* source, float weight, float power);
 bool lovrSourceIsEffectEnabled(Source* source, Effect effect);
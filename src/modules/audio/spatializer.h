@@ -1,8 +1,24 @@
 #include "audio.h"
 
+// Source parameters, as published to the mixer
+typedef struct {
+  float pitch;
+  float volume;
+  float position[4];
+  float orientation[4];
+  float radius;
+  float dipoleWeight;
+  float dipolePower;
+  uint32_t effects;
+  float priority;
+  uint32_t bus; // 0 is the master output, otherwise the index of the bus plus one
+} SourceParams;
+
 // Private Source functions for spatializer use
 intptr_t* lovrSourceGetSpatializerMemoField(Source* source);
 uint32_t lovrSourceGetIndex(Source* source);
+// Only valid on the audio thread, returns the snapshot of parameters being mixed
+SourceParams* lovrSourceGetParams(Source* source);
 
 typedef struct {
   bool (*init)(void);
@@ -17,6 +33,8 @@ typedef struct {
   uint32_t (*tail)(float* scratch, float* output, uint32_t frames);
   void (*setListenerPose)(float position[4], float orientation[4]);
   bool (*setGeometry)(float* vertices, uint32_t* indices, uint32_t vertexCount, uint32_t indexCount, AudioMaterial material);
+  // Optional, loads a set of head-related impulse responses, returns false if the data is invalid
+  bool (*setHRTF)(const void* data, size_t size);
   void (*sourceCreate)(Source* source);
   void (*sourceDestroy)(Source* source);
   const char* name;
@@ -29,3 +47,4 @@ extern Spatializer phononSpatializer;
 extern Spatializer oculusSpatializer;
 #endif
 extern Spatializer simpleSpatializer;
+extern Spatializer hrtfSpatializer;
@@ -0,0 +1,517 @@
+#include "spatializer.h"
+#include "core/convert.h"
+#include "core/dsp.h"
+#include "core/maf.h"
+#include "core/os.h"
+#include "util.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Binaural spatializer, which convolves each Source with the head-related impulse response (HRIR)
+// measured closest to its direction.
+// - Convolution is uniformly partitioned and done with FFTs (overlap-save), in blocks of HRTF_BLOCK.
+// - Until an HRIR set is loaded, it uses HRIRs generated from a spherical head model.
+// - When the closest direction changes, the old and new filters are crossfaded over a block.
+// - Convolution gets HRTF_BUDGET of each period's duration.  The time spent convolving each voice is
+//   measured, and only as many of the most audible Sources as fit in the budget are convolved next
+//   period, the rest are panned.
+//
+// HRIR sets use a compact little endian binary format:
+// - "HRIR", then u32 version (1), u32 sample rate, u32 length (in taps), u32 direction count.
+// - For each direction: f32 azimuth and f32 elevation in degrees, followed by f32 left[length] and
+//   f32 right[length].  Azimuth 0 is forward and 90 is to the left, elevation 90 is up.
+
+#define HRTF_BLOCK 128
+#define HRTF_FFT_SIZE (2 * HRTF_BLOCK)
+#define HRTF_MAX_PARTITIONS 8
+#define HRTF_BUDGET .25
+#define HEAD_RADIUS .0875f
+#define SPEED_OF_SOUND 343.f
+
+typedef struct {
+  uint32_t count;
+  uint32_t partitions;
+  float* directions;
+  float* filters; // Spectrum of left + i * right for each direction and partition, real then imaginary
+} HRIRSet;
+
+typedef struct {
+  float window[HRTF_FFT_SIZE];
+  float spectra[HRTF_MAX_PARTITIONS][2][HRTF_FFT_SIZE];
+  uint32_t cursor;
+  uint32_t direction;
+  float gain;
+  float pan[2];
+  float score;
+  bool active;
+  bool selected;
+  bool convolving;
+} Voice;
+
+static struct {
+  float listener[16];
+  float inverse[16];
+  dsp_fft_plan fft;
+  HRIRSet set;
+  Voice voices[MAX_SOURCES];
+  double convolveTime;
+  uint32_t convolveCount;
+  double voiceCost;
+} state;
+
+// HRIR sets
+
+static void destroySet(HRIRSet* set) {
+  free(set->directions);
+  free(set->filters);
+  memset(set, 0, sizeof(*set));
+}
+
+// irs holds left[length] and right[length] for each direction
+static bool createSet(HRIRSet* set, uint32_t count, uint32_t length, const float* directions, const float* irs) {
+  uint32_t partitions = MIN((length + HRTF_BLOCK - 1) / HRTF_BLOCK, HRTF_MAX_PARTITIONS);
+  length = MIN(length, partitions * HRTF_BLOCK);
+
+  set->count = count;
+  set->partitions = partitions;
+  set->directions = malloc(count * 3 * sizeof(float));
+  set->filters = malloc((size_t) count * partitions * 2 * HRTF_FFT_SIZE * sizeof(float));
+
+  if (!set->directions || !set->filters) {
+    destroySet(set);
+    return false;
+  }
+
+  memcpy(set->directions, directions, count * 3 * sizeof(float));
+
+  // Since both ears are real, one FFT of left + i * right gives a filter that convolves a real input
+  // into left + i * right, so each block needs a single inverse FFT for both ears.
+  for (uint32_t i = 0; i < count; i++) {
+    const float* left = irs + (size_t) i * 2 * length;
+    const float* right = left + length;
+
+    for (uint32_t p = 0; p < partitions; p++) {
+      float* re = set->filters + ((size_t) i * partitions + p) * 2 * HRTF_FFT_SIZE;
+      float* im = re + HRTF_FFT_SIZE;
+      uint32_t start = p * HRTF_BLOCK;
+      uint32_t taps = MIN(length - start, HRTF_BLOCK);
+      memset(re, 0, 2 * HRTF_FFT_SIZE * sizeof(float));
+      memcpy(re, left + start, taps * sizeof(float));
+      memcpy(im, right + start, taps * sizeof(float));
+      dsp_fft(&state.fft, re, im, false);
+
+      for (uint32_t j = 0; j < HRTF_FFT_SIZE; j++) {
+        re[j] /= HRTF_FFT_SIZE;
+        im[j] /= HRTF_FFT_SIZE;
+      }
+    }
+  }
+
+  return true;
+}
+
+static void getDirection(float azimuth, float elevation, float* direction) {
+  float a = azimuth * (float) M_PI / 180.f;
+  float e = elevation * (float) M_PI / 180.f;
+  direction[0] = -sinf(a) * cosf(e);
+  direction[1] = sinf(e);
+  direction[2] = -cosf(a) * cosf(e);
+}
+
+// Spherical head model from Brown and Duda: each ear gets the Woodworth delay and a one-pole/one-zero
+// head shadow filter, both depending on the angle between the source and the ear.
+static bool createSphericalSet(HRIRSet* set, float sampleRate) {
+  uint32_t length = HRTF_BLOCK;
+  float directions[512 * 3];
+  uint32_t count = 0;
+
+  for (int elevation = -40; elevation <= 90; elevation += 10) {
+    uint32_t steps = MAX((uint32_t) (36.f * cosf(elevation * (float) M_PI / 180.f) + .5f), 1);
+    for (uint32_t i = 0; i < steps; i++) {
+      getDirection(360.f * i / steps, (float) elevation, directions + 3 * count++);
+    }
+  }
+
+  float* irs = calloc((size_t) count * 2 * length, sizeof(float));
+  if (!irs) return false;
+
+  float omega = SPEED_OF_SOUND / HEAD_RADIUS;
+  float beta = 2.f * omega;
+  float k = 2.f * sampleRate;
+
+  for (uint32_t i = 0; i < count; i++) {
+    for (uint32_t ear = 0; ear < 2; ear++) {
+      float* ir = irs + ((size_t) i * 2 + ear) * length;
+      float side = ear == 0 ? -1.f : 1.f;
+      float theta = acosf(CLAMP(directions[3 * i] * side, -1.f, 1.f));
+      float delay = theta < (float) M_PI / 2.f ? 1.f - cosf(theta) : theta - (float) M_PI / 2.f + 1.f;
+      delay *= HEAD_RADIUS / SPEED_OF_SOUND * sampleRate;
+
+      float alpha = 1.05f + .95f * cosf(theta / (5.f * (float) M_PI / 6.f) * (float) M_PI);
+      float b0 = (beta + alpha * k) / (beta + k);
+      float b1 = (beta - alpha * k) / (beta + k);
+      float a1 = (beta - k) / (beta + k);
+
+      uint32_t offset = (uint32_t) delay;
+      float fraction = delay - offset;
+      float x1 = 0.f, y1 = 0.f;
+      for (uint32_t n = 0; n < length; n++) {
+        float x = n == offset ? 1.f - fraction : (n == offset + 1 ? fraction : 0.f);
+        float y = b0 * x + b1 * x1 - a1 * y1;
+        ir[n] = y;
+        x1 = x;
+        y1 = y;
+      }
+    }
+  }
+
+  bool success = createSet(set, count, length, directions, irs);
+  free(irs);
+  return success;
+}
+
+static uint32_t findDirection(float* direction) {
+  uint32_t nearest = 0;
+  float best = -2.f;
+  for (uint32_t i = 0; i < state.set.count; i++) {
+    float dot = vec3_dot(direction, state.set.directions + 3 * i);
+    if (dot > best) {
+      best = dot;
+      nearest = i;
+    }
+  }
+  return nearest;
+}
+
+// Convolution
+
+// Writes a block of interleaved stereo, using the input spectra already in the voice
+static void convolveBlock(Voice* voice, uint32_t direction, float* output) {
+  float re[HRTF_FFT_SIZE] = { 0.f };
+  float im[HRTF_FFT_SIZE] = { 0.f };
+  uint32_t partitions = state.set.partitions;
+
+  for (uint32_t p = 0; p < partitions; p++) {
+    float* filter = state.set.filters + ((size_t) direction * partitions + p) * 2 * HRTF_FFT_SIZE;
+    float* input = voice->spectra[(voice->cursor + HRTF_MAX_PARTITIONS - p) % HRTF_MAX_PARTITIONS][0];
+    dsp_complex_mac(re, im, input, input + HRTF_FFT_SIZE, filter, filter + HRTF_FFT_SIZE, HRTF_FFT_SIZE);
+  }
+
+  dsp_fft(&state.fft, re, im, true);
+
+  // Overlap-save, the first half wrapped around and is discarded
+  for (uint32_t i = 0; i < HRTF_BLOCK; i++) {
+    output[2 * i + 0] = re[HRTF_BLOCK + i];
+    output[2 * i + 1] = im[HRTF_BLOCK + i];
+  }
+}
+
+static void crossfade(float* output, const float* from, const float* to) {
+  for (uint32_t i = 0; i < HRTF_BLOCK; i++) {
+    float t = (i + 1) / (float) HRTF_BLOCK;
+    output[2 * i + 0] = from[2 * i + 0] + (to[2 * i + 0] - from[2 * i + 0]) * t;
+    output[2 * i + 1] = from[2 * i + 1] + (to[2 * i + 1] - from[2 * i + 1]) * t;
+  }
+}
+
+// Spatializer
+
+static bool hrtf_init(void) {
+  mat4_identity(state.listener);
+  mat4_identity(state.inverse);
+  state.convolveTime = 0.;
+  state.convolveCount = 0;
+  state.voiceCost = 0.;
+
+  if (!dsp_fft_init(&state.fft, HRTF_FFT_SIZE)) {
+    return false;
+  }
+
+  if (!createSphericalSet(&state.set, lovrAudioGetSampleRate())) {
+    dsp_fft_destroy(&state.fft);
+    return false;
+  }
+
+  return true;
+}
+
+static void hrtf_destroy(void) {
+  destroySet(&state.set);
+  dsp_fft_destroy(&state.fft);
+}
+
+static uint32_t hrtf_apply(Source* source, const float* input, float* output, uint32_t frames, uint32_t _frames) {
+  SourceParams* params = lovrSourceGetParams(source);
+  Voice* voice = &state.voices[lovrSourceGetIndex(source)];
+
+  float position[4];
+  vec3_init(position, params->position);
+  mat4_transform(state.inverse, position);
+  float distance = vec3_length(position);
+
+  float direction[4] = { 0.f, 0.f, -1.f, 0.f };
+  if (distance > .0001f) {
+    vec3_scale(vec3_init(direction, position), 1.f / distance);
+  }
+
+  bool spatialize = params->effects & (1 << EFFECT_SPATIALIZATION);
+  float target[2] = { 1.f, 1.f };
+  if (spatialize) {
+    target[0] = CLAMP(.5f - direction[0] * .5f, 0.f, 1.f);
+    target[1] = CLAMP(.5f + direction[0] * .5f, 0.f, 1.f);
+  }
+
+  float gain = 1.f;
+
+  float weight = params->dipoleWeight;
+  float power = params->dipolePower;
+  if (weight > 0.f && power > 0.f) {
+    float sourceDirection[4];
+    float sourceToListener[4];
+    quat_getDirection(params->orientation, sourceDirection);
+    mat4_transformDirection(state.listener, vec3_scale(vec3_init(sourceToListener, direction), -1.f));
+    float dot = vec3_dot(sourceToListener, sourceDirection);
+    gain *= powf(fabsf(1.f - weight + weight * dot), power);
+  }
+
+  if (params->effects & (1 << EFFECT_ATTENUATION)) {
+    gain /= MAX(distance, 1.f);
+  }
+
+  voice->score = params->priority * params->volume * gain;
+  voice->active = true;
+
+  bool convolve = spatialize && voice->selected;
+  bool timed = convolve || voice->convolving;
+  double start = timed ? os_get_time() : 0.;
+  uint32_t nearest = convolve ? findDirection(direction) : voice->direction;
+
+  // Switching to convolution starts from empty history, the crossfade covers the missing tail
+  if (convolve && !voice->convolving) {
+    memset(voice->spectra, 0, sizeof(voice->spectra));
+  }
+
+  float pan[2] = { target[0] * gain, target[1] * gain };
+  float panStep[2] = { (pan[0] - voice->pan[0]) / frames, (pan[1] - voice->pan[1]) / frames };
+  float gainStep = (gain - voice->gain) / frames;
+
+  for (uint32_t offset = 0; offset + HRTF_BLOCK <= frames; offset += HRTF_BLOCK) {
+    float* out = output + 2 * offset;
+    float panned[HRTF_BLOCK * 2];
+    float from[HRTF_BLOCK * 2];
+    float to[HRTF_BLOCK * 2];
+
+    float panStart[2] = { voice->pan[0] + panStep[0] * offset, voice->pan[1] + panStep[1] * offset };
+    convert_pan_mono(panned, input + offset, HRTF_BLOCK, panStart, panStep);
+
+    // The window slides even while panning, so convolution can pick up where it left off
+    memmove(voice->window, voice->window + HRTF_BLOCK, HRTF_BLOCK * sizeof(float));
+    memcpy(voice->window + HRTF_BLOCK, input + offset, HRTF_BLOCK * sizeof(float));
+
+    if (!convolve && !voice->convolving) {
+      memcpy(out, panned, sizeof(panned));
+      continue;
+    }
+
+    // Add the spectrum of the window to the delay line
+    voice->cursor = (voice->cursor + 1) % HRTF_MAX_PARTITIONS;
+    float* re = voice->spectra[voice->cursor][0];
+    float* im = voice->spectra[voice->cursor][1];
+    memcpy(re, voice->window, sizeof(voice->window));
+    memset(im, 0, HRTF_FFT_SIZE * sizeof(float));
+    dsp_fft(&state.fft, re, im, false);
+
+    if (voice->convolving) {
+      convolveBlock(voice, voice->direction, from);
+    }
+
+    if (convolve) {
+      if (!voice->convolving || nearest != voice->direction) {
+        convolveBlock(voice, nearest, to);
+      } else {
+        memcpy(to, from, sizeof(to));
+      }
+    }
+
+    for (uint32_t i = 0; i < HRTF_BLOCK; i++) {
+      float g = voice->gain + gainStep * (offset + i);
+      from[2 * i + 0] *= g, from[2 * i + 1] *= g;
+      to[2 * i + 0] *= g, to[2 * i + 1] *= g;
+    }
+
+    if (convolve && voice->convolving && nearest == voice->direction) {
+      memcpy(out, to, sizeof(to));
+    } else if (convolve && voice->convolving) {
+      crossfade(out, from, to);
+    } else if (convolve) {
+      crossfade(out, panned, to);
+    } else {
+      crossfade(out, from, panned);
+    }
+
+    voice->direction = nearest;
+    voice->convolving = convolve;
+  }
+
+  voice->pan[0] = pan[0];
+  voice->pan[1] = pan[1];
+  voice->gain = gain;
+
+  if (timed) {
+    state.convolveTime += os_get_time() - start;
+    state.convolveCount++;
+  }
+
+  return frames;
+}
+
+// Ranks the voices mixed this period, the most audible ones get convolved next period.  The cost of
+// a voice is smoothed over periods, so one slow period doesn't make the limit jump around.
+static uint32_t hrtf_tail(float* scratch, float* output, uint32_t frames) {
+  Voice* ranking[MAX_SOURCES];
+  uint32_t count = 0;
+
+  if (state.convolveCount > 0) {
+    double cost = state.convolveTime / state.convolveCount;
+    state.voiceCost = state.voiceCost > 0. ? state.voiceCost + (cost - state.voiceCost) * .1 : cost;
+    state.convolveTime = 0.;
+    state.convolveCount = 0;
+  }
+
+  double budget = HRTF_BUDGET * frames / lovrAudioGetSampleRate();
+  uint32_t limit = state.voiceCost > 0. ? (uint32_t) MIN(budget / state.voiceCost, MAX_SOURCES) : MAX_SOURCES;
+  limit = MAX(limit, 1);
+
+  for (uint32_t i = 0; i < MAX_SOURCES; i++) {
+    if (state.voices[i].active) {
+      Voice* voice = &state.voices[i];
+      uint32_t j = count++;
+      while (j > 0 && ranking[j - 1]->score < voice->score) {
+        ranking[j] = ranking[j - 1];
+        j--;
+      }
+      ranking[j] = voice;
+      voice->active = false;
+    }
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    ranking[i]->selected = i < limit;
+  }
+
+  return 0;
+}
+
+static void hrtf_setListenerPose(float position[4], float orientation[4]) {
+  mat4_identity(state.listener);
+  mat4_translate(state.listener, position[0], position[1], position[2]);
+  mat4_rotateQuat(state.listener, orientation);
+  mat4_invert(mat4_init(state.inverse, state.listener));
+}
+
+static bool hrtf_setGeometry(float* vertices, uint32_t* indices, uint32_t vertexCount, uint32_t indexCount, AudioMaterial material) {
+  return false;
+}
+
+static bool hrtf_setHRTF(const void* data, size_t size) {
+  const uint8_t* bytes = data;
+  uint32_t header[5];
+
+  if (size < 4 + 4 * sizeof(uint32_t) || memcmp(bytes, "HRIR", 4)) {
+    return false;
+  }
+
+  memcpy(header, bytes, sizeof(header));
+  uint32_t version = header[1];
+  uint32_t rate = header[2];
+  uint32_t length = header[3];
+  uint32_t count = header[4];
+  uint64_t stride = 2 * sizeof(float) + 2 * (uint64_t) length * sizeof(float);
+
+  if (version != 1 || rate == 0 || length == 0 || count == 0 || (size - sizeof(header)) / stride < count) {
+    return false;
+  }
+
+  // Resample to the device rate, scaling so the filter keeps its gain
+  float ratio = (float) rate / lovrAudioGetSampleRate();
+  uint32_t resampled = MIN((uint32_t) ceilf(length / ratio), HRTF_MAX_PARTITIONS * HRTF_BLOCK);
+  float* directions = malloc(count * 3 * sizeof(float));
+  float* irs = malloc((size_t) count * 2 * resampled * sizeof(float));
+  float* ir = malloc(length * sizeof(float));
+
+  if (!directions || !irs || !ir) {
+    free(directions);
+    free(irs);
+    free(ir);
+    return false;
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    const uint8_t* entry = bytes + sizeof(header) + i * stride;
+    float angles[2];
+    memcpy(angles, entry, sizeof(angles));
+    getDirection(angles[0], angles[1], directions + 3 * i);
+
+    for (uint32_t ear = 0; ear < 2; ear++) {
+      memcpy(ir, entry + sizeof(angles) + ear * length * sizeof(float), length * sizeof(float));
+      float* dst = irs + ((size_t) i * 2 + ear) * resampled;
+      for (uint32_t n = 0; n < resampled; n++) {
+        float t = n * ratio;
+        uint32_t index = (uint32_t) t;
+        float a = index < length ? ir[index] : 0.f;
+        float b = index + 1 < length ? ir[index + 1] : 0.f;
+        dst[n] = (a + (b - a) * (t - index)) * MIN(ratio, 1.f);
+      }
+    }
+  }
+
+  HRIRSet set;
+  bool success = createSet(&set, count, resampled, directions, irs);
+  free(directions);
+  free(irs);
+  free(ir);
+
+  if (!success) {
+    return false;
+  }
+
+  destroySet(&state.set);
+  state.set = set;
+
+  for (uint32_t i = 0; i < MAX_SOURCES; i++) {
+    state.voices[i].convolving = false;
+    state.voices[i].direction = 0;
+  }
+
+  return true;
+}
+
+static void hrtf_sourceCreate(Source* source) {
+  Voice* voice = &state.voices[lovrSourceGetIndex(source)];
+  memset(voice->window, 0, sizeof(voice->window));
+  voice->cursor = 0;
+  voice->direction = 0;
+  voice->gain = 0.f;
+  voice->pan[0] = voice->pan[1] = 0.f;
+  voice->active = false;
+  voice->selected = true;
+  voice->convolving = false;
+}
+
+static void hrtf_sourceDestroy(Source* source) {
+  //
+}
+
+Spatializer hrtfSpatializer = {
+  .init = hrtf_init,
+  .destroy = hrtf_destroy,
+  .apply = hrtf_apply,
+  .tail = hrtf_tail,
+  .setListenerPose = hrtf_setListenerPose,
+  .setGeometry = hrtf_setGeometry,
+  .setHRTF = hrtf_setHRTF,
+  .sourceCreate = hrtf_sourceCreate,
+  .sourceDestroy = hrtf_sourceDestroy,
+  .name = "hrtf"
+};
@@ -192,7 +192,7 @@ static uint32_t oculus_apply(Source* source, const float* input, float* output,
       state.sources[idx].occupied = true;
       ovrAudio_ResetAudioSource(state.context, idx);
       ovrAudio_SetAudioSourceAttenuationMode(state.context, idx,
-        lovrSourceIsEffectEnabled(source, EFFECT_ATTENUATION) ? ovrAudioSourceAttenuationMode_InverseSquare : ovrAudioSourceAttenuationMode_None, 1.0f);
+        (lovrSourceGetParams(source)->effects & (1 << EFFECT_ATTENUATION)) ? ovrAudioSourceAttenuationMode_InverseSquare : ovrAudioSourceAttenuationMode_None, 1.0f);
     }
   }
 
@@ -201,8 +201,7 @@ static uint32_t oculus_apply(Source* source, const float* input, float* output,
     uint32_t outStatus = 0;
     state.sources[idx].usedSourceThisPlayback = true;
 
-    float position[4], orientation[4];
-    lovrSourceGetPose(source, position, orientation);
+    float* position = lovrSourceGetParams(source)->position;
 
     ovrAudio_SetAudioSourcePos(state.context, idx, position[0], position[1], position[2]);
 
@@ -202,8 +202,9 @@ uint32_t phonon_apply(Source* source, const float* input, float* output, uint32_
   IPLVector3 up = { y[0], y[1], y[2] };
 
   // TODO maybe this should use a matrix
-  float position[4], orientation[4];
-  lovrSourceGetPose(source, position, orientation);
+  SourceParams* params = lovrSourceGetParams(source);
+  float* position = params->position;
+  float* orientation = params->orientation;
   vec3_set(x, 1.f, 0.f, 0.f);
   vec3_set(y, 0.f, 1.f, 0.f);
   vec3_set(z, 0.f, 0.f, -1.f);
@@ -211,8 +212,8 @@ uint32_t phonon_apply(Source* source, const float* input, float* output, uint32_
   quat_rotate(orientation, y);
   quat_rotate(orientation, z);
 
-  float weight, power;
-  lovrSourceGetDirectivity(source, &weight, &power);
+  float weight = params->dipoleWeight;
+  float power = params->dipolePower;
 
   IPLSource iplSource = {
     .position = (IPLVector3) { position[0], position[1], position[2] },
@@ -231,10 +232,10 @@ uint32_t phonon_apply(Source* source, const float* input, float* output, uint32_
   float radius = 0.f;
   IPLint32 rays = 0;
 
-  if (state.mesh && lovrSourceIsEffectEnabled(source, EFFECT_OCCLUSION)) {
-    bool transmission = lovrSourceIsEffectEnabled(source, EFFECT_TRANSMISSION);
+  if (state.mesh && (params->effects & (1 << EFFECT_OCCLUSION))) {
+    bool transmission = (params->effects & (1 << EFFECT_TRANSMISSION));
     occlusion = transmission ? IPL_DIRECTOCCLUSION_TRANSMISSIONBYFREQUENCY : IPL_DIRECTOCCLUSION_NOTRANSMISSION;
-    radius = lovrSourceGetRadius(source);
+    radius = params->radius;
 
     if (radius > 0.f) {
       volumetric = IPL_DIRECTOCCLUSION_VOLUMETRIC;
@@ -245,8 +246,8 @@ uint32_t phonon_apply(Source* source, const float* input, float* output, uint32_
   IPLDirectSoundPath path = phonon_iplGetDirectSoundPath(state.environment, listener, forward, up, iplSource, radius, rays, occlusion, volumetric);
 
   IPLDirectSoundEffectOptions options = {
-    .applyDistanceAttenuation = lovrSourceIsEffectEnabled(source, EFFECT_ATTENUATION) ? IPL_TRUE : IPL_FALSE,
-    .applyAirAbsorption = lovrSourceIsEffectEnabled(source, EFFECT_ABSORPTION) ? IPL_TRUE : IPL_FALSE,
+    .applyDistanceAttenuation = (params->effects & (1 << EFFECT_ATTENUATION)) ? IPL_TRUE : IPL_FALSE,
+    .applyAirAbsorption = (params->effects & (1 << EFFECT_ABSORPTION)) ? IPL_TRUE : IPL_FALSE,
     .applyDirectivity = weight > 0.f && power > 0.f ? IPL_TRUE : IPL_FALSE,
     .directOcclusionMode = occlusion
   };
@@ -257,7 +258,7 @@ uint32_t phonon_apply(Source* source, const float* input, float* output, uint32_
   IPLHrtfInterpolation interpolation = IPL_HRTFINTERPOLATION_NEAREST;
   phonon_iplApplyBinauralEffect(state.binauralEffect[index], state.binauralRenderer, tmp, path.direction, interpolation, blend, out);
 
-  if (state.mesh && lovrSourceIsEffectEnabled(source, EFFECT_REVERB)) {
+  if (state.mesh && (params->effects & (1 << EFFECT_REVERB))) {
     phonon_iplSetDryAudioForConvolutionEffect(state.convolutionEffect[index], iplSource, in);
   }
 
@@ -1,4 +1,5 @@
 #include "spatializer.h"
+#include "core/convert.h"
 #include "core/maf.h"
 #include "util.h"
 #include <math.h>
@@ -18,14 +19,15 @@ static void simple_destroy(void) {
 }
 
 static uint32_t simple_apply(Source* source, const float* input, float* output, uint32_t frames, uint32_t _frames) {
-  float sourcePos[4], sourceOrientation[4];
-  lovrSourceGetPose(source, sourcePos, sourceOrientation);
+  SourceParams* params = lovrSourceGetParams(source);
+  float* sourcePos = params->position;
+  float* sourceOrientation = params->orientation;
 
   float listenerPos[4] = { 0.f };
   mat4_transform(state.listener, listenerPos);
 
   float target[2] = { 1.f, 1.f };
-  if (lovrSourceIsEffectEnabled(source, EFFECT_SPATIALIZATION)) {
+  if (params->effects & (1 << EFFECT_SPATIALIZATION)) {
     float leftEar[4] = { -0.1f, 0.0f, 0.0f, 1.0f };
     float rightEar[4] = { 0.1f, 0.0f, 0.0f, 1.0f };
     mat4_transform(state.listener, leftEar);
@@ -36,8 +38,8 @@ static uint32_t simple_apply(Source* source, const float* input, float* output,
     target[1] = .5f + (ldistance - rdistance) * 2.5f;
   }
 
-  float weight, power;
-  lovrSourceGetDirectivity(source, &weight, &power);
+  float weight = params->dipoleWeight;
+  float power = params->dipolePower;
   if (weight > 0.f && power > 0.f) {
     float sourceDirection[4];
     float sourceToListener[4];
@@ -49,7 +51,7 @@ static uint32_t simple_apply(Source* source, const float* input, float* output,
     target[1] *= factor;
   }
 
-  if (lovrSourceIsEffectEnabled(source, EFFECT_ATTENUATION)) {
+  if (params->effects & (1 << EFFECT_ATTENUATION)) {
     float distance = vec3_distance(sourcePos, listenerPos);
     float attenuation = 1.f / MAX(distance, 1.f);
     target[0] *= attenuation;
@@ -63,21 +65,17 @@ static uint32_t simple_apply(Source* source, const float* input, float* output,
   float lerpFrames = lovrAudioGetSampleRate() * lerpDuration;
   float lerpRate = 1.f / lerpFrames;
 
+  // Gain moves towards the target by at most lerpRate per frame, spread evenly over the buffer
+  float step[2];
   for (uint32_t c = 0; c < 2; c++) {
-    float sign = target[c] > gain[c] ? 1.f : -1.f;
-
-    uint32_t lerpCount = fabsf(target[c] - gain[c]) / lerpRate;
-    lerpCount = MIN(lerpCount, frames);
+    float delta = CLAMP(target[c] - gain[c], -lerpRate * frames, lerpRate * frames);
+    step[c] = delta / frames;
+  }
 
-    for (uint32_t i = 0; i < lerpCount; i++) {
-      output[i * 2 + c] = input[i] * gain[c];
-      gain[c] += lerpRate * sign;
-    }
+  convert_pan_mono(output, input, frames, gain, step);
 
-    for (uint32_t i = lerpCount; i < frames; i++) {
-      output[i * 2 + c] = input[i] * gain[c];
-    }
-  }
+  gain[0] += step[0] * frames;
+  gain[1] += step[1] * frames;
 
   return frames;
 }
@@ -14,6 +14,10 @@ Blob* lovrBlobCreate(void* data, size_t size, const char* name) {
 
 void lovrBlobDestroy(void* ref) {
   Blob* blob = ref;
-  free(blob->data);
+  if (blob->unmap) {
+    blob->unmap(blob->data, blob->size);
+  } else {
+    free(blob->data);
+  }
   free(blob);
 }
@@ -1,3 +1,4 @@
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -8,6 +9,7 @@ typedef struct Blob {
   void* data;
   size_t size;
   const char* name;
+  bool (*unmap)(void* data, size_t size);
 } Blob;
 
 Blob* lovrBlobCreate(void* data, size_t size, const char* name);
@@ -1,7 +1,13 @@
 #include "data/image.h"
 #include "data/blob.h"
+#include "core/bc.h"
+#include "core/convert.h"
+#include "core/fs.h"
+#include "core/job.h"
+#include "core/zstd.h"
 #include "util.h"
 #include "lib/stb/stb_image.h"
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -184,108 +190,486 @@ void* lovrImageGetLayerData(Image* image, uint32_t level, uint32_t layer) {
   return (uint8_t*) image->mipmaps[level].data + layer * image->mipmaps[level].stride;
 }
 
+// DDS, KTX, and ASTC Images loaded from a mapped file point into the mapping, so once a level has
+// been copied somewhere else its pages can go back to the OS, and touching it again reads it back
+// from the file.  Images that were decoded or inflated into memory can't be read again, so this
+// leaves them alone.
+void lovrImageReleaseLevel(Image* image, uint32_t level) {
+  if (level >= image->levels || !image->blob->unmap) return;
+  Mipmap* mipmap = &image->mipmaps[level];
+  size_t size = mipmap->stride * (image->layers - 1) + mipmap->size;
+  fs_release(mipmap->data, size);
+}
+
+// Pixel access decodes and encodes whole rows at a time with the vectorized conversion kernels,
+// instead of switching on the format for every pixel.  Rows are always expanded to RGBA floats,
+// with missing channels filled in as (0, 0, 0, 1).
+
+enum { TYPE_UN8, TYPE_UN16, TYPE_F16, TYPE_F32 };
+
+static bool getPixelLayout(TextureFormat format, uint32_t* channels, uint32_t* type) {
+  switch (format) {
+    case FORMAT_R8: *channels = 1, *type = TYPE_UN8; return true;
+    case FORMAT_RG8: *channels = 2, *type = TYPE_UN8; return true;
+    case FORMAT_RGBA8: *channels = 4, *type = TYPE_UN8; return true;
+    case FORMAT_R16: *channels = 1, *type = TYPE_UN16; return true;
+    case FORMAT_RG16: *channels = 2, *type = TYPE_UN16; return true;
+    case FORMAT_RGBA16: *channels = 4, *type = TYPE_UN16; return true;
+    case FORMAT_R16F: *channels = 1, *type = TYPE_F16; return true;
+    case FORMAT_RG16F: *channels = 2, *type = TYPE_F16; return true;
+    case FORMAT_RGBA16F: *channels = 4, *type = TYPE_F16; return true;
+    case FORMAT_R32F: *channels = 1, *type = TYPE_F32; return true;
+    case FORMAT_RG32F: *channels = 2, *type = TYPE_F32; return true;
+    case FORMAT_RGBA32F: *channels = 4, *type = TYPE_F32; return true;
+    default: return false;
+  }
+}
+
+static void decodeRow(TextureFormat format, const void* src, float* dst, uint32_t count) {
+  uint32_t channels, type;
+  getPixelLayout(format, &channels, &type);
+
+  // Narrow formats get decoded into the end of the row and then spread out front to back, which
+  // never overwrites a component before it's read
+  size_t n = (size_t) count * channels;
+  float* p = dst + (size_t) count * (4 - channels);
+
+  switch (type) {
+    case TYPE_UN8: convert_un8_to_f32(p, src, n); break;
+    case TYPE_UN16: convert_un16_to_f32(p, src, n); break;
+    case TYPE_F16: convert_f16_to_f32(p, src, n); break;
+    case TYPE_F32: memcpy(p, src, n * sizeof(float)); break;
+    default: lovrUnreachable();
+  }
+
+  if (channels < 4) {
+    for (uint32_t i = 0; i < count; i++, p += channels, dst += 4) {
+      float r = p[0];
+      float g = channels > 1 ? p[1] : 0.f;
+      dst[0] = r;
+      dst[1] = g;
+      dst[2] = 0.f;
+      dst[3] = 1.f;
+    }
+  }
+}
+
+// Note: narrow formats are packed in place, so this clobbers the source row
+static void encodeRow(TextureFormat format, float* src, void* dst, uint32_t count) {
+  uint32_t channels, type;
+  getPixelLayout(format, &channels, &type);
+
+  if (channels < 4) {
+    for (uint32_t i = 0; i < count; i++) {
+      for (uint32_t c = 0; c < channels; c++) {
+        src[i * channels + c] = src[i * 4 + c];
+      }
+    }
+  }
+
+  size_t n = (size_t) count * channels;
+
+  switch (type) {
+    case TYPE_UN8: convert_f32_to_un8(dst, src, n); break;
+    case TYPE_UN16: convert_f32_to_un16(dst, src, n); break;
+    case TYPE_F16: convert_f32_to_f16(dst, src, n); break;
+    case TYPE_F32: memcpy(dst, src, n * sizeof(float)); break;
+    default: lovrUnreachable();
+  }
+}
+
 void lovrImageGetPixel(Image* image, uint32_t x, uint32_t y, float pixel[4]) {
+  uint32_t channels, type;
   lovrCheck(!lovrImageIsCompressed(image), "Unable to access individual pixels of a compressed image");
   lovrAssert(x < image->width && y < image->height, "Pixel coordinates must be within Image bounds");
+  lovrAssert(getPixelLayout(image->format, &channels, &type), "Unsupported format for Image:getPixel");
   size_t offset = measure(y * image->width + x, 1, image->format);
-  uint8_t* u8 = (uint8_t*) image->mipmaps[0].data + offset;
-  uint16_t* u16 = (uint16_t*) u8;
-  float* f32 = (float*) u8;
-  switch (image->format) {
-    case FORMAT_R8:
-      pixel[0] = u8[0] / 255.f;
-      return;
-    case FORMAT_RG8:
-      pixel[0] = u8[0] / 255.f;
-      pixel[1] = u8[1] / 255.f;
-      return;
-    case FORMAT_RGBA8:
-      pixel[0] = u8[0] / 255.f;
-      pixel[1] = u8[1] / 255.f;
-      pixel[2] = u8[2] / 255.f;
-      pixel[3] = u8[3] / 255.f;
-      return;
-    case FORMAT_R16:
-      pixel[0] = u16[0] / 65535.f;
-      return;
-    case FORMAT_RG16:
-      pixel[0] = u16[0] / 65535.f;
-      pixel[1] = u16[1] / 65535.f;
-      return;
-    case FORMAT_RGBA16:
-      pixel[0] = u16[0] / 65535.f;
-      pixel[1] = u16[1] / 65535.f;
-      pixel[2] = u16[2] / 65535.f;
-      pixel[3] = u16[3] / 65535.f;
-      return;
-    case FORMAT_R32F:
-      pixel[0] = f32[0];
-      return;
-    case FORMAT_RG32F:
-      pixel[0] = f32[0];
-      pixel[1] = f32[1];
-      return;
-    case FORMAT_RGBA32F:
-      pixel[0] = f32[0];
-      pixel[1] = f32[1];
-      pixel[2] = f32[2];
-      pixel[3] = f32[3];
-      return;
-    default: lovrThrow("Unsupported format for Image:getPixel");
-  }
+  decodeRow(image->format, (uint8_t*) image->mipmaps[0].data + offset, pixel, 1);
 }
 
 void lovrImageSetPixel(Image* image, uint32_t x, uint32_t y, float pixel[4]) {
+  uint32_t channels, type;
   lovrCheck(!lovrImageIsCompressed(image), "Unable to access individual pixels of a compressed image");
   lovrAssert(x < image->width && y < image->height, "Pixel coordinates must be within Image bounds");
+  lovrAssert(getPixelLayout(image->format, &channels, &type), "Unsupported format for Image:setPixel");
   size_t offset = measure(y * image->width + x, 1, image->format);
-  uint8_t* u8 = (uint8_t*) image->mipmaps[0].data + offset;
-  uint16_t* u16 = (uint16_t*) u8;
-  float* f32 = (float*) u8;
-  switch (image->format) {
-    case FORMAT_R8:
-      u8[0] = (uint8_t) (pixel[0] * 255.f + .5f);
-      break;
-    case FORMAT_RG8:
-      u8[0] = (uint8_t) (pixel[0] * 255.f + .5f);
-      u8[1] = (uint8_t) (pixel[1] * 255.f + .5f);
-      break;
-    case FORMAT_RGBA8:
-      u8[0] = (uint8_t) (pixel[0] * 255.f + .5f);
-      u8[1] = (uint8_t) (pixel[1] * 255.f + .5f);
-      u8[2] = (uint8_t) (pixel[2] * 255.f + .5f);
-      u8[3] = (uint8_t) (pixel[3] * 255.f + .5f);
-      break;
-    case FORMAT_R16:
-      u16[0] = (uint16_t) (pixel[0] * 65535.f + .5f);
-      break;
-    case FORMAT_RG16:
-      u16[0] = (uint16_t) (pixel[0] * 65535.f + .5f);
-      u16[1] = (uint16_t) (pixel[1] * 65535.f + .5f);
-      break;
-    case FORMAT_RGBA16:
-      u16[0] = (uint16_t) (pixel[0] * 65535.f + .5f);
-      u16[1] = (uint16_t) (pixel[1] * 65535.f + .5f);
-      u16[2] = (uint16_t) (pixel[2] * 65535.f + .5f);
-      u16[3] = (uint16_t) (pixel[3] * 65535.f + .5f);
-      break;
-    case FORMAT_R32F:
-      f32[0] = pixel[0];
-      break;
-    case FORMAT_RG32F:
-      f32[0] = pixel[0];
-      f32[1] = pixel[1];
-      break;
-    case FORMAT_RGBA32F:
-      f32[0] = pixel[0];
-      f32[1] = pixel[1];
-      f32[2] = pixel[2];
-      f32[3] = pixel[3];
-      break;
-    default: lovrThrow("Unsupported format for Image:setPixel");
+  float copy[4] = { pixel[0], pixel[1], pixel[2], pixel[3] };
+  encodeRow(image->format, copy, (uint8_t*) image->mipmaps[0].data + offset, 1);
+}
+
+static void checkRegion(Image* image, uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+  lovrCheck(x < image->width && y < image->height, "Image region offset must be within Image bounds");
+  lovrCheck(w > 0 && h > 0, "Image region dimensions must be positive");
+  lovrCheck(w <= image->width - x, "Image region extends past the image width");
+  lovrCheck(h <= image->height - y, "Image region extends past the image height");
+}
+
+// Rows are converted in spans of ROW_SPAN pixels on the stack, since the callback can throw
+#define ROW_SPAN 256
+
+void lovrImageMapPixel(Image* image, uint32_t x, uint32_t y, uint32_t w, uint32_t h, MapPixelCallback* callback, void* userdata) {
+  uint32_t channels, type;
+  lovrCheck(!lovrImageIsCompressed(image), "Unable to access individual pixels of a compressed image");
+  lovrAssert(getPixelLayout(image->format, &channels, &type), "Unsupported format for Image:mapPixel");
+  checkRegion(image, x, y, w, h);
+
+  float row[ROW_SPAN * 4];
+  size_t pixelSize = measure(1, 1, image->format);
+  size_t stride = image->width * pixelSize;
+  uint8_t* data = (uint8_t*) image->mipmaps[0].data + y * stride + x * pixelSize;
+
+  for (uint32_t i = 0; i < h; i++, data += stride) {
+    for (uint32_t start = 0; start < w; start += ROW_SPAN) {
+      uint32_t count = MIN(w - start, ROW_SPAN);
+      uint8_t* span = data + start * pixelSize;
+      decodeRow(image->format, span, row, count);
+      for (uint32_t j = 0; j < count; j++) {
+        callback(userdata, x + start + j, y + i, row + 4 * j);
+      }
+      encodeRow(image->format, row, span, count);
+    }
   }
 }
 
+static Image* allocate(uint32_t width, uint32_t height, uint32_t layers, uint32_t levels, TextureFormat format, uint32_t flags) {
+  size_t total = 0;
+  for (uint32_t i = 0; i < levels; i++) {
+    total += measure(MAX(width >> i, 1), MAX(height >> i, 1), format) * layers;
+  }
+
+  char* data = malloc(total);
+  Image* image = calloc(1, offsetof(Image, mipmaps) + levels * sizeof(Mipmap));
+  lovrAssert(image && data, "Out of memory");
+  image->ref = 1;
+  image->flags = flags;
+  image->width = width;
+  image->height = height;
+  image->format = format;
+  image->layers = layers;
+  image->levels = levels;
+  image->blob = lovrBlobCreate(data, total, "Image");
+
+  for (uint32_t i = 0; i < levels; i++) {
+    size_t size = measure(MAX(width >> i, 1), MAX(height >> i, 1), format);
+    image->mipmaps[i] = (Mipmap) { data, size, size };
+    data += size * layers;
+  }
+
+  return image;
+}
+
+Image* lovrImageConvert(Image* image, TextureFormat format) {
+  uint32_t channels, type;
+  lovrCheck(!lovrImageIsCompressed(image), "Compressed Images cannot be converted");
+  lovrAssert(getPixelLayout(image->format, &channels, &type), "Unsupported source format for Image:convert");
+  lovrAssert(getPixelLayout(format, &channels, &type), "Unsupported destination format for Image:convert");
+
+  Image* result = allocate(image->width, image->height, image->layers, image->levels, format, image->flags);
+  float* row = malloc(image->width * 4 * sizeof(float));
+  lovrAssert(row, "Out of memory");
+
+  for (uint32_t level = 0; level < image->levels; level++) {
+    uint32_t width = lovrImageGetWidth(image, level);
+    uint32_t height = lovrImageGetHeight(image, level);
+    size_t srcStride = measure(width, 1, image->format);
+    size_t dstStride = measure(width, 1, format);
+    for (uint32_t layer = 0; layer < image->layers; layer++) {
+      uint8_t* src = lovrImageGetLayerData(image, level, layer);
+      uint8_t* dst = lovrImageGetLayerData(result, level, layer);
+      for (uint32_t y = 0; y < height; y++, src += srcStride, dst += dstStride) {
+        decodeRow(image->format, src, row, width);
+        encodeRow(format, row, dst, width);
+      }
+    }
+  }
+
+  free(row);
+  return result;
+}
+
+Blob* lovrImageGetPixels(Image* image, uint32_t x, uint32_t y, uint32_t w, uint32_t h, TextureFormat format) {
+  uint32_t channels, type;
+  lovrCheck(!lovrImageIsCompressed(image), "Unable to access individual pixels of a compressed image");
+  checkRegion(image, x, y, w, h);
+
+  if (format != image->format) {
+    lovrAssert(getPixelLayout(image->format, &channels, &type), "Unsupported source format for Image:getPixels");
+    lovrAssert(getPixelLayout(format, &channels, &type), "Unsupported destination format for Image:getPixels");
+  }
+
+  size_t srcPixelSize = measure(1, 1, image->format);
+  size_t srcStride = image->width * srcPixelSize;
+  size_t dstStride = measure(w, 1, format);
+  uint8_t* src = (uint8_t*) image->mipmaps[0].data + y * srcStride + x * srcPixelSize;
+  uint8_t* data = malloc(dstStride * h);
+  lovrAssert(data, "Out of memory");
+
+  if (format == image->format) {
+    for (uint32_t i = 0; i < h; i++, src += srcStride) {
+      memcpy(data + i * dstStride, src, dstStride);
+    }
+  } else {
+    float row[ROW_SPAN * 4];
+    size_t dstPixelSize = measure(1, 1, format);
+    for (uint32_t i = 0; i < h; i++, src += srcStride) {
+      for (uint32_t start = 0; start < w; start += ROW_SPAN) {
+        uint32_t count = MIN(w - start, ROW_SPAN);
+        decodeRow(image->format, src + start * srcPixelSize, row, count);
+        encodeRow(format, row, data + i * dstStride + start * dstPixelSize, count);
+      }
+    }
+  }
+
+  return lovrBlobCreate(data, dstStride * h, "Image Pixels");
+}
+
+static float gammaToLinear(float x) {
+  return x <= .04045f ? x / 12.92f : powf((x + .055f) / 1.055f, 2.4f);
+}
+
+static float linearToGamma(float x) {
+  return x <= .0031308f ? x * 12.92f : 1.055f * powf(x, 1.f / 2.4f) - .055f;
+}
+
+// Applies a per-component color function to the color channels (not alpha) of every pixel
+static void transformColors(Image* image, float (*fn)(float), const char* debug) {
+  uint32_t channels, type;
+  lovrCheck(!lovrImageIsCompressed(image), "Unable to access individual pixels of a compressed image");
+  lovrAssert(getPixelLayout(image->format, &channels, &type), "Unsupported format for Image:%s", debug);
+  uint32_t colors = MIN(channels, 3);
+
+  // 8 bit images have few enough values to use a lookup table directly on the data
+  if (type == TYPE_UN8) {
+    uint8_t lookup[256];
+    for (uint32_t i = 0; i < 256; i++) {
+      float x = fn(i / 255.f);
+      lookup[i] = (uint8_t) (CLAMP(x, 0.f, 1.f) * 255.f + .5f);
+    }
+
+    for (uint32_t level = 0; level < image->levels; level++) {
+      size_t count = measure(lovrImageGetWidth(image, level), lovrImageGetHeight(image, level), FORMAT_R8);
+      for (uint32_t layer = 0; layer < image->layers; layer++) {
+        uint8_t* p = lovrImageGetLayerData(image, level, layer);
+        for (size_t i = 0; i < count; i++, p += channels) {
+          for (uint32_t c = 0; c < colors; c++) {
+            p[c] = lookup[p[c]];
+          }
+        }
+      }
+    }
+
+    return;
+  }
+
+  float* row = malloc(image->width * 4 * sizeof(float));
+  lovrAssert(row, "Out of memory");
+
+  for (uint32_t level = 0; level < image->levels; level++) {
+    uint32_t width = lovrImageGetWidth(image, level);
+    uint32_t height = lovrImageGetHeight(image, level);
+    size_t stride = measure(width, 1, image->format);
+    for (uint32_t layer = 0; layer < image->layers; layer++) {
+      uint8_t* data = lovrImageGetLayerData(image, level, layer);
+      for (uint32_t y = 0; y < height; y++, data += stride) {
+        decodeRow(image->format, data, row, width);
+        for (uint32_t x = 0; x < width; x++) {
+          for (uint32_t c = 0; c < colors; c++) {
+            row[4 * x + c] = fn(row[4 * x + c]);
+          }
+        }
+        encodeRow(image->format, row, data, width);
+      }
+    }
+  }
+
+  free(row);
+}
+
+void lovrImageGammaToLinear(Image* image) {
+  transformColors(image, gammaToLinear, "gammaToLinear");
+  image->flags &= ~IMAGE_SRGB;
+}
+
+void lovrImageLinearToGamma(Image* image) {
+  transformColors(image, linearToGamma, "linearToGamma");
+  image->flags |= IMAGE_SRGB;
+}
+
+void lovrImagePremultiply(Image* image) {
+  uint32_t channels, type;
+  lovrCheck(!lovrImageIsCompressed(image), "Unable to access individual pixels of a compressed image");
+  lovrAssert(getPixelLayout(image->format, &channels, &type), "Unsupported format for Image:premultiply");
+  lovrCheck(!lovrImageIsPremultiplied(image), "Image is already premultiplied");
+  image->flags |= IMAGE_PREMULTIPLIED;
+
+  if (channels < 4) {
+    return;
+  }
+
+  float* row = malloc(image->width * 4 * sizeof(float));
+  lovrAssert(row, "Out of memory");
+
+  for (uint32_t level = 0; level < image->levels; level++) {
+    uint32_t width = lovrImageGetWidth(image, level);
+    uint32_t height = lovrImageGetHeight(image, level);
+    size_t stride = measure(width, 1, image->format);
+    for (uint32_t layer = 0; layer < image->layers; layer++) {
+      uint8_t* data = lovrImageGetLayerData(image, level, layer);
+      for (uint32_t y = 0; y < height; y++, data += stride) {
+        decodeRow(image->format, data, row, width);
+        for (uint32_t x = 0; x < width; x++) {
+          float* p = row + 4 * x;
+          p[0] *= p[3];
+          p[1] *= p[3];
+          p[2] *= p[3];
+        }
+        encodeRow(image->format, row, data, width);
+      }
+    }
+  }
+
+  free(row);
+}
+
+// Each level is a 2x2 box filter of the previous one.  Color channels of sRGB images are averaged
+// in linear space, otherwise mipmaps of sRGB images get darker as they get smaller.
+Image* lovrImageGenerateMipmaps(Image* image) {
+  uint32_t channels, type;
+  lovrCheck(!lovrImageIsCompressed(image), "Unable to generate mipmaps for a compressed image");
+  lovrAssert(getPixelLayout(image->format, &channels, &type), "Unsupported format for Image:generateMipmaps");
+
+  uint32_t levels = (uint32_t) log2(MAX(image->width, image->height)) + 1;
+  Image* result = allocate(image->width, image->height, image->layers, levels, image->format, image->flags);
+  bool srgb = image->flags & IMAGE_SRGB;
+  uint32_t colors = MIN(channels, 3);
+
+  for (uint32_t layer = 0; layer < image->layers; layer++) {
+    memcpy(lovrImageGetLayerData(result, 0, layer), lovrImageGetLayerData(image, 0, layer), result->mipmaps[0].size);
+  }
+
+  float* a = malloc(image->width * 4 * sizeof(float) * 2);
+  lovrAssert(a, "Out of memory");
+  float* b = a + image->width * 4;
+
+  for (uint32_t level = 1; level < levels; level++) {
+    uint32_t srcWidth = lovrImageGetWidth(result, level - 1);
+    uint32_t srcHeight = lovrImageGetHeight(result, level - 1);
+    uint32_t width = lovrImageGetWidth(result, level);
+    uint32_t height = lovrImageGetHeight(result, level);
+    size_t srcStride = measure(srcWidth, 1, image->format);
+    size_t dstStride = measure(width, 1, image->format);
+
+    for (uint32_t layer = 0; layer < image->layers; layer++) {
+      uint8_t* src = lovrImageGetLayerData(result, level - 1, layer);
+      uint8_t* dst = lovrImageGetLayerData(result, level, layer);
+      for (uint32_t y = 0; y < height; y++, dst += dstStride) {
+        decodeRow(image->format, src + (2 * y) * srcStride, a, srcWidth);
+        decodeRow(image->format, src + MIN(2 * y + 1, srcHeight - 1) * srcStride, b, srcWidth);
+
+        if (srgb) {
+          for (uint32_t x = 0; x < srcWidth; x++) {
+            for (uint32_t c = 0; c < colors; c++) {
+              a[4 * x + c] = gammaToLinear(a[4 * x + c]);
+              b[4 * x + c] = gammaToLinear(b[4 * x + c]);
+            }
+          }
+        }
+
+        // The output row is written into the front of the first input row, which is safe because
+        // output pixel x only reads input pixels 2x and 2x + 1
+        for (uint32_t x = 0; x < width; x++) {
+          uint32_t x0 = 2 * x;
+          uint32_t x1 = MIN(2 * x + 1, srcWidth - 1);
+          for (uint32_t c = 0; c < 4; c++) {
+            float average = (a[4 * x0 + c] + a[4 * x1 + c] + b[4 * x0 + c] + b[4 * x1 + c]) * .25f;
+            a[4 * x + c] = (srgb && c < colors) ? linearToGamma(average) : average;
+          }
+        }
+
+        encodeRow(image->format, a, dst, width);
+      }
+    }
+  }
+
+  free(a);
+  return result;
+}
+
+// Compression is split into jobs of one row of blocks, numbered across every level and layer
+
+typedef struct {
+  Image* source;
+  Image* result;
+} CompressContext;
+
+static void compressBlockRow(void* context, uint32_t index) {
+  CompressContext* ctx = context;
+  Image* source = ctx->source;
+  Image* result = ctx->result;
+
+  uint32_t level = 0;
+  uint32_t rows = (lovrImageGetHeight(source, 0) + 3) / 4;
+  while (index >= rows * source->layers) {
+    index -= rows * source->layers;
+    rows = (lovrImageGetHeight(source, ++level) + 3) / 4;
+  }
+
+  uint32_t layer = index / rows;
+  uint32_t by = index % rows;
+  uint32_t width = lovrImageGetWidth(source, level);
+  uint32_t height = lovrImageGetHeight(source, level);
+  uint32_t columns = (width + 3) / 4;
+  size_t blockSize = measure(4, 4, result->format);
+  const uint8_t* pixels = lovrImageGetLayerData(source, level, layer);
+  uint8_t* out = (uint8_t*) lovrImageGetLayerData(result, level, layer) + by * columns * blockSize;
+
+  // Blocks that hang off the edge of the image repeat the edge pixels
+  for (uint32_t bx = 0; bx < columns; bx++, out += blockSize) {
+    uint8_t block[64];
+    for (uint32_t y = 0; y < 4; y++) {
+      uint32_t py = MIN(by * 4 + y, height - 1);
+      for (uint32_t x = 0; x < 4; x++) {
+        uint32_t px = MIN(bx * 4 + x, width - 1);
+        memcpy(block + (y * 4 + x) * 4, pixels + (py * width + px) * 4, 4);
+      }
+    }
+
+    switch (result->format) {
+      case FORMAT_BC1: bc1_encode(out, block); break;
+      case FORMAT_BC3: bc3_encode(out, block); break;
+      case FORMAT_BC7: bc7_encode(out, block); break;
+      default: break;
+    }
+  }
+}
+
+Image* lovrImageCompress(Image* image, TextureFormat format, uint32_t threads) {
+  uint32_t channels, type;
+  lovrCheck(!lovrImageIsCompressed(image), "Image is already compressed");
+  lovrCheck(format == FORMAT_BC1 || format == FORMAT_BC3 || format == FORMAT_BC7, "Images can only be compressed to bc1, bc3, or bc7");
+  lovrAssert(getPixelLayout(image->format, &channels, &type), "Unsupported format for Image:compress");
+
+  Image* source = image;
+  if (image->format != FORMAT_RGBA8) {
+    source = lovrImageConvert(image, FORMAT_RGBA8);
+  }
+
+  uint32_t jobs = 0;
+  for (uint32_t level = 0; level < image->levels; level++) {
+    jobs += (lovrImageGetHeight(image, level) + 3) / 4 * image->layers;
+  }
+
+  Image* result = allocate(image->width, image->height, image->layers, image->levels, format, image->flags);
+  CompressContext context = { source, result };
+  job_run(compressBlockRow, &context, jobs, threads);
+
+  if (source != image) {
+    lovrRelease(source, lovrImageDestroy);
+  }
+
+  return result;
+}
+
 void lovrImageCopy(Image* src, Image* dst, uint32_t srcOffset[2], uint32_t dstOffset[2], uint32_t extent[2]) {
   lovrAssert(src->format == dst->format, "To copy between Images, their formats must match");
   lovrAssert(!lovrImageIsCompressed(src), "Compressed Images cannot be copied");
@@ -1048,6 +1432,27 @@ static Image* loadKTX1(Blob* blob) {
   return image;
 }
 
+// Supercompressed KTX2 levels are inflated in parallel, one job per level
+typedef struct {
+  const void* src;
+  void* dst;
+  size_t srcSize;
+  size_t dstSize;
+  uint32_t scheme;
+  bool ok;
+} KTXLevel;
+
+static void inflateKTXLevel(void* context, uint32_t index) {
+  KTXLevel* level = (KTXLevel*) context + index;
+  if (level->scheme == 2) {
+    size_t written;
+    level->ok = zstd_decompress(level->dst, level->dstSize, level->src, level->srcSize, &written) && written == level->dstSize;
+  } else {
+    int written = stbi_zlib_decode_buffer(level->dst, (int) level->dstSize, level->src, (int) level->srcSize);
+    level->ok = written >= 0 && (size_t) written == level->dstSize;
+  }
+}
+
 static Image* loadKTX2(Blob* blob) {
   typedef struct {
     uint8_t magic[12];
@@ -1088,10 +1493,12 @@ static Image* loadKTX2(Blob* blob) {
   lovrAssert(header->pixelDepth == 0, "Unable to load 3D KTX images");
   lovrAssert(header->faceCount == 1 || header->faceCount == 6, "Invalid KTX file (faceCount must be 1 or 6)");
   lovrAssert(header->layerCount == 0 || header->faceCount == 1, "Unable to load cubemap array KTX images");
-  lovrAssert(!header->compression, "Supercompressed KTX files are not currently supported");
+  lovrAssert(header->vkFormat != 0 && header->compression != 1, "KTX files using Basis Universal (BasisLZ/UASTC) are not supported");
+  lovrAssert(header->compression == 0 || header->compression == 2 || header->compression == 3, "KTX file uses an unsupported supercompression scheme");
 
   uint32_t layers = MAX(header->layerCount, 1);
   uint32_t levels = MAX(header->levelCount, 1);
+  lovrAssert(length >= offsetof(KTX2Header, levels) + levels * sizeof(header->levels[0]), "Invalid KTX file (level index overflow)");
 
   Image* image = calloc(1, offsetof(Image, mipmaps) + levels * sizeof(Mipmap));
   lovrAssert(image, "Out of memory");
@@ -1157,16 +1564,69 @@ static Image* loadKTX2(Blob* blob) {
     default: lovrThrow("KTX file uses an unsupported image format");
   }
 
+  // Supercompression (Zstd or zlib), the inflated levels are packed into a new Blob
+  if (header->compression) {
+    size_t total = 0;
+    for (uint32_t i = 0; i < image->levels; i++) {
+      uint64_t offset = header->levels[i].byteOffset;
+      uint64_t length = header->levels[i].byteLength;
+      lovrAssert(length <= blob->size && offset <= blob->size - length, "KTX file overflow");
+      lovrAssert(header->levels[i].uncompressedLength <= INT32_MAX, "KTX level is too big");
+      total += header->levels[i].uncompressedLength;
+    }
+
+    char* inflated = malloc(total);
+    KTXLevel* jobs = malloc(image->levels * sizeof(KTXLevel));
+    lovrAssert(inflated && jobs, "Out of memory");
+
+    char* cursor = inflated;
+    for (uint32_t i = 0; i < image->levels; i++) {
+      jobs[i] = (KTXLevel) {
+        .src = data + header->levels[i].byteOffset,
+        .dst = cursor,
+        .srcSize = header->levels[i].byteLength,
+        .dstSize = header->levels[i].uncompressedLength,
+        .scheme = header->compression
+      };
+      cursor += jobs[i].dstSize;
+    }
+
+    job_run(inflateKTXLevel, jobs, image->levels, 0);
+
+    bool ok = true;
+    for (uint32_t i = 0; i < image->levels; i++) {
+      ok &= jobs[i].ok;
+    }
+
+    free(jobs);
+
+    if (!ok) {
+      free(inflated);
+      lovrThrow("Could not decompress KTX file (corrupt supercompressed data)");
+    }
+
+    lovrRelease(image->blob, lovrBlobDestroy);
+    image->blob = lovrBlobCreate(inflated, total, "Image");
+  }
+
   // Mipmaps
   uint32_t width = image->width;
   uint32_t height = image->height;
+  char* inflated = image->blob->data;
   for (uint32_t i = 0; i < image->levels; i++) {
-    uint64_t offset = header->levels[i].byteOffset;
-    uint64_t size = header->levels[i].byteLength;
+    uint64_t size = header->compression ? header->levels[i].uncompressedLength : header->levels[i].byteLength;
     size_t stride = size / image->layers;
-    lovrAssert(offset + size <= blob->size, "KTX file overflow");
-    lovrAssert(measure(width, height, image->format) == size, "KTX size mismatch");
-    image->mipmaps[i] = (Mipmap) { data + offset, stride, stride };
+    lovrAssert(measure(width, height, image->format) == stride, "KTX size mismatch");
+
+    if (header->compression) {
+      image->mipmaps[i] = (Mipmap) { inflated, stride, stride };
+      inflated += size;
+    } else {
+      uint64_t offset = header->levels[i].byteOffset;
+      lovrAssert(size <= blob->size && offset <= blob->size - size, "KTX file overflow");
+      image->mipmaps[i] = (Mipmap) { data + offset, stride, stride };
+    }
+
     width = MAX(width >> 1, 1);
     height = MAX(height >> 1, 1);
   }
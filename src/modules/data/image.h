@@ -55,6 +55,8 @@ typedef enum {
 
 typedef struct Image Image;
 
+typedef void MapPixelCallback(void* userdata, uint32_t x, uint32_t y, float pixel[4]);
+
 Image* lovrImageCreateRaw(uint32_t width, uint32_t height, TextureFormat format);
 Image* lovrImageCreateFromFile(struct Blob* blob);
 void lovrImageDestroy(void* ref);
@@ -71,8 +73,17 @@ uint32_t lovrImageGetLevelCount(Image* image);
 TextureFormat lovrImageGetFormat(Image* image);
 size_t lovrImageGetLayerSize(Image* image, uint32_t level);
 void* lovrImageGetLayerData(Image* image, uint32_t level, uint32_t layer);
+void lovrImageReleaseLevel(Image* image, uint32_t level);
 void lovrImageGetPixel(Image* image, uint32_t x, uint32_t y, float pixel[4]);
 void lovrImageSetPixel(Image* image, uint32_t x, uint32_t y, float pixel[4]);
+void lovrImageMapPixel(Image* image, uint32_t x, uint32_t y, uint32_t w, uint32_t h, MapPixelCallback* callback, void* userdata);
+Image* lovrImageConvert(Image* image, TextureFormat format);
+struct Blob* lovrImageGetPixels(Image* image, uint32_t x, uint32_t y, uint32_t w, uint32_t h, TextureFormat format);
+void lovrImageGammaToLinear(Image* image);
+void lovrImageLinearToGamma(Image* image);
+void lovrImagePremultiply(Image* image);
+Image* lovrImageGenerateMipmaps(Image* image);
+Image* lovrImageCompress(Image* image, TextureFormat format, uint32_t threads);
 void lovrImageCopy(Image* src, Image* dst, uint32_t srcOffset[2], uint32_t dstOffset[2], uint32_t extent[2]);
 void lovrImageClear(Image* image);
 struct Blob* lovrImageEncode(Image* image);
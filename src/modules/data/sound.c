@@ -1,11 +1,13 @@
 #include "data/sound.h"
 #include "data/blob.h"
+#include "core/fs.h"
 #include "util.h"
 #include "lib/stb/stb_vorbis.h"
 #include "lib/miniaudio/miniaudio.h"
 #define MINIMP3_FLOAT_OUTPUT
 #define MINIMP3_NO_STDIO
 #include "lib/minimp3/minimp3_ex.h"
+#include "lib/tinycthread/tinycthread.h"
 #include <stdlib.h>
 #include <limits.h>
 #include <string.h>
@@ -28,8 +30,29 @@ struct Sound {
   uint32_t sampleRate;
   uint32_t frames;
   uint32_t cursor;
+  size_t window;
+  size_t released;
+  bool shared;
 };
 
+// Streamed Sounds decode straight from a mapped file, so only the pages the decoder touches are
+// read from disk.  Once the decoder has moved a window past the last release, everything outside
+// the window ahead of it goes back to the OS, where fs_release supports it.  Seeks backwards read
+// the file again.
+static void releasePages(Sound* sound, size_t offset) {
+  if (!sound->window || (offset >= sound->released && offset - sound->released < sound->window)) {
+    return;
+  }
+
+  uint8_t* data = sound->blob->data;
+  size_t size = sound->blob->size;
+  offset = MIN(offset, size);
+  size_t end = size - offset > sound->window ? offset + sound->window : size;
+  fs_release(data, offset);
+  fs_release(data + end, size - end);
+  sound->released = offset;
+}
+
 // Readers
 
 static uint32_t lovrSoundReadRaw(Sound* sound, uint32_t offset, uint32_t count, void* data) {
@@ -59,6 +82,7 @@ static uint32_t lovrSoundReadOgg(Sound* sound, uint32_t offset, uint32_t count,
   uint32_t sampleCount = count * channelCount;
   uint32_t n = stb_vorbis_get_samples_float_interleaved(sound->decoder, channelCount, data, sampleCount);
   sound->cursor += n;
+  releasePages(sound, stb_vorbis_get_file_offset(sound->decoder));
   return n;
 }
 
@@ -72,9 +96,185 @@ static uint32_t lovrSoundReadMp3(Sound* sound, uint32_t offset, uint32_t count,
   size_t samples = mp3dec_ex_read(sound->decoder, data, count * channels);
   uint32_t frames = (uint32_t) (samples / channels);
   sound->cursor += frames;
+  releasePages(sound, ((mp3dec_ex_t*) sound->decoder)->offset);
   return frames;
 }
 
+// Cache
+
+// Sounds decoded from the same file share one PCM Blob.  The cache holds a reference to each Blob
+// and evicts the least recently used ones once the budget is exceeded.  Sounds keep their own
+// reference, so eviction never frees data that is still in use.  Only Sounds that are decoded when
+// they're loaded are cached, the others keep their decoder.
+//
+// Files are identified by their size and two independent 64 bit hashes, FNV1a and a word at a time
+// hash using MurmurHash64A's mixing, so the file doesn't have to be kept around to compare it.
+
+#define SOUND_CACHE_BUDGET (64 << 20)
+
+typedef struct CacheEntry {
+  struct CacheEntry* prev;
+  struct CacheEntry* next;
+  uint64_t hash;
+  uint64_t check;
+  size_t fileSize;
+  Blob* blob;
+  SampleFormat format;
+  ChannelLayout layout;
+  uint32_t sampleRate;
+  uint32_t frames;
+} CacheEntry;
+
+static struct {
+  once_flag once;
+  mtx_t lock;
+  map_t entries;
+  CacheEntry* head;
+  CacheEntry* tail;
+  size_t size;
+  size_t budget;
+  SoundCacheStats stats;
+} cache = { .once = ONCE_FLAG_INIT, .budget = SOUND_CACHE_BUDGET };
+
+static uint64_t hashWords(const void* data, size_t size) {
+  const uint64_t m = 0xc6a4a7935bd1e995;
+  const uint8_t* bytes = data;
+  uint64_t hash = 0x8445d61a4e774912 ^ (size * m);
+  size_t i = 0;
+
+  for (; i + 8 <= size; i += 8) {
+    uint64_t k;
+    memcpy(&k, bytes + i, 8);
+    k *= m;
+    k ^= k >> 47;
+    k *= m;
+    hash ^= k;
+    hash *= m;
+  }
+
+  if (i < size) {
+    uint64_t k = 0;
+    memcpy(&k, bytes + i, size - i);
+    hash ^= k;
+    hash *= m;
+  }
+
+  hash ^= hash >> 47;
+  hash *= m;
+  hash ^= hash >> 47;
+  return hash;
+}
+
+static void cacheInit(void) {
+  mtx_init(&cache.lock, mtx_plain);
+  map_init(&cache.entries, 0);
+}
+
+static void cacheUnlink(CacheEntry* entry) {
+  if (entry->prev) entry->prev->next = entry->next;
+  else cache.head = entry->next;
+  if (entry->next) entry->next->prev = entry->prev;
+  else cache.tail = entry->prev;
+  entry->prev = entry->next = NULL;
+}
+
+static void cachePushFront(CacheEntry* entry) {
+  entry->next = cache.head;
+  if (cache.head) cache.head->prev = entry;
+  else cache.tail = entry;
+  cache.head = entry;
+}
+
+static void cacheTrim(size_t budget) {
+  while (cache.tail && cache.size > budget) {
+    CacheEntry* entry = cache.tail;
+    cacheUnlink(entry);
+    map_remove(&cache.entries, entry->hash);
+    cache.size -= entry->blob->size;
+    cache.stats.evictions++;
+    lovrRelease(entry->blob, lovrBlobDestroy);
+    free(entry);
+  }
+}
+
+static bool cacheLookup(Sound* sound, uint64_t hash, uint64_t check, size_t fileSize) {
+  bool hit = false;
+  mtx_lock(&cache.lock);
+  uint64_t value = map_get(&cache.entries, hash);
+  CacheEntry* entry = value == MAP_NIL ? NULL : (CacheEntry*) (uintptr_t) value;
+  if (entry && entry->check == check && entry->fileSize == fileSize) {
+    cacheUnlink(entry);
+    cachePushFront(entry);
+    lovrRetain(entry->blob);
+    sound->blob = entry->blob;
+    sound->format = entry->format;
+    sound->layout = entry->layout;
+    sound->sampleRate = entry->sampleRate;
+    sound->frames = entry->frames;
+    sound->read = lovrSoundReadRaw;
+    sound->shared = true;
+    cache.stats.hits++;
+    hit = true;
+  } else {
+    cache.stats.misses++;
+  }
+  mtx_unlock(&cache.lock);
+  return hit;
+}
+
+static void cacheInsert(Sound* sound, uint64_t hash, uint64_t check, size_t fileSize) {
+  mtx_lock(&cache.lock);
+  if (sound->blob->size <= cache.budget && map_get(&cache.entries, hash) == MAP_NIL) {
+    CacheEntry* entry = calloc(1, sizeof(CacheEntry));
+    lovrAssert(entry, "Out of memory");
+    entry->hash = hash;
+    entry->check = check;
+    entry->fileSize = fileSize;
+    entry->blob = sound->blob;
+    entry->format = sound->format;
+    entry->layout = sound->layout;
+    entry->sampleRate = sound->sampleRate;
+    entry->frames = sound->frames;
+    lovrRetain(entry->blob);
+    map_set(&cache.entries, hash, (uint64_t) (uintptr_t) entry);
+    cachePushFront(entry);
+    cache.size += entry->blob->size;
+    sound->shared = true;
+    cacheTrim(cache.budget);
+  }
+  mtx_unlock(&cache.lock);
+}
+
+void lovrSoundGetCacheStats(SoundCacheStats* stats) {
+  call_once(&cache.once, cacheInit);
+  mtx_lock(&cache.lock);
+  *stats = cache.stats;
+  stats->size = cache.size;
+  stats->budget = cache.budget;
+  stats->count = cache.entries.used;
+  mtx_unlock(&cache.lock);
+}
+
+void lovrSoundSetCacheBudget(size_t budget) {
+  call_once(&cache.once, cacheInit);
+  mtx_lock(&cache.lock);
+  cache.budget = budget;
+  cacheTrim(budget);
+  mtx_unlock(&cache.lock);
+}
+
+// Writes to a shared Sound go to a private copy of its data
+static void detachSharedData(Sound* sound) {
+  if (!sound->shared) return;
+  void* data = malloc(sound->blob->size);
+  lovrAssert(data, "Out of memory");
+  memcpy(data, sound->blob->data, sound->blob->size);
+  Blob* blob = lovrBlobCreate(data, sound->blob->size, sound->blob->name);
+  lovrRelease(sound->blob, lovrBlobDestroy);
+  sound->blob = blob;
+  sound->shared = false;
+}
+
 // Sound
 
 Sound* lovrSoundCreateRaw(uint32_t frames, SampleFormat format, ChannelLayout layout, uint32_t sampleRate, Blob* blob) {
@@ -318,11 +518,48 @@ Sound* lovrSoundCreateFromFile(Blob* blob, bool decode) {
   lovrAssert(sound, "Out of memory");
   sound->ref = 1;
 
-  if (loadOgg(sound, blob, decode)) return sound;
-  if (loadWAV(sound, blob, decode)) return sound;
-  if (loadMP3(sound, blob, decode)) return sound;
+  uint64_t hash = 0;
+  uint64_t check = 0;
+
+  if (decode) {
+    call_once(&cache.once, cacheInit);
+    hash = hash64(blob->data, blob->size);
+    check = hashWords(blob->data, blob->size);
+    if (cacheLookup(sound, hash, check, blob->size)) {
+      return sound;
+    }
+  }
 
-  lovrThrow("Could not load sound from '%s': Audio format not recognized", blob->name);
+  if (!loadOgg(sound, blob, decode) && !loadWAV(sound, blob, decode) && !loadMP3(sound, blob, decode)) {
+    lovrThrow("Could not load sound from '%s': Audio format not recognized", blob->name);
+  }
+
+  if (decode && !sound->decoder) {
+    cacheInsert(sound, hash, check, blob->size);
+  }
+
+  return sound;
+}
+
+// Streams bypass the cache, hashing the file would read all of it.  WAV data is copied out of the
+// file when loading, so the window only applies to compressed formats.
+Sound* lovrSoundCreateFromStream(Blob* blob, size_t window) {
+  Sound* sound = calloc(1, sizeof(Sound));
+  lovrAssert(sound, "Out of memory");
+  sound->ref = 1;
+
+  if (!loadOgg(sound, blob, false) && !loadWAV(sound, blob, false) && !loadMP3(sound, blob, false)) {
+    lovrThrow("Could not load sound from '%s': Audio format not recognized", blob->name);
+  }
+
+  // Opening a file can scan all of it, so the pages are released right away
+  if (sound->decoder && blob->unmap) {
+    sound->window = MAX(window, 1);
+    sound->released = SIZE_MAX;
+    releasePages(sound, 0);
+  }
+
+  return sound;
 }
 
 Sound* lovrSoundCreateFromCallback(SoundCallback read, void *callbackMemo, SoundDestroyCallback callbackMemoDestroy, SampleFormat format, uint32_t sampleRate, ChannelLayout layout, uint32_t maxFrames) {
@@ -350,7 +587,9 @@ void lovrSoundDestroy(void* ref) {
   free(sound);
 }
 
+// The Blob can be written to, so shared data is detached first
 Blob* lovrSoundGetBlob(Sound* sound) {
+  detachSharedData(sound);
   return sound->blob;
 }
 
@@ -413,6 +652,7 @@ uint32_t lovrSoundWrite(Sound* sound, uint32_t offset, uint32_t count, const voi
       frames += chunk;
     }
   } else {
+    detachSharedData(sound);
     count = MIN(count, sound->frames - offset);
     memcpy((char*) sound->blob->data + offset * stride, data, count * stride);
     frames = count;
@@ -440,6 +680,7 @@ uint32_t lovrSoundCopy(Sound* src, Sound* dst, uint32_t count, uint32_t srcOffse
       frames += read;
     }
   } else {
+    detachSharedData(dst);
     count = MIN(count, dst->frames - dstOffset);
     size_t stride = lovrSoundGetStride(src);
     char* data = (char*) dst->blob->data + dstOffset * stride;
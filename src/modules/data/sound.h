@@ -9,6 +9,9 @@ struct Blob;
 // Can pass as the maxFrames argument to lovrSoundCreateFromCallback
 #define LOVR_SOUND_ENDLESS 0xFFFFFFFF
 
+// Default number of bytes of a streamed file kept in memory, see lovrSoundCreateFromStream
+#define LOVR_SOUND_STREAM_WINDOW (256 << 10)
+
 typedef enum {
   SAMPLE_F32,
   SAMPLE_I16
@@ -22,12 +25,22 @@ typedef enum {
 
 typedef struct Sound Sound;
 
+typedef struct {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+  size_t size;
+  size_t budget;
+  uint32_t count;
+} SoundCacheStats;
+
 typedef uint32_t (SoundCallback)(Sound* sound, uint32_t offset, uint32_t count, void* data);
 typedef void (SoundDestroyCallback)(Sound* sound);
 
 Sound* lovrSoundCreateRaw(uint32_t frames, SampleFormat format, ChannelLayout channels, uint32_t sampleRate, struct Blob* data);
 Sound* lovrSoundCreateStream(uint32_t frames, SampleFormat format, ChannelLayout channels, uint32_t sampleRate);
 Sound* lovrSoundCreateFromFile(struct Blob* blob, bool decode);
+Sound* lovrSoundCreateFromStream(struct Blob* blob, size_t window);
 Sound* lovrSoundCreateFromCallback(SoundCallback read, void *callbackMemo, SoundDestroyCallback callbackDataDestroy, SampleFormat format, uint32_t sampleRate, ChannelLayout channels, uint32_t maxFrames);
 void lovrSoundDestroy(void* ref);
 struct Blob* lovrSoundGetBlob(Sound* sound);
@@ -44,3 +57,5 @@ uint32_t lovrSoundRead(Sound* sound, uint32_t offset, uint32_t count, void* data
 uint32_t lovrSoundWrite(Sound* sound, uint32_t offset, uint32_t count, const void* data);
 uint32_t lovrSoundCopy(Sound* src, Sound* dst, uint32_t frames, uint32_t srcOffset, uint32_t dstOffset);
 void *lovrSoundGetCallbackMemo(Sound* sound);
+void lovrSoundGetCacheStats(SoundCacheStats* stats);
+void lovrSoundSetCacheBudget(size_t budget);
@@ -40,6 +40,7 @@ typedef struct Archive {
   bool (*stat)(struct Archive* archive, const char* path, FileInfo* info);
   void (*list)(struct Archive* archive, const char* path, fs_list_cb callback, void* context);
   bool (*read)(struct Archive* archive, const char* path, size_t bytes, size_t* bytesRead, void** data);
+  bool (*map)(struct Archive* archive, const char* path, size_t* size, void** data);
   void (*close)(struct Archive* archive);
   zip_state zip;
   strpool strings;
@@ -204,7 +205,7 @@ bool lovrFilesystemMount(const char* path, const char* mountpoint, bool append,
     }
   }
 
-  Archive archive;
+  Archive archive = { 0 };
   arr_init(&archive.strings, arr_alloc);
 
   if (!dir_init(&archive, path, mountpoint, root) && !zip_init(&archive, path, mountpoint, root)) {
@@ -299,6 +300,24 @@ void* lovrFilesystemRead(const char* path, size_t bytes, size_t* bytesRead) {
   return NULL;
 }
 
+// Returns a read only view of a file that is paged in on demand, or NULL if the file can't be
+// mapped (files in zip archives aren't), in which case it has to be read instead.
+void* lovrFilesystemMap(const char* path, size_t* size) {
+  if (valid(path)) {
+    void* data;
+    FOREACH_ARCHIVE(archive) {
+      if (archive->map(archive, path, size, &data)) {
+        return data;
+      }
+    }
+  }
+  return NULL;
+}
+
+bool lovrFilesystemUnmap(void* data, size_t size) {
+  return fs_unmap(data, size);
+}
+
 void lovrFilesystemGetDirectoryItems(const char* path, void (*callback)(void* context, const char* path), void* context) {
   if (valid(path)) {
     FOREACH_ARCHIVE(archive) {
@@ -567,6 +586,17 @@ static bool dir_read(Archive* archive, const char* path, size_t bytes, size_t* b
   return true;
 }
 
+static bool dir_map(Archive* archive, const char* path, size_t* size, void** data) {
+  char resolved[LOVR_PATH_MAX];
+  FileInfo info;
+  if (dir_resolve(archive, resolved, path) != PATH_PHYSICAL || !fs_stat(resolved, &info)) {
+    return false;
+  }
+
+  *data = info.type == FILE_REGULAR && info.size > 0 ? fs_map(resolved, size) : NULL;
+  return true;
+}
+
 static void dir_close(Archive* archive) {
   arr_free(&archive->strings);
 }
@@ -580,6 +610,7 @@ static bool dir_init(Archive* archive, const char* path, const char* mountpoint,
   archive->stat = dir_stat;
   archive->list = dir_list;
   archive->read = dir_read;
+  archive->map = dir_map;
   archive->close = dir_close;
   return true;
 }
@@ -670,6 +701,14 @@ static bool zip_read(Archive* archive, const char* path, size_t bytes, size_t* b
   return true;
 }
 
+// Files in a zip are never mapped: a view into the archive's mapping would dangle once the archive
+// is unmounted, so they get read (and inflated) into their own memory instead
+static bool zip_map(Archive* archive, const char* path, size_t* size, void** data) {
+  if (!zip_lookup(archive, path)) return false;
+  *data = NULL;
+  return true;
+}
+
 static void zip_close(Archive* archive) {
   arr_free(&archive->nodes);
   map_free(&archive->lookup);
@@ -800,6 +839,7 @@ static bool zip_init(Archive* archive, const char* filename, const char* mountpo
   archive->stat = zip_stat;
   archive->list = zip_list;
   archive->read = zip_read;
+  archive->map = zip_map;
   archive->close = zip_close;
   return true;
 }
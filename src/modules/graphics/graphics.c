@@ -6,6 +6,7 @@
 #include "event/event.h"
 #include "headset/headset.h"
 #include "math/math.h"
+#include "core/convert.h"
 #include "core/gpu.h"
 #include "core/maf.h"
 #include "core/spv.h"
@@ -28,6 +29,9 @@ const char** os_vk_get_instance_extensions(uint32_t* count);
 #define MAX_TRANSFORMS 16
 #define MAX_PIPELINES 4
 #define MAX_SHADER_RESOURCES 32
+#define STREAMING_TAIL_SIZE 128
+#define STREAMING_ACTIVE_FRAMES 2
+#define STREAMING_UPLOAD_LIMIT (32 << 20)
 #define FLOAT_BITS(f) ((union { float f; uint32_t u; }) { f }).u
 
 typedef struct {
@@ -49,12 +53,22 @@ struct Buffer {
   Sync sync;
 };
 
+typedef struct {
+  Image* image;
+  uint32_t level;
+  uint32_t minLevel;
+  uint32_t tailLevel;
+  uint32_t lastUse;
+  size_t memory;
+} TextureResidency;
+
 struct Texture {
   uint32_t ref;
   uint32_t xrTick;
   gpu_texture* gpu;
   gpu_texture* renderView;
   Material* material;
+  TextureResidency* residency;
   TextureInfo info;
   Sync sync;
 };
@@ -115,9 +129,12 @@ struct Material {
   uint32_t tick;
   uint16_t index;
   uint16_t block;
+  uint32_t streamTick;
   gpu_bundle* bundle;
+  gpu_bundle* streamBundle;
   MaterialInfo info;
   bool hasWritableTexture;
+  bool hasStreamingTexture;
 };
 
 typedef struct {
@@ -404,6 +421,13 @@ static struct {
   size_t builtinLayout;
   size_t materialLayout;
   Allocator allocator;
+  struct {
+    arr_t(Texture*) textures;
+    size_t budget;
+    size_t memory;
+    uint32_t uploads;
+    uint32_t evictions;
+  } streaming;
 } state;
 
 // Helpers
@@ -413,6 +437,7 @@ static size_t tempPush(void);
 static void tempPop(size_t stack);
 static int u64cmp(const void* a, const void* b);
 static void beginFrame(void);
+static void updateStreaming(void);
 static void releasePassResources(void);
 static void processReadbacks(void);
 static size_t getLayout(gpu_slot* slots, uint32_t count);
@@ -421,11 +446,15 @@ static gpu_texture* getScratchTexture(gpu_texture_info* info);
 static bool isDepthFormat(TextureFormat format);
 static uint32_t measureTexture(TextureFormat format, uint32_t w, uint32_t h, uint32_t d);
 static void checkTextureBounds(const TextureInfo* info, uint32_t offset[4], uint32_t extent[3]);
+static bool setResidentLevel(Texture* texture, uint32_t level);
+static void touchTexture(Texture* texture);
 static void mipmapTexture(gpu_stream* stream, Texture* texture, uint32_t base, uint32_t count);
 static ShaderResource* findShaderResource(Shader* shader, const char* name, size_t length, uint32_t slot);
 static void trackBuffer(Pass* pass, Buffer* buffer, gpu_phase phase, gpu_cache cache);
 static void trackTexture(Pass* pass, Texture* texture, gpu_phase phase, gpu_cache cache);
 static void trackMaterial(Pass* pass, Material* material, gpu_phase phase, gpu_cache cache);
+static void writeMaterialBundle(Material* material, gpu_bundle* bundle);
+static gpu_bundle* getMaterialBundle(Material* material);
 static void updateModelTransforms(Model* model, uint32_t nodeIndex, float* parent);
 static void checkShaderFeatures(uint32_t* features, uint32_t count);
 static void onResize(uint32_t width, uint32_t height);
@@ -491,6 +520,8 @@ bool lovrGraphicsInit(GraphicsConfig* config) {
   arr_init(&state.scratchBuffers, realloc);
   arr_init(&state.scratchBufferHandles, realloc);
   arr_init(&state.scratchTextures, realloc);
+  arr_init(&state.streaming.textures, realloc);
+  state.streaming.budget = config->streamingBudget;
 
   for (uint32_t i = 0; i < COUNTOF(state.passes); i++) {
     arr_init(&state.passes[i].readbacks, realloc);
@@ -716,6 +747,7 @@ void lovrGraphicsDestroy() {
     free(state.scratchTextures.data[i].texture);
   }
   arr_free(&state.scratchTextures);
+  arr_free(&state.streaming.textures);
   for (size_t i = 0; i < state.pipelines.length; i++) {
     gpu_pipeline_destroy(state.pipelines.data[i]);
     free(state.pipelines.data[i]);
@@ -1179,6 +1211,25 @@ void* lovrBufferMap(Buffer* buffer, uint32_t offset, uint32_t size) {
   return buffer->pointer + offset;
 }
 
+// Returns memory to write a range of the Buffer to.  Temporary buffers are written directly.  Other
+// buffers get staging memory that is copied into them at the start of the frame's submission, so
+// every pass submitted this frame sees the new contents.  The whole range has to be written.
+void* lovrBufferSetData(Buffer* buffer, uint32_t offset, uint32_t size) {
+  lovrCheck(offset + size <= buffer->size, "Tried to write past the end of the Buffer");
+
+  if (buffer->pointer) {
+    return buffer->pointer + offset;
+  }
+
+  beginFrame();
+  gpu_buffer* scratchpad = tempAlloc(gpu_sizeof_buffer());
+  void* data = gpu_map(scratchpad, size, 4, GPU_MAP_STAGING);
+  gpu_copy_buffers(state.stream, scratchpad, buffer->gpu, 0, offset, size);
+  buffer->sync.writePhase = GPU_PHASE_TRANSFER;
+  buffer->sync.pendingWrite = GPU_CACHE_TRANSFER_WRITE;
+  return data;
+}
+
 void lovrBufferClear(Buffer* buffer, uint32_t offset, uint32_t size) {
   lovrAssert(buffer->pointer, "This function can only be called on temporary buffers");
   lovrCheck(size % 4 == 0, "Buffer clear size must be a multiple of 4");
@@ -1189,6 +1240,27 @@ void lovrBufferClear(Buffer* buffer, uint32_t offset, uint32_t size) {
 
 // Texture
 
+size_t lovrGraphicsGetStreamingBudget() {
+  return state.streaming.budget;
+}
+
+void lovrGraphicsSetStreamingBudget(size_t budget) {
+  state.streaming.budget = budget;
+}
+
+void lovrGraphicsGetStreamingStats(StreamingStats* stats) {
+  stats->budget = state.streaming.budget;
+  stats->memory = state.streaming.memory;
+  stats->textureCount = (uint32_t) state.streaming.textures.length;
+  stats->residentLevels = 0;
+  stats->uploads = state.streaming.uploads;
+  stats->evictions = state.streaming.evictions;
+  for (size_t i = 0; i < state.streaming.textures.length; i++) {
+    Texture* texture = state.streaming.textures.data[i];
+    stats->residentLevels += texture->info.mipmaps - texture->residency->level;
+  }
+}
+
 Texture* lovrGraphicsGetWindowTexture() {
   if (!state.window->gpu) {
     beginFrame();
@@ -1243,6 +1315,20 @@ Texture* lovrTextureCreate(const TextureInfo* info) {
   lovrCheck((info->format < FORMAT_BC1 || info->format > FORMAT_BC7) || state.features.textureBC, "%s textures are not supported on this GPU", "BC");
   lovrCheck(info->format < FORMAT_ASTC_4x4 || state.features.textureASTC, "%s textures are not supported on this GPU", "ASTC");
 
+  if (info->streaming) {
+    lovrCheck(info->imageCount == 1, "Streaming textures must be created from a single Image");
+    lovrCheck(info->usage == TEXTURE_SAMPLE, "Streaming textures can only have the 'sample' usage");
+    lovrCheck(info->type != TEXTURE_3D, "Volume textures can not be streamed");
+    lovrCheck(mipmaps > 1 && lovrImageGetLevelCount(info->images[0]) == mipmaps, "Streaming textures require an Image with mipmaps");
+
+    for (uint32_t level = 0; level < mipmaps; level++) {
+      uint32_t width = MAX(info->width >> level, 1);
+      uint32_t height = MAX(info->height >> level, 1);
+      size_t size = lovrImageGetLayerSize(info->images[0], level);
+      lovrCheck(size * info->layers == measureTexture(info->format, width, height, info->layers), "Texture/Image size mismatch!");
+    }
+  }
+
   Texture* texture = calloc(1, sizeof(Texture) + gpu_sizeof_texture());
   lovrAssert(texture, "Out of memory");
   texture->ref = 1;
@@ -1250,6 +1336,28 @@ Texture* lovrTextureCreate(const TextureInfo* info) {
   texture->info = *info;
   texture->info.mipmaps = mipmaps;
 
+  // Streaming textures only upload their mip tail here, the rest is streamed in by beginFrame
+  if (info->streaming) {
+    texture->residency = calloc(1, sizeof(TextureResidency));
+    lovrAssert(texture->residency, "Out of memory");
+    texture->residency->image = info->images[0];
+    texture->residency->level = mipmaps;
+    texture->residency->tailLevel = mipmaps - 1;
+    lovrRetain(info->images[0]);
+
+    for (uint32_t level = 0; level < mipmaps; level++) {
+      if (MAX(info->width >> level, info->height >> level) <= STREAMING_TAIL_SIZE) {
+        texture->residency->tailLevel = level;
+        break;
+      }
+    }
+
+    beginFrame();
+    lovrAssert(setResidentLevel(texture, texture->residency->tailLevel), "Failed to create streaming texture");
+    arr_push(&state.streaming.textures, texture);
+    return texture;
+  }
+
   uint32_t levelCount = 0;
   uint32_t levelOffsets[16];
   uint32_t levelSizes[16];
@@ -1344,6 +1452,7 @@ Texture* lovrTextureCreateView(const TextureViewInfo* view) {
   const TextureInfo* info = &view->parent->info;
   uint32_t maxLayers = info->type == TEXTURE_3D ? MAX(info->layers >> view->levelIndex, 1) : info->layers;
   lovrCheck(!info->parent, "Can't nest texture views");
+  lovrCheck(!view->parent->residency, "Can't create views of streaming textures");
   lovrCheck(view->type != TEXTURE_3D, "Texture views may not be volume textures");
   lovrCheck(view->layerCount > 0, "Texture view must have at least one layer");
   lovrCheck(view->layerIndex + view->layerCount <= maxLayers, "Texture view layer range exceeds layer count of parent texture");
@@ -1389,6 +1498,17 @@ void lovrTextureDestroy(void* ref) {
     if (texture->renderView && texture->renderView != texture->gpu) gpu_texture_destroy(texture->renderView);
     if (texture->gpu) gpu_texture_destroy(texture->gpu);
   }
+  if (texture->residency) {
+    for (size_t i = 0; i < state.streaming.textures.length; i++) {
+      if (state.streaming.textures.data[i] == texture) {
+        state.streaming.textures.data[i] = arr_pop(&state.streaming.textures);
+        break;
+      }
+    }
+    state.streaming.memory -= texture->residency->memory;
+    lovrRelease(texture->residency->image, lovrImageDestroy);
+    free(texture->residency);
+  }
   free(texture);
 }
 
@@ -1396,6 +1516,20 @@ const TextureInfo* lovrTextureGetInfo(Texture* texture) {
   return &texture->info;
 }
 
+uint32_t lovrTextureGetResidentLevel(Texture* texture) {
+  return texture->residency ? texture->residency->level : 0;
+}
+
+uint32_t lovrTextureGetMinResidentLevel(Texture* texture) {
+  return texture->residency ? texture->residency->minLevel : 0;
+}
+
+void lovrTextureSetMinResidentLevel(Texture* texture, uint32_t level) {
+  lovrCheck(texture->residency, "Only streaming textures have a minimum resident level");
+  lovrCheck(level < texture->info.mipmaps, "Minimum resident level must be less than the Texture's mipmap count");
+  texture->residency->minLevel = level;
+}
+
 static Material* lovrTextureGetMaterial(Texture* texture) {
   if (!texture->material) {
     texture->material = lovrMaterialCreate(&(MaterialInfo) {
@@ -2044,16 +2178,6 @@ Material* lovrMaterialCreate(const MaterialInfo* info) {
 
   memcpy(data, info, sizeof(MaterialData));
 
-  gpu_buffer_binding buffer = {
-    .object = block->buffer,
-    .offset = material->index * stride,
-    .extent = stride
-  };
-
-  gpu_binding bindings[8] = {
-    { 0, GPU_SLOT_UNIFORM_BUFFER, .buffer = buffer }
-  };
-
   Texture* textures[] = {
     info->texture,
     info->glowTexture,
@@ -2064,22 +2188,19 @@ Material* lovrMaterialCreate(const MaterialInfo* info) {
     info->normalTexture
   };
 
+  material->hasStreamingTexture = false;
+  material->streamBundle = NULL;
+
   for (uint32_t i = 0; i < COUNTOF(textures); i++) {
     lovrRetain(textures[i]);
     Texture* texture = textures[i] ? textures[i] : state.defaultTexture;
     lovrCheck(i == 0 || texture->info.type == TEXTURE_2D, "Material textures must be 2D");
     lovrCheck(texture->info.usage & TEXTURE_SAMPLE, "Textures must be created with the 'sample' usage to use them in Materials");
-    bindings[i + 1] = (gpu_binding) { i + 1, GPU_SLOT_SAMPLED_TEXTURE, .texture = texture->gpu };
     material->hasWritableTexture |= texture->info.usage != TEXTURE_SAMPLE;
+    material->hasStreamingTexture |= !!texture->residency;
   }
 
-  gpu_bundle_info bundleInfo = {
-    .layout = state.layouts.data[state.materialLayout].gpu,
-    .bindings = bindings,
-    .count = COUNTOF(bindings)
-  };
-
-  gpu_bundle_write(&material->bundle, &bundleInfo, 1);
+  writeMaterialBundle(material, material->bundle);
 
   return material;
 }
@@ -2304,23 +2425,14 @@ static Glyph* lovrFontGetGlyph(Font* font, uint32_t codepoint, bool* resized) {
 
   gpu_buffer* scratchpad = tempAlloc(gpu_sizeof_buffer());
 
-  size_t stack = tempPush();
-  float* pixels = tempAlloc(pixelWidth * pixelHeight * 4 * sizeof(float));
+  // msdfgen writes floats straight into staging memory, then they get packed to rgba8 in place
+  size_t count = pixelWidth * pixelHeight * 4;
+  float* pixels = gpu_map(scratchpad, count * sizeof(float), 4, GPU_MAP_STAGING);
   lovrRasterizerGetPixels(font->info.rasterizer, glyph->codepoint, pixels, pixelWidth, pixelHeight, font->info.spread);
-  uint8_t* dst = gpu_map(scratchpad, pixelWidth * pixelHeight * 4 * sizeof(uint8_t), 4, GPU_MAP_STAGING);
-  float* src = pixels;
-  for (uint32_t y = 0; y < pixelHeight; y++) {
-    for (uint32_t x = 0; x < pixelWidth; x++) {
-      for (uint32_t c = 0; c < 4; c++) {
-        float f = *src++; // CLAMP would evaluate this multiple times
-        *dst++ = (uint8_t) (CLAMP(f, 0.f, 1.f) * 255.f + .5f);
-      }
-    }
-  }
+  convert_f32_to_un8((uint8_t*) pixels, pixels, count);
   uint32_t dstOffset[4] = { glyph->x - font->padding, glyph->y - font->padding, 0, 0 };
   uint32_t extent[3] = { pixelWidth, pixelHeight, 1 };
   gpu_copy_buffer_texture(state.stream, scratchpad, font->atlas->gpu, 0, dstOffset, extent);
-  tempPop(stack);
 
   state.hasGlyphUpload = true;
   return glyph;
@@ -3967,6 +4079,7 @@ void lovrPassSendTexture(Pass* pass, const char* name, size_t length, uint32_t s
 
   pass->bindings[slot].texture = texture->gpu;
   pass->bindingMask |= (1u << slot);
+  touchTexture(texture);
   pass->bindingsDirty = true;
 
   gpu_phase phase = 0;
@@ -4184,16 +4297,16 @@ static void bindBundles(Pass* pass, Draw* draw, Shader* shader) {
     if (draw->material && draw->material != pass->pipeline->material) {
       trackMaterial(pass, draw->material, GPU_PHASE_SHADER_VERTEX | GPU_PHASE_SHADER_FRAGMENT, GPU_CACHE_TEXTURE);
       pass->materialDirty = true;
-      bundles[1] = draw->material->bundle;
+      bundles[1] = getMaterialBundle(draw->material);
       bundleMask |= (1 << 1);
     } else if (pass->materialDirty) {
       Material* material = pass->pipeline->material ? pass->pipeline->material : state.defaultMaterial;
       trackMaterial(pass, material, GPU_PHASE_SHADER_VERTEX | GPU_PHASE_SHADER_FRAGMENT, GPU_CACHE_TEXTURE);
       pass->materialDirty = false;
-      bundles[1] = material->bundle;
+      bundles[1] = getMaterialBundle(material);
       bundleMask |= (1 << 1);
     } else {
-      bundles[1] = (pass->pipeline->material ? pass->pipeline->material : state.defaultMaterial)->bundle;
+      bundles[1] = getMaterialBundle(pass->pipeline->material ? pass->pipeline->material : state.defaultMaterial);
     }
   }
 
@@ -5498,6 +5611,82 @@ static void beginFrame(void) {
   state.scratchBufferIndex = 0;
   state.allocator.cursor = 0;
   processReadbacks();
+  updateStreaming();
+}
+
+// Evicts the most detailed level of the least recently used streaming texture, only considering
+// textures that were last used before the given tick.
+static bool evictStreamingLevel(uint32_t tick) {
+  Texture* victim = NULL;
+
+  for (size_t i = 0; i < state.streaming.textures.length; i++) {
+    Texture* texture = state.streaming.textures.data[i];
+    TextureResidency* residency = texture->residency;
+    uint32_t coarsest = MAX(residency->tailLevel, residency->minLevel);
+    if (residency->level < coarsest && residency->lastUse < tick && (!victim || residency->lastUse < victim->residency->lastUse)) {
+      victim = texture;
+    }
+  }
+
+  if (victim && setResidentLevel(victim, victim->residency->level + 1)) {
+    state.streaming.evictions++;
+    return true;
+  }
+
+  return false;
+}
+
+// Textures that were used in the last few frames get one more detailed level per frame, as long as
+// it fits in the budget and the per-frame upload limit.  Levels of textures that haven't been used
+// as recently are evicted to make room, and if the budget was lowered, levels are evicted from the
+// least recently used textures until everything fits.  Only the mip tail is guaranteed resident.
+static void updateStreaming(void) {
+  size_t budget = state.streaming.budget;
+  size_t uploaded = 0;
+
+  for (size_t i = 0; i < state.streaming.textures.length; i++) {
+    Texture* texture = state.streaming.textures.data[i];
+    TextureResidency* residency = texture->residency;
+    uint32_t coarsest = MAX(residency->tailLevel, residency->minLevel);
+    uint32_t level = CLAMP(residency->level, residency->minLevel, coarsest);
+
+    if (level != residency->level) {
+      setResidentLevel(texture, level);
+      continue;
+    }
+
+    if (level == residency->minLevel || state.tick - residency->lastUse > STREAMING_ACTIVE_FRAMES) {
+      continue;
+    }
+
+    TextureInfo* info = &texture->info;
+    uint32_t width = MAX(info->width >> (level - 1), 1);
+    uint32_t height = MAX(info->height >> (level - 1), 1);
+    size_t cost = measureTexture(info->format, width, height, info->layers);
+
+    if (uploaded > 0 && uploaded + cost > STREAMING_UPLOAD_LIMIT) {
+      continue;
+    }
+
+    if (budget > 0) {
+      while (state.streaming.memory + cost > budget) {
+        if (!evictStreamingLevel(residency->lastUse)) break;
+      }
+
+      if (state.streaming.memory + cost > budget) {
+        continue;
+      }
+    }
+
+    if (setResidentLevel(texture, level - 1)) {
+      uploaded += cost;
+      state.streaming.uploads++;
+    }
+  }
+
+  while (budget > 0 && state.streaming.memory > budget) {
+    if (!evictStreamingLevel(~0u)) break;
+  }
 }
 
 static void releasePassResources(void) {
@@ -5728,6 +5917,98 @@ static void checkTextureBounds(const TextureInfo* info, uint32_t offset[4], uint
   lovrCheck(offset[3] < info->mipmaps, "Texture mipmap %d exceeds its mipmap count (%d)", offset[3] + 1, info->mipmaps);
 }
 
+// Changes the levels of a streaming texture that are resident.  The texture only ever allocates
+// the resident levels, so every change allocates a new texture with the new range of levels.
+// Levels that stay resident are copied over from the old texture on the GPU, and levels that are
+// becoming resident are uploaded from the Image, after which the Image can let go of their pages.
+// The new texture is copied over the texture's gpu struct, so anything referring to the texture's
+// gpu pointer sees the new levels.  The old texture gets condemned as usual.
+static bool setResidentLevel(Texture* texture, uint32_t level) {
+  TextureResidency* residency = texture->residency;
+  TextureInfo* info = &texture->info;
+  uint32_t previous = residency->level;
+  bool initialized = previous < info->mipmaps;
+
+  // The first texture initializes the texture's own gpu struct, later ones need a temporary one
+  gpu_texture* gpu = initialized ? tempAlloc(gpu_sizeof_texture()) : texture->gpu;
+
+  bool success = gpu_texture_init(gpu, &(gpu_texture_info) {
+    .type = (gpu_texture_type) info->type,
+    .format = (gpu_texture_format) info->format,
+    .size = { MAX(info->width >> level, 1), MAX(info->height >> level, 1), info->layers },
+    .mipmaps = info->mipmaps - level,
+    .samples = 1,
+    .usage = GPU_TEXTURE_SAMPLE | GPU_TEXTURE_COPY_SRC | GPU_TEXTURE_COPY_DST,
+    .srgb = info->srgb,
+    .label = info->label,
+    .upload.stream = state.stream
+  });
+
+  if (!success) {
+    return false;
+  }
+
+  // Levels uploaded or copied into the old texture have to land before they're copied out of it
+  gpu_sync(state.stream, &(gpu_barrier) {
+    .prev = GPU_PHASE_TRANSFER,
+    .next = GPU_PHASE_TRANSFER,
+    .flush = GPU_CACHE_TRANSFER_WRITE,
+    .clear = GPU_CACHE_TRANSFER_READ | GPU_CACHE_TRANSFER_WRITE
+  }, 1);
+
+  for (uint32_t i = MAX(level, previous); initialized && i < info->mipmaps; i++) {
+    uint32_t srcOffset[4] = { 0, 0, 0, i - previous };
+    uint32_t dstOffset[4] = { 0, 0, 0, i - level };
+    uint32_t extent[3] = { MAX(info->width >> i, 1), MAX(info->height >> i, 1), info->layers };
+    gpu_copy_textures(state.stream, texture->gpu, gpu, srcOffset, dstOffset, extent);
+  }
+
+  if (level < previous) {
+    uint32_t total = 0;
+    for (uint32_t i = level; i < previous; i++) {
+      total += (uint32_t) lovrImageGetLayerSize(residency->image, i) * info->layers;
+    }
+
+    gpu_buffer* scratchpad = tempAlloc(gpu_sizeof_buffer());
+    char* data = gpu_map(scratchpad, total, 64, GPU_MAP_STAGING);
+
+    uint32_t offset = 0;
+    for (uint32_t i = level; i < previous; i++) {
+      size_t size = lovrImageGetLayerSize(residency->image, i);
+      for (uint32_t layer = 0; layer < info->layers; layer++) {
+        memcpy(data + offset + layer * size, lovrImageGetLayerData(residency->image, i, layer), size);
+      }
+
+      uint32_t dstOffset[4] = { 0, 0, 0, i - level };
+      uint32_t extent[3] = { MAX(info->width >> i, 1), MAX(info->height >> i, 1), info->layers };
+      gpu_copy_buffer_texture(state.stream, scratchpad, gpu, offset, dstOffset, extent);
+      offset += (uint32_t) size * info->layers;
+
+      // Once a level is resident it's only ever copied on the GPU, it won't be read again unless
+      // it gets evicted, and then it's paged back in from the file
+      lovrImageReleaseLevel(residency->image, i);
+    }
+  }
+
+  state.hasTextureUpload = true;
+
+  if (initialized) {
+    gpu_texture_destroy(texture->gpu);
+    memcpy(texture->gpu, gpu, gpu_sizeof_texture());
+  }
+
+  size_t memory = 0;
+  for (uint32_t i = level; i < info->mipmaps; i++) {
+    memory += measureTexture(info->format, MAX(info->width >> i, 1), MAX(info->height >> i, 1), info->layers);
+  }
+
+  state.streaming.memory -= residency->memory;
+  state.streaming.memory += memory;
+  residency->memory = memory;
+  residency->level = level;
+  return true;
+}
+
 static void mipmapTexture(gpu_stream* stream, Texture* texture, uint32_t base, uint32_t count) {
   if (count == ~0u) count = texture->info.mipmaps - (base + 1);
   bool volumetric = texture->info.type == TEXTURE_3D;
@@ -5814,6 +6095,12 @@ static void trackTexture(Pass* pass, Texture* texture, gpu_phase phase, gpu_cach
   lovrRetain(texture);
 }
 
+static void touchTexture(Texture* texture) {
+  if (texture && texture->residency) {
+    texture->residency->lastUse = state.tick;
+  }
+}
+
 static void trackMaterial(Pass* pass, Material* material, gpu_phase phase, gpu_cache cache) {
   if (!material->hasWritableTexture) {
     return;
@@ -5828,6 +6115,68 @@ static void trackMaterial(Pass* pass, Material* material, gpu_phase phase, gpu_c
   trackTexture(pass, material->info.normalTexture, phase, cache);
 }
 
+static void writeMaterialBundle(Material* material, gpu_bundle* bundle) {
+  MaterialBlock* block = &state.materialBlocks.data[material->block];
+  uint32_t stride = ALIGN(sizeof(MaterialData), state.limits.uniformBufferAlign);
+
+  gpu_buffer_binding buffer = {
+    .object = block->buffer,
+    .offset = material->index * stride,
+    .extent = stride
+  };
+
+  gpu_binding bindings[8] = {
+    { 0, GPU_SLOT_UNIFORM_BUFFER, .buffer = buffer }
+  };
+
+  Texture* textures[] = {
+    material->info.texture,
+    material->info.glowTexture,
+    material->info.metalnessTexture,
+    material->info.roughnessTexture,
+    material->info.clearcoatTexture,
+    material->info.occlusionTexture,
+    material->info.normalTexture
+  };
+
+  for (uint32_t i = 0; i < COUNTOF(textures); i++) {
+    Texture* texture = textures[i] ? textures[i] : state.defaultTexture;
+    bindings[i + 1] = (gpu_binding) { i + 1, GPU_SLOT_SAMPLED_TEXTURE, .texture = texture->gpu };
+  }
+
+  gpu_bundle_info bundleInfo = {
+    .layout = state.layouts.data[state.materialLayout].gpu,
+    .bindings = bindings,
+    .count = COUNTOF(bindings)
+  };
+
+  gpu_bundle_write(&bundle, &bundleInfo, 1);
+}
+
+// Bundles can't be rewritten while the GPU is using them, so materials with streaming textures get
+// a fresh bundle each frame that uses the textures' current images.
+static gpu_bundle* getMaterialBundle(Material* material) {
+  if (!material->hasStreamingTexture) {
+    return material->bundle;
+  }
+
+  touchTexture(material->info.texture);
+  touchTexture(material->info.glowTexture);
+  touchTexture(material->info.metalnessTexture);
+  touchTexture(material->info.roughnessTexture);
+  touchTexture(material->info.clearcoatTexture);
+  touchTexture(material->info.occlusionTexture);
+  touchTexture(material->info.normalTexture);
+
+  if (!material->streamBundle || material->streamTick != state.tick) {
+    material->streamBundle = getBundle(state.materialLayout);
+    material->streamTick = state.tick;
+    writeMaterialBundle(material, material->streamBundle);
+  }
+
+  return material->streamBundle;
+}
+
 static void updateModelTransforms(Model* model, uint32_t nodeIndex, float* parent) {
   mat4 global = model->globalTransforms + 16 * nodeIndex;
   NodeTransform* local = &model->localTransforms[nodeIndex];
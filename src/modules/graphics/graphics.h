@@ -25,6 +25,7 @@ typedef struct {
   bool vsync;
   bool stencil;
   bool antialias;
+  size_t streamingBudget;
   void* cacheData;
   size_t cacheSize;
 } GraphicsConfig;
@@ -179,6 +180,7 @@ const BufferInfo* lovrBufferGetInfo(Buffer* buffer);
 bool lovrBufferIsTemporary(Buffer* buffer);
 bool lovrBufferIsValid(Buffer* buffer);
 void* lovrBufferMap(Buffer* buffer, uint32_t offset, uint32_t size);
+void* lovrBufferSetData(Buffer* buffer, uint32_t offset, uint32_t size);
 void lovrBufferClear(Buffer* buffer, uint32_t offset, uint32_t size);
 
 // Texture
@@ -218,17 +220,33 @@ typedef struct {
   uint32_t usage;
   bool srgb;
   bool xr;
+  bool streaming;
   uintptr_t handle;
   uint32_t imageCount;
   struct Image** images;
   const char* label;
 } TextureInfo;
 
+typedef struct {
+  size_t budget;
+  size_t memory;
+  uint32_t textureCount;
+  uint32_t residentLevels;
+  uint32_t uploads;
+  uint32_t evictions;
+} StreamingStats;
+
 Texture* lovrGraphicsGetWindowTexture(void);
+size_t lovrGraphicsGetStreamingBudget(void);
+void lovrGraphicsSetStreamingBudget(size_t budget);
+void lovrGraphicsGetStreamingStats(StreamingStats* stats);
 Texture* lovrTextureCreate(const TextureInfo* info);
 Texture* lovrTextureCreateView(const TextureViewInfo* view);
 void lovrTextureDestroy(void* ref);
 const TextureInfo* lovrTextureGetInfo(Texture* texture);
+uint32_t lovrTextureGetResidentLevel(Texture* texture);
+uint32_t lovrTextureGetMinResidentLevel(Texture* texture);
+void lovrTextureSetMinResidentLevel(Texture* texture, uint32_t level);
 
 // Sampler
 
@@ -1,17 +1,71 @@
 #include "physics.h"
+#include "core/job.h"
 #include "core/maf.h"
+#include "core/os.h"
 #include "util.h"
+#include "lib/tinycthread/tinycthread.h"
 #include <ode/ode.h>
 #include <stdlib.h>
 
+typedef struct {
+  uint64_t hash;
+  Shape* a;
+  Shape* b;
+  float position[3];
+  float normal[3];
+  float depth;
+  float impulse;
+  bool seen;
+} ContactPair;
+
+typedef struct {
+  dReal aabb[6];
+  dGeomID geom;
+} CullBounds;
+
+// A pair of shapes found by the broadphase, and the contacts the narrowphase found for them
+typedef struct {
+  Shape* a;
+  Shape* b;
+  dContactGeom* contacts;
+  int count;
+  bool serial;
+} CollisionPair;
+
 struct World {
   uint32_t ref;
   dWorldID id;
   dSpaceID space;
+  BroadphaseType broadphase;
+  dThreadingImplementationID threading;
+  dThreadingThreadPoolID threadPool;
+  uint32_t threadCount;
   dJointGroupID contactGroup;
   arr_t(Shape*) overlaps;
+  arr_t(CollisionPair) collisions;
+  arr_t(dContactGeom) contactGeoms;
+  uint32_t shapeCount;
+  arr_t(Shape*) queryResults;
   char* tags[MAX_TAGS];
-  uint16_t masks[MAX_TAGS];
+  uint32_t masks[MAX_TAGS];
+  CollisionStats stats;
+  StepTimings timings;
+  arr_t(CullBounds) cullBounds;
+  bool countCulledPairs;
+  float timestep;
+  uint32_t maxSubsteps;
+  double accumulator;
+  ContactEvent* events;
+  uint32_t eventCapacity;
+  uint32_t eventHead;
+  uint32_t eventCount;
+  arr_t(ContactPair) pairs;
+  arr_t(ContactPair) newPairs;
+  map_t pairMap;
+  map_t newPairMap;
+  arr_t(dJointID) contactJoints;
+  arr_t(uint32_t) contactJointPairs;
+  arr_t(dJointFeedback) feedback;
   Collider* head;
 };
 
@@ -27,16 +81,31 @@ struct Collider {
   arr_t(Joint*) joints;
   float friction;
   float restitution;
+  float previousPosition[4];
+  float previousOrientation[4];
 };
 
+// Triangle data and the trimesh's collision tree, shared by every MeshShape created from the same
+// source.  Vertices and indices are either owned or live inside the retained source object.
+typedef struct {
+  uint32_t ref;
+  dTriMeshDataID id;
+  float* vertices;
+  uint32_t* indices;
+  uint32_t vertexCount;
+  uint32_t indexCount;
+  void* source;
+  void (*destructor)(void*);
+} MeshData;
+
 struct Shape {
   uint32_t ref;
   ShapeType type;
   dGeomID id;
   Collider* collider;
-  void* vertices;
-  void* indices;
+  MeshData* mesh;
   void* userdata;
+  uint32_t order;
   bool sensor;
 };
 
@@ -47,8 +116,15 @@ struct Joint {
   void* userdata;
 };
 
+// Pairs are stored with the shape that was added first as a, see narrowphase
 static void defaultNearCallback(void* data, dGeomID a, dGeomID b) {
-  lovrWorldCollide((World*) data, dGeomGetData(a), dGeomGetData(b), -1, -1);
+  World* world = data;
+  Shape* shapeA = dGeomGetData(a);
+  Shape* shapeB = dGeomGetData(b);
+  arr_expand(&world->collisions, 1);
+  CollisionPair* pair = &world->collisions.data[world->collisions.length++];
+  pair->a = shapeA->order < shapeB->order ? shapeA : shapeB;
+  pair->b = shapeA->order < shapeB->order ? shapeB : shapeA;
 }
 
 static void customNearCallback(void* data, dGeomID shapeA, dGeomID shapeB) {
@@ -79,6 +155,298 @@ static void raycastCallback(void* data, dGeomID a, dGeomID b) {
   }
 }
 
+typedef struct {
+  RaycastHit* hit;
+  bool any;
+} RaycastQuery;
+
+static void raycastQueryCallback(void* data, dGeomID a, dGeomID b) {
+  RaycastQuery* query = data;
+  RaycastHit* hit = query->hit;
+  Shape* shape = dGeomGetData(b);
+
+  if (!shape || (query->any && hit->shape)) {
+    return;
+  }
+
+  dContactGeom contact;
+  int flags = query->any ? (1 | CONTACTS_UNIMPORTANT) : 1;
+  if (dCollide(a, b, flags, &contact, sizeof(contact)) > 0 && (!hit->shape || contact.depth < hit->distance)) {
+    hit->shape = shape;
+    hit->position[0] = contact.pos[0];
+    hit->position[1] = contact.pos[1];
+    hit->position[2] = contact.pos[2];
+    hit->normal[0] = contact.normal[0];
+    hit->normal[1] = contact.normal[1];
+    hit->normal[2] = contact.normal[2];
+    hit->distance = contact.depth;
+  }
+}
+
+typedef struct {
+  World* world;
+  uint32_t tagMask;
+  Collider* ignore;
+  Shape* shape;
+  dContactGeom contact;
+} QueryData;
+
+static bool queryFilter(QueryData* query, Shape* shape) {
+  if (!shape || !shape->collider || shape->collider == query->ignore) {
+    return false;
+  }
+
+  uint32_t tag = shape->collider->tag;
+  return query->tagMask == ~0u || (tag != NO_TAG && (query->tagMask & (1u << tag)));
+}
+
+static void queryCallback(void* data, dGeomID a, dGeomID b) {
+  QueryData* query = data;
+  Shape* shape = dGeomGetData(b);
+  dContactGeom contact;
+
+  if (queryFilter(query, shape) && dCollide(a, b, 1 | CONTACTS_UNIMPORTANT, &contact, sizeof(contact)) > 0) {
+    arr_push(&query->world->queryResults, shape);
+  }
+}
+
+static void sweepCallback(void* data, dGeomID a, dGeomID b) {
+  QueryData* query = data;
+  Shape* shape = dGeomGetData(b);
+
+  if (!query->shape && queryFilter(query, shape) && dCollide(a, b, 1, &query->contact, sizeof(dContactGeom)) > 0) {
+    query->shape = shape;
+  }
+}
+
+static Shape** queryGeom(World* world, dGeomID geom, uint32_t tagMask, uint32_t* count) {
+  QueryData query = { .world = world, .tagMask = tagMask };
+  arr_clear(&world->queryResults);
+  dSpaceCollide2(geom, (dGeomID) world->space, &query, queryCallback);
+  dGeomDestroy(geom);
+  *count = (uint32_t) world->queryResults.length;
+  return world->queryResults.data;
+}
+
+static bool sweepTest(QueryData* query, dGeomID geom, float start[3], float delta[3], float t) {
+  query->shape = NULL;
+  dGeomSetPosition(geom, start[0] + delta[0] * t, start[1] + delta[1] * t, start[2] + delta[2] * t);
+  dSpaceCollide2(geom, (dGeomID) query->world->space, query, sweepCallback);
+  return query->shape;
+}
+
+// Tag filtering happens in the broadphase using the category/collide bits of each geom.  A pair is
+// only reported when (categoryA & collideB) || (categoryB & collideA), which matches the tag masks
+// since they are always symmetric.  Untagged geoms use all bits so they collide with everything.
+static void updateCollisionBits(Collider* collider) {
+  uint32_t tag = collider->tag;
+  unsigned long category = tag == NO_TAG ? ~0ul : (1ul << tag);
+  unsigned long collide = tag == NO_TAG ? ~0ul : collider->world->masks[tag];
+  for (dGeomID geom = dBodyGetFirstGeom(collider->body); geom; geom = dBodyGetNextGeom(geom)) {
+    dGeomSetCategoryBits(geom, category);
+    dGeomSetCollideBits(geom, collide);
+  }
+}
+
+static void updateTagCollisionBits(World* world, uint32_t i, uint32_t j) {
+  for (Collider* collider = world->head; collider; collider = collider->next) {
+    if (collider->tag == i || collider->tag == j) {
+      updateCollisionBits(collider);
+    }
+  }
+}
+
+static int compareCullBounds(const void* a, const void* b) {
+  dReal x = ((const CullBounds*) a)->aabb[0];
+  dReal y = ((const CullBounds*) b)->aabb[0];
+  return (x > y) - (x < y);
+}
+
+// ODE checks the category/collide bits before the bounds and drops mismatched pairs silently.  To
+// count them, this redoes the broadphase with a sort and sweep on x over the bounds ODE computed,
+// counting pairs that overlap but that the bits rule out.  Like ODE, geoms on the same body and
+// disabled geoms are skipped.
+static void countCulledPairs(World* world) {
+  int count = dSpaceGetNumGeoms(world->space);
+  arr_clear(&world->cullBounds);
+  arr_reserve(&world->cullBounds, (size_t) count);
+
+  for (int i = 0; i < count; i++) {
+    dGeomID geom = dSpaceGetGeom(world->space, i);
+    if (dGeomIsEnabled(geom)) {
+      CullBounds* bounds = &world->cullBounds.data[world->cullBounds.length++];
+      dGeomGetAABB(geom, bounds->aabb);
+      bounds->geom = geom;
+    }
+  }
+
+  CullBounds* bounds = world->cullBounds.data;
+  size_t length = world->cullBounds.length;
+  qsort(bounds, length, sizeof(CullBounds), compareCullBounds);
+
+  for (size_t i = 0; i < length; i++) {
+    dReal* p = bounds[i].aabb;
+    dGeomID a = bounds[i].geom;
+    for (size_t j = i + 1; j < length && bounds[j].aabb[0] <= p[1]; j++) {
+      dReal* q = bounds[j].aabb;
+      dGeomID b = bounds[j].geom;
+
+      if (q[2] > p[3] || q[3] < p[2] || q[4] > p[5] || q[5] < p[4]) {
+        continue;
+      }
+
+      dBodyID body = dGeomGetBody(a);
+      if (body && body == dGeomGetBody(b)) {
+        continue;
+      }
+
+      if (!(dGeomGetCategoryBits(a) & dGeomGetCollideBits(b)) && !(dGeomGetCategoryBits(b) & dGeomGetCollideBits(a))) {
+        world->stats.pairsCulled++;
+      }
+    }
+  }
+}
+
+// Contact events
+
+static void pushContactEvent(World* world, ContactEventType type, ContactPair* pair) {
+  // When the ring is full the oldest event is overwritten
+  if (world->eventCount == world->eventCapacity) {
+    ContactEvent* oldest = &world->events[world->eventHead];
+    lovrRelease(oldest->a, lovrShapeDestroy);
+    lovrRelease(oldest->b, lovrShapeDestroy);
+    world->eventHead = (world->eventHead + 1) % world->eventCapacity;
+    world->eventCount--;
+    world->stats.eventsDropped++;
+  }
+
+  ContactEvent* event = &world->events[(world->eventHead + world->eventCount++) % world->eventCapacity];
+  event->type = type;
+  event->a = pair->a;
+  event->b = pair->b;
+  memcpy(event->position, pair->position, sizeof(event->position));
+  memcpy(event->normal, pair->normal, sizeof(event->normal));
+  event->depth = pair->depth;
+  event->impulse = pair->impulse;
+  lovrRetain(pair->a);
+  lovrRetain(pair->b);
+}
+
+// Records a touching pair for this step, keeping the deepest contact point.  The pair is keyed by
+// its shapes regardless of order, so colliding the same pair twice in a step only tracks it once.
+static uint32_t trackContactPair(World* world, Shape* a, Shape* b, dContactGeom* contacts, int count) {
+  Shape* key[2] = { MIN(a, b), MAX(a, b) };
+  uint64_t hash = hash64(key, sizeof(key));
+  uint64_t index = map_get(&world->newPairMap, hash);
+
+  if (index != MAP_NIL) {
+    return (uint32_t) index;
+  }
+
+  int deepest = 0;
+  for (int i = 1; i < count; i++) {
+    if (contacts[i].depth > contacts[deepest].depth) {
+      deepest = i;
+    }
+  }
+
+  dContactGeom* contact = &contacts[deepest];
+  ContactPair pair = {
+    .hash = hash,
+    .a = a,
+    .b = b,
+    .position = { contact->pos[0], contact->pos[1], contact->pos[2] },
+    .normal = { contact->normal[0], contact->normal[1], contact->normal[2] },
+    .depth = contact->depth
+  };
+
+  lovrRetain(a);
+  lovrRetain(b);
+  index = world->newPairs.length;
+  arr_push(&world->newPairs, pair);
+  map_set(&world->newPairMap, hash, index);
+  return (uint32_t) index;
+}
+
+// Diffs this step's touching pairs against the last step's to produce begin/persist/end events,
+// then makes this step's pairs the new baseline.  Impulses come from the contact joint feedback.
+static void flushContactEvents(World* world, float dt) {
+  if (dt > 0.f) {
+    for (size_t i = 0; i < world->contactJoints.length; i++) {
+      ContactPair* pair = &world->newPairs.data[world->contactJointPairs.data[i]];
+      dReal* force = world->feedback.data[i].f1;
+      pair->impulse += (force[0] * pair->normal[0] + force[1] * pair->normal[1] + force[2] * pair->normal[2]) * dt;
+    }
+  }
+
+  for (size_t i = 0; i < world->newPairs.length; i++) {
+    ContactPair* pair = &world->newPairs.data[i];
+    uint64_t previous = map_get(&world->pairMap, pair->hash);
+
+    if (previous == MAP_NIL) {
+      pushContactEvent(world, CONTACT_BEGIN, pair);
+    } else {
+      world->pairs.data[previous].seen = true;
+      pushContactEvent(world, CONTACT_PERSIST, pair);
+    }
+  }
+
+  for (size_t i = 0; i < world->pairs.length; i++) {
+    ContactPair* pair = &world->pairs.data[i];
+
+    if (!pair->seen) {
+      ContactPair end = { .a = pair->a, .b = pair->b };
+      pushContactEvent(world, CONTACT_END, &end);
+    }
+
+    lovrRelease(pair->a, lovrShapeDestroy);
+    lovrRelease(pair->b, lovrShapeDestroy);
+  }
+
+  arr_clear(&world->pairs);
+  arr_append(&world->pairs, world->newPairs.data, world->newPairs.length);
+  arr_clear(&world->newPairs);
+
+  map_t map = world->pairMap;
+  world->pairMap = world->newPairMap;
+  world->newPairMap = map;
+  map_free(&world->newPairMap);
+  map_init(&world->newPairMap, (uint32_t) world->pairs.length);
+
+  arr_clear(&world->contactJoints);
+  arr_clear(&world->contactJointPairs);
+}
+
+static void clearContactEvents(World* world) {
+  while (world->eventCount > 0) {
+    ContactEvent* event = &world->events[world->eventHead];
+    lovrRelease(event->a, lovrShapeDestroy);
+    lovrRelease(event->b, lovrShapeDestroy);
+    world->eventHead = (world->eventHead + 1) % world->eventCapacity;
+    world->eventCount--;
+  }
+
+  for (size_t i = 0; i < world->pairs.length; i++) {
+    lovrRelease(world->pairs.data[i].a, lovrShapeDestroy);
+    lovrRelease(world->pairs.data[i].b, lovrShapeDestroy);
+  }
+
+  for (size_t i = 0; i < world->newPairs.length; i++) {
+    lovrRelease(world->newPairs.data[i].a, lovrShapeDestroy);
+    lovrRelease(world->newPairs.data[i].b, lovrShapeDestroy);
+  }
+
+  arr_clear(&world->pairs);
+  arr_clear(&world->newPairs);
+  arr_clear(&world->contactJoints);
+  arr_clear(&world->contactJointPairs);
+  map_free(&world->pairMap);
+  map_free(&world->newPairMap);
+  map_init(&world->pairMap, 0);
+  map_init(&world->newPairMap, 0);
+  world->eventHead = 0;
+}
+
 // XXX slow, but probably fine (tag names are not on any critical path), could switch to hashing if needed
 static uint32_t findTag(World* world, const char* name) {
   for (uint32_t i = 0; i < MAX_TAGS && world->tags[i]; i++) {
@@ -108,9 +476,13 @@ static void onInfoMessage(int num, const char* format, va_list args) {
 }
 
 static bool initialized = false;
+static map_t meshCache;
+static mtx_t meshCacheLock;
 
 bool lovrPhysicsInit() {
   if (initialized) return false;
+  map_init(&meshCache, 0);
+  mtx_init(&meshCacheLock, mtx_plain);
   dInitODE();
   dSetErrorHandler(onErrorMessage);
   dSetDebugHandler(onDebugMessage);
@@ -120,19 +492,66 @@ bool lovrPhysicsInit() {
 
 void lovrPhysicsDestroy() {
   if (!initialized) return;
+  map_free(&meshCache);
+  mtx_destroy(&meshCacheLock);
   dCloseODE();
   initialized = false;
 }
 
-World* lovrWorldCreate(float xg, float yg, float zg, bool allowSleep, const char** tags, uint32_t tagCount) {
+World* lovrWorldCreate(float xg, float yg, float zg, bool allowSleep, const char** tags, uint32_t tagCount, BroadphaseInfo* broadphase, uint32_t threadCount) {
   World* world = calloc(1, sizeof(World));
   lovrAssert(world, "Out of memory");
   world->ref = 1;
   world->id = dWorldCreate();
-  world->space = dHashSpaceCreate(0);
-  dHashSpaceSetLevels(world->space, -4, 8);
+  world->broadphase = broadphase->type;
+  switch (broadphase->type) {
+    case BROADPHASE_HASH:
+      world->space = dHashSpaceCreate(0);
+      dHashSpaceSetLevels(world->space, -4, 8);
+      break;
+    case BROADPHASE_SAP:
+      // Y is up, so sort along the horizontal axes first
+      world->space = dSweepAndPruneSpaceCreate(0, dSAP_AXES_XZY);
+      break;
+    case BROADPHASE_QUADTREE: {
+      dVector3 center = { broadphase->center[0], broadphase->center[1], broadphase->center[2] };
+      dVector3 extents = { broadphase->extents[0], broadphase->extents[1], broadphase->extents[2] };
+      world->space = dQuadTreeSpaceCreate(0, center, extents, broadphase->depth);
+      break;
+    }
+    case BROADPHASE_SIMPLE:
+      world->space = dSimpleSpaceCreate(0);
+      break;
+    default: lovrUnreachable();
+  }
   world->contactGroup = dJointGroupCreate(0);
+  world->threadCount = MAX(threadCount, 1);
+  if (threadCount > 1) {
+    // Islands are solved in parallel by a pool of worker threads, and the narrowphase is split up
+    // with job_run.  The broadphase stays on the calling thread, since spaces aren't threadsafe.
+    world->threading = dThreadingAllocateMultiThreadedImplementation();
+    if (world->threading) {
+      world->threadPool = dThreadingAllocateThreadPool(threadCount, 0, dAllocateFlagBasicData, NULL);
+      lovrAssert(world->threadPool, "Failed to create physics thread pool");
+      dThreadingThreadPoolServeMultiThreadedImplementation(world->threadPool, world->threading);
+      dWorldSetStepThreadingImplementation(world->id, dThreadingImplementationGetFunctions(world->threading), world->threading);
+      dWorldSetStepIslandsProcessingMaxThreadCount(world->id, threadCount);
+    } else {
+      lovrLog(LOG_WARN, "PHY", "ODE was built without threading support, islands will be solved on one thread");
+    }
+  }
   arr_init(&world->overlaps, arr_alloc);
+  arr_init(&world->collisions, arr_alloc);
+  arr_init(&world->contactGeoms, arr_alloc);
+  arr_init(&world->queryResults, arr_alloc);
+  arr_init(&world->pairs, arr_alloc);
+  arr_init(&world->newPairs, arr_alloc);
+  arr_init(&world->contactJoints, arr_alloc);
+  arr_init(&world->contactJointPairs, arr_alloc);
+  arr_init(&world->feedback, arr_alloc);
+  arr_init(&world->cullBounds, arr_alloc);
+  map_init(&world->pairMap, 0);
+  map_init(&world->newPairMap, 0);
   lovrWorldSetGravity(world, xg, yg, zg);
   lovrWorldSetSleepingAllowed(world, allowSleep);
   for (uint32_t i = 0; i < tagCount; i++) {
@@ -148,13 +567,75 @@ void lovrWorldDestroy(void* ref) {
   World* world = ref;
   lovrWorldDestroyData(world);
   arr_free(&world->overlaps);
+  arr_free(&world->collisions);
+  arr_free(&world->contactGeoms);
+  arr_free(&world->queryResults);
+  arr_free(&world->pairs);
+  arr_free(&world->newPairs);
+  arr_free(&world->contactJoints);
+  arr_free(&world->contactJointPairs);
+  arr_free(&world->feedback);
+  arr_free(&world->cullBounds);
+  map_free(&world->pairMap);
+  map_free(&world->newPairMap);
+  free(world->events);
   for (uint32_t i = 0; i < MAX_TAGS && world->tags[i]; i++) {
     free(world->tags[i]);
   }
   free(world);
 }
 
+BroadphaseType lovrWorldGetBroadphase(World* world) {
+  return world->broadphase;
+}
+
+uint32_t lovrWorldGetThreadCount(World* world) {
+  return world->threadCount;
+}
+
+void lovrWorldGetCollisionStats(World* world, CollisionStats* stats) {
+  *stats = world->stats;
+}
+
+bool lovrWorldIsCountingCulledPairs(World* world) {
+  return world->countCulledPairs;
+}
+
+void lovrWorldSetCountingCulledPairs(World* world, bool enable) {
+  world->countCulledPairs = enable;
+}
+
+void lovrWorldGetStepTimings(World* world, StepTimings* timings) {
+  *timings = world->timings;
+}
+
+uint32_t lovrWorldGetContactEventCapacity(World* world) {
+  return world->eventCapacity;
+}
+
+// Changing the capacity discards any pending events and resets contact tracking
+void lovrWorldSetContactEventCapacity(World* world, uint32_t capacity) {
+  clearContactEvents(world);
+  world->events = realloc(world->events, capacity * sizeof(ContactEvent));
+  lovrAssert(!capacity || world->events, "Out of memory");
+  world->eventCapacity = capacity;
+}
+
+// The caller takes ownership of the references to the event's shapes
+bool lovrWorldPollContactEvent(World* world, ContactEvent* event) {
+  if (world->eventCount == 0) {
+    return false;
+  }
+
+  *event = world->events[world->eventHead];
+  world->eventHead = (world->eventHead + 1) % world->eventCapacity;
+  world->eventCount--;
+  return true;
+}
+
 void lovrWorldDestroyData(World* world) {
+  clearContactEvents(world);
+
   while (world->head) {
     Collider* next = world->head->next;
     lovrColliderDestroyData(world->head);
@@ -166,6 +647,15 @@ void lovrWorldDestroyData(World* world) {
     world->contactGroup = NULL;
   }
 
+  if (world->threading) {
+    dThreadingImplementationShutdownProcessing(world->threading);
+    dThreadingFreeThreadPool(world->threadPool);
+    dWorldSetStepThreadingImplementation(world->id, NULL, NULL);
+    dThreadingFreeImplementation(world->threading);
+    world->threadPool = NULL;
+    world->threading = NULL;
+  }
+
   if (world->space) {
     dSpaceDestroy(world->space);
     world->space = NULL;
@@ -177,20 +667,241 @@ void lovrWorldDestroyData(World* world) {
   }
 }
 
-void lovrWorldUpdate(World* world, float dt, CollisionResolver resolver, void* userdata) {
+static void savePreviousPoses(World* world) {
+  for (Collider* collider = world->head; collider; collider = collider->next) {
+    const dReal* p = dBodyGetPosition(collider->body);
+    const dReal* q = dBodyGetQuaternion(collider->body);
+    vec3_set(collider->previousPosition, p[0], p[1], p[2]);
+    quat_set(collider->previousOrientation, q[1], q[2], q[3], q[0]);
+  }
+}
+
+// With a fixed timestep, poses are interpolated between the last two steps using the leftover time
+static void getInterpolatedPose(Collider* collider, float position[4], float orientation[4]) {
+  World* world = collider->world;
+  const dReal* p = dBodyGetPosition(collider->body);
+  const dReal* q = dBodyGetQuaternion(collider->body);
+
+  if (world->timestep > 0.f) {
+    float alpha = (float) (world->accumulator / world->timestep);
+    float current[4] = { p[0], p[1], p[2], 0.f };
+    vec3_init(position, collider->previousPosition);
+    vec3_lerp(position, current, alpha);
+    quat_init(orientation, collider->previousOrientation);
+    quat_slerp(orientation, quat_set(current, q[1], q[2], q[3], q[0]), alpha);
+  } else {
+    vec3_set(position, p[0], p[1], p[2]);
+    position[3] = 0.f;
+    quat_set(orientation, q[1], q[2], q[3], q[0]);
+  }
+}
+
+// Narrowphase
+
+static bool filterPair(World* world, Shape* a, Shape* b) {
+  uint32_t i = a->collider->tag;
+  uint32_t j = b->collider->tag;
+
+  world->stats.pairsOverlapping++;
+
+  // The broadphase already filters by tag, but custom resolvers can pass any pair of shapes
+  if (i != NO_TAG && j != NO_TAG && !((world->masks[i] & (1u << j)) && (world->masks[j] & (1u << i)))) {
+    world->stats.pairsRejected++;
+    return false;
+  }
+
+  return true;
+}
+
+// Turns the contacts of a pair into contact joints, and tracks the pair for contact events
+static int addContacts(World* world, CollisionPair* pair, float friction, float restitution) {
+  Collider* colliderA = pair->a->collider;
+  Collider* colliderB = pair->b->collider;
+  int contactCount = pair->count;
+
+  if (contactCount <= 0) {
+    return 0;
+  }
+
+  if (friction < 0.f) {
+    friction = sqrtf(colliderA->friction * colliderB->friction);
+  }
+
+  if (restitution < 0.f) {
+    restitution = MAX(colliderA->restitution, colliderB->restitution);
+  }
+
+  world->stats.pairsAccepted++;
+  world->stats.contacts += contactCount;
+
+  bool events = world->eventCapacity > 0;
+  uint32_t index = events ? trackContactPair(world, pair->a, pair->b, pair->contacts, contactCount) : 0;
+
+  if (!pair->a->sensor && !pair->b->sensor) {
+    for (int c = 0; c < contactCount; c++) {
+      dContact contact = { .geom = pair->contacts[c] };
+      contact.surface.mode = restitution > 0 ? dContactBounce : 0;
+      contact.surface.mu = friction;
+      contact.surface.bounce = restitution;
+
+      dJointID joint = dJointCreateContact(world->id, world->contactGroup, &contact);
+      dJointAttach(joint, colliderA->body, colliderB->body);
+
+      if (events) {
+        arr_push(&world->contactJoints, joint);
+        arr_push(&world->contactJointPairs, index);
+      }
+    }
+  }
+
+  return contactCount;
+}
+
+#define NARROWPHASE_BATCH 64
+
+static int comparePairs(const void* a, const void* b) {
+  const CollisionPair* p = a;
+  const CollisionPair* q = b;
+  if (p->a->order != q->a->order) return p->a->order < q->a->order ? -1 : 1;
+  return (p->b->order > q->b->order) - (p->b->order < q->b->order);
+}
+
+static void collideBatch(void* context, uint32_t index) {
+  World* world = context;
+  size_t start = (size_t) index * NARROWPHASE_BATCH;
+  size_t end = MIN(start + NARROWPHASE_BATCH, world->collisions.length);
+  for (size_t i = start; i < end; i++) {
+    CollisionPair* pair = &world->collisions.data[i];
+    if (!pair->serial) {
+      pair->count = dCollide(pair->a->id, pair->b->id, MAX_CONTACTS, pair->contacts, sizeof(dContactGeom));
+    }
+  }
+}
+
+// Collides the pairs the broadphase found.  The order the broadphase reports pairs in depends on
+// the history of its internal lists, so pairs are sorted by the order their shapes were added first.
+// Contact joints are then created in the same order whenever the bodies are in the same state,
+// which makes restoring a snapshot deterministic.  With more than one thread, batches of pairs are
+// collided on worker threads, since the colliders for the primitive shapes only read the geoms
+// (the broadphase has already updated their poses and bounds).  Pairs with a mesh or terrain stay
+// on this thread: ODE's trimesh colliders share a cache and heightfields keep scratch buffers in
+// the geom.  Contact joints are created afterwards, in broadphase order on this thread, so the
+// simulation doesn't depend on the thread count.
+static void narrowphase(World* world) {
+  size_t count = world->collisions.length;
+  qsort(world->collisions.data, count, sizeof(CollisionPair), comparePairs);
+  arr_reserve(&world->contactGeoms, count * MAX_CONTACTS);
+
+  for (size_t i = 0; i < count; i++) {
+    CollisionPair* pair = &world->collisions.data[i];
+    ShapeType typeA = pair->a->type;
+    ShapeType typeB = pair->b->type;
+    pair->contacts = world->contactGeoms.data + i * MAX_CONTACTS;
+    pair->count = filterPair(world, pair->a, pair->b) ? 0 : -1;
+    pair->serial = typeA == SHAPE_MESH || typeA == SHAPE_TERRAIN || typeB == SHAPE_MESH || typeB == SHAPE_TERRAIN;
+  }
+
+  bool parallel = world->threadCount > 1 && count > NARROWPHASE_BATCH;
+
+  if (parallel) {
+    uint32_t batches = (uint32_t) ((count + NARROWPHASE_BATCH - 1) / NARROWPHASE_BATCH);
+    job_run(collideBatch, world, batches, world->threadCount);
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    CollisionPair* pair = &world->collisions.data[i];
+    if (pair->count == 0 && (pair->serial || !parallel)) {
+      pair->count = dCollide(pair->a->id, pair->b->id, MAX_CONTACTS, pair->contacts, sizeof(dContactGeom));
+    }
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    addContacts(world, &world->collisions.data[i], -1.f, -1.f);
+  }
+}
+
+static void step(World* world, float dt, CollisionResolver resolver, void* userdata) {
   if (resolver) {
     resolver(world, userdata);
   } else {
+    double start = os_get_time();
+    arr_clear(&world->collisions);
     dSpaceCollide(world->space, world, defaultNearCallback);
+    world->timings.broadphase += os_get_time() - start;
+
+    if (world->countCulledPairs) {
+      countCulledPairs(world);
+    }
+
+    start = os_get_time();
+    narrowphase(world);
+    world->timings.narrowphase += os_get_time() - start;
+  }
+
+  if (world->eventCapacity > 0 && dt > 0) {
+    arr_reserve(&world->feedback, world->contactJoints.length);
+    for (size_t i = 0; i < world->contactJoints.length; i++) {
+      dJointSetFeedback(world->contactJoints.data[i], &world->feedback.data[i]);
+    }
   }
 
   if (dt > 0) {
+    double start = os_get_time();
     dWorldQuickStep(world->id, dt);
+    world->timings.solve += os_get_time() - start;
+  }
+
+  if (world->eventCapacity > 0) {
+    flushContactEvents(world, dt);
   }
 
   dJointGroupEmpty(world->contactGroup);
 }
 
+// Returns the number of steps taken.  With a fixed timestep, time is accumulated and stepped in
+// fixed increments, dropping any time beyond the maximum number of substeps.
+uint32_t lovrWorldUpdate(World* world, float dt, CollisionResolver resolver, void* userdata) {
+  memset(&world->stats, 0, sizeof(world->stats));
+  memset(&world->timings, 0, sizeof(world->timings));
+
+  if (world->timestep <= 0.f) {
+    step(world, dt, resolver, userdata);
+    return 1;
+  }
+
+  world->accumulator += dt;
+  uint32_t steps = (uint32_t) (world->accumulator / world->timestep);
+
+  if (steps > world->maxSubsteps) {
+    steps = world->maxSubsteps;
+    world->accumulator = steps * world->timestep;
+  }
+
+  for (uint32_t i = 0; i < steps; i++) {
+    if (i == steps - 1) {
+      savePreviousPoses(world);
+    }
+
+    step(world, world->timestep, resolver, userdata);
+    world->accumulator -= world->timestep;
+  }
+
+  world->accumulator = MAX(world->accumulator, 0.);
+  return steps;
+}
+
+void lovrWorldGetTimestep(World* world, float* timestep, uint32_t* maxSubsteps) {
+  *timestep = world->timestep;
+  *maxSubsteps = world->maxSubsteps;
+}
+
+void lovrWorldSetTimestep(World* world, float timestep, uint32_t maxSubsteps) {
+  world->timestep = timestep;
+  world->maxSubsteps = maxSubsteps;
+  world->accumulator = 0.;
+  savePreviousPoses(world);
+}
+
 int lovrWorldGetStepCount(World* world) {
   return dWorldGetQuickStepNumIterations(world->id);
 }
@@ -200,8 +911,14 @@ void lovrWorldSetStepCount(World* world, int iterations) {
 }
 
 void lovrWorldComputeOverlaps(World* world) {
+  double start = os_get_time();
   arr_clear(&world->overlaps);
   dSpaceCollide(world->space, world, customNearCallback);
+  world->timings.broadphase += os_get_time() - start;
+
+  if (world->countCulledPairs) {
+    countCulledPairs(world);
+  }
 }
 
 int lovrWorldGetNextOverlap(World* world, Shape** a, Shape** b) {
@@ -216,48 +933,16 @@ int lovrWorldGetNextOverlap(World* world, Shape** a, Shape** b) {
 }
 
 int lovrWorldCollide(World* world, Shape* a, Shape* b, float friction, float restitution) {
-  if (!a || !b) {
+  if (!a || !b || !filterPair(world, a, b)) {
     return false;
   }
 
-  Collider* colliderA = a->collider;
-  Collider* colliderB = b->collider;
-  uint32_t i = colliderA->tag;
-  uint32_t j = colliderB->tag;
-
-  if (i != NO_TAG && j != NO_TAG && !((world->masks[i] & (1 << j)) && (world->masks[j] & (1 << i)))) {
-    return false;
-  }
-
-  if (friction < 0.f) {
-    friction = sqrtf(colliderA->friction * colliderB->friction);
-  }
-
-  if (restitution < 0.f) {
-    restitution = MAX(colliderA->restitution, colliderB->restitution);
-  }
-
-  dContact contacts[MAX_CONTACTS];
-  for (int c = 0; c < MAX_CONTACTS; c++) {
-    contacts[c].surface.mode = 0;
-    contacts[c].surface.mu = friction;
-    contacts[c].surface.bounce = restitution;
-
-    if (restitution > 0) {
-      contacts[c].surface.mode |= dContactBounce;
-    }
-  }
-
-  int contactCount = dCollide(a->id, b->id, MAX_CONTACTS, &contacts[0].geom, sizeof(dContact));
-
-  if (!a->sensor && !b->sensor) {
-    for (int c = 0; c < contactCount; c++) {
-      dJointID joint = dJointCreateContact(world->id, world->contactGroup, &contacts[c]);
-      dJointAttach(joint, colliderA->body, colliderB->body);
-    }
-  }
-
-  return contactCount;
+  dContactGeom contacts[MAX_CONTACTS];
+  CollisionPair pair = { .a = a, .b = b, .contacts = contacts };
+  double start = os_get_time();
+  pair.count = dCollide(a->id, b->id, MAX_CONTACTS, pair.contacts, sizeof(dContactGeom));
+  world->timings.narrowphase += os_get_time() - start;
+  return addContacts(world, &pair, friction, restitution);
 }
 
 void lovrWorldGetContacts(World* world, Shape* a, Shape* b, Contact contacts[MAX_CONTACTS], uint32_t* count) {
@@ -282,16 +967,322 @@ void lovrWorldRaycast(World* world, float x1, float y1, float z1, float x2, floa
   float dy = y2 - y1;
   float dz = z2 - z1;
   float length = sqrtf(dx * dx + dy * dy + dz * dz);
-  dGeomID ray = dCreateRay(world->space, length);
+  dGeomID ray = dCreateRay(0, length);
   dGeomRaySet(ray, x1, y1, z1, dx, dy, dz);
   dSpaceCollide2(ray, (dGeomID) world->space, &data, raycastCallback);
   dGeomDestroy(ray);
 }
 
+// Rays are 6 floats each (origin and direction, the direction's length is the ray's length).  A
+// single ray geom outside of the space is reused for all of them.  Finds the closest hit for each
+// ray, or stops at the first hit in RAYCAST_ANY mode (useful for visibility tests).
+uint32_t lovrWorldRaycastBatch(World* world, const float* rays, uint32_t count, RaycastMode mode, RaycastHit* hits) {
+  bool any = mode == RAYCAST_ANY;
+  RaycastQuery query = { .any = any };
+  uint32_t hitCount = 0;
+
+  dGeomID ray = dCreateRay(0, 1.f);
+  dGeomRaySetFirstContact(ray, any);
+  dGeomRaySetClosestHit(ray, !any);
+
+  for (uint32_t i = 0; i < count; i++, rays += 6) {
+    float length = sqrtf(rays[3] * rays[3] + rays[4] * rays[4] + rays[5] * rays[5]);
+    query.hit = &hits[i];
+    query.hit->shape = NULL;
+
+    if (length == 0.f) {
+      continue;
+    }
+
+    dGeomRaySetLength(ray, length);
+    dGeomRaySet(ray, rays[0], rays[1], rays[2], rays[3], rays[4], rays[5]);
+    dSpaceCollide2(ray, (dGeomID) world->space, &query, raycastQueryCallback);
+    hitCount += !!hits[i].shape;
+  }
+
+  dGeomDestroy(ray);
+  return hitCount;
+}
+
+Shape** lovrWorldQueryBox(World* world, float position[3], float size[3], float orientation[4], uint32_t tagMask, uint32_t* count) {
+  dReal q[4] = { orientation[3], orientation[0], orientation[1], orientation[2] };
+  dGeomID box = dCreateBox(0, size[0], size[1], size[2]);
+  dGeomSetPosition(box, position[0], position[1], position[2]);
+  dGeomSetQuaternion(box, q);
+  return queryGeom(world, box, tagMask, count);
+}
+
+Shape** lovrWorldQuerySphere(World* world, float position[3], float radius, uint32_t tagMask, uint32_t* count) {
+  dGeomID sphere = dCreateSphere(0, radius);
+  dGeomSetPosition(sphere, position[0], position[1], position[2]);
+  return queryGeom(world, sphere, tagMask, count);
+}
+
+// Moves a copy of the shape from start to end in steps no larger than its smallest half extent, so
+// consecutive positions overlap and nothing thicker than zero gets skipped.  The first step with a
+// hit is refined with a binary search.  Shapes on the swept shape's own collider are ignored.
+bool lovrWorldSweep(World* world, Shape* shape, float start[3], float end[3], float orientation[4], uint32_t tagMask, RaycastHit* hit) {
+  dGeomID geom;
+  dReal radius, length;
+  dVector3 size;
+
+  switch (shape->type) {
+    case SHAPE_SPHERE:
+      radius = dGeomSphereGetRadius(shape->id);
+      geom = dCreateSphere(0, radius);
+      break;
+    case SHAPE_BOX:
+      dGeomBoxGetLengths(shape->id, size);
+      radius = MIN(MIN(size[0], size[1]), size[2]) / 2.f;
+      geom = dCreateBox(0, size[0], size[1], size[2]);
+      break;
+    case SHAPE_CAPSULE:
+      dGeomCapsuleGetParams(shape->id, &radius, &length);
+      geom = dCreateCapsule(0, radius, length);
+      break;
+    case SHAPE_CYLINDER:
+      dGeomCylinderGetParams(shape->id, &radius, &length);
+      geom = dCreateCylinder(0, radius, length);
+      radius = MIN(radius, length / 2.f);
+      break;
+    default:
+      lovrThrow("Only sphere, box, capsule, and cylinder shapes can be swept");
+  }
+
+  dReal q[4] = { orientation[3], orientation[0], orientation[1], orientation[2] };
+  dGeomSetQuaternion(geom, q);
+
+  QueryData query = { .world = world, .tagMask = tagMask, .ignore = shape->collider };
+  float delta[3] = { end[0] - start[0], end[1] - start[1], end[2] - start[2] };
+  float distance = sqrtf(delta[0] * delta[0] + delta[1] * delta[1] + delta[2] * delta[2]);
+  uint32_t steps = radius > 0.f ? MAX((uint32_t) ceilf(distance / radius), 1) : 1;
+  float lo = 0.f;
+  float hi = -1.f;
+
+  for (uint32_t i = 0; i <= steps; i++) {
+    float t = (float) i / steps;
+    if (sweepTest(&query, geom, start, delta, t)) {
+      hi = t;
+      break;
+    }
+    lo = t;
+  }
+
+  if (hi < 0.f) {
+    dGeomDestroy(geom);
+    hit->shape = NULL;
+    return false;
+  }
+
+  if (hi > 0.f) {
+    for (uint32_t i = 0; i < 16; i++) {
+      float mid = (lo + hi) / 2.f;
+      if (sweepTest(&query, geom, start, delta, mid)) {
+        hi = mid;
+      } else {
+        lo = mid;
+      }
+    }
+
+    sweepTest(&query, geom, start, delta, hi);
+  }
+
+  dGeomDestroy(geom);
+  hit->shape = query.shape;
+  hit->position[0] = query.contact.pos[0];
+  hit->position[1] = query.contact.pos[1];
+  hit->position[2] = query.contact.pos[2];
+  hit->normal[0] = query.contact.normal[0];
+  hit->normal[1] = query.contact.normal[1];
+  hit->normal[2] = query.contact.normal[2];
+  hit->distance = hi * distance;
+  return true;
+}
+
 Collider* lovrWorldGetFirstCollider(World* world) {
   return world->head;
 }
 
+static void writePose(Collider* collider, PoseFormat format, float* pose) {
+  float position[4], orientation[4];
+  getInterpolatedPose(collider, position, orientation);
+
+  if (format == POSE_MATRIX) {
+    mat4_fromQuat(pose, orientation);
+    vec3_init(pose + 12, position);
+    pose[15] = 1.f;
+  } else {
+    vec3_init(pose, position);
+    pose[3] = 1.f;
+    quat_init(pose + 4, orientation);
+  }
+}
+
+static void readPose(Collider* collider, PoseFormat format, float* pose) {
+  float position[4], orientation[4];
+
+  if (format == POSE_MATRIX) {
+    mat4_getPosition(pose, position);
+    mat4_getOrientation(pose, orientation);
+  } else {
+    vec3_init(position, pose);
+    quat_init(orientation, pose + 4);
+  }
+
+  dReal q[4] = { orientation[3], orientation[0], orientation[1], orientation[2] };
+  dBodySetPosition(collider->body, position[0], position[1], position[2]);
+  dBodySetQuaternion(collider->body, q);
+  vec3_set(collider->previousPosition, position[0], position[1], position[2]);
+  quat_init(collider->previousOrientation, orientation);
+}
+
+// Poses are written at the index of their collider, either in the given list or in the world's
+// collider list.  When only awake colliders are requested, the poses of sleeping colliders are left
+// alone and the indices of the poses that were written are stored in indices (if not NULL).
+uint32_t lovrWorldGetPoses(World* world, Collider** colliders, uint32_t count, PoseFormat format, bool awakeOnly, float* poses, uint32_t* indices) {
+  uint32_t stride = format == POSE_MATRIX ? 16 : 8;
+  uint32_t written = 0;
+
+  if (colliders) {
+    for (uint32_t i = 0; i < count; i++) {
+      if (awakeOnly && !dBodyIsEnabled(colliders[i]->body)) continue;
+      writePose(colliders[i], format, poses + i * stride);
+      if (indices) indices[written] = i;
+      written++;
+    }
+  } else {
+    uint32_t i = 0;
+    for (Collider* collider = world->head; collider; collider = collider->next, i++) {
+      lovrCheck(i < count, "Not enough room for %d poses", i + 1);
+      if (awakeOnly && !dBodyIsEnabled(collider->body)) continue;
+      writePose(collider, format, poses + i * stride);
+      if (indices) indices[written] = i;
+      written++;
+    }
+  }
+
+  return written;
+}
+
+uint32_t lovrWorldSetPoses(World* world, Collider** colliders, uint32_t count, PoseFormat format, float* poses) {
+  uint32_t stride = format == POSE_MATRIX ? 16 : 8;
+
+  if (colliders) {
+    for (uint32_t i = 0; i < count; i++) {
+      readPose(colliders[i], format, poses + i * stride);
+    }
+    return count;
+  }
+
+  uint32_t i = 0;
+  for (Collider* collider = world->head; collider && i < count; collider = collider->next, i++) {
+    readPose(collider, format, poses + i * stride);
+  }
+  return i;
+}
+
+// Snapshots are a header followed by the state of each collider's body, in the order of the World's
+// collider list.  Values are stored as dReal so a restore is bit-exact.  What isn't in a snapshot:
+// - Joints.  Contact joints are rebuilt every step, and ODE's other joints only hold their anchors
+//   and settings, since ODE doesn't warm start.  The World needs the same joints when restoring.
+// - Settings, like gravity, damping, masses, or tags, which are expected to be unchanged.
+// - ODE's sleep timers, which its API can't read.  Instead, applyBodyState resets them.
+// ODE shuffles constraints in the solver with a random number generator shared by every World, so
+// its seed is saved too.  Results are only bit-exact when islands are solved on one thread, since
+// the order threads draw from that generator in isn't fixed.
+
+#define SNAPSHOT_MAGIC 0x50414e53 // SNAP
+
+typedef struct {
+  uint32_t magic;
+  uint32_t realSize;
+  uint32_t bodyCount;
+  uint32_t seed;
+  double accumulator;
+} SnapshotHeader;
+
+typedef struct {
+  dReal position[3];
+  dReal orientation[4];
+  dReal linearVelocity[3];
+  dReal angularVelocity[3];
+  dReal force[3];
+  dReal torque[3];
+  uint32_t awake;
+} BodyState;
+
+// Setting a quaternion renormalizes it, which can change its last bits, and enabling a body resets
+// its sleep timers.  Snapshots apply the state they saved to the World as well, so continuing after
+// a snapshot matches restoring it bit for bit.  A snapshot can delay a body falling asleep a little.
+static void applyBodyState(dBodyID body, const BodyState* state) {
+  dBodySetPosition(body, state->position[0], state->position[1], state->position[2]);
+  dBodySetQuaternion(body, state->orientation);
+  dBodySetLinearVel(body, state->linearVelocity[0], state->linearVelocity[1], state->linearVelocity[2]);
+  dBodySetAngularVel(body, state->angularVelocity[0], state->angularVelocity[1], state->angularVelocity[2]);
+  dBodySetForce(body, state->force[0], state->force[1], state->force[2]);
+  dBodySetTorque(body, state->torque[0], state->torque[1], state->torque[2]);
+  dBodySetAutoDisableAverageSamplesCount(body, dBodyGetAutoDisableAverageSamplesCount(body));
+  if (state->awake) {
+    dBodyEnable(body);
+  } else {
+    dBodyDisable(body);
+  }
+}
+
+size_t lovrWorldGetSnapshotSize(World* world) {
+  return sizeof(SnapshotHeader) + lovrWorldGetColliderCount(world) * sizeof(BodyState);
+}
+
+void lovrWorldSnapshot(World* world, void* data, size_t size) {
+  lovrCheck(size >= lovrWorldGetSnapshotSize(world), "Snapshot is too small for this World");
+  SnapshotHeader* header = data;
+  BodyState* state = (BodyState*) (header + 1);
+  memset(header, 0, sizeof(*header));
+  header->magic = SNAPSHOT_MAGIC;
+  header->realSize = sizeof(dReal);
+  header->seed = (uint32_t) dRandGetSeed();
+  header->accumulator = world->accumulator;
+
+  for (Collider* collider = world->head; collider; collider = collider->next, state++) {
+    dBodyID body = collider->body;
+    memset(state, 0, sizeof(*state));
+    memcpy(state->position, dBodyGetPosition(body), sizeof(state->position));
+    memcpy(state->orientation, dBodyGetQuaternion(body), sizeof(state->orientation));
+    memcpy(state->linearVelocity, dBodyGetLinearVel(body), sizeof(state->linearVelocity));
+    memcpy(state->angularVelocity, dBodyGetAngularVel(body), sizeof(state->angularVelocity));
+    memcpy(state->force, dBodyGetForce(body), sizeof(state->force));
+    memcpy(state->torque, dBodyGetTorque(body), sizeof(state->torque));
+    state->awake = dBodyIsEnabled(body);
+    applyBodyState(body, state);
+    header->bodyCount++;
+  }
+}
+
+void lovrWorldRestore(World* world, const void* data, size_t size) {
+  const SnapshotHeader* header = data;
+  lovrCheck(size >= sizeof(SnapshotHeader) && header->magic == SNAPSHOT_MAGIC, "Invalid World snapshot");
+  lovrCheck(header->realSize == sizeof(dReal), "World snapshot was created with a different ODE precision");
+  lovrCheck(size >= sizeof(SnapshotHeader) + header->bodyCount * sizeof(BodyState), "World snapshot is truncated");
+  lovrCheck(header->bodyCount == lovrWorldGetColliderCount(world), "World snapshot has %d colliders, but the World has %d", header->bodyCount, lovrWorldGetColliderCount(world));
+  const BodyState* state = (const BodyState*) (header + 1);
+
+  for (Collider* collider = world->head; collider; collider = collider->next, state++) {
+    applyBodyState(collider->body, state);
+  }
+
+  dRandSetSeed(header->seed);
+  world->accumulator = header->accumulator;
+  savePreviousPoses(world);
+}
+
+uint32_t lovrWorldGetColliderCount(World* world) {
+  uint32_t count = 0;
+  for (Collider* collider = world->head; collider; collider = collider->next) {
+    count++;
+  }
+  return count;
+}
+
 void lovrWorldGetGravity(World* world, float* x, float* y, float* z) {
   dReal gravity[4];
   dWorldGetGravity(world->id, gravity);
@@ -352,6 +1343,10 @@ const char* lovrWorldGetTagName(World* world, uint32_t tag) {
   return (tag == NO_TAG) ? NULL : world->tags[tag];
 }
 
+uint32_t lovrWorldFindTag(World* world, const char* name) {
+  return findTag(world, name);
+}
+
 int lovrWorldDisableCollisionBetween(World* world, const char* tag1, const char* tag2) {
   uint32_t i = findTag(world, tag1);
   uint32_t j = findTag(world, tag2);
@@ -359,8 +1354,9 @@ int lovrWorldDisableCollisionBetween(World* world, const char* tag1, const char*
     return NO_TAG;
   }
 
-  world->masks[i] &= ~(1 << j);
-  world->masks[j] &= ~(1 << i);
+  world->masks[i] &= ~(1u << j);
+  world->masks[j] &= ~(1u << i);
+  updateTagCollisionBits(world, i, j);
   return 0;
 }
 
@@ -371,8 +1367,9 @@ int lovrWorldEnableCollisionBetween(World* world, const char* tag1, const char*
     return NO_TAG;
   }
 
-  world->masks[i] |= (1 << j);
-  world->masks[j] |= (1 << i);
+  world->masks[i] |= (1u << j);
+  world->masks[j] |= (1u << i);
+  updateTagCollisionBits(world, i, j);
   return 0;
 }
 
@@ -383,7 +1380,7 @@ int lovrWorldIsCollisionEnabledBetween(World* world, const char* tag1, const cha
     return NO_TAG;
   }
 
-  return (world->masks[i] & (1 << j)) && (world->masks[j] & (1 << i));
+  return (world->masks[i] & (1u << j)) && (world->masks[j] & (1u << i));
 }
 
 Collider* lovrColliderCreate(World* world, float x, float y, float z) {
@@ -395,6 +1392,7 @@ Collider* lovrColliderCreate(World* world, float x, float y, float z) {
   collider->friction = INFINITY;
   collider->restitution = 0;
   collider->tag = NO_TAG;
+  quat_identity(collider->previousOrientation);
   dBodySetData(collider->body, collider);
   arr_init(&collider->shapes, arr_alloc);
   arr_init(&collider->joints, arr_alloc);
@@ -476,9 +1474,11 @@ void lovrColliderAddShape(Collider* collider, Shape* shape) {
   }
 
   shape->collider = collider;
+  shape->order = collider->world->shapeCount++;
   dGeomSetBody(shape->id, collider->body);
   dSpaceID newSpace = collider->world->space;
   dSpaceAdd(newSpace, shape->id);
+  updateCollisionBits(collider);
 }
 
 void lovrColliderRemoveShape(Collider* collider, Shape* shape) {
@@ -530,10 +1530,12 @@ const char* lovrColliderGetTag(Collider* collider) {
 bool lovrColliderSetTag(Collider* collider, const char* tag) {
   if (!tag) {
     collider->tag = NO_TAG;
+    updateCollisionBits(collider);
     return true;
   }
 
   collider->tag = findTag(collider->world, tag);
+  updateCollisionBits(collider);
   return collider->tag != NO_TAG;
 }
 
@@ -639,8 +1641,10 @@ void lovrColliderGetPosition(Collider* collider, float* x, float* y, float* z) {
   *z = position[2];
 }
 
+// Moving a collider directly teleports it instead of interpolating from its old pose
 void lovrColliderSetPosition(Collider* collider, float x, float y, float z) {
   dBodySetPosition(collider->body, x, y, z);
+  vec3_set(collider->previousPosition, x, y, z);
 }
 
 void lovrColliderGetOrientation(Collider* collider, quat orientation) {
@@ -651,6 +1655,11 @@ void lovrColliderGetOrientation(Collider* collider, quat orientation) {
 void lovrColliderSetOrientation(Collider* collider, quat orientation) {
   dReal q[4] = { orientation[3], orientation[0], orientation[1], orientation[2] };
   dBodySetQuaternion(collider->body, q);
+  quat_init(collider->previousOrientation, orientation);
+}
+
+void lovrColliderGetPose(Collider* collider, float position[4], float orientation[4]) {
+  getInterpolatedPose(collider, position, orientation);
 }
 
 void lovrColliderGetLinearVelocity(Collider* collider, float* x, float* y, float* z) {
@@ -785,6 +1794,45 @@ void lovrColliderGetAABB(Collider* collider, float aabb[6]) {
   }
 }
 
+static void destroyMeshData(void* ref) {
+  MeshData* mesh = ref;
+  dGeomTriMeshDataDestroy(mesh->id);
+  if (mesh->source) {
+    if (initialized) map_remove(&meshCache, hash64(&mesh->source, sizeof(void*)));
+    lovrRelease(mesh->source, mesh->destructor);
+  } else {
+    free(mesh->vertices);
+    free(mesh->indices);
+  }
+  free(mesh);
+}
+
+// Cached meshes are released with the cache locked, so a lookup on another thread can never find
+// (and retain) a mesh that is being destroyed
+static void releaseMeshData(MeshData* mesh) {
+  if (mesh->source && initialized) {
+    mtx_lock(&meshCacheLock);
+    lovrRelease(mesh, destroyMeshData);
+    mtx_unlock(&meshCacheLock);
+  } else {
+    lovrRelease(mesh, destroyMeshData);
+  }
+}
+
+static MeshData* createMeshData(uint32_t vertexCount, float* vertices, uint32_t indexCount, uint32_t* indices) {
+  MeshData* mesh = calloc(1, sizeof(MeshData));
+  lovrAssert(mesh, "Out of memory");
+  mesh->ref = 1;
+  mesh->id = dGeomTriMeshDataCreate();
+  mesh->vertices = vertices;
+  mesh->indices = indices;
+  mesh->vertexCount = vertexCount;
+  mesh->indexCount = indexCount;
+  dGeomTriMeshDataBuildSingle(mesh->id, vertices, 3 * sizeof(float), vertexCount, indices, indexCount, 3 * sizeof(dTriIndex));
+  dGeomTriMeshDataPreprocess2(mesh->id, (1U << dTRIDATAPREPROCESS_BUILD_FACE_ANGLES), NULL);
+  return mesh;
+}
+
 void lovrShapeDestroy(void* ref) {
   Shape* shape = ref;
   lovrShapeDestroyData(shape);
@@ -793,18 +1841,19 @@ void lovrShapeDestroy(void* ref) {
 
 void lovrShapeDestroyData(Shape* shape) {
   if (shape->id) {
-    if (shape->type == SHAPE_MESH) {
-      dTriMeshDataID dataID = dGeomTriMeshGetData(shape->id);
-      dGeomTriMeshDataDestroy(dataID);
-      free(shape->vertices);
-      free(shape->indices);
-    } else if (shape->type == SHAPE_TERRAIN) {
+    if (shape->type == SHAPE_TERRAIN) {
       dHeightfieldDataID dataID = dGeomHeightfieldGetHeightfieldData(shape->id);
       dGeomHeightfieldDataDestroy(dataID);
     }
     dGeomDestroy(shape->id);
     shape->id = NULL;
   }
+
+  // Other shapes may still be using the trimesh data, so it's released after the geom is destroyed
+  if (shape->mesh) {
+    releaseMeshData(shape->mesh);
+    shape->mesh = NULL;
+  }
 }
 
 ShapeType lovrShapeGetType(Shape* shape) {
@@ -1041,21 +2090,88 @@ void lovrCylinderShapeSetLength(CylinderShape* cylinder, float length) {
   dGeomCylinderSetParams(cylinder->id, lovrCylinderShapeGetRadius(cylinder), length);
 }
 
-MeshShape* lovrMeshShapeCreate(int vertexCount, float* vertices, int indexCount, dTriIndex* indices) {
+static MeshShape* createMeshShape(MeshData* data) {
   MeshShape* mesh = calloc(1, sizeof(MeshShape));
   lovrAssert(mesh, "Out of memory");
   mesh->ref = 1;
-  dTriMeshDataID dataID = dGeomTriMeshDataCreate();
-  dGeomTriMeshDataBuildSingle(dataID, vertices, 3 * sizeof(float), vertexCount, indices, indexCount, 3 * sizeof(dTriIndex));
-  dGeomTriMeshDataPreprocess2(dataID, (1U << dTRIDATAPREPROCESS_BUILD_FACE_ANGLES), NULL);
-  mesh->id = dCreateTriMesh(0, dataID, 0, 0, 0);
+  mesh->id = dCreateTriMesh(0, data->id, 0, 0, 0);
   mesh->type = SHAPE_MESH;
-  mesh->vertices = vertices;
-  mesh->indices = indices;
+  mesh->mesh = data;
   dGeomSetData(mesh->id, mesh);
   return mesh;
 }
 
+// Takes ownership of the vertices and indices
+MeshShape* lovrMeshShapeCreate(int vertexCount, float* vertices, int indexCount, dTriIndex* indices) {
+  return createMeshShape(createMeshData(vertexCount, vertices, indexCount, indices));
+}
+
+// References the vertices and indices in place, retaining the object that owns them.  The trimesh
+// data is cached per source object, so every shape created from the same source after the first
+// one skips building the collision tree.  The cache is shared by all threads.
+MeshShape* lovrMeshShapeCreateShared(void* source, void (*destructor)(void*), uint32_t vertexCount, float* vertices, uint32_t indexCount, uint32_t* indices) {
+  uint64_t hash = hash64(&source, sizeof(void*));
+  mtx_lock(&meshCacheLock);
+  uint64_t cached = map_get(&meshCache, hash);
+
+  if (cached != MAP_NIL) {
+    MeshData* data = (MeshData*) (uintptr_t) cached;
+    lovrRetain(data);
+    mtx_unlock(&meshCacheLock);
+    return createMeshShape(data);
+  }
+
+  MeshData* data = createMeshData(vertexCount, vertices, indexCount, indices);
+  data->source = source;
+  data->destructor = destructor;
+  lovrRetain(source);
+  map_set(&meshCache, hash, (uint64_t) (uintptr_t) data);
+  mtx_unlock(&meshCacheLock);
+  return createMeshShape(data);
+}
+
+// Serialized meshes are a header followed by the vertices (3 floats each) and indices, laid out so
+// the triangles can be used in place when the data is loaded again.
+
+#define MESH_MAGIC 0x4853454d // MESH
+
+typedef struct {
+  uint32_t magic;
+  uint32_t vertexCount;
+  uint32_t indexCount;
+  uint32_t padding;
+} MeshHeader;
+
+void* lovrMeshShapeSerialize(MeshShape* mesh, size_t* size) {
+  MeshData* data = mesh->mesh;
+  size_t vertexSize = data->vertexCount * 3 * sizeof(float);
+  size_t indexSize = data->indexCount * sizeof(uint32_t);
+  *size = sizeof(MeshHeader) + vertexSize + indexSize;
+  MeshHeader* header = malloc(*size);
+  lovrAssert(header, "Out of memory");
+  *header = (MeshHeader) { MESH_MAGIC, data->vertexCount, data->indexCount, 0 };
+  memcpy(header + 1, data->vertices, vertexSize);
+  memcpy((char*) (header + 1) + vertexSize, data->indices, indexSize);
+  return header;
+}
+
+MeshShape* lovrMeshShapeCreateSerialized(void* source, void (*destructor)(void*), void* data, size_t size) {
+  MeshHeader* header = data;
+  lovrAssert(size >= sizeof(MeshHeader) && header->magic == MESH_MAGIC, "Invalid serialized MeshShape");
+  uint64_t words = (uint64_t) header->vertexCount * 3 + header->indexCount;
+  lovrAssert(words <= (size - sizeof(MeshHeader)) / sizeof(float), "Serialized MeshShape is truncated");
+  lovrAssert(header->indexCount % 3 == 0, "Serialized MeshShape index count must be a multiple of 3");
+  float* vertices = (float*) (header + 1);
+  uint32_t* indices = (uint32_t*) (vertices + 3 * (size_t) header->vertexCount);
+
+  // The data may come from anywhere, and ODE trusts the indices
+  for (uint32_t i = 0; i < header->indexCount; i++) {
+    lovrAssert(indices[i] < header->vertexCount, "Serialized MeshShape has an out of range index");
+  }
+
+  return lovrMeshShapeCreateShared(source, destructor, header->vertexCount, vertices, header->indexCount, indices);
+}
+
 TerrainShape* lovrTerrainShapeCreate(float* vertices, uint32_t widthSamples, uint32_t depthSamples, float horizontalScale, float verticalScale) {
   const float thickness = 10.f;
   TerrainShape* terrain = calloc(1, sizeof(TerrainShape));
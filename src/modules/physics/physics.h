@@ -5,7 +5,7 @@
 #pragma once
 
 #define MAX_CONTACTS 10
-#define MAX_TAGS 16
+#define MAX_TAGS 32
 #define NO_TAG ~0u
 
 typedef struct World World;
@@ -25,6 +25,20 @@ typedef Joint DistanceJoint;
 typedef Joint HingeJoint;
 typedef Joint SliderJoint;
 
+typedef enum {
+  BROADPHASE_HASH,
+  BROADPHASE_SAP,
+  BROADPHASE_QUADTREE,
+  BROADPHASE_SIMPLE
+} BroadphaseType;
+
+typedef struct {
+  BroadphaseType type;
+  float center[3];
+  float extents[3];
+  uint32_t depth;
+} BroadphaseInfo;
+
 typedef void (*CollisionResolver)(World* world, void* userdata);
 typedef void (*RaycastCallback)(Shape* shape, float x, float y, float z, float nx, float ny, float nz, void* userdata);
 
@@ -39,10 +53,76 @@ typedef struct {
   float depth;
 } Contact;
 
-World* lovrWorldCreate(float xg, float yg, float zg, bool allowSleep, const char** tags, uint32_t tagCount);
+typedef enum {
+  RAYCAST_CLOSEST,
+  RAYCAST_ANY
+} RaycastMode;
+
+// Tag filtering happens inside ODE's broadphase, which doesn't report the pairs it culls:
+// - pairsCulled: pairs with overlapping bounds that the broadphase culled because of their tags.
+//   ODE can't count these, so they're found by a separate pass that only runs when counting culled
+//   pairs is enabled, and are 0 otherwise.
+// - pairsOverlapping: pairs with overlapping bounds that reached lovrWorldCollide.
+// - pairsRejected: pairs a custom resolver passed in that their tags don't allow to collide.
+typedef struct {
+  uint32_t pairsCulled;
+  uint32_t pairsOverlapping;
+  uint32_t pairsRejected;
+  uint32_t pairsAccepted;
+  uint32_t contacts;
+  uint32_t eventsDropped;
+} CollisionStats;
+
+typedef enum {
+  CONTACT_BEGIN,
+  CONTACT_PERSIST,
+  CONTACT_END
+} ContactEventType;
+
+typedef struct {
+  ContactEventType type;
+  Shape* a;
+  Shape* b;
+  float position[3];
+  float normal[3];
+  float depth;
+  float impulse;
+} ContactEvent;
+
+// With a custom resolver, the broadphase is computeOverlaps and the narrowphase is each collide call
+typedef struct {
+  double broadphase;
+  double narrowphase;
+  double solve;
+} StepTimings;
+
+typedef enum {
+  POSE_TRANSFORM,
+  POSE_MATRIX
+} PoseFormat;
+
+typedef struct {
+  Shape* shape;
+  float position[3];
+  float normal[3];
+  float distance;
+} RaycastHit;
+
+World* lovrWorldCreate(float xg, float yg, float zg, bool allowSleep, const char** tags, uint32_t tagCount, BroadphaseInfo* broadphase, uint32_t threadCount);
 void lovrWorldDestroy(void* ref);
 void lovrWorldDestroyData(World* world);
-void lovrWorldUpdate(World* world, float dt, CollisionResolver resolver, void* userdata);
+BroadphaseType lovrWorldGetBroadphase(World* world);
+uint32_t lovrWorldGetThreadCount(World* world);
+void lovrWorldGetCollisionStats(World* world, CollisionStats* stats);
+bool lovrWorldIsCountingCulledPairs(World* world);
+void lovrWorldSetCountingCulledPairs(World* world, bool enable);
+void lovrWorldGetStepTimings(World* world, StepTimings* timings);
+uint32_t lovrWorldGetContactEventCapacity(World* world);
+void lovrWorldSetContactEventCapacity(World* world, uint32_t capacity);
+bool lovrWorldPollContactEvent(World* world, ContactEvent* event);
+uint32_t lovrWorldUpdate(World* world, float dt, CollisionResolver resolver, void* userdata);
+void lovrWorldGetTimestep(World* world, float* timestep, uint32_t* maxSubsteps);
+void lovrWorldSetTimestep(World* world, float timestep, uint32_t maxSubsteps);
 int lovrWorldGetStepCount(World* world);
 void lovrWorldSetStepCount(World* world, int iterations);
 void lovrWorldComputeOverlaps(World* world);
@@ -50,7 +130,17 @@ int lovrWorldGetNextOverlap(World* world, Shape** a, Shape** b);
 int lovrWorldCollide(World* world, Shape* a, Shape* b, float friction, float restitution);
 void lovrWorldGetContacts(World* world, Shape* a, Shape* b, Contact contacts[MAX_CONTACTS], uint32_t* count);
 void lovrWorldRaycast(World* world, float x1, float y1, float z1, float x2, float y2, float z2, RaycastCallback callback, void* userdata);
+uint32_t lovrWorldRaycastBatch(World* world, const float* rays, uint32_t count, RaycastMode mode, RaycastHit* hits);
+Shape** lovrWorldQueryBox(World* world, float position[3], float size[3], float orientation[4], uint32_t tagMask, uint32_t* count);
+Shape** lovrWorldQuerySphere(World* world, float position[3], float radius, uint32_t tagMask, uint32_t* count);
+bool lovrWorldSweep(World* world, Shape* shape, float start[3], float end[3], float orientation[4], uint32_t tagMask, RaycastHit* hit);
 Collider* lovrWorldGetFirstCollider(World* world);
+uint32_t lovrWorldGetColliderCount(World* world);
+uint32_t lovrWorldGetPoses(World* world, Collider** colliders, uint32_t count, PoseFormat format, bool awakeOnly, float* poses, uint32_t* indices);
+uint32_t lovrWorldSetPoses(World* world, Collider** colliders, uint32_t count, PoseFormat format, float* poses);
+size_t lovrWorldGetSnapshotSize(World* world);
+void lovrWorldSnapshot(World* world, void* data, size_t size);
+void lovrWorldRestore(World* world, const void* data, size_t size);
 void lovrWorldGetGravity(World* world, float* x, float* y, float* z);
 void lovrWorldSetGravity(World* world, float x, float y, float z);
 float lovrWorldGetResponseTime(World* world);
@@ -64,6 +154,7 @@ void lovrWorldSetAngularDamping(World* world, float damping, float threshold);
 bool lovrWorldIsSleepingAllowed(World* world);
 void lovrWorldSetSleepingAllowed(World* world, bool allowed);
 const char* lovrWorldGetTagName(World* world, uint32_t tag);
+uint32_t lovrWorldFindTag(World* world, const char* name);
 int lovrWorldDisableCollisionBetween(World* world, const char* tag1, const char* tag2);
 int lovrWorldEnableCollisionBetween(World* world, const char* tag1, const char* tag2);
 int lovrWorldIsCollisionEnabledBetween(World* world, const char* tag1, const char* tag);
@@ -104,6 +195,7 @@ void lovrColliderGetPosition(Collider* collider, float* x, float* y, float* z);
 void lovrColliderSetPosition(Collider* collider, float x, float y, float z);
 void lovrColliderGetOrientation(Collider* collider, float* orientation);
 void lovrColliderSetOrientation(Collider* collider, float* orientation);
+void lovrColliderGetPose(Collider* collider, float position[4], float orientation[4]);
 void lovrColliderGetLinearVelocity(Collider* collider, float* x, float* y, float* z);
 void lovrColliderSetLinearVelocity(Collider* collider, float x, float y, float z);
 void lovrColliderGetAngularVelocity(Collider* collider, float* x, float* y, float* z);
@@ -173,6 +265,9 @@ float lovrCylinderShapeGetLength(CylinderShape* cylinder);
 void lovrCylinderShapeSetLength(CylinderShape* cylinder, float length);
 
 MeshShape* lovrMeshShapeCreate(int vertexCount, float vertices[], int indexCount, uint32_t indices[]);
+MeshShape* lovrMeshShapeCreateShared(void* source, void (*destructor)(void*), uint32_t vertexCount, float* vertices, uint32_t indexCount, uint32_t* indices);
+MeshShape* lovrMeshShapeCreateSerialized(void* source, void (*destructor)(void*), void* data, size_t size);
+void* lovrMeshShapeSerialize(MeshShape* mesh, size_t* size);
 
 TerrainShape* lovrTerrainShapeCreate(float* vertices, uint32_t widthSamples, uint32_t depthSamples, float horizontalScale, float verticalScale);
 
@@ -0,0 +1,43 @@
+-- Renders 64 looping Sources for 10 seconds through the offline mixer and reports the cost of each
+-- period, first with plain stereo mixing and then with spatialization and effects.
+
+local PERIOD = 256 -- BUFFER_SIZE in audio.h
+local SOURCES = 64
+local SECONDS = 10
+
+return function()
+  local rate = lovr.audio.getSampleRate()
+
+  local samples = {}
+  for i = 1, rate do
+    samples[i] = math.sin(i / rate * 2 * math.pi * 440) * .25
+  end
+
+  local sound = lovr.data.newSound(rate, 'f32', 'mono', rate)
+  sound:setFrames(samples)
+
+  for _, spatial in ipairs({ false, true }) do
+    local sources = {}
+    for i = 1, SOURCES do
+      sources[i] = lovr.audio.newSource(sound, { spatial = spatial })
+      sources[i]:setLooping(true)
+      sources[i]:setPosition(math.cos(i) * 4, 0, math.sin(i) * 4)
+      sources[i]:play()
+    end
+
+    local output = lovr.data.newSound(SECONDS * rate, 'f32', 'stereo', rate)
+    local start = lovr.timer.getTime()
+    lovr.audio.render(output)
+    local elapsed = lovr.timer.getTime() - start
+
+    local periods = SECONDS * rate / PERIOD
+    local voices = lovr.audio.getVoiceStats()
+    print(('%d %s sources (%d real): %.1f ms for %d s, %.2f us per period, %.0fx realtime'):format(
+      SOURCES, spatial and 'spatial' or 'stereo', voices.real, elapsed * 1e3, SECONDS,
+      elapsed / periods * 1e6, SECONDS / elapsed))
+
+    for i = 1, SOURCES do
+      sources[i]:stop()
+    end
+  end
+end
@@ -0,0 +1,268 @@
+#include "core/bc.h"
+#include "core/job.h"
+#include "lib/stb/stb_image.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// Reports block compression throughput in megapixels per second for each thread count, and the
+// PSNR of the result, for bc1, bc3 and bc7.  Encoding is split into rows of blocks with job_run,
+// like Image:compress.  The image is a PNG or JPEG passed on the command line, or a generated one
+// mixing gradients, hard edges and noise.  The decoders here are only for measuring the error.
+
+// job.c gets the core count from the os layer, which needs a window system, so it's provided here
+uint32_t os_get_core_count(void) {
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors;
+#else
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count > 0 ? (uint32_t) count : 1;
+#endif
+}
+
+static double now(void) {
+  struct timespec t;
+  timespec_get(&t, TIME_UTC);
+  return (double) t.tv_sec + t.tv_nsec / 1e9;
+}
+
+typedef struct {
+  const uint8_t* pixels;
+  uint8_t* blocks;
+  uint32_t width;
+  uint32_t height;
+  size_t blockSize;
+  void (*encode)(uint8_t* block, const uint8_t pixels[64]);
+} Context;
+
+static void bc1(uint8_t* block, const uint8_t pixels[64]) { bc1_encode(block, pixels); }
+static void bc3(uint8_t* block, const uint8_t pixels[64]) { bc3_encode(block, pixels); }
+static void bc7(uint8_t* block, const uint8_t pixels[64]) { bc7_encode(block, pixels); }
+
+static void gather(const uint8_t* pixels, uint32_t width, uint32_t bx, uint32_t by, uint8_t block[64]) {
+  for (uint32_t y = 0; y < 4; y++) {
+    memcpy(block + y * 16, pixels + ((by * 4 + y) * width + bx * 4) * 4, 16);
+  }
+}
+
+static void encodeRow(void* userdata, uint32_t by) {
+  Context* context = userdata;
+  uint32_t columns = context->width / 4;
+  uint8_t* out = context->blocks + by * columns * context->blockSize;
+  for (uint32_t bx = 0; bx < columns; bx++, out += context->blockSize) {
+    uint8_t block[64];
+    gather(context->pixels, context->width, bx, by, block);
+    context->encode(out, block);
+  }
+}
+
+// Decoders
+
+static void unpack565(uint16_t c, int rgb[3]) {
+  rgb[0] = ((c >> 11) & 31) * 255 / 31;
+  rgb[1] = ((c >> 5) & 63) * 255 / 63;
+  rgb[2] = (c & 31) * 255 / 31;
+}
+
+static void decodeColor(const uint8_t* block, uint8_t pixels[64], int opaque) {
+  uint16_t c0 = block[0] | (block[1] << 8);
+  uint16_t c1 = block[2] | (block[3] << 8);
+  int palette[4][3];
+  unpack565(c0, palette[0]);
+  unpack565(c1, palette[1]);
+  for (int c = 0; c < 3; c++) {
+    if (c0 > c1 || opaque) {
+      palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+      palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    } else {
+      palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+      palette[3][c] = 0;
+    }
+  }
+  uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((uint32_t) block[7] << 24);
+  for (int i = 0; i < 16; i++) {
+    int index = (indices >> (2 * i)) & 3;
+    for (int c = 0; c < 3; c++) pixels[4 * i + c] = (uint8_t) palette[index][c];
+  }
+}
+
+static void decodeBC1(const uint8_t* block, uint8_t pixels[64]) {
+  decodeColor(block, pixels, 0);
+  for (int i = 0; i < 16; i++) pixels[4 * i + 3] = 255;
+}
+
+static void decodeBC3(const uint8_t* block, uint8_t pixels[64]) {
+  int a0 = block[0], a1 = block[1], alpha[8] = { a0, a1 };
+  for (int i = 1; i < 7; i++) {
+    alpha[i + 1] = a0 > a1 ? ((7 - i) * a0 + i * a1) / 7 : (i < 5 ? ((5 - i) * a0 + i * a1) / 5 : (i == 5 ? 0 : 255));
+  }
+  uint64_t bits = 0;
+  for (int i = 0; i < 6; i++) bits |= (uint64_t) block[2 + i] << (8 * i);
+  decodeColor(block + 8, pixels, 1);
+  for (int i = 0; i < 16; i++) pixels[4 * i + 3] = (uint8_t) alpha[(bits >> (3 * i)) & 7];
+}
+
+static uint32_t readBits(const uint8_t* block, uint32_t* offset, uint32_t count) {
+  uint32_t value = 0;
+  for (uint32_t i = 0; i < count; i++, (*offset)++) {
+    value |= ((block[*offset >> 3] >> (*offset & 7)) & 1) << i;
+  }
+  return value;
+}
+
+// Mode 6 only, which is the only mode the encoder writes
+static void decodeBC7(const uint8_t* block, uint8_t pixels[64]) {
+  static const int weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+  uint32_t offset = 7;
+  int e[2][4];
+  for (int c = 0; c < 4; c++) {
+    e[0][c] = readBits(block, &offset, 7);
+    e[1][c] = readBits(block, &offset, 7);
+  }
+  int p0 = readBits(block, &offset, 1);
+  int p1 = readBits(block, &offset, 1);
+  for (int c = 0; c < 4; c++) {
+    e[0][c] = (e[0][c] << 1) | p0;
+    e[1][c] = (e[1][c] << 1) | p1;
+  }
+  for (int i = 0; i < 16; i++) {
+    int w = weights[readBits(block, &offset, i == 0 ? 3 : 4)];
+    for (int c = 0; c < 4; c++) {
+      pixels[4 * i + c] = (uint8_t) (((64 - w) * e[0][c] + w * e[1][c] + 32) >> 6);
+    }
+  }
+}
+
+static double psnr(const Context* context, void (*decode)(const uint8_t*, uint8_t[64]), int channels) {
+  double error = 0.;
+  uint32_t columns = context->width / 4;
+  uint32_t rows = context->height / 4;
+  for (uint32_t by = 0; by < rows; by++) {
+    for (uint32_t bx = 0; bx < columns; bx++) {
+      uint8_t original[64], decoded[64];
+      gather(context->pixels, context->width, bx, by, original);
+      decode(context->blocks + (by * columns + bx) * context->blockSize, decoded);
+      for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < channels; c++) {
+          double d = (double) original[4 * i + c] - decoded[4 * i + c];
+          error += d * d;
+        }
+      }
+    }
+  }
+  double mse = error / ((double) context->width * context->height * channels);
+  return mse > 0. ? 10. * log10(255. * 255. / mse) : INFINITY;
+}
+
+static uint8_t* generate(uint32_t size) {
+  uint8_t* pixels = malloc(size * size * 4);
+  if (!pixels) return NULL;
+  uint32_t seed = 1;
+  for (uint32_t y = 0; y < size; y++) {
+    for (uint32_t x = 0; x < size; x++) {
+      uint8_t* p = pixels + (y * size + x) * 4;
+      seed = seed * 1664525u + 1013904223u;
+      int noise = (int) (seed >> 28) - 8;
+      float u = (float) x / size, v = (float) y / size;
+      if (x < size / 2) {
+        p[0] = (uint8_t) (u * 510.f);
+        p[1] = (uint8_t) (v * 255.f);
+        p[2] = (uint8_t) (127.5f + 127.5f * sinf(u * 40.f) * cosf(v * 40.f));
+      } else {
+        int checker = ((x / 8) ^ (y / 8)) & 1;
+        p[0] = (uint8_t) (checker ? 230 : 20);
+        p[1] = (uint8_t) (checker ? 40 : 200);
+        p[2] = (uint8_t) (100 + noise * 4);
+      }
+      p[3] = (uint8_t) (v * 255.f);
+    }
+  }
+  return pixels;
+}
+
+static uint8_t* load(const char* path, uint32_t* width, uint32_t* height) {
+  FILE* file = fopen(path, "rb");
+  if (!file) return NULL;
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  uint8_t* data = malloc(size);
+  if (!data || fread(data, 1, size, file) != (size_t) size) {
+    fclose(file);
+    free(data);
+    return NULL;
+  }
+  fclose(file);
+  int w, h, channels;
+  uint8_t* pixels = stbi_load_from_memory(data, (int) size, &w, &h, &channels, 4);
+  free(data);
+  // Cropped to whole blocks, to keep the edge handling out of the way
+  *width = (uint32_t) w & ~3u;
+  *height = (uint32_t) h & ~3u;
+  if (pixels && *width != (uint32_t) w) {
+    for (uint32_t y = 0; y < *height; y++) {
+      memmove(pixels + y * *width * 4, pixels + y * w * 4, *width * 4);
+    }
+  }
+  return pixels;
+}
+
+int main(int argc, char** argv) {
+  uint32_t width = 2048, height = 2048;
+  uint8_t* pixels = argc > 1 ? load(argv[1], &width, &height) : generate(width);
+
+  if (!pixels || width == 0 || height == 0) {
+    fprintf(stderr, "Could not load %s\n", argc > 1 ? argv[1] : "image");
+    return 1;
+  }
+
+  struct {
+    const char* name;
+    void (*encode)(uint8_t* block, const uint8_t pixels[64]);
+    void (*decode)(const uint8_t* block, uint8_t pixels[64]);
+    size_t blockSize;
+    int channels;
+  } formats[] = {
+    { "bc1", bc1, decodeBC1, 8, 3 },
+    { "bc3", bc3, decodeBC3, 16, 4 },
+    { "bc7", bc7, decodeBC7, 16, 4 }
+  };
+
+  uint32_t cores = os_get_core_count();
+  uint8_t* blocks = malloc((size_t) width * height);
+
+  if (!blocks) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  printf("%ux%u, %u cores\n", width, height, cores);
+
+  for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+    Context context = { pixels, blocks, width, height, formats[f].blockSize, formats[f].encode };
+
+    for (uint32_t threads = 1;; threads = threads * 2 > cores ? cores : threads * 2) {
+      double start = now();
+      job_run(encodeRow, &context, height / 4, threads);
+      double elapsed = now() - start;
+      printf("%s %2u threads %9.1f Mpix/s\n", formats[f].name, threads, width * height / elapsed / 1e6);
+      if (threads == cores) break;
+    }
+
+    printf("%s PSNR %.2f dB\n", formats[f].name, psnr(&context, formats[f].decode, formats[f].channels));
+  }
+
+  free(blocks);
+  free(pixels);
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include "scalar.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Reports the throughput of the pixel conversion kernels in megapixels per second, for the
+// vectorized kernels and their scalar versions.  A pixel is 4 components.
+
+#define PIXELS (2048 * 2048)
+#define COMPONENTS (PIXELS * 4)
+#define ROUNDS 16
+
+static double now(void) {
+  struct timespec t;
+  timespec_get(&t, TIME_UTC);
+  return (double) t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static void report(const char* name, double simd, double scalar) {
+  double megapixels = (double) PIXELS * ROUNDS / 1e6;
+  printf("%-12s %9.1f Mpix/s %9.1f Mpix/s scalar %6.2fx\n", name, megapixels / simd, megapixels / scalar, scalar / simd);
+}
+
+#define BENCH(name, dst, src) do {\
+  double t0 = now();\
+  for (int i = 0; i < ROUNDS; i++) convert_##name(dst, src, COMPONENTS);\
+  double t1 = now();\
+  for (int i = 0; i < ROUNDS; i++) scalar_##name(dst, src, COMPONENTS);\
+  double t2 = now();\
+  report(#name, t1 - t0, t2 - t1);\
+} while (0)
+
+int main(void) {
+  float* f32 = malloc(COMPONENTS * sizeof(float));
+  uint16_t* u16 = malloc(COMPONENTS * sizeof(uint16_t));
+  uint16_t* f16 = malloc(COMPONENTS * sizeof(uint16_t));
+  uint8_t* u8 = malloc(COMPONENTS * sizeof(uint8_t));
+
+  if (!f32 || !u16 || !f16 || !u8) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  // Slightly out of range, so the clamps are exercised
+  srand(0);
+  for (size_t i = 0; i < COMPONENTS; i++) {
+    f32[i] = (float) rand() / RAND_MAX * 1.5f - .25f;
+  }
+
+  convert_f32_to_un8(u8, f32, COMPONENTS);
+  convert_f32_to_un16(u16, f32, COMPONENTS);
+  convert_f32_to_f16(f16, f32, COMPONENTS);
+
+  float* out = malloc(COMPONENTS * sizeof(float));
+  uint16_t* out16 = malloc(COMPONENTS * sizeof(uint16_t));
+  uint8_t* out8 = malloc(COMPONENTS * sizeof(uint8_t));
+
+  if (!out || !out16 || !out8) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  BENCH(f32_to_un8, out8, f32);
+  BENCH(un8_to_f32, out, u8);
+  BENCH(f32_to_un16, out16, f32);
+  BENCH(un16_to_f32, out, u16);
+  BENCH(f32_to_f16, out16, f32);
+  BENCH(f16_to_f32, out, f16);
+
+  // Keeps the outputs observable
+  printf("checksum %u\n", (unsigned) (out8[PIXELS] + out16[PIXELS] + (uint32_t) out[PIXELS]));
+
+  free(f32);
+  free(u16);
+  free(f16);
+  free(u8);
+  free(out);
+  free(out16);
+  free(out8);
+  return 0;
+}
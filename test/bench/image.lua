@@ -0,0 +1,42 @@
+-- Times the bulk pixel operations on a 2048x2048 Image in the RGBA8, RGBA16F and RGBA32F formats,
+-- next to a getPixel/setPixel loop in Lua for reference.  Throughput is in megapixels per second.
+
+local SIZE = 2048
+local STRIP = 64 -- The getPixel/setPixel loop only covers this many rows, it's too slow otherwise
+
+local function measure(pixels, fn)
+  local start = lovr.timer.getTime()
+  fn()
+  return pixels / (lovr.timer.getTime() - start) / 1e6
+end
+
+return function()
+  local pixels = SIZE * SIZE
+
+  for _, format in ipairs({ 'rgba8', 'rgba16f', 'rgba32f' }) do
+    local image = lovr.data.newImage(SIZE, SIZE, format)
+    local other = format == 'rgba8' and 'rgba32f' or 'rgba8'
+
+    local results = {
+      { 'getPixel/setPixel', measure(SIZE * STRIP, function()
+        for y = 0, STRIP - 1 do
+          for x = 0, SIZE - 1 do
+            image:setPixel(x, y, image:getPixel(x, y))
+          end
+        end
+      end) },
+      { 'mapPixel', measure(pixels, function()
+        image:mapPixel(function(x, y, r, g, b, a) return r, g, b, a end)
+      end) },
+      { 'getPixels', measure(pixels, function() image:getPixels(0, 0, SIZE, SIZE, 'rgba32f') end) },
+      { 'convert to ' .. other, measure(pixels, function() image:convert(other) end) },
+      { 'premultiply', measure(pixels, function() image:premultiply() end) },
+      { 'gammaToLinear', measure(pixels, function() image:gammaToLinear() end) },
+      { 'linearToGamma', measure(pixels, function() image:linearToGamma() end) }
+    }
+
+    for _, result in ipairs(results) do
+      print(('%-8s %-20s %10.1f Mpix/s'):format(format, result[1], result[2]))
+    end
+  end
+end
@@ -0,0 +1,91 @@
+-- Compares the load time of supercompressed KTX2 files with the same files stored uncompressed:
+--
+--   lovr test bench ktx a.ktx2 b.ktx2 ...
+--
+-- The uncompressed copy of each file is built in memory from its inflated levels, so there's nothing
+-- to prepare besides the supercompressed files (e.g. `ktx create --zstd 19` or `toktx --zcmp 19`).
+-- Files are read before timing, so this measures parsing and inflating only, next to the size that
+-- would be read from disk or downloaded.
+
+local SECONDS = .5 -- Each file is loaded repeatedly for at least this long
+
+local function u32(s, offset)
+  local a, b, c, d = s:byte(offset + 1, offset + 4)
+  return a + b * 2 ^ 8 + c * 2 ^ 16 + d * 2 ^ 24
+end
+
+local function u64(s, offset)
+  return u32(s, offset) + u32(s, offset + 4) * 2 ^ 32
+end
+
+local function pack32(n)
+  return string.char(n % 256, math.floor(n / 2 ^ 8) % 256, math.floor(n / 2 ^ 16) % 256, math.floor(n / 2 ^ 24) % 256)
+end
+
+local function pack64(n)
+  return pack32(n % 2 ^ 32) .. pack32(math.floor(n / 2 ^ 32))
+end
+
+-- Replaces the supercompressed levels with the inflated ones and clears the scheme in the header,
+-- keeping the format, the data format descriptor and the key/value data as they are
+local function uncompress(file)
+  local image = lovr.data.newImage(lovr.data.newBlob(file, 'ktx'))
+  local inflated = image:getBlob():getString()
+  local levels = math.max(u32(file, 40), 1)
+
+  local start = #file
+  for i = 0, levels - 1 do
+    start = math.min(start, u64(file, 80 + i * 24))
+  end
+
+  local index, data = {}, {}
+  local offset, cursor = start, 1
+  for i = 0, levels - 1 do
+    local size = u64(file, 80 + i * 24 + 16)
+    local padding = (16 - offset % 16) % 16
+    table.insert(data, ('\0'):rep(padding) .. inflated:sub(cursor, cursor + size - 1))
+    offset = offset + padding
+    table.insert(index, pack64(offset) .. pack64(size) .. pack64(size))
+    offset, cursor = offset + size, cursor + size
+  end
+
+  local header = file:sub(1, 44) .. pack32(0) .. file:sub(49, 80)
+  return header .. table.concat(index) .. file:sub(81 + levels * 24, start) .. table.concat(data)
+end
+
+local function measure(contents)
+  local blob = lovr.data.newBlob(contents, 'ktx')
+  local runs, start, elapsed = 0, lovr.timer.getTime(), 0
+  repeat
+    lovr.data.newImage(blob):release()
+    runs = runs + 1
+    elapsed = lovr.timer.getTime() - start
+  until elapsed >= SECONDS
+  return elapsed / runs * 1e3
+end
+
+return function(...)
+  local paths = { ... }
+
+  if #paths == 0 then
+    print('Pass the paths of some supercompressed KTX2 files')
+    return
+  end
+
+  for _, path in ipairs(paths) do
+    local handle = assert(io.open(path, 'rb'))
+    local file = handle:read('*a')
+    handle:close()
+
+    local scheme = ({ [0] = 'none', 'basislz', 'zstd', 'zlib' })[u32(file, 44)] or '?'
+    local image = lovr.data.newImage(lovr.data.newBlob(file, 'ktx'))
+    local width, height = image:getDimensions()
+    print(('%s: %dx%d %s, %d levels, %s'):format(path, width, height, image:getFormat(), math.max(u32(file, 40), 1), scheme))
+
+    local plain = scheme == 'none' and file or uncompress(file)
+    print(('  %-6s %8.2f MB %8.2f ms'):format(scheme, #file / 2 ^ 20, measure(file)))
+    if plain ~= file then
+      print(('  %-6s %8.2f MB %8.2f ms'):format('none', #plain / 2 ^ 20, measure(plain)))
+    end
+  end
+end
@@ -0,0 +1,47 @@
+-- Drops 10,000 spheres onto a floor and steps the World under each broadphase, reporting the time
+-- spent in the broadphase, the narrowphase and the solver per step:
+--
+--   lovr test bench physics                    hash, sap and quadtree
+--   lovr test bench physics simple sap ...     only these, 'simple' is O(n^2) and takes a while
+--
+-- The bodies start in a loose 100x100 grid and pile up as they land, so the later steps have a lot
+-- of contacts.
+
+local BODIES = 10000
+local STEPS = 120
+
+return function(...)
+  local broadphases = { ... }
+  if #broadphases == 0 then
+    broadphases = { 'hash', 'sap', 'quadtree' }
+  end
+
+  for _, broadphase in ipairs(broadphases) do
+    local world = lovr.physics.newWorld(0, -9.81, 0, true, nil, {
+      broadphase = { type = broadphase, center = { 0, 25, 0 }, extents = { 120, 60, 120 }, depth = 7 }
+    })
+
+    world:newBoxCollider(0, -.5, 0, 120, 1, 120):setKinematic(true)
+
+    local side = math.ceil(math.sqrt(BODIES))
+    for i = 0, BODIES - 1 do
+      local x, z = i % side, math.floor(i / side)
+      world:newSphereCollider(x - side / 2 + (z % 2) * .25, 1 + (x * 7 + z * 13) % 20, z - side / 2, .4)
+    end
+
+    local broad, narrow, solve, contacts = 0, 0, 0, 0
+    local start = lovr.timer.getTime()
+    for _ = 1, STEPS do
+      world:update(1 / 60)
+      local b, n, s = world:getStepTimings()
+      broad, narrow, solve = broad + b, narrow + n, solve + s
+      contacts = contacts + world:getCollisionStats().contacts
+    end
+    local total = lovr.timer.getTime() - start
+
+    print(('%-9s %8.2f ms per step: %8.2f ms broadphase, %8.2f ms narrowphase, %8.2f ms solve, %6d contacts'):format(
+      broadphase, total / STEPS * 1e3, broad / STEPS * 1e3, narrow / STEPS * 1e3, solve / STEPS * 1e3, math.floor(contacts / STEPS)))
+
+    world:destroy()
+  end
+end
@@ -0,0 +1,63 @@
+-- Casts the same rays through a field of boxes with World:raycast and a Lua callback that keeps the
+-- closest hit, then with World:raycastBatch into tables and into Blobs, in both modes.
+
+local BOXES = 1000
+local RAYS = 4096
+local LENGTH = 50
+local FRAMES = 20
+
+local function measure(fn)
+  local start = lovr.timer.getTime()
+  for _ = 1, FRAMES do fn() end
+  return (lovr.timer.getTime() - start) / FRAMES
+end
+
+return function()
+  local world = lovr.physics.newWorld(0, 0, 0, false)
+  local random = lovr.math.newRandomGenerator(1)
+
+  for _ = 1, BOXES do
+    local x, y, z = (random:random() - .5) * 40, (random:random() - .5) * 40, (random:random() - .5) * 40
+    world:newBoxCollider(x, y, z, .5 + random:random(), .5 + random:random(), .5 + random:random()):setKinematic(true)
+  end
+
+  local rays = {}
+  for i = 0, RAYS - 1 do
+    local dx, dy, dz = random:randomNormal(), random:randomNormal(), random:randomNormal()
+    local scale = LENGTH / math.sqrt(dx * dx + dy * dy + dz * dz)
+    rays[6 * i + 1], rays[6 * i + 2], rays[6 * i + 3] = (random:random() - .5) * 40, (random:random() - .5) * 40, (random:random() - .5) * 40
+    rays[6 * i + 4], rays[6 * i + 5], rays[6 * i + 6] = dx * scale, dy * scale, dz * scale
+  end
+
+  local results = {
+    { 'raycast with a callback', measure(function()
+      for i = 0, RAYS - 1 do
+        local x, y, z = rays[6 * i + 1], rays[6 * i + 2], rays[6 * i + 3]
+        local closest = math.huge
+        world:raycast(x, y, z, x + rays[6 * i + 4], y + rays[6 * i + 5], z + rays[6 * i + 6], function(shape, hx, hy, hz)
+          local distance = (hx - x) ^ 2 + (hy - y) ^ 2 + (hz - z) ^ 2
+          if distance < closest then closest = distance end
+        end)
+      end
+    end) },
+    { 'raycastBatch closest, tables', measure(function() world:raycastBatch(rays, {}) end) },
+    { 'raycastBatch any, tables', measure(function() world:raycastBatch(rays, {}, nil, 'any') end) }
+  }
+
+  -- Blobs can only be filled from Lua with the FFI
+  local ok, ffi = pcall(require, 'ffi')
+  if ok then
+    local input = lovr.data.newBlob(RAYS * 6 * 4)
+    local output = lovr.data.newBlob(RAYS * 8 * 4)
+    local pointer = ffi.cast('float*', input:getPointer())
+    for i = 1, RAYS * 6 do pointer[i - 1] = rays[i] end
+    table.insert(results, { 'raycastBatch closest, Blobs', measure(function() world:raycastBatch(input, output) end) })
+    table.insert(results, { 'raycastBatch any, Blobs', measure(function() world:raycastBatch(input, output, nil, 'any') end) })
+  end
+
+  for _, result in ipairs(results) do
+    print(('%-28s %8.2f ms per %d rays, %7.0f rays per ms'):format(result[1], result[2] * 1e3, RAYS, RAYS / (result[2] * 1e3)))
+  end
+
+  world:destroy()
+end
@@ -0,0 +1,61 @@
+-- Renders spatialized Sources through the offline mixer with more and more of them playing, and
+-- reports how many Sources the spatializer gets through per millisecond of mixing:
+--
+--   LOVR_TEST_SPATIALIZER=hrtf lovr test bench spatializer
+--
+-- "Sources per ms" is seconds of Source audio mixed per millisecond, so 1 second of one Source that
+-- takes .5 ms to mix is 2 Sources per ms, and 1000 times that is how many would play in realtime
+-- on one core.  The Sources circle the listener so the HRTF spatializer keeps changing directions.
+-- Once the HRTF spatializer runs out of budget it pans the rest instead of convolving them, so the
+-- rate climbs again past the number it can convolve.
+
+local PERIOD = 256 -- BUFFER_SIZE in audio.h
+local COUNTS = { 1, 4, 16, 32, 64 }
+local SECONDS = 2
+
+return function()
+  local rate = lovr.audio.getSampleRate()
+  local random = lovr.math.newRandomGenerator(1)
+
+  local samples = {}
+  for i = 1, rate do
+    samples[i] = (random:random() * 2 - 1) * .25
+  end
+
+  local sound = lovr.data.newSound(rate, 'f32', 'mono', rate)
+  sound:setFrames(samples)
+  local output = lovr.data.newSound(SECONDS * rate, 'f32', 'stereo', rate)
+
+  print(('spatializer: %s'):format(lovr.audio.getSpatializer()))
+
+  for _, count in ipairs(COUNTS) do
+    local sources = {}
+    for i = 1, count do
+      sources[i] = lovr.audio.newSource(sound)
+      sources[i]:setLooping(true)
+      sources[i]:play()
+    end
+
+    -- Moves the Sources every period, so the time includes crossfading between directions
+    local periods = math.floor(SECONDS * rate / PERIOD)
+    local elapsed = 0
+    for p = 0, periods - 1 do
+      for i = 1, count do
+        local angle = i / count * 2 * math.pi + p * .01
+        sources[i]:setPosition(math.cos(angle) * 4, 0, math.sin(angle) * 4)
+      end
+
+      local start = lovr.timer.getTime()
+      lovr.audio.render(output, PERIOD, p * PERIOD)
+      elapsed = elapsed + lovr.timer.getTime() - start
+    end
+
+    local voices = lovr.audio.getVoiceStats()
+    print(('%3d sources (%2d real): %8.2f us per period, %8.1f sources per ms'):format(
+      count, voices.real, elapsed / periods * 1e6, count * SECONDS / (elapsed * 1e3)))
+
+    for i = 1, count do
+      sources[i]:stop()
+    end
+  end
+end
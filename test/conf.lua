@@ -0,0 +1,8 @@
+function lovr.conf(t)
+  t.identity = 'lovr-test'
+  t.window = nil
+  t.modules.headset = false
+  t.modules.graphics = os.getenv('LOVR_TEST_GRAPHICS') ~= nil
+  t.audio.start = false
+  t.audio.spatializer = os.getenv('LOVR_TEST_SPATIALIZER')
+end
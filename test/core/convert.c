@@ -0,0 +1,271 @@
+#include "scalar.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+// Checks every conversion kernel against its scalar version.  Counts run through every length up
+// to a few vector widths, from unaligned offsets, so the tails are covered along with the vector
+// loops.  Edge values (clamp boundaries, rounding ties, denormals, infinities, NaN) are scattered
+// through the input so they land in both.  Conversions have to match bit for bit, except that any
+// NaN matches any NaN.  The mixing kernels are allowed a tiny relative error, since some targets
+// fuse the multiply and add.  A canary after the output catches kernels writing too far.
+
+#define SIZE 4096
+#define CANARY 0xcd
+
+static int failures;
+
+static const float edges[] = {
+  0.f, -0.f, 1.f, -1.f, .5f, -.5f, 2.f, -2.f,
+  .5f / 255.f, 1.5f / 255.f, 254.5f / 255.f, .5f / 65535.f, 65534.5f / 65535.f,
+  .99999994f, 1.0000001f, -.99999994f, -1.0000001f, 1e-40f, -1e-40f, 1e30f, -1e30f,
+  INFINITY, -INFINITY, NAN, -NAN,
+  65504.f, 65519.f, 65520.f, 6.1035156e-5f, 6.0975552e-5f, 5.9604645e-8f, 2.9802322e-8f, 4.4703484e-8f,
+  .5f / 32767.f, 1.5f / 32767.f, 32766.5f / 32767.f
+};
+
+static float floats[SIZE];
+static uint8_t bytes[SIZE];
+static uint16_t words[SIZE];
+static int16_t shorts[SIZE];
+
+static uint32_t seed = 1;
+
+static uint32_t random32(void) {
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return seed;
+}
+
+static void fill(void) {
+  for (size_t i = 0; i < SIZE; i++) {
+    floats[i] = (float) (random32() % 1000000) / 1000000.f * 4.f - 2.f;
+    bytes[i] = (uint8_t) random32();
+    words[i] = (uint16_t) random32();
+    shorts[i] = (int16_t) random32();
+  }
+
+  for (size_t i = 0; i < SIZE; i += 7) {
+    floats[i] = edges[(i / 7) % (sizeof(edges) / sizeof(edges[0]))];
+  }
+
+  words[0] = 0, words[1] = 65535, words[2] = 0x7c00, words[3] = 0xfc00, words[4] = 0x7e00, words[5] = 0x7c01;
+  words[6] = 0x8000, words[7] = 0x0001, words[8] = 0x03ff, words[9] = 0x0400, words[10] = 0x7bff, words[11] = 0xfbff;
+  shorts[0] = -32768, shorts[1] = 32767, shorts[2] = 0, shorts[3] = -1;
+}
+
+// Each case is a count and a starting offset into the inputs
+static const size_t offsets[] = { 0, 1, 3 };
+#define FOREACH_CASE(n, offset)\
+  for (size_t n = 0; n <= 67; n = n < 64 ? n + 1 : n + 3)\
+    for (size_t o = 0, offset = offsets[0]; o < 3; o++, offset = o < 3 ? offsets[o] : 0)
+
+static bool sameFloat(float a, float b) {
+  if (isnan(a) || isnan(b)) return isnan(a) && isnan(b);
+  return !memcmp(&a, &b, sizeof(float));
+}
+
+static bool nearFloat(float a, float b) {
+  return fabsf(a - b) <= 1e-5f * fmaxf(1.f, fabsf(b));
+}
+
+static bool sameHalf(uint16_t a, uint16_t b) {
+  bool nanA = (a & 0x7c00) == 0x7c00 && (a & 0x3ff);
+  bool nanB = (b & 0x7c00) == 0x7c00 && (b & 0x3ff);
+  return nanA || nanB ? nanA && nanB : a == b;
+}
+
+static void fail(const char* name, size_t n, size_t offset, size_t i, double input) {
+  if (failures++ < 20) {
+    printf("%s: mismatch at %zu of %zu (offset %zu, input %g)\n", name, i, n, offset, input);
+  }
+}
+
+static void canary(const char* name, const void* end, size_t size, size_t n) {
+  const uint8_t* p = end;
+  for (size_t i = 0; i < size; i++) {
+    if (p[i] != CANARY) {
+      if (failures++ < 20) printf("%s: wrote past the end of %zu outputs\n", name, n);
+      return;
+    }
+  }
+}
+
+// Kernels producing integers, compared exactly
+
+#define TEST_TO_INT(name, T, source)\
+  static void test_##name(void) {\
+    T a[SIZE + 8], b[SIZE + 8];\
+    FOREACH_CASE(n, offset) {\
+      memset(a, CANARY, sizeof(a));\
+      memset(b, CANARY, sizeof(b));\
+      convert_##name(a, source + offset, n);\
+      scalar_##name(b, source + offset, n);\
+      canary("convert_" #name, a + n, 8 * sizeof(T), n);\
+      for (size_t i = 0; i < n; i++) {\
+        if (a[i] != b[i]) fail("convert_" #name, n, offset, i, source[offset + i]);\
+      }\
+    }\
+  }
+
+TEST_TO_INT(f32_to_un8, uint8_t, floats)
+TEST_TO_INT(f32_to_un16, uint16_t, floats)
+TEST_TO_INT(f32_to_i16, int16_t, floats)
+
+// Kernels producing floats
+
+#define TEST_TO_FLOAT(name, T, source)\
+  static void test_##name(void) {\
+    float a[SIZE + 8], b[SIZE + 8];\
+    FOREACH_CASE(n, offset) {\
+      memset(a, CANARY, sizeof(a));\
+      memset(b, CANARY, sizeof(b));\
+      convert_##name(a, source + offset, n);\
+      scalar_##name(b, source + offset, n);\
+      canary("convert_" #name, a + n, 8 * sizeof(float), n);\
+      for (size_t i = 0; i < n; i++) {\
+        if (!sameFloat(a[i], b[i])) fail("convert_" #name, n, offset, i, source[offset + i]);\
+      }\
+    }\
+  }
+
+TEST_TO_FLOAT(un8_to_f32, uint8_t, bytes)
+TEST_TO_FLOAT(un16_to_f32, uint16_t, words)
+TEST_TO_FLOAT(i16_to_f32, int16_t, shorts)
+TEST_TO_FLOAT(f16_to_f32, uint16_t, words)
+
+static void test_f32_to_f16(void) {
+  uint16_t a[SIZE + 8], b[SIZE + 8];
+  FOREACH_CASE(n, offset) {
+    memset(a, CANARY, sizeof(a));
+    memset(b, CANARY, sizeof(b));
+    convert_f32_to_f16(a, floats + offset, n);
+    scalar_f32_to_f16(b, floats + offset, n);
+    canary("convert_f32_to_f16", a + n, 8 * sizeof(uint16_t), n);
+    for (size_t i = 0; i < n; i++) {
+      if (!sameHalf(a[i], b[i])) fail("convert_f32_to_f16", n, offset, i, floats[offset + i]);
+    }
+  }
+}
+
+// Every half, not just the sampled ones, since the bit tricks are easy to get wrong at the edges
+static void test_f16_exhaustive(void) {
+  static uint16_t halves[65536];
+  static float a[65536], b[65536];
+  static uint16_t c[65536], d[65536];
+  for (uint32_t i = 0; i < 65536; i++) halves[i] = (uint16_t) i;
+  convert_f16_to_f32(a, halves, 65536);
+  scalar_f16_to_f32(b, halves, 65536);
+  for (uint32_t i = 0; i < 65536; i++) {
+    if (!sameFloat(a[i], b[i])) fail("convert_f16_to_f32 (exhaustive)", 65536, 0, i, b[i]);
+  }
+  convert_f32_to_f16(c, b, 65536);
+  scalar_f32_to_f16(d, b, 65536);
+  for (uint32_t i = 0; i < 65536; i++) {
+    if (!sameHalf(c[i], d[i]) || !sameHalf(d[i], halves[i])) fail("convert_f32_to_f16 (round trip)", 65536, 0, i, b[i]);
+  }
+}
+
+// f32 -> un8 is documented to work in place
+static void test_f32_to_un8_in_place(void) {
+  float a[SIZE], b[SIZE];
+  FOREACH_CASE(n, offset) {
+    memcpy(a, floats + offset, n * sizeof(float));
+    memcpy(b, floats + offset, n * sizeof(float));
+    convert_f32_to_un8((uint8_t*) a, a, n);
+    scalar_f32_to_un8((uint8_t*) b, b, n);
+    if (memcmp(a, b, n)) fail("convert_f32_to_un8 (in place)", n, offset, 0, floats[offset]);
+  }
+}
+
+static void test_clamp_f32(void) {
+  float a[SIZE + 8], b[SIZE + 8];
+  FOREACH_CASE(n, offset) {
+    memset(a, CANARY, sizeof(a));
+    memset(b, CANARY, sizeof(b));
+    memcpy(a, floats + offset, n * sizeof(float));
+    memcpy(b, floats + offset, n * sizeof(float));
+    convert_clamp_f32(a, n);
+    scalar_clamp_f32(b, n);
+    canary("convert_clamp_f32", a + n, 8 * sizeof(float), n);
+    for (size_t i = 0; i < n; i++) {
+      if (!sameFloat(a[i], b[i]) || isnan(a[i])) fail("convert_clamp_f32", n, offset, i, floats[offset + i]);
+    }
+  }
+}
+
+// The mixing kernels only see finite audio, and accumulate into whatever is already there
+
+static const float gains[][2] = { { 1.f, 0.f }, { .5f, .001f }, { 0.f, -.0005f }, { .8f, -.8f / 64.f } };
+
+static void fillAudio(float* dst, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    float x = floats[i % SIZE];
+    dst[i] = isfinite(x) && fabsf(x) <= 2.f ? x : 0.f;
+  }
+}
+
+static void test_mix_stereo(void) {
+  float src[2 * SIZE], a[2 * SIZE + 8], b[2 * SIZE + 8];
+  fillAudio(src, 2 * SIZE);
+  for (size_t g = 0; g < sizeof(gains) / sizeof(gains[0]); g++) {
+    FOREACH_CASE(n, offset) {
+      memset(a, CANARY, sizeof(a));
+      memset(b, CANARY, sizeof(b));
+      fillAudio(a, 2 * n);
+      fillAudio(b, 2 * n);
+      convert_mix_stereo(a, src + 2 * offset, n, gains[g][0], gains[g][1]);
+      scalar_mix_stereo(b, src + 2 * offset, n, gains[g][0], gains[g][1]);
+      canary("convert_mix_stereo", a + 2 * n, 8 * sizeof(float), n);
+      for (size_t i = 0; i < 2 * n; i++) {
+        if (!nearFloat(a[i], b[i])) fail("convert_mix_stereo", n, offset, i / 2, src[2 * offset + i]);
+      }
+    }
+  }
+}
+
+static void test_pan_mono(void) {
+  float src[SIZE], a[2 * SIZE + 8], b[2 * SIZE + 8];
+  fillAudio(src, SIZE);
+  for (size_t g = 0; g < sizeof(gains) / sizeof(gains[0]); g++) {
+    float gain[2] = { gains[g][0], 1.f - gains[g][0] };
+    float step[2] = { gains[g][1], -gains[g][1] };
+    FOREACH_CASE(n, offset) {
+      memset(a, CANARY, sizeof(a));
+      memset(b, CANARY, sizeof(b));
+      convert_pan_mono(a, src + offset, n, gain, step);
+      scalar_pan_mono(b, src + offset, n, gain, step);
+      canary("convert_pan_mono", a + 2 * n, 8 * sizeof(float), n);
+      for (size_t i = 0; i < 2 * n; i++) {
+        if (!nearFloat(a[i], b[i])) fail("convert_pan_mono", n, offset, i / 2, src[offset + i / 2]);
+      }
+    }
+  }
+}
+
+int main(void) {
+  fill();
+  test_f32_to_un8();
+  test_f32_to_un8_in_place();
+  test_un8_to_f32();
+  test_f32_to_un16();
+  test_un16_to_f32();
+  test_f32_to_f16();
+  test_f16_to_f32();
+  test_f16_exhaustive();
+  test_f32_to_i16();
+  test_i16_to_f32();
+  test_clamp_f32();
+  test_mix_stereo();
+  test_pan_mono();
+
+  if (failures > 0) {
+    printf("%d failures\n", failures);
+    return 1;
+  }
+
+  printf("All conversion kernels match their scalar versions\n");
+  return 0;
+}
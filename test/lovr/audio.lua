@@ -0,0 +1,142 @@
+-- Audio from several threads at once.  Worker threads hammer the Source and listener setters and
+-- getters while the main thread renders, then the getters have to give back what was set.
+
+local THREADS = 4
+local SOURCES = 8
+local ITERATIONS = 2000
+
+local worker = [[
+  local audio = require('lovr.audio')
+  local thread = require('lovr.thread')
+  local name, count, iterations = ...
+
+  local channel = thread.getChannel(name)
+  local sources = {}
+  for i = 1, count do
+    sources[i] = channel:pop(true)
+  end
+
+  for i = 1, iterations do
+    local source = sources[i % count + 1]
+
+    source:setVolume(i % 11 / 10)
+    local volume = source:getVolume()
+    assert(volume >= 0 and volume <= 1, 'Bad volume ' .. volume)
+
+    source:setPitch(.5 + i % 4 * .25)
+    assert(source:getPitch() > 0, 'Bad pitch')
+
+    source:setPose(i % 7, 0, 0, 0, 0, 1, 0)
+    source:setRadius(i % 3)
+    source:setPriority(i % 5)
+    source:setEffectEnabled('attenuation', i % 2 == 0)
+    source:isEffectEnabled('attenuation')
+    source:getRadius()
+    source:getPriority()
+
+    audio.setPose(0, i % 5, 0, 0, 0, 1, 0)
+    audio.getPose()
+
+    if i % 3 == 0 then
+      source:play()
+    elseif i % 3 == 1 then
+      source:pause()
+    else
+      source:seek(i % 10 / 100)
+    end
+  end
+]]
+
+return {
+  concurrentSettersWhileRendering = function()
+    local rate = lovr.audio.getSampleRate()
+    local sound = lovr.data.newSound(rate, 'f32', 'mono', rate)
+    local output = lovr.data.newSound(512, 'f32', 'stereo', rate)
+
+    local sources = {}
+    for i = 1, SOURCES do
+      sources[i] = lovr.audio.newSource(sound, { pitchable = true })
+      sources[i]:setLooping(true)
+    end
+
+    local threads = {}
+    for i = 1, THREADS do
+      local name = 'test.audio.' .. i
+      local channel = lovr.thread.getChannel(name)
+      for _, source in ipairs(sources) do
+        channel:push(source)
+      end
+      threads[i] = lovr.thread.newThread(worker)
+      threads[i]:start(name, SOURCES, ITERATIONS)
+    end
+
+    local running = true
+    while running do
+      lovr.audio.render(output)
+      running = false
+      for _, thread in ipairs(threads) do
+        running = running or thread:isRunning()
+      end
+    end
+
+    for _, thread in ipairs(threads) do
+      thread:wait()
+      assert(not thread:getError(), thread:getError())
+    end
+
+    for _, source in ipairs(sources) do
+      source:setVolume(.25)
+      source:setPitch(1.5)
+      source:setRadius(2)
+      source:setPriority(3)
+      source:setEffectEnabled('attenuation', false)
+      assert(source:getVolume() == .25, 'Source volume was lost')
+      assert(source:getPitch() == 1.5, 'Source pitch was lost')
+      assert(source:getRadius() == 2, 'Source radius was lost')
+      assert(source:getPriority() == 3, 'Source priority was lost')
+      assert(not source:isEffectEnabled('attenuation'), 'Source effects were lost')
+      source:stop()
+    end
+
+    lovr.audio.setPose(1, 2, 3)
+    local x, y, z = lovr.audio.getPose()
+    assert(x == 1 and y == 2 and z == 3, 'Listener pose was lost')
+    lovr.audio.render(output)
+  end,
+
+  -- Renders a ramp in chunks that don't line up with the mixer's periods, any frames dropped or
+  -- repeated between calls show up as a step that's out of line with the others
+  renderIsContiguous = function()
+    local rate = lovr.audio.getSampleRate()
+    local length, chunk, chunks = 1024, 100, 7
+    local ramp = {}
+    for i = 1, length do
+      ramp[2 * i - 1], ramp[2 * i] = i / length, i / length
+    end
+
+    local sound = lovr.data.newSound(length, 'f32', 'stereo', rate)
+    sound:setFrames(ramp)
+    local source = lovr.audio.newSource(sound, { spatial = false })
+    source:play()
+
+    local output = lovr.data.newSound(chunk * chunks, 'f32', 'stereo', rate)
+    for i = 0, chunks - 1 do
+      assert(lovr.audio.render(output, chunk, i * chunk) == chunk, 'Render came up short')
+    end
+    source:stop()
+
+    -- Frames left over from an earlier test are silent, the ramp starts after them
+    local frames = output:getFrames()
+    local start = 1
+    while start < #frames / 2 and frames[2 * start - 1] == 0 do
+      start = start + 1
+    end
+
+    local step = frames[2 * start + 1] - frames[2 * start - 1]
+    assert(step > 0, 'The ramp was not rendered')
+    for i = start, #frames / 2 - 1 do
+      local delta = frames[2 * i + 1] - frames[2 * i - 1]
+      assert(math.abs(delta - step) < 1e-6, ('Render is not contiguous at frame %d'):format(i))
+    end
+  end
+}
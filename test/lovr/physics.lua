@@ -0,0 +1,75 @@
+-- World snapshots.  The scene has joints, a stack of boxes that falls asleep early on, and a sphere
+-- that lands on one of the sleeping boxes after the snapshot and wakes it up.
+
+local STEPS = 180
+
+local function scene()
+  local world = lovr.physics.newWorld(0, -9.81, 0, true)
+  world:newBoxCollider(0, -.5, 0, 40, 1, 40):setKinematic(true)
+
+  for i = 1, 3 do
+    world:newBoxCollider(0, i - .5, 0, 1, 1, 1)
+  end
+
+  -- Lands on the stack at about 4 seconds
+  world:newSphereCollider(0, 80, 0, .25)
+
+  local anchor = world:newSphereCollider(5, 4, 0, .1)
+  anchor:setKinematic(true)
+  local bob = world:newSphereCollider(7, 4, 0, .3)
+  lovr.physics.newBallJoint(anchor, bob, 5, 4, 0)
+
+  local a = world:newBoxCollider(-6, 3, 0, 1, .2, .2)
+  local b = world:newBoxCollider(-5, 3, 0, 1, .2, .2)
+  lovr.physics.newHingeJoint(a, b, -5.5, 3, 0, 0, 0, 1)
+  local c = world:newBoxCollider(-4, 3, 0, 1, .2, .2)
+  lovr.physics.newDistanceJoint(b, c, -5, 3, 0, -4, 3, 0)
+  local d = world:newBoxCollider(-3, 3, 0, 1, .2, .2)
+  lovr.physics.newSliderJoint(c, d, 1, 0, 0)
+
+  return world
+end
+
+local function sleeping(world)
+  local count = 0
+  for _, collider in ipairs(world:getColliders()) do
+    if not collider:isKinematic() and not collider:isAwake() then
+      count = count + 1
+    end
+  end
+  return count
+end
+
+local function step(world, count)
+  for _ = 1, count do
+    world:update(1 / 60)
+  end
+end
+
+return {
+  snapshotRestoresBitExact = function()
+    local world = scene()
+    step(world, STEPS)
+    assert(sleeping(world) > 0, 'Nothing fell asleep, so sleeping bodies are not covered')
+    local snapshot = world:snapshot()
+
+    step(world, STEPS)
+    local expected = world:snapshot():getString()
+
+    world:restore(snapshot)
+    step(world, STEPS)
+    local actual = world:snapshot():getString()
+
+    -- Snapshots hold the raw positions, orientations, velocities, forces, and sleep state
+    assert(actual == expected, 'Stepping after restoring a snapshot gave different results')
+    world:destroy()
+  end,
+
+  snapshotChecksColliderCount = function()
+    local world = scene()
+    local snapshot = world:snapshot()
+    world:newSphereCollider(0, 10, 0, 1)
+    assert(not pcall(world.restore, world, snapshot), 'Restoring a snapshot with the wrong collider count should fail')
+    world:destroy()
+  end
+}
@@ -0,0 +1,72 @@
+-- Runs the tests in lovr/ or the benchmarks in bench/, without a window or a headset:
+--
+--   lovr test                 runs every test
+--   lovr test bench           runs every benchmark
+--   lovr test bench audio     runs bench/audio.lua, passing it any remaining arguments
+--
+-- A test file returns a table of test functions, which fail by throwing an error.  A benchmark
+-- file returns a function that prints its own report.  Graphics is only available when the
+-- LOVR_TEST_GRAPHICS environment variable is set, since it needs a GPU, and LOVR_TEST_SPATIALIZER
+-- picks the audio spatializer.
+
+local function scripts(folder, only)
+  local names = {}
+  for _, file in ipairs(lovr.filesystem.getDirectoryItems(folder)) do
+    local name = file:match('^(.+)%.lua$')
+    if name and (not only or name == only) then
+      table.insert(names, name)
+    end
+  end
+  table.sort(names)
+  return names
+end
+
+local function test()
+  local passed, failed = 0, 0
+
+  for _, script in ipairs(scripts('lovr')) do
+    local tests = lovr.filesystem.load('lovr/' .. script .. '.lua')()
+
+    local names = {}
+    for name in pairs(tests) do table.insert(names, name) end
+    table.sort(names)
+
+    for _, name in ipairs(names) do
+      local ok, message = xpcall(tests[name], debug.traceback)
+      if ok then
+        passed = passed + 1
+      else
+        failed = failed + 1
+        print(('FAIL %s.%s: %s'):format(script, name, message))
+      end
+    end
+  end
+
+  print(('%d passed, %d failed'):format(passed, failed))
+  return failed == 0
+end
+
+local function bench(only, ...)
+  local names = scripts('bench', only)
+  if #names == 0 then
+    print(('No benchmark named %q'):format(only))
+    return false
+  end
+
+  for _, script in ipairs(names) do
+    print(('-- %s'):format(script))
+    lovr.filesystem.load('bench/' .. script .. '.lua')()(...)
+  end
+
+  return true
+end
+
+function lovr.load(args)
+  local ok
+  if args[1] == 'bench' then
+    ok = bench(select(2, (table.unpack or unpack)(args)))
+  else
+    ok = test()
+  end
+  lovr.event.quit(ok and 0 or 1)
+end
@@ -0,0 +1,32 @@
+// Builds the conversion kernels a second time without SIMD, with a scalar_ prefix instead of
+// convert_, so tests and benchmarks can compare the vectorized kernels against the reference.
+
+#include "../src/core/convert.h"
+
+#define LOVR_CONVERT_SCALAR
+#define convert_f32_to_un8 scalar_f32_to_un8
+#define convert_un8_to_f32 scalar_un8_to_f32
+#define convert_f32_to_un16 scalar_f32_to_un16
+#define convert_un16_to_f32 scalar_un16_to_f32
+#define convert_f32_to_f16 scalar_f32_to_f16
+#define convert_f16_to_f32 scalar_f16_to_f32
+#define convert_f32_to_i16 scalar_f32_to_i16
+#define convert_i16_to_f32 scalar_i16_to_f32
+#define convert_clamp_f32 scalar_clamp_f32
+#define convert_mix_stereo scalar_mix_stereo
+#define convert_pan_mono scalar_pan_mono
+
+#include "../src/core/convert.c"
+
+#undef LOVR_CONVERT_SCALAR
+#undef convert_f32_to_un8
+#undef convert_un8_to_f32
+#undef convert_f32_to_un16
+#undef convert_un16_to_f32
+#undef convert_f32_to_f16
+#undef convert_f16_to_f32
+#undef convert_f32_to_i16
+#undef convert_i16_to_f32
+#undef convert_clamp_f32
+#undef convert_mix_stereo
+#undef convert_pan_mono